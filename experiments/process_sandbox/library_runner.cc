@@ -321,15 +321,42 @@ namespace sandbox
           exit(0);
         }
         assert(shared_mem->is_child_executing);
-        try
+        // Drain every batched call before the single-slot message, so that
+        // enqueued calls are never reordered after a later synchronous
+        // call.  `head` is advanced only after an entry has executed; the
+        // parent uses it as the completion counter.
+        auto& ring = shared_mem->ring;
+        uint32_t head = ring.head.load(std::memory_order_relaxed);
+        while (head != ring.tail.load(std::memory_order_acquire))
         {
-          (*library->functions[shared_mem->function_index])(
-            shared_mem->msg_buffer);
+          auto entry = ring.entries[head % CallRing::ring_size];
+          try
+          {
+            (*library->functions[entry.function_index])(entry.msg_buffer);
+          }
+          catch (...)
+          {
+            // FIXME: Report error in some useful way.
+            printf("Exception!\n");
+          }
+          head++;
+          ring.head.store(head, std::memory_order_release);
         }
-        catch (...)
+        // The single-slot path.  A doorbell rung for a batch does not
+        // refill the slot, so only invoke it when there is a message.
+        if (shared_mem->msg_buffer != nullptr)
         {
-          // FIXME: Report error in some useful way.
-          printf("Exception!\n");
+          try
+          {
+            (*library->functions[shared_mem->function_index])(
+              shared_mem->msg_buffer);
+          }
+          catch (...)
+          {
+            // FIXME: Report error in some useful way.
+            printf("Exception!\n");
+          }
+          shared_mem->msg_buffer = nullptr;
         }
         shared_mem->signal(false);
       }
@@ -109,6 +109,18 @@ namespace sandbox
      * shouldn't be mutable by the code in the sandbox, but is currently.
      */
     uintptr_t shared_heap_range_end;
+    /**
+     * The initial start of the shared heap range.  The bump pointer only
+     * moves forwards, so its distance from this base is both the current
+     * usage and the high-water mark of the heap.
+     */
+    uintptr_t shared_heap_range_base;
+    /**
+     * The number of reserve calls that failed because the range was
+     * exhausted.  A non-zero value means the child has already had
+     * allocations refused.  Updated from both sides of the sandbox.
+     */
+    std::atomic<size_t> failed_reserves;
     /**
      * Flag indicating that this memory provider is initialised.  If it is not
      * yet initialised, then it should request some memory for its buffer.
@@ -130,6 +142,7 @@ namespace sandbox
     {
       shared_heap_range_start = start;
       shared_heap_range_end = end;
+      shared_heap_range_base = start;
       isInitialised = true;
     }
     /**
@@ -148,6 +161,7 @@ namespace sandbox
         shared_heap_range_start = reinterpret_cast<uintptr_t>(bootstrap_heap);
         shared_heap_range_end =
           reinterpret_cast<uintptr_t>(bootstrap_heap) + bootstrap_heap_size;
+        shared_heap_range_base = reinterpret_cast<uintptr_t>(bootstrap_heap);
         isInitialised = true;
       }
       size_t align1 = align - 1;
@@ -168,6 +182,7 @@ namespace sandbox
       } while (!shared_heap_range_start.compare_exchange_strong(start, end));
       if (end > shared_heap_range_end)
       {
+        failed_reserves.fetch_add(1, std::memory_order_relaxed);
         return nullptr;
       }
       return reinterpret_cast<void*>(rounded_start);
@@ -730,6 +745,68 @@ namespace sandbox
     }
   };
 
+  /**
+   * A single-producer, single-consumer submission ring of pending calls,
+   * stored in the shared memory region.  The parent appends call
+   * descriptors (a vtable index and an argument-frame pointer) and rings
+   * the doorbell once per batch; the child drains every pending descriptor
+   * before going back to sleep, amortising the wakeup cost over the batch.
+   *
+   * The indexes increase monotonically and are taken modulo `ring_size`
+   * when used; unsigned wrap-around is harmless.  Only the parent writes
+   * `tail` and only the child writes `head`.  The child advances `head`
+   * after executing an entry, so `head` doubles as the completion counter:
+   * every call with a ticket at or below it has finished and its results
+   * are visible in the argument frame.
+   */
+  struct CallRing
+  {
+    /**
+     * A pending call, in the same form that `SandboxedLibrary::send` uses
+     * for the single-slot path.
+     */
+    struct Entry
+    {
+      /**
+       * The index of the function to call in the library's vtable.
+       */
+      int function_index;
+      /**
+       * A pointer to the argument frame, in the shared memory range.
+       */
+      void* msg_buffer;
+    };
+    /**
+     * The number of entries in the ring.  A power of two, so that the
+     * modulo in the index calculation is a mask.
+     */
+    static constexpr uint32_t ring_size = 64;
+    /**
+     * The call descriptors.
+     */
+    Entry entries[ring_size];
+    /**
+     * The index of the next entry that the child will consume.  Written
+     * only by the child, after the entry has been executed.
+     */
+    std::atomic<uint32_t> head = 0;
+    /**
+     * The index of the next entry that the parent will fill.  Written only
+     * by the parent, after the entry has been populated.
+     */
+    std::atomic<uint32_t> tail = 0;
+    /**
+     * Predicate to check whether the ring has no space for another entry.
+     * Called only by the parent.
+     */
+    bool full()
+    {
+      return tail.load(std::memory_order_relaxed) -
+        head.load(std::memory_order_acquire) ==
+        ring_size;
+    }
+  };
+
   /**
    * Class representing a view of a shared memory region.  This provides both
    * the parent and child views of the region.
@@ -760,6 +837,11 @@ namespace sandbox
      * argument frame provided by the sandbox caller.
      */
     void* msg_buffer = nullptr;
+    /**
+     * The submission ring for batched calls.  The child drains this before
+     * handling `msg_buffer` and before going back to sleep.
+     */
+    CallRing ring;
     /**
      * The message queue for the parent's allocator.  This is stored in the
      * shared region because the child must be able to free memory allocated by
@@ -1219,6 +1301,48 @@ namespace sandbox
       }
     }
   }
+  uint32_t SandboxedLibrary::enqueue(int idx, void* ptr)
+  {
+    auto& ring = shared_mem->ring;
+    // If the ring is full, wake the child so it drains some entries and
+    // wait for space.
+    while (ring.full())
+    {
+      shared_mem->signal(true);
+      if (!shared_mem->wait(false, {0, 100000}) && has_child_exited())
+      {
+        throw std::runtime_error("Sandboxed library terminated abnormally");
+      }
+    }
+    uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+    ring.entries[tail % CallRing::ring_size] = {idx, ptr};
+    // Publish the entry.  The release store pairs with the acquire load of
+    // `tail` in the child's drain loop.
+    ring.tail.store(tail + 1, std::memory_order_release);
+    return tail + 1;
+  }
+  void SandboxedLibrary::flush()
+  {
+    shared_mem->signal(true);
+  }
+  void SandboxedLibrary::wait_for_completion(uint32_t ticket)
+  {
+    auto& ring = shared_mem->ring;
+    // The indexes wrap, so compare with a signed difference.
+    while (
+      static_cast<int32_t>(
+        ring.head.load(std::memory_order_acquire) - ticket) < 0)
+    {
+      // The child may have drained the ring and gone back to sleep between
+      // our enqueue and this wait, missing a doorbell that raced with its
+      // last check; re-ring it so the remaining entries are executed.
+      shared_mem->signal(true);
+      if (!shared_mem->wait(false, {0, 100000}) && has_child_exited())
+      {
+        throw std::runtime_error("Sandboxed library terminated abnormally");
+      }
+    }
+  }
 #  ifndef USE_KQUEUE_PROCDESC
   namespace
   {
@@ -1309,6 +1433,39 @@ namespace sandbox
 #  error Missing implementation of SandboxedLibrary
 #endif
 
+  SandboxedLibrary::HeapTelemetry SandboxedLibrary::heap_telemetry()
+  {
+    auto& mp = shared_mem->memory_provider;
+    uintptr_t base = mp.shared_heap_range_base;
+    HeapTelemetry stats;
+    stats.capacity = mp.shared_heap_range_end - base;
+    stats.used =
+      mp.shared_heap_range_start.load(std::memory_order_relaxed) - base;
+    stats.failed_reserves = mp.failed_reserves.load(std::memory_order_relaxed);
+    return stats;
+  }
+  void SandboxedLibrary::check_heap_pressure()
+  {
+    if (heap_pressure_warned)
+    {
+      return;
+    }
+    auto stats = heap_telemetry();
+    // Warn once when seven eighths of the range have been handed out.  The
+    // mapping cannot grow under a running child (it is mapped at a fixed
+    // address and length in both processes), so the remedies are
+    // provisioning a larger heap up front or recycling the sandbox; warn
+    // while there is still headroom to do either.
+    if (stats.used >= stats.capacity - (stats.capacity / 8))
+    {
+      fprintf(
+        stderr,
+        "Sandbox heap almost exhausted: %zd of %zd bytes used\n",
+        stats.used,
+        stats.capacity);
+      heap_pressure_warned = true;
+    }
+  }
   void* SandboxedLibrary::alloc_in_sandbox(size_t bytes, size_t count)
   {
     bool overflow = false;
@@ -1317,6 +1474,7 @@ namespace sandbox
     {
       return nullptr;
     }
+    check_heap_pressure();
     return allocator->alloc(sz);
   }
   void SandboxedLibrary::dealloc_in_sandbox(void* ptr)
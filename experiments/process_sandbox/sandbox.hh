@@ -3,6 +3,7 @@
 
 #include <assert.h>
 #include <memory>
+#include <stdint.h>
 #include <string.h>
 #include <tuple>
 #include <vector>
@@ -169,6 +170,18 @@ namespace sandbox
      * Deallocate an allocation in the sandbox.
      */
     void dealloc_in_sandbox(void* ptr);
+    /**
+     * Flag recording that the heap-pressure warning has been issued, so
+     * that it is printed at most once per sandbox.
+     */
+    bool heap_pressure_warned = false;
+    /**
+     * Checks the heap watermark and warns (once) when the shared range is
+     * almost exhausted.  Called on every parent-side allocation, so the
+     * warning fires while there is still headroom to provision a larger
+     * heap or recycle the sandbox.
+     */
+    void check_heap_pressure();
     /**
      * Start the child process.  On *NIX systems, this can be called within a
      * vfork context and so must not allocate or modify memory on the heap, or
@@ -299,6 +312,40 @@ namespace sandbox
       memcpy(ptr, str, len);
       return ptr;
     }
+    /**
+     * Telemetry for this sandbox's shared heap.
+     */
+    struct HeapTelemetry
+    {
+      /**
+       * Bytes of the shared range handed out by the memory provider.  The
+       * provider bump-allocates and never moves the pointer backwards, so
+       * this is also the high-water mark.
+       */
+      size_t used;
+      /**
+       * Total bytes in the shared heap range.
+       */
+      size_t capacity;
+      /**
+       * The number of allocations refused because the range was exhausted.
+       * Non-zero means the child has already had allocations fail.
+       */
+      size_t failed_reserves;
+    };
+    /**
+     * Reads the current heap telemetry.  This is a handful of loads
+     * straight from the shared memory region, with no syscalls, so it is
+     * cheap enough to consult on every call into the sandbox.
+     */
+    HeapTelemetry heap_telemetry();
+    /**
+     * Rings the doorbell for calls enqueued by `SandboxedFunction::enqueue`,
+     * waking the child so that it drains every pending call before going
+     * back to sleep.  Call this once per batch, rather than once per call;
+     * that is the entire point of the batching interface.
+     */
+    void flush();
 
   private:
     /**
@@ -306,12 +353,35 @@ namespace sandbox
      */
     template<typename Ret, typename... Args>
     friend class SandboxedFunction;
+    /**
+     * PendingCall needs to wait for the completion of the call that it
+     * represents.
+     */
+    template<typename Ret, typename... Args>
+    friend class PendingCall;
     /**
      * Sends a message to the child process, containing a vtable index and a
      * pointer to the argument frame (a tuple of arguments and space for the
      * return value).
      */
     void send(int idx, void* ptr);
+    /**
+     * Appends a call descriptor (a vtable index and a pointer to the
+     * argument frame) to the submission ring in the shared memory region,
+     * without waking the child.  If the ring is full, this rings the
+     * doorbell and blocks until the child has made space.  Returns a ticket
+     * that can be passed to `wait_for_completion`.
+     *
+     * Like `send`, this interface is not reentrant: calls may be enqueued
+     * from only one thread at a time.
+     */
+    uint32_t enqueue(int idx, void* ptr);
+    /**
+     * Blocks until the child has executed the call identified by `ticket`.
+     * Rings the doorbell while waiting, so the caller does not need to have
+     * called `flush` first.
+     */
+    void wait_for_completion(uint32_t ticket);
     /**
      * Instruct the child to exit and block until it does.  The return value is
      * the exit code of the child process.  If the child has already exited,
@@ -346,6 +416,67 @@ namespace sandbox
     // turn references into pointers.
   };
 
+  /**
+   * A batched call that has been enqueued in the sandbox's submission ring
+   * but whose completion has not yet been observed.  The return value lives
+   * in the argument frame in shared memory until `result` is called.
+   *
+   * Instances are created by `SandboxedFunction::enqueue` and `result` must
+   * be called exactly once, after the batch has been flushed (or directly,
+   * in which case it rings the doorbell itself).
+   */
+  template<typename Ret, typename... Args>
+  class PendingCall
+  {
+    /**
+     * Only the corresponding SandboxedFunction may construct pending calls.
+     */
+    template<typename R, typename... A>
+    friend class SandboxedFunction;
+    /**
+     * The correct argument frame type for this specific instantiation.
+     */
+    using argframe = argframe<Ret, Args...>;
+    /**
+     * The library against which the call was enqueued.
+     */
+    SandboxedLibrary& lib;
+    /**
+     * The argument frame for the call, allocated in the shared region.
+     */
+    argframe* callframe;
+    /**
+     * The completion ticket returned when the call was enqueued.
+     */
+    uint32_t ticket;
+    /**
+     * Constructor, called by `SandboxedFunction::enqueue`.
+     */
+    PendingCall(SandboxedLibrary& l, argframe* frame, uint32_t t)
+    : lib(l), callframe(frame), ticket(t)
+    {}
+
+  public:
+    /**
+     * Waits for the child to execute this call, then frees the argument
+     * frame and returns the result.
+     */
+    Ret result()
+    {
+      lib.wait_for_completion(ticket);
+      if constexpr (!std::is_void_v<Ret>)
+      {
+        Ret r = callframe->ret;
+        lib.free(callframe);
+        return r;
+      }
+      else
+      {
+        lib.free(callframe);
+      }
+    }
+  };
+
   /**
    * A wrapper for invoking a function exported from a sandbox.
    */
@@ -423,6 +554,20 @@ namespace sandbox
         lib.free(callframe);
       }
     }
+    /**
+     * Enqueues a call in the sandbox's submission ring without waking the
+     * child.  Callers should enqueue a whole batch, `flush` the library
+     * once, and then collect the results, amortising the wakeup cost over
+     * the batch.  Enqueued calls execute in enqueue order, before any later
+     * synchronous call through the call operator.
+     */
+    PendingCall<Ret, Args...> enqueue(Args... args)
+    {
+      argframe* callframe = lib.alloc<argframe>();
+      callframe->args = std::forward_as_tuple(args...);
+      uint32_t ticket = lib.enqueue(vtable_index, callframe);
+      return PendingCall<Ret, Args...>(lib, callframe, ticket);
+    }
   };
 
   /**
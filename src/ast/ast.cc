@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: MIT
 #include "ast.h"
 
+#include <unordered_set>
+
 namespace
 {
   auto child_pos(::ast::Ast& parent, ::ast::Ast& child)
@@ -179,20 +181,70 @@ namespace ast
     return ast;
   }
 
+  const Ident* atom(const Ident& id)
+  {
+    // Node-based, so atoms stay valid as the table grows. The pass
+    // pipeline is single-threaded.
+    static std::unordered_set<Ident> table;
+    return &*table.insert(id).first;
+  }
+
+  size_t& scope_epoch()
+  {
+    // Starts above the default SymbolScope epoch, so a scope's cache is
+    // stale until get_def first fills it.
+    static size_t epoch = 1;
+    return epoch;
+  }
+
   Ast get_def(Ast ast, Ident id)
   {
-    while ((ast = get_scope(ast)))
+    auto name = atom(id);
+
+    // Memoize resolutions in the scope the search starts from: references
+    // repeat within a scope, and the chain walk is quadratic in nesting.
+    // Misses are memoized too; adding a symbol invalidates via the epoch.
+    Scope memo;
+    ast = get_scope(ast);
+
+    if (ast)
+    {
+      memo = ast->scope;
+
+      if (memo->epoch == scope_epoch())
+      {
+        auto find = memo->cache.find(name);
+
+        if (find != memo->cache.end())
+          return find->second.lock();
+      }
+      else
+      {
+        memo->cache.clear();
+        memo->epoch = scope_epoch();
+      }
+    }
+
+    Ast def;
+
+    while (ast)
     {
       auto scope = ast->scope;
-      auto find = scope->sym.find(id);
+      auto find = scope->sym.find(name);
 
       if (find != scope->sym.end())
-        return find->second.lock();
+      {
+        def = find->second.lock();
+        break;
+      }
 
-      ast = ast->parent.lock();
+      ast = get_scope(ast->parent.lock());
     }
 
-    return {};
+    if (memo)
+      memo->cache.emplace(name, def);
+
+    return def;
   }
 
   Ast get_prev_in_expr(Ast ast)
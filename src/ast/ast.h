@@ -27,12 +27,29 @@ namespace ast
     size_t id = 0;
   };
 
-  /// Symbol scope (ID -> Ast)
+  /// Symbol scope (interned ID -> Ast)
   struct SymbolScope
   {
-    std::map<Ident, WeakAst> sym;
+    std::map<const Ident*, WeakAst> sym;
+
+    /// Resolutions memoized by `get_def` for searches starting at this
+    /// scope, so repeated references resolve without walking the scope
+    /// chain again. Only valid while `epoch` matches `scope_epoch()`:
+    /// adding a symbol anywhere bumps the epoch, discarding every cache at
+    /// once rather than tracking which searches saw the mutated scope.
+    std::map<const Ident*, WeakAst> cache;
+    size_t epoch = 0;
   };
 
+  /// Intern an identifier. Each distinct name maps to a single atom, so
+  /// atoms compare as pointers; symbol scopes are keyed by atom.
+  const Ident* atom(const Ident& id);
+
+  /// Scope-mutation epoch, bumped whenever a symbol is added to a scope.
+  /// A SymbolScope's memoized resolutions are only valid while its own
+  /// epoch matches this value.
+  size_t& scope_epoch();
+
   /// Create a new token (value node) with name and token value,
   /// using a previous token's source location, position and length.
   Ast token(const Ast& ast, const char* name, const std::string& token);
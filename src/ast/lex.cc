@@ -0,0 +1,333 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include "lex.h"
+
+#include <cstring>
+
+namespace
+{
+  constexpr size_t npos = std::string_view::npos;
+
+  bool is_blank(char c)
+  {
+    return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+  }
+
+  bool is_digit(char c)
+  {
+    return (c >= '0') && (c <= '9');
+  }
+
+  bool is_word_start(char c)
+  {
+    return (c == '_') || ((c >= 'a') && (c <= 'z')) ||
+      ((c >= 'A') && (c <= 'Z'));
+  }
+
+  bool is_word(char c)
+  {
+    return is_word_start(c) || is_digit(c) || (c == '\'');
+  }
+
+  bool is_punct(char c)
+  {
+    return strchr(",()[]{};", c) != nullptr;
+  }
+
+  bool is_sym(char c)
+  {
+    // The sym character class of grammar.peg.
+    return strchr("!#$%&'*+-./:<=>?@\\^`|~", c) != nullptr;
+  }
+
+  /// Scan a plain string. `i` is at the opening quote; returns the index
+  /// past the closing quote, or npos if unterminated.
+  size_t scan_string(std::string_view src, size_t i)
+  {
+    i++;
+
+    while (i < src.size())
+    {
+      if ((src[i] == '\\') && (i + 1 < src.size()) && (src[i + 1] == '"'))
+        i += 2;
+      else if (src[i] == '"')
+        return i + 1;
+      else
+        i++;
+    }
+
+    return npos;
+  }
+
+  size_t scan_code(std::string_view src, size_t i);
+
+  /// Scan an interpolated string, "{ ... }". Nested strings share the
+  /// same delimiters. `i` is at the opening quote.
+  size_t scan_interp(std::string_view src, size_t i)
+  {
+    i += 2;
+
+    while (i < src.size())
+    {
+      if ((src[i] == '}') && (i + 1 < src.size()) && (src[i + 1] == '"'))
+        return i + 2;
+
+      if ((src[i] == '"') && (i + 1 < src.size()) && (src[i + 1] == '{'))
+        i = scan_interp(src, i);
+      else if ((src[i] == '$') && (i + 1 < src.size()) && (src[i + 1] == '{'))
+        i = scan_code(src, i + 2);
+      else
+        i++;
+
+      if (i == npos)
+        return npos;
+    }
+
+    return npos;
+  }
+
+  size_t scan_line_comment(std::string_view src, size_t i)
+  {
+    while ((i < src.size()) && (src[i] != '\r') && (src[i] != '\n'))
+      i++;
+
+    return i;
+  }
+
+  /// Scan a block comment, which nests. `i` is at the opening '/'.
+  size_t scan_block_comment(std::string_view src, size_t i)
+  {
+    i += 2;
+    size_t depth = 1;
+
+    while (i < src.size())
+    {
+      if ((i + 1 < src.size()) && (src[i] == '/') && (src[i + 1] == '*'))
+      {
+        depth++;
+        i += 2;
+      }
+      else if ((i + 1 < src.size()) && (src[i] == '*') && (src[i + 1] == '/'))
+      {
+        i += 2;
+
+        if (--depth == 0)
+          return i;
+      }
+      else
+      {
+        i++;
+      }
+    }
+
+    return npos;
+  }
+
+  /// Scan unquoted code inside an interpolated string, to the brace that
+  /// matches the opening '${'. Strings and comments are skipped whole, so
+  /// braces inside them do not count. `i` is past the opening brace.
+  size_t scan_code(std::string_view src, size_t i)
+  {
+    size_t depth = 1;
+
+    while (i < src.size())
+    {
+      char c = src[i];
+
+      if (c == '{')
+      {
+        depth++;
+        i++;
+      }
+      else if (c == '}')
+      {
+        i++;
+
+        if (--depth == 0)
+          return i;
+      }
+      else if (c == '"')
+      {
+        if ((i + 1 < src.size()) && (src[i + 1] == '{'))
+          i = scan_interp(src, i);
+        else
+          i = scan_string(src, i);
+      }
+      else if ((c == '/') && (i + 1 < src.size()) && (src[i + 1] == '/'))
+      {
+        i = scan_line_comment(src, i);
+      }
+      else if ((c == '/') && (i + 1 < src.size()) && (src[i + 1] == '*'))
+      {
+        i = scan_block_comment(src, i);
+      }
+      else
+      {
+        i++;
+      }
+
+      if (i == npos)
+        return npos;
+    }
+
+    return npos;
+  }
+}
+
+namespace lex
+{
+  std::vector<Token> scan(std::string_view src)
+  {
+    std::vector<Token> tokens;
+    size_t i = 0;
+
+    auto emit = [&](Kind kind, size_t begin, size_t end) {
+      tokens.push_back(
+        {kind,
+         static_cast<uint32_t>(begin),
+         static_cast<uint32_t>(end - begin)});
+    };
+
+    while (i < src.size())
+    {
+      char c = src[i];
+      size_t begin = i;
+
+      if (is_blank(c))
+      {
+        i++;
+        continue;
+      }
+
+      if (
+        (c == '/') && (i + 1 < src.size()) &&
+        ((src[i + 1] == '/') || (src[i + 1] == '*')))
+      {
+        size_t end = (src[i + 1] == '/') ? scan_line_comment(src, i) :
+                                           scan_block_comment(src, i);
+
+        if (end == npos)
+        {
+          emit(Kind::Invalid, begin, src.size());
+          break;
+        }
+
+        emit(Kind::Comment, begin, end);
+        i = end;
+        continue;
+      }
+
+      if (c == '"')
+      {
+        size_t end = ((i + 1 < src.size()) && (src[i + 1] == '{')) ?
+          scan_interp(src, i) :
+          scan_string(src, i);
+
+        if (end == npos)
+        {
+          emit(Kind::Invalid, begin, src.size());
+          break;
+        }
+
+        emit(Kind::String, begin, end);
+        i = end;
+        continue;
+      }
+
+      if (is_word_start(c))
+      {
+        while ((i < src.size()) && is_word(src[i]))
+          i++;
+
+        emit(Kind::Word, begin, i);
+        continue;
+      }
+
+      if (is_digit(c))
+      {
+        // Covers int, float, hex and binary literals; the grammar
+        // distinguishes them.
+        if (
+          (c == '0') && (i + 1 < src.size()) &&
+          ((src[i + 1] == 'x') || (src[i + 1] == 'b')))
+          i += 2;
+
+        while (
+          (i < src.size()) &&
+          (is_digit(src[i]) || is_word(src[i]) || (src[i] == '_')))
+          i++;
+
+        if (
+          (i + 1 < src.size()) && (src[i] == '.') && is_digit(src[i + 1]))
+        {
+          i++;
+
+          while ((i < src.size()) && (is_digit(src[i]) || (src[i] == '_')))
+            i++;
+
+          if (
+            (i + 1 < src.size()) &&
+            ((src[i] == 'e') || (src[i] == 'E')))
+          {
+            size_t j = i + 1;
+
+            if ((j < src.size()) && ((src[j] == '-') || (src[j] == '+')))
+              j++;
+
+            if ((j < src.size()) && is_digit(src[j]))
+            {
+              i = j;
+
+              while ((i < src.size()) && (is_digit(src[i]) || (src[i] == '_')))
+                i++;
+            }
+          }
+        }
+
+        emit(Kind::Number, begin, i);
+        continue;
+      }
+
+      if (is_punct(c))
+      {
+        emit(Kind::Punct, begin, begin + 1);
+        i++;
+        continue;
+      }
+
+      if (is_sym(c))
+      {
+        while ((i < src.size()) && is_sym(src[i]))
+          i++;
+
+        emit(Kind::Sym, begin, i);
+        continue;
+      }
+
+      // A byte no token can start with; stop and let the parser report it.
+      emit(Kind::Invalid, begin, begin + 1);
+      break;
+    }
+
+    return tokens;
+  }
+
+  std::string scrub(std::string_view src, const std::vector<Token>& tokens)
+  {
+    std::string out(src);
+
+    for (const Token& tok : tokens)
+    {
+      if (tok.kind != Kind::Comment)
+        continue;
+
+      for (size_t i = tok.position; i < tok.position + tok.length; i++)
+      {
+        if ((out[i] != '\r') && (out[i] != '\n'))
+          out[i] = ' ';
+      }
+    }
+
+    return out;
+  }
+}
@@ -0,0 +1,51 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lex
+{
+  /// Lexical token kinds, mirroring the lexical layer of grammar.peg.
+  enum class Kind : uint8_t
+  {
+    /// An identifier or keyword (%word).
+    Word,
+    /// An int, float, hex or binary literal.
+    Number,
+    /// A plain or interpolated string, including its delimiters.
+    String,
+    /// A run of symbol characters (sym).
+    Sym,
+    /// A single reserved punctuation character: , ( ) [ ] { } ;
+    Punct,
+    /// A line comment or nested block comment.
+    Comment,
+    /// Input the scanner cannot tokenize, such as an unterminated string
+    /// or comment. Always the last token when present.
+    Invalid,
+  };
+
+  /// A token is a kind plus a range into the source buffer.
+  struct Token
+  {
+    Kind kind;
+    uint32_t position;
+    uint32_t length;
+  };
+
+  /// Scan the source into a compact token stream in a single pass.
+  /// Whitespace is not tokenized. The scanner never fails: anything it
+  /// cannot tokenize ends the stream with an Invalid token, and the
+  /// parser's own diagnostics remain authoritative on malformed input.
+  std::vector<Token> scan(std::string_view src);
+
+  /// Return a copy of `src` in which every comment byte is replaced by a
+  /// space, keeping newlines, so the parser's whitespace rule never
+  /// re-scans comment bodies while every line, column and position in the
+  /// source is unchanged.
+  std::string scrub(std::string_view src, const std::vector<Token>& tokens);
+}
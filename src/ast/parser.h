@@ -4,6 +4,7 @@
 
 #include "ast.h"
 #include "err.h"
+#include "lex.h"
 
 namespace parser
 {
@@ -50,7 +51,15 @@ namespace parser
       err << file << ":" << ln << ":" << col << ": " << msg << err::end;
     };
 
-    if (!parser.parse_n(src.data(), src.size(), ast, file.c_str()))
+    // Pre-lex the source once and blank out comment bodies (keeping
+    // newlines), so the grammar's whitespace rule never re-scans comments
+    // at each backtrack point. Every line, column and position is
+    // unchanged, and the parser's diagnostics remain authoritative on
+    // input the scanner cannot tokenize.
+    auto view = std::string_view(src.data(), src.size());
+    auto scrubbed = lex::scrub(view, lex::scan(view));
+
+    if (!parser.parse_n(scrubbed.data(), scrubbed.size(), ast, file.c_str()))
       return {};
 
     return ast;
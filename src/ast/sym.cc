@@ -21,7 +21,8 @@ namespace
       return;
 
     auto scope = enclosing->scope;
-    auto find = scope->sym.find(id);
+    auto atom = ast::atom(id);
+    auto find = scope->sym.find(atom);
 
     if (find != scope->sym.end())
     {
@@ -30,7 +31,10 @@ namespace
           << "Previous definition of " << id << " is here." << err::end;
     }
 
-    scope->sym.emplace(id, ast);
+    scope->sym.emplace(atom, ast);
+
+    // New definitions invalidate memoized resolutions everywhere.
+    ast::scope_epoch()++;
   }
 
   void id_to_local(ast::Ast& ast, err::Errors& err)
@@ -3,6 +3,8 @@
 #include "compiler/analysis.h"
 
 #include "compiler/dataflow/liveness.h"
+#include "compiler/ir/hoisting.h"
+#include "compiler/ir/inliner.h"
 #include "compiler/ir/print.h"
 #include "compiler/regionck/check_regions.h"
 #include "compiler/source_manager.h"
@@ -10,7 +12,10 @@
 #include "compiler/typecheck/permission_check.h"
 #include "compiler/visitor.h"
 
+#include <algorithm>
+#include <atomic>
 #include <fmt/ostream.h>
+#include <thread>
 
 namespace verona::compiler
 {
@@ -18,8 +23,16 @@ namespace verona::compiler
   {
   public:
     AnalysisVisitor(
-      Context& context, const Program& program, AnalysisResults* results)
-    : context_(context), program_(program), results_(results)
+      Context& context,
+      const Program& program,
+      AnalysisResults* results,
+      size_t typecheck_threads,
+      size_t inline_budget)
+    : context_(context),
+      program_(program),
+      results_(results),
+      typecheck_threads_(typecheck_threads),
+      inline_budget_(inline_budget)
     {}
 
     void visit_program(Program* program)
@@ -30,6 +43,22 @@ namespace verona::compiler
         {
           visit_entity(entity.get());
         }
+      }
+
+      check_assertions(program);
+
+      typecheck_methods();
+
+      for (Method* method : worklist_)
+      {
+        finish_method(method);
+      }
+    }
+
+    void check_assertions(Program* program)
+    {
+      for (const auto& file : program->files)
+      {
         for (const auto& assertion : file->assertions)
         {
           visit_assertion(assertion.get());
@@ -37,6 +66,39 @@ namespace verona::compiler
       }
     }
 
+    /**
+     * Demand-driven entry point: analyse a single method, memoizing the
+     * result. Diagnostics are issued immediately and a failing method
+     * terminates compilation, since the caller is already generating
+     * code and cannot proceed without the analysis.
+     *
+     * Returns nullptr for methods without a body.
+     */
+    const FnAnalysis* demand(Method* method)
+    {
+      auto it = results_->functions.find(method);
+      if (it != results_->functions.end())
+        return &it->second;
+
+      if (!method->body)
+        return nullptr;
+
+      visit_method(method);
+      if (!results_->ok)
+        context_.exit(1);
+
+      FnAnalysis& analysis = results_->functions.at(method);
+      {
+        PassTimer timer(context_, "typecheck", method->path());
+        analysis.typecheck = typecheck(context_, method, *analysis.inference);
+      }
+      finish_method(method);
+      if (!results_->ok)
+        context_.exit(1);
+
+      return &analysis;
+    }
+
   private:
     void visit_entity(Entity* entity)
     {
@@ -106,18 +168,100 @@ namespace verona::compiler
 
       FnAnalysis& analysis = results_->functions[method];
 
-      analysis.ir = build_ir(*method->signature, *method->body);
+      {
+        PassTimer timer(context_, "build_ir", path);
+        analysis.ir = build_ir(*method->signature, *method->body);
+      }
       IRPrinter(*context_.dump(path, "ir")).print("IR", *method, *analysis.ir);
 
-      analysis.liveness = compute_liveness(*analysis.ir);
+      {
+        PassTimer timer(context_, "inline_direct_calls", path);
+        inline_direct_calls(*analysis.ir, inline_budget_);
+      }
+      IRPrinter(*context_.dump(path, "inlined-ir"))
+        .print("Inlined IR", *method, *analysis.ir);
+
+      {
+        PassTimer timer(context_, "hoist_loop_invariants", path);
+        hoist_loop_invariants(*analysis.ir);
+      }
+      IRPrinter(*context_.dump(path, "hoisted-ir"))
+        .print("Hoisted IR", *method, *analysis.ir);
+
+      {
+        PassTimer timer(context_, "compute_liveness", path);
+        analysis.liveness = compute_liveness(*analysis.ir);
+      }
       IRPrinter(*context_.dump(path, "liveness"))
         .with_liveness(*analysis.liveness)
         .print("Liveness Analysis", *method, *analysis.ir);
 
-      analysis.inference =
-        infer(context_, program_, *method, *analysis.ir, *analysis.liveness);
+      {
+        PassTimer timer(context_, "infer", path);
+        analysis.inference =
+          infer(context_, program_, *method, *analysis.ir, *analysis.liveness);
+      }
+
+      // Constraint solving is by far the most expensive pass and each
+      // method's constraints are independent, so it is deferred to
+      // typecheck_methods, which solves the collected worklist across a
+      // pool of worker threads.
+      worklist_.push_back(method);
+    }
+
+    /**
+     * Solve the constraints of every method in the worklist concurrently.
+     *
+     * Each worker only reads the shared Program and writes the typecheck
+     * field of its method's FnAnalysis, whose map entry was already
+     * created by visit_method, so the results map itself is never mutated
+     * here. Type interning is serialized inside the TypeInterner, and
+     * each worker uses its own memoizing mappers (see Context::polarizer).
+     *
+     * Diagnostics and the remaining per-method passes are issued by
+     * finish_method afterwards, in visitor order, making the output
+     * independent of how methods were scheduled onto threads.
+     */
+    void typecheck_methods()
+    {
+      std::atomic<size_t> next{0};
+      auto work = [&]() {
+        ThreadContext thread_context(context_);
+        while (true)
+        {
+          size_t index = next.fetch_add(1, std::memory_order_relaxed);
+          if (index >= worklist_.size())
+            break;
+
+          Method* method = worklist_[index];
+          FnAnalysis& analysis = results_->functions.at(method);
+          PassTimer timer(context_, "typecheck", method->path());
+          analysis.typecheck =
+            typecheck(context_, method, *analysis.inference);
+        }
+      };
+
+      size_t threads = std::min(typecheck_threads_, worklist_.size());
+      std::vector<std::thread> workers;
+      for (size_t i = 1; i < threads; i++)
+      {
+        workers.emplace_back(work);
+      }
+
+      // The visiting thread participates as well.
+      work();
+
+      for (auto& worker : workers)
+      {
+        worker.join();
+      }
+    }
+
+    void finish_method(Method* method)
+    {
+      std::string path = method->path();
+      FnAnalysis& analysis = results_->functions.at(method);
 
-      analysis.typecheck = typecheck(context_, method, *analysis.inference);
       if (!analysis.typecheck)
       {
         report(
@@ -134,21 +278,32 @@ namespace verona::compiler
         .with_types(*analysis.typecheck)
         .print("Typed IR", *method, *analysis.ir);
 
-      if (!check_permissions(context_, *analysis.ir, *analysis.typecheck))
       {
-        results_->ok = false;
+        PassTimer timer(context_, "check_permissions", path);
+        if (!check_permissions(context_, *analysis.ir, *analysis.typecheck))
+        {
+          results_->ok = false;
+        }
       }
 
-      analysis.region_graphs =
-        make_region_graphs(context_, *method, *analysis.typecheck);
+      {
+        PassTimer timer(context_, "region_graphs", path);
+        analysis.region_graphs =
+          make_region_graphs(context_, *method, *analysis.typecheck);
 
-      CheckRegions(context_, *analysis.typecheck, *analysis.region_graphs)
-        .process(*analysis.ir);
+        CheckRegions(context_, *analysis.typecheck, *analysis.region_graphs)
+          .process(*analysis.ir);
+      }
     }
 
     Context& context_;
     const Program& program_;
     AnalysisResults* results_;
+    size_t typecheck_threads_;
+    size_t inline_budget_;
+
+    /// Methods awaiting constraint solving, in visitor order.
+    std::vector<Method*> worklist_;
   };
 
   /**
@@ -203,17 +358,67 @@ namespace verona::compiler
     const std::string& name_;
   };
 
-  std::unique_ptr<AnalysisResults> analyse(Context& context, Program* program)
+  std::unique_ptr<AnalysisResults> analyse(
+    Context& context,
+    Program* program,
+    size_t typecheck_threads,
+    size_t inline_budget)
   {
+    if (typecheck_threads == 0)
+      typecheck_threads = std::max<size_t>(
+        std::thread::hardware_concurrency(), 1);
+
     auto results = std::make_unique<AnalysisResults>();
     results->ok = true;
 
-    AnalysisVisitor visitor(context, *program, results.get());
+    AnalysisVisitor visitor(
+      context, *program, results.get(), typecheck_threads, inline_budget);
     visitor.visit_program(program);
 
     return results;
   }
 
+  std::unique_ptr<AnalysisResults>
+  analyse_lazy(Context& context, Program* program, size_t inline_budget)
+  {
+    auto results = std::make_unique<AnalysisResults>();
+    results->ok = true;
+
+    // The visitor lives as long as the demand hook, which codegen's
+    // reachability walk calls while the results are alive. Laziness is
+    // only useful for a single consumer, so demands are not threaded.
+    auto visitor = std::make_shared<AnalysisVisitor>(
+      context, *program, results.get(), size_t(1), inline_budget);
+    visitor->check_assertions(program);
+
+    results->demand = [visitor](const Method* method) {
+      return visitor->demand(const_cast<Method*>(method));
+    };
+
+    return results;
+  }
+
+  void AnalysisResults::release_method(const Method* method)
+  {
+    FnAnalysis& analysis = functions.at(method);
+    analysis.region_graphs.reset();
+    analysis.liveness.reset();
+    analysis.typecheck.reset();
+    analysis.inference.reset();
+    analysis.ir.reset();
+  }
+
+  const FnAnalysis&
+  AnalysisResults::method_analysis(const Method* method) const
+  {
+    if (demand)
+    {
+      if (const FnAnalysis* analysis = demand(method))
+        return *analysis;
+    }
+    return functions.at(method);
+  }
+
   void dump_ast(Context& context, Program* program, const std::string& name)
   {
     DumpAST visitor(context, name);
@@ -7,6 +7,8 @@
 #include "compiler/regionck/region_graph.h"
 #include "compiler/typecheck/typecheck.h"
 
+#include <functional>
+
 namespace verona::compiler
 {
   struct FnAnalysis
@@ -22,9 +24,61 @@ namespace verona::compiler
   {
     std::unordered_map<const Method*, FnAnalysis> functions;
     bool ok;
+
+    /**
+     * When set (see analyse_lazy), computes the analysis of a method
+     * and memoizes it in `functions` on first use.
+     */
+    std::function<const FnAnalysis*(const Method*)> demand;
+
+    /**
+     * Access the analysis of a method with a body, computing it on
+     * demand in lazy mode.
+     */
+    const FnAnalysis& method_analysis(const Method* method) const;
+
+    /**
+     * Free the analysis artifacts of a method that nothing will read
+     * again. Codegen calls this once it has emitted the last reachable
+     * instantiation of the method, so peak memory is bounded by the
+     * methods still in flight rather than the whole program. The map
+     * entry itself remains: releasing only resets its fields, which
+     * keeps concurrent lookups of other methods safe, but the method
+     * must not be demanded again afterwards.
+     */
+    void release_method(const Method* method);
   };
 
-  std::unique_ptr<AnalysisResults> analyse(Context& context, Program* program);
+  /**
+   * Analyse every method of the program.
+   *
+   * Constraint solving, the expensive part of typechecking, runs across
+   * `typecheck_threads` worker threads; zero means one thread per
+   * hardware core. Diagnostics and results are deterministic regardless
+   * of the thread count.
+   *
+   * `inline_budget` is the maximum callee size, in IR statements, that
+   * inline_direct_calls will splice into a caller; zero disables
+   * inlining.
+   */
+  std::unique_ptr<AnalysisResults> analyse(
+    Context& context,
+    Program* program,
+    size_t typecheck_threads = 0,
+    size_t inline_budget = 8);
+
+  /**
+   * Demand-driven flavour of analyse, for uses that only need a slice
+   * of the program. No method is analysed up front; instead the
+   * reachability walk in codegen pulls analyses through the returned
+   * results' `demand` hook for exactly the methods it can reach from
+   * the entry point. Static assertions are still checked eagerly.
+   *
+   * Diagnostics of demanded methods are issued as they are computed;
+   * a failing method terminates compilation at that point.
+   */
+  std::unique_ptr<AnalysisResults>
+  analyse_lazy(Context& context, Program* program, size_t inline_budget = 8);
 
   void dump_ast(Context& context, Program* program, const std::string& name);
 }
@@ -0,0 +1,102 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * Bump-pointer arenas for compiler-lifetime allocations.
+ *
+ * The compiler builds large graphs of small, immutable objects (most
+ * notably interned types) that all die together at the end of the
+ * compilation. Allocating them individually is pure malloc churn; an
+ * arena hands them out by advancing a pointer through large chunks and
+ * releases everything wholesale when it is destroyed. Nothing is ever
+ * freed individually, so the arena must outlive every object allocated
+ * from it.
+ */
+namespace verona::compiler
+{
+  class Arena
+  {
+  public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t alignment)
+    {
+      void* result = std::align(alignment, size, current_, remaining_);
+      if (result == nullptr)
+      {
+        // Oversized allocations get a chunk of their own.
+        size_t chunk_size = std::max(size + alignment, CHUNK_SIZE);
+        chunks_.push_back(std::make_unique<std::byte[]>(chunk_size));
+        current_ = chunks_.back().get();
+        remaining_ = chunk_size;
+        result = std::align(alignment, size, current_, remaining_);
+      }
+
+      current_ = static_cast<std::byte*>(current_) + size;
+      remaining_ -= size;
+      return result;
+    }
+
+  private:
+    static constexpr size_t CHUNK_SIZE = 1 << 20;
+
+    std::vector<std::unique_ptr<std::byte[]>> chunks_;
+    void* current_ = nullptr;
+    size_t remaining_ = 0;
+  };
+
+  /**
+   * Standard-library compatible allocator handing out memory from an
+   * Arena. Deallocation is a no-op, so this only suits containers that
+   * grow monotonically and are destroyed with (or before) the arena.
+   */
+  template<typename T>
+  class ArenaAllocator
+  {
+  public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena* arena) : arena_(arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena())
+    {}
+
+    T* allocate(size_t count)
+    {
+      return static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) {}
+
+    Arena* arena() const
+    {
+      return arena_;
+    }
+
+  private:
+    Arena* arena_;
+  };
+
+  template<typename T, typename U>
+  bool
+  operator==(const ArenaAllocator<T>& left, const ArenaAllocator<U>& right)
+  {
+    return left.arena() == right.arena();
+  }
+
+  template<typename T, typename U>
+  bool
+  operator!=(const ArenaAllocator<T>& left, const ArenaAllocator<U>& right)
+  {
+    return !(left == right);
+  }
+}
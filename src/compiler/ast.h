@@ -14,10 +14,13 @@
 
 using pegmatite::ASTChild;
 using pegmatite::ASTConstant;
-using pegmatite::ASTContainer;
 using pegmatite::ASTList;
 using pegmatite::ASTPtr;
 
+// All container nodes go through the arena-backed mixin, so that every node
+// pegmatite allocates for us lands in the context's arena.
+using ASTContainer = verona::compiler::ArenaAllocated<pegmatite::ASTContainer>;
+
 namespace verona::compiler
 {
   struct Expression;
@@ -62,7 +65,7 @@ namespace verona::compiler
     const Name& name() const;
   };
 
-  struct StringLiteral : public pegmatite::ASTString
+  struct StringLiteral : public ArenaAllocated<pegmatite::ASTString>
   {
     bool construct(
       const pegmatite::InputRange& r,
@@ -127,7 +130,7 @@ namespace verona::compiler
   /**
    * AST Node for identifiers. Has an associated source location.
    */
-  struct Name : public SourceLocatableMixin<pegmatite::ASTString>
+  struct Name : public SourceLocatableMixin<ArenaAllocated<pegmatite::ASTString>>
   {};
 
   /**
@@ -136,7 +139,7 @@ namespace verona::compiler
    * Pointers to LocalDef are used throughout the compiler to uniquely identify
    * a given local variable, possibly through the opaque LocalID wrapper.
    */
-  struct LocalDef : public pegmatite::ASTContainer
+  struct LocalDef : public ASTContainer
   {
     ASTChild<Name> name;
 
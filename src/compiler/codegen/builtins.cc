@@ -74,6 +74,57 @@ namespace verona::compiler
       else if (method == "_fulfill_sleeping")
         return builtin_cown_fulfill_sleeping();
     }
+    else if (entity == "String")
+    {
+      if (method == "eq")
+        return builtin_string_op(bytecode::StringOperator::Eq);
+      else if (method == "ne")
+        return builtin_string_op(bytecode::StringOperator::Ne);
+      else if (method == "lt")
+        return builtin_string_op(bytecode::StringOperator::Lt);
+      else if (method == "le")
+        return builtin_string_op(bytecode::StringOperator::Le);
+      else if (method == "gt")
+        return builtin_string_op(bytecode::StringOperator::Gt);
+      else if (method == "ge")
+        return builtin_string_op(bytecode::StringOperator::Ge);
+      else if (method == "find")
+        return builtin_string_op(bytecode::StringOperator::Find);
+      else if (method == "hash")
+        return builtin_string_hash();
+    }
+    else if (entity == "Array")
+    {
+      if (method == "create")
+        return builtin_array_create();
+      else if (method == "get")
+        return builtin_array_get();
+      else if (method == "put")
+        return builtin_array_put();
+      else if (method == "size")
+        return builtin_array_size();
+      else if (method == "copy")
+        return builtin_array_copy();
+      else if (method == "fill")
+        return builtin_array_fill();
+      else if (method == "compare")
+        return builtin_array_compare();
+    }
+    else if (entity == "Map")
+    {
+      if (method == "create")
+        return builtin_map_create();
+      else if (method == "get")
+        return builtin_map_get();
+      else if (method == "put")
+        return builtin_map_put();
+      else if (method == "contains")
+        return builtin_map_contains();
+      else if (method == "remove")
+        return builtin_map_remove();
+      else if (method == "size")
+        return builtin_map_size();
+    }
     fmt::print(stderr, "Invalid builtin {}.{}\n", entity, method);
     abort();
   }
@@ -132,6 +183,27 @@ namespace verona::compiler
     emit<Opcode::Return>();
   }
 
+  void BuiltinGenerator::builtin_string_op(bytecode::StringOperator op)
+  {
+    assert(abi_.arguments == 2);
+    assert(abi_.returns == 1);
+
+    emit<Opcode::StringOp>(Register(0), op, Register(0), Register(1));
+    emit<Opcode::Clear>(Register(1));
+    emit<Opcode::Return>();
+  }
+
+  void BuiltinGenerator::builtin_string_hash()
+  {
+    assert(abi_.arguments == 1);
+    assert(abi_.returns == 1);
+
+    // Hash ignores its second operand; the receiver is passed twice.
+    emit<Opcode::StringOp>(
+      Register(0), bytecode::StringOperator::Hash, Register(0), Register(0));
+    emit<Opcode::Return>();
+  }
+
   void BuiltinGenerator::builtin_cown_create()
   {
     assert(abi_.arguments == 2);
@@ -164,4 +236,159 @@ namespace verona::compiler
     emit<Opcode::ClearList>(bytecode::RegisterSpan{Register(0), Register(1)});
     emit<Opcode::Return>();
   }
+
+  void BuiltinGenerator::builtin_array_create()
+  {
+    assert(abi_.arguments == 3);
+    assert(abi_.returns == 1);
+
+    // This is a static method, therefore register 0 contains the descriptor
+    // for Array[T]. We use that to allocate the array, in the region of the
+    // parent object passed in register 1.
+    emit<Opcode::NewArray>(
+      Register(0), Register(1), Register(0), Register(2));
+    emit<Opcode::ClearList>(bytecode::RegisterSpan{Register(1), Register(2)});
+    emit<Opcode::Return>();
+  }
+
+  void BuiltinGenerator::builtin_array_get()
+  {
+    assert(abi_.arguments == 2);
+    assert(abi_.returns == 1);
+
+    emit<Opcode::ArrayLoad>(Register(0), Register(0), Register(1));
+    emit<Opcode::Clear>(Register(1));
+    emit<Opcode::Return>();
+  }
+
+  void BuiltinGenerator::builtin_array_put()
+  {
+    assert(abi_.arguments == 3);
+    assert(abi_.returns == 1);
+
+    // The store's result is the slot's previous value, which `put` does not
+    // return: it is written to register 0 and cleared with the arguments.
+    emit<Opcode::ArrayStore>(
+      Register(0), Register(0), Register(1), Register(2));
+    emit<Opcode::ClearList>(
+      bytecode::RegisterSpan{Register(0), Register(1), Register(2)});
+    emit<Opcode::Return>();
+  }
+
+  void BuiltinGenerator::builtin_array_size()
+  {
+    assert(abi_.arguments == 1);
+    assert(abi_.returns == 1);
+
+    emit<Opcode::ArrayLength>(Register(0), Register(0));
+    emit<Opcode::Return>();
+  }
+
+  void BuiltinGenerator::builtin_map_create()
+  {
+    assert(abi_.arguments == 2);
+    assert(abi_.returns == 1);
+
+    // This is a static method, therefore register 0 contains the descriptor
+    // for Map[K, V]. We use that to allocate the map, in the region of the
+    // parent object passed in register 1.
+    emit<Opcode::NewMap>(Register(0), Register(1), Register(0));
+    emit<Opcode::Clear>(Register(1));
+    emit<Opcode::Return>();
+  }
+
+  void BuiltinGenerator::builtin_map_get()
+  {
+    assert(abi_.arguments == 2);
+    assert(abi_.returns == 1);
+
+    emit<Opcode::MapGet>(Register(0), Register(0), Register(1));
+    emit<Opcode::Clear>(Register(1));
+    emit<Opcode::Return>();
+  }
+
+  void BuiltinGenerator::builtin_map_put()
+  {
+    assert(abi_.arguments == 3);
+    assert(abi_.returns == 1);
+
+    // The insert's result is the key's previous value, which `put` does not
+    // return: it is written to register 0 and cleared with the arguments.
+    emit<Opcode::MapInsert>(
+      Register(0), Register(0), Register(1), Register(2));
+    emit<Opcode::ClearList>(
+      bytecode::RegisterSpan{Register(0), Register(1), Register(2)});
+    emit<Opcode::Return>();
+  }
+
+  void BuiltinGenerator::builtin_map_contains()
+  {
+    assert(abi_.arguments == 2);
+    assert(abi_.returns == 1);
+
+    emit<Opcode::MapContains>(Register(0), Register(0), Register(1));
+    emit<Opcode::Clear>(Register(1));
+    emit<Opcode::Return>();
+  }
+
+  void BuiltinGenerator::builtin_map_remove()
+  {
+    assert(abi_.arguments == 2);
+    assert(abi_.returns == 1);
+
+    emit<Opcode::MapRemove>(Register(0), Register(0), Register(1));
+    emit<Opcode::Clear>(Register(1));
+    emit<Opcode::Return>();
+  }
+
+  void BuiltinGenerator::builtin_map_size()
+  {
+    assert(abi_.arguments == 1);
+    assert(abi_.returns == 1);
+
+    emit<Opcode::MapSize>(Register(0), Register(0));
+    emit<Opcode::Return>();
+  }
+
+  void BuiltinGenerator::builtin_array_copy()
+  {
+    assert(abi_.arguments == 5);
+    assert(abi_.returns == 1);
+
+    emit<Opcode::ArrayCopy>(
+      Register(0), Register(1), Register(2), Register(3), Register(4));
+    emit<Opcode::ClearList>(bytecode::RegisterSpan{
+      Register(0), Register(1), Register(2), Register(3), Register(4)});
+    emit<Opcode::Return>();
+  }
+
+  void BuiltinGenerator::builtin_array_fill()
+  {
+    assert(abi_.arguments == 4);
+    assert(abi_.returns == 1);
+
+    emit<Opcode::ArrayFill>(
+      Register(0), Register(1), Register(2), Register(3));
+    emit<Opcode::ClearList>(bytecode::RegisterSpan{
+      Register(0), Register(1), Register(2), Register(3)});
+    emit<Opcode::Return>();
+  }
+
+  void BuiltinGenerator::builtin_array_compare()
+  {
+    assert(abi_.arguments == 5);
+    assert(abi_.returns == 1);
+
+    // The comparison result overwrites the receiver in register 0.
+    emit<Opcode::ArrayCompare>(
+      Register(0),
+      Register(0),
+      Register(1),
+      Register(2),
+      Register(3),
+      Register(4));
+    emit<Opcode::ClearList>(bytecode::RegisterSpan{
+      Register(1), Register(2), Register(3), Register(4)});
+    emit<Opcode::Return>();
+  }
 }
@@ -26,8 +26,23 @@ namespace verona::compiler
     void builtin_freeze();
     void builtin_trace_region();
     void builtin_binop(bytecode::BinaryOperator op);
+    void builtin_string_op(bytecode::StringOperator op);
+    void builtin_string_hash();
     void builtin_cown_create();
     void builtin_cown_create_sleeping();
     void builtin_cown_fulfill_sleeping();
+    void builtin_array_create();
+    void builtin_array_get();
+    void builtin_array_put();
+    void builtin_array_size();
+    void builtin_array_copy();
+    void builtin_array_fill();
+    void builtin_array_compare();
+    void builtin_map_create();
+    void builtin_map_get();
+    void builtin_map_put();
+    void builtin_map_contains();
+    void builtin_map_remove();
+    void builtin_map_size();
   };
 }
@@ -98,7 +98,7 @@ namespace verona::compiler
   }
 
   std::vector<uint8_t> codegen(
-    Context& context, const Program& program, const AnalysisResults& analysis)
+    Context& context, const Program& program, AnalysisResults& analysis)
   {
     auto entry = find_entry(context, program);
     if (!entry)
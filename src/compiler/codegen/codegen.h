@@ -12,5 +12,5 @@ namespace verona::compiler
    * Any errors during codegen will be reported in the context.
    */
   std::vector<uint8_t> codegen(
-    Context& context, const Program& program, const AnalysisResults& analysis);
+    Context& context, const Program& program, AnalysisResults& analysis);
 }
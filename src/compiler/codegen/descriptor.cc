@@ -73,6 +73,17 @@ namespace verona::compiler
       else
         gen.u32(0);
 
+      // Descriptor flags. Bit 0 marks the builtin Array class, whose
+      // instances carry contiguous element storage, and bit 1 the builtin
+      // Map class, whose instances carry a hash table (see
+      // interpreter/object.h).
+      uint32_t flags = 0;
+      if (entity.definition->name == "Array")
+        flags = 1;
+      else if (entity.definition->name == "Map")
+        flags = 2;
+      gen.u32(flags);
+
       uint32_t method_slots = emit_methods(info);
       auto [field_slots, field_count] = emit_fields(entity);
       emit_subtypes(info);
@@ -92,6 +103,7 @@ namespace verona::compiler
       gen.u32(0); // field_count
       gen.u32(truncate<uint32_t>(info.subtypes.size()));
       gen.u32(0); // finaliser
+      gen.u32(0); // flags
       emit_subtypes(info);
     }
 
@@ -5,10 +5,17 @@
 #include "compiler/codegen/builtins.h"
 #include "compiler/codegen/ir.h"
 #include "compiler/printing.h"
+#include "compiler/resolution.h"
+#include "compiler/type_visitor.h"
 #include "compiler/typecheck/typecheck.h"
 #include "compiler/visitor.h"
 #include "compiler/zip.h"
 
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
 namespace verona::compiler
 {
   using bytecode::DescriptorIdx;
@@ -61,6 +68,103 @@ namespace verona::compiler
     gen_.define_relocatable(frame_size_, allocator_.frame_size());
   }
 
+  namespace
+  {
+    /**
+     * Collect the entities a dispatch on the receiver type could select.
+     *
+     * This mirrors the walk reachability performs for call statements
+     * (see CallReachability in reachability.cc): whatever that walk would
+     * have made reachable is exactly the set of possible targets.
+     */
+    struct ReceiverEntities : public TypeVisitor<>
+    {
+      std::vector<std::pair<const Entity*, TypeList>> entities;
+
+      void add(const Entity* entity, const TypeList& arguments)
+      {
+        for (const auto& [other, other_arguments] : entities)
+        {
+          if (other == entity && other_arguments == arguments)
+            return;
+        }
+        entities.push_back({entity, arguments});
+      }
+
+      void visit_static_type(const StaticTypePtr& ty) final
+      {
+        add(ty->definition, ty->arguments);
+      }
+
+      void visit_entity_type(const EntityTypePtr& ty) final
+      {
+        add(ty->definition, ty->arguments);
+      }
+
+      void visit_union(const UnionTypePtr& ty) final
+      {
+        visit_types(ty->elements);
+      }
+
+      void visit_intersection(const IntersectionTypePtr& ty) final
+      {
+        visit_types(ty->elements);
+      }
+
+      void visit_variable_renaming_type(const VariableRenamingTypePtr& ty) final
+      {}
+
+      void visit_capability(const CapabilityTypePtr& ty) final {}
+    };
+  }
+
+  std::optional<Label> find_unique_call_target(
+    Context& context,
+    const Reachability& reachability,
+    const TypePtr& receiver,
+    const std::string& method_name,
+    const TypeList& call_arguments)
+  {
+    ReceiverEntities walk;
+    walk.visit_type(receiver);
+
+    if (walk.entities.size() != 1)
+      return std::nullopt;
+
+    CodegenItem<Entity> entity(
+      walk.entities.front().first,
+      Instantiation(walk.entities.front().second));
+    const CodegenItem<Entity>& canonical =
+      reachability.normalize_equivalence(entity);
+
+    const EntityReachability* info = reachability.try_find_entity(canonical);
+    if (info == nullptr)
+      return std::nullopt;
+
+    // An interface dispatch selects the concrete receiver's method, which
+    // could be any of the subtypes'.
+    if (!info->subtypes.empty())
+      return std::nullopt;
+
+    const Method* target =
+      lookup_member<Method>(canonical.definition, method_name);
+    if (target == nullptr)
+      return std::nullopt;
+
+    // The method's instantiation combines the entity's type arguments
+    // with the call's, matching how reachability registered it.
+    TypeList arguments = canonical.instantiation.types();
+    arguments.insert(
+      arguments.end(), call_arguments.begin(), call_arguments.end());
+
+    auto it = info->methods.find(
+      CodegenItem<Method>(target, Instantiation(arguments)));
+    if (it == info->methods.end())
+      return std::nullopt;
+
+    return it->second.label;
+  }
+
   void emit_function(
     Context& context,
     const Reachability& reachability,
@@ -107,11 +211,16 @@ namespace verona::compiler
 
   void emit_functions(
     Context& context,
-    const AnalysisResults& analysis,
+    AnalysisResults& analysis,
     const Reachability& reachability,
     const SelectorTable& selectors,
     Generator& gen)
   {
+    // Method bodies are independent once reachability is fixed, so each
+    // one is emitted into its own child generator, across a pool of
+    // worker threads. The chunks are appended in collection order, so
+    // the output bytecode is identical to serial emission.
+    std::vector<std::pair<const CodegenItem<Method>*, Label>> items;
     for (const auto& [entity, entity_info] : reachability.entities)
     {
       for (const auto& [method, method_info] : entity_info.methods)
@@ -119,19 +228,103 @@ namespace verona::compiler
         if (!method_info.label.has_value())
           continue;
 
-        gen.define_label(method_info.label.value());
-        if (method.definition->kind() == Method::Builtin)
+        // Touch the analysis now: in lazy mode this computes and
+        // memoizes it, leaving only read-only lookups to the workers.
+        if (method.definition->kind() != Method::Builtin)
+          analysis.method_analysis(method.definition);
+
+        items.push_back({&method, method_info.label.value()});
+      }
+    }
+
+    // Instantiations left to emit per method definition. A worker that
+    // finishes the last one releases the definition's analysis
+    // artifacts, so the peak over the whole emission is the analyses of
+    // the methods still in flight, not of the entire program. Only the
+    // counters are shared; releasing resets fields of one map entry and
+    // never mutates the map itself.
+    std::unordered_map<const Method*, std::atomic<size_t>> remaining;
+    for (const auto& [method, label] : items)
+    {
+      if (method->definition->kind() == Method::Builtin)
+        continue;
+
+      auto it = remaining.find(method->definition);
+      if (it == remaining.end())
+        remaining.emplace(method->definition, 1);
+      else
+        it->second.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::vector<std::unique_ptr<Generator>> chunks;
+    for (size_t i = 0; i < items.size(); i++)
+    {
+      chunks.push_back(std::make_unique<Generator>(gen));
+    }
+
+    std::atomic<size_t> next{0};
+    auto work = [&]() {
+      ThreadContext thread_context(context);
+      while (true)
+      {
+        size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= items.size())
+          break;
+
+        const auto& [method, label] = items[index];
+        Generator& chunk = *chunks[index];
+
+        chunk.define_label(label);
+        if (method->definition->kind() == Method::Builtin)
         {
-          BuiltinGenerator::generate(context, gen, method);
+          BuiltinGenerator::generate(context, chunk, *method);
         }
         else
         {
           const FnAnalysis& fn_analysis =
-            analysis.functions.at(method.definition);
+            analysis.method_analysis(method->definition);
           emit_function(
-            context, reachability, selectors, gen, method, fn_analysis);
+            context, reachability, selectors, chunk, *method, fn_analysis);
+
+          // Stream the analysis out once its last instantiation is
+          // emitted. The acquire-release pair orders every worker's
+          // reads of the analysis before the release.
+          if (
+            remaining.at(method->definition)
+              .fetch_sub(1, std::memory_order_acq_rel) == 1)
+            analysis.release_method(method->definition);
         }
       }
+    };
+
+    size_t threads =
+      std::min<size_t>(std::thread::hardware_concurrency(), items.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; i++)
+    {
+      workers.emplace_back(work);
+    }
+
+    // The calling thread participates as well.
+    work();
+
+    for (auto& worker : workers)
+    {
+      worker.join();
+    }
+
+    // The combined size is known up front, so the output buffer can be
+    // grown once rather than reallocating as chunks are appended.
+    size_t total = gen.current_offset();
+    for (auto& chunk : chunks)
+    {
+      total += chunk->current_offset();
+    }
+    gen.reserve(total);
+
+    for (auto& chunk : chunks)
+    {
+      gen.append(*chunk);
     }
   }
 }
@@ -26,11 +26,28 @@ namespace verona::compiler
 
   void emit_functions(
     Context& context,
-    const AnalysisResults& analysis,
+    AnalysisResults& analysis,
     const Reachability& reachability,
     const SelectorTable& selectors,
     Generator& gen);
 
+  /**
+   * Find the label of the unique method a call could dispatch to, if
+   * reachability proves there is exactly one.
+   *
+   * `receiver` must already be reified for the calling method's
+   * instantiation, and `call_arguments` are the reified type arguments of
+   * the call. Returns nullopt when the receiver may be more than one
+   * class (or an interface), in which case the call must stay a dynamic
+   * dispatch through the selector table.
+   */
+  std::optional<Label> find_unique_call_target(
+    Context& context,
+    const Reachability& reachability,
+    const TypePtr& receiver,
+    const std::string& method_name,
+    const TypeList& call_arguments);
+
   struct FunctionABI
   {
     explicit FunctionABI(const FnSignature& sig)
@@ -5,6 +5,7 @@
 #include "ds/helpers.h"
 
 #include <cassert>
+#include <unordered_map>
 
 namespace verona::compiler
 {
@@ -85,35 +86,40 @@ namespace verona::compiler
       }
 
       assert(rel.offset + rel.width <= code_.size());
+      patch(code_, rel, *slot);
+    }
+  }
 
-      // Checks after making the relative value that it is a valid signed or
-      // unsigned value of the correct size.  That is it hasn't overflowed
-      // the n-bit value.
-      uint64_t value = *slot - rel.relative_to;
-      if (rel.width != 8)
+  void Generator::patch(
+    std::vector<uint8_t>& code, const Relocation& rel, RelocationValue target)
+  {
+    // Checks after making the relative value that it is a valid signed or
+    // unsigned value of the correct size.  That is it hasn't overflowed
+    // the n-bit value.
+    uint64_t value = target - rel.relative_to;
+    if (rel.width != 8)
+    {
+      size_t shift = (8 - rel.width) * 8;
+      if (rel.is_signed)
       {
-        size_t shift = (8 - rel.width) * 8;
-        if (rel.is_signed)
-        {
-          // Check that all the bits beyond the value when restricted to
-          // its size, are the same as the top bit.
-          if (value != (((int64_t)value) << shift) >> shift)
-            abort();
-        }
-        else
-        {
-          // Check top bits are all zero.
-          if (value != (value << shift) >> shift)
-            abort();
-        }
+        // Check that all the bits beyond the value when restricted to
+        // its size, are the same as the top bit.
+        if (value != (((int64_t)value) << shift) >> shift)
+          abort();
       }
-
-      // Write back the relocated value
-      for (int i = 0; i < rel.width; i++)
+      else
       {
-        code_.at(rel.offset + i) = (value >> (i * 8)) & 0xff;
+        // Check top bits are all zero.
+        if (value != (value << shift) >> shift)
+          abort();
       }
     }
+
+    // Write back the relocated value
+    for (int i = 0; i < rel.width; i++)
+    {
+      code.at(rel.offset + i) = (value >> (i * 8)) & 0xff;
+    }
   }
 
   void Generator::add_relocation(
@@ -130,6 +136,10 @@ namespace verona::compiler
 
   Generator::Relocatable Generator::create_relocatable()
   {
+    if (parent_ != nullptr)
+      return parent_->create_relocatable();
+
+    std::lock_guard<std::mutex> guard(handles_mutex_);
     size_t index = relocatables_.size();
     relocatables_.push_back(std::nullopt);
     return Relocatable(index);
@@ -148,6 +158,10 @@ namespace verona::compiler
   void
   Generator::define_relocatable(Relocatable relocatable, RelocationValue value)
   {
+    if (parent_ != nullptr)
+      return parent_->define_relocatable(relocatable, value);
+
+    std::lock_guard<std::mutex> guard(handles_mutex_);
     std::optional<RelocationValue>& slot = relocatables_.at(relocatable.index);
     if (slot.has_value())
       throw std::logic_error("Relocatable already has a value");
@@ -157,6 +171,69 @@ namespace verona::compiler
 
   void Generator::define_label(Label label)
   {
+    // The label's target must remain an instruction start, so the next
+    // instruction cannot be fused into the tail of its predecessor.
+    last_instruction_.reset();
+
+    if (parent_ != nullptr)
+    {
+      pending_labels_.push_back({label.relocatable.index, current_offset()});
+      return;
+    }
+
     define_relocatable(label, current_offset());
   }
+
+  void Generator::append(Generator& child)
+  {
+    assert(child.parent_ == this);
+
+    size_t base = code_.size();
+
+    std::unordered_map<size_t, size_t> local_labels;
+    for (const auto& [index, offset] : child.pending_labels_)
+    {
+      local_labels.insert({index, offset});
+    }
+
+    for (const auto& rel : child.relocations_)
+    {
+      // Relocations whose target label is defined within the same chunk
+      // are patched in place, before the bytes are copied: the site and
+      // the target shift by the same base, so relative values are already
+      // final and absolute ones just need the base added. Only
+      // cross-chunk references are kept for finish.
+      if (auto local = local_labels.find(rel.index);
+          local != local_labels.end())
+      {
+        size_t target = local->second + (rel.relative_to == 0 ? base : 0);
+        patch(child.code_, rel, target);
+        continue;
+      }
+
+      // A relative_to of zero means the value is absolute. Position
+      // relative relocations always reference an instruction start,
+      // which in a chunk is never at offset zero since the function
+      // header precedes any instruction.
+      size_t relative_to = rel.relative_to == 0 ? 0 : rel.relative_to + base;
+      relocations_.push_back(
+        {rel.offset + base, rel.width, rel.index, relative_to, rel.is_signed});
+    }
+
+    code_.insert(code_.end(), child.code_.begin(), child.code_.end());
+
+    // The labels are still defined globally; call sites and descriptors
+    // in other chunks refer to them.
+    for (const auto& [index, offset] : child.pending_labels_)
+    {
+      define_relocatable(Relocatable(index), offset + base);
+    }
+
+    // Never fuse across chunk boundaries.
+    last_instruction_.reset();
+
+    child.code_.clear();
+    child.relocations_.clear();
+    child.pending_labels_.clear();
+  }
 }
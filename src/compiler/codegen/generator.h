@@ -7,6 +7,7 @@
 
 #include <functional>
 #include <iostream>
+#include <mutex>
 #include <optional>
 #include <vector>
 
@@ -41,6 +42,11 @@ namespace verona::compiler
    * `define_relocatable` is used once the actual value is known. However
    * relocations are not actually resolved until `finish` is called.
    *
+   * Bytecode can also be emitted into child generators, possibly from
+   * several threads, and concatenated into the root with `append`.
+   * Children share the root's relocatable handles (handle creation and
+   * definition are thread-safe), but write to their own buffer; append
+   * shifts their relocations and label definitions to the final offsets.
    */
   class Generator
   {
@@ -50,6 +56,15 @@ namespace verona::compiler
 
     Generator(std::vector<uint8_t>& code) : code_(code) {}
 
+    /**
+     * Create a child generator emitting into its own buffer, to be
+     * concatenated into `parent` with append. Handles are shared with
+     * the parent; the child itself must only be used by one thread.
+     */
+    explicit Generator(Generator& parent)
+    : code_(owned_code_), parent_(&parent)
+    {}
+
     /**
      * Write integer values in little endian format.
      */
@@ -96,9 +111,31 @@ namespace verona::compiler
 
     /**
      * Define a label to the current offset.
+     *
+     * In a child generator the final offset is only known once the
+     * chunk's position is, so the definition is deferred until append.
      */
     void define_label(Label label);
 
+    /**
+     * Concatenate a child generator's bytecode onto this one, shifting
+     * its relocations and deferred label definitions by the chunk's
+     * base offset. Relocations targeting a label defined within the same
+     * chunk are patched on the spot and never reach finish. The child is
+     * left empty.
+     */
+    void append(Generator& child);
+
+    /**
+     * Preallocate the underlying buffer. Used before concatenating child
+     * generators, whose combined size is known, so the buffer is grown
+     * once instead of reallocating per chunk.
+     */
+    void reserve(size_t capacity)
+    {
+      code_.reserve(capacity);
+    }
+
     /**
      * Link the bytecode by resolving all relocations.
      *
@@ -135,11 +172,36 @@ namespace verona::compiler
     void emit_impl(bytecode::OpcodeOperands<Operands...>, Args&&... args)
     {
       size_t opcode_start = current_offset();
-      opcode(Op);
+
+      // Peephole fusion of adjacent instruction pairs. A fused opcode's
+      // operand encoding is the concatenation of its two components', so
+      // the first instruction's bytes stay in place: its opcode byte is
+      // patched to the fused opcode and this instruction's operands are
+      // appended without an opcode byte of their own. Relative offsets
+      // among the appended operands resolve against the fused
+      // instruction's start.
+      std::optional<bytecode::Opcode> fused;
+      if (last_instruction_.has_value())
+        fused = bytecode::fused_opcode(last_instruction_->opcode, Op);
+
+      if (fused.has_value())
+      {
+        opcode_start = last_instruction_->offset;
+        code_.at(opcode_start) = static_cast<uint8_t>(*fused);
+      }
+      else
+      {
+        opcode(Op);
+      }
+
       std::initializer_list<int> x{
         (emit_helper<Operands>::write(
            this, opcode_start, std::forward<Args>(args)),
          0)...};
+
+      // Written last: the operand writes above close the window, and the
+      // instruction only becomes a fusion candidate once it is complete.
+      last_instruction_ = LastInstruction{fused.value_or(Op), opcode_start};
     }
 
     /**
@@ -158,6 +220,12 @@ namespace verona::compiler
     template<typename T>
     std::enable_if_t<std::is_integral_v<T>> write(std::common_type_t<T> value)
     {
+      // Raw data between two instructions makes them non-adjacent, so any
+      // write closes the fusion window. Operand writes also pass through
+      // here; emit_impl re-opens the window once the instruction is
+      // complete.
+      last_instruction_.reset();
+
       size_t offset = code_.size();
       code_.reserve(offset + sizeof(T));
       for (size_t i = 0; i < sizeof(T) * 8; i += 8)
@@ -173,6 +241,17 @@ namespace verona::compiler
       size_t relative_to,
       bool is_signed);
 
+    struct Relocation;
+
+    /**
+     * Write the resolved target of a relocation back into the code,
+     * checking it fits the relocation's width.
+     */
+    static void patch(
+      std::vector<uint8_t>& code,
+      const Relocation& rel,
+      RelocationValue target);
+
     struct Relocation
     {
       size_t offset;
@@ -182,7 +261,30 @@ namespace verona::compiler
       bool is_signed;
     };
 
+    /**
+     * Opcode and offset of the most recently emitted instruction, used to
+     * fuse instruction pairs. The window is closed whenever a label is
+     * defined or raw data is written, so fusion only applies to two truly
+     * adjacent instructions where the second is not a jump target.
+     */
+    struct LastInstruction
+    {
+      bytecode::Opcode opcode;
+      size_t offset;
+    };
+    std::optional<LastInstruction> last_instruction_;
+
+    // A child generator owns its buffer; the root borrows the caller's.
+    std::vector<uint8_t> owned_code_;
     std::vector<uint8_t>& code_;
+    Generator* parent_ = nullptr;
+
+    // (handle index, local offset) of labels defined in a child, shifted
+    // and defined for real when the chunk is appended.
+    std::vector<std::pair<size_t, size_t>> pending_labels_;
+
+    // Guards relocatables_, which children share through the root.
+    std::mutex handles_mutex_;
     std::vector<std::optional<RelocationValue>> relocatables_;
     std::vector<Relocation> relocations_;
   };
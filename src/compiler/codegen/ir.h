@@ -7,7 +7,9 @@
 #include "compiler/visitor.h"
 #include "compiler/zip.h"
 
+#include <algorithm>
 #include <fmt/ostream.h>
+#include <set>
 
 namespace verona::compiler
 {
@@ -42,6 +44,7 @@ namespace verona::compiler
     void generate_body(const FunctionIR& ir)
     {
       setup_parameters(ir);
+      plan_copy_coalescing(ir);
 
       IRTraversal traversal(ir);
       // IRTraversal always returns the entrypoint first,
@@ -49,18 +52,38 @@ namespace verona::compiler
       while (BasicBlock* bb = traversal.next())
       {
         define_label(basic_block_label(bb));
+        emitted_blocks_.insert(bb);
+
+        assignment_ = &typecheck_.types.at(bb);
+        tail_call_ = tail_call_candidate(*bb);
 
         std::vector<Liveness> live_out = liveness_.statements_out(bb);
         for (const auto& [stmt, stmt_live_out] :
              safe_zip(bb->statements, live_out))
         {
+          // The end-scopes trailing a tail call are emitted with it.
+          if (
+            tail_call_ != nullptr &&
+            std::holds_alternative<EndScopeStmt>(stmt) &&
+            std::find(
+              tail_end_scopes_.begin(),
+              tail_end_scopes_.end(),
+              &std::get<EndScopeStmt>(stmt)) != tail_end_scopes_.end())
+            continue;
+
           const auto& stmt_live_out_ = stmt_live_out;
           std::visit(
             [&](const auto& s) { visit_stmt(s, stmt_live_out_); }, stmt);
         }
 
-        const Terminator& term = bb->terminator.value();
-        std::visit([&](const auto& t) { visit_term(t); }, term);
+        // A tail call transfers control itself, so the return terminator
+        // has nothing left to emit.
+        if (tail_call_ == nullptr)
+        {
+          const Terminator& term = bb->terminator.value();
+          std::visit([&](const auto& t) { visit_term(t); }, term);
+        }
+        tail_call_ = nullptr;
       }
     }
 
@@ -79,6 +102,180 @@ namespace verona::compiler
       }
     }
 
+    /**
+     * Coalesce copies with the variable they copy from.
+     *
+     * The builder conservatively emits a CopyStmt whenever a value escapes
+     * its scope, and each one survives as a Copy dispatch plus a later
+     * Clear of the source. Because registers are never reused, a copy's
+     * output can share its input's register when the input is killed later
+     * in the same basic block: every path through the output's uses first
+     * passes the input's kill, so the register holds the value undisturbed
+     * from the input's definition to the output's own kill.
+     *
+     * For such copies nothing is emitted, and the input's Clear is
+     * suppressed: the reference the Copy would have added is instead taken
+     * over from the input, and released by the output's kill as usual.
+     *
+     * The input's kill must not also kill the output (the output's Clear
+     * must come strictly after), and only one copy may take over a given
+     * input. Kills on other paths, which don't go through the copy, are
+     * left alone.
+     */
+    void plan_copy_coalescing(const FunctionIR& ir)
+    {
+      for (const BasicBlock& bb : ir.basic_blocks)
+      {
+        for (size_t i = 0; i < bb.statements.size(); i++)
+        {
+          const CopyStmt* copy = std::get_if<CopyStmt>(&bb.statements[i]);
+          if (copy == nullptr)
+            continue;
+
+          Variable in = copy->input.variable;
+          Variable out = copy->output;
+
+          if (coalesce_sources_.find(in) != coalesce_sources_.end())
+            continue;
+
+          // Find the input's kill further down the block, making sure the
+          // output isn't killed first.
+          const void* kill = nullptr;
+          bool blocked = false;
+          for (size_t j = i + 1;
+               j < bb.statements.size() && kill == nullptr && !blocked;
+               j++)
+          {
+            const Statement& later = bb.statements[j];
+            if (auto end_scope = std::get_if<EndScopeStmt>(&later))
+            {
+              const auto& dead = end_scope->dead_variables;
+              bool kills_out =
+                std::find(dead.begin(), dead.end(), out) != dead.end();
+              bool kills_in =
+                std::find(dead.begin(), dead.end(), in) != dead.end();
+
+              if (kills_out)
+                blocked = true;
+              else if (kills_in)
+                kill = end_scope;
+            }
+            else if (auto overwrite = std::get_if<OverwriteStmt>(&later))
+            {
+              if (overwrite->dead_variable == out)
+                blocked = true;
+              else if (overwrite->dead_variable == in)
+                kill = overwrite;
+            }
+          }
+
+          if (kill == nullptr || blocked)
+            continue;
+
+          coalesced_.insert({out, in});
+          coalesce_sources_.insert(in);
+          suppressed_kills_[kill].push_back(in);
+        }
+      }
+    }
+
+    /**
+     * True when this statement is the last use of `var`: liveness shows
+     * no later use, so its register's reference can be transferred out
+     * with a Move instead of duplicated with a Copy, and the variable's
+     * eventual kill clears an already-empty register. Variables whose
+     * register was taken over by a coalesced copy are excluded, as the
+     * register still carries the copy's value after this use.
+     */
+    bool can_move_from(Variable var, const Liveness& live_out) const
+    {
+      return !live_out.live_variables.contains(var) &&
+        coalesce_sources_.find(var) == coalesce_sources_.end();
+    }
+
+    /**
+     * Return the call statement in tail position of `bb`, if any.
+     *
+     * A call is in tail position when the block's terminator returns its
+     * output and only end-of-scope statements separate the two, so
+     * nothing else runs in this frame after the call. Such a call reuses
+     * the current frame (see Opcode::TailCall), which makes
+     * self-recursive loops run in constant stack space. The trailing
+     * end-scopes, collected in `tail_end_scopes_`, are emitted before
+     * the call instead: they only cover the call's consumed operands,
+     * whose registers have just been moved out of.
+     */
+    const CallStmt* tail_call_candidate(const BasicBlock& bb)
+    {
+      tail_end_scopes_.clear();
+
+      const auto* ret = std::get_if<ReturnTerminator>(&bb.terminator.value());
+      if (ret == nullptr)
+        return nullptr;
+
+      size_t end = bb.statements.size();
+      while (
+        end > 0 && std::holds_alternative<EndScopeStmt>(bb.statements[end - 1]))
+        end--;
+
+      if (end == 0)
+        return nullptr;
+
+      const auto* call = std::get_if<CallStmt>(&bb.statements[end - 1]);
+      if (
+        call == nullptr ||
+        resolve(call->output) != resolve(ret->input.variable))
+        return nullptr;
+
+      for (size_t i = end; i < bb.statements.size(); i++)
+        tail_end_scopes_.push_back(&std::get<EndScopeStmt>(bb.statements[i]));
+
+      return call;
+    }
+
+    /**
+     * Emit the argument transfers into a child frame for a call-like
+     * statement, starting at callee register `first_index`. A variable's
+     * final occurrence is moved rather than copied when this statement is
+     * its last use, saving the incref here and the decref at its kill.
+     */
+    void emit_arguments(
+      const std::vector<Variable>& vars,
+      const FunctionABI& abi,
+      size_t first_index,
+      const Liveness& live_out)
+    {
+      for (size_t i = 0; i < vars.size(); i++)
+      {
+        Register src = variable(vars[i]);
+        CalleeRegister dst =
+          callee_register(abi, truncate<uint8_t>(first_index + i));
+
+        bool repeated_later =
+          std::find(vars.begin() + i + 1, vars.end(), vars[i]) != vars.end();
+
+        if (!repeated_later && can_move_from(vars[i], live_out))
+          emit<Opcode::Move>(dst, src);
+        else
+          emit<Opcode::Copy>(dst, src);
+      }
+    }
+
+    /**
+     * Follow coalesced copies back to the variable whose register they
+     * share.
+     */
+    Variable resolve(Variable var) const
+    {
+      auto it = coalesced_.find(var);
+      while (it != coalesced_.end())
+      {
+        var = it->second;
+        it = coalesced_.find(var);
+      }
+      return var;
+    }
+
     /**
      * Map some list of types to concrete types, using the current method's
      * instantiation.
@@ -132,7 +329,16 @@ namespace verona::compiler
         // that.
         if (var != stmt.output)
         {
-          registers.push_back(variable(var));
+          // Coalesced copies can make two live variables share a
+          // register; only protect it once.
+          Register reg = variable(var);
+          if (
+            std::find_if(registers.begin(), registers.end(), [&](Register r) {
+              return r.value == reg.value;
+            }) == registers.end())
+          {
+            registers.push_back(reg);
+          }
         }
       }
 
@@ -151,26 +357,49 @@ namespace verona::compiler
 
     void visit_stmt(const CallStmt& stmt, const Liveness& live_out)
     {
-      SelectorIdx selector =
-        method_selector(stmt.method, reify(stmt.type_arguments));
+      TypeList type_arguments = reify(stmt.type_arguments);
+      SelectorIdx selector = method_selector(stmt.method, type_arguments);
 
       FunctionABI abi(stmt);
       allocator_.reserve_child_callspace(abi);
 
-      size_t index = 0;
+      std::vector<Variable> vars;
+      vars.reserve(1 + stmt.arguments.size());
+      vars.push_back(stmt.receiver);
+      vars.insert(vars.end(), stmt.arguments.begin(), stmt.arguments.end());
+      emit_arguments(vars, abi, 0, live_out);
 
-      emit<Opcode::Copy>(
-        callee_register(abi, truncate<uint8_t>(index++)),
-        variable(stmt.receiver));
-      for (const auto& var : stmt.arguments)
+      if (&stmt == tail_call_)
       {
-        Register src = variable(var);
-        CalleeRegister dst = callee_register(abi, truncate<uint8_t>(index++));
-        emit<Opcode::Copy>(dst, src);
+        // Clear everything that would otherwise be cleared between the
+        // call and the return: the frame must hold nothing but the
+        // arguments when it is reused. These registers were just moved
+        // out of, so the clears are cheap.
+        for (const EndScopeStmt* end_scope : tail_end_scopes_)
+          visit_stmt(*end_scope, live_out);
+
+        // A tail-recursive loop never takes a branch back-edge, so it
+        // gets its yield point here instead.
+        emit<Opcode::Yield>();
+        emit<Opcode::TailCall>(selector, truncate<uint8_t>(abi.callspace()));
+        return;
       }
 
+      // When reachability proves the call has a single possible target,
+      // skip the vtable walk and jump straight to the method's code.
+      std::optional<Label> direct = find_unique_call_target(
+        context_,
+        reachability_,
+        reify(assignment_->at(stmt.receiver)),
+        stmt.method,
+        type_arguments);
+
       protect_live_registers(stmt, live_out, [&]() {
-        emit<Opcode::Call>(selector, truncate<uint8_t>(abi.callspace()));
+        if (direct)
+          emit<Opcode::CallDirect>(
+            *direct, truncate<uint8_t>(abi.callspace()));
+        else
+          emit<Opcode::Call>(selector, truncate<uint8_t>(abi.callspace()));
       });
 
       emit<Opcode::Move>(variable(stmt.output), callee_register(abi, 0));
@@ -188,19 +417,11 @@ namespace verona::compiler
       // Index is 1, as we don't have a receiver (static method),
       // but currently codegen always assumes a receiver.
       // TODO-Better-Static-codegen
-      size_t index = 1;
-      for (const auto& var : stmt.cowns)
-      {
-        Register src = variable(var);
-        CalleeRegister dst = callee_register(abi, truncate<uint8_t>(index++));
-        emit<Opcode::Copy>(dst, src);
-      }
-      for (const auto& var : stmt.captures)
-      {
-        Register src = variable(var);
-        CalleeRegister dst = callee_register(abi, truncate<uint8_t>(index++));
-        emit<Opcode::Copy>(dst, src);
-      }
+      std::vector<Variable> vars;
+      vars.reserve(stmt.cowns.size() + stmt.captures.size());
+      vars.insert(vars.end(), stmt.cowns.begin(), stmt.cowns.end());
+      vars.insert(vars.end(), stmt.captures.begin(), stmt.captures.end());
+      emit_arguments(vars, abi, 1, live_out);
 
       // Gen when opcode with closure
       emit<Opcode::When>(
@@ -243,7 +464,10 @@ namespace verona::compiler
     {
       Register input = variable(stmt.input);
       Register output = variable(stmt.output);
-      emit<Opcode::Copy>(output, input);
+      if (can_move_from(stmt.input, live_out))
+        emit<Opcode::Move>(output, input);
+      else
+        emit<Opcode::Copy>(output, input);
     }
 
     void visit_stmt(const ReadFieldStmt& stmt, const Liveness& live_out)
@@ -267,9 +491,16 @@ namespace verona::compiler
 
     void visit_stmt(const CopyStmt& stmt, const Liveness& live_out)
     {
+      // A coalesced copy shares its input's register; nothing to emit.
+      if (coalesced_.find(stmt.output) != coalesced_.end())
+        return;
+
       Register input = variable(stmt.input);
       Register output = variable(stmt.output);
-      emit<Opcode::Copy>(output, input);
+      if (can_move_from(stmt.input.variable, live_out))
+        emit<Opcode::Move>(output, input);
+      else
+        emit<Opcode::Copy>(output, input);
     }
 
     void visit_stmt(const IntegerLiteralStmt& stmt, const Liveness& live_out)
@@ -299,10 +530,21 @@ namespace verona::compiler
 
     void visit_stmt(const EndScopeStmt& stmt, const Liveness& live_out)
     {
+      auto suppressed = suppressed_kills_.find(&stmt);
+
       std::vector<Register> regs;
       // TODO: This could be omitted for variables with a non-linear type.
       for (Variable v : stmt.dead_variables)
       {
+        // A coalesced copy took over this variable's reference; its
+        // register is released by the copy's kill instead.
+        if (
+          suppressed != suppressed_kills_.end() &&
+          std::find(
+            suppressed->second.begin(), suppressed->second.end(), v) !=
+            suppressed->second.end())
+          continue;
+
         regs.push_back(variable(v));
       }
 
@@ -314,11 +556,19 @@ namespace verona::compiler
 
     void visit_stmt(const OverwriteStmt& stmt, const Liveness& live_out)
     {
+      if (suppressed_kills_.find(&stmt) != suppressed_kills_.end())
+        return;
+
       emit<Opcode::Clear>(variable(stmt.dead_variable));
     }
 
     void visit_term(const BranchTerminator& term)
     {
+      // A back-edge gets a yield point, emitted before the phi moves so
+      // the Copy/Move and Jump stay adjacent for fusion.
+      if (is_back_edge(term.target))
+        emit<Opcode::Yield>();
+
       const auto& inputs = term.phi_arguments;
       const auto& outputs = term.target->phi_nodes;
       for (auto [in_var, out_var] : safe_zip(inputs, outputs))
@@ -346,6 +596,9 @@ namespace verona::compiler
 
     void visit_term(const IfTerminator& term)
     {
+      if (is_back_edge(term.true_target) || is_back_edge(term.false_target))
+        emit<Opcode::Yield>();
+
       Register input = variable(term.input);
       emit<Opcode::JumpIf>(input, basic_block_label(term.true_target));
       emit<Opcode::Jump>(basic_block_label(term.false_target));
@@ -357,8 +610,9 @@ namespace verona::compiler
 
       if (input.value != 0)
       {
-        emit<Opcode::Copy>(Register(0), input);
-        emit<Opcode::Clear>(input);
+        // The return value's register dies with the frame, so its
+        // reference is transferred rather than copied and cleared.
+        emit<Opcode::Move>(Register(0), input);
       }
 
       emit<Opcode::Return>();
@@ -373,6 +627,8 @@ namespace verona::compiler
      */
     Register variable(Variable var)
     {
+      var = resolve(var);
+
       auto [it, inserted] = variables_.insert({var, Register(0)});
       if (inserted)
       {
@@ -397,6 +653,17 @@ namespace verona::compiler
       return it->second;
     }
 
+    /**
+     * True if jumping to `target` is a loop back-edge, ie. the block's
+     * code was already emitted. Back-edges get a Yield in front of them,
+     * so a behaviour stuck in a long loop periodically offers its cowns
+     * back to the scheduler (see VM::opcode_yield).
+     */
+    bool is_back_edge(const BasicBlock* target) const
+    {
+      return emitted_blocks_.count(target) != 0;
+    }
+
     /**
      * Type visitor used to emit the right bytecode sequence to match a value
      * against a given type.
@@ -535,9 +802,32 @@ namespace verona::compiler
     const LivenessAnalysis& liveness_;
     const std::vector<Label>& closure_labels_;
 
+    /// Type assignment of the basic block being generated, used to get
+    /// receiver types when devirtualizing calls.
+    const TypeAssignment* assignment_ = nullptr;
+
     FunctionABI abi_ = FunctionABI(*method_.definition->signature);
 
     std::map<Variable, Register> variables_;
     std::unordered_map<const BasicBlock*, Label> basic_block_labels_;
+
+    /// Basic blocks whose code has been emitted; a jump to one of these
+    /// is a loop back-edge.
+    std::set<const BasicBlock*> emitted_blocks_;
+
+    /// Copy outputs coalesced with their input (see plan_copy_coalescing).
+    std::map<Variable, Variable> coalesced_;
+    std::set<Variable> coalesce_sources_;
+
+    /// Kill statements whose Clear of the listed variables is taken over
+    /// by a coalesced copy, keyed by the statement's address.
+    std::unordered_map<const void*, std::vector<Variable>> suppressed_kills_;
+
+    /// Call statement in tail position of the block being generated, if
+    /// any; emitted as a TailCall (see tail_call_candidate).
+    const CallStmt* tail_call_ = nullptr;
+    /// End-scope statements between the tail call and the return; their
+    /// clears are emitted before the TailCall instead.
+    std::vector<const EndScopeStmt*> tail_end_scopes_;
   };
 }
@@ -13,6 +13,7 @@
 #include <fmt/ostream.h>
 #include <map>
 #include <queue>
+#include <unordered_map>
 
 namespace verona::compiler
 {
@@ -43,25 +44,38 @@ namespace verona::compiler
 
       while (!queue_.empty())
       {
-        ReachabilityItem item = queue_.front();
+        size_t id = queue_.front();
         queue_.pop();
 
-        auto [_, inserted] = visited_.insert(item);
-        if (inserted)
-        {
-          std::visit([&](const auto& inner) { visit_item(inner); }, item);
-        }
+        // Copy the item out: visiting may push, growing items_.
+        ReachabilityItem item = items_.at(id);
+        std::visit([&](const auto& inner) { visit_item(inner); }, item);
       }
     }
 
     /**
      * Push a new item to be processed for reachability.
+     *
+     * Items are numbered densely the first time they are seen, and the
+     * worklist is deduplicated by id: pushing an item again costs one hash
+     * probe and a bit test, rather than an ordered-set insertion comparing
+     * instantiations element by element.
      */
     void push(ReachabilityItem item)
     {
-      if (visited_.find(item) == visited_.end())
+      auto [it, inserted] =
+        item_ids_.try_emplace(std::move(item), items_.size());
+      if (inserted)
       {
-        queue_.push(item);
+        items_.push_back(it->first);
+        enqueued_.push_back(false);
+      }
+
+      size_t id = it->second;
+      if (!enqueued_[id])
+      {
+        enqueued_[id] = true;
+        queue_.push(id);
       }
     }
 
@@ -276,7 +290,8 @@ namespace verona::compiler
         *item.definition->signature->generics, item.instantiation);
 
       if (item.definition->body)
-        visit_body(analysis_.functions.at(item.definition), item.instantiation);
+        visit_body(
+          analysis_.method_analysis(item.definition), item.instantiation);
 
       // Also add that method for any already known subtype
       for (const auto& subtype : parent_info.subtypes)
@@ -586,14 +601,42 @@ namespace verona::compiler
       return it->second;
     }
 
+    /**
+     * Hash of a work item. Types are interned, so an instantiation is
+     * identified by the addresses of its type arguments.
+     */
+    struct ItemHash
+    {
+      size_t operator()(const ReachabilityItem& item) const
+      {
+        return std::visit(
+          [](const auto& inner) {
+            size_t h = std::hash<const void*>()(inner.definition);
+            for (const TypePtr& ty : inner.instantiation.types())
+            {
+              h ^= std::hash<const void*>()(ty.get()) + 0x9e3779b9 + (h << 6) +
+                (h >> 2);
+            }
+            return h;
+          },
+          item);
+      }
+    };
+
     Context& context_;
     const Program& program_;
     Generator& gen_;
     const AnalysisResults& analysis_;
     Reachability result_;
 
-    std::queue<ReachabilityItem> queue_;
-    std::set<ReachabilityItem> visited_;
+    /// Dense numbering of work items, assigned at first push.
+    std::unordered_map<ReachabilityItem, size_t, ItemHash> item_ids_;
+    /// Id back to item.
+    std::vector<ReachabilityItem> items_;
+    /// Items that have ever been queued, by id. Set once an item is
+    /// queued, so each item is visited at most once.
+    std::vector<bool> enqueued_;
+    std::queue<size_t> queue_;
     std::unique_ptr<std::ostream> solver_out_;
   };
 
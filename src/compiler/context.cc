@@ -7,21 +7,56 @@
 
 namespace verona::compiler
 {
-  Context::Context()
-  : free_variables_(std::make_unique<FreeVariablesVisitor>()),
-    polarizer_(std::make_unique<Polarizer>(*this))
-  {}
+  namespace
+  {
+    /**
+     * Per-thread memoizing mappers.
+     *
+     * The caches inside the Polarizer and FreeVariablesVisitor are not
+     * synchronized, so they cannot be shared between the concurrent
+     * typechecking workers. Instead each thread lazily creates its own
+     * pair the first time it asks a given Context for them. The caches
+     * only ever hold results that any thread could recompute, so the
+     * duplication is purely a memoization trade-off.
+     */
+    struct ThreadMappers
+    {
+      const Context* owner = nullptr;
+      std::unique_ptr<Polarizer> polarizer;
+      std::unique_ptr<FreeVariablesVisitor> free_variables;
+    };
+    thread_local ThreadMappers thread_mappers;
 
-  Context::~Context() {}
+    ThreadMappers& mappers_for(Context& context)
+    {
+      if (thread_mappers.owner != &context)
+      {
+        thread_mappers.owner = &context;
+        thread_mappers.polarizer = std::make_unique<Polarizer>(context);
+        thread_mappers.free_variables =
+          std::make_unique<FreeVariablesVisitor>();
+      }
+      return thread_mappers;
+    }
+  }
+
+  Context::Context() {}
+
+  Context::~Context()
+  {
+    // Don't leave this thread's mappers dangling over a dead Context.
+    if (thread_mappers.owner == this)
+      thread_mappers = ThreadMappers();
+  }
 
   Polarizer& Context::polarizer()
   {
-    return *polarizer_;
+    return *mappers_for(*this).polarizer;
   }
 
   const FreeVariables& Context::free_variables(const TypePtr& type)
   {
-    return free_variables_->free_variables(type);
+    return mappers_for(*this).free_variables->free_variables(type);
   }
 
   bool Context::should_print_name(std::string_view name)
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "compiler/intern.h"
+#include "compiler/profile.h"
 #include "compiler/source_manager.h"
 #include "compiler/type.h"
 
@@ -20,6 +21,11 @@ namespace verona::compiler
     Context();
     ~Context();
 
+    /**
+     * These mappers memoize their results in unsynchronized caches, so
+     * each thread (in particular each concurrent typechecking worker)
+     * gets its own lazily-created instance.
+     */
     Polarizer& polarizer();
 
     const FreeVariables& free_variables(const TypePtr& type);
@@ -45,6 +51,23 @@ namespace verona::compiler
       print_patterns_.push_back(pattern);
     }
 
+    CompilationProfiler& profiler()
+    {
+      return profiler_;
+    }
+
+    /**
+     * Arena backing the AST (see ArenaAllocated in pegmatite-extra.h).
+     *
+     * Parse trees are kept for the entire compilation, so their storage is
+     * released wholesale with the context rather than one node at a time.
+     * Files are parsed sequentially on a single thread, hence no lock.
+     */
+    Arena& ast_arena()
+    {
+      return ast_arena_;
+    }
+
     void exit(int error_code)
     {
       std::exit(error_code);
@@ -64,11 +87,10 @@ namespace verona::compiler
 
     bool should_print_name(std::string_view name);
 
-    std::unique_ptr<Polarizer> polarizer_;
-    std::unique_ptr<FreeVariablesVisitor> free_variables_;
-
     std::optional<std::string> dump_path_;
     std::vector<std::string> print_patterns_;
+    CompilationProfiler profiler_;
+    Arena ast_arena_;
   };
 
   /**
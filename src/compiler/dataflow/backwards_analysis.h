@@ -2,7 +2,11 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
-#include "compiler/dataflow/work_set.h"
+#include "compiler/ir/ir.h"
+
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 /**
  * This file implements a generic framework for backwards dataflow analysis.
@@ -73,18 +77,80 @@ namespace verona::compiler
   private:
     void process(const FunctionIR& ir)
     {
+      position_.clear();
+      next_position_ = 0;
+      number_blocks(ir);
+
       for (const BasicBlock* bb : ir.exits)
       {
-        work_set_.insert(bb);
+        work_set_.insert({position_of(bb), bb});
       }
 
       while (!work_set_.empty())
       {
-        const BasicBlock* bb = work_set_.remove();
+        const BasicBlock* bb = work_set_.begin()->second;
+        work_set_.erase(work_set_.begin());
         visit_basic_block(bb);
       }
     }
 
+    /**
+     * Number the basic blocks in postorder of a depth-first traversal from
+     * the entry.
+     *
+     * A backwards analysis converges fastest when a block is visited after
+     * its (non back-edge) successors, which is exactly postorder. The
+     * work-list always pops the pending block with the smallest postorder
+     * position, so most blocks only need to be recomputed when a loop's
+     * back-edge actually changes their state.
+     */
+    void number_blocks(const FunctionIR& ir)
+    {
+      auto successors = [](const BasicBlock* bb) {
+        std::vector<const BasicBlock*> result;
+        bb->visit_successors(
+          [&](const BasicBlock* successor) { result.push_back(successor); });
+        return result;
+      };
+
+      std::unordered_set<const BasicBlock*> visited;
+      std::vector<std::pair<const BasicBlock*, std::vector<const BasicBlock*>>>
+        stack;
+
+      visited.insert(ir.entry);
+      stack.push_back({ir.entry, successors(ir.entry)});
+      while (!stack.empty())
+      {
+        auto& [bb, pending] = stack.back();
+        if (pending.empty())
+        {
+          position_.insert({bb, next_position_++});
+          stack.pop_back();
+          continue;
+        }
+
+        const BasicBlock* next = pending.back();
+        pending.pop_back();
+        if (visited.insert(next).second)
+        {
+          stack.push_back({next, successors(next)});
+        }
+      }
+    }
+
+    /**
+     * Position of a block in the postorder numbering. Blocks that aren't
+     * reachable from the entry are given positions past the end of the
+     * numbering, in discovery order.
+     */
+    size_t position_of(const BasicBlock* bb)
+    {
+      auto [it, inserted] = position_.insert({bb, next_position_});
+      if (inserted)
+        next_position_++;
+      return it->second;
+    }
+
     State out_state(const BasicBlock* bb)
     {
       State state;
@@ -119,7 +185,7 @@ namespace verona::compiler
       {
         for (const BasicBlock* predecessor : bb->predecessors)
         {
-          work_set_.insert(predecessor);
+          work_set_.insert({position_of(predecessor), predecessor});
         }
       }
     }
@@ -136,7 +202,12 @@ namespace verona::compiler
     }
 
   private:
-    WorkSet<const BasicBlock*> work_set_;
+    /// Pending blocks, keyed by postorder position so the earliest pending
+    /// block is popped first. Inserting a block already pending is a no-op.
+    std::set<std::pair<size_t, const BasicBlock*>> work_set_;
+    std::unordered_map<const BasicBlock*, size_t> position_;
+    size_t next_position_ = 0;
+
     std::unique_ptr<Result> result_;
   };
 };
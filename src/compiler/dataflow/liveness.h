@@ -66,6 +66,18 @@ namespace verona::compiler
     {
       auto renaming = VariableRenaming::backwards(current, successor);
 
+      if (renaming.is_identity())
+      {
+        // On edges without phi nodes the sets can be merged a word at a
+        // time. Removing the combined live set from the zombies afterwards
+        // implements the same live-over-zombie preference as the general
+        // path below.
+        state_out.zombie_variables.insert_all(state_in.zombie_variables);
+        state_out.live_variables.insert_all(state_in.live_variables);
+        state_out.zombie_variables.remove_all(state_out.live_variables);
+        return;
+      }
+
       for (Variable variable : state_in.zombie_variables)
       {
         Variable renamed = renaming.apply(variable);
@@ -4,19 +4,44 @@
 
 #include "compiler/ir/variable.h"
 
-#include <unordered_set>
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+#include <vector>
 
 namespace verona::compiler
 {
   /**
    * Set of SSA Variables.
+   *
+   * The set is backed by a dense bitset indexed by the variables' SSA
+   * indices, which the IR builder allocates contiguously from zero. Bulk
+   * operations between two VariableSets work a word at a time.
+   *
+   * Iterating the set yields Variables rebuilt from their index alone; the
+   * optional LocalID carried by parameters is not retained. Variable
+   * equality and hashing only consider the index, so this is invisible to
+   * everything but pretty-printing.
    */
   class VariableSet
   {
   public:
     void insert(Variable variable)
     {
-      variables_.insert(variable);
+      size_t word = word_index(variable.index);
+      if (word >= words_.size())
+        words_.resize(word + 1, 0);
+      words_[word] |= bit(variable.index);
+    }
+
+    void insert_all(const VariableSet& others)
+    {
+      if (others.words_.size() > words_.size())
+        words_.resize(others.words_.size(), 0);
+      for (size_t i = 0; i < others.words_.size(); i++)
+      {
+        words_[i] |= others.words_[i];
+      }
     }
 
     template<typename T>
@@ -25,12 +50,26 @@ namespace verona::compiler
       static_assert(
         std::is_same_v<typename T::value_type, Variable>,
         "Argument should be a collection of Variables");
-      variables_.insert(others.begin(), others.end());
+      for (Variable v : others)
+      {
+        insert(v);
+      }
     }
 
     void remove(Variable variable)
     {
-      variables_.erase(variable);
+      size_t word = word_index(variable.index);
+      if (word < words_.size())
+        words_[word] &= ~bit(variable.index);
+    }
+
+    void remove_all(const VariableSet& others)
+    {
+      size_t common = std::min(words_.size(), others.words_.size());
+      for (size_t i = 0; i < common; i++)
+      {
+        words_[i] &= ~others.words_[i];
+      }
     }
 
     template<typename T>
@@ -41,41 +80,129 @@ namespace verona::compiler
         "Argument should be a collection of Variables");
       for (Variable v : others)
       {
-        variables_.erase(v);
+        remove(v);
       }
     }
 
     bool contains(Variable element) const
     {
-      return variables_.find(element) != variables_.end();
+      size_t word = word_index(element.index);
+      return word < words_.size() && (words_[word] & bit(element.index)) != 0;
     }
 
     size_t size() const
     {
-      return variables_.size();
+      size_t count = 0;
+      for (uint64_t word : words_)
+      {
+        count += std::bitset<BITS>(word).count();
+      }
+      return count;
     }
 
     bool empty() const
     {
-      return variables_.empty();
+      for (uint64_t word : words_)
+      {
+        if (word != 0)
+          return false;
+      }
+      return true;
     }
 
-    // VariableSet is iterable, piggybacking on the unordered_set's iterator
-    // implementation.
+    // VariableSet is iterable, by scanning the bitset for set bits.
     using value_type = Variable;
-    using const_iterator = std::unordered_set<Variable>::const_iterator;
+
+    class const_iterator
+    {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = Variable;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const Variable*;
+      using reference = Variable;
+
+      Variable operator*() const
+      {
+        return Variable{index_};
+      }
+
+      const_iterator& operator++()
+      {
+        index_++;
+        advance();
+        return *this;
+      }
+
+      const_iterator operator++(int)
+      {
+        const_iterator old = *this;
+        ++(*this);
+        return old;
+      }
+
+      bool operator==(const const_iterator& other) const
+      {
+        return index_ == other.index_;
+      }
+      bool operator!=(const const_iterator& other) const
+      {
+        return !(*this == other);
+      }
+
+    private:
+      friend class VariableSet;
+
+      const_iterator(const std::vector<uint64_t>* words, uint64_t index)
+      : words_(words), index_(index)
+      {
+        advance();
+      }
+
+      /**
+       * Move forwards to the next set bit at or after the current position,
+       * skipping whole words once they hold no further bits.
+       */
+      void advance()
+      {
+        uint64_t total = words_->size() * BITS;
+        while (index_ < total)
+        {
+          uint64_t remaining = (*words_)[index_ / BITS] >> (index_ % BITS);
+          if (remaining & 1)
+            return;
+          if (remaining == 0)
+            index_ = ((index_ / BITS) + 1) * BITS;
+          else
+            index_++;
+        }
+      }
+
+      const std::vector<uint64_t>* words_;
+      uint64_t index_;
+    };
 
     const_iterator begin() const
     {
-      return variables_.begin();
+      return const_iterator(&words_, 0);
     }
     const_iterator end() const
     {
-      return variables_.end();
+      return const_iterator(&words_, words_.size() * BITS);
     }
 
   private:
-    // TODO: This should be replaced by a bitset, using the variable indices.
-    std::unordered_set<Variable> variables_;
+    static constexpr size_t BITS = 64;
+
+    static size_t word_index(uint64_t index)
+    {
+      return index / BITS;
+    }
+    static uint64_t bit(uint64_t index)
+    {
+      return uint64_t(1) << (index % BITS);
+    }
+
+    std::vector<uint64_t> words_;
   };
 }
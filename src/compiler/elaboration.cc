@@ -5,6 +5,8 @@
 #include "compiler/visitor.h"
 #include "compiler/zip.h"
 
+#include <map>
+
 namespace verona::compiler
 {
   class ElaborationVisitor : public MemberVisitor<>
@@ -223,6 +225,24 @@ namespace verona::compiler
 
     void visit_signature(FnSignature* signature)
     {
+      // Without where clauses, elaboration depends only on the signature's
+      // types: fresh external regions are numbered positionally. Generated
+      // accessors repeat the same signature across many entities, so the
+      // result is memoized. Clause-bearing signatures take the full path -
+      // clauses name method-specific locals and can raise diagnostics.
+      bool memoizable = signature->where_clauses.empty();
+
+      if (memoizable)
+      {
+        auto it = memo_.find(signature->types);
+        if (it != memo_.end())
+        {
+          signature->types = it->second;
+          return;
+        }
+      }
+
+      TypeSignature original = signature->types;
       ClauseMap clauses = build_clause_map(signature->where_clauses);
       RegionMap regions = build_region_map(signature);
 
@@ -247,6 +267,9 @@ namespace verona::compiler
 
       apply_return(
         &signature->types.return_type, clauses, regions, next_fresh_external);
+
+      if (memoizable)
+        memo_.insert({original, signature->types});
     }
 
     void visit_method(Method* method) final
@@ -258,6 +281,10 @@ namespace verona::compiler
 
   private:
     Context& context_;
+
+    /// Elaborated types for clause-free signatures, keyed on the types
+    /// before elaboration.
+    std::map<TypeSignature, TypeSignature> memo_;
   };
 
   bool elaborate(Context& context, Program* program)
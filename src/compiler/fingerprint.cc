@@ -0,0 +1,146 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include "compiler/fingerprint.h"
+
+#include "compiler/printing.h"
+#include "compiler/visitor.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+
+namespace verona::compiler
+{
+  namespace
+  {
+    // The file starts with this line, doubling as a format version; bump
+    // it whenever the printed AST or the bytecode format changes shape.
+    constexpr std::string_view MAGIC = "# verona fingerprints v1";
+
+    uint64_t fnv1a(const std::string& data)
+    {
+      uint64_t hash = 0xcbf29ce484222325;
+      for (char c : data)
+      {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3;
+      }
+      return hash;
+    }
+
+    template<typename Ast>
+    uint64_t fingerprint(const Ast& ast)
+    {
+      std::stringstream buffer;
+      buffer << ast;
+      return fnv1a(buffer.str());
+    }
+
+    class FingerprintVisitor : private MemberVisitor<>
+    {
+    public:
+      ProgramFingerprints fingerprints;
+
+      void visit_program(Program* program)
+      {
+        for (const auto& file : program->files)
+        {
+          for (const auto& entity : file->entities)
+          {
+            // The entity's own entry covers structure the member entries
+            // don't key on, such as its kind and generic bounds.
+            std::stringstream name;
+            name << entity->name;
+            fingerprints.insert({name.str(), fingerprint(*entity)});
+
+            visit_members(entity->members);
+          }
+          for (const auto& assertion : file->assertions)
+          {
+            std::string key =
+              "static-assertion-" + std::to_string(fingerprints.size());
+            fingerprints.insert({key, fingerprint(*assertion)});
+          }
+        }
+      }
+
+    private:
+      void visit_method(Method* method) final
+      {
+        fingerprints.insert({method->path(), fingerprint(*method)});
+      }
+
+      void visit_field(Field* fld) final
+      {
+        fingerprints.insert({fld->path(), fingerprint(*fld)});
+      }
+    };
+  }
+
+  ProgramFingerprints fingerprint_program(Program* program)
+  {
+    FingerprintVisitor visitor;
+    visitor.visit_program(program);
+    return std::move(visitor.fingerprints);
+  }
+
+  size_t count_changed(
+    const ProgramFingerprints& previous, const ProgramFingerprints& current)
+  {
+    size_t changed = 0;
+    for (const auto& [path, value] : current)
+    {
+      auto it = previous.find(path);
+      if (it == previous.end() || it->second != value)
+        changed++;
+    }
+    for (const auto& [path, value] : previous)
+    {
+      if (current.find(path) == current.end())
+        changed++;
+    }
+    return changed;
+  }
+
+  std::optional<ProgramFingerprints> load_fingerprints(const std::string& path)
+  {
+    std::ifstream input(path);
+    if (!input.is_open())
+      return std::nullopt;
+
+    std::string header;
+    if (!std::getline(input, header) || header != MAGIC)
+      return std::nullopt;
+
+    ProgramFingerprints fingerprints;
+    std::string line;
+    while (std::getline(input, line))
+    {
+      std::istringstream fields(line);
+      uint64_t value;
+      std::string key;
+      if (!(fields >> std::hex >> value >> key))
+        return std::nullopt;
+      fingerprints.insert({key, value});
+    }
+    return fingerprints;
+  }
+
+  void
+  save_fingerprints(const std::string& path, const ProgramFingerprints& fps)
+  {
+    std::ofstream output(path);
+    if (!output.is_open())
+    {
+      std::cerr << "Cannot open fingerprint file " << path << std::endl;
+      return;
+    }
+
+    output << MAGIC << "\n";
+    for (const auto& [key, value] : fps)
+    {
+      output << std::hex << value << " " << key << "\n";
+    }
+  }
+}
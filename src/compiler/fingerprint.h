@@ -0,0 +1,47 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "compiler/ast.h"
+
+#include <map>
+#include <optional>
+#include <string>
+
+/**
+ * Per-definition fingerprints of an elaborated program.
+ *
+ * Each entity, field and method gets a 64-bit hash of its printed AST,
+ * keyed by its path. The printed form is insensitive to whitespace and
+ * comments, so touching a file without changing any definition leaves
+ * its fingerprints unchanged.
+ *
+ * The fingerprints persist across compiler invocations (see
+ * load_fingerprints / save_fingerprints) and let the driver detect
+ * which definitions changed since the last build. When nothing changed
+ * at all, the previous output can be reused wholesale.
+ */
+namespace verona::compiler
+{
+  using ProgramFingerprints = std::map<std::string, uint64_t>;
+
+  ProgramFingerprints fingerprint_program(Program* program);
+
+  /**
+   * Number of definitions whose fingerprint differs between the two
+   * maps, counting additions and removals as changes.
+   */
+  size_t
+  count_changed(const ProgramFingerprints& previous,
+                const ProgramFingerprints& current);
+
+  /**
+   * Load fingerprints written by a previous invocation. Returns nullopt
+   * if the file is missing or was written in an unknown format.
+   */
+  std::optional<ProgramFingerprints>
+  load_fingerprints(const std::string& path);
+
+  void
+  save_fingerprints(const std::string& path, const ProgramFingerprints& fps);
+}
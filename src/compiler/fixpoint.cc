@@ -101,7 +101,15 @@ namespace verona::compiler
 
   TypePtr unfold_fixpoint(Context& context, const FixpointTypePtr& fixpoint)
   {
-    return OpenFixpoint(context, fixpoint).apply(fixpoint->inner);
+    // Deep constraint chains unfold the same recursive type over and
+    // over. The expansion depends only on the (interned) fixpoint, so it
+    // is shared through the interner.
+    if (TypePtr cached = context.lookup_unfolding(fixpoint))
+      return cached;
+
+    TypePtr result = OpenFixpoint(context, fixpoint).apply(fixpoint->inner);
+    context.remember_unfolding(fixpoint, result);
+    return result;
   }
 
   TypePtr close_fixpoint(
@@ -4,6 +4,7 @@
 #include "instantiation.h"
 
 #include "compiler/ast.h"
+#include "compiler/context.h"
 
 namespace verona::compiler
 {
@@ -12,4 +13,14 @@ namespace verona::compiler
   {
     return instance_.types_.at(ty->definition->index);
   }
+
+  TypePtr Instantiation::Applier::apply_one(const TypePtr& type)
+  {
+    if (TypePtr cached = context().lookup_instantiation(instance_.types_, type))
+      return cached;
+
+    TypePtr result = RecursiveTypeMapper::apply_one(type);
+    context().remember_instantiation(instance_.types_, type, result);
+    return result;
+  }
 }
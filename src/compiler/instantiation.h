@@ -70,6 +70,15 @@ namespace verona::compiler
 
       TypePtr visit_type_parameter(const TypeParameterPtr& ty) final;
 
+    protected:
+      /**
+       * Applying the same instantiation to the same type always produces
+       * the same result, so every node is memoized in the interner,
+       * keyed on the type arguments. This shares work across all uses of
+       * a specialization, not just within one apply call.
+       */
+      TypePtr apply_one(const TypePtr& type) final;
+
     private:
       const Instantiation& instance_;
     };
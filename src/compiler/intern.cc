@@ -1027,8 +1027,10 @@ namespace verona::compiler
     if (!ty)
       return false;
 
-    auto it = types_.find(ty);
-    return it != types_.end() && *it == ty;
+    Shard& shard = shard_for(typeid(*ty));
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto it = shard.types.find(ty);
+    return it != shard.types.end() && *it == ty;
   }
 
   bool TypeInterner::is_interned(const TypeList& tys)
@@ -1054,28 +1056,58 @@ namespace verona::compiler
   template<typename T>
   std::shared_ptr<const T> TypeInterner::intern(T value)
   {
-    // We split the lookup and insert steps, avoiding the allocation of the
-    // shared_ptr if the lookup succeeds. To avoid searching the map twice,
-    // we use lower_bound to perform the lookup, giving us a hint on where
-    // to insert even if the lookup fails.
-    // <Some rant about how unergonomic C++ containers are>
-
-    // After lower_bound, one of these must hold:
-    // - `it` is `types_.end()`
-    // - `*it` is strictly greater than `value`
-    // - `*it` is equal to `value`
-    // In the first two cases, value is not in the map, so we insert it.
-    auto it = types_.lower_bound(value);
-    if (it == types_.end() || LessTypes()(value, *it))
+    // Hot types get re-interned constantly during constraint solving;
+    // the calling thread's cache of recent results answers those hits
+    // without taking any lock.
+    ThreadCache& cache = thread_cache_;
+    if (cache.owner == this)
     {
-      it = types_.emplace_hint(it, std::make_shared<T>(value));
+      auto hit = cache.types.find(value);
+      if (hit != cache.types.end())
+        return std::static_pointer_cast<const T>(*hit);
     }
+    else
+    {
+      cache.owner = this;
+      cache.types.clear();
+    }
+
+    TypePtr result;
+    {
+      // We split the lookup and insert steps, avoiding the allocation of
+      // the shared_ptr if the lookup succeeds. To avoid searching the map
+      // twice, we use lower_bound to perform the lookup, giving us a hint
+      // on where to insert even if the lookup fails.
+      // <Some rant about how unergonomic C++ containers are>
+
+      // After lower_bound, one of these must hold:
+      // - `it` is `shard.types.end()`
+      // - `*it` is strictly greater than `value`
+      // - `*it` is equal to `value`
+      // In the first two cases, value is not in the map, so we insert it.
+      Shard& shard = shard_for(typeid(T));
+      std::lock_guard<std::mutex> guard(shard.mutex);
+      auto it = shard.types.lower_bound(value);
+      if (it == shard.types.end() || LessTypes()(value, *it))
+      {
+        // allocate_shared co-locates the type and its control block in
+        // one allocation from the shard's arena.
+        it = shard.types.emplace_hint(
+          it, std::allocate_shared<T>(ArenaAllocator<T>(&shard.arena), value));
+      }
+
+      assert(!LessTypes()(*it, value) && !LessTypes()(value, *it));
 
-    assert(!LessTypes()(*it, value) && !LessTypes()(value, *it));
+      result = *it;
+    }
+
+    if (cache.types.size() >= ThreadCache::LIMIT)
+      cache.types.clear();
+    cache.types.insert(result);
 
-    // At this point, `*it` is equal to `value`, making the cast to a
+    // At this point, `result` is equal to `value`, making the cast to a
     // shared_ptr<T> safe.
-    return std::static_pointer_cast<const T>(*it);
+    return std::static_pointer_cast<const T>(result);
   }
 
   /**
@@ -1158,4 +1190,53 @@ namespace verona::compiler
   {
     return (*this)(left, *right);
   }
+
+  TypePtr TypeInterner::lookup_instantiation(
+    const TypeList& arguments, const TypePtr& type)
+  {
+    std::lock_guard<std::mutex> guard(instantiations_mutex_);
+    auto group = instantiations_.find(arguments);
+    if (group == instantiations_.end())
+      return nullptr;
+
+    auto it = group->second.find(type.get());
+    if (it == group->second.end())
+      return nullptr;
+
+    return it->second;
+  }
+
+  void TypeInterner::remember_instantiation(
+    const TypeList& arguments, const TypePtr& type, const TypePtr& result)
+  {
+    std::lock_guard<std::mutex> guard(instantiations_mutex_);
+    instantiations_[arguments].insert({type.get(), result});
+  }
+
+  TypePtr TypeInterner::lookup_unfolding(const FixpointTypePtr& fixpoint)
+  {
+    std::lock_guard<std::mutex> guard(unfoldings_mutex_);
+    auto it = unfoldings_.find(fixpoint.get());
+    if (it == unfoldings_.end())
+      return nullptr;
+
+    return it->second;
+  }
+
+  void TypeInterner::remember_unfolding(
+    const FixpointTypePtr& fixpoint, const TypePtr& result)
+  {
+    std::lock_guard<std::mutex> guard(unfoldings_mutex_);
+    unfoldings_.insert({fixpoint.get(), result});
+  }
+
+  thread_local TypeInterner::ThreadCache TypeInterner::thread_cache_;
+
+  TypeInterner::~TypeInterner()
+  {
+    // Don't leave this thread's cache pointing at a dead interner; the
+    // worker threads' caches die with the threads themselves.
+    if (thread_cache_.owner == this)
+      thread_cache_ = ThreadCache();
+  }
 }
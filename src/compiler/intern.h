@@ -2,11 +2,17 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include "compiler/arena.h"
 #include "compiler/type.h"
 
 #include <algorithm>
+#include <array>
+#include <map>
+#include <mutex>
 #include <optional>
 #include <set>
+#include <typeinfo>
+#include <unordered_map>
 
 /**
  * Type interner.
@@ -37,6 +43,7 @@ namespace verona::compiler
   {
   public:
     TypeInterner() {}
+    ~TypeInterner();
 
     EntityTypePtr mk_entity_type(const Entity* definition, TypeList arguments);
     StaticTypePtr mk_static_type(const Entity* definition, TypeList arguments);
@@ -105,6 +112,37 @@ namespace verona::compiler
 
     TypePtr mk_not_child_of(Region region);
 
+    /**
+     * Memoization of Instantiation::apply (see instantiation.h).
+     *
+     * Programs instantiate the same generics with the same type arguments
+     * over and over, rebuilding identical trees each time. Keying the
+     * result on the argument list and the input type computes each
+     * distinct specialization once per compilation. Interned pointers are
+     * stable for the lifetime of the interner, so cached results never
+     * dangle.
+     *
+     * lookup_instantiation returns nullptr if the result isn't known yet.
+     */
+    TypePtr
+    lookup_instantiation(const TypeList& arguments, const TypePtr& type);
+    void remember_instantiation(
+      const TypeList& arguments, const TypePtr& type, const TypePtr& result);
+
+    /**
+     * Memoization of unfold_fixpoint (see fixpoint.h).
+     *
+     * Unfolding depends only on the interned fixpoint itself, and the
+     * solver unfolds the same recursive type every time a constraint
+     * chain crosses it, so each fixpoint is expanded at most once per
+     * compilation.
+     *
+     * lookup_unfolding returns nullptr if the result isn't known yet.
+     */
+    TypePtr lookup_unfolding(const FixpointTypePtr& fixpoint);
+    void
+    remember_unfolding(const FixpointTypePtr& fixpoint, const TypePtr& result);
+
     // It's important that we only have one interner, but C++ makes it easy
     // to accidentally make copies. Protect against that.
     TypeInterner(const TypeInterner&) = delete;
@@ -165,6 +203,71 @@ namespace verona::compiler
     TypePtr unfold_compression(
       PathCompressionMap compression, Variable dead_variable, TypePtr type);
 
-    std::set<TypePtr, LessTypes> types_;
+    /**
+     * Typechecking solves methods on concurrent worker threads, all of
+     * which intern types through this object. The interning set is
+     * sharded so the workers rarely contend: each Type subclass maps to
+     * a shard by the hash of its typeid, and each shard has its own
+     * lock. Interned pointers are stable for the lifetime of the
+     * interner, which lets a thread-local cache of recent results
+     * answer repeated interning of hot types without taking any lock
+     * at all, while pointer-identity semantics come from the shards.
+     *
+     * The ordered, heterogeneous-lookup sets cannot be made lock-free,
+     * but the critical section is a single lookup-or-insert; the mk_*
+     * normalization logic works on values and needs no protection.
+     */
+    static constexpr size_t SHARD_COUNT = 16;
+
+    struct Shard
+    {
+      std::mutex mutex;
+
+      /**
+       * Interned types live for the rest of the compilation, so both
+       * the Type objects (see intern()) and the set nodes that index
+       * them come from a bump arena, released wholesale with the
+       * interner instead of one free at a time.
+       */
+      Arena arena;
+      std::set<TypePtr, LessTypes, ArenaAllocator<TypePtr>> types{
+        ArenaAllocator<TypePtr>(&arena)};
+    };
+
+    Shard& shard_for(const std::type_info& info)
+    {
+      return shards_[info.hash_code() % SHARD_COUNT];
+    }
+
+    /**
+     * Per-thread cache of recently interned types. Entries are always
+     * pointers owned by the shards, so a hit returns exactly what the
+     * shard lookup would. The cache is reset when the thread switches
+     * to a different interner, and emptied when it grows past LIMIT.
+     */
+    struct ThreadCache
+    {
+      static constexpr size_t LIMIT = 4096;
+
+      const TypeInterner* owner = nullptr;
+      std::set<TypePtr, LessTypes> types;
+    };
+
+    static thread_local ThreadCache thread_cache_;
+
+    std::array<Shard, SHARD_COUNT> shards_;
+
+    /**
+     * Memoized instantiation results, grouped by the instantiation's type
+     * arguments so each argument list is only stored once. Guarded by its
+     * own lock since typechecking workers instantiate concurrently.
+     */
+    std::mutex instantiations_mutex_;
+    std::map<TypeList, std::unordered_map<const Type*, TypePtr>>
+      instantiations_;
+
+    /// Memoized fixpoint unfoldings, keyed on the interned fixpoint.
+    std::mutex unfoldings_mutex_;
+    std::unordered_map<const Type*, TypePtr> unfoldings_;
   };
 }
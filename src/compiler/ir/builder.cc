@@ -1104,6 +1104,10 @@ namespace verona::compiler
       params.push_back(param->local);
     }
     builder.build(receiver, std::move(params), &*body.expression);
+
+    mir->variable_count = builder.next_variable_;
+    mir->type_arguments_count = builder.next_type_arguments_;
+
     return std::move(mir);
   }
 }
@@ -0,0 +1,178 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include "compiler/ir/hoisting.h"
+
+#include "compiler/ir/dominance.h"
+
+#include <algorithm>
+#include <optional>
+#include <unordered_set>
+
+namespace verona::compiler
+{
+  namespace
+  {
+    /**
+     * Whether this statement is invariant register setup: no operands, no
+     * side effects, and a result that only depends on the program text.
+     * Strings are excluded as their materialization allocates.
+     */
+    bool is_invariant_setup(const Statement& stmt)
+    {
+      return std::holds_alternative<StaticTypeStmt>(stmt) ||
+        std::holds_alternative<IntegerLiteralStmt>(stmt);
+    }
+
+    /**
+     * Collect every block that is part of a natural loop.
+     *
+     * An edge to a block that dominates its source is a back edge; the
+     * loop's body is everything that reaches the edge's source without
+     * going through the header.
+     */
+    std::unordered_set<const BasicBlock*> find_loop_blocks(FunctionIR& ir)
+    {
+      std::unordered_set<const BasicBlock*> in_loop;
+
+      for (BasicBlock& bb : ir.basic_blocks)
+      {
+        bb.visit_successors([&](BasicBlock* header) {
+          if (!dominates(header, &bb))
+            return;
+
+          std::unordered_set<const BasicBlock*> body = {header, &bb};
+          std::vector<BasicBlock*> worklist = {&bb};
+          while (!worklist.empty())
+          {
+            BasicBlock* current = worklist.back();
+            worklist.pop_back();
+            for (BasicBlock* pred : current->predecessors)
+            {
+              if (body.insert(pred).second)
+                worklist.push_back(pred);
+            }
+          }
+
+          in_loop.insert(body.begin(), body.end());
+        });
+      }
+
+      return in_loop;
+    }
+
+    void hoist_loop_invariants(FunctionIR& ir)
+    {
+      // An entry block with predecessors would itself be part of a loop,
+      // leaving no block that executes once per call to hoist into. The
+      // builder never produces this shape.
+      if (!ir.entry->predecessors.empty())
+        return;
+
+      std::unordered_set<const BasicBlock*> in_loop = find_loop_blocks(ir);
+
+      // A variable an in-loop OverwriteStmt kills must stay put: hoisting
+      // its definition past the kill would leave it live and zombie at
+      // once, which liveness forbids.
+      std::unordered_set<Variable> overwritten;
+      for (BasicBlock& bb : ir.basic_blocks)
+      {
+        if (in_loop.count(&bb) == 0)
+          continue;
+
+        for (const Statement& stmt : bb.statements)
+        {
+          if (const auto* overwrite = std::get_if<OverwriteStmt>(&stmt))
+            overwritten.insert(overwrite->dead_variable);
+        }
+      }
+
+      // Move invariant setup out of the loop blocks. Blocks are visited
+      // in creation order so the output is deterministic.
+      std::vector<BasicBlock*> modified;
+      std::vector<Statement> hoisted;
+      for (BasicBlock& bb : ir.basic_blocks)
+      {
+        if (&bb == ir.entry || in_loop.count(&bb) == 0)
+          continue;
+
+        auto split = std::stable_partition(
+          bb.statements.begin(),
+          bb.statements.end(),
+          [&](const Statement& s) {
+            if (!is_invariant_setup(s))
+              return true;
+            auto output = statement_output(s);
+            return output.has_value() && overwritten.count(*output) > 0;
+          });
+        if (split == bb.statements.end())
+          continue;
+
+        std::move(split, bb.statements.end(), std::back_inserter(hoisted));
+        bb.statements.erase(split, bb.statements.end());
+        modified.push_back(&bb);
+      }
+
+      if (hoisted.empty())
+        return;
+
+      // The scope exits inside the loop still list the hoisted variables
+      // as dead; left alone, codegen would clear their registers on every
+      // iteration and the next use would read UNINIT. Drop them from the
+      // in-loop kills: the variables now die when the frame does.
+      std::unordered_set<Variable> hoisted_outputs;
+      for (const Statement& stmt : hoisted)
+      {
+        if (auto output = statement_output(stmt))
+          hoisted_outputs.insert(*output);
+      }
+
+      for (BasicBlock& bb : ir.basic_blocks)
+      {
+        if (in_loop.count(&bb) == 0)
+          continue;
+
+        for (Statement& stmt : bb.statements)
+        {
+          if (auto* end_scope = std::get_if<EndScopeStmt>(&stmt))
+          {
+            auto& dead = end_scope->dead_variables;
+            dead.erase(
+              std::remove_if(
+                dead.begin(),
+                dead.end(),
+                [&](Variable v) { return hoisted_outputs.count(v) > 0; }),
+              dead.end());
+          }
+        }
+      }
+
+      // Definitions in the entry block dominate every use, so the hoisted
+      // statements can go at its end, after the existing setup.
+      std::move(
+        hoisted.begin(),
+        hoisted.end(),
+        std::back_inserter(ir.entry->statements));
+      modified.push_back(ir.entry);
+
+      // Re-index the definition points of the statements in the blocks we
+      // touched.
+      for (BasicBlock* bb : modified)
+      {
+        for (size_t i = 0; i < bb->statements.size(); i++)
+        {
+          if (auto output = statement_output(bb->statements[i]))
+          {
+            ir.variable_definitions.insert_or_assign(
+              *output, IRPoint::statement(bb, i));
+          }
+        }
+      }
+    }
+  }
+
+  void hoist_loop_invariants(MethodIR& ir)
+  {
+    for (auto& function : ir.function_irs)
+      hoist_loop_invariants(*function);
+  }
+}
@@ -0,0 +1,26 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "compiler/ir/ir.h"
+
+namespace verona::compiler
+{
+  /**
+   * Hoist loop-invariant register setup out of loops.
+   *
+   * Statements that materialize constants (static type descriptors and
+   * integer literals) have no operands and no side effects, yet are
+   * re-executed on every iteration when they appear inside a loop. This
+   * pass moves them to the function's entry block, where they execute
+   * once.
+   *
+   * Loops are identified from back edges using the dominator tree: an edge
+   * to a block that dominates its source closes a loop, whose body is
+   * found by walking predecessors from the source back to the header.
+   *
+   * The pass runs on freshly built IR, before liveness and type inference,
+   * so downstream analyses see the hoisted program.
+   */
+  void hoist_loop_invariants(MethodIR& ir);
+}
@@ -0,0 +1,490 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include "compiler/ir/inliner.h"
+
+#include "compiler/ast.h"
+#include "compiler/ir/builder.h"
+#include "compiler/resolution.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace verona::compiler
+{
+  namespace
+  {
+    class Inliner
+    {
+    public:
+      Inliner(MethodIR& method_ir, size_t budget)
+      : method_ir_(method_ir), budget_(budget)
+      {}
+
+      void process()
+      {
+        for (auto& function : method_ir_.function_irs)
+          process_function(*function);
+      }
+
+    private:
+      void process_function(FunctionIR& ir)
+      {
+        find_known_entities(ir);
+
+        // Blocks left to scan for calls. Splitting a block adds its
+        // continuation here; spliced callee bodies are not added, so
+        // calls inside them are never reconsidered and the pass
+        // terminates even on recursive methods.
+        std::vector<BasicBlock*> worklist;
+        for (BasicBlock& bb : ir.basic_blocks)
+          worklist.push_back(&bb);
+
+        for (size_t i = 0; i < worklist.size(); i++)
+          scan_block(ir, worklist[i], &worklist);
+      }
+
+      /**
+       * Record the entity each SSA variable is statically known to be an
+       * instance of, from the statement that defines it.
+       */
+      void find_known_entities(const FunctionIR& ir)
+      {
+        known_entities_.clear();
+        copies_.clear();
+
+        for (const BasicBlock& bb : ir.basic_blocks)
+        {
+          for (const Statement& stmt : bb.statements)
+          {
+            if (const auto* static_type = std::get_if<StaticTypeStmt>(&stmt))
+              known_entities_.insert(
+                {static_type->output, static_type->definition});
+            else if (const auto* allocation = std::get_if<NewStmt>(&stmt))
+              known_entities_.insert(
+                {allocation->output, allocation->definition});
+            else if (const auto* copy = std::get_if<CopyStmt>(&stmt))
+              copies_.insert({copy->output, copy->input.variable});
+          }
+        }
+      }
+
+      const Entity* resolve_entity(Variable receiver) const
+      {
+        Variable current = receiver;
+        while (true)
+        {
+          auto entity = known_entities_.find(current);
+          if (entity != known_entities_.end())
+            return entity->second;
+
+          auto copy = copies_.find(current);
+          if (copy == copies_.end())
+            return nullptr;
+          current = copy->second;
+        }
+      }
+
+      /**
+       * Scan a block for the first call that can be inlined, and splice
+       * the callee in. The remainder of the block moves to the
+       * continuation, which is on the worklist, so a single scan of each
+       * block is enough.
+       */
+      void scan_block(
+        FunctionIR& ir, BasicBlock* bb, std::vector<BasicBlock*>* worklist)
+      {
+        for (size_t index = 0; index < bb->statements.size(); index++)
+        {
+          const auto* call = std::get_if<CallStmt>(&bb->statements[index]);
+          if (call == nullptr)
+            continue;
+
+          std::unique_ptr<MethodIR> callee = inlinable_callee(*call);
+          if (callee == nullptr)
+            continue;
+
+          worklist->push_back(
+            splice(ir, bb, index, *callee->function_irs.front()));
+          return;
+        }
+      }
+
+      /**
+       * Build the IR of the call's target, if the target is statically
+       * known and small enough to inline.
+       */
+      std::unique_ptr<MethodIR> inlinable_callee(const CallStmt& call)
+      {
+        const Entity* entity = resolve_entity(call.receiver.variable);
+        if (entity == nullptr)
+          return nullptr;
+
+        // An interface dispatch could select any implementing class'
+        // method, and a generic body mentions type parameters which have
+        // no meaning in the caller.
+        if (entity->kind->value() == Entity::Interface)
+          return nullptr;
+        if (entity->generics->types.size() != 0)
+          return nullptr;
+
+        const Method* method = lookup_member<Method>(entity, call.method);
+        if (method == nullptr || !method->body)
+          return nullptr;
+        if (method->signature->generics->types.size() != 0)
+          return nullptr;
+        if (method->signature->parameters.size() != call.arguments.size())
+          return nullptr;
+        if (rejected_.count(method) != 0)
+          return nullptr;
+
+        auto callee = build_ir(*method->signature, *method->body);
+
+        size_t size = 0;
+        for (const BasicBlock& bb : callee->function_irs.front()->basic_blocks)
+          size += bb.statements.size();
+
+        // A when clause builds its body as an extra function, whose
+        // index would not survive splicing. A callee that never returns
+        // would leave the continuation unreachable.
+        if (
+          callee->function_irs.size() != 1 || size > budget_ ||
+          callee->function_irs.front()->exits.empty())
+        {
+          rejected_.insert(method);
+          return nullptr;
+        }
+
+        return callee;
+      }
+
+      /**
+       * Replace the call at `bb->statements[index]` by the callee's body.
+       *
+       * The callee's blocks are grafted between `bb` and a new
+       * continuation block, which receives the rest of `bb` and its
+       * terminator, and is returned. The callee's variables and
+       * type-argument ids are renamed into the caller's, its receiver and
+       * parameters are bound with copies (mirroring the argument copies
+       * a Call would have performed into the callee's frame), and its
+       * returns become branches to the continuation.
+       */
+      BasicBlock* splice(
+        FunctionIR& ir, BasicBlock* bb, size_t index, FunctionIR& callee)
+      {
+        variables_.clear();
+        type_arguments_.clear();
+
+        CallStmt call = std::get<CallStmt>(std::move(bb->statements[index]));
+
+        // Split the caller's block: everything after the call, including
+        // the terminator, moves to the continuation.
+        BasicBlock* continuation = ir.add_block(bb);
+        std::move(
+          bb->statements.begin() + index + 1,
+          bb->statements.end(),
+          std::back_inserter(continuation->statements));
+        bb->statements.erase(
+          bb->statements.begin() + index, bb->statements.end());
+        continuation->terminator = std::move(bb->terminator);
+        bb->terminator = std::nullopt;
+
+        continuation->visit_successors([&](BasicBlock* successor) {
+          std::replace(
+            successor->predecessors.begin(),
+            successor->predecessors.end(),
+            bb,
+            continuation);
+        });
+        if (ir.exits.erase(bb) != 0)
+          ir.exits.insert(continuation);
+
+        // Bind the callee's receiver and parameters to the call's inputs.
+        auto bind = [&](Variable formal, IRInput actual) {
+          CopyStmt stmt(call.source_range);
+          stmt.input = actual;
+          stmt.output = fresh_variable(formal.lid);
+          variables_.insert({formal, stmt.output});
+          bb->statements.push_back(std::move(stmt));
+        };
+
+        if (callee.receiver.has_value())
+          bind(*callee.receiver, call.receiver);
+        for (size_t i = 0; i < callee.parameters.size(); i++)
+          bind(callee.parameters[i], call.arguments[i]);
+
+        // Graft the callee's blocks, renaming as we go. With multiple
+        // exits the call's output becomes a phi node in the continuation;
+        // with a single one, a copy of the returned value. The converted
+        // returns have the continuation as unique successor, as phi
+        // nodes require of its predecessors.
+        bool needs_phi = callee.exits.size() > 1;
+        std::optional<IRInput> returned;
+
+        std::unordered_map<const BasicBlock*, BasicBlock*> blocks;
+        for (const BasicBlock& callee_bb : callee.basic_blocks)
+          blocks.insert({&callee_bb, ir.add_block(nullptr)});
+
+        for (BasicBlock& callee_bb : callee.basic_blocks)
+        {
+          BasicBlock* grafted = blocks.at(&callee_bb);
+
+          grafted->immediate_dominator = callee_bb.immediate_dominator ?
+            blocks.at(callee_bb.immediate_dominator) :
+            bb;
+          for (BasicBlock* predecessor : callee_bb.predecessors)
+            grafted->predecessors.push_back(blocks.at(predecessor));
+          for (Variable phi : callee_bb.phi_nodes)
+          {
+            Variable renamed = remap(phi);
+            grafted->phi_nodes.push_back(renamed);
+            ir.variable_definitions.insert_or_assign(
+              renamed, grafted->entry_point());
+          }
+
+          for (Statement& stmt : callee_bb.statements)
+          {
+            rewrite(stmt);
+            grafted->statements.push_back(std::move(stmt));
+          }
+
+          Terminator& terminator = callee_bb.terminator.value();
+          if (const auto* ret = std::get_if<ReturnTerminator>(&terminator))
+          {
+            returned = remap(ret->input);
+            std::vector<Variable> phi_arguments;
+            if (needs_phi)
+              phi_arguments.push_back(returned->variable);
+
+            grafted->terminator =
+              BranchTerminator{continuation, std::move(phi_arguments)};
+            continuation->predecessors.push_back(grafted);
+          }
+          else
+          {
+            grafted->terminator =
+              rewrite_terminator(std::move(terminator), blocks);
+          }
+        }
+
+        BasicBlock* entry = blocks.at(callee.entry);
+        entry->predecessors.push_back(bb);
+        bb->terminator = BranchTerminator{entry, {}};
+
+        if (needs_phi)
+        {
+          continuation->phi_nodes.push_back(call.output);
+          ir.variable_definitions.insert_or_assign(
+            call.output, continuation->entry_point());
+        }
+        else
+        {
+          CopyStmt stmt(call.source_range);
+          stmt.input = returned.value();
+          stmt.output = call.output;
+          continuation->statements.insert(
+            continuation->statements.begin(), std::move(stmt));
+        }
+
+        // Re-index the definition points of the statements in the blocks
+        // we touched.
+        reindex_definitions(ir, bb);
+        reindex_definitions(ir, continuation);
+        for (const auto& [old_bb, grafted] : blocks)
+          reindex_definitions(ir, grafted);
+
+        return continuation;
+      }
+
+      void reindex_definitions(FunctionIR& ir, BasicBlock* bb)
+      {
+        for (size_t i = 0; i < bb->statements.size(); i++)
+        {
+          if (auto output = statement_output(bb->statements[i]))
+          {
+            ir.variable_definitions.insert_or_assign(
+              *output, IRPoint::statement(bb, i));
+          }
+        }
+      }
+
+      Variable fresh_variable(std::optional<LocalID> lid)
+      {
+        return Variable{method_ir_.variable_count++, lid};
+      }
+
+      Variable remap(Variable variable)
+      {
+        auto it = variables_.find(variable);
+        if (it != variables_.end())
+          return it->second;
+
+        Variable fresh = fresh_variable(variable.lid);
+        variables_.insert({variable, fresh});
+        return fresh;
+      }
+
+      IRInput remap(IRInput input)
+      {
+        return IRInput(remap(input.variable), input.source_range);
+      }
+
+      TypeArgumentsId remap(TypeArgumentsId id)
+      {
+        auto it = type_arguments_.find(id);
+        if (it != type_arguments_.end())
+          return it->second;
+
+        TypeArgumentsId fresh =
+          TypeArgumentsId(method_ir_.type_arguments_count++);
+        type_arguments_.insert({id, fresh});
+        return fresh;
+      }
+
+      void rewrite(Statement& stmt)
+      {
+        std::visit([&](auto& inner) { rewrite_statement(inner); }, stmt);
+      }
+
+      void rewrite_statement(NewStmt& stmt)
+      {
+        stmt.output = remap(stmt.output);
+        if (stmt.parent.has_value())
+          stmt.parent = remap(*stmt.parent);
+        stmt.type_arguments = remap(stmt.type_arguments);
+      }
+
+      void rewrite_statement(StaticTypeStmt& stmt)
+      {
+        stmt.output = remap(stmt.output);
+        stmt.type_arguments = remap(stmt.type_arguments);
+      }
+
+      void rewrite_statement(CallStmt& stmt)
+      {
+        stmt.output = remap(stmt.output);
+        stmt.receiver = remap(stmt.receiver);
+        for (IRInput& argument : stmt.arguments)
+          argument = remap(argument);
+        stmt.type_arguments = remap(stmt.type_arguments);
+      }
+
+      void rewrite_statement(WhenStmt&)
+      {
+        // Ruled out by the single FunctionIR requirement.
+        abort();
+      }
+
+      void rewrite_statement(ReadFieldStmt& stmt)
+      {
+        stmt.output = remap(stmt.output);
+        stmt.base = remap(stmt.base);
+      }
+
+      void rewrite_statement(WriteFieldStmt& stmt)
+      {
+        stmt.output = remap(stmt.output);
+        stmt.base = remap(stmt.base);
+        stmt.right = remap(stmt.right);
+      }
+
+      void rewrite_statement(IntegerLiteralStmt& stmt)
+      {
+        stmt.output = remap(stmt.output);
+      }
+
+      void rewrite_statement(StringLiteralStmt& stmt)
+      {
+        stmt.output = remap(stmt.output);
+      }
+
+      void rewrite_statement(MatchBindStmt& stmt)
+      {
+        // The type is unchanged: a non-generic callee cannot mention
+        // type parameters.
+        stmt.output = remap(stmt.output);
+        stmt.input = remap(stmt.input);
+      }
+
+      void rewrite_statement(CopyStmt& stmt)
+      {
+        stmt.output = remap(stmt.output);
+        stmt.input = remap(stmt.input);
+      }
+
+      void rewrite_statement(ViewStmt& stmt)
+      {
+        stmt.output = remap(stmt.output);
+        stmt.input = remap(stmt.input);
+      }
+
+      void rewrite_statement(EndScopeStmt& stmt)
+      {
+        for (Variable& dead : stmt.dead_variables)
+          dead = remap(dead);
+      }
+
+      void rewrite_statement(OverwriteStmt& stmt)
+      {
+        stmt.dead_variable = remap(stmt.dead_variable);
+      }
+
+      void rewrite_statement(UnitStmt& stmt)
+      {
+        stmt.output = remap(stmt.output);
+      }
+
+      Terminator rewrite_terminator(
+        Terminator terminator,
+        const std::unordered_map<const BasicBlock*, BasicBlock*>& blocks)
+      {
+        if (auto* branch = std::get_if<BranchTerminator>(&terminator))
+        {
+          branch->target = blocks.at(branch->target);
+          for (Variable& argument : branch->phi_arguments)
+            argument = remap(argument);
+        }
+        else if (auto* cond = std::get_if<IfTerminator>(&terminator))
+        {
+          cond->input = remap(cond->input);
+          cond->true_target = blocks.at(cond->true_target);
+          cond->false_target = blocks.at(cond->false_target);
+        }
+        else if (auto* match = std::get_if<MatchTerminator>(&terminator))
+        {
+          match->input = remap(match->input);
+          for (MatchTerminator::Arm& arm : match->arms)
+          {
+            arm.target = blocks.at(arm.target);
+            arm.binding = remap(arm.binding);
+          }
+        }
+        return terminator;
+      }
+
+      MethodIR& method_ir_;
+      size_t budget_;
+
+      /// Entity each variable is statically an instance of, and copy
+      /// links to look through, for the function being processed.
+      std::unordered_map<Variable, const Entity*> known_entities_;
+      std::unordered_map<Variable, Variable> copies_;
+
+      /// Methods already found too big or of the wrong shape, so their IR
+      /// is built at most once.
+      std::unordered_set<const Method*> rejected_;
+
+      /// Renamings of the callee being spliced.
+      std::unordered_map<Variable, Variable> variables_;
+      std::unordered_map<TypeArgumentsId, TypeArgumentsId> type_arguments_;
+    };
+  }
+
+  void inline_direct_calls(MethodIR& ir, size_t budget)
+  {
+    if (budget == 0)
+      return;
+
+    Inliner(ir, budget).process();
+  }
+}
@@ -0,0 +1,29 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "compiler/ir/ir.h"
+
+namespace verona::compiler
+{
+  /**
+   * Inline small statically-resolved calls into their caller.
+   *
+   * A call's target is known at IR-build time when its receiver is the
+   * output of a StaticTypeStmt or a NewStmt, possibly through copies: the
+   * statement names the exact entity, so the method cannot dispatch
+   * anywhere else. Such a callee is spliced into the caller's CFG,
+   * replacing the Call opcode's frame setup with plain register copies.
+   * Accessors are the common case, and turn into a single field access.
+   *
+   * Only callees whose body has at most `budget` statements are inlined,
+   * and calls inside a spliced body are not reconsidered, so the growth
+   * per original call site is bounded by the budget. A budget of zero
+   * disables the pass.
+   *
+   * The pass runs on freshly built IR, before hoisting, liveness and type
+   * inference: downstream analyses see the inlined program, and check the
+   * callee's body with the caller's (possibly more precise) types.
+   */
+  void inline_direct_calls(MethodIR& ir, size_t budget);
+}
@@ -44,6 +44,20 @@ namespace verona::compiler
     {}
   }
 
+  std::optional<Variable> statement_output(const Statement& stmt)
+  {
+    return std::visit(
+      [](const auto& inner) -> std::optional<Variable> {
+        using T = std::decay_t<decltype(inner)>;
+        if constexpr (
+          std::is_same_v<T, EndScopeStmt> || std::is_same_v<T, OverwriteStmt>)
+          return std::nullopt;
+        else
+          return inner.output;
+      },
+      stmt);
+  }
+
   void BasicBlock::visit_successors(
     const std::function<void(BasicBlock*)> visitor) const
   {
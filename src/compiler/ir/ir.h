@@ -295,6 +295,11 @@ namespace verona::compiler
     UnitStmt>
     Statement;
 
+  /**
+   * Get the SSA variable defined by a statement, if any.
+   */
+  std::optional<Variable> statement_output(const Statement& stmt);
+
   struct BasicBlock
   {
     size_t index;
@@ -423,6 +428,14 @@ namespace verona::compiler
   {
     std::vector<std::unique_ptr<FunctionIR>> function_irs;
 
+    /**
+     * Number of SSA variables and type-argument ids handed out by the
+     * builder, across all the method's functions. Passes that add
+     * statements to the IR allocate fresh ones from here.
+     */
+    uint64_t variable_count = 0;
+    uint64_t type_arguments_count = 0;
+
     /**
      * Add a FunctionIR to this method
      */
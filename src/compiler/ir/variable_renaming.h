@@ -31,6 +31,15 @@ namespace verona::compiler
     Variable apply(Variable variable) const;
     VariableRenaming invert() const;
 
+    /**
+     * True if this renaming maps every variable to itself, ie. the edge it
+     * represents carries no phi nodes.
+     */
+    bool is_identity() const
+    {
+      return mapping_.empty();
+    }
+
     /**
      * Compute the composition of two renamings, such that
      *
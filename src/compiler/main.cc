@@ -5,11 +5,13 @@
 #include "compiler/codegen/codegen.h"
 #include "compiler/context.h"
 #include "compiler/elaboration.h"
+#include "compiler/fingerprint.h"
 #include "compiler/ir/builder.h"
 #include "compiler/ir/ir.h"
 #include "compiler/parser.h"
 #include "compiler/printing.h"
 #include "compiler/resolution.h"
+#include "compiler/symbol_index.h"
 #include "compiler/typecheck/wf_types.h"
 #include "ds/console.h"
 #include "fs.h"
@@ -21,6 +23,7 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <pegmatite.hh>
 #include <verona.h>
 
@@ -60,6 +63,16 @@ namespace verona::compiler
 
     bool enable_builtin = true;
     bool enable_colors = true;
+    bool incremental = false;
+    bool lazy_analysis = false;
+    bool symbol_index = false;
+    std::string profile_compile_file;
+
+    // Worker threads used for constraint solving; 0 = one per core.
+    size_t typecheck_threads = 0;
+
+    // Maximum callee size, in IR statements, for inlining; 0 disables.
+    size_t inline_budget = 8;
   };
 
   /**
@@ -76,6 +89,24 @@ namespace verona::compiler
     {
       context.add_print_pattern(pattern);
     }
+    if (!options.profile_compile_file.empty())
+    {
+      context.profiler().enable();
+    }
+  }
+
+  /**
+   * Read back the bytecode produced by a previous invocation.
+   */
+  bool read_output_file(const std::string& path, std::vector<uint8_t>* output)
+  {
+    std::ifstream input(path, std::ios::binary);
+    if (!input.is_open())
+      return false;
+
+    output->assign(
+      std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    return !output->empty();
   }
 
   bool compile(
@@ -96,6 +127,9 @@ namespace verona::compiler
       work_list.push(input_file_path);
     }
 
+    std::vector<std::string> source_paths;
+    std::optional<PassTimer> parse_timer;
+    parse_timer.emplace(context, "parse");
     while (!work_list.empty())
     {
       auto& input_file = work_list.front();
@@ -107,6 +141,7 @@ namespace verona::compiler
       }
 
       context.add_source_file(input_file.string());
+      source_paths.push_back(input_file.string());
       std::unique_ptr<File> file = parse(context, input_file.string(), input);
       if (!file)
       {
@@ -128,28 +163,101 @@ namespace verona::compiler
       program->files.push_back(std::move(file));
       work_list.pop();
     }
+    parse_timer.reset();
 
     dump_ast(context, program.get(), "ast");
 
-    if (!name_resolution(context, program.get()))
-      return false;
+    {
+      PassTimer timer(context, "name_resolution");
+      if (!name_resolution(context, program.get()))
+        return false;
+    }
 
     dump_ast(context, program.get(), "resolved-ast");
 
-    if (!elaborate(context, program.get()))
-      return false;
+    {
+      PassTimer timer(context, "elaboration");
+      if (!elaborate(context, program.get()))
+        return false;
+    }
 
     dump_ast(context, program.get(), "elaborated-ast");
 
-    if (!check_wf_types(context, program.get()))
-      return false;
+    {
+      PassTimer timer(context, "check_wf_types");
+      if (!check_wf_types(context, program.get()))
+        return false;
+    }
+
+    // With --incremental, fingerprint every definition of the elaborated
+    // program and compare against the previous build. When nothing
+    // changed the previous bytecode is reused wholesale; reusing
+    // individual methods' analysis would additionally need their
+    // solutions serialized, which the interned type representation does
+    // not support yet.
+    std::optional<std::string> fingerprint_path;
+    ProgramFingerprints fingerprints;
+    if (options.incremental && options.output_file)
+    {
+      fingerprint_path = *options.output_file + ".fingerprints";
+      fingerprints = fingerprint_program(program.get());
+
+      if (auto previous = load_fingerprints(*fingerprint_path))
+      {
+        if (
+          *previous == fingerprints &&
+          read_output_file(*options.output_file, output))
+        {
+          std::cerr << "No definitions changed; reusing "
+                    << *options.output_file << std::endl;
+          return true;
+        }
+
+        std::cerr << count_changed(*previous, fingerprints)
+                  << " definitions changed since the previous build"
+                  << std::endl;
+      }
+    }
 
-    std::unique_ptr<AnalysisResults> analysis = analyse(context, program.get());
+    // With --symbol-index, maintain a sidecar name -> entity table next
+    // to the main input, for tools that only need symbol lookup. The
+    // index is keyed on a content hash of the sources; when a fresh one
+    // already exists there is nothing to rewrite.
+    std::optional<std::string> symbol_index_path;
+    uint64_t source_hash = 0;
+    if (options.symbol_index && !options.input_files.empty())
+    {
+      source_hash = hash_source_files(source_paths);
+      std::string index_path = options.input_files.front() + ".symbols";
+      if (!SymbolIndex::open(index_path, source_hash))
+        symbol_index_path = index_path;
+    }
+
+    std::optional<PassTimer> analysis_timer;
+    analysis_timer.emplace(context, "analysis");
+    std::unique_ptr<AnalysisResults> analysis = options.lazy_analysis ?
+      analyse_lazy(context, program.get(), options.inline_budget) :
+      analyse(
+        context,
+        program.get(),
+        options.typecheck_threads,
+        options.inline_budget);
     if (!analysis->ok)
       return false;
+    analysis_timer.reset();
 
-    *output = codegen(context, *program, *analysis);
-    return !context.have_errors_occurred();
+    {
+      PassTimer timer(context, "codegen");
+      *output = codegen(context, *program, *analysis);
+    }
+
+    bool ok = !context.have_errors_occurred();
+    if (ok && fingerprint_path)
+      save_fingerprints(*fingerprint_path, fingerprints);
+    if (ok && symbol_index_path)
+      save_symbol_index(*symbol_index_path, *program, source_hash);
+
+    return ok;
   }
 
   std::string get_builtin_library()
@@ -207,7 +315,14 @@ namespace verona::compiler
       options.input_files.push_back(get_builtin_library());
 
     std::vector<uint8_t> bytecode;
-    if (!compile(context, options, &bytecode))
+    bool ok = compile(context, options, &bytecode);
+
+    // Written here rather than from a destructor: context.exit does not
+    // unwind the stack.
+    if (context.profiler().enabled())
+      context.profiler().dump(options.profile_compile_file);
+
+    if (!ok)
       context.exit(1);
 
     if (options.output_file)
@@ -249,6 +364,31 @@ int main(int argc, const char** argv)
   app.add_option("--print", options.print_patterns);
   app.add_flag("--disable-colors{false}", options.enable_colors);
   app.add_flag("--disable-builtin{false}", options.enable_builtin);
+  app.add_option(
+    "--profile-compile",
+    options.profile_compile_file,
+    "Write a chrome://tracing profile of the compilation to this file");
+  app.add_flag(
+    "--lazy-analysis",
+    options.lazy_analysis,
+    "Only analyse methods reachable from the entry point");
+  app.add_flag(
+    "--incremental",
+    options.incremental,
+    "Reuse the previous output when no definition changed "
+    "(requires --output)");
+  app.add_flag(
+    "--symbol-index",
+    options.symbol_index,
+    "Maintain an on-disk index of top-level symbols next to the input");
+  app.add_option(
+    "--typecheck-threads",
+    options.typecheck_threads,
+    "Worker threads used for constraint solving (0 = one per core)");
+  app.add_option(
+    "--inline-budget",
+    options.inline_budget,
+    "Maximum callee size, in IR statements, for inlining (0 disables)");
 
   verona::interpreter::add_arguments(app, options, "run");
 
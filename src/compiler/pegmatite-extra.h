@@ -1,12 +1,45 @@
 // Copyright Microsoft and Project Verona Contributors.
 // SPDX-License-Identifier: MIT
 #pragma once
+#include "compiler/context.h"
+
 #include <ast.hh>
 #include <pegmatite.hh>
 
+namespace verona::compiler
+{
+  /**
+   * Mixin that places AST nodes in the compilation context's arena.
+   *
+   * Pegmatite constructs AST nodes with plain new-expressions, which find a
+   * class-scope operator new through the node's base classes. Routing that
+   * operator through the arena turns the tens of millions of per-node
+   * allocations made while parsing a large program into bump-pointer
+   * increments.
+   *
+   * operator delete is a no-op: destructors still run when the owning
+   * ASTPtr goes away, but the storage is only reclaimed when the arena is,
+   * together with the context. Nodes are only ever allocated while parsing,
+   * which runs with a ThreadContext set.
+   */
+  template<typename Base>
+  struct ArenaAllocated : public Base
+  {
+    using Base::Base;
+
+    static void* operator new(size_t size)
+    {
+      return ThreadContext::get().ast_arena().allocate(
+        size, alignof(std::max_align_t));
+    }
+
+    static void operator delete(void*) {}
+  };
+}
+
 namespace pegmatite
 {
-  struct ASTInteger : public ASTNode
+  struct ASTInteger : public verona::compiler::ArenaAllocated<ASTNode>
   {
     bool
     construct(const InputRange& r, ASTStack&, const ErrorReporter&) override
@@ -26,7 +59,7 @@ namespace pegmatite
   };
 
   template<typename T>
-  struct ASTConstant : public ASTNode
+  struct ASTConstant : public verona::compiler::ArenaAllocated<ASTNode>
   {
     bool
     construct(const InputRange& r, ASTStack&, const ErrorReporter&) override
@@ -63,11 +63,24 @@ namespace verona::compiler
   TypeSignature
   Polarizer::visit_signature(const TypeSignature& signature, Polarity polarity)
   {
+    // The same signature appears in many method types: trait bounds and
+    // generated accessors repeat structurally identical signatures, so the
+    // whole signature is memoized on top of the per-type caches.
+    auto& cache = polarity == Polarity::Positive ? positive_signature_cache_ :
+                                                   negative_signature_cache_;
+
+    auto it = cache.find(signature);
+    if (it != cache.end())
+      return it->second;
+
     // Receiver and arguments are co-variant, return type is contra-variant
-    return TypeSignature(
+    TypeSignature result(
       apply(signature.receiver, reverse_polarity(polarity)),
       apply(signature.arguments, reverse_polarity(polarity)),
       apply(signature.return_type, polarity));
+
+    cache.insert({signature, result});
+    return result;
   }
 
   TypePtr Polarizer::visit_has_method_type(
@@ -104,5 +104,8 @@ namespace verona::compiler
 
     std::unordered_map<TypePtr, TypePtr> positive_cache_;
     std::unordered_map<TypePtr, TypePtr> negative_cache_;
+
+    std::map<TypeSignature, TypeSignature> positive_signature_cache_;
+    std::map<TypeSignature, TypeSignature> negative_signature_cache_;
   };
 }
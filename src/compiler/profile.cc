@@ -0,0 +1,86 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include "compiler/profile.h"
+
+#include "compiler/context.h"
+
+#include <fstream>
+#include <iostream>
+
+namespace verona::compiler
+{
+  void CompilationProfiler::record(
+    std::string_view name,
+    std::string_view detail,
+    Clock::time_point begin,
+    Clock::time_point end)
+  {
+    auto us = [&](Clock::time_point t) {
+      return std::chrono::duration_cast<std::chrono::microseconds>(t - start_)
+        .count();
+    };
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    size_t tid =
+      thread_ids_.insert({std::this_thread::get_id(), thread_ids_.size()})
+        .first->second;
+    events_.push_back(
+      {std::string(name),
+       std::string(detail),
+       tid,
+       static_cast<uint64_t>(us(begin)),
+       static_cast<uint64_t>(us(end) - us(begin))});
+  }
+
+  void CompilationProfiler::dump(const std::string& path)
+  {
+    std::ofstream output(path);
+    if (!output.is_open())
+    {
+      std::cerr << "Cannot open profile file " << path << std::endl;
+      return;
+    }
+
+    // Complete events ("ph": "X") in the chrome://tracing array format.
+    // Names and method paths only contain identifier characters, so no
+    // JSON escaping is needed.
+    output << "[";
+    bool first = true;
+    for (const auto& event : events_)
+    {
+      if (!first)
+        output << ",";
+      first = false;
+
+      output << "\n  {\"name\": \"" << event.name << "\", \"ph\": \"X\""
+             << ", \"pid\": 1, \"tid\": " << event.tid
+             << ", \"ts\": " << event.begin_us
+             << ", \"dur\": " << event.duration_us;
+      if (!event.detail.empty())
+        output << ", \"args\": {\"method\": \"" << event.detail << "\"}";
+      output << "}";
+    }
+    output << "\n]\n";
+  }
+
+  PassTimer::PassTimer(
+    Context& context, std::string_view name, std::string_view detail)
+  : profiler_(context.profiler().enabled() ? &context.profiler() : nullptr)
+  {
+    if (profiler_ != nullptr)
+    {
+      name_ = name;
+      detail_ = detail;
+      begin_ = CompilationProfiler::Clock::now();
+    }
+  }
+
+  PassTimer::~PassTimer()
+  {
+    if (profiler_ != nullptr)
+    {
+      profiler_->record(
+        name_, detail_, begin_, CompilationProfiler::Clock::now());
+    }
+  }
+}
@@ -0,0 +1,92 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Compilation self-profiling.
+ *
+ * When enabled with --profile-compile, the driver and the analysis
+ * passes wrap themselves in PassTimer scopes. Each scope becomes a
+ * complete event in the emitted chrome://tracing JSON file (load it in
+ * chrome://tracing or Perfetto); nesting and per-thread lanes give the
+ * hierarchy, and per-method passes carry the method path as an
+ * argument.
+ *
+ * Events are buffered and written by dump(), which the driver calls
+ * before exiting, since Context::exit does not run destructors.
+ */
+namespace verona::compiler
+{
+  class Context;
+
+  class CompilationProfiler
+  {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    void enable()
+    {
+      enabled_ = true;
+      start_ = Clock::now();
+    }
+
+    bool enabled() const
+    {
+      return enabled_;
+    }
+
+    void record(
+      std::string_view name,
+      std::string_view detail,
+      Clock::time_point begin,
+      Clock::time_point end);
+
+    void dump(const std::string& path);
+
+  private:
+    struct Event
+    {
+      std::string name;
+      std::string detail;
+      size_t tid;
+      uint64_t begin_us;
+      uint64_t duration_us;
+    };
+
+    bool enabled_ = false;
+    Clock::time_point start_;
+
+    std::mutex mutex_;
+    std::vector<Event> events_;
+    std::unordered_map<std::thread::id, size_t> thread_ids_;
+  };
+
+  /**
+   * RAII scope recording one profiler event; free when disabled.
+   * `detail` typically holds the method a per-method pass works on.
+   */
+  class PassTimer
+  {
+  public:
+    PassTimer(
+      Context& context, std::string_view name, std::string_view detail = "");
+    ~PassTimer();
+
+    PassTimer(const PassTimer&) = delete;
+    PassTimer& operator=(const PassTimer&) = delete;
+
+  private:
+    CompilationProfiler* profiler_;
+    std::string name_;
+    std::string detail_;
+    CompilationProfiler::Clock::time_point begin_;
+  };
+}
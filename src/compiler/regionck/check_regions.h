@@ -297,39 +297,15 @@ namespace verona::compiler
       Diagnostic reason_diagnostic,
       Args&&... reason_args)
     {
-      std::unordered_set<Variable> visited;
-      std::vector<Variable> todo;
-
       /**
-       * We walk the region graph to find all transitive direct and indirect
-       * children, and call check_not_live on them.
+       * All transitive direct and indirect children were precomputed when
+       * the graph was built (see RegionGraph::compute_closure), so this is
+       * a scan of the root's closure row rather than a graph walk.
        */
-
-      auto push_children = [&](Variable v) {
-        if (auto it = graph.incoming_edges.find(v);
-            it != graph.incoming_edges.end())
-        {
-          for (auto [child, _] : it->second)
-          {
-            if (visited.find(child) == visited.end())
-              todo.push_back(child);
-          }
-        }
-      };
-
-      push_children(root);
-      while (!todo.empty())
-      {
-        Variable current = todo.back();
-        todo.pop_back();
-
-        if (auto [_, inserted] = visited.insert(current); inserted)
-        {
-          check_not_live(
-            live, current, reason_range, reason_diagnostic, reason_args...);
-          push_children(current);
-        }
-      }
+      graph.for_each_transitive_child(root, [&](Variable child) {
+        check_not_live(
+          live, child, reason_range, reason_diagnostic, reason_args...);
+      });
     }
 
   private:
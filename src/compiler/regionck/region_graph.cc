@@ -7,8 +7,137 @@
 #include "compiler/typecheck/typecheck.h"
 #include "compiler/visitor.h"
 
+#include <limits>
+#include <numeric>
+
 namespace verona::compiler
 {
+  namespace
+  {
+    /// Union-find with path compression over dense variable ids.
+    struct UnionFind
+    {
+      std::vector<uint32_t> parent;
+
+      explicit UnionFind(size_t size) : parent(size)
+      {
+        std::iota(parent.begin(), parent.end(), 0);
+      }
+
+      uint32_t find(uint32_t x)
+      {
+        while (parent[x] != x)
+        {
+          parent[x] = parent[parent[x]];
+          x = parent[x];
+        }
+        return x;
+      }
+
+      void merge(uint32_t x, uint32_t y)
+      {
+        parent[find(x)] = find(y);
+      }
+    };
+  }
+
+  void RegionGraph::compute_closure()
+  {
+    variable_ids.clear();
+    variables.clear();
+
+    // Every edge endpoint appears in outgoing_edges, either as a source
+    // or as a target.
+    auto add_variable = [&](Variable v) {
+      if (variable_ids.emplace(v, uint32_t(variables.size())).second)
+        variables.push_back(v);
+    };
+    for (const auto& [from, edges] : outgoing_edges)
+    {
+      add_variable(from);
+      for (const auto& [to, _] : edges)
+        add_variable(to);
+    }
+
+    size_t count = variables.size();
+
+    // Mutually Direct variables are aliases of the same region. Collapse
+    // them into classes so each alias class is closed once and shares a
+    // row; their walks would reach the same children anyway.
+    UnionFind uf(count);
+    for (const auto& [from, edges] : outgoing_edges)
+    {
+      for (const auto& [to, kind] : edges)
+      {
+        if (kind != Edge::Direct)
+          continue;
+
+        auto it = outgoing_edges.find(to);
+        if (it == outgoing_edges.end())
+          continue;
+
+        auto back = it->second.find(from);
+        if (back != it->second.end() && back->second == Edge::Direct)
+          uf.merge(variable_ids.at(from), variable_ids.at(to));
+      }
+    }
+
+    // Allocate one row per alias class.
+    constexpr uint32_t NO_ROW = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> row_of_rep(count, NO_ROW);
+    closure_row.assign(count, 0);
+    closure.clear();
+
+    for (uint32_t id = 0; id < count; id++)
+    {
+      uint32_t rep = uf.find(id);
+      if (row_of_rep[rep] == NO_ROW)
+      {
+        row_of_rep[rep] = uint32_t(closure.size());
+        closure.emplace_back(count, false);
+      }
+      closure_row[id] = row_of_rep[rep];
+    }
+
+    // Seed each row with the immediate children of every member of its
+    // class; members end up in their own row only if a cycle leads back
+    // to them, matching the graph walk this replaces.
+    std::vector<std::vector<uint32_t>> seeds(closure.size());
+    for (uint32_t id = 0; id < count; id++)
+    {
+      auto it = incoming_edges.find(variables[id]);
+      if (it == incoming_edges.end())
+        continue;
+
+      for (const auto& [child, _] : it->second)
+        seeds[closure_row[id]].push_back(variable_ids.at(child));
+    }
+
+    std::vector<uint32_t> todo;
+    for (size_t row_index = 0; row_index < closure.size(); row_index++)
+    {
+      std::vector<bool>& row = closure[row_index];
+      todo.assign(seeds[row_index].begin(), seeds[row_index].end());
+
+      while (!todo.empty())
+      {
+        uint32_t current = todo.back();
+        todo.pop_back();
+
+        if (row[current])
+          continue;
+        row[current] = true;
+
+        auto it = incoming_edges.find(variables[current]);
+        if (it == incoming_edges.end())
+          continue;
+
+        for (const auto& [child, _] : it->second)
+          todo.push_back(variable_ids.at(child));
+      }
+    }
+  }
+
   void dump_region_graphs(
     Context& context, const Method& method, const RegionGraphs& graphs)
   {
@@ -114,6 +243,11 @@ namespace verona::compiler
       }
     }
 
+    for (auto& entry : *result)
+    {
+      entry.second.compute_closure();
+    }
+
     dump_region_graphs(context, method, *result);
     return result;
   }
@@ -5,6 +5,7 @@
 
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 namespace verona::compiler
 {
@@ -60,6 +61,47 @@ namespace verona::compiler
     std::map<Variable, std::map<Variable, Edge>> incoming_edges;
 
     void add_edge(Variable from, Variable to, Edge edge);
+
+    /**
+     * Precomputed transitive-children closure.
+     *
+     * Region checking repeatedly asks for all transitive children of a
+     * variable (everything that must be invalidated when it is consumed
+     * or overwritten). The variables of the block are numbered densely,
+     * mutually-Direct variables - aliases of the same region - are
+     * collapsed into one class through a union-find, and each class gets
+     * a bitmap row over the universe marking its transitive children.
+     * Queries then scan a row instead of walking the graph with a
+     * visited set per call.
+     *
+     * Computed once by compute_closure after all edges are added.
+     */
+    std::map<Variable, uint32_t> variable_ids;
+    std::vector<Variable> variables;
+    std::vector<uint32_t> closure_row;
+    std::vector<std::vector<bool>> closure;
+
+    void compute_closure();
+
+    /**
+     * Invoke `f` on every transitive child of `root`. As with the graph
+     * walk this replaces, `root` itself is included only if a cycle
+     * leads back to it.
+     */
+    template<typename F>
+    void for_each_transitive_child(Variable root, F&& f) const
+    {
+      auto it = variable_ids.find(root);
+      if (it == variable_ids.end())
+        return;
+
+      const std::vector<bool>& row = closure.at(closure_row.at(it->second));
+      for (size_t i = 0; i < row.size(); i++)
+      {
+        if (row[i])
+          f(variables.at(i));
+      }
+    }
   };
   typedef std::unordered_map<const BasicBlock*, RegionGraph> RegionGraphs;
 
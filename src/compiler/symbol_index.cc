@@ -0,0 +1,294 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include "compiler/symbol_index.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifndef _MSC_VER
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace verona::compiler
+{
+  namespace
+  {
+    /**
+     * File layout, all integers little-endian:
+     *
+     *   u64 MAGIC            format tag, doubles as the version
+     *   u64 source hash      hash_source_files of the inputs
+     *   u32 entry count
+     *   u32 slot count       power of two, strictly greater than entries
+     *   slot count * {       open-addressed table, linear probing
+     *     u64 name hash
+     *     u32 name offset    into the string pool, EMPTY_SLOT if unused
+     *     u32 file
+     *     u32 entity
+     *     u32 kind
+     *   }
+     *   string pool          NUL-terminated names
+     *
+     * Bump MAGIC whenever the layout changes shape; old files then fail
+     * to open and get rewritten.
+     */
+    constexpr uint64_t MAGIC = 0x3176786469736e76; // "vnsidxv1"
+    constexpr size_t HEADER_SIZE = 24;
+    constexpr size_t SLOT_SIZE = 24;
+    constexpr uint32_t EMPTY_SLOT = 0xffffffff;
+
+    uint64_t fnv1a(std::string_view data)
+    {
+      uint64_t hash = 0xcbf29ce484222325;
+      for (char c : data)
+      {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3;
+      }
+      return hash;
+    }
+
+    template<typename T>
+    void write_int(std::vector<uint8_t>* buffer, T value)
+    {
+      for (size_t i = 0; i < sizeof(T); i++)
+      {
+        buffer->push_back((value >> (i * 8)) & 0xff);
+      }
+    }
+
+    template<typename T>
+    T read_int(const uint8_t* data, size_t offset)
+    {
+      T value = 0;
+      for (size_t i = 0; i < sizeof(T); i++)
+      {
+        value |= static_cast<T>(data[offset + i]) << (i * 8);
+      }
+      return value;
+    }
+
+    size_t next_power_of_two(size_t n)
+    {
+      size_t result = 1;
+      while (result < n)
+        result *= 2;
+      return result;
+    }
+  }
+
+  uint64_t hash_source_files(const std::vector<std::string>& paths)
+  {
+    uint64_t hash = 0xcbf29ce484222325;
+    for (const auto& path : paths)
+    {
+      // Chain per-file hashes rather than concatenating the bytes, so
+      // moving content across file boundaries changes the result.
+      hash ^= fnv1a(path);
+      hash *= 0x100000001b3;
+
+      std::ifstream input(path, std::ios::binary);
+      std::string contents(
+        (std::istreambuf_iterator<char>(input)),
+        std::istreambuf_iterator<char>());
+      hash ^= fnv1a(contents);
+      hash *= 0x100000001b3;
+    }
+    return hash;
+  }
+
+  bool save_symbol_index(
+    const std::string& path, const Program& program, uint64_t source_hash)
+  {
+    struct IndexedEntity
+    {
+      const Entity* entity;
+      uint32_t file;
+      uint32_t index;
+    };
+
+    std::vector<IndexedEntity> entities;
+    for (uint32_t file = 0; file < program.files.size(); file++)
+    {
+      uint32_t index = 0;
+      for (const auto& entity : program.files[file]->entities)
+      {
+        entities.push_back({entity.get(), file, index++});
+      }
+    }
+
+    // Load factor of at most one half keeps probe chains short and
+    // guarantees the reader's probe loop hits an empty slot.
+    size_t slot_count = next_power_of_two(2 * entities.size() + 1);
+
+    struct Slot
+    {
+      uint64_t name_hash;
+      uint32_t name_offset = EMPTY_SLOT;
+      uint32_t file;
+      uint32_t entity;
+      uint32_t kind;
+    };
+    std::vector<Slot> slots(slot_count);
+    std::string pool;
+
+    for (const auto& indexed : entities)
+    {
+      const std::string& name = indexed.entity->name;
+      uint64_t hash = fnv1a(name);
+      size_t slot = hash & (slot_count - 1);
+      while (slots[slot].name_offset != EMPTY_SLOT)
+        slot = (slot + 1) & (slot_count - 1);
+
+      slots[slot].name_hash = hash;
+      slots[slot].name_offset = truncate<uint32_t>(pool.size());
+      slots[slot].file = indexed.file;
+      slots[slot].entity = indexed.index;
+      slots[slot].kind = static_cast<uint32_t>(indexed.entity->kind->value());
+      pool += name;
+      pool += '\0';
+    }
+
+    std::vector<uint8_t> buffer;
+    buffer.reserve(HEADER_SIZE + slot_count * SLOT_SIZE + pool.size());
+    write_int<uint64_t>(&buffer, MAGIC);
+    write_int<uint64_t>(&buffer, source_hash);
+    write_int<uint32_t>(&buffer, truncate<uint32_t>(entities.size()));
+    write_int<uint32_t>(&buffer, truncate<uint32_t>(slot_count));
+    for (const auto& slot : slots)
+    {
+      write_int<uint64_t>(&buffer, slot.name_hash);
+      write_int<uint32_t>(&buffer, slot.name_offset);
+      write_int<uint32_t>(&buffer, slot.file);
+      write_int<uint32_t>(&buffer, slot.entity);
+      write_int<uint32_t>(&buffer, slot.kind);
+    }
+    buffer.insert(buffer.end(), pool.begin(), pool.end());
+
+    std::ofstream output(path, std::ios::binary);
+    if (!output.is_open())
+    {
+      std::cerr << "Cannot open symbol index file " << path << std::endl;
+      return false;
+    }
+    output.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    return output.good();
+  }
+
+  std::optional<SymbolIndex>
+  SymbolIndex::open(const std::string& path, uint64_t source_hash)
+  {
+    std::shared_ptr<const uint8_t> data;
+    size_t size = 0;
+
+#ifndef _MSC_VER
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+      struct stat st;
+      void* addr = MAP_FAILED;
+
+      if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+      {
+        size = static_cast<size_t>(st.st_size);
+        addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      }
+
+      // The mapping, if any, persists after the descriptor is closed.
+      close(fd);
+
+      if (addr != MAP_FAILED)
+      {
+        data = std::shared_ptr<const uint8_t>(
+          static_cast<const uint8_t*>(addr), [size](const uint8_t* p) {
+            munmap(const_cast<void*>(static_cast<const void*>(p)), size);
+          });
+      }
+    }
+#endif
+
+    if (!data)
+    {
+      std::ifstream input(path, std::ios::binary);
+      if (!input.is_open())
+        return std::nullopt;
+
+      std::vector<uint8_t> bytes(
+        (std::istreambuf_iterator<char>(input)),
+        std::istreambuf_iterator<char>());
+      size = bytes.size();
+      auto owned = std::make_shared<std::vector<uint8_t>>(std::move(bytes));
+      data = std::shared_ptr<const uint8_t>(owned, owned->data());
+    }
+
+    if (size < HEADER_SIZE)
+      return std::nullopt;
+    if (read_int<uint64_t>(data.get(), 0) != MAGIC)
+      return std::nullopt;
+    if (read_int<uint64_t>(data.get(), 8) != source_hash)
+      return std::nullopt;
+
+    uint32_t entries = read_int<uint32_t>(data.get(), 16);
+    uint32_t slot_count = read_int<uint32_t>(data.get(), 20);
+    if (slot_count == 0 || (slot_count & (slot_count - 1)) != 0)
+      return std::nullopt;
+    if (entries >= slot_count)
+      return std::nullopt;
+    if (size < HEADER_SIZE + static_cast<size_t>(slot_count) * SLOT_SIZE)
+      return std::nullopt;
+
+    return SymbolIndex(std::move(data), size);
+  }
+
+  std::optional<SymbolIndex::Entry>
+  SymbolIndex::lookup(std::string_view name) const
+  {
+    const uint8_t* data = data_.get();
+    uint32_t slot_count = read_int<uint32_t>(data, 20);
+    size_t pool_offset = HEADER_SIZE + static_cast<size_t>(slot_count) * SLOT_SIZE;
+
+    uint64_t hash = fnv1a(name);
+    for (size_t probe = 0; probe < slot_count; probe++)
+    {
+      size_t slot = (hash + probe) & (slot_count - 1);
+      size_t offset = HEADER_SIZE + slot * SLOT_SIZE;
+
+      uint32_t name_offset = read_int<uint32_t>(data, offset + 8);
+      if (name_offset == EMPTY_SLOT)
+        return std::nullopt;
+      if (read_int<uint64_t>(data, offset) != hash)
+        continue;
+
+      size_t name_start = pool_offset + name_offset;
+      if (name_start >= size_)
+        return std::nullopt;
+      const char* start = reinterpret_cast<const char*>(data + name_start);
+      const void* end = memchr(start, '\0', size_ - name_start);
+      if (end == nullptr)
+        return std::nullopt;
+
+      std::string_view candidate(
+        start, static_cast<const char*>(end) - start);
+      if (candidate != name)
+        continue;
+
+      Entry entry;
+      entry.name = candidate;
+      entry.file = read_int<uint32_t>(data, offset + 12);
+      entry.entity = read_int<uint32_t>(data, offset + 16);
+      entry.kind =
+        static_cast<Entity::Kind>(read_int<uint32_t>(data, offset + 20));
+      return entry;
+    }
+    return std::nullopt;
+  }
+
+  size_t SymbolIndex::size() const
+  {
+    return read_int<uint32_t>(data_.get(), 16);
+  }
+}
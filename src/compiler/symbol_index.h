@@ -0,0 +1,91 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "compiler/ast.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Persistent on-disk symbol index.
+ *
+ * After a successful compile, the top-level symbol table (entity name to
+ * entity handle) is written to a sidecar file next to the main source
+ * file, as a compact open-addressed hash table over a string pool.
+ * Subsequent runs map the file read-only and answer name lookups straight
+ * from the mapping, so tools that only need lookup (formatters, tags
+ * generation, the planned language server) can skip parsing and
+ * resolution entirely.
+ *
+ * Freshness is verified by a content hash of all the source files the
+ * index was built from; a stale or malformed index simply fails to open
+ * and the producer rewrites it.
+ */
+namespace verona::compiler
+{
+  /**
+   * Hash the names and contents of the given files. Any change to the
+   * file set, to a file's name or to its contents changes the hash.
+   */
+  uint64_t hash_source_files(const std::vector<std::string>& paths);
+
+  /**
+   * Write the program's top-level symbols to `path`. Returns false if the
+   * file cannot be written.
+   */
+  bool save_symbol_index(
+    const std::string& path, const Program& program, uint64_t source_hash);
+
+  /**
+   * Read-only view of an index file, backed by a memory mapping where the
+   * platform provides one.
+   */
+  class SymbolIndex
+  {
+  public:
+    /**
+     * Handle to an entity, stable across compiler invocations as long as
+     * the sources are unchanged: the position of its file in parse order
+     * and its position within that file's entity list.
+     */
+    struct Entry
+    {
+      std::string_view name;
+      Entity::Kind kind;
+      uint32_t file;
+      uint32_t entity;
+    };
+
+    /**
+     * Open an index file. Returns nullopt if the file is missing, is in
+     * an unknown format, or was built from different sources than
+     * `source_hash` describes.
+     */
+    static std::optional<SymbolIndex>
+    open(const std::string& path, uint64_t source_hash);
+
+    /**
+     * Look up a top-level symbol by name. The returned name views into
+     * the index's mapping and is valid for the lifetime of the index.
+     */
+    std::optional<Entry> lookup(std::string_view name) const;
+
+    /**
+     * Number of symbols in the index.
+     */
+    size_t size() const;
+
+  private:
+    SymbolIndex(std::shared_ptr<const uint8_t> data, size_t size)
+    : data_(std::move(data)), size_(size)
+    {}
+
+    std::shared_ptr<const uint8_t> data_;
+    size_t size_;
+  };
+}
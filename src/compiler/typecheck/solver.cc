@@ -9,47 +9,89 @@
 #include <fmt/ostream.h>
 #include <fstream>
 #include <iomanip>
+#include <memory>
 
 namespace verona::compiler
 {
+  /**
+   * Copy-on-write holder for a component of the solver state.
+   *
+   * Copying a Cow only copies a pointer; the underlying value is shared
+   * until `write` is called, which materializes a private copy if anyone
+   * else still holds the old one. Backtracking pushes one state per
+   * alternative, most of which only ever touch their constraint list, so
+   * sharing the substitution and assumptions between siblings avoids
+   * copying them once per branch point.
+   */
+  template<typename T>
+  class Cow
+  {
+  public:
+    Cow() : value_(std::make_shared<T>()) {}
+    explicit Cow(T value) : value_(std::make_shared<T>(std::move(value))) {}
+
+    const T& read() const
+    {
+      return *value_;
+    }
+
+    T& write()
+    {
+      if (value_.use_count() != 1)
+        value_ = std::make_shared<T>(*value_);
+      return *value_;
+    }
+
+  private:
+    std::shared_ptr<T> value_;
+  };
+
   struct SolverState
   {
-    Constraints constraints;
+    Cow<Constraints> constraints;
 
-    Substitution substitution;
-    Assumptions assumptions;
+    Cow<Substitution> substitution;
+    Cow<Assumptions> assumptions;
 
     uint64_t steps = 0;
     uint64_t depth = 0;
 
-    explicit SolverState(Constraints constraints) : constraints(constraints) {}
+    explicit SolverState(Constraints constraints)
+    : constraints(std::move(constraints))
+    {}
 
     void apply_substitution(Context& context, const Substitution& s)
     {
-      constraints = s.apply(context, constraints);
-      assumptions = s.apply(context, assumptions);
-      s.apply_to(context, &substitution);
+      // Compound solutions frequently carry a trivial substitution;
+      // applying it would materialize every component for nothing.
+      if (s.is_trivial())
+        return;
+
+      constraints.write() = s.apply(context, constraints.read());
+      assumptions.write() = s.apply(context, assumptions.read());
+      s.apply_to(context, &substitution.write());
     }
 
-    void add_constraints(Constraints cs)
+    void add_constraints(const Constraints& cs)
     {
-      constraints.insert(constraints.end(), cs.begin(), cs.end());
+      Constraints& own = constraints.write();
+      own.insert(own.end(), cs.begin(), cs.end());
     }
 
     void add_constraint(Constraint c)
     {
-      constraints.push_back(c);
+      constraints.write().push_back(c);
     }
 
-    bool done()
+    bool done() const
     {
-      return constraints.empty();
+      return constraints.read().empty();
     }
 
     Constraint pop_constraint()
     {
-      Constraint c = constraints.back();
-      constraints.pop_back();
+      Constraint c = constraints.read().back();
+      constraints.write().pop_back();
       depth = c.depth;
       return c;
     }
@@ -140,7 +182,7 @@ namespace verona::compiler
       if (state.done())
       {
         trace(state, "  done");
-        solutions.insert(Solution{state.substitution});
+        solutions.insert(Solution{state.substitution.read()});
         state_stack.pop_back();
         continue;
       }
@@ -151,14 +193,28 @@ namespace verona::compiler
 
       trace(state, c);
 
-      if (state.assumptions.find(c) != state.assumptions.end())
+      const Assumptions& assumptions = state.assumptions.read();
+      if (assumptions.find(c) != assumptions.end())
       {
         // Do nothing
         trace(state, "  assumed");
         continue;
       }
 
-      auto solution = Constraint::solve(c, mode, context_);
+      auto memo_key = std::make_tuple(c.left.get(), c.right.get(), mode);
+      auto memo = solved_memo_.find(memo_key);
+      if (memo != solved_memo_.end())
+      {
+        trace(state, "  memoized");
+      }
+      else
+      {
+        memo = solved_memo_
+                 .insert({memo_key, Constraint::solve(c, mode, context_)})
+                 .first;
+      }
+
+      const auto& solution = memo->second;
       if (!solution)
       {
         trace(state, "  Cannot solve constraint ", c);
@@ -193,7 +249,7 @@ namespace verona::compiler
     assert(!state_stack->empty());
 
     SolverState& state = state_stack->back();
-    state.assumptions.insert(constraint);
+    state.assumptions.write().insert(constraint);
     for (auto it : substitution.types())
     {
       trace(state, "  ", *it.first, " --> ", *it.second);
@@ -214,7 +270,7 @@ namespace verona::compiler
     SolverState& state = state_stack->back();
 
     state.add_constraints(solution.subconstraints);
-    state.assumptions.insert(
+    state.assumptions.write().insert(
       solution.assumptions.begin(), solution.assumptions.end());
 
     for (auto it : solution.substitution.types())
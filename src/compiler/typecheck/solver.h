@@ -4,6 +4,9 @@
 
 #include "compiler/typecheck/constraint.h"
 
+#include <map>
+#include <tuple>
+
 namespace verona::compiler
 {
   struct SolverState;
@@ -52,6 +55,19 @@ namespace verona::compiler
     template<typename... Args>
     void trace(const SolverState& state, const Args&... args);
 
+    /**
+     * Memo of Constraint::solve results. Types are interned, so the
+     * pointer pair is already the canonical form of a constraint (depth
+     * and reason are debugging-only and ignored by comparison), and the
+     * derivation only depends on that pair and the mode. Structurally
+     * identical constraints recur heavily, e.g. across instantiations
+     * of the same generic, and hit the memo instead of being re-solved.
+     */
+    std::map<
+      std::tuple<const Type*, const Type*, SolverMode>,
+      std::optional<Constraint::Solution>>
+      solved_memo_;
+
     uint64_t total_steps_ = 0;
     Context& context_;
     std::ostream& output_;
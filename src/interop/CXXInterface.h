@@ -20,14 +20,24 @@
 #include <clang/Lex/HeaderSearchOptions.h>
 #include <clang/Lex/Preprocessor.h>
 #include <clang/Lex/PreprocessorOptions.h>
+#include <clang/Sema/Lookup.h>
 #include <clang/Sema/Sema.h>
 #include <clang/Sema/Template.h>
 #include <clang/Sema/TemplateDeduction.h>
 #include <clang/Serialization/ASTWriter.h>
 #include <clang/Tooling/Tooling.h>
+#include <llvm/ADT/Hashing.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/StringExtras.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
 #include <llvm/Support/SmallVectorMemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <unordered_map>
+#include <vector>
 
 namespace verona::interop
 {
@@ -55,6 +65,10 @@ namespace verona::interop
     std::unique_ptr<Compiler> Clang;
     /// Virtual file system (compiler unit, pch, headers)
     FileSystem FS;
+    /// Resolved queries by qualified name, retained across calls. The
+    /// AST never changes after parsing, so entries (including negative
+    /// ones) stay valid for the lifetime of the interface.
+    std::unordered_map<std::string, CXXType> typeCache;
 
     /**
      * Creates new AST consumers to add the AST back into the interface.
@@ -198,6 +212,314 @@ namespace verona::interop
         new llvm::SmallVectorMemoryBuffer(std::move(pchOutBuffer)));
     }
 
+    /**
+     * On-disk cache of generated pre-compiled headers.
+     *
+     * Generating the PCH re-parses the user header and everything it
+     * includes, which dominates start-up time for header-heavy
+     * interfaces. When the user provides a cache directory, the PCH is
+     * written there once and later runs map it back into the virtual
+     * file system, paying page-fault cost only.
+     *
+     * Cached files are keyed on everything that determines the compiler
+     * invocation: the contents of the user header, the include path and
+     * the source language (the remaining arguments are fixed by
+     * Compiler). Headers included transitively are not part of the key;
+     * Clang records them (with timestamps) inside the PCH and rejects a
+     * stale one when loading it.
+     *
+     * The cache file is a small header followed by the raw PCH bytes.
+     * Integers are host-endian: the PCH itself is only valid for the
+     * Clang that wrote it, so cache files are machine-local by nature.
+     */
+    struct PCHCacheHeader
+    {
+      uint64_t magic;
+      uint64_t key;
+      uint64_t size;
+    };
+
+    /// "vnapch01", little-endian. Bump the version digits whenever the
+    /// layout changes; a mismatch regenerates the PCH.
+    static constexpr uint64_t pch_cache_magic = 0x3130686370616E76;
+
+    /// Hash of the inputs that determine the PCH, or 0 (cache disabled
+    /// for this run) if the user header can't be read.
+    static uint64_t pchCacheKey(
+      const char* headerFile,
+      llvm::ArrayRef<std::string> includePath,
+      SourceLanguage sourceLang)
+    {
+      auto buffer = llvm::MemoryBuffer::getFile(headerFile);
+      if (!buffer)
+        return 0;
+      llvm::hash_code hash = llvm::hash_value((*buffer)->getBuffer());
+      for (auto& dir : includePath)
+        hash = llvm::hash_combine(hash, dir);
+      hash = llvm::hash_combine(hash, static_cast<int>(sourceLang));
+      return static_cast<uint64_t>(hash);
+    }
+
+    /// Path of the cache file for a key, inside the cache directory.
+    static std::string pchCacheFile(llvm::StringRef cacheDir, uint64_t key)
+    {
+      llvm::SmallString<128> path(cacheDir);
+      llvm::sys::path::append(path, "verona-" + llvm::utohexstr(key) + ".pch");
+      return std::string(path);
+    }
+
+    /**
+     * Maps a cached PCH back into memory, or returns null if there is
+     * no usable cache file. The header is read eagerly; the PCH bytes
+     * are a memory-mapped slice of the file, so nothing else is read
+     * until Clang touches it.
+     */
+    std::unique_ptr<llvm::MemoryBuffer>
+    readCachedPCH(const std::string& path, uint64_t key)
+    {
+      auto header =
+        llvm::MemoryBuffer::getFileSlice(path, sizeof(PCHCacheHeader), 0);
+      if (!header || (*header)->getBufferSize() < sizeof(PCHCacheHeader))
+        return nullptr;
+
+      PCHCacheHeader hdr;
+      memcpy(&hdr, (*header)->getBufferStart(), sizeof(hdr));
+      if (hdr.magic != pch_cache_magic || hdr.key != key)
+        return nullptr;
+
+      uint64_t fileSize = 0;
+      if (
+        llvm::sys::fs::file_size(path, fileSize) ||
+        fileSize != sizeof(hdr) + hdr.size)
+        return nullptr;
+
+      auto pch =
+        llvm::MemoryBuffer::getFileSlice(path, hdr.size, sizeof(hdr));
+      if (!pch)
+        return nullptr;
+      return std::move(*pch);
+    }
+
+    /// Writes the PCH to the cache, best-effort. The file is written to
+    /// a temporary name and renamed into place, so a concurrent run
+    /// never maps a half-written cache.
+    void writeCachedPCH(
+      const std::string& path, uint64_t key, const llvm::MemoryBuffer& pch)
+    {
+      if (llvm::sys::fs::create_directories(FileSystem::getDirName(path)))
+        return;
+
+      PCHCacheHeader hdr = {pch_cache_magic, key, pch.getBufferSize()};
+      std::string tmp = path + ".tmp";
+      std::error_code EC;
+      llvm::raw_fd_ostream out(tmp, EC);
+      if (EC)
+        return;
+      out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+      out.write(pch.getBufferStart(), pch.getBufferSize());
+      out.close();
+      if (out.has_error() || llvm::sys::fs::rename(tmp, path))
+        llvm::sys::fs::remove(tmp);
+    }
+
+    /// Returns the PCH from the cache when possible, generating (and
+    /// caching) it otherwise. An empty cache path disables the cache.
+    std::unique_ptr<llvm::MemoryBuffer> loadOrGeneratePCH(
+      const char* headerFile,
+      llvm::ArrayRef<std::string> includePath,
+      SourceLanguage sourceLang,
+      llvm::StringRef pchCachePath)
+    {
+      if (pchCachePath.empty())
+        return generatePCH(headerFile, includePath, sourceLang);
+
+      uint64_t key = pchCacheKey(headerFile, includePath, sourceLang);
+      if (!key)
+        return generatePCH(headerFile, includePath, sourceLang);
+
+      auto path = pchCacheFile(pchCachePath, key);
+      if (auto cached = readCachedPCH(path, key))
+        return cached;
+
+      auto pchBuffer = generatePCH(headerFile, includePath, sourceLang);
+      writeCachedPCH(path, key, *pchBuffer);
+      return pchBuffer;
+    }
+
+    /// Specialisations queued by queueClassTemplate, awaiting their
+    /// definitions from instantiateQueued.
+    std::vector<clang::ClassTemplateSpecializationDecl*>
+      pendingSpecializations;
+
+    /**
+     * Finds or creates the canonical declaration of a class template
+     * specialisation, without instantiating its definition. Returns null if
+     * the type is not a class template.
+     */
+    clang::ClassTemplateSpecializationDecl* declareClassTemplateSpecialization(
+      CXXType& classTemplate, llvm::ArrayRef<clang::TemplateArgument> args)
+    {
+      if (classTemplate.kind != CXXType::Kind::TemplateClass)
+      {
+        return nullptr;
+      }
+
+      auto& S = Clang->getSema();
+
+      // Check if this specialisation is already present in the AST
+      // (declaration, definition, used).
+      clang::ClassTemplateDecl* ClassTemplate =
+        classTemplate.getAs<clang::ClassTemplateDecl>();
+      void* InsertPos = nullptr;
+      clang::ClassTemplateSpecializationDecl* Decl =
+        ClassTemplate->findSpecialization(args, InsertPos);
+      if (!Decl)
+      {
+        // This is the first time we have referenced this class template
+        // specialization. Create the canonical declaration and add it to
+        // the set of specializations.
+        Decl = clang::ClassTemplateSpecializationDecl::Create(
+          *ast,
+          ClassTemplate->getTemplatedDecl()->getTagKind(),
+          ClassTemplate->getDeclContext(),
+          ClassTemplate->getTemplatedDecl()->getBeginLoc(),
+          ClassTemplate->getLocation(),
+          ClassTemplate,
+          args,
+          nullptr);
+        ClassTemplate->AddSpecialization(Decl, InsertPos);
+      }
+      // If specialisation hasn't been directly declared yet (by the user),
+      // instantiate the declaration.
+      if (Decl->getSpecializationKind() == clang::TSK_Undeclared)
+      {
+        clang::MultiLevelTemplateArgumentList TemplateArgLists;
+        TemplateArgLists.addOuterTemplateArguments(args);
+        S.InstantiateAttrsForDecl(
+          TemplateArgLists, ClassTemplate->getTemplatedDecl(), Decl);
+      }
+      return Decl;
+    }
+
+    /**
+     * Resolves a fully qualified type name through Sema's qualified lookup,
+     * one nested name at a time.
+     *
+     * Unlike matching over the whole translation unit, this only
+     * materialises the declarations the query touches. When the AST is
+     * backed by a pre-compiled header, everything else stays serialized, so
+     * memory and time scale with the number of queries, not with the size
+     * of the header set.
+     */
+    CXXType lookupType(llvm::StringRef name)
+    {
+      name.consume_front("::");
+      llvm::SmallVector<llvm::StringRef, 4> parts;
+      name.split(parts, "::", -1, /*KeepEmpty=*/false);
+      if (parts.empty())
+      {
+        return CXXType();
+      }
+
+      auto& S = Clang->getSema();
+      clang::DeclContext* DC = ast->getTranslationUnitDecl();
+
+      // Walk the qualifiers; each one must be a namespace or a class.
+      // Sema's qualified lookup follows inline namespaces for us.
+      for (auto part : llvm::ArrayRef<llvm::StringRef>(parts).drop_back())
+      {
+        clang::DeclarationName declName{&ast->Idents.get(part)};
+        clang::LookupResult found(
+          S, declName, clang::SourceLocation{}, clang::Sema::LookupAnyName);
+        found.suppressDiagnostics();
+        S.LookupQualifiedName(found, DC);
+
+        clang::DeclContext* next = nullptr;
+        for (auto* decl : found)
+        {
+          if (auto* ns = clang::dyn_cast<clang::NamespaceDecl>(decl))
+          {
+            next = ns;
+            break;
+          }
+          if (auto* record = clang::dyn_cast<clang::CXXRecordDecl>(decl))
+          {
+            next = record;
+            break;
+          }
+        }
+        if (!next)
+        {
+          return CXXType();
+        }
+        DC = next;
+      }
+
+      // Resolve the final name, with the same preference order as the
+      // matchers in getType: template, then class, then enum.
+      clang::DeclarationName declName{&ast->Idents.get(parts.back())};
+      clang::LookupResult found(
+        S, declName, clang::SourceLocation{}, clang::Sema::LookupAnyName);
+      found.suppressDiagnostics();
+      S.LookupQualifiedName(found, DC);
+
+      const clang::EnumDecl* foundEnum = nullptr;
+      const clang::CXXRecordDecl* foundClass = nullptr;
+      const clang::ClassTemplateDecl* foundTemplateClass = nullptr;
+      for (auto* decl : found)
+      {
+        if (auto* templ = clang::dyn_cast<clang::ClassTemplateDecl>(decl))
+        {
+          foundTemplateClass = templ;
+        }
+        else if (auto* record = clang::dyn_cast<clang::CXXRecordDecl>(decl))
+        {
+          foundClass = record->getDefinition();
+        }
+        else if (auto* en = clang::dyn_cast<clang::EnumDecl>(decl))
+        {
+          foundEnum = en;
+        }
+      }
+
+      if (foundTemplateClass)
+      {
+        return CXXType(foundTemplateClass);
+      }
+      if (foundClass)
+      {
+        return CXXType(foundClass);
+      }
+      if (foundEnum)
+      {
+        return CXXType(foundEnum);
+      }
+      return CXXType();
+    }
+
+    /// Resolve a builtin type by its qualified spelling, returning an
+    /// invalid type for anything else.
+    static CXXType builtinType(llvm::StringRef name)
+    {
+      return llvm::StringSwitch<CXXType>(name)
+        .Case("::bool", CXXType::getBoolean())
+        .Case("::unsigned char", CXXType::getUnsignedChar())
+        .Case("::char", CXXType::getChar())
+        .Case("::signed char", CXXType::getSignedChar())
+        .Case("::short", CXXType::getShort())
+        .Case("::unsigned short", CXXType::getUnsignedShort())
+        .Case("::int", CXXType::getInt())
+        .Case("::unsigned int", CXXType::getUnsignedInt())
+        .Case("::long", CXXType::getLong())
+        .Case("::unsigned long", CXXType::getUnsignedLong())
+        .Case("::long long", CXXType::getLongLong())
+        .Case("::unsigned long long", CXXType::getUnsignedLongLong())
+        .Case("::float", CXXType::getFloat())
+        .Case("::double", CXXType::getDouble())
+        // Otherwise, just return empty invalid type
+        .Default(CXXType());
+    }
+
     /// Maps between CXXType and Clang's types.
     clang::QualType typeForBuiltin(CXXType::BuiltinTypeKinds ty)
     {
@@ -242,16 +564,21 @@ namespace verona::interop
      * CXXInterface c-tor. Creates the internal compile unit, include the
      * user file (and all dependencies), generates the pre-compiled headers,
      * creates the compiler instance and re-attaches the AST to the interface.
+     *
+     * When `pchCachePath` names a directory, the pre-compiled header is
+     * cached there between runs (see PCHCacheHeader above).
      */
     CXXInterface(
       std::string headerFile,
       llvm::ArrayRef<std::string> includePath,
-      SourceLanguage sourceLang = SourceLanguage::CXX)
+      SourceLanguage sourceLang = SourceLanguage::CXX,
+      llvm::StringRef pchCachePath = "")
     : factory(this)
     {
-      // Pre-compiles the file requested by the user
-      std::unique_ptr<llvm::MemoryBuffer> pchBuffer =
-        generatePCH(headerFile.c_str(), includePath, sourceLang);
+      // Pre-compiles the file requested by the user, reusing a cached
+      // PCH if one exists for these inputs.
+      std::unique_ptr<llvm::MemoryBuffer> pchBuffer = loadOrGeneratePCH(
+        headerFile.c_str(), includePath, sourceLang, pchCachePath);
 
       // Creating a fake compile unit to include the target file
       // in an in-memory file system.
@@ -289,86 +616,145 @@ namespace verona::interop
      * We don't need to find builtin types because they're pre-defined in the
      * language and represented in CXXType directly.
      *
-     * TODO: Change this method to receive a list of names and return a list
-     * of types (or some variation over mutliple types at the same time).
+     * Single-name convenience over getTypes; a binding pipeline with many
+     * names in hand should batch them instead.
      */
     CXXType getType(std::string name)
     {
-      name = "::" + name;
-      clang::ast_matchers::MatchFinder finder;
-      const clang::EnumDecl* foundEnum = nullptr;
-      const clang::CXXRecordDecl* foundClass = nullptr;
-      const clang::ClassTemplateDecl* foundTemplateClass = nullptr;
+      return getTypes(llvm::ArrayRef<std::string>(name)).front();
+    }
 
-      finder.addMatcher(
-        clang::ast_matchers::cxxRecordDecl(clang::ast_matchers::hasName(name))
-          .bind("id"),
-        new HandleMatch(
-          [&](const clang::ast_matchers::MatchFinder::MatchResult& Result) {
-            auto* decl = Result.Nodes.getNodeAs<clang::CXXRecordDecl>("id")
-                           ->getDefinition();
-            if (decl)
-            {
-              foundClass = decl;
-            }
-          }));
-      finder.addMatcher(
-        clang::ast_matchers::classTemplateDecl(
-          clang::ast_matchers::hasName(name))
-          .bind("id"),
-        new HandleMatch(
-          [&](const clang::ast_matchers::MatchFinder::MatchResult& Result) {
-            auto* decl = Result.Nodes.getNodeAs<clang::ClassTemplateDecl>("id");
-            if (decl)
-            {
-              foundTemplateClass = decl;
-            }
-          }));
-      finder.addMatcher(
-        clang::ast_matchers::enumDecl(clang::ast_matchers::hasName(name))
-          .bind("id"),
-        new HandleMatch(
-          [&](const clang::ast_matchers::MatchFinder::MatchResult& Result) {
-            auto* decl = Result.Nodes.getNodeAs<clang::EnumDecl>("id");
-            if (decl)
-            {
-              foundEnum = decl;
-            }
-          }));
-      finder.matchAST(*ast);
+    /**
+     * Resolve a batch of fully qualified names, returning their types in
+     * input order.
+     *
+     * Names resolved by an earlier call are served from a cache retained
+     * for the lifetime of the interface. The rest go through qualified
+     * lookup first, which only deserializes the declarations on the
+     * queried path (see lookupType). Names the lookup cannot resolve
+     * share a single exhaustive matcher walk over the translation unit,
+     * so a batch pays at most one full AST traversal rather than one per
+     * name.
+     */
+    std::vector<CXXType> getTypes(llvm::ArrayRef<std::string> names)
+    {
+      std::vector<CXXType> results(names.size());
+      std::vector<size_t> pending;
 
-      // Should onlyt match one, so this is fine.
-      if (foundTemplateClass)
+      for (size_t i = 0; i < names.size(); i++)
       {
-        return CXXType(foundTemplateClass);
+        std::string name = "::" + names[i];
+
+        if (auto it = typeCache.find(name); it != typeCache.end())
+        {
+          results[i] = it->second;
+        }
+        else if (auto ty = lookupType(name); ty.valid())
+        {
+          results[i] = ty;
+          typeCache.emplace(std::move(name), ty);
+        }
+        else
+        {
+          pending.push_back(i);
+        }
       }
-      if (foundClass)
+
+      if (pending.empty())
       {
-        return CXXType(foundClass);
+        return results;
       }
-      if (foundEnum)
+
+      // One matcher walk resolves every name the qualified lookup missed,
+      // with the same preference order as lookupType: template, then
+      // class, then enum.
+      struct Candidates
       {
-        return CXXType(foundEnum);
+        const clang::ClassTemplateDecl* foundTemplateClass = nullptr;
+        const clang::CXXRecordDecl* foundClass = nullptr;
+        const clang::EnumDecl* foundEnum = nullptr;
+      };
+      std::vector<Candidates> candidates(pending.size());
+
+      clang::ast_matchers::MatchFinder finder;
+      for (size_t i = 0; i < pending.size(); i++)
+      {
+        std::string name = "::" + names[pending[i]];
+        Candidates& c = candidates[i];
+
+        finder.addMatcher(
+          clang::ast_matchers::cxxRecordDecl(
+            clang::ast_matchers::hasName(name))
+            .bind("id"),
+          new HandleMatch(
+            [&c](
+              const clang::ast_matchers::MatchFinder::MatchResult& Result) {
+              auto* decl = Result.Nodes.getNodeAs<clang::CXXRecordDecl>("id")
+                             ->getDefinition();
+              if (decl)
+              {
+                c.foundClass = decl;
+              }
+            }));
+        finder.addMatcher(
+          clang::ast_matchers::classTemplateDecl(
+            clang::ast_matchers::hasName(name))
+            .bind("id"),
+          new HandleMatch(
+            [&c](
+              const clang::ast_matchers::MatchFinder::MatchResult& Result) {
+              auto* decl =
+                Result.Nodes.getNodeAs<clang::ClassTemplateDecl>("id");
+              if (decl)
+              {
+                c.foundTemplateClass = decl;
+              }
+            }));
+        finder.addMatcher(
+          clang::ast_matchers::enumDecl(clang::ast_matchers::hasName(name))
+            .bind("id"),
+          new HandleMatch(
+            [&c](
+              const clang::ast_matchers::MatchFinder::MatchResult& Result) {
+              auto* decl = Result.Nodes.getNodeAs<clang::EnumDecl>("id");
+              if (decl)
+              {
+                c.foundEnum = decl;
+              }
+            }));
       }
+      finder.matchAST(*ast);
 
-      // If didn't match any type, check for builtins
-      return llvm::StringSwitch<CXXType>(name)
-        .Case("::bool", CXXType::getBoolean())
-        .Case("::unsigned char", CXXType::getUnsignedChar())
-        .Case("::char", CXXType::getChar())
-        .Case("::signed char", CXXType::getSignedChar())
-        .Case("::short", CXXType::getShort())
-        .Case("::unsigned short", CXXType::getUnsignedShort())
-        .Case("::int", CXXType::getInt())
-        .Case("::unsigned int", CXXType::getUnsignedInt())
-        .Case("::long", CXXType::getLong())
-        .Case("::unsigned long", CXXType::getUnsignedLong())
-        .Case("::long long", CXXType::getLongLong())
-        .Case("::unsigned long long", CXXType::getUnsignedLongLong())
-        .Case("::float", CXXType::getFloat())
-        .Case("::double", CXXType::getDouble())
-        // Otherwise, just return empty invalid type
-        .Default(CXXType());
+      for (size_t i = 0; i < pending.size(); i++)
+      {
+        const Candidates& c = candidates[i];
+        std::string name = "::" + names[pending[i]];
+
+        // Should only match one, so this is fine.
+        CXXType ty;
+        if (c.foundTemplateClass)
+        {
+          ty = CXXType(c.foundTemplateClass);
+        }
+        else if (c.foundClass)
+        {
+          ty = CXXType(c.foundClass);
+        }
+        else if (c.foundEnum)
+        {
+          ty = CXXType(c.foundEnum);
+        }
+        else
+        {
+          // If didn't match any type, check for builtins
+          ty = builtinType(name);
+        }
+
+        results[pending[i]] = ty;
+        typeCache.emplace(std::move(name), ty);
+      }
+
+      return results;
     }
 
     /// Return the size in bytes of the specified type.
@@ -448,45 +834,12 @@ namespace verona::interop
     CXXType instantiateClassTemplate(
       CXXType& classTemplate, llvm::ArrayRef<clang::TemplateArgument> args)
     {
-      if (classTemplate.kind != CXXType::Kind::TemplateClass)
+      auto* Decl = declareClassTemplateSpecialization(classTemplate, args);
+      if (!Decl)
       {
         return CXXType{};
       }
 
-      auto& S = Clang->getSema();
-
-      // Check if this specialisation is already present in the AST
-      // (declaration, definition, used).
-      clang::ClassTemplateDecl* ClassTemplate =
-        classTemplate.getAs<clang::ClassTemplateDecl>();
-      void* InsertPos = nullptr;
-      clang::ClassTemplateSpecializationDecl* Decl =
-        ClassTemplate->findSpecialization(args, InsertPos);
-      if (!Decl)
-      {
-        // This is the first time we have referenced this class template
-        // specialization. Create the canonical declaration and add it to
-        // the set of specializations.
-        Decl = clang::ClassTemplateSpecializationDecl::Create(
-          *ast,
-          ClassTemplate->getTemplatedDecl()->getTagKind(),
-          ClassTemplate->getDeclContext(),
-          ClassTemplate->getTemplatedDecl()->getBeginLoc(),
-          ClassTemplate->getLocation(),
-          ClassTemplate,
-          args,
-          nullptr);
-        ClassTemplate->AddSpecialization(Decl, InsertPos);
-      }
-      // If specialisation hasn't been directly declared yet (by the user),
-      // instantiate the declaration.
-      if (Decl->getSpecializationKind() == clang::TSK_Undeclared)
-      {
-        clang::MultiLevelTemplateArgumentList TemplateArgLists;
-        TemplateArgLists.addOuterTemplateArguments(args);
-        S.InstantiateAttrsForDecl(
-          TemplateArgLists, ClassTemplate->getTemplatedDecl(), Decl);
-      }
       // If specialisation hasn't been defined yet, create its definition at the
       // end of the file.
       clang::ClassTemplateSpecializationDecl* Def =
@@ -494,6 +847,7 @@ namespace verona::interop
           Decl->getDefinition());
       if (!Def)
       {
+        auto& S = Clang->getSema();
         clang::SourceLocation InstantiationLoc = Clang->getEndOfFileLocation();
         assert(InstantiationLoc.isValid());
         S.InstantiateClassTemplateSpecialization(
@@ -504,6 +858,59 @@ namespace verona::interop
       return CXXType{Def};
     }
 
+    /**
+     * Queue a class template specialisation for instantiation. The returned
+     * type is declared but has no definition until instantiateQueued runs;
+     * don't ask for its size or emit code against it before then.
+     *
+     * Bindings that need many specialisations (eg. hundreds of containers)
+     * should queue them all and instantiate once, instead of paying a full
+     * Sema pass per specialisation through instantiateClassTemplate.
+     */
+    CXXType queueClassTemplate(
+      CXXType& classTemplate, llvm::ArrayRef<clang::TemplateArgument> args)
+    {
+      auto* Decl = declareClassTemplateSpecialization(classTemplate, args);
+      if (!Decl)
+      {
+        return CXXType{};
+      }
+      if (!Decl->getDefinition())
+      {
+        pendingSpecializations.push_back(Decl);
+      }
+      return CXXType{Decl};
+    }
+
+    /**
+     * Instantiate the definitions of all queued specialisations at the end
+     * of the main file, then flush the member instantiations they triggered
+     * in one Sema pass. A subsequent emitLLVM produces a single module
+     * covering the whole batch.
+     */
+    void instantiateQueued()
+    {
+      auto& S = Clang->getSema();
+      for (auto* Decl : pendingSpecializations)
+      {
+        // The same specialisation may appear twice in a batch, or have
+        // been defined by instantiateClassTemplate in the meantime.
+        if (Decl->getDefinition())
+        {
+          continue;
+        }
+        clang::SourceLocation InstantiationLoc = Clang->getEndOfFileLocation();
+        assert(InstantiationLoc.isValid());
+        S.InstantiateClassTemplateSpecialization(
+          InstantiationLoc, Decl, clang::TSK_ExplicitInstantiationDefinition);
+      }
+      pendingSpecializations.clear();
+
+      // Members (methods, nested types) are instantiated lazily; perform
+      // them all now so the batch is complete before code generation.
+      S.PerformPendingInstantiations();
+    }
+
     /**
      * Get the template especialization with args.
      */
@@ -0,0 +1,145 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "CXXInterface.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace verona::interop
+{
+  /**
+   * Pool of preconstructed CXXInterface sessions over one header set.
+   *
+   * Clang's Sema and ASTContext are not thread-safe, so a session must
+   * only be used by one thread at a time; the pool hands out exclusive
+   * checkouts and blocks once every session is in use. All sessions are
+   * configured identically and share the on-disk PCH cache, so only the
+   * first construction of each pays header parsing: a binding server
+   * running concurrent getType / instantiateClassTemplate sessions skips
+   * the CompilerInstance setup on every checkout after the first, and a
+   * returned session keeps its warmed query cache (see
+   * CXXInterface::getTypes) for the next user.
+   *
+   * Sessions are constructed lazily, up to `capacity`, so a lightly
+   * loaded server only ever builds one.
+   */
+  class InterfacePool
+  {
+  public:
+    InterfacePool(
+      std::string headerFile,
+      std::vector<std::string> includePath,
+      SourceLanguage sourceLang = SourceLanguage::CXX,
+      std::string pchCachePath = "",
+      size_t capacity = std::thread::hardware_concurrency())
+    : headerFile_(std::move(headerFile)),
+      includePath_(std::move(includePath)),
+      sourceLang_(sourceLang),
+      pchCachePath_(std::move(pchCachePath)),
+      capacity_(std::max<size_t>(capacity, 1))
+    {}
+
+    /**
+     * Exclusive use of one pooled session; returns it to the pool on
+     * destruction. Move-only, and must not outlive the pool.
+     */
+    class Session
+    {
+    public:
+      Session(Session&& other)
+      : pool_(std::exchange(other.pool_, nullptr)),
+        interface_(std::move(other.interface_))
+      {}
+
+      Session(const Session&) = delete;
+      Session& operator=(const Session&) = delete;
+      Session& operator=(Session&&) = delete;
+
+      ~Session()
+      {
+        if (pool_)
+          pool_->checkin(std::move(interface_));
+      }
+
+      CXXInterface& operator*()
+      {
+        return *interface_;
+      }
+
+      CXXInterface* operator->()
+      {
+        return interface_.get();
+      }
+
+    private:
+      friend class InterfacePool;
+
+      Session(InterfacePool* pool, std::unique_ptr<CXXInterface> interface)
+      : pool_(pool), interface_(std::move(interface))
+      {}
+
+      InterfacePool* pool_;
+      std::unique_ptr<CXXInterface> interface_;
+    };
+
+    /**
+     * Check a session out, constructing one if the pool has not reached
+     * capacity yet, and blocking until one is returned otherwise.
+     */
+    Session checkout()
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+
+      while (idle_.empty())
+      {
+        if (live_ < capacity_)
+        {
+          // Construction is the expensive part; do it unlocked so other
+          // sessions can be checked out and in meanwhile.
+          live_++;
+          lock.unlock();
+          return Session(
+            this,
+            std::make_unique<CXXInterface>(
+              headerFile_, includePath_, sourceLang_, pchCachePath_));
+        }
+
+        available_.wait(lock);
+      }
+
+      Session session(this, std::move(idle_.back()));
+      idle_.pop_back();
+      return session;
+    }
+
+  private:
+    void checkin(std::unique_ptr<CXXInterface> interface)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back(std::move(interface));
+      }
+      available_.notify_one();
+    }
+
+    const std::string headerFile_;
+    const std::vector<std::string> includePath_;
+    const SourceLanguage sourceLang_;
+    const std::string pchCachePath_;
+    const size_t capacity_;
+
+    std::mutex mutex_;
+    std::condition_variable available_;
+    /// Sessions waiting for a user.
+    std::vector<std::unique_ptr<CXXInterface>> idle_;
+    /// Sessions constructed so far, idle or checked out.
+    size_t live_ = 0;
+  };
+}
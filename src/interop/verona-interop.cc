@@ -2,10 +2,13 @@
 // SPDX-License-Identifier: MIT
 
 #include "CXXInterface.h"
+#include "InterfacePool.h"
 
+#include <atomic>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <thread>
 
 using namespace std;
 using namespace verona::interop;
@@ -48,6 +51,20 @@ namespace
     cl::CommaSeparated,
     cl::value_desc("specialization"));
 
+  cl::opt<string> pchCachePath(
+    "pch-cache",
+    cl::desc("Directory caching pre-compiled headers between runs"),
+    cl::Optional,
+    cl::init(""),
+    cl::value_desc("directory"));
+
+  cl::opt<unsigned> poolSessions(
+    "pool-sessions",
+    cl::desc("Query the symbol from this many concurrent pooled sessions"),
+    cl::Optional,
+    cl::init(0),
+    cl::value_desc("count"));
+
   /// Prints a type to stdout
   void printType(CXXType& ty)
   {
@@ -81,7 +98,18 @@ namespace
   vector<TemplateArgument>
   create_template_args(CXXInterface& interface, llvm::ArrayRef<string> args)
   {
+    // Batch-resolve the type names, so the whole list shares one AST
+    // traversal at most (see CXXInterface::getTypes).
+    vector<string> typeNames;
+    for (auto arg : args)
+    {
+      if (!isdigit(arg[0]))
+        typeNames.push_back(arg);
+    }
+    auto types = interface.getTypes(typeNames);
+
     vector<TemplateArgument> templateArgs;
+    size_t nextType = 0;
     for (auto arg : args)
     {
       if (isdigit(arg[0]))
@@ -93,8 +121,8 @@ namespace
       }
       else
       {
-        // Try to find the type name
-        auto decl = interface.getType(arg);
+        // Use the resolved type name
+        auto decl = types[nextType++];
         if (!decl.valid())
         {
           cerr << "Invalid template specialization type " << arg.c_str()
@@ -207,8 +235,35 @@ int main(int argc, char** argv)
   vector<string> includePath;
   parseCommandLine(argc, argv, includePath);
 
+  // Query the symbol from concurrent sessions checked out of a shared
+  // pool (see InterfacePool), before the single-interface flow below.
+  if (poolSessions > 1 && !symbol.empty())
+  {
+    InterfacePool pool(
+      inputFile, includePath, SourceLanguage::CXX, pchCachePath, poolSessions);
+
+    atomic<unsigned> found{0};
+    vector<thread> threads;
+    for (unsigned i = 0; i < poolSessions; i++)
+    {
+      threads.emplace_back([&]() {
+        auto session = pool.checkout();
+        if (session->getType(symbol).valid())
+          found++;
+      });
+    }
+    for (auto& t : threads)
+    {
+      t.join();
+    }
+
+    cout << "Pooled sessions found symbol " << found << "/" << poolSessions
+         << " times" << endl;
+  }
+
   // Create the C++ interface
-  CXXInterface interface(inputFile, includePath);
+  CXXInterface interface(
+    inputFile, includePath, SourceLanguage::CXX, pchCachePath);
 
   // Test function creation
   if (testFunction)
@@ -63,6 +63,40 @@ namespace verona::bytecode
     return out;
   }
 
+  std::ostream& operator<<(std::ostream& out, const StringOperator& self)
+  {
+    switch (self)
+    {
+      case StringOperator::Eq:
+        fmt::print(out, "STR_EQ");
+        break;
+      case StringOperator::Ne:
+        fmt::print(out, "STR_NE");
+        break;
+      case StringOperator::Lt:
+        fmt::print(out, "STR_LT");
+        break;
+      case StringOperator::Le:
+        fmt::print(out, "STR_LE");
+        break;
+      case StringOperator::Gt:
+        fmt::print(out, "STR_GT");
+        break;
+      case StringOperator::Ge:
+        fmt::print(out, "STR_GE");
+        break;
+      case StringOperator::Find:
+        fmt::print(out, "STR_FIND");
+        break;
+      case StringOperator::Hash:
+        fmt::print(out, "STR_HASH");
+        break;
+
+        EXHAUSTIVE_SWITCH;
+    }
+    return out;
+  }
+
   std::ostream& operator<<(std::ostream& out, const Capability& self)
   {
     switch (self)
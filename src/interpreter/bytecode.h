@@ -2,10 +2,13 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include "interpreter/dispatch_order.h"
+
 #include <cstdint>
 #include <cstdlib>
 #include <fmt/format.h>
 #include <limits>
+#include <optional>
 #include <ostream>
 #include <string_view>
 #include <vector>
@@ -31,6 +34,10 @@
  * - 32-bit number of methods
  * - 32-bit number of subtypes
  * - 32-bit offset to finaliser
+ * - 32-bit descriptor flags (bit 0 marks the builtin Array class, whose
+ *   instances carry contiguous element storage instead of named fields;
+ *   bit 1 marks the builtin Map class, whose instances carry a hash
+ *   table)
  * - For each field, 32-bit selector index
  * - For each method, 32-bit selector index and 32-bit absolute offset
  * - For each subtype, 32-bit descriptor index.
@@ -107,6 +114,18 @@
  * which is indexed using the selector index passed to the opcode as an
  * immediate operand.
  *
+ * The CallDirect opcode sets up its frame exactly like Call, but carries the
+ * callee's code offset as an immediate instead of a selector: no vtable is
+ * consulted. The compiler emits it when reachability proves a call site has
+ * exactly one possible receiver class. The receiver value is still passed in
+ * the first argument register, it just takes no part in dispatch.
+ *
+ * The TailCall opcode has the same operands and dispatch as Call, but reuses
+ * the current frame instead of stacking a new one: the arguments are moved
+ * from the top of the frame down to its base, and the callee returns directly
+ * to the current frame's caller. It is emitted when a call's result is
+ * immediately returned, so self-recursive methods run in constant stack space.
+ *
  * # When opcode
  *
  * Using the When opcode requires setting up the frame in the exact same way as
@@ -270,8 +289,17 @@ namespace verona::bytecode
 
   enum class Opcode : uint8_t
   {
+    ArrayCompare, // dst(u8), lhs(u8), lhs_index(u8), rhs(u8), rhs_index(u8),
+                  //   count(u8)
+    ArrayCopy, // dst_base(u8), dst_index(u8), src_base(u8), src_index(u8),
+               //   count(u8)
+    ArrayFill, // base(u8), index(u8), count(u8), src(u8)
+    ArrayLength, // dst(u8), base(u8)
+    ArrayLoad, // dst(u8), base(u8), index(u8)
+    ArrayStore, // dst(u8), base(u8), index(u8), src(u8)
     BinOp, // op(u8), src1(u8), src2(u8)
     Call, // selector(u32), callspace(u8)
+    CallDirect, // target(u32), callspace(u8)
     Clear, // dst(u8)
     ClearList, // argc(u8), dst(u8)...
     Copy, // dst(u8), src(u8)
@@ -279,15 +307,23 @@ namespace verona::bytecode
     Freeze, // dst(u8), src(u8)
     Int64, // dst(u8), immediate(u64)
     String, // dst(u8), immediate(str)
+    StringOp, // dst(u8), op(u8), src1(u8), src2(u8)
     Jump, // target(u16)
     JumpIf, // src(u8), target(u16)
     Load, // dst(u8), base(u8), selector(u32)
     LoadDescriptor, // dst(u8), descriptor_id(u32)
+    MapContains, // dst(u8), map(u8), key(u8)
+    MapGet, // dst(u8), map(u8), key(u8)
+    MapInsert, // dst(u8), map(u8), key(u8), value(u8)
+    MapRemove, // dst(u8), map(u8), key(u8)
+    MapSize, // dst(u8), map(u8)
     MatchCapability, // dst(u8), src(u8), cap(u8)
     MatchDescriptor, // dst(u8), src(u8), descriptor(u8)
     Merge, // into(u8), src(u8)
     Move, // dst(u8), src(u8)
     MutView, // dst(u8), src(u8)
+    NewArray, // dst(u8), region(u8), descriptor(u8), length(u8)
+    NewMap, // dst(u8), region(u8), descriptor(u8)
     NewObject, // dst(u8), region(u8), descriptor(u8)
     NewCown, // dst(u8), descriptor(u8), src(u8)
     NewRegion, // dst(u8), descriptor(u8)
@@ -296,14 +332,59 @@ namespace verona::bytecode
     Protect, // argc(u8), args(u8)...
     Return,
     Store, // dst(u8), base(u8), selector(u32), src(u8)
+    TailCall, // selector(u32), callspace(u8)
     TraceRegion, // region(u8)
     Unprotect, // argc(u8), args(u8)...
     Unreachable,
     When, // codepointer(u32), cown count(u8), capture count(u8)
+    Yield,
+
+    // Fused superinstructions, produced by the code generator's peephole
+    // for frequently adjacent pairs. A fused opcode's operands are the
+    // concatenation of its two components' operands, and executing it is
+    // exactly equivalent to executing the pair: both destinations are
+    // written. The compiler never emits these directly; see
+    // Generator::emit.
+    Int64BinOp, // dst(u8), immediate(u64), dst(u8), op(u8), src1(u8), src2(u8)
+    LoadBinOp, // dst(u8), base(u8), selector(u32),
+               //   dst(u8), op(u8), src1(u8), src2(u8)
+    CopyJump, // dst(u8), src(u8), target(u16)
 
-    maximum_value = When,
+    maximum_value = CopyJump,
   };
 
+  /**
+   * Map a pair of adjacent opcodes to their fused superinstruction, if one
+   * exists.
+   *
+   * Because fused opcodes preserve the exact semantics of their pair,
+   * including the first instruction's register write, the code generator
+   * may fuse any adjacent occurrence without liveness information, as long
+   * as no jump targets the second instruction.
+   *
+   * Which fusions are emitted is selected by the profile-guided VM_FUSE_*
+   * switches (see dispatch_order.h); the VM always retains every fused
+   * handler, so a disabled fusion only stops new bytecode using it.
+   */
+  constexpr std::optional<Opcode> fused_opcode(Opcode first, Opcode second)
+  {
+#if VM_FUSE_INT64_BINOP
+    if (first == Opcode::Int64 && second == Opcode::BinOp)
+      return Opcode::Int64BinOp;
+#endif
+#if VM_FUSE_LOAD_BINOP
+    if (first == Opcode::Load && second == Opcode::BinOp)
+      return Opcode::LoadBinOp;
+#endif
+#if VM_FUSE_COPY_JUMP
+    if (first == Opcode::Copy && second == Opcode::Jump)
+      return Opcode::CopyJump;
+#endif
+    (void)first;
+    (void)second;
+    return std::nullopt;
+  }
+
   enum class BinaryOperator : uint8_t
   {
     Add,
@@ -325,6 +406,26 @@ namespace verona::bytecode
     maximum_value = Or,
   };
 
+  /**
+   * Operations of the StringOp opcode. Comparisons are lexicographic on
+   * the string's bytes and produce 0 or 1. Find produces the index of the
+   * first occurrence of the second operand, or the receiver's length when
+   * there is none. Hash ignores its second operand.
+   */
+  enum class StringOperator : uint8_t
+  {
+    Eq,
+    Ne,
+    Lt,
+    Le,
+    Gt,
+    Ge,
+    Find,
+    Hash,
+
+    maximum_value = Hash,
+  };
+
   enum class Capability : uint8_t
   {
     Iso,
@@ -351,6 +452,57 @@ namespace verona::bytecode
   template<Opcode opcode>
   struct OpcodeSpec;
 
+  template<>
+  struct OpcodeSpec<Opcode::ArrayCompare>
+  {
+    using Operands = OpcodeOperands<
+      Register,
+      Register,
+      Register,
+      Register,
+      Register,
+      Register>;
+    constexpr static std::string_view format =
+      "ARRAY_COMPARE {}, {}[{}], {}[{}], {}";
+  };
+
+  template<>
+  struct OpcodeSpec<Opcode::ArrayCopy>
+  {
+    using Operands =
+      OpcodeOperands<Register, Register, Register, Register, Register>;
+    constexpr static std::string_view format =
+      "ARRAY_COPY {}[{}], {}[{}], {}";
+  };
+
+  template<>
+  struct OpcodeSpec<Opcode::ArrayFill>
+  {
+    using Operands = OpcodeOperands<Register, Register, Register, Register>;
+    constexpr static std::string_view format = "ARRAY_FILL {}[{}], {}, {}";
+  };
+
+  template<>
+  struct OpcodeSpec<Opcode::ArrayLength>
+  {
+    using Operands = OpcodeOperands<Register, Register>;
+    constexpr static std::string_view format = "ARRAY_LENGTH {}, {}";
+  };
+
+  template<>
+  struct OpcodeSpec<Opcode::ArrayLoad>
+  {
+    using Operands = OpcodeOperands<Register, Register, Register>;
+    constexpr static std::string_view format = "ARRAY_LOAD {}, {}[{}]";
+  };
+
+  template<>
+  struct OpcodeSpec<Opcode::ArrayStore>
+  {
+    using Operands = OpcodeOperands<Register, Register, Register, Register>;
+    constexpr static std::string_view format = "ARRAY_STORE {}, {}[{}], {}";
+  };
+
   template<>
   struct OpcodeSpec<Opcode::BinOp>
   {
@@ -366,6 +518,13 @@ namespace verona::bytecode
     constexpr static std::string_view format = "CALL {}, {:#x}";
   };
 
+  template<>
+  struct OpcodeSpec<Opcode::CallDirect>
+  {
+    using Operands = OpcodeOperands<AbsoluteOffset, uint8_t>;
+    constexpr static std::string_view format = "CALL_DIRECT {:#x}, {:#x}";
+  };
+
   template<>
   struct OpcodeSpec<Opcode::Clear>
   {
@@ -436,6 +595,41 @@ namespace verona::bytecode
     constexpr static std::string_view format = "LOAD_DESCRIPTOR {}, {:#x}";
   };
 
+  template<>
+  struct OpcodeSpec<Opcode::MapContains>
+  {
+    using Operands = OpcodeOperands<Register, Register, Register>;
+    constexpr static std::string_view format = "MAP_CONTAINS {}, {}[{}]";
+  };
+
+  template<>
+  struct OpcodeSpec<Opcode::MapGet>
+  {
+    using Operands = OpcodeOperands<Register, Register, Register>;
+    constexpr static std::string_view format = "MAP_GET {}, {}[{}]";
+  };
+
+  template<>
+  struct OpcodeSpec<Opcode::MapInsert>
+  {
+    using Operands = OpcodeOperands<Register, Register, Register, Register>;
+    constexpr static std::string_view format = "MAP_INSERT {}, {}[{}], {}";
+  };
+
+  template<>
+  struct OpcodeSpec<Opcode::MapRemove>
+  {
+    using Operands = OpcodeOperands<Register, Register, Register>;
+    constexpr static std::string_view format = "MAP_REMOVE {}, {}[{}]";
+  };
+
+  template<>
+  struct OpcodeSpec<Opcode::MapSize>
+  {
+    using Operands = OpcodeOperands<Register, Register>;
+    constexpr static std::string_view format = "MAP_SIZE {}, {}";
+  };
+
   template<>
   struct OpcodeSpec<Opcode::MatchCapability>
   {
@@ -464,6 +658,20 @@ namespace verona::bytecode
     constexpr static std::string_view format = "MUT-VIEW {}, {}";
   };
 
+  template<>
+  struct OpcodeSpec<Opcode::NewArray>
+  {
+    using Operands = OpcodeOperands<Register, Register, Register, Register>;
+    constexpr static std::string_view format = "NEW_ARRAY {}, {}, {}, {}";
+  };
+
+  template<>
+  struct OpcodeSpec<Opcode::NewMap>
+  {
+    using Operands = OpcodeOperands<Register, Register, Register>;
+    constexpr static std::string_view format = "NEW_MAP {}, {}, {}";
+  };
+
   template<>
   struct OpcodeSpec<Opcode::NewObject>
   {
@@ -527,6 +735,21 @@ namespace verona::bytecode
     constexpr static std::string_view format = "STRING {}, \"{}\"";
   };
 
+  template<>
+  struct OpcodeSpec<Opcode::StringOp>
+  {
+    using Operands =
+      OpcodeOperands<Register, StringOperator, Register, Register>;
+    constexpr static std::string_view format = "{1} {0}, {2}, {3}";
+  };
+
+  template<>
+  struct OpcodeSpec<Opcode::TailCall>
+  {
+    using Operands = OpcodeOperands<SelectorIdx, uint8_t>;
+    constexpr static std::string_view format = "TAIL_CALL {}, {:#x}";
+  };
+
   template<>
   struct OpcodeSpec<Opcode::TraceRegion>
   {
@@ -541,6 +764,13 @@ namespace verona::bytecode
     constexpr static std::string_view format = "WHEN {}, {:#x}, {:#x}";
   };
 
+  template<>
+  struct OpcodeSpec<Opcode::Yield>
+  {
+    using Operands = OpcodeOperands<>;
+    constexpr static std::string_view format = "YIELD";
+  };
+
   template<>
   struct OpcodeSpec<Opcode::Unprotect>
   {
@@ -555,7 +785,44 @@ namespace verona::bytecode
     constexpr static std::string_view format = "UNREACHABLE";
   };
 
+  template<>
+  struct OpcodeSpec<Opcode::Int64BinOp>
+  {
+    using Operands = OpcodeOperands<
+      Register,
+      uint64_t,
+      Register,
+      BinaryOperator,
+      Register,
+      Register>;
+    constexpr static std::string_view format =
+      "INT64 {0}, {1:#x}; {3} {2}, {4}, {5}";
+  };
+
+  template<>
+  struct OpcodeSpec<Opcode::LoadBinOp>
+  {
+    using Operands = OpcodeOperands<
+      Register,
+      Register,
+      SelectorIdx,
+      Register,
+      BinaryOperator,
+      Register,
+      Register>;
+    constexpr static std::string_view format =
+      "LOAD {0}, {1}[{2:#x}]; {4} {3}, {5}, {6}";
+  };
+
+  template<>
+  struct OpcodeSpec<Opcode::CopyJump>
+  {
+    using Operands = OpcodeOperands<Register, Register, RelativeOffset>;
+    constexpr static std::string_view format = "COPY {0}, {1}; JUMP {2:+#x}";
+  };
+
   std::ostream& operator<<(std::ostream& out, const BinaryOperator& self);
+  std::ostream& operator<<(std::ostream& out, const StringOperator& self);
   std::ostream& operator<<(std::ostream& out, const Capability& self);
 
   template<typename T>
@@ -7,6 +7,7 @@
 
 #include <fmt/ostream.h>
 #include <optional>
+#include <unordered_map>
 #include <verona.h>
 
 namespace verona::interpreter
@@ -29,12 +30,64 @@ namespace verona::interpreter
     const VMDescriptor* string;
   };
 
+  /**
+   * A format string preprocessed into a segment list at load time.
+   *
+   * Each segment is a run of literal characters followed by an optional
+   * argument slot, so printing is buffer copies plus per-argument
+   * formatting, with no parsing of the format string at run time. Only
+   * the specs the Print opcode uses are recognised: "{}", the deep spec
+   * "{:#}" (see format.h) and the "{{" / "}}" escapes. A format using
+   * anything else is marked not `fast` and printed through fmt's own
+   * parser instead.
+   */
+  struct PrintFormat
+  {
+    static constexpr size_t NO_ARG = SIZE_MAX;
+
+    struct Segment
+    {
+      /**
+       * Literal run preceding the argument. Views the program's bytes,
+       * which outlive the Code.
+       */
+      std::string_view literal;
+
+      /// Index of the argument printed after the literal, or NO_ARG.
+      size_t arg = NO_ARG;
+
+      /// Use deep formatting ("{:#}") for the argument.
+      bool deep = false;
+    };
+
+    std::vector<Segment> segments;
+
+    /// Number of argument slots in the format.
+    size_t arg_count = 0;
+
+    /// False when the format uses specs the segment list cannot
+    /// represent; the printer falls back to parsing it with fmt.
+    bool fast = false;
+  };
+
+  /**
+   * A loaded program: the bytes plus everything decoded from them.
+   *
+   * One Code is the program's shared immutable segment: descriptors
+   * (with their selector tables and match bits), pre-decoded function
+   * headers and interned string atoms are built once here, before any
+   * scheduler thread starts, and every per-thread VM reads them through
+   * a const reference. Nothing in a Code changes after construction, so
+   * all of it is shared read-only across threads; anything a VM mutates
+   * while running (register stacks, inline caches, counters) lives in
+   * the VM itself.
+   */
   class Code
   {
   public:
     void check(size_t ip, size_t len) const
     {
-      if ((ip + len) > data_.size())
+      if ((ip + len) > size_)
       {
         std::stringstream s;
         s << "Instruction overflow " << ip << " " << len;
@@ -48,11 +101,27 @@ namespace verona::interpreter
       return load_helper<T>::load(*this, ip);
     }
 
+    /**
+     * Like `load`, but without the bounds and range checks, which are
+     * debug assertions only.
+     *
+     * Must only be used on instruction streams proven valid by the
+     * verifier, ie. by the VM's dispatch path.
+     */
+    template<typename T>
+    T load_unchecked(size_t& ip) const
+    {
+      return load_helper<T>::load_unchecked(*this, ip);
+    }
+
     /**
      * Load all operands of an opcode as a tuple.
      *
      * The return value is a tuple whose elements match the Operands specified
      * in this opcode's OpcodeSpec.
+     *
+     * This is the VM's dispatch path: it decodes unchecked, relying on the
+     * verification performed when the Code was constructed.
      */
     template<Opcode opcode>
     auto load_operands(size_t& ip) const
@@ -71,7 +140,7 @@ namespace verona::interpreter
     std::tuple<Args...>
     load_operands_inner(bytecode::OpcodeOperands<Args...>, size_t& ip) const
     {
-      return {load<Args>(ip)...};
+      return {load_unchecked<Args>(ip)...};
     }
 
     uint8_t u8(size_t& ip) const
@@ -120,27 +189,56 @@ namespace verona::interpreter
       return header;
     }
 
-    Code(std::vector<uint8_t> code) : data_(std::move(code))
+    /**
+     * Decoded header of a function, together with the offset of its first
+     * instruction.
+     */
+    struct FunctionInfo
     {
-      size_t ip = 0;
+      FunctionHeader header;
+      size_t body;
+    };
 
-      check_verona_nums(ip);
+    /**
+     * Look up the pre-decoded information for the function whose header
+     * starts at `offset`.
+     *
+     * The table is populated by the verifier, which decodes every
+     * reachable function exactly once, so any function the VM can enter
+     * is guaranteed to be present. This lets calls enter the callee
+     * without re-parsing its header.
+     */
+    const FunctionInfo& function_info(size_t offset) const
+    {
+      auto it = functions_.find(offset);
+      assert(it != functions_.end());
+      return it->second;
+    }
 
-      uint32_t descriptors_count = u32(ip);
-      for (uint32_t i = 0; i < descriptors_count; i++)
-      {
-        descriptors_.push_back(load_descriptor(DescriptorIdx(i), ip));
-      }
+    /**
+     * Load a program from an owned buffer of bytes.
+     */
+    Code(std::vector<uint8_t> code)
+    {
+      auto owned = std::make_shared<std::vector<uint8_t>>(std::move(code));
+      data_ = owned->data();
+      size_ = owned->size();
+      backing_ = std::shared_ptr<const uint8_t>(std::move(owned), data_);
+      load_program();
+    }
 
-      special_descriptors_.main = get_descriptor(load<DescriptorIdx>(ip));
-      special_descriptors_.main_selector = load<SelectorIdx>(ip);
-      special_descriptors_.u64 =
-        get_optional_descriptor(load<DescriptorIdx>(ip));
-      special_descriptors_.string =
-        get_optional_descriptor(load<DescriptorIdx>(ip));
+    /**
+     * Load a program from externally managed read-only memory, eg. a
+     * file mapping. `data`'s deleter releases the backing when the Code
+     * is destroyed; the bytes must stay valid and unchanged until then.
+     */
+    Code(std::shared_ptr<const uint8_t> data, size_t size)
+    : backing_(std::move(data)), data_(backing_.get()), size_(size)
+    {
+      load_program();
     }
 
-    const std::vector<std::unique_ptr<const VMDescriptor>>& descriptors()
+    const std::vector<std::unique_ptr<const VMDescriptor>>& descriptors() const
     {
       return descriptors_;
     }
@@ -153,7 +251,7 @@ namespace verona::interpreter
     size_t entrypoint() const
     {
       SelectorIdx selector = special_descriptors_.main_selector;
-      return special_descriptors_.main->methods[selector.value];
+      return special_descriptors_.main->methods.get(selector);
     }
 
     const VMDescriptor* get_descriptor(DescriptorIdx desc) const
@@ -175,12 +273,219 @@ namespace verona::interpreter
         return get_descriptor(desc);
     }
 
+    /**
+     * Find the interned atom for a string literal operand.
+     *
+     * `literal` must point into the program's bytes; every literal
+     * operand was interned by the verifier when the program was loaded,
+     * so the lookup cannot miss.
+     */
+    VMString* interned_string(std::string_view literal) const
+    {
+      auto it = interned_strings_.find(literal.data());
+      assert(it != interned_strings_.end());
+      return it->second;
+    }
+
+    /**
+     * Find the preprocessed segment list for a format string, or nullptr
+     * when the string is not a literal of this program (e.g. it was
+     * computed at run time) and must be parsed instead.
+     */
+    const PrintFormat* print_format(std::string_view fmt) const
+    {
+      auto it = print_formats_.find(fmt);
+      if (it == print_formats_.end())
+        return nullptr;
+      return &it->second;
+    }
+
+    Code(const Code&) = delete;
+    Code& operator=(const Code&) = delete;
+
+    ~Code()
+    {
+      for (const auto& [contents, atom] : atoms_)
+        VMString::release(atom);
+    }
+
   private:
-    const std::vector<uint8_t> data_;
+    /**
+     * Parse the program's descriptor tables and verify its bytecode.
+     */
+    void load_program()
+    {
+      size_t ip = 0;
+
+      check_verona_nums(ip);
+
+      uint32_t descriptors_count = u32(ip);
+      for (uint32_t i = 0; i < descriptors_count; i++)
+      {
+        descriptors_.push_back(
+          load_descriptor(DescriptorIdx(i), descriptors_count, ip));
+      }
+
+      special_descriptors_.main = get_descriptor(load<DescriptorIdx>(ip));
+      special_descriptors_.main_selector = load<SelectorIdx>(ip);
+      special_descriptors_.u64 =
+        get_optional_descriptor(load<DescriptorIdx>(ip));
+      special_descriptors_.string =
+        get_optional_descriptor(load<DescriptorIdx>(ip));
+
+      // Prove the whole program valid once, so dispatch can decode
+      // unchecked. Throws on malformed bytecode.
+      verify();
+    }
+
+    /**
+     * Keeps the program's bytes alive for the lifetime of the Code. The
+     * deleter releases whatever backs them: a heap buffer for the owning
+     * constructor, or a file mapping for the zero-copy loading path.
+     */
+    std::shared_ptr<const uint8_t> backing_;
+
+    /**
+     * The program's bytes. Points into backing_.
+     */
+    const uint8_t* data_;
+    size_t size_;
+
     std::vector<std::unique_ptr<const VMDescriptor>> descriptors_;
 
     SpecialDescriptors special_descriptors_;
 
+    /**
+     * Offsets of the function headers named by descriptors, ie. methods
+     * and finalisers. These seed the verifier's worklist; closures are
+     * found from the When instructions that reference them.
+     */
+    std::vector<size_t> function_entrypoints_;
+
+    /**
+     * Pre-decoded headers of every reachable function, keyed by the
+     * offset of the function's header. Filled in by the verifier.
+     */
+    std::unordered_map<size_t, FunctionInfo> functions_;
+
+    /**
+     * Interned atoms for string literals, filled in by the verifier.
+     *
+     * atoms_ dedupes literals by contents and owns one reference to each
+     * atom, released when the Code is destroyed. interned_strings_ maps
+     * each literal operand, keyed by its position in the program, to its
+     * atom for constant-time lookup at run time.
+     */
+    std::unordered_map<std::string_view, VMString*> atoms_;
+    std::unordered_map<const char*, VMString*> interned_strings_;
+
+    /**
+     * Segment lists for every string literal, keyed by contents like
+     * atoms_. Built when the literal is interned, so the Print opcode
+     * never parses a literal format at run time.
+     */
+    std::unordered_map<std::string_view, PrintFormat> print_formats_;
+
+    VMString* intern_string(std::string_view literal)
+    {
+      auto [it, inserted] = atoms_.try_emplace(literal, nullptr);
+      if (inserted)
+      {
+        it->second = new VMString(std::string(literal));
+        print_formats_.emplace(literal, preprocess_format(literal));
+      }
+      interned_strings_.emplace(literal.data(), it->second);
+      return it->second;
+    }
+
+    /**
+     * Split a format string into the segment list described on
+     * PrintFormat. The segments view `fmt`, so this must only be called
+     * on literals in the program's bytes.
+     */
+    static PrintFormat preprocess_format(std::string_view fmt)
+    {
+      PrintFormat pf;
+      pf.fast = true;
+
+      size_t lit_begin = 0;
+      size_t i = 0;
+      while (i < fmt.size())
+      {
+        char c = fmt[i];
+        if (c == '{')
+        {
+          if (i + 1 < fmt.size() && fmt[i + 1] == '{')
+          {
+            // Escaped brace: end the literal run after the first brace
+            // and restart it after the second, so the segments still
+            // view the original bytes.
+            pf.segments.push_back(
+              {fmt.substr(lit_begin, i + 1 - lit_begin)});
+            i += 2;
+            lit_begin = i;
+          }
+          else if (fmt.compare(i, 2, "{}") == 0)
+          {
+            pf.segments.push_back(
+              {fmt.substr(lit_begin, i - lit_begin), pf.arg_count++, false});
+            i += 2;
+            lit_begin = i;
+          }
+          else if (fmt.compare(i, 4, "{:#}") == 0)
+          {
+            pf.segments.push_back(
+              {fmt.substr(lit_begin, i - lit_begin), pf.arg_count++, true});
+            i += 4;
+            lit_begin = i;
+          }
+          else
+          {
+            // Positional index or some other spec: leave it to fmt.
+            pf.fast = false;
+            return pf;
+          }
+        }
+        else if (c == '}')
+        {
+          if (i + 1 < fmt.size() && fmt[i + 1] == '}')
+          {
+            pf.segments.push_back(
+              {fmt.substr(lit_begin, i + 1 - lit_begin)});
+            i += 2;
+            lit_begin = i;
+          }
+          else
+          {
+            // Stray closing brace; fmt reports the error.
+            pf.fast = false;
+            return pf;
+          }
+        }
+        else
+        {
+          i++;
+        }
+      }
+
+      if (lit_begin < fmt.size())
+        pf.segments.push_back({fmt.substr(lit_begin)});
+
+      return pf;
+    }
+
+    /**
+     * Verify the whole program: every operand of every reachable
+     * instruction decodes within its function body, register indices fit
+     * in their frame, jump targets are instruction starts and descriptor
+     * indices are valid. Defined in verifier.cc.
+     *
+     * Throws std::logic_error when the bytecode is malformed.
+     */
+    void verify();
+
+    friend class Verifier;
+
     void check_verona_nums(size_t& ip)
     {
       uint32_t nums = u32(ip);
@@ -191,7 +496,7 @@ namespace verona::interpreter
     }
 
     std::unique_ptr<VMDescriptor>
-    load_descriptor(DescriptorIdx index, size_t& ip)
+    load_descriptor(DescriptorIdx index, uint32_t descriptor_count, size_t& ip)
     {
       std::string_view name = str(ip);
       uint32_t method_slots = u32(ip);
@@ -200,29 +505,67 @@ namespace verona::interpreter
       uint32_t field_count = u32(ip);
       uint32_t subtype_count = u32(ip);
       uint32_t finaliser_ip = u32(ip);
+      uint32_t flags = u32(ip);
 
-      auto descriptor = std::make_unique<VMDescriptor>(
-        index, name, method_slots, field_slots, field_count, finaliser_ip);
+      if ((flags & ~3u) != 0)
+        throw std::logic_error("Unknown descriptor flags");
+
+      if ((flags & 3) == 3)
+        throw std::logic_error("Descriptor is both an array and a map");
+
+      if ((flags & 3) != 0 && (field_count != 0 || finaliser_ip != 0))
+        throw std::logic_error(
+          "Array or map descriptor with fields or finaliser");
+
+      if (finaliser_ip > 0)
+        function_entrypoints_.push_back(finaliser_ip);
 
+      auto descriptor = std::make_unique<VMDescriptor>(
+        index,
+        name,
+        field_count,
+        finaliser_ip,
+        (flags & 1) != 0,
+        (flags & 2) != 0);
+
+      std::vector<std::pair<uint32_t, uint32_t>> methods;
+      methods.reserve(method_count);
       for (uint32_t i = 0; i < method_count; i++)
       {
         SelectorIdx selector = load<SelectorIdx>(ip);
         uint32_t offset = u32(ip);
-        assert(selector.value < method_slots);
-        descriptor->methods[selector.value] = offset;
+        if (selector.value >= method_slots)
+          throw std::logic_error("Method selector out of bounds");
+        methods.emplace_back(selector.value, offset);
+        function_entrypoints_.push_back(offset);
       }
+      descriptor->methods.build(std::move(methods));
+
+      std::vector<std::pair<uint32_t, uint32_t>> fields;
+      fields.reserve(field_count);
       for (uint32_t i = 0; i < field_count; i++)
       {
         SelectorIdx selector = load<SelectorIdx>(ip);
-        assert(selector.value < field_slots);
-        descriptor->fields[selector.value] = i;
+        if (selector.value >= field_slots)
+          throw std::logic_error("Field selector out of bounds");
+        fields.emplace_back(selector.value, i);
       }
+      descriptor->fields.build(std::move(fields));
       for (uint32_t i = 0; i < subtype_count; i++)
       {
         DescriptorIdx subtype = load<DescriptorIdx>(ip);
+        if (subtype.value >= descriptor_count)
+          throw std::logic_error("Subtype index out of bounds");
         descriptor->subtypes.insert(subtype);
       }
 
+      // Expand the subtype set (made reflexive by the constructor) into
+      // one bit per descriptor in the program, so a pattern match tests
+      // a single bit rather than probing the set.
+      descriptor->match_bits.resize(descriptor_count);
+      for (DescriptorIdx subtype : descriptor->subtypes)
+        descriptor->match_bits[subtype.value] = true;
+
       return descriptor;
     }
 
@@ -244,6 +587,12 @@ namespace verona::interpreter
     static T load(const Code& code, size_t& ip)
     {
       code.check(ip, sizeof(T));
+      return load_unchecked(code, ip);
+    }
+
+    static T load_unchecked(const Code& code, size_t& ip)
+    {
+      assert((ip + sizeof(T)) <= code.size_);
       uint64_t bits = 0;
 
       for (size_t i = 0; i < (sizeof(T) * 8); i += 8)
@@ -271,6 +620,14 @@ namespace verona::interpreter
       }
       return static_cast<T>(value);
     };
+
+    static T load_unchecked(const Code& code, size_t& ip)
+    {
+      typedef std::underlying_type_t<T> wire_type;
+      wire_type value = code.load_unchecked<wire_type>(ip);
+      assert(value <= static_cast<wire_type>(T::maximum_value));
+      return static_cast<T>(value);
+    };
   };
 
   template<typename T>
@@ -280,6 +637,11 @@ namespace verona::interpreter
     {
       return T(code.load<typename T::underlying_type>(ip));
     }
+
+    static T load_unchecked(const Code& code, size_t& ip)
+    {
+      return T(code.load_unchecked<typename T::underlying_type>(ip));
+    }
   };
 
   template<>
@@ -293,6 +655,15 @@ namespace verona::interpreter
       ip += size;
       return s;
     }
+
+    static std::string_view load_unchecked(const Code& code, size_t& ip)
+    {
+      uint16_t size = code.load_unchecked<uint16_t>(ip);
+      assert((ip + size) <= code.size_);
+      std::string_view s(reinterpret_cast<const char*>(&code.data_[ip]), size);
+      ip += size;
+      return s;
+    }
   };
 
   template<>
@@ -307,5 +678,15 @@ namespace verona::interpreter
       ip += size;
       return bytecode::RegisterSpan(data, size);
     }
+
+    static bytecode::RegisterSpan load_unchecked(const Code& code, size_t& ip)
+    {
+      uint8_t size = code.load_unchecked<uint8_t>(ip);
+      assert((ip + size) <= code.size_);
+      const bytecode::Register* data =
+        reinterpret_cast<const bytecode::Register*>(&code.data_[ip]);
+      ip += size;
+      return bytecode::RegisterSpan(data, size);
+    }
   };
 }
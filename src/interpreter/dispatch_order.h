@@ -0,0 +1,94 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+/**
+ * Profile-guided layout of the interpreter's dispatch.
+ *
+ * VM_DISPATCH_OPS lists every opcode handler, and its order is the order
+ * the handler code is emitted by the threaded dispatch loop (see
+ * VM::dispatch_loop). That makes it the i-cache layout of the VM's hot
+ * code: handlers that frequently execute one after the other should sit
+ * next to each other in the list. Opcodes without a handler (currently
+ * Merge) are deliberately absent and fall through to the invalid-opcode
+ * path.
+ *
+ * The VM_FUSE_* switches select which superinstructions the code
+ * generator's peephole emits (see bytecode::fused_opcode). The VM always
+ * keeps the fused handlers, so bytecode produced with a different
+ * selection still runs.
+ *
+ * Both are regenerated from an opcode-pair frequency profile:
+ *
+ *   1. Build the `interpreter-profile` target and run the workload with
+ *      `--opcode-profile <file>`. The file contains one
+ *      `<first> <second> <count>` line per dynamically executed opcode
+ *      pair, using the enumerator names; `#` starts a comment.
+ *   2. Run the `interpreter-pgo-layout` build target (or
+ *      `reorder_dispatch.py` directly), which rewrites the list below by
+ *      pair affinity and enables the fusions whose component pairs are
+ *      hot. Rebuilding then picks the new layout up, as every dispatch
+ *      translation unit includes this header.
+ *
+ * The checked-in order is the default profile: declaration order of
+ * `bytecode::Opcode`, with every fusion enabled.
+ */
+
+// VM_DISPATCH_OPS_BEGIN (reorder_dispatch.py rewrites this block)
+#define VM_DISPATCH_OPS(OP) \
+  OP(ArrayCompare, opcode_array_compare) \
+  OP(ArrayCopy, opcode_array_copy) \
+  OP(ArrayFill, opcode_array_fill) \
+  OP(ArrayLength, opcode_array_length) \
+  OP(ArrayLoad, opcode_array_load) \
+  OP(ArrayStore, opcode_array_store) \
+  OP(BinOp, opcode_binop) \
+  OP(Call, opcode_call) \
+  OP(CallDirect, opcode_call_direct) \
+  OP(Clear, opcode_clear) \
+  OP(ClearList, opcode_clear_list) \
+  OP(Copy, opcode_copy) \
+  OP(FulfillSleepingCown, opcode_fulfill_sleeping_cown) \
+  OP(Freeze, opcode_freeze) \
+  OP(Int64, opcode_int64) \
+  OP(Jump, opcode_jump) \
+  OP(JumpIf, opcode_jump_if) \
+  OP(Yield, opcode_yield) \
+  OP(Load, opcode_load) \
+  OP(LoadDescriptor, opcode_load_descriptor) \
+  OP(MapContains, opcode_map_contains) \
+  OP(MapGet, opcode_map_get) \
+  OP(MapInsert, opcode_map_insert) \
+  OP(MapRemove, opcode_map_remove) \
+  OP(MapSize, opcode_map_size) \
+  OP(MatchCapability, opcode_match_capability) \
+  OP(MatchDescriptor, opcode_match_descriptor) \
+  OP(Move, opcode_move) \
+  OP(MutView, opcode_mut_view) \
+  OP(NewArray, opcode_new_array) \
+  OP(NewMap, opcode_new_map) \
+  OP(NewObject, opcode_new_object) \
+  OP(NewRegion, opcode_new_region) \
+  OP(NewSleepingCown, opcode_new_sleeping_cown) \
+  OP(NewCown, opcode_new_cown) \
+  OP(Print, opcode_print) \
+  OP(Protect, opcode_protect) \
+  OP(Return, opcode_return) \
+  OP(Store, opcode_store) \
+  OP(TailCall, opcode_tailcall) \
+  OP(String, opcode_string) \
+  OP(StringOp, opcode_string_op) \
+  OP(TraceRegion, opcode_trace_region) \
+  OP(When, opcode_when) \
+  OP(Unprotect, opcode_unprotect) \
+  OP(Unreachable, opcode_unreachable) \
+  OP(Int64BinOp, opcode_int64_binop) \
+  OP(LoadBinOp, opcode_load_binop) \
+  OP(CopyJump, opcode_copy_jump)
+// VM_DISPATCH_OPS_END
+
+// VM_FUSE_BEGIN (reorder_dispatch.py rewrites this block)
+#define VM_FUSE_INT64_BINOP 1
+#define VM_FUSE_LOAD_BINOP 1
+#define VM_FUSE_COPY_JUMP 1
+// VM_FUSE_END
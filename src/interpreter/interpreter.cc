@@ -4,9 +4,17 @@
 #include "interpreter/vm.h"
 #include "options.h"
 
+#include <fstream>
 #include <iterator>
 #include <verona.h>
 
+#ifndef _MSC_VER
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
 namespace verona::interpreter
 {
   Code load_file(std::istream& input)
@@ -22,6 +30,131 @@ namespace verona::interpreter
     return Code(data);
   }
 
+#ifndef _MSC_VER
+  namespace
+  {
+    /**
+     * Map an anonymous huge-page buffer of at least `bytes`, preferring
+     * explicit hugetlb pages and falling back to an ordinary mapping
+     * advised as transparent huge pages when no hugetlb pool is
+     * configured. Returns nullptr on failure; `mapped` receives the
+     * length to pass to munmap.
+     */
+    void* map_huge(size_t bytes, size_t& mapped)
+    {
+      constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+      mapped = snmalloc::bits::align_up(bytes, HUGE_PAGE_SIZE);
+
+#  ifdef MAP_HUGETLB
+      void* p = mmap(
+        nullptr,
+        mapped,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+        -1,
+        0);
+      if (p != MAP_FAILED)
+        return p;
+#  endif
+
+      void* q = mmap(
+        nullptr,
+        mapped,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+      if (q == MAP_FAILED)
+        return nullptr;
+
+#  ifdef MADV_HUGEPAGE
+      madvise(q, mapped, MADV_HUGEPAGE);
+#  endif
+      return q;
+    }
+
+    /// Read the whole file into `buffer`; returns false on a short read.
+    bool read_all(int fd, uint8_t* buffer, size_t size)
+    {
+      size_t done = 0;
+      while (done < size)
+      {
+        ssize_t n = read(fd, buffer + done, size - done);
+        if (n <= 0)
+          return false;
+        done += static_cast<size_t>(n);
+      }
+      return true;
+    }
+  }
+#endif
+
+  Code load_file(const std::string& path, bool huge_pages)
+  {
+#ifndef _MSC_VER
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+      struct stat st;
+      void* addr = MAP_FAILED;
+      size_t size = 0;
+
+      // Only regular files can be mapped; anything else (eg. a pipe)
+      // uses the stream fallback.
+      if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+      {
+        size = static_cast<size_t>(st.st_size);
+
+        if (huge_pages)
+        {
+          // Copy the program into a huge-page buffer instead of mapping
+          // the file, then drop write access for the run.
+          size_t mapped = 0;
+          void* buffer = map_huge(size, mapped);
+
+          if (buffer != nullptr)
+          {
+            if (read_all(fd, static_cast<uint8_t*>(buffer), size))
+            {
+              close(fd);
+              mprotect(buffer, mapped, PROT_READ);
+              std::shared_ptr<const uint8_t> data(
+                static_cast<const uint8_t*>(buffer),
+                [mapped](const uint8_t* p) {
+                  munmap(const_cast<void*>(static_cast<const void*>(p)),
+                         mapped);
+                });
+              return Code(std::move(data), size);
+            }
+
+            munmap(buffer, mapped);
+            lseek(fd, 0, SEEK_SET);
+          }
+        }
+
+        addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      }
+
+      // The mapping, if any, persists after the descriptor is closed.
+      close(fd);
+
+      if (addr != MAP_FAILED)
+      {
+        std::shared_ptr<const uint8_t> data(
+          static_cast<const uint8_t*>(addr), [size](const uint8_t* p) {
+            munmap(const_cast<void*>(static_cast<const void*>(p)), size);
+          });
+        return Code(std::move(data), size);
+      }
+    }
+#else
+    UNUSED(huge_pages);
+#endif
+
+    std::ifstream file(path, std::ios::binary);
+    return load_file(file);
+  }
+
   class EmptyCown : public rt::VCown<EmptyCown>
   {
   public:
@@ -45,21 +178,32 @@ namespace verona::interpreter
     // the receiver. This matches the usual calling convention for static
     // methods.
     // TODO: Should this contain command line arguments in the future?
-    std::vector<Value> args;
-    args.push_back(Value::descriptor(code.special_descriptors().main));
-
-    rt::Cown::schedule<ExecuteMessage>(cown, ip, std::move(args), 0);
+    rt::Cown::schedule<ExecuteMessage>(
+      cown,
+      ip,
+      size_t(1),
+      size_t(0),
+      Value::descriptor(code.special_descriptors().main),
+      nullptr);
 
     rt::Alloc* alloc = rt::ThreadAlloc::get();
     rt::Cown::release(alloc, cown);
 
     sched.run_with_startup<const Code*, bool>(VM::init_vm, &code, verbose);
 
+    VM::flush_print();
+
     snmalloc::current_alloc_pool()->debug_check_empty();
   }
 
   void instantiate(InterpreterOptions& options, const Code& code)
   {
+    VM::set_profile(!options.profile_file.empty());
+
+    // Not STDOUT_FILENO: unistd.h is not available on all platforms.
+    if (options.buffered_print)
+      VM::set_print_fd(1);
+
 #ifdef USE_SYSTEMATIC_TESTING
     if (options.run_seed.has_value())
     {
@@ -88,5 +232,19 @@ namespace verona::interpreter
 #else
     interpreter::instantiate(options.cores, code, options.verbose);
 #endif
+
+#ifdef USE_OPCODE_PROFILE
+    if (!options.opcode_profile_file.empty())
+    {
+      std::ofstream out(options.opcode_profile_file);
+      VM::dump_opcode_profile(out);
+    }
+#endif
+
+    if (!options.profile_file.empty())
+    {
+      std::ofstream out(options.profile_file);
+      VM::dump_profile(code, out);
+    }
   }
 }
@@ -8,5 +8,20 @@
 namespace verona::interpreter
 {
   Code load_file(std::istream& input);
+
+  /**
+   * Load a program by mapping the file read-only into memory, where the
+   * platform supports it.
+   *
+   * The program runs directly over the lazily faulted mapping: no copy
+   * of the file is made. Falls back to reading the file through a
+   * stream when mapping is unavailable or fails.
+   *
+   * With `huge_pages` set the program is instead copied into an
+   * anonymous huge-page buffer (explicit hugetlb pages when a pool is
+   * configured, a transparent-huge-page advised mapping otherwise),
+   * trading the copy at load time for fewer TLB misses on large images.
+   */
+  Code load_file(const std::string& path, bool huge_pages = false);
   void instantiate(InterpreterOptions& options, const Code& code);
 }
@@ -35,8 +35,8 @@ int main(int argc, const char** argv)
 
   verona::interpreter::validate_args(options);
 
-  std::ifstream file(options.input_file, std::ios::binary);
-  auto code = verona::interpreter::load_file(file);
+  auto code =
+    verona::interpreter::load_file(options.input_file, options.huge_pages);
 
   verona::interpreter::instantiate(options, code);
 
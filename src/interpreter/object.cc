@@ -4,24 +4,136 @@
 
 #include "vm.h"
 
+#include <algorithm>
 #include <fmt/ostream.h>
+#include <limits>
+#include <numeric>
 
 namespace verona::interpreter
 {
+  void SelectorMap::build(std::vector<std::pair<uint32_t, uint32_t>> entries)
+  {
+    size_t n = entries.size();
+    keys_.assign(n, 0);
+    values_.assign(n, 0);
+    disp_.assign(std::max<size_t>(n, 1), 0);
+    if (n == 0)
+      return;
+
+    // Distinct placements only exist for distinct keys; duplicates would
+    // make the displacement search below diverge.
+    std::vector<uint32_t> keys;
+    keys.reserve(n);
+    for (const auto& e : entries)
+      keys.push_back(e.first);
+    std::sort(keys.begin(), keys.end());
+    if (std::adjacent_find(keys.begin(), keys.end()) != keys.end())
+      throw std::logic_error("Duplicate selector in descriptor");
+
+    // Group the keys into buckets by their first hash.
+    std::vector<std::vector<size_t>> buckets(disp_.size());
+    for (size_t i = 0; i < n; i++)
+      buckets[hash(entries[i].first, 0) % buckets.size()].push_back(i);
+
+    // Place the largest buckets first, while the table is emptiest, so
+    // the hardest placements see the most free slots.
+    std::vector<size_t> order(buckets.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return buckets[a].size() > buckets[b].size();
+    });
+
+    std::vector<bool> used(n, false);
+    std::vector<size_t> placed;
+    for (size_t b : order)
+    {
+      const auto& bucket = buckets[b];
+      if (bucket.empty())
+        break;
+
+      // Find a displacement under which every key in the bucket lands in
+      // a distinct free slot. Expected to succeed after a handful of
+      // tries; the cap only guards against a pathological hash.
+      for (uint32_t d = 1;; d++)
+      {
+        size_t i = 0;
+        for (; i < bucket.size(); i++)
+        {
+          size_t pos = position(entries[bucket[i]].first, d);
+          if (used[pos])
+            break;
+          used[pos] = true;
+          placed.push_back(pos);
+        }
+
+        if (i == bucket.size())
+        {
+          disp_[b] = d;
+          break;
+        }
+
+        for (size_t pos : placed)
+          used[pos] = false;
+        placed.clear();
+
+        if (d == std::numeric_limits<uint32_t>::max())
+          throw std::logic_error("Unable to place selector table");
+      }
+
+      for (size_t i = 0; i < bucket.size(); i++)
+      {
+        keys_[placed[i]] = entries[bucket[i]].first;
+        values_[placed[i]] = entries[bucket[i]].second;
+      }
+      placed.clear();
+    }
+  }
+
   VMDescriptor::VMDescriptor(
     bytecode::DescriptorIdx index,
     std::string_view name,
-    size_t method_slots,
-    size_t field_slots,
     size_t field_count,
-    uint32_t finaliser_ip)
+    uint32_t finaliser_ip,
+    bool is_array,
+    bool is_map)
   : index(index),
     name(name),
-    methods(std::make_unique<uint32_t[]>(method_slots)),
-    fields(std::make_unique<uint32_t[]>(field_slots)),
     field_count(field_count),
+    is_array(is_array),
+    is_map(is_map),
     finaliser_ip(finaliser_ip)
   {
+    if (is_map)
+    {
+      // Map instances own a hash table instead of named fields, so
+      // everything that iterates fields has a map-specific version. The
+      // builtin Map class declares no named fields and no finaliser.
+      assert(field_count == 0);
+      assert(finaliser_ip == 0);
+      rt::Descriptor::size = rt::vsizeof<VMMap>;
+      rt::Descriptor::trace = VMMap::trace_fn;
+      rt::Descriptor::destructor = VMMap::destructor_fn;
+      rt::Descriptor::finaliser = VMMap::collect_iso_fields;
+      subtypes.insert(index);
+      return;
+    }
+
+    if (is_array)
+    {
+      // Array instances size their element buffer per-object, from the
+      // length passed to NewArray, so everything that iterates fields has
+      // an array-specific version. The builtin Array class declares no
+      // named fields and no finaliser.
+      assert(field_count == 0);
+      assert(finaliser_ip == 0);
+      rt::Descriptor::size = rt::vsizeof<VMArray>;
+      rt::Descriptor::trace = VMArray::trace_fn;
+      rt::Descriptor::destructor = VMArray::destructor_fn;
+      rt::Descriptor::finaliser = VMArray::collect_iso_fields;
+      subtypes.insert(index);
+      return;
+    }
+
     rt::Descriptor::size = rt::vsizeof<VMObject>;
     rt::Descriptor::trace = VMObject::trace_fn;
 
@@ -108,4 +220,187 @@ namespace verona::interpreter
     VMObject* object = static_cast<VMObject*>(base_object);
     (object)->~VMObject();
   }
+
+  VMArray::VMArray(VMObject* region, const VMDescriptor* desc, size_t length)
+  : VMObject(region, desc), length(length)
+  {
+    assert(desc->is_array);
+    if (length > 0)
+      fields = std::make_unique<FieldValue[]>(length);
+  }
+
+  void VMArray::trace_fn(const rt::Object* base_object, rt::ObjectStack& stack)
+  {
+    const VMArray* array = static_cast<const VMArray*>(base_object);
+
+    for (size_t i = 0; i < array->length; i++)
+    {
+      array->fields[i].trace(stack);
+    }
+  }
+
+  void VMArray::collect_iso_fields(
+    rt::Object* base_object, rt::Object* region, rt::ObjectStack& sub_regions)
+  {
+    UNUSED(region);
+
+    VMArray* array = static_cast<VMArray*>(base_object);
+
+    for (size_t i = 0; i < array->length; i++)
+    {
+      array->fields[i].add_isos(sub_regions);
+    }
+  }
+
+  void VMArray::destructor_fn(rt::Object* base_object)
+  {
+    VMArray* array = static_cast<VMArray*>(base_object);
+    array->~VMArray();
+  }
+
+  VMMap::VMMap(VMObject* region, const VMDescriptor* desc)
+  : VMObject(region, desc), capacity_(8)
+  {
+    assert(desc->is_map);
+    slots_ = std::make_unique<Slot[]>(capacity_);
+    states_ = std::make_unique<SlotState[]>(capacity_);
+  }
+
+  size_t VMMap::lookup_index(const Value& key)
+  {
+    size_t mask = capacity_ - 1;
+    for (size_t i = key.hash() & mask;; i = (i + 1) & mask)
+    {
+      if (states_[i] == SlotState::Empty)
+        return SIZE_MAX;
+      if (states_[i] == SlotState::Full && slots_[i].key.equals(key))
+        return i;
+    }
+  }
+
+  FieldValue* VMMap::lookup(const Value& key)
+  {
+    size_t index = lookup_index(key);
+    return index == SIZE_MAX ? nullptr : &slots_[index].value;
+  }
+
+  FieldValue& VMMap::insert(rt::Alloc* alloc, Value&& key)
+  {
+    // Grow at 3/4 occupancy, counting tombstones, which keeps every
+    // probe sequence short and guarantees the scans below terminate.
+    if ((used_ + 1) * 4 > capacity_ * 3)
+      grow(alloc);
+
+    size_t mask = capacity_ - 1;
+    size_t target = SIZE_MAX;
+    size_t i = key.hash() & mask;
+    for (;; i = (i + 1) & mask)
+    {
+      if (states_[i] == SlotState::Empty)
+        break;
+
+      if (states_[i] == SlotState::Full && slots_[i].key.equals(key))
+      {
+        key.clear(alloc);
+        return slots_[i].value;
+      }
+
+      // Remember the first tombstone on the probe path, so re-inserting
+      // a removed key reuses its slot.
+      if (states_[i] == SlotState::Tombstone && target == SIZE_MAX)
+        target = i;
+    }
+
+    if (target == SIZE_MAX)
+    {
+      target = i;
+      used_++;
+    }
+
+    states_[target] = SlotState::Full;
+    entries_++;
+    Value unset =
+      slots_[target].key.exchange(alloc, region(), std::move(key));
+    assert(unset.tag == Value::UNINIT);
+    unset.clear(alloc);
+    return slots_[target].value;
+  }
+
+  bool VMMap::remove(rt::Alloc* alloc, const Value& key)
+  {
+    size_t index = lookup_index(key);
+    if (index == SIZE_MAX)
+      return false;
+
+    slots_[index].key.exchange(alloc, region(), Value()).clear(alloc);
+    slots_[index].value.exchange(alloc, region(), Value()).clear(alloc);
+    states_[index] = SlotState::Tombstone;
+    entries_--;
+    return true;
+  }
+
+  void VMMap::grow(rt::Alloc* alloc)
+  {
+    size_t capacity = capacity_ * 2;
+    auto slots = std::make_unique<Slot[]>(capacity);
+    auto states = std::make_unique<SlotState[]>(capacity);
+    size_t mask = capacity - 1;
+
+    // Keys in the table are distinct, so re-insertion never needs an
+    // equality check: each key lands in the first empty slot of its
+    // probe sequence.
+    for (size_t i = 0; i < capacity_; i++)
+    {
+      if (states_[i] != SlotState::Full)
+        continue;
+
+      Value key = slots_[i].key.exchange(alloc, region(), Value());
+      Value value = slots_[i].value.exchange(alloc, region(), Value());
+
+      size_t j = key.hash() & mask;
+      while (states[j] == SlotState::Full)
+        j = (j + 1) & mask;
+
+      states[j] = SlotState::Full;
+      slots[j].key.exchange(alloc, region(), std::move(key)).clear(alloc);
+      slots[j].value.exchange(alloc, region(), std::move(value)).clear(alloc);
+    }
+
+    slots_ = std::move(slots);
+    states_ = std::move(states);
+    capacity_ = capacity;
+    used_ = entries_;
+  }
+
+  void VMMap::trace_fn(const rt::Object* base_object, rt::ObjectStack& stack)
+  {
+    const VMMap* map = static_cast<const VMMap*>(base_object);
+
+    // Empty and tombstone slots are UNINIT, which trace ignores.
+    for (size_t i = 0; i < map->capacity_; i++)
+    {
+      map->slots_[i].key.trace(stack);
+      map->slots_[i].value.trace(stack);
+    }
+  }
+
+  void VMMap::collect_iso_fields(
+    rt::Object* base_object, rt::Object* region, rt::ObjectStack& sub_regions)
+  {
+    UNUSED(region);
+
+    VMMap* map = static_cast<VMMap*>(base_object);
+
+    for (size_t i = 0; i < map->capacity_; i++)
+    {
+      map->slots_[i].key.add_isos(sub_regions);
+      map->slots_[i].value.add_isos(sub_regions);
+    }
+  }
+
+  void VMMap::destructor_fn(rt::Object* base_object)
+  {
+    VMMap* map = static_cast<VMMap*>(base_object);
+    map->~VMMap();
+  }
 }
@@ -6,27 +6,109 @@
 #include "interpreter/value.h"
 
 #include <unordered_set>
+#include <vector>
 #include <verona.h>
 
 namespace verona::interpreter
 {
+  /**
+   * Compact selector→value table with minimal perfect hashing.
+   *
+   * Selector indices are drawn from a program-wide universe (see
+   * compiler/codegen/selector.cc), so a dense table indexed by selector
+   * costs universe-sized storage in every descriptor. Instead the entries
+   * are stored in exactly `count` slots, with a hash-and-displace
+   * placement computed when the program is loaded: keys are grouped into
+   * buckets by a first hash, and each bucket is assigned a displacement
+   * under which its keys land in distinct free slots. A lookup is one
+   * displacement read and one table probe, with no collision chain.
+   *
+   * The type system guarantees dispatch only uses selectors present in
+   * the descriptor, so lookups do not handle misses (asserted in debug).
+   */
+  class SelectorMap
+  {
+  public:
+    /**
+     * Build the table from (selector, value) pairs. Throws
+     * std::logic_error if a selector appears twice.
+     */
+    void build(std::vector<std::pair<uint32_t, uint32_t>> entries);
+
+    uint32_t get(bytecode::SelectorIdx selector) const
+    {
+      assert(!values_.empty());
+      size_t pos =
+        position(selector.value, disp_[hash(selector.value, 0) % disp_.size()]);
+      assert(keys_[pos] == selector.value);
+      return values_[pos];
+    }
+
+  private:
+    static size_t hash(uint32_t key, uint32_t seed)
+    {
+      uint64_t h = key + ((uint64_t(seed) + 1) * 0x9E3779B97F4A7C15);
+      h ^= h >> 33;
+      h *= 0xFF51AFD7ED558CCD;
+      h ^= h >> 33;
+      return (size_t)h;
+    }
+
+    size_t position(uint32_t key, uint32_t d) const
+    {
+      return hash(key, d) % values_.size();
+    }
+
+    std::vector<uint32_t> keys_;
+    std::vector<uint32_t> values_;
+    std::vector<uint32_t> disp_;
+  };
+
   struct VMDescriptor : public rt::Descriptor
   {
     VMDescriptor(
       bytecode::DescriptorIdx index,
       std::string_view name,
-      size_t method_slots,
-      size_t field_slots,
       size_t field_count,
-      uint32_t finaliser_ip);
+      uint32_t finaliser_ip,
+      bool is_array,
+      bool is_map);
 
     const bytecode::DescriptorIdx index;
     const std::string name;
     const size_t field_count;
-    std::unique_ptr<uint32_t[]> fields;
-    std::unique_ptr<uint32_t[]> methods;
+
+    /**
+     * True for instantiations of the builtin Array class. Array instances
+     * are VMArrays rather than VMObjects: they have no named fields and
+     * carry a per-instance length and contiguous element buffer instead,
+     * with matching trace and finalisation functions.
+     */
+    const bool is_array;
+
+    /**
+     * True for instantiations of the builtin Map class. Map instances are
+     * VMMaps: an open-addressed hash table owned by the object, with
+     * matching trace and finalisation functions.
+     */
+    const bool is_map;
+    SelectorMap fields;
+    SelectorMap methods;
     std::unordered_set<bytecode::DescriptorIdx> subtypes;
     const uint32_t finaliser_ip;
+
+    /**
+     * One bit per descriptor in the program: bit `i` is set when values
+     * whose descriptor has index `i` match this descriptor in a pattern.
+     * Expanded from the subtype metadata when the program is loaded, so
+     * a match test reads a single bit.
+     */
+    std::vector<bool> match_bits;
+
+    bool matches(bytecode::DescriptorIdx idx) const
+    {
+      return match_bits[idx.value];
+    }
   };
 
   struct VMObject : public rt::Object
@@ -62,6 +144,109 @@ namespace verona::interpreter
     VMObject* parent_;
   };
 
+  /**
+   * Fixed-length array object, used for instantiations of the builtin
+   * Array class.
+   *
+   * The elements live in one contiguous buffer sized by the per-instance
+   * length, rather than by the descriptor's field count, so indexed
+   * access is a single offset and tracing walks the buffer linearly.
+   * Elements start out UNINIT; the Load/Store array opcodes are the only
+   * accessors.
+   */
+  struct VMArray : public VMObject
+  {
+    explicit VMArray(
+      VMObject* region, const VMDescriptor* desc, size_t length);
+
+    const size_t length;
+
+    static void trace_fn(const rt::Object* base_object, rt::ObjectStack& stack);
+    static void collect_iso_fields(
+      rt::Object* base_object,
+      rt::Object* region,
+      rt::ObjectStack& sub_regions);
+    static void destructor_fn(rt::Object* base_object);
+  };
+
+  /**
+   * Hash map object, used for instantiations of the builtin Map class.
+   *
+   * The table is open-addressed with linear probing and tombstones, over
+   * power-of-two capacities, keyed by shallow value equality (see
+   * FieldValue::equals): U64 keys by value, strings by contents with
+   * their cached hash, objects by identity. Key and value slots have the
+   * same ownership semantics as object fields, so freezing the map's
+   * region works through the regular trace function.
+   */
+  struct VMMap : public VMObject
+  {
+    explicit VMMap(VMObject* region, const VMDescriptor* desc);
+
+    size_t size() const
+    {
+      return entries_;
+    }
+
+    /**
+     * Return the value slot for `key`, or nullptr when the key is absent.
+     */
+    FieldValue* lookup(const Value& key);
+
+    /**
+     * Return the value slot for `key`, inserting the key when absent.
+     * `key` is consumed, either into the table or cleared when an equal
+     * key is already present.
+     */
+    FieldValue& insert(rt::Alloc* alloc, Value&& key);
+
+    /**
+     * Remove `key`'s entry, dropping its key and value. Returns false
+     * when the key is absent.
+     */
+    bool remove(rt::Alloc* alloc, const Value& key);
+
+    static void trace_fn(const rt::Object* base_object, rt::ObjectStack& stack);
+    static void collect_iso_fields(
+      rt::Object* base_object,
+      rt::Object* region,
+      rt::ObjectStack& sub_regions);
+    static void destructor_fn(rt::Object* base_object);
+
+  private:
+    enum class SlotState : uint8_t
+    {
+      Empty,
+      Full,
+      Tombstone,
+    };
+
+    struct Slot
+    {
+      FieldValue key;
+      FieldValue value;
+    };
+
+    /**
+     * Return the index of `key`'s slot, or SIZE_MAX when absent.
+     */
+    size_t lookup_index(const Value& key);
+
+    void grow(rt::Alloc* alloc);
+
+    std::unique_ptr<Slot[]> slots_;
+    std::unique_ptr<SlotState[]> states_;
+
+    /** Table capacity, always a power of two. */
+    size_t capacity_;
+
+    /** Number of Full slots. */
+    size_t entries_ = 0;
+
+    /** Number of Full and Tombstone slots, reset by grow. */
+    size_t used_ = 0;
+  };
+
   struct VMCown : public rt::VCown<VMCown>
   {
     // This is the descriptor for cown[T], not for T.
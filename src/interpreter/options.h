@@ -11,6 +11,12 @@ namespace verona::interpreter
     uint8_t cores = 4;
     bool verbose = false;
     bool run = false;
+    bool huge_pages = false;
+    bool buffered_print = false;
+    std::string profile_file;
+#ifdef USE_OPCODE_PROFILE
+    std::string opcode_profile_file;
+#endif
 #ifdef USE_SYSTEMATIC_TESTING
     std::optional<size_t> run_seed;
     std::optional<size_t> run_seed_upper;
@@ -33,6 +39,27 @@ namespace verona::interpreter
 
     app.add_option("--" + tag + "cores", options.cores);
     app.add_flag("--" + tag + "verbose", options.verbose);
+    app.add_flag(
+      "--" + tag + "hugepages",
+      options.huge_pages,
+      "Load the program into huge-page backed memory, reducing TLB misses "
+      "on large bytecode images");
+    app.add_flag(
+      "--" + tag + "buffered-print",
+      options.buffered_print,
+      "Buffer Print output and write it to stdout in large chunks, instead "
+      "of a flushing stream write per print");
+    app.add_option(
+      "--" + tag + "profile",
+      options.profile_file,
+      "Write per-opcode and per-method execution counts as CSV to this file "
+      "on exit");
+#ifdef USE_OPCODE_PROFILE
+    app.add_option(
+      "--" + tag + "opcode-profile",
+      options.opcode_profile_file,
+      "Write an opcode-pair frequency profile to this file on exit");
+#endif
 #ifdef USE_SYSTEMATIC_TESTING
     app.add_option("--" + tag + "seed", options.run_seed);
     app.add_option("--" + tag + "seed_upper", options.run_seed_upper);
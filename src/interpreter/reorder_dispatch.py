@@ -0,0 +1,179 @@
+# Copyright Microsoft and Project Verona Contributors.
+# SPDX-License-Identifier: MIT
+"""Apply an opcode-pair frequency profile to dispatch_order.h.
+
+The profile is produced by a USE_OPCODE_PROFILE build of the interpreter
+(the `interpreter-profile` target) run with `--opcode-profile <file>`. It
+is a text file of `<first> <second> <count>` lines, one per dynamically
+executed pair of adjacent opcodes, using the enumerator names of
+`bytecode::Opcode`; lines starting with '#' are comments.
+
+Two things are rewritten, between their marker comments:
+
+* The VM_DISPATCH_OPS list, which is the code layout of the opcode
+  handlers in the threaded dispatch loop. Handlers are ordered greedily
+  by pair affinity: starting from the hottest opcode, the next handler
+  placed is the one most often executed after the one just placed, so
+  hot successor handlers share i-cache lines. Handlers absent from the
+  profile keep their relative order, after all profiled ones.
+
+* The VM_FUSE_* switches, which select the superinstructions the code
+  generator's peephole emits. A fusion is enabled when its component
+  pair accounts for at least FUSE_THRESHOLD of all executed pairs.
+
+Usage:
+    reorder_dispatch.py --profile <file> [--header <dispatch_order.h>]
+"""
+
+import argparse
+import re
+import sys
+from collections import defaultdict
+from pathlib import Path
+
+# Fraction of all executed pairs a component pair must reach for its
+# superinstruction to be worth having in the code generator's peephole.
+FUSE_THRESHOLD = 0.01
+
+# Superinstruction switch -> (the opcode pair it fuses, the fused opcode).
+# Executions of the fused opcode itself also count as evidence, so a
+# profile gathered with the fusion already enabled keeps it enabled.
+FUSIONS = {
+    "VM_FUSE_INT64_BINOP": (("Int64", "BinOp"), "Int64BinOp"),
+    "VM_FUSE_LOAD_BINOP": (("Load", "BinOp"), "LoadBinOp"),
+    "VM_FUSE_COPY_JUMP": (("Copy", "Jump"), "CopyJump"),
+}
+
+OPS_BEGIN = "// VM_DISPATCH_OPS_BEGIN"
+OPS_END = "// VM_DISPATCH_OPS_END"
+FUSE_BEGIN = "// VM_FUSE_BEGIN"
+FUSE_END = "// VM_FUSE_END"
+
+OP_LINE = re.compile(r"^\s*OP\((\w+),\s*(\w+)\)")
+
+
+def parse_profile(path):
+    pairs = defaultdict(int)
+    for lineno, line in enumerate(path.read_text().splitlines(), 1):
+        line = line.split("#", 1)[0].strip()
+        if not line:
+            continue
+        fields = line.split()
+        if len(fields) != 3:
+            sys.exit(f"{path}:{lineno}: expected '<first> <second> <count>'")
+        pairs[(fields[0], fields[1])] += int(fields[2])
+    return pairs
+
+
+def order_handlers(handlers, pairs):
+    """Greedy affinity ordering of the handler names in `handlers`."""
+    known = set(handlers)
+    weight = defaultdict(int)
+    succ = defaultdict(lambda: defaultdict(int))
+    for (first, second), count in pairs.items():
+        if first in known:
+            weight[first] += count
+        if second in known:
+            weight[second] += count
+        if first in known and second in known:
+            succ[first][second] += count
+
+    ordered = []
+    placed = set()
+    while len(placed) < len(weight):
+        if ordered:
+            # Prefer the hottest not-yet-placed successor of the last
+            # placed handler; fall back to the hottest remaining one.
+            candidates = {
+                op: count
+                for op, count in succ[ordered[-1]].items()
+                if op not in placed
+            }
+        else:
+            candidates = {}
+        if not candidates:
+            candidates = {
+                op: count for op, count in weight.items() if op not in placed
+            }
+        best = max(candidates, key=lambda op: (candidates[op], weight[op]))
+        ordered.append(best)
+        placed.add(best)
+
+    # Unprofiled handlers keep their relative order, after the hot ones.
+    ordered.extend(op for op in handlers if op not in placed)
+    return ordered
+
+
+def find_marker(lines, marker):
+    for index, line in enumerate(lines):
+        if line.startswith(marker):
+            return index
+    sys.exit(f"header is missing the {marker} marker")
+
+
+def rewrite_block(lines, begin, end, replacement):
+    lo = find_marker(lines, begin)
+    hi = find_marker(lines, end)
+    return lines[: lo + 1] + replacement + lines[hi:]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--profile", type=Path, required=True)
+    parser.add_argument(
+        "--header",
+        type=Path,
+        default=Path(__file__).with_name("dispatch_order.h"),
+    )
+    args = parser.parse_args()
+
+    pairs = parse_profile(args.profile)
+    total = sum(pairs.values())
+    if total == 0:
+        sys.exit(f"{args.profile}: profile contains no executed pairs")
+
+    lines = args.header.read_text().splitlines()
+
+    # Collect the current OP(Name, handler) list.
+    lo = find_marker(lines, OPS_BEGIN)
+    hi = find_marker(lines, OPS_END)
+    op_handlers = {}
+    for line in lines[lo:hi]:
+        match = OP_LINE.match(line)
+        if match:
+            op_handlers[match.group(1)] = match.group(2)
+    unknown = {op for pair in pairs for op in pair} - set(op_handlers)
+    if unknown:
+        sys.exit(f"{args.profile}: unknown opcodes {sorted(unknown)}")
+
+    ordered = order_handlers(list(op_handlers), pairs)
+    ops_block = ["#define VM_DISPATCH_OPS(OP) \\"]
+    ops_block += [
+        f"  OP({op}, {op_handlers[op]}) \\" for op in ordered[:-1]
+    ]
+    ops_block += [f"  OP({ordered[-1]}, {op_handlers[ordered[-1]]})"]
+
+    def fuse_evidence(pair, fused):
+        executed = sum(
+            count for (first, _), count in pairs.items() if first == fused
+        )
+        return pairs.get(pair, 0) + executed
+
+    fusions = {
+        switch: int(fuse_evidence(pair, fused) >= FUSE_THRESHOLD * total)
+        for switch, (pair, fused) in FUSIONS.items()
+    }
+    fuse_block = [
+        f"#define {switch} {enable}" for switch, enable in fusions.items()
+    ]
+
+    lines = rewrite_block(lines, OPS_BEGIN, OPS_END, ops_block)
+    lines = rewrite_block(lines, FUSE_BEGIN, FUSE_END, fuse_block)
+    args.header.write_text("\n".join(lines) + "\n")
+
+    print(f"{args.header}: ordered {len(ordered)} handlers, fusions: "
+          + ", ".join(f"{s}={e}" for s, e in fusions.items()))
+
+
+if __name__ == "__main__":
+    main()
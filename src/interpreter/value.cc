@@ -6,8 +6,41 @@
 #include "ds/helpers.h"
 #include "interpreter/object.h"
 
+#include <cstring>
+
 namespace verona::interpreter
 {
+  uint64_t VMString::compute_hash() const
+  {
+    // Word-at-a-time multiply-xor hash, with the same finalizer as
+    // SelectorMap (see object.h). Consuming eight bytes per step keeps
+    // long keys memory-bound instead of loop-bound.
+    uint64_t h = 0x9E3779B97F4A7C15 ^ contents.size();
+    const char* data = contents.data();
+    size_t remaining = contents.size();
+
+    while (remaining >= sizeof(uint64_t))
+    {
+      uint64_t chunk;
+      memcpy(&chunk, data, sizeof(chunk));
+      h = (h ^ chunk) * 0xFF51AFD7ED558CCD;
+      data += sizeof(chunk);
+      remaining -= sizeof(chunk);
+    }
+
+    uint64_t tail = 0;
+    memcpy(&tail, data, remaining);
+    h = (h ^ tail) * 0xFF51AFD7ED558CCD;
+
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCD;
+    h ^= h >> 33;
+
+    // 0 marks the cache as empty; remap so every contents has a non-zero
+    // hash.
+    return h == 0 ? 1 : h;
+  }
+
   Value Value::u64(uint64_t value)
   {
     Value v;
@@ -20,7 +53,7 @@ namespace verona::interpreter
   {
     Value v;
     v.tag = STRING;
-    v.inner.string_ptr = new std::string(std::move(value));
+    v.inner.string_ptr = new VMString(std::move(value));
     return v;
   }
 
@@ -29,6 +62,15 @@ namespace verona::interpreter
     return Value::string(std::string(value));
   }
 
+  Value Value::string(VMString* str)
+  {
+    str->acquire();
+    Value v;
+    v.tag = STRING;
+    v.inner.string_ptr = str;
+    return v;
+  }
+
   Value Value::iso(VMObject* object)
   {
     assert(object->debug_is_iso());
@@ -89,6 +131,17 @@ namespace verona::interpreter
 
   void Value::overwrite(rt::Alloc* alloc, Value&& other)
   {
+    // When neither side owns anything, the overwrite is a plain store.
+    // This is the common case on arithmetic-heavy code, where U64 results
+    // are repeatedly written over U64 registers.
+    if (is_trivial(tag) && is_trivial(other.tag))
+    {
+      this->tag = other.tag;
+      this->inner = other.inner;
+      other.tag = UNINIT;
+      return;
+    }
+
     std::swap(this->tag, other.tag);
     std::swap(this->inner, other.inner);
     other.clear(alloc);
@@ -119,7 +172,7 @@ namespace verona::interpreter
         break;
 
       case STRING:
-        delete inner.string_ptr;
+        VMString::release(inner.string_ptr);
         break;
 
       case MUT:
@@ -179,7 +232,7 @@ namespace verona::interpreter
         return Value::u64(inner.u64);
 
       case STRING:
-        return Value::string(inner.string());
+        return Value::string(inner.string_ptr);
 
       case DESCRIPTOR:
         return Value::descriptor(inner.descriptor);
@@ -215,6 +268,36 @@ namespace verona::interpreter
     return inner.object;
   }
 
+  void Value::trace(rt::ObjectStack& stack) const
+  {
+    switch (tag)
+    {
+      case ISO:
+      case MUT:
+      case IMM:
+        stack.push(inner.object);
+        break;
+
+      case COWN:
+        stack.push(inner.cown);
+        break;
+
+      case UNINIT:
+      case U64:
+      case STRING:
+      case DESCRIPTOR:
+        break;
+
+      case COWN_UNOWNED:
+        // An unowned view in a message capture block: the runtime holds
+        // the reference on the message's behalf, so there is nothing to
+        // report here.
+        break;
+
+        EXHAUSTIVE_SWITCH
+    }
+  }
+
   Value FieldValue::read(Value::Tag parent)
   {
     assert(
@@ -228,7 +311,7 @@ namespace verona::interpreter
         return Value::u64(inner.u64);
 
       case Value::STRING:
-        return Value::string(inner.string());
+        return Value::string(inner.string_ptr);
 
       case Value::DESCRIPTOR:
         return Value::descriptor(inner.descriptor);
@@ -316,6 +399,168 @@ namespace verona::interpreter
     return result;
   }
 
+  namespace
+  {
+    bool equals_inner(
+      Value::Tag tag,
+      const Value::Inner& inner,
+      Value::Tag other_tag,
+      const Value::Inner& other_inner)
+    {
+      if (tag != other_tag)
+        return false;
+
+      switch (tag)
+      {
+        case Value::UNINIT:
+          return true;
+
+        case Value::U64:
+          return inner.u64 == other_inner.u64;
+
+        case Value::STRING:
+          return inner.string() == other_inner.string();
+
+        case Value::DESCRIPTOR:
+          return inner.descriptor == other_inner.descriptor;
+
+        case Value::ISO:
+        case Value::MUT:
+        case Value::IMM:
+          return inner.object == other_inner.object;
+
+        case Value::COWN:
+          return inner.cown == other_inner.cown;
+
+        case Value::COWN_UNOWNED:
+          // Cannot be part of the heap.
+          abort();
+
+          EXHAUSTIVE_SWITCH
+      }
+    }
+
+    uint64_t mix_hash(uint64_t h)
+    {
+      // Same finalizer as SelectorMap (see object.h).
+      h ^= h >> 33;
+      h *= 0xFF51AFD7ED558CCD;
+      h ^= h >> 33;
+      return h;
+    }
+
+    uint64_t hash_inner(Value::Tag tag, const Value::Inner& inner)
+    {
+      switch (tag)
+      {
+        case Value::UNINIT:
+          return 0;
+
+        case Value::U64:
+          return mix_hash(inner.u64);
+
+        case Value::STRING:
+          return inner.string_ptr->hash();
+
+        case Value::DESCRIPTOR:
+          return mix_hash(reinterpret_cast<uintptr_t>(inner.descriptor));
+
+        case Value::ISO:
+        case Value::MUT:
+        case Value::IMM:
+          return mix_hash(reinterpret_cast<uintptr_t>(inner.object));
+
+        case Value::COWN:
+          return mix_hash(reinterpret_cast<uintptr_t>(inner.cown));
+
+        case Value::COWN_UNOWNED:
+          // Cannot be part of the heap.
+          abort();
+
+          EXHAUSTIVE_SWITCH
+      }
+    }
+  }
+
+  uint64_t Value::hash() const
+  {
+    return hash_inner(tag, inner);
+  }
+
+  bool FieldValue::equals(const FieldValue& other) const
+  {
+    return equals_inner(tag, inner, other.tag, other.inner);
+  }
+
+  bool FieldValue::equals(const Value& other) const
+  {
+    return equals_inner(tag, inner, other.tag, other.inner);
+  }
+
+  uint64_t FieldValue::hash() const
+  {
+    return hash_inner(tag, inner);
+  }
+
+  void FieldValue::copy_range(
+    rt::Alloc* alloc,
+    rt::Object* region,
+    FieldValue* dst,
+    FieldValue* src,
+    size_t count,
+    Value::Tag src_parent)
+  {
+    // When no slot on either side owns anything, and viewpoint adaptation
+    // cannot mint owning IMM views of the source, the copy degenerates to
+    // a block move of the tag/inner pairs. This is the common case for
+    // arrays of integers, and what makes bulk copies memory-bound rather
+    // than dispatch-bound.
+    if (src_parent != Value::IMM)
+    {
+      bool trivial = true;
+      for (size_t i = 0; i < count; i++)
+      {
+        if (!Value::is_trivial(src[i].tag) || !Value::is_trivial(dst[i].tag))
+        {
+          trivial = false;
+          break;
+        }
+      }
+
+      if (trivial)
+      {
+        memmove(
+          static_cast<void*>(dst),
+          static_cast<const void*>(src),
+          count * sizeof(FieldValue));
+        return;
+      }
+    }
+
+    // General path: a read/exchange pair per slot, releasing what the
+    // destination held. Walking from the far end when the destination
+    // starts inside the source range gives memmove semantics for
+    // overlapping copies within one array.
+    if (dst <= src || dst >= src + count)
+    {
+      for (size_t i = 0; i < count; i++)
+      {
+        Value old =
+          dst[i].exchange(alloc, region, src[i].read(src_parent));
+        old.clear(alloc);
+      }
+    }
+    else
+    {
+      for (size_t i = count; i > 0; i--)
+      {
+        Value old =
+          dst[i - 1].exchange(alloc, region, src[i - 1].read(src_parent));
+        old.clear(alloc);
+      }
+    }
+  }
+
   void FieldValue::trace(rt::ObjectStack& stack) const
   {
     switch (tag)
@@ -374,7 +619,7 @@ namespace verona::interpreter
     switch (tag)
     {
       case Value::STRING:
-        delete inner.string_ptr;
+        VMString::release(inner.string_ptr);
         break;
 
       case Value::ISO:
@@ -4,6 +4,7 @@
 
 #include "interpreter/bytecode.h"
 
+#include <atomic>
 #include <fmt/format.h>
 #include <verona.h>
 
@@ -13,6 +14,88 @@ namespace verona::interpreter
   struct VMObject;
   struct VMCown;
 
+  /**
+   * Immutable, reference-counted string payload.
+   *
+   * STRING values share the payload: copying a value acquires a
+   * reference rather than copying the characters. The count is atomic
+   * because values captured by `when` clauses move across scheduler
+   * threads.
+   *
+   * Literal atoms are interned by Code when the program is loaded, with
+   * one reference owned by the intern table, so executing a String
+   * instruction never allocates.
+   */
+  struct VMString
+  {
+    explicit VMString(std::string contents) : contents(std::move(contents)) {}
+
+    const std::string contents;
+
+    void acquire()
+    {
+      refcount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void release(VMString* str)
+    {
+      if (str->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete str;
+    }
+
+    /**
+     * Comparison and search kernels for the StringOp opcode. They defer
+     * to the std routines over the whole payload, rather than a per-byte
+     * interpreter loop, so they run at the platform's block-compare
+     * speed. `find` returns the index of the first occurrence of
+     * `needle`, or the string's length when there is none.
+     */
+    bool equals(const VMString& other) const
+    {
+      // Shared payloads (e.g. two references to one interned atom) are
+      // equal without looking at the bytes.
+      return this == &other || contents == other.contents;
+    }
+
+    int compare(const VMString& other) const
+    {
+      return contents.compare(other.contents);
+    }
+
+    size_t find(const VMString& needle) const
+    {
+      size_t index = contents.find(needle.contents);
+      return index == std::string::npos ? contents.size() : index;
+    }
+
+    /**
+     * Hash of the contents, computed on first use and cached. The
+     * payload is immutable, so racing computations produce the same
+     * value and the cache only needs relaxed atomics.
+     */
+    uint64_t hash() const
+    {
+      uint64_t h = hash_.load(std::memory_order_relaxed);
+      if (h == 0)
+      {
+        h = compute_hash();
+        hash_.store(h, std::memory_order_relaxed);
+      }
+      return h;
+    }
+
+  private:
+    uint64_t compute_hash() const;
+
+    std::atomic<uint64_t> refcount = 1;
+
+    /**
+     * Cached hash of `contents`, 0 while not yet computed.
+     * compute_hash never returns 0.
+     */
+    mutable std::atomic<uint64_t> hash_ = 0;
+  };
+
   /**
    * Tagged Verona value, which handles ownership of objects and reference
    * counts.
@@ -49,16 +132,11 @@ namespace verona::interpreter
       VMCown* cown;
       const VMDescriptor* descriptor;
       uint64_t u64;
-      std::string* string_ptr;
-
-      std::string& string()
-      {
-        return *string_ptr;
-      }
+      VMString* string_ptr;
 
       const std::string& string() const
       {
-        return *string_ptr;
+        return string_ptr->contents;
       }
     };
 
@@ -67,9 +145,23 @@ namespace verona::interpreter
 
     Value() : tag(Tag::UNINIT) {}
 
+    /**
+     * Whether values with this tag own anything. Clearing or overwriting
+     * a trivial value is a plain store, with no release work. This is
+     * what keeps integer arithmetic cheap: a U64 result is written over a
+     * (typically U64) register without ever inspecting the allocator.
+     */
+    static constexpr bool is_trivial(Tag t)
+    {
+      return t == Tag::UNINIT || t == Tag::MUT || t == Tag::U64 ||
+        t == Tag::DESCRIPTOR || t == Tag::COWN_UNOWNED;
+    }
+
     static Value u64(uint64_t value);
     static Value string(std::string value);
     static Value string(std::string_view value);
+    // Shares the given payload, acquiring a new reference to it.
+    static Value string(VMString* str);
 
     // Takes ownership of the region.
     static Value iso(VMObject* object);
@@ -149,6 +241,13 @@ namespace verona::interpreter
      */
     Value cown_body() const;
 
+    /**
+     * Shallow hash, consistent with FieldValue::equals: U64 values hash
+     * by value, STRING values by contents (cached in the payload), and
+     * references by the identity of what they refer to.
+     */
+    uint64_t hash() const;
+
     Inner* operator->()
     {
       return &inner;
@@ -211,6 +310,44 @@ namespace verona::interpreter
      **/
     void add_isos(rt::ObjectStack& stack) const;
 
+    /**
+     * Shallow equality, as used by the ArrayCompare opcode.
+     *
+     * Values of different tags are never equal. U64 values compare by
+     * value and STRING values by contents; everything else compares by
+     * identity of the referenced object, cown or descriptor.
+     */
+    bool equals(const FieldValue& other) const;
+    bool equals(const Value& other) const;
+
+    /**
+     * Shallow hash, consistent with `equals`; see Value::hash.
+     */
+    uint64_t hash() const;
+
+    /**
+     * Copy `count` slots from `src` into `dst`, with the same semantics
+     * as a read/exchange pair per slot: new references are acquired for
+     * the copies, the destination's old contents are released, and
+     * viewpoint adaptation is applied using `src_parent`, the tag of the
+     * value the source slots were accessed through.
+     *
+     * `region` should be the region of the object containing `dst`. The
+     * ranges may overlap; the result is as if the source range had been
+     * read in full before the first store.
+     *
+     * When every slot in both ranges holds a trivial value (see
+     * Value::is_trivial) and `src_parent` is not IMM, the copy is a
+     * single memmove rather than per-slot reference counting.
+     */
+    static void copy_range(
+      rt::Alloc* alloc,
+      rt::Object* region,
+      FieldValue* dst,
+      FieldValue* src,
+      size_t count,
+      Value::Tag src_parent);
+
     friend fmt::formatter<Value>;
 
   private:
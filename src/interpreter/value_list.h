@@ -86,6 +86,17 @@ namespace verona::interpreter
       return reverse_iterator(vm_, registers_.begin());
     }
 
+    size_t size() const
+    {
+      return registers_.size();
+    }
+
+    value_type& operator[](size_t index) const
+    {
+      assert(index < size());
+      return vm_->read(registers_.begin()[index]);
+    }
+
   private:
     vm_pointer vm_;
     RegisterSpan registers_;
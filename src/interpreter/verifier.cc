@@ -0,0 +1,238 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include "interpreter/code.h"
+
+#include <unordered_set>
+
+/**
+ * List of opcodes the VM has a handler for. Merge is deliberately absent,
+ * matching the dispatch table in vm.cc: a verified program never contains
+ * it.
+ */
+#define VERIFIER_OPS(OP) \
+  OP(ArrayCompare) \
+  OP(ArrayCopy) \
+  OP(ArrayFill) \
+  OP(ArrayLength) \
+  OP(ArrayLoad) \
+  OP(ArrayStore) \
+  OP(BinOp) \
+  OP(Call) \
+  OP(CallDirect) \
+  OP(Clear) \
+  OP(ClearList) \
+  OP(Copy) \
+  OP(FulfillSleepingCown) \
+  OP(Freeze) \
+  OP(Int64) \
+  OP(Jump) \
+  OP(JumpIf) \
+  OP(Load) \
+  OP(LoadDescriptor) \
+  OP(MapContains) \
+  OP(MapGet) \
+  OP(MapInsert) \
+  OP(MapRemove) \
+  OP(MapSize) \
+  OP(MatchCapability) \
+  OP(MatchDescriptor) \
+  OP(Move) \
+  OP(MutView) \
+  OP(NewArray) \
+  OP(NewMap) \
+  OP(NewObject) \
+  OP(NewRegion) \
+  OP(NewSleepingCown) \
+  OP(NewCown) \
+  OP(Print) \
+  OP(Protect) \
+  OP(Return) \
+  OP(Store) \
+  OP(TailCall) \
+  OP(String) \
+  OP(StringOp) \
+  OP(TraceRegion) \
+  OP(When) \
+  OP(Yield) \
+  OP(Unprotect) \
+  OP(Unreachable) \
+  OP(Int64BinOp) \
+  OP(LoadBinOp) \
+  OP(CopyJump)
+
+namespace verona::interpreter
+{
+  /**
+   * One-shot bytecode verifier, run when a Code is constructed.
+   *
+   * Starting from the function entry points named by descriptors, it
+   * decodes every reachable function once, with the checked loaders, and
+   * proves the properties the VM's unchecked dispatch path relies on:
+   * every instruction and its operands decode within the function body,
+   * register indices fit in the frame, jump targets are instruction
+   * starts within the same function, descriptor indices are valid and
+   * When code pointers lead to well-formed functions.
+   *
+   * Selector operands are not proven here: their bound depends on the
+   * dynamic receiver, and the table they index is validated when
+   * descriptors are loaded.
+   */
+  class Verifier
+  {
+  public:
+    explicit Verifier(Code& code) : code_(code) {}
+
+    void verify_program()
+    {
+      for (size_t entry : code_.function_entrypoints_)
+        enqueue_function(entry);
+
+      while (!pending_.empty())
+      {
+        size_t offset = pending_.back();
+        pending_.pop_back();
+        verify_function(offset);
+      }
+    }
+
+  private:
+    void enqueue_function(size_t offset)
+    {
+      if (verified_.insert(offset).second)
+        pending_.push_back(offset);
+    }
+
+    [[noreturn]] void fail(std::string_view message, size_t ip) const
+    {
+      throw std::logic_error(
+        fmt::format("Bytecode verification failed at {:#x}: {}", ip, message));
+    }
+
+    void verify_function(size_t offset)
+    {
+      size_t ip = offset;
+      FunctionHeader header = code_.function_header(ip);
+      code_.check(ip, header.size);
+
+      if (header.argc > header.locals || header.retc > header.locals)
+        fail("argument and return registers do not fit in the frame", offset);
+
+      // Record the decoded header so the VM can enter this function
+      // without re-parsing it.
+      code_.functions_.emplace(offset, Code::FunctionInfo{header, ip});
+
+      locals_ = header.locals;
+      starts_.clear();
+      jumps_.clear();
+
+      size_t body_end = ip + header.size;
+      while (ip < body_end)
+      {
+        starts_.insert(ip);
+        instruction_start_ = ip;
+
+        // Throws on values beyond Opcode::maximum_value.
+        Opcode op = code_.load<Opcode>(ip);
+        switch (op)
+        {
+#define OP(NAME) \
+  case Opcode::NAME: \
+    verify_operands<Opcode::NAME>(ip); \
+    break;
+
+          VERIFIER_OPS(OP)
+
+#undef OP
+
+          default:
+            fail("opcode has no handler", instruction_start_);
+        }
+      }
+
+      if (ip != body_end)
+        fail("last instruction overruns the function body", instruction_start_);
+
+      for (const auto& [source, target] : jumps_)
+      {
+        if (starts_.count(target) == 0)
+          fail("jump target is not an instruction start", source);
+      }
+    }
+
+    template<Opcode opcode>
+    void verify_operands(size_t& ip)
+    {
+      verify_operands_inner(
+        typename bytecode::OpcodeSpec<opcode>::Operands(), ip);
+    }
+
+    template<typename... Args>
+    void verify_operands_inner(bytecode::OpcodeOperands<Args...>, size_t& ip)
+    {
+      (check_operand(code_.load<Args>(ip)), ...);
+    }
+
+    void check_operand(bytecode::Register reg)
+    {
+      if (reg.value >= locals_)
+        fail("register out of bounds", instruction_start_);
+    }
+
+    void check_operand(bytecode::RegisterSpan regs)
+    {
+      for (bytecode::Register reg : regs)
+        check_operand(reg);
+    }
+
+    void check_operand(bytecode::RelativeOffset offset)
+    {
+      // A backwards target underflows and a forwards target past the body
+      // overflows the start set; both are rejected once the function has
+      // been fully decoded.
+      jumps_.emplace_back(
+        instruction_start_, instruction_start_ + offset.value);
+    }
+
+    void check_operand(bytecode::AbsoluteOffset offset)
+    {
+      enqueue_function(offset.value);
+    }
+
+    void check_operand(DescriptorIdx desc)
+    {
+      // Throws when the index is invalid.
+      code_.get_descriptor(desc);
+    }
+
+    void check_operand(std::string_view literal)
+    {
+      // Intern every string literal operand, so executing one never
+      // allocates. Print format strings get atoms too; they are small
+      // and this keeps the rule uniform.
+      code_.intern_string(literal);
+    }
+
+    /**
+     * Immediates and enums need no further checks: enum operands are
+     * range-checked by the loader, selector bounds are dynamic.
+     */
+    template<typename T>
+    void check_operand(T)
+    {}
+
+    Code& code_;
+
+    uint8_t locals_ = 0;
+    size_t instruction_start_ = 0;
+    std::unordered_set<size_t> starts_;
+    std::vector<std::pair<size_t, size_t>> jumps_;
+
+    std::unordered_set<size_t> verified_;
+    std::vector<size_t> pending_;
+  };
+
+  void Code::verify()
+  {
+    Verifier(*this).verify_program();
+  }
+}
@@ -3,26 +3,72 @@
 #include "interpreter/vm.h"
 
 #include "interpreter/convert.h"
+#include "interpreter/dispatch_order.h"
 #include "interpreter/format.h"
 #include "interpreter/value_list.h"
 
+#include <algorithm>
 #include <fmt/ranges.h>
+#include <new>
+
+#ifdef _MSC_VER
+#  define WIN32_LEAN_AND_MEAN
+#  define NOMINMAX
+#  include <io.h>
+#  include <windows.h>
+#else
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+/**
+ * The list of opcodes and their handlers, VM_DISPATCH_OPS, lives in
+ * dispatch_order.h: its order is the profile-guided code layout of the
+ * handlers. It drives both the portable switch in `dispatch_opcode` and
+ * the computed-goto table in `dispatch_loop`, so the two cannot drift
+ * apart.
+ */
 
 namespace verona::interpreter
 {
-  void VM::run(std::vector<Value> args, size_t cown_count, size_t start)
+  /**
+   * Saved execution state of a yielded run: the frames it had pushed and
+   * the stack slots they covered, in frame order. Frame bases keep their
+   * original values; resume rebases them onto the stack top of the
+   * re-delivery, which re-entrancy may have moved.
+   */
+  struct VM::Suspension
   {
-    assert(cfstack_.empty());
+    std::vector<Frame> frames;
+    std::vector<Value> values;
+  };
+
+  VM::Suspension* VM::run(
+    Value* args,
+    size_t argc,
+    size_t cown_count,
+    size_t start,
+    rt::Behaviour* behaviour)
+  {
+    // The scheduler may run a behaviour inline, from within the
+    // `opcode_when` that scheduled it (see Cown::schedule_inline). As with
+    // finalisers, the new frame is stacked past the live ones, with no
+    // overlap, and the saved state is restored once it returns.
+    bool old_halt = std::exchange(halt_, false);
+    size_t old_start_ip = std::exchange(start_ip_, start);
+    rt::Behaviour* old_behaviour = std::exchange(behaviour_, behaviour);
+    uint64_t old_fuel = std::exchange(fuel_, YIELD_FUEL);
+    size_t frame_index = cfstack_.size();
+    size_t base = cfstack_.empty() ? 0 : frame().base + frame().locals;
 
-    halt_ = false;
-    push_frame(start, 0, OnReturn::Halt);
+    push_frame(start, base, OnReturn::Halt);
 
-    assert(static_cast<size_t>(frame().argc) == args.size());
+    assert(static_cast<size_t>(frame().argc) == argc);
 
     // First argument is the receiver, followed by cown_count cowns that are
     // being acquired, followed by captures. The cowns need to be transformed
     // so we actually pass their contents to the behaviour instead.
-    for (size_t i = 0; i < args.size(); i++)
+    for (size_t i = 0; i < argc; i++)
     {
       Register reg(truncate<uint8_t>(i));
       Value& value = args[i];
@@ -38,11 +84,98 @@ namespace verona::interpreter
     }
 
     dispatch_loop();
+    flush_fulfills();
+
+    Suspension* suspension = nullptr;
+    if (std::exchange(suspend_, false))
+      suspension = capture_suspension(frame_index);
+
+    halt_ = old_halt;
+    start_ip_ = old_start_ip;
+    behaviour_ = old_behaviour;
+    fuel_ = old_fuel;
+    return suspension;
+  }
+
+  VM::Suspension* VM::resume(rt::Behaviour* behaviour, Suspension* suspension)
+  {
+    bool old_halt = std::exchange(halt_, false);
+    size_t old_start_ip = start_ip_;
+    rt::Behaviour* old_behaviour = std::exchange(behaviour_, behaviour);
+    uint64_t old_fuel = std::exchange(fuel_, YIELD_FUEL);
+    size_t frame_index = cfstack_.size();
+    size_t base = cfstack_.empty() ? 0 : frame().base + frame().locals;
+
+    trace(
+      "Resuming yielded behaviour, {:d} frames at base {:d}",
+      suspension->frames.size(),
+      base);
+
+    // Rebase the saved frames onto the current stack top. Value stack
+    // slots never move once committed (see ValueStack), so the moves
+    // below are the only relocation the saved state needs.
+    size_t old_base = suspension->frames.front().base;
+    grow_stack(base + suspension->values.size());
+    for (Frame f : suspension->frames)
+    {
+      f.base = base + (f.base - old_base);
+      cfstack_.push_back(f);
+    }
+    refresh_window();
+
+    Value* slots = stack_.data();
+    for (size_t i = 0; i < suspension->values.size(); i++)
+      slots[base + i].overwrite(alloc_, std::move(suspension->values[i]));
+
+    delete suspension;
+
+    start_ip_ = frame().ip;
+    dispatch_loop();
+    flush_fulfills();
+
+    Suspension* next = nullptr;
+    if (std::exchange(suspend_, false))
+      next = capture_suspension(frame_index);
+
+    halt_ = old_halt;
+    start_ip_ = old_start_ip;
+    behaviour_ = old_behaviour;
+    fuel_ = old_fuel;
+    return next;
+  }
+
+  VM::Suspension* VM::capture_suspension(size_t frame_index)
+  {
+    auto* suspension = new Suspension();
+
+    size_t base = cfstack_[frame_index].base;
+    size_t top = frame().base + frame().locals;
+
+    trace(
+      "Suspending {:d} frames covering slots {:d}..{:d}",
+      cfstack_.size() - frame_index,
+      base,
+      top);
+
+    suspension->frames.assign(cfstack_.begin() + frame_index, cfstack_.end());
+    cfstack_.resize(frame_index);
+    refresh_window();
+
+    // Moving out leaves the slots UNINIT, ready for whatever is stacked
+    // over them next.
+    suspension->values.reserve(top - base);
+    for (size_t i = base; i < top; i++)
+      suspension->values.push_back(std::move(stack_.data()[i]));
+
+    return suspension;
   }
 
   void VM::push_frame(size_t ip, size_t base, OnReturn on_return)
   {
-    FunctionHeader header = code_.function_header(ip);
+    // The header was decoded by the verifier when the program was loaded;
+    // entering a function is a table lookup rather than a parse.
+    const Code::FunctionInfo& info = code_.function_info(ip);
+    const FunctionHeader& header = info.header;
 
     start_ip_ = ip;
     trace(
@@ -54,7 +187,7 @@ namespace verona::interpreter
       header.locals);
 
     Frame frame;
-    frame.ip = ip;
+    frame.ip = info.body;
     frame.argc = header.argc;
     frame.retc = header.retc;
     frame.locals = header.locals;
@@ -63,18 +196,207 @@ namespace verona::interpreter
 
     grow_stack(frame.base + frame.locals);
     cfstack_.push_back(frame);
+    refresh_window();
+
+    count_invocation(ip);
+  }
+
+  void VM::count_invocation(size_t ip)
+  {
+    uint64_t count = ++invocation_counts_[ip];
+    if (count == HOT_THRESHOLD)
+      function_became_hot(ip);
+
+    if (profile_enabled_)
+    {
+      std::lock_guard<std::mutex> guard(profile_lock_);
+      method_counts_[ip]++;
+    }
   }
 
+  void VM::function_became_hot(size_t ip)
+  {
+    trace(
+      "Function {} is hot ({:d} invocations)",
+      code_.function_info(ip).header.name,
+      HOT_THRESHOLD);
+  }
+
+#ifdef USE_OPCODE_PROFILE
+#  define VM_PROFILE_OP(op) record_dispatch(op)
+#else
+#  define VM_PROFILE_OP(op) ((void)0)
+#endif
+
   void VM::dispatch_loop()
   {
+#ifdef USE_OPCODE_PROFILE
+    // A fresh loop starts a new pair chain; the previous instruction, if
+    // any, belongs to an unrelated behaviour or caller.
+    profile_has_prev_ = false;
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+    // Direct-threaded dispatch: every handler ends with its own indirect
+    // jump to the next handler, so the branch predictor keeps one target
+    // history per opcode rather than sharing a single switch branch.
+    //
+    // The table is indexed by opcode value and filled from VM_DISPATCH_OPS
+    // on entry; opcodes without a handler keep the invalid label. Filling
+    // at run time keeps the table in sync with the enum without relying on
+    // the list being in enum order.
+    const void* table[static_cast<size_t>(Opcode::maximum_value) + 1];
+    for (auto& target : table)
+      target = &&lbl_invalid;
+#  define OP(NAME, FN) table[static_cast<size_t>(Opcode::NAME)] = &&lbl_##NAME;
+    VM_DISPATCH_OPS(OP)
+#  undef OP
+
+    Opcode op{};
+
+    // The verifier has proven every reachable opcode valid, so the fetch
+    // is unchecked and the table is indexed directly. Opcodes without a
+    // handler (Merge) keep the invalid label in the table.
+#  define DISPATCH() \
+    do \
+    { \
+      if (halt_) \
+        return; \
+      start_ip_ = frame().ip; \
+      op = code_.load_unchecked<Opcode>(frame().ip); \
+      VM_PROFILE_OP(op); \
+      record_execution(op); \
+      goto* table[static_cast<size_t>(op)]; \
+    } while (0)
+
+    DISPATCH();
+
+#  define OP(NAME, FN) \
+    lbl_##NAME: \
+    execute_opcode<Opcode::NAME, &VM::FN>(frame().ip); \
+    DISPATCH();
+    VM_DISPATCH_OPS(OP)
+#  undef OP
+
+  lbl_invalid:
+    fatal("Invalid opcode {:#x}", static_cast<int>(op));
+#  undef DISPATCH
+#else
+    // Portable fallback: one switch per instruction.
     while (!halt_)
     {
       start_ip_ = frame().ip;
-      Opcode op = code_.load<Opcode>(frame().ip);
+      Opcode op = code_.load_unchecked<Opcode>(frame().ip);
+      VM_PROFILE_OP(op);
+      record_execution(op);
       dispatch_opcode(op);
     }
+#endif
+  }
+
+  namespace
+  {
+    const char* opcode_label(Opcode op)
+    {
+      switch (op)
+      {
+#define OP(NAME, FN) \
+  case Opcode::NAME: \
+    return #NAME;
+        VM_DISPATCH_OPS(OP)
+#undef OP
+        default:
+          return "?";
+      }
+    }
+  }
+
+  void VM::dump_profile(const Code& code, std::ostream& out)
+  {
+    out << "Kind,Name,Count\n";
+
+    struct Row
+    {
+      std::string name;
+      uint64_t count;
+    };
+    std::vector<Row> rows;
+
+    for (size_t i = 0; i < OPCODE_COUNT; i++)
+    {
+      uint64_t count = opcode_counts_[i].load(std::memory_order_relaxed);
+      if (count != 0)
+        rows.push_back(Row{opcode_label(static_cast<Opcode>(i)), count});
+    }
+
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+      return a.count > b.count;
+    });
+    for (const Row& row : rows)
+      out << "Opcode," << row.name << "," << row.count << "\n";
+
+    rows.clear();
+    {
+      std::lock_guard<std::mutex> guard(profile_lock_);
+      for (const auto& [ip, count] : method_counts_)
+        rows.push_back(
+          Row{std::string(code.function_info(ip).header.name), count});
+    }
+
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+      return a.count > b.count;
+    });
+    for (const Row& row : rows)
+      out << "Method,\"" << row.name << "\"," << row.count << "\n";
+  }
+
+#ifdef USE_OPCODE_PROFILE
+  void VM::record_dispatch(Opcode op)
+  {
+    if (profile_has_prev_)
+    {
+      opcode_pairs_[static_cast<size_t>(profile_prev_)]
+                   [static_cast<size_t>(op)]
+                     .fetch_add(1, std::memory_order_relaxed);
+    }
+    profile_prev_ = op;
+    profile_has_prev_ = true;
   }
 
+  void VM::dump_opcode_profile(std::ostream& out)
+  {
+    struct Pair
+    {
+      Opcode first;
+      Opcode second;
+      uint64_t count;
+    };
+    std::vector<Pair> pairs;
+
+    for (size_t i = 0; i < OPCODE_COUNT; i++)
+    {
+      for (size_t j = 0; j < OPCODE_COUNT; j++)
+      {
+        uint64_t count = opcode_pairs_[i][j].load(std::memory_order_relaxed);
+        if (count != 0)
+          pairs.push_back(
+            Pair{static_cast<Opcode>(i), static_cast<Opcode>(j), count});
+      }
+    }
+
+    std::sort(pairs.begin(), pairs.end(), [](const Pair& a, const Pair& b) {
+      return a.count > b.count;
+    });
+
+    out << "# verona opcode-pair profile v1\n";
+    out << "# first second count\n";
+    for (const Pair& p : pairs)
+    {
+      out << opcode_label(p.first) << " " << opcode_label(p.second) << " "
+          << p.count << "\n";
+    }
+  }
+#endif
+
   void VM::execute_finaliser(VMObject* object)
   {
     // This function gets called by the runtime to execute a finaliser.
@@ -121,41 +443,142 @@ namespace verona::interpreter
     // Run finaliser to completion.
     vm->dispatch_loop();
 
+    // A finaliser can run with no enclosing behaviour, so any promises it
+    // fulfilled are woken here rather than waiting for the next run.
+    vm->flush_fulfills();
+
     vm->halt_ = old_halt;
     vm->start_ip_ = old_start_ip;
   }
 
+  ValueStack::ValueStack()
+  {
+    // Reserve the capacity plus a guard region that is never committed.
+    size_t bytes = MAX_VALUES * sizeof(Value) + COMMIT_BYTES;
+#ifdef _MSC_VER
+    slots_ = static_cast<Value*>(
+      VirtualAlloc(nullptr, bytes, MEM_RESERVE, PAGE_NOACCESS));
+    if (slots_ == nullptr)
+      throw std::bad_alloc();
+#else
+    void* addr =
+      mmap(nullptr, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED)
+      throw std::bad_alloc();
+    slots_ = static_cast<Value*>(addr);
+#endif
+  }
+
+  ValueStack::~ValueStack()
+  {
+    // Committed slots must have been cleared by the VM; their destructor
+    // reports any that were not.
+    for (size_t i = 0; i < size_; i++)
+      slots_[i].~Value();
+
+#ifdef _MSC_VER
+    VirtualFree(slots_, 0, MEM_RELEASE);
+#else
+    munmap(slots_, MAX_VALUES * sizeof(Value) + COMMIT_BYTES);
+#endif
+  }
+
+  void ValueStack::grow(size_t count)
+  {
+    assert(count <= MAX_VALUES);
+    if (count <= size_)
+      return;
+
+    size_t old_bytes = size_ * sizeof(Value);
+    size_t new_bytes = ((count * sizeof(Value)) + COMMIT_BYTES - 1) /
+      COMMIT_BYTES * COMMIT_BYTES;
+
+    char* base = reinterpret_cast<char*>(slots_);
+#ifdef _MSC_VER
+    if (
+      VirtualAlloc(
+        base + old_bytes,
+        new_bytes - old_bytes,
+        MEM_COMMIT,
+        PAGE_READWRITE) == nullptr)
+      throw std::bad_alloc();
+#else
+    if (
+      mprotect(base + old_bytes, new_bytes - old_bytes, PROT_READ | PROT_WRITE)
+      != 0)
+      throw std::bad_alloc();
+#endif
+
+    size_t new_size = new_bytes / sizeof(Value);
+    for (size_t i = size_; i < new_size; i++)
+      new (&slots_[i]) Value();
+    size_ = new_size;
+  }
+
   void VM::grow_stack(size_t size)
   {
-    size = snmalloc::bits::next_pow2(size);
-    if (stack_.size() < size)
-      stack_.resize(size);
+    if (size > ValueStack::MAX_VALUES)
+      fatal("Value stack overflow");
+    stack_.grow(size);
+  }
+
+  void VM::refresh_window()
+  {
+    if (cfstack_.empty())
+      window_ = nullptr;
+    else
+      window_ = stack_.data() + frame().base;
   }
 
+  // Register operands are proven in bounds by the verifier, so accesses
+  // only carry a debug assertion.
   Value& VM::read(Register reg)
   {
-    if (reg.value >= frame().locals)
-    {
-      fatal("Out of bounds stack access (register {})", reg.value);
-    }
-    return stack_.at(frame().base + reg.value);
+    assert(reg.value < frame().locals);
+    return window_[reg.value];
   }
 
   const Value& VM::read(Register reg) const
   {
-    if (reg.value >= frame().locals)
-    {
-      fatal("Out of bounds stack access (register {})", reg.value);
-    }
-    return stack_.at(frame().base + reg.value);
+    assert(reg.value < frame().locals);
+    return window_[reg.value];
   }
 
   void VM::write(Register reg, Value value)
   {
-    if (reg.value >= frame().locals)
-      fatal("Out of bounds stack access (register {})", reg.value);
+    assert(reg.value < frame().locals);
+    window_[reg.value].overwrite(alloc_, std::move(value));
+  }
+
+  VM::InlineCache& VM::inline_cache_slot()
+  {
+    if (start_ip_ >= inline_caches_.size())
+      inline_caches_.resize(start_ip_ + 1);
+    return inline_caches_[start_ip_];
+  }
+
+  uint32_t
+  VM::cached_field_index(const VMDescriptor* descriptor, SelectorIdx selector)
+  {
+    InlineCache& cache = inline_cache_slot();
+    if (cache.descriptor == descriptor)
+      return cache.entry;
+
+    uint32_t index = descriptor->fields.get(selector);
+    cache = {descriptor, index};
+    return index;
+  }
+
+  uint32_t VM::cached_method_address(
+    const VMDescriptor* descriptor, SelectorIdx selector)
+  {
+    InlineCache& cache = inline_cache_slot();
+    if (cache.descriptor == descriptor)
+      return cache.entry;
 
-    stack_.at(frame().base + reg.value).overwrite(alloc_, std::move(value));
+    uint32_t addr = descriptor->methods.get(selector);
+    cache = {descriptor, addr};
+    return addr;
   }
 
   const VMDescriptor* VM::find_dispatch_descriptor(const Value& value) const
@@ -227,6 +650,163 @@ namespace verona::interpreter
     }
   }
 
+  VMArray* VM::array_operand(const Value& value)
+  {
+    check_type(value, {Value::ISO, Value::MUT, Value::IMM});
+
+    if (!value->object->descriptor()->is_array)
+      fatal("Value {} is not an array", value);
+
+    return static_cast<VMArray*>(value->object);
+  }
+
+  void
+  VM::check_array_range(const VMArray* array, uint64_t index, uint64_t count)
+  {
+    // Phrased to be overflow-safe when index + count wraps.
+    if (count > array->length || index > array->length - count)
+      fatal(
+        "Array range [{:d}, {:d}) out of bounds, length is {:d}",
+        index,
+        index + count,
+        array->length);
+  }
+
+  Value VM::opcode_array_compare(
+    const Value& lhs,
+    uint64_t lhs_index,
+    const Value& rhs,
+    uint64_t rhs_index,
+    uint64_t count)
+  {
+    VMArray* lhs_array = array_operand(lhs);
+    VMArray* rhs_array = array_operand(rhs);
+    check_array_range(lhs_array, lhs_index, count);
+    check_array_range(rhs_array, rhs_index, count);
+
+    // Slots are tag/pointer pairs with union padding, so this cannot be a
+    // memcmp. A single dispatch still covers the whole range, which is
+    // what matters against a per-element get/get/compare loop.
+    for (uint64_t i = 0; i < count; i++)
+    {
+      if (!lhs_array->fields[lhs_index + i].equals(
+            rhs_array->fields[rhs_index + i]))
+        return Value::u64(0);
+    }
+    return Value::u64(1);
+  }
+
+  void VM::opcode_array_copy(
+    const Value& dst,
+    uint64_t dst_index,
+    const Value& src,
+    uint64_t src_index,
+    uint64_t count)
+  {
+    check_type(dst, {Value::ISO, Value::MUT});
+
+    VMArray* dst_array = array_operand(dst);
+    VMArray* src_array = array_operand(src);
+    check_array_range(dst_array, dst_index, count);
+    check_array_range(src_array, src_index, count);
+
+    if (count == 0)
+      return;
+
+    if (dst_array->region() == src_array->region())
+    {
+      // Within one region every reference is fair game, so the whole
+      // range is handed to copy_range, which lowers runs of trivial
+      // values to a memmove and handles overlap.
+      FieldValue::copy_range(
+        alloc_,
+        dst_array->region(),
+        &dst_array->fields[dst_index],
+        &src_array->fields[src_index],
+        count,
+        src.tag);
+      return;
+    }
+
+    // Across regions a MUT element would create an unchecked external
+    // reference, exactly as in opcode_array_store.
+    for (uint64_t i = 0; i < count; i++)
+    {
+      Value value = src_array->fields[src_index + i].read(src.tag);
+      if (value.tag == Value::MUT)
+        fatal("Writing reference to incorrect region");
+
+      Value old_value = dst_array->fields[dst_index + i].exchange(
+        alloc_, dst_array->region(), std::move(value));
+      old_value.clear(alloc_);
+    }
+  }
+
+  void VM::opcode_array_fill(
+    const Value& base, uint64_t index, uint64_t count, Value src)
+  {
+    check_type(base, {Value::ISO, Value::MUT});
+    check_type(
+      src, {Value::MUT, Value::IMM, Value::U64, Value::STRING, Value::COWN});
+
+    VMArray* array = array_operand(base);
+    check_array_range(array, index, count);
+
+    if (src.tag == Value::Tag::MUT && array->region() != src->object->region())
+    {
+      fatal("Writing reference to incorrect region");
+    }
+
+    for (uint64_t i = 0; i < count; i++)
+    {
+      // maybe_consume mints an owned copy of `src` for each slot; ISO
+      // values are excluded above, as a region has a single owner.
+      Value old_value = array->fields[index + i].exchange(
+        alloc_, array->region(), src.maybe_consume());
+      old_value.clear(alloc_);
+    }
+
+    src.clear(alloc_);
+  }
+
+  Value VM::opcode_array_length(const Value& base)
+  {
+    return Value::u64(array_operand(base)->length);
+  }
+
+  Value VM::opcode_array_load(const Value& base, uint64_t index)
+  {
+    VMArray* array = array_operand(base);
+    if (index >= array->length)
+      fatal(
+        "Array index {:d} out of bounds, length is {:d}", index, array->length);
+
+    Value value = array->fields[index].read(base.tag);
+    if (value.tag == Value::UNINIT)
+      fatal("Array index {:d} has not been assigned", index);
+
+    return std::move(value);
+  }
+
+  Value VM::opcode_array_store(const Value& base, uint64_t index, Value src)
+  {
+    check_type(base, {Value::ISO, Value::MUT});
+
+    VMArray* array = array_operand(base);
+    if (index >= array->length)
+      fatal(
+        "Array index {:d} out of bounds, length is {:d}", index, array->length);
+
+    if (src.tag == Value::Tag::MUT && array->region() != src->object->region())
+    {
+      fatal("Writing reference to incorrect region");
+    }
+
+    Value old_value =
+      array->fields[index].exchange(alloc_, array->region(), std::move(src));
+    return std::move(old_value);
+  }
+
   Value
   VM::opcode_binop(bytecode::BinaryOperator op, uint64_t left, uint64_t right)
   {
@@ -282,7 +862,7 @@ namespace verona::interpreter
     const Value& receiver = read(Register(frame().locals - callspace));
     const VMDescriptor* descriptor = find_dispatch_descriptor(receiver);
 
-    size_t addr = descriptor->methods[selector.value];
+    size_t addr = cached_method_address(descriptor, selector);
     size_t base = frame().base + frame().locals - callspace;
 
     push_frame(addr, base, OnReturn::Continue);
@@ -297,6 +877,93 @@ namespace verona::interpreter
     }
   }
 
+  void VM::opcode_call_direct(AbsoluteOffset target, uint8_t callspace)
+  {
+    if (callspace == 0)
+      fatal("Not enough call space to find a receiver");
+    if (callspace > frame().locals)
+      fatal("Call space does not fit in current frame");
+
+    // The target was resolved at compile time; the receiver stays in the
+    // first callspace register but takes no part in dispatch.
+    size_t base = frame().base + frame().locals - callspace;
+
+    push_frame(target.value, base, OnReturn::Continue);
+
+    if (callspace < frame().argc || callspace < frame().retc)
+    {
+      fatal(
+        "Call space is too small: callspace={:d}, argc={:d}, retc={:d}",
+        callspace,
+        frame().argc,
+        frame().retc);
+    }
+  }
+
+  void VM::opcode_tailcall(SelectorIdx selector, uint8_t callspace)
+  {
+    if (callspace == 0)
+      fatal("Not enough call space to find a receiver");
+    if (callspace > frame().locals)
+      fatal("Call space does not fit in current frame");
+
+    // Dispatch on the receiver, exactly as Call does.
+    const Value& receiver = read(Register(frame().locals - callspace));
+    const VMDescriptor* descriptor = find_dispatch_descriptor(receiver);
+    size_t addr = cached_method_address(descriptor, selector);
+
+    // The frame is reused, so every register below the argument window
+    // must already be cleared, mirroring the contract opcode_return
+    // enforces on the rest of the frame.
+    for (int i = 0; i < frame().locals - callspace; i++)
+    {
+      Value& value = read(Register(i));
+      switch (value.tag)
+      {
+        case Value::UNINIT:
+          break;
+
+        case Value::DESCRIPTOR:
+        case Value::U64:
+          // See opcode_return: codegen does not end the scope of these.
+          value.clear(alloc_);
+          break;
+
+        default:
+          fatal("Register {} was not cleared: {}", i, value);
+          break;
+      }
+    }
+
+    // Slide the arguments down to the base of the frame. The windows may
+    // overlap, but the destination is always at or below the source, so
+    // an ascending move never reads a slot it has written.
+    for (size_t i = 0; i < callspace; i++)
+    {
+      write(
+        Register(i),
+        std::move(read(Register(frame().locals - callspace + i))));
+    }
+
+    // Replace the current frame rather than stacking a new one; the
+    // callee returns straight to this frame's caller, which makes
+    // self-recursive loops run in constant stack space.
+    OnReturn on_return = frame().on_return;
+    uint8_t retc = frame().retc;
+    size_t base = frame().base;
+    cfstack_.pop_back();
+    push_frame(addr, base, on_return);
+
+    if (callspace < frame().argc || frame().retc > retc)
+    {
+      fatal(
+        "Tail call space is too small: callspace={:d}, argc={:d}, retc={:d}",
+        callspace,
+        frame().argc,
+        frame().retc);
+    }
+  }
+
   Value VM::opcode_clear()
   {
     return Value();
@@ -316,8 +983,28 @@ namespace verona::interpreter
 
     cown->cown->contents = result.consume_iso();
 
+    // The reference acquired here keeps the cown alive until the batch is
+    // flushed, then transfers to the scheduler queue.
     rt::Cown::acquire(cown->cown);
-    cown->cown->schedule();
+    pending_fulfills_.push_back(cown->cown);
+  }
+
+  /**
+   * Wake the promise cowns fulfilled since the last flush.
+   *
+   * Scatter-gather code fulfills many promises from a single behaviour;
+   * deferring the wakeups to the end of the run pays the scheduler
+   * interaction once for the whole batch (see Cown::schedule_many)
+   * instead of once per promise.
+   */
+  void VM::flush_fulfills()
+  {
+    if (pending_fulfills_.empty())
+      return;
+
+    rt::Cown::schedule_many(
+      pending_fulfills_.size(), pending_fulfills_.data());
+    pending_fulfills_.clear();
   }
 
   Value VM::opcode_freeze(Value src)
@@ -341,7 +1028,41 @@ namespace verona::interpreter
 
   Value VM::opcode_string(std::string_view imm)
   {
-    return Value::string(imm);
+    // Literals are interned at load time; this only acquires a reference
+    // to the atom.
+    return Value::string(code_.interned_string(imm));
+  }
+
+  Value VM::opcode_string_op(
+    bytecode::StringOperator op, const Value& lhs, const Value& rhs)
+  {
+    check_type(lhs, Value::STRING);
+    check_type(rhs, Value::STRING);
+
+    const VMString* left = lhs->string_ptr;
+    const VMString* right = rhs->string_ptr;
+
+    switch (op)
+    {
+      case bytecode::StringOperator::Eq:
+        return Value::u64(left->equals(*right));
+      case bytecode::StringOperator::Ne:
+        return Value::u64(!left->equals(*right));
+      case bytecode::StringOperator::Lt:
+        return Value::u64(left->compare(*right) < 0);
+      case bytecode::StringOperator::Le:
+        return Value::u64(left->compare(*right) <= 0);
+      case bytecode::StringOperator::Gt:
+        return Value::u64(left->compare(*right) > 0);
+      case bytecode::StringOperator::Ge:
+        return Value::u64(left->compare(*right) >= 0);
+      case bytecode::StringOperator::Find:
+        return Value::u64(left->find(*right));
+      case bytecode::StringOperator::Hash:
+        return Value::u64(left->hash());
+
+        EXHAUSTIVE_SWITCH;
+    }
   }
 
   void VM::opcode_jump(RelativeOffset offset)
@@ -355,13 +1076,30 @@ namespace verona::interpreter
       frame().ip = start_ip_ + offset.value;
   }
 
+  void VM::opcode_yield()
+  {
+    // Emitted by the code generator at loop back-edges. Outside a
+    // behaviour (the entrypoint, finalisers, direct runs) there is
+    // nothing to requeue to, so the opcode is free beyond the decrement.
+    if (behaviour_ == nullptr || --fuel_ != 0)
+      return;
+
+    trace("Yielding behaviour at loop back-edge");
+
+    // Checkpoint: halt the dispatch loop and have the innermost run or
+    // resume lift this run's frames into a Suspension. The behaviour is
+    // requeued on its cowns by ExecuteMessage::f.
+    suspend_ = true;
+    halt_ = true;
+  }
+
   Value VM::opcode_load(const Value& base, SelectorIdx selector)
   {
     check_type(base, {Value::ISO, Value::MUT, Value::IMM});
 
     VMObject* object = base->object;
     const VMDescriptor* descriptor = object->descriptor();
-    size_t index = descriptor->fields[selector.value];
+    size_t index = cached_field_index(descriptor, selector);
 
     Value value = object->fields[index].read(base.tag);
     return std::move(value);
@@ -373,6 +1111,63 @@ namespace verona::interpreter
     return Value::descriptor(descriptor);
   }
 
+  VMMap* VM::map_operand(const Value& value)
+  {
+    check_type(value, {Value::ISO, Value::MUT, Value::IMM});
+
+    if (!value->object->descriptor()->is_map)
+      fatal("Value {} is not a map", value);
+
+    return static_cast<VMMap*>(value->object);
+  }
+
+  Value VM::opcode_map_contains(const Value& map, const Value& key)
+  {
+    return Value::u64(map_operand(map)->lookup(key) != nullptr);
+  }
+
+  Value VM::opcode_map_get(const Value& map, const Value& key)
+  {
+    VMMap* object = map_operand(map);
+    FieldValue* slot = object->lookup(key);
+    if (slot == nullptr)
+      fatal("Map does not contain key {}", key);
+
+    return slot->read(map.tag);
+  }
+
+  Value VM::opcode_map_insert(const Value& map, Value key, Value value)
+  {
+    check_type(map, {Value::ISO, Value::MUT});
+
+    VMMap* object = map_operand(map);
+    if (key.tag == Value::Tag::MUT && object->region() != key->object->region())
+    {
+      fatal("Writing reference to incorrect region");
+    }
+    if (
+      value.tag == Value::Tag::MUT &&
+      object->region() != value->object->region())
+    {
+      fatal("Writing reference to incorrect region");
+    }
+
+    FieldValue& slot = object->insert(alloc_, std::move(key));
+    Value old_value = slot.exchange(alloc_, object->region(), std::move(value));
+    return std::move(old_value);
+  }
+
+  Value VM::opcode_map_remove(const Value& map, const Value& key)
+  {
+    check_type(map, {Value::ISO, Value::MUT});
+    return Value::u64(map_operand(map)->remove(alloc_, key));
+  }
+
+  Value VM::opcode_map_size(const Value& map)
+  {
+    return Value::u64(map_operand(map)->size());
+  }
+
   Value VM::opcode_match_descriptor(const Value& src, const VMDescriptor* desc)
   {
     const VMDescriptor* src_descriptor = find_match_descriptor(src);
@@ -383,7 +1178,7 @@ namespace verona::interpreter
     if (src_descriptor == nullptr)
       result = 0;
     else
-      result = desc->subtypes.count(src_descriptor->index) > 0;
+      result = desc->matches(src_descriptor->index);
 
     trace(" Matching {} against {} = {}", src, desc->name, result);
     return Value::u64(result);
@@ -432,6 +1227,31 @@ namespace verona::interpreter
     return Value::mut(src->object);
   }
 
+  Value VM::opcode_new_array(
+    const Value& parent, const VMDescriptor* descriptor, uint64_t length)
+  {
+    check_type(parent, {Value::ISO, Value::MUT});
+
+    if (!descriptor->is_array)
+      fatal("Descriptor {} is not an array descriptor", descriptor->name);
+
+    VMObject* region = parent->object->region();
+    rt::Object* object = rt::Region::alloc(alloc_, region, descriptor);
+    return Value::mut(new (object) VMArray(region, descriptor, length));
+  }
+
+  Value VM::opcode_new_map(const Value& parent, const VMDescriptor* descriptor)
+  {
+    check_type(parent, {Value::ISO, Value::MUT});
+
+    if (!descriptor->is_map)
+      fatal("Descriptor {} is not a map descriptor", descriptor->name);
+
+    VMObject* region = parent->object->region();
+    rt::Object* object = rt::Region::alloc(alloc_, region, descriptor);
+    return Value::mut(new (object) VMMap(region, descriptor));
+  }
+
   Value
   VM::opcode_new_object(const Value& parent, const VMDescriptor* descriptor)
   {
@@ -473,14 +1293,113 @@ namespace verona::interpreter
     rt::RegionTrace::gc(alloc_, region);
   }
 
+  namespace
+  {
+    /// Write the whole buffer to `fd`, retrying short writes. Print
+    /// output is diagnostic, so errors are swallowed rather than fatal.
+    void write_all(int fd, const char* data, size_t size)
+    {
+      while (size > 0)
+      {
+#ifdef _MSC_VER
+        auto written = _write(fd, data, static_cast<unsigned>(size));
+#else
+        auto written = ::write(fd, data, size);
+#endif
+        if (written <= 0)
+          return;
+
+        data += written;
+        size -= static_cast<size_t>(written);
+      }
+    }
+  }
+
+  void VM::set_print_fd(int fd)
+  {
+    flush_print();
+    std::lock_guard<std::mutex> guard(print_lock_);
+    print_fd_ = fd;
+    print_buffer_.reserve(PRINT_BUFFER_SIZE);
+  }
+
+  void VM::flush_print()
+  {
+    std::lock_guard<std::mutex> guard(print_lock_);
+    if (print_fd_ < 0 || print_buffer_.empty())
+      return;
+
+    write_all(print_fd_, print_buffer_.data(), print_buffer_.size());
+    print_buffer_.clear();
+  }
+
+  bool VM::buffered_print(const char* data, size_t size)
+  {
+    std::lock_guard<std::mutex> guard(print_lock_);
+    if (print_fd_ < 0)
+      return false;
+
+    if (print_buffer_.size() + size > PRINT_BUFFER_SIZE)
+    {
+      write_all(print_fd_, print_buffer_.data(), print_buffer_.size());
+      print_buffer_.clear();
+
+      // Oversized prints go straight out rather than through the buffer.
+      if (size > PRINT_BUFFER_SIZE)
+      {
+        write_all(print_fd_, data, size);
+        return true;
+      }
+    }
+
+    print_buffer_.insert(print_buffer_.end(), data, data + size);
+    return true;
+  }
+
   void VM::opcode_print(std::string_view fmt, ConstValueList values)
   {
+    const PrintFormat* pf = code_.print_format(fmt);
+    if (pf != nullptr && pf->fast && pf->arg_count <= values.size())
+    {
+      // Literal format, preprocessed when the program was loaded: copy
+      // the literal runs and format the arguments, no parsing.
+      fmt::memory_buffer buf;
+      for (const auto& seg : pf->segments)
+      {
+        buf.append(
+          seg.literal.data(), seg.literal.data() + seg.literal.size());
+        if (seg.arg != PrintFormat::NO_ARG)
+        {
+          if (seg.deep)
+            fmt::format_to(std::back_inserter(buf), "{:#}", values[seg.arg]);
+          else
+            fmt::format_to(std::back_inserter(buf), "{}", values[seg.arg]);
+        }
+      }
+
+      if (!buffered_print(buf.data(), buf.size()))
+        std::fwrite(buf.data(), 1, buf.size(), stdout);
+      return;
+    }
+
+    // A string computed at run time, a spec the segment list cannot
+    // express, or too few arguments (fmt reports the error): parse the
+    // format here.
     fmt::dynamic_format_arg_store<fmt::format_context> store;
     for (const Value& value : values)
     {
       store.push_back(std::cref(value));
     }
-    fmt::vprint(fmt, store);
+
+    if (print_fd_ >= 0)
+    {
+      auto out = fmt::vformat(fmt, store);
+      buffered_print(out.data(), out.size());
+    }
+    else
+    {
+      fmt::vprint(fmt, store);
+    }
   }
 
   void VM::opcode_return()
@@ -525,6 +1444,7 @@ namespace verona::interpreter
       fatal("Cannot return of top-most frame");
     }
     cfstack_.pop_back();
+    refresh_window();
   }
 
   Value VM::opcode_store(const Value& base, SelectorIdx selector, Value src)
@@ -533,7 +1453,7 @@ namespace verona::interpreter
 
     VMObject* object = base->object;
     const VMDescriptor* desc = object->descriptor();
-    size_t index = desc->fields[selector.value];
+    size_t index = cached_field_index(desc, selector);
 
     if (src.tag == Value::Tag::MUT && object->region() != src->object->region())
     {
@@ -554,8 +1474,7 @@ namespace verona::interpreter
     if (callspace > frame().locals)
       fatal("Call space does not fit in current frame");
 
-    size_t addr = offset.value;
-    FunctionHeader header = code_.function_header(addr);
+    const FunctionHeader& header = code_.function_info(offset.value).header;
 
     if (callspace > header.argc)
     {
@@ -569,42 +1488,70 @@ namespace verona::interpreter
     // We use this to copy these values into the message
     size_t base = frame().locals - callspace;
 
-    // Prepare the cowns and the arguments for the method invocation.
-    std::vector<Value> args;
+    // Captured values move into the message's capture block as they are.
+    // In particular an ISO capture hands its whole region over
+    // pointer-only: no freeze, no copy, just the entry-object pointer
+    // riding the message until the receiving run moves it into a register.
+    // Only sendable values may cross; a MUT would leave the sender with
+    // aliases into a region now owned by another thread. The compiler
+    // rejects that statically, but bytecode need not come from our
+    // compiler, so the tags are checked here like every other opcode's.
+    // Checked before the direct-run fast path, so invalid bytecode does
+    // not slip through when the cown happens to be idle.
+    for (size_t i = 0; i < capture_count; i++)
+    {
+      const Value& v =
+        read(Register(truncate<uint8_t>(base + 1 + cown_count + i)));
+      if (v.tag == Value::MUT || v.tag == Value::COWN_UNOWNED)
+        fatal("Capturing non-sendable value {} in `when`", v);
+
+      if (v.tag == Value::ISO)
+        trace("Transferring ownership of region {} through message", v);
+    }
+
+    // A `when` over a single idle cown runs synchronously: the runtime
+    // acquires the cown by waking its sleeping queue, and the captures
+    // move register-to-register into a fresh frame, without a message or
+    // closure ever being allocated.
+    if (cown_count == 1)
+    {
+      Value& v = read(Register(truncate<uint8_t>(base + 1)));
+      check_type(v, Value::COWN);
+
+      if (rt::Cown::try_run_direct(v->cown, [&] {
+            run_when_direct(offset.value, base, capture_count);
+          }))
+      {
+        // Drop our reference to the cown; no message took ownership of it.
+        read(Register(truncate<uint8_t>(base + 1))).clear(alloc_);
+        return;
+      }
+    }
+
+    // Prepare the cowns for the method invocation, replacing each COWN
+    // register with an unowned view so the registers form the capture
+    // block of the message.
     std::vector<rt::Cown*> cowns;
-    args.reserve(header.argc);
     cowns.reserve(cown_count);
 
-    // First argument is a placeholder for the receiver.
-    args.push_back(Value());
-
-    // The rest are the cowns
     for (size_t i = 0; i < cown_count; i++)
     {
       Value& v = read(Register(truncate<uint8_t>(base + 1 + i)));
       trace("Capturing cown {:d}: {}", i, v);
       check_type(v, Value::COWN);
 
-      // Push the body of the cown into the message, as an unowned cown. The
-      // runtime will be holding a reference to the cown for us, so no need to
-      // have our own.
+      // The message captures the cown unowned. The runtime will be holding
+      // a reference to the cown for us, so no need to have our own.
       //
       // We can't look up the pointer to the cown's contents, since for promise
       // cowns it is not set until the promise is fulfilled.
-      args.push_back(v.as_unowned_cown());
+      Value unowned = v.as_unowned_cown();
 
       // Transfer ownership of the cown from `v` into the `cowns` vector. The
       // runtime will hold on to the references until after the message is
       // executed.
       cowns.push_back(v.consume_cown());
-    }
-
-    // The rest are the captured values
-    for (size_t i = 0; i < capture_count; i++)
-    {
-      Value& v = read(Register(truncate<uint8_t>(base + 1 + cown_count + i)));
-      trace("Capturing variable {:d}: {}", i + cown_count, v);
-      args.push_back(std::move(v));
+      v.overwrite(alloc_, std::move(unowned));
     }
 
     trace(
@@ -616,8 +1563,51 @@ namespace verona::interpreter
       cowns.push_back(new VMCown(nullptr, nullptr));
     }
 
+    // The cown and capture registers are moved straight into the message's
+    // capture block, which lives in the same allocation as the message
+    // body; a placeholder receiver is created in front of them.
     rt::Cown::schedule<ExecuteMessage, rt::YesTransfer>(
-      cowns.size(), cowns.data(), offset.value, std::move(args), cown_count);
+      cowns.size(),
+      cowns.data(),
+      offset.value,
+      size_t(callspace),
+      size_t(cown_count),
+      Value(),
+      callspace > 1 ? &read(Register(truncate<uint8_t>(base + 1))) : nullptr);
+  }
+
+  void VM::run_when_direct(size_t start, size_t base, uint8_t capture_count)
+  {
+    // Modeled on execute_finaliser: save the state that isn't in stacks,
+    // stack a "halt on return" frame past the live ones and run it to
+    // completion.
+    bool old_halt = std::exchange(halt_, false);
+    size_t old_start_ip = std::exchange(start_ip_, start);
+
+    // Value stack slots never move (see ValueStack), so the caller's
+    // capture registers stay valid across the frame push and are moved
+    // slot-to-slot into the callee.
+    Value* src = &read(Register(truncate<uint8_t>(base)));
+
+    push_frame(start, frame().base + frame().locals, OnReturn::Halt);
+
+    // Receiver placeholder.
+    write(Register(0), Value());
+
+    // The acquired cown's contents; the runtime holds the cown itself for
+    // the duration of the run.
+    write(Register(1), src[1].cown_body());
+
+    for (size_t i = 0; i < capture_count; i++)
+    {
+      trace("Capturing variable {:d}: {}", i + 1, src[2 + i]);
+      write(Register(truncate<uint8_t>(2 + i)), std::move(src[2 + i]));
+    }
+
+    dispatch_loop();
+
+    halt_ = old_halt;
+    start_ip_ = old_start_ip;
   }
 
   void VM::opcode_protect(ConstValueList values)
@@ -657,6 +1647,47 @@ namespace verona::interpreter
     fatal("Reached unreachable opcode");
   }
 
+  /**
+   * Fused superinstruction handlers. Each one performs both component
+   * writes, making it exactly equivalent to the pair of instructions it
+   * replaces, in a single dispatch. The binop operands are read after the
+   * first write, as they may name its destination register.
+   */
+  void VM::opcode_int64_binop(
+    Register imm_dst,
+    uint64_t imm,
+    Register dst,
+    bytecode::BinaryOperator op,
+    Register left,
+    Register right)
+  {
+    write(imm_dst, opcode_int64(imm));
+    uint64_t l = convert_operand<uint64_t>::convert(this, left);
+    uint64_t r = convert_operand<uint64_t>::convert(this, right);
+    write(dst, opcode_binop(op, l, r));
+  }
+
+  void VM::opcode_load_binop(
+    Register load_dst,
+    Register base,
+    SelectorIdx selector,
+    Register dst,
+    bytecode::BinaryOperator op,
+    Register left,
+    Register right)
+  {
+    write(load_dst, opcode_load(read(base), selector));
+    uint64_t l = convert_operand<uint64_t>::convert(this, left);
+    uint64_t r = convert_operand<uint64_t>::convert(this, right);
+    write(dst, opcode_binop(op, l, r));
+  }
+
+  void VM::opcode_copy_jump(Register dst, Register src, RelativeOffset offset)
+  {
+    write(dst, opcode_copy(convert_operand<Value>::convert(this, src)));
+    opcode_jump(offset);
+  }
+
   void VM::dispatch_opcode(Opcode op)
   {
     switch (op)
@@ -666,35 +1697,7 @@ namespace verona::interpreter
     execute_opcode<Opcode::NAME, &VM::FN>(frame().ip); \
     break;
 
-      OP(BinOp, opcode_binop);
-      OP(Call, opcode_call);
-      OP(Clear, opcode_clear);
-      OP(ClearList, opcode_clear_list);
-      OP(Copy, opcode_copy);
-      OP(FulfillSleepingCown, opcode_fulfill_sleeping_cown);
-      OP(Freeze, opcode_freeze);
-      OP(Int64, opcode_int64);
-      OP(Jump, opcode_jump);
-      OP(JumpIf, opcode_jump_if);
-      OP(Load, opcode_load);
-      OP(LoadDescriptor, opcode_load_descriptor);
-      OP(MatchCapability, opcode_match_capability);
-      OP(MatchDescriptor, opcode_match_descriptor);
-      OP(Move, opcode_move);
-      OP(MutView, opcode_mut_view);
-      OP(NewObject, opcode_new_object);
-      OP(NewRegion, opcode_new_region);
-      OP(NewSleepingCown, opcode_new_sleeping_cown);
-      OP(NewCown, opcode_new_cown);
-      OP(Print, opcode_print);
-      OP(Protect, opcode_protect);
-      OP(Return, opcode_return);
-      OP(Store, opcode_store);
-      OP(String, opcode_string);
-      OP(TraceRegion, opcode_trace_region);
-      OP(When, opcode_when);
-      OP(Unprotect, opcode_unprotect);
-      OP(Unreachable, opcode_unreachable);
+      VM_DISPATCH_OPS(OP)
 
 #undef OP
 
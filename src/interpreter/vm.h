@@ -4,8 +4,11 @@
 
 #include "interpreter/code.h"
 
+#include <atomic>
 #include <fmt/core.h>
 #include <fmt/ostream.h>
+#include <mutex>
+#include <utility>
 
 namespace verona::interpreter
 {
@@ -19,7 +22,74 @@ namespace verona::interpreter
   using ValueList = BaseValueList<false>;
   using ConstValueList = BaseValueList<true>;
 
-  class VM
+  /**
+   * Contiguous stack of Values backing the VM's register frames.
+   *
+   * The whole capacity is reserved from the OS up front and committed in
+   * fixed-size steps as the stack grows, so slot addresses never change:
+   * pointers into the stack stay valid across growth, which finaliser
+   * re-entrancy relies on. The uncommitted tail of the reservation acts
+   * as a guard region, turning a runaway recursion that escapes the
+   * explicit overflow check into an immediate fault rather than silent
+   * corruption.
+   *
+   * Frames are views into this stack; pushing one only touches the OS
+   * when the stack reaches a new maximum depth.
+   */
+  class ValueStack
+  {
+  public:
+    ValueStack();
+    ~ValueStack();
+
+    ValueStack(const ValueStack&) = delete;
+    ValueStack& operator=(const ValueStack&) = delete;
+
+    /**
+     * Maximum depth of the stack, in Values. Only virtual address space
+     * is reserved for this up front; memory is committed as the stack
+     * grows.
+     */
+    static constexpr size_t MAX_VALUES = 1 << 22;
+
+    /**
+     * Ensure the first `count` slots are committed and constructed.
+     * `count` must not exceed MAX_VALUES.
+     */
+    void grow(size_t count);
+
+    size_t size() const
+    {
+      return size_;
+    }
+
+    Value* data()
+    {
+      return slots_;
+    }
+
+  private:
+    /**
+     * Granularity at which the reservation is committed; a multiple of
+     * the page size on all supported platforms.
+     */
+    static constexpr size_t COMMIT_BYTES = 64 * 1024;
+
+    Value* slots_;
+    size_t size_ = 0;
+  };
+
+  /**
+   * Per-thread execution engine over a shared Code.
+   *
+   * All program state — descriptors, function headers, interned atoms —
+   * is read through `code_` and shared by every VM; everything the VM
+   * writes while running (register stacks, inline caches, invocation
+   * counts) is per-thread. The class is cache-line aligned so one
+   * thread's mutable state never shares a line with a neighbouring
+   * allocation another thread is writing.
+   */
+  class alignas(rt::CACHE_LINE_SIZE) VM
   {
   public:
     VM(const Code& code, bool verbose)
@@ -39,14 +109,47 @@ namespace verona::interpreter
       local_vm = new VM(*code, verbose);
     }
 
+    /**
+     * Saved execution state of a run that yielded: the frames it had
+     * pushed and the values in their registers, lifted off the VM's
+     * stacks. Opaque to the owner; produced by `run` or `resume` and
+     * consumed by `resume`.
+     */
+    struct Suspension;
+
     /**
      * Run the VM from the given address.
      *
-     * Puts args on the stack.
+     * Moves the `argc` values at `args` into the new frame's registers.
      *
-     * Keeps fetching and executing instructions until the VM halts.
+     * Keeps fetching and executing instructions until the frame returns.
+     * May be invoked re-entrantly, when the scheduler runs a behaviour
+     * inline from within `opcode_when`: the new frame is stacked past the
+     * live ones, and the previous state is restored on completion.
+     *
+     * `behaviour` is the behaviour this run executes on behalf of, if
+     * any. When it is set and the run crosses enough loop back-edges (see
+     * `opcode_yield`), the run checkpoints instead of completing and the
+     * suspended state is returned; the caller requeues the behaviour and
+     * passes the state to `resume` on re-delivery. Returns null when the
+     * run completed.
+     */
+    Suspension* run(
+      Value* args,
+      size_t argc,
+      size_t cown_count,
+      size_t start,
+      rt::Behaviour* behaviour = nullptr);
+
+    /**
+     * Continue a yielded run from its suspension, which is consumed.
+     *
+     * The saved frames are rebased onto the current top of the stacks:
+     * re-entrancy may have changed the depth since the run yielded.
+     * Returns the new suspension if the run yielded again, null when it
+     * completed.
      */
-    void run(std::vector<Value> args, size_t cown_count, size_t start);
+    Suspension* resume(rt::Behaviour* behaviour, Suspension* suspension);
 
     /**
      * Run finaliser for this VM object.
@@ -60,23 +163,66 @@ namespace verona::interpreter
     static void execute_finaliser(VMObject* object);
 
   private:
+    Value opcode_array_compare(
+      const Value& lhs,
+      uint64_t lhs_index,
+      const Value& rhs,
+      uint64_t rhs_index,
+      uint64_t count);
+    void opcode_array_copy(
+      const Value& dst,
+      uint64_t dst_index,
+      const Value& src,
+      uint64_t src_index,
+      uint64_t count);
+    void opcode_array_fill(
+      const Value& base, uint64_t index, uint64_t count, Value src);
+    Value opcode_array_length(const Value& base);
+    Value opcode_array_load(const Value& base, uint64_t index);
+    Value opcode_array_store(const Value& base, uint64_t index, Value src);
     Value
     opcode_binop(bytecode::BinaryOperator op, uint64_t left, uint64_t right);
     void opcode_call(SelectorIdx selector, uint8_t callspace);
+    void opcode_call_direct(AbsoluteOffset target, uint8_t callspace);
     Value opcode_clear();
     void opcode_clear_list(ValueList values);
     Value opcode_copy(Value src);
+    void opcode_copy_jump(Register dst, Register src, RelativeOffset offset);
     void opcode_fulfill_sleeping_cown(const Value& cown, Value result);
+    void flush_fulfills();
     Value opcode_freeze(Value src);
     Value opcode_int64(uint64_t imm);
+    void opcode_int64_binop(
+      Register imm_dst,
+      uint64_t imm,
+      Register dst,
+      bytecode::BinaryOperator op,
+      Register left,
+      Register right);
     void opcode_jump(RelativeOffset offset);
     void opcode_jump_if(uint64_t condition, RelativeOffset offset);
     Value opcode_load(const Value& base, SelectorIdx selector);
+    void opcode_load_binop(
+      Register load_dst,
+      Register base,
+      SelectorIdx selector,
+      Register dst,
+      bytecode::BinaryOperator op,
+      Register left,
+      Register right);
     Value opcode_load_descriptor(DescriptorIdx desc_idx);
+    Value opcode_map_contains(const Value& map, const Value& key);
+    Value opcode_map_get(const Value& map, const Value& key);
+    Value opcode_map_insert(const Value& map, Value key, Value value);
+    Value opcode_map_remove(const Value& map, const Value& key);
+    Value opcode_map_size(const Value& map);
     Value opcode_match_descriptor(const Value& src, const VMDescriptor* desc);
     Value opcode_match_capability(const Value& src, bytecode::Capability cap);
     Value opcode_move(Register src);
     Value opcode_mut_view(const Value& src);
+    Value opcode_new_array(
+      const Value& parent, const VMDescriptor* descriptor, uint64_t length);
+    Value opcode_new_map(const Value& parent, const VMDescriptor* descriptor);
     Value
     opcode_new_object(const Value& parent, const VMDescriptor* descriptor);
     Value opcode_new_region(const VMDescriptor* descriptor);
@@ -88,10 +234,23 @@ namespace verona::interpreter
     void opcode_return();
     Value opcode_store(const Value& base, SelectorIdx selector, Value src);
     Value opcode_string(std::string_view imm);
+    Value opcode_string_op(
+      bytecode::StringOperator op, const Value& lhs, const Value& rhs);
+    void opcode_tailcall(SelectorIdx selector, uint8_t callspace);
     void opcode_trace_region(const Value& region);
     void opcode_when(
       AbsoluteOffset offset, uint8_t cown_count, uint8_t capture_count);
     void opcode_unreachable();
+    void opcode_yield();
+
+    /**
+     * Body of a single-cown `when` whose target was acquired directly by
+     * the runtime (see Cown::try_run_direct). Stacks a fresh frame past
+     * the live ones, moving the captures straight from the caller's
+     * registers into it, and runs it to completion. `base` is the first
+     * register of the caller's callspace.
+     */
+    void run_when_direct(size_t start, size_t base, uint8_t capture_count);
 
     enum class OnReturn
     {
@@ -130,10 +289,32 @@ namespace verona::interpreter
 
     void grow_stack(size_t size);
 
+    /**
+     * Resolve a selector against a descriptor's field or method table,
+     * through the inline cache of the executing instruction.
+     *
+     * Each call site remembers the last descriptor it saw together with
+     * the resolved table entry; a monomorphic site skips the table lookup
+     * with a single pointer compare.
+     */
+    uint32_t
+    cached_field_index(const VMDescriptor* descriptor, SelectorIdx selector);
+    uint32_t
+    cached_method_address(const VMDescriptor* descriptor, SelectorIdx selector);
+
+    /**
+     * Rebuild the register window for the current frame.
+     *
+     * Must be called whenever the current frame changes, ie. after a frame
+     * is pushed or popped.
+     */
+    void refresh_window();
+
     /**
      * Read the value of a register, relative to the current frame.
      *
-     * Aborts the VM if the register is out of bounds.
+     * The verifier proves register operands in bounds, so this only
+     * carries a debug assertion.
      */
     Value& read(Register reg);
     const Value& read(Register reg) const;
@@ -141,7 +322,8 @@ namespace verona::interpreter
     /**
      * Write a value to a register, relative to the current frame.
      *
-     * Aborts the VM if the register is out of bounds.
+     * The verifier proves register operands in bounds, so this only
+     * carries a debug assertion.
      */
     void write(Register reg, Value value);
 
@@ -188,6 +370,25 @@ namespace verona::interpreter
     void check_type(const Value& value, Value::Tag expected);
     void check_type(const Value& value, std::vector<Value::Tag> expected);
 
+    /**
+     * Check that `value` refers to an array object and return it.
+     * Aborts the VM otherwise.
+     */
+    VMArray* array_operand(const Value& value);
+
+    /**
+     * Check that `value` refers to a map object and return it.
+     * Aborts the VM otherwise.
+     */
+    VMMap* map_operand(const Value& value);
+
+    /**
+     * Check that `[index, index + count)` lies within `array`.
+     * Aborts the VM otherwise.
+     */
+    void
+    check_array_range(const VMArray* array, uint64_t index, uint64_t count);
+
     const Code& code_;
     rt::Alloc* const alloc_;
     const bool verbose_;
@@ -210,6 +411,38 @@ namespace verona::interpreter
      */
     bool halt_;
 
+    /**
+     * The behaviour the innermost run/resume executes on behalf of, or
+     * null when execution was not started by a behaviour (the program
+     * entrypoint, finalisers, direct runs). Only a behaviour-backed run
+     * can yield: there is nothing to requeue otherwise.
+     */
+    rt::Behaviour* behaviour_ = nullptr;
+
+    /**
+     * Set by opcode_yield alongside halt_; tells the innermost run/resume
+     * to capture its frames into a Suspension instead of treating the
+     * halt as completion.
+     */
+    bool suspend_ = false;
+
+    /**
+     * Loop back-edges left before a behaviour-backed run checkpoints.
+     * Every Yield opcode costs one; a behaviour that loops for a long
+     * time eventually hands its cowns back to the scheduler, while a
+     * short loop only pays the decrement.
+     */
+    uint64_t fuel_ = 0;
+
+    /// Back-edges granted to each run or resume of a behaviour.
+    static constexpr uint64_t YIELD_FUEL = 1 << 14;
+
+    /**
+     * Lift the frames from `frame_index` up, and the stack values they
+     * cover, off the VM's stacks into a fresh Suspension.
+     */
+    Suspension* capture_suspension(size_t frame_index);
+
     /**
      * Value stack.
      *
@@ -217,11 +450,10 @@ namespace verona::interpreter
      * within this view.
      *
      * Because of finalisers, the VM needs to support re-entrant invocations,
-     * which may cause the stack to grow at unexpected times. We use a deque
-     * rather than a vector to make sure references don't get invalidated when
-     * this happens.
+     * which may cause the stack to grow at unexpected times. The arena's
+     * reservation never moves, so references stay valid when this happens.
      */
-    std::deque<Value> stack_;
+    ValueStack stack_;
 
     struct Frame
     {
@@ -269,6 +501,166 @@ namespace verona::interpreter
      */
     std::vector<Frame> cfstack_;
 
+    /**
+     * Promise cowns fulfilled since the last flush, each holding a
+     * reference that transfers to the scheduler queue when they are
+     * woken in one batch (see flush_fulfills).
+     */
+    std::vector<rt::Cown*> pending_fulfills_;
+
+    /**
+     * Register window for the current frame: the first slot of the
+     * frame's view into stack_, so register access is a single indexed
+     * load. Values themselves cannot be cached outside the stack: they
+     * are owning slots, and a finaliser can re-enter the VM in the
+     * middle of an instruction and must observe a consistent register
+     * state.
+     *
+     * The pointer stays valid across grow_stack, as the stack's
+     * reservation never moves. It is refreshed on every frame transition
+     * (call, return, finaliser entry) by refresh_window.
+     */
+    Value* window_ = nullptr;
+
+    /**
+     * Per-call-site inline caches for selector lookups.
+     *
+     * Indexed by the address of the executing instruction. Each slot
+     * holds the last descriptor dispatched on at that site and the result
+     * of resolving the site's selector against it. The cached entry is
+     * only used when the descriptor matches, so a slot never needs
+     * explicit invalidation. The table grows lazily to the highest
+     * caching instruction executed so far.
+     */
+    struct InlineCache
+    {
+      const VMDescriptor* descriptor = nullptr;
+      uint32_t entry = 0;
+    };
+    std::vector<InlineCache> inline_caches_;
+
+    InlineCache& inline_cache_slot();
+
+    /**
+     * Number of invocations after which a function is considered hot.
+     */
+    static constexpr uint64_t HOT_THRESHOLD = 1024;
+
+    /**
+     * Per-function invocation counts, keyed by the offset of the
+     * function's header. Thread-local, like the VM itself.
+     *
+     * When a function's count reaches HOT_THRESHOLD, function_became_hot
+     * is called once for it.
+     */
+    std::unordered_map<size_t, uint64_t> invocation_counts_;
+
+    void count_invocation(size_t ip);
+
+    /**
+     * Called the first time a function crosses HOT_THRESHOLD.
+     *
+     * This is the installation point for a baseline compiler: a native
+     * version of the function would be produced here and entered on
+     * subsequent calls. Until one exists, the transition is only
+     * reported.
+     */
+    void function_became_hot(size_t ip);
+
+    static constexpr size_t OPCODE_COUNT =
+      static_cast<size_t>(Opcode::maximum_value) + 1;
+
+    /**
+     * Runtime execution statistics, enabled by the interpreter's
+     * --profile option. The flag is checked on every dispatch, so the
+     * counters cost one predictable branch when profiling is off.
+     */
+    static inline bool profile_enabled_ = false;
+
+    /// Executions of each opcode, summed over all VMs.
+    static inline std::atomic<uint64_t> opcode_counts_[OPCODE_COUNT] = {};
+
+    /// Invocations of each method, keyed by the offset of the function's
+    /// header. Guarded by profile_lock_; only touched per call, and only
+    /// when profiling is enabled.
+    static inline std::mutex profile_lock_;
+    static inline std::unordered_map<size_t, uint64_t> method_counts_;
+
+    static void record_execution(Opcode op)
+    {
+      if (profile_enabled_)
+        opcode_counts_[static_cast<size_t>(op)].fetch_add(
+          1, std::memory_order_relaxed);
+    }
+
+  public:
+    /// Enable or disable --profile statistics collection.
+    static void set_profile(bool enabled)
+    {
+      profile_enabled_ = enabled;
+    }
+
+    /**
+     * Write the accumulated per-opcode execution counts and per-method
+     * dispatch counts as CSV, most executed first. `code` resolves the
+     * method names.
+     */
+    static void dump_profile(const Code& code, std::ostream& out);
+
+    /**
+     * Route Print output to `fd` through a shared buffer, flushed with
+     * one write when it fills, instead of a locked, flushing stream
+     * write per print. Opt-in (--buffered-print); pass -1 to restore the
+     * default stream path. Output may be held in the buffer until
+     * `flush_print` runs, so diagnostics interleaved with other stdout
+     * writers should keep the default.
+     */
+    static void set_print_fd(int fd);
+
+    /// Write out any buffered Print output.
+    static void flush_print();
+
+  private:
+    /// Buffered Print sink (see set_print_fd); -1 means disabled.
+    static inline int print_fd_ = -1;
+
+    /// Pending output for print_fd_, bounded by PRINT_BUFFER_SIZE.
+    /// Guarded by print_lock_: prints come from every scheduler thread.
+    static inline std::mutex print_lock_;
+    static inline std::vector<char> print_buffer_;
+
+    static constexpr size_t PRINT_BUFFER_SIZE = 64 * 1024;
+
+    /// Append print output to the buffered sink, or report that the
+    /// default stream path should be used.
+    static bool buffered_print(const char* data, size_t size);
+#ifdef USE_OPCODE_PROFILE
+    /**
+     * Dynamic opcode-pair frequencies, shared by all VMs. The counts feed
+     * the profile consumed by reorder_dispatch.py, which lays the opcode
+     * handlers out for i-cache density and selects which superinstructions
+     * the code generator emits (see dispatch_order.h).
+     */
+    static inline std::atomic<uint64_t>
+      opcode_pairs_[OPCODE_COUNT][OPCODE_COUNT] = {};
+
+    /// Previously dispatched opcode; only meaningful when
+    /// profile_has_prev_ is set, which a fresh dispatch loop resets.
+    Opcode profile_prev_{};
+    bool profile_has_prev_ = false;
+
+    void record_dispatch(Opcode op);
+
+  public:
+    /**
+     * Write the accumulated opcode-pair profile, one
+     * `<first> <second> <count>` line per executed pair, hottest first.
+     */
+    static void dump_opcode_profile(std::ostream& out);
+
+  private:
+#endif
+
     Frame& frame()
     {
       assert(!cfstack_.empty());
@@ -292,22 +684,94 @@ namespace verona::interpreter
 
   /**
    * This represent the closure for all when clauses in the runtime
+   *
+   * The captured arguments are stored in the behaviour itself when they
+   * fit, so the capture block lives in the same allocation as the message
+   * body and cown array (see MultiMessage::make_body_combined) rather
+   * than in a separately heap-allocated vector. Larger captures spill to
+   * their own allocation.
    */
   class ExecuteMessage : public rt::VBehaviour<ExecuteMessage>
   {
+    /// Arguments stored inline, including the receiver placeholder.
+    /// Sized so the whole behaviour fits Cown::MAX_COMBINED_CAPTURE.
+    static constexpr size_t INLINE_ARGS = 6;
+
     size_t start;
-    std::vector<Value> args;
-    size_t cown_count;
+    uint32_t argc;
+    uint32_t cown_count;
+    /// The capture block: `inline_args` when the arguments fit, a spilled
+    /// allocation of `argc` values otherwise.
+    Value* args;
+    Value inline_args[INLINE_ARGS];
+    /// Saved state of a run that yielded; consumed when the requeued
+    /// behaviour is delivered again.
+    VM::Suspension* suspension = nullptr;
 
   public:
-    ExecuteMessage(size_t start, std::vector<Value> args, size_t cown_count)
-    : start(start), args(std::move(args)), cown_count(cown_count)
-    {}
+    /**
+     * Build the closure for a `when`. `receiver` becomes argument zero;
+     * the `argc - 1` values at `rest` are moved in after it.
+     */
+    ExecuteMessage(
+      size_t start, size_t argc, size_t cown_count, Value receiver, Value* rest)
+    : start(start),
+      argc(static_cast<uint32_t>(argc)),
+      cown_count(static_cast<uint32_t>(cown_count))
+    {
+      rt::Alloc* alloc = rt::ThreadAlloc::get();
+      if (argc <= INLINE_ARGS)
+      {
+        args = inline_args;
+      }
+      else
+      {
+        args = static_cast<Value*>(alloc->alloc(argc * sizeof(Value)));
+        for (size_t i = 0; i < argc; i++)
+          new (&args[i]) Value();
+      }
+
+      args[0].overwrite(alloc, std::move(receiver));
+      for (size_t i = 1; i < argc; i++)
+        args[i].overwrite(alloc, std::move(rest[i - 1]));
+    }
+
+    ~ExecuteMessage()
+    {
+      // The VM moved the arguments into its registers, so the block only
+      // holds UNINIT values by now.
+      if (args != inline_args)
+        rt::ThreadAlloc::get()->dealloc(args, argc * sizeof(Value));
+    }
 
     // Main runtime entry for a closure.
     void f()
     {
-      VM::local_vm->run(std::move(args), cown_count, start);
+      VM::Suspension* next;
+      if (suspension != nullptr)
+        next = VM::local_vm->resume(this, std::exchange(suspension, nullptr));
+      else
+        next = VM::local_vm->run(args, argc, cown_count, start, this);
+
+      if (next != nullptr)
+      {
+        // The run checkpointed at a loop back-edge: keep the state and
+        // requeue, so queued messages interleave (see Behaviour::yield).
+        suspension = next;
+        yield();
+      }
+    }
+
+    /**
+     * Leak-detection trace of the capture block. An in-flight message may
+     * own whole regions (ISO captures hand their region over pointer-only,
+     * see VM::opcode_when) as well as immutables and cowns; without this
+     * the detector would consider them unreachable while queued.
+     */
+    void trace(rt::ObjectStack& st) const
+    {
+      for (size_t i = 0; i < argc; i++)
+        args[i].trace(st);
     }
   };
 }
@@ -13,9 +13,71 @@
 #include "llvm/ADT/StringRef.h"
 
 #include <string>
+#include <unordered_map>
 
 namespace mlir::verona
 {
+  /**
+   * Child index for AST nodes. The helpers in AST locate children by
+   * scanning a node's child list, and the generator asks for the same
+   * children of the same nodes several times while lowering a single
+   * construct (calls are queried once per operand, members once for the
+   * object and once for the field, conditionals several times for their
+   * else block). The index bins a node's children by tag the first time
+   * the node is queried, so repeated queries are hash lookups and
+   * lowering stays linear in the size of the AST. The AST is not
+   * mutated during lowering, so entries never go stale.
+   */
+  class ASTIndex
+  {
+    /// Children binned by tag, built lazily per node. The first child
+    /// of each tag wins, matching the scan in AST::findNode.
+    std::unordered_map<
+      ::ast::AstImpl*,
+      std::unordered_map<unsigned int, ::ast::Ast>>
+      children;
+
+    const std::unordered_map<unsigned int, ::ast::Ast>&
+    bins(const ::ast::Ast& ast)
+    {
+      auto res = children.emplace(
+        ast.get(), std::unordered_map<unsigned int, ::ast::Ast>());
+      auto& map = res.first->second;
+      if (res.second)
+      {
+        for (auto& node : ast->nodes)
+          map.emplace(node->tag, node);
+      }
+      return map;
+    }
+
+  public:
+    /// Find a sub-node of tag 'type', or nullptr if there is none.
+    ::ast::Ast tryFind(const ::ast::Ast& ast, unsigned int type)
+    {
+      auto& map = bins(ast);
+      auto it = map.find(type);
+      if (it == map.end())
+        return ::ast::Ast();
+      return it->second;
+    }
+
+    /// Find a sub-node of tag 'type', like AST::findNode.
+    ::ast::Ast find(const ::ast::Ast& ast, unsigned int type)
+    {
+      auto node = tryFind(ast, type);
+      // TODO: Make this into a soft error
+      assert(node && "Bad node");
+      return node;
+    }
+
+    /// Return true if the node has a sub-node of tag 'type'.
+    bool has(const ::ast::Ast& ast, unsigned int type)
+    {
+      return tryFind(ast, type) != nullptr;
+    }
+  };
+
   /**
    * This is a bag of utility functions to handle AST lookups and fail-safe
    * operations. While the AST design is still in flux, we can keep this around,
@@ -143,7 +205,7 @@ namespace mlir::verona
     /// Return true if node has a certain kind sub-node
     static bool hasA(::ast::Ast ast, NodeKind kind)
     {
-      auto nodes = ast->nodes;
+      auto& nodes = ast->nodes;
       return std::find_if(nodes.begin(), nodes.end(), [&](::ast::Ast& node) {
                return isA(node, kind);
              }) != nodes.end();
@@ -330,9 +392,9 @@ namespace mlir::verona
     }
 
     /// Return true if node defined a region to allocate
-    static bool hasInRegion(::ast::Ast ast)
+    static bool hasInRegion(ASTIndex& index, ::ast::Ast ast)
     {
-      return hasA(ast, NodeKind::InRegion);
+      return index.has(ast, NodeKind::InRegion);
     }
 
     /// Find a sub-node of tag 'type'
@@ -380,36 +442,36 @@ namespace mlir::verona
     }
 
     /// Get the local reference (local variable) from an expression
-    static llvm::StringRef getLocalRef(::ast::Ast ast)
+    static llvm::StringRef getLocalRef(ASTIndex& index, ::ast::Ast ast)
     {
       assert(!isValue(ast) && "Bad node");
-      return getTokenValue(findNode(ast, NodeKind::Localref));
+      return getTokenValue(index.find(ast, NodeKind::Localref));
     }
 
     /// Return true if node is a variable definition
-    static llvm::StringRef getLocalName(::ast::Ast ast)
+    static llvm::StringRef getLocalName(ASTIndex& index, ::ast::Ast ast)
     {
       // Local variables can be new 'local' or existing 'localref'
       if (isLocalRef(ast))
         return getTokenValue(ast);
       if (isMember(ast))
-        return getTokenValue(findNode(ast, NodeKind::Localref));
+        return getTokenValue(index.find(ast, NodeKind::Localref));
       assert(isLet(ast) && "Bad node");
-      return getTokenValue(findNode(ast, NodeKind::Local));
+      return getTokenValue(index.find(ast, NodeKind::Local));
     }
 
     /// Return true if node is an ID (func, var, type names)
-    static llvm::StringRef getID(::ast::Ast ast)
+    static llvm::StringRef getID(ASTIndex& index, ::ast::Ast ast)
     {
       if (isAny(ast, {NodeKind::Call, NodeKind::StaticCall}))
-        return getTokenValue(findNode(ast, NodeKind::Function));
+        return getTokenValue(index.find(ast, NodeKind::Function));
       if (isMember(ast))
-        return getTokenValue(findNode(ast, NodeKind::Lookup));
+        return getTokenValue(index.find(ast, NodeKind::Lookup));
       if (isQualType(ast))
-        return getTokenValue(findNode(ast, NodeKind::Typeref));
+        return getTokenValue(index.find(ast, NodeKind::Typeref));
       if (isInvoke(ast))
-        return getID(findNode(ast, NodeKind::Member));
-      return getTokenValue(findNode(ast, NodeKind::ID));
+        return getID(index, index.find(ast, NodeKind::Member));
+      return getTokenValue(index.find(ast, NodeKind::ID));
     }
 
     // ================================================= Type Helpers
@@ -417,7 +479,7 @@ namespace mlir::verona
     static ::ast::Ast getType(::ast::Ast ast)
     {
       // This can be any of the type holders
-      for (auto node : ast->nodes)
+      for (auto& node : ast->nodes)
       {
         if (isTypeHolder(node))
           return node;
@@ -449,7 +511,7 @@ namespace mlir::verona
       // operator (in sep).
       sep = 0;
       auto type = findNode(ast, NodeKind::Type);
-      for (auto node : type->nodes)
+      for (auto& node : type->nodes)
       {
         switch (node->tag)
         {
@@ -500,7 +562,7 @@ namespace mlir::verona
       // Arguments are in sig / params
       auto sig = findNode(ast, NodeKind::Sig);
       auto params = findNode(sig, NodeKind::Params);
-      for (auto param : params->nodes)
+      for (auto& param : params->nodes)
         args.push_back(findNode(param, NodeKind::NamedParam));
     }
 
@@ -514,7 +576,7 @@ namespace mlir::verona
       // Constraints are in sig / params
       auto sig = findNode(ast, NodeKind::Sig);
       auto consts = findNode(sig, NodeKind::Constraints);
-      for (auto c : consts->nodes)
+      for (auto& c : consts->nodes)
         constraints.push_back(c);
     }
 
@@ -544,7 +606,7 @@ namespace mlir::verona
       assert(isFunction(ast) && "Bad node");
 
       auto quals = findNode(ast, NodeKind::Qualifier);
-      for (auto c : quals->nodes)
+      for (auto& c : quals->nodes)
         qual.push_back(c);
     }
 
@@ -559,11 +621,11 @@ namespace mlir::verona
     }
 
     /// Get the class allocation region if any
-    static ::ast::Ast getInRegion(::ast::Ast ast)
+    static ::ast::Ast getInRegion(ASTIndex& index, ::ast::Ast ast)
     {
       assert(isNew(ast) && "Bad node");
 
-      return findNode(ast, NodeKind::InRegion);
+      return index.find(ast, NodeKind::InRegion);
     }
 
     /// Get the field init expression
@@ -602,7 +664,7 @@ namespace mlir::verona
 
     // ================================================= Operation Helpers
     /// Return the number of operands in an operation
-    static size_t numOperands(::ast::Ast ast)
+    static size_t numOperands(ASTIndex& index, ::ast::Ast ast)
     {
       assert((isCall(ast) || isInvoke(ast) || isStaticCall(ast)) && "Bad node");
       // Dynamic calls must have descriptor
@@ -610,10 +672,10 @@ namespace mlir::verona
         assert(isValue(ast->nodes[2]) && "No descriptor for dynamic call");
       // Invokes must have a member
       if (isInvoke(ast))
-        findNode(ast, NodeKind::Member);
+        index.find(ast, NodeKind::Member);
       // Dynamic call's first argument is separate (descriptor), bool to int
       size_t firstArg = isCall(ast) || isInvoke(ast);
-      auto args = findNode(ast, NodeKind::Args);
+      auto args = index.find(ast, NodeKind::Args);
       return args->nodes.size() + firstArg;
     }
 
@@ -636,10 +698,10 @@ namespace mlir::verona
     }
 
     /// Return the n-th operand of the operation
-    static ::ast::Ast getOperand(::ast::Ast ast, size_t n)
+    static ::ast::Ast getOperand(ASTIndex& index, ::ast::Ast ast, size_t n)
     {
-      assert(n < numOperands(ast) && "Bad offset");
-      auto args = findNode(ast, NodeKind::Args);
+      assert(n < numOperands(index, ast) && "Bad offset");
+      auto args = index.find(ast, NodeKind::Args);
       // Static calls don't have special first argument
       if (isStaticCall(ast))
         return args->nodes[n];
@@ -648,86 +710,100 @@ namespace mlir::verona
       {
         auto node = ast;
         if (isInvoke(ast))
-          node = findNode(ast, NodeKind::Member);
-        return findNode(node, NodeKind::Localref);
+          node = index.find(ast, NodeKind::Member);
+        return index.find(node, NodeKind::Localref);
       }
       // All others in 'args'
       return args->nodes[n - 1];
     }
 
-    /// Get all operands of the operation.
+    /// Get all operands of the operation, in a single pass over the node.
     /// T must be a list<ast> type with push_back.
     template<class T>
-    static void getAllOperands(T& ops, ::ast::Ast ast)
+    static void getAllOperands(ASTIndex& index, T& ops, ::ast::Ast ast)
     {
-      auto numOps = numOperands(ast);
-      for (size_t i = 0; i < numOps; i++)
-        ops.push_back(getOperand(ast, i));
+      assert((isCall(ast) || isInvoke(ast) || isStaticCall(ast)) && "Bad node");
+      // Dynamic calls must have descriptor
+      if (isCall(ast))
+        assert(isValue(ast->nodes[2]) && "No descriptor for dynamic call");
+      // Invoke/Calls have the first operand as 'localref'
+      if (isCall(ast) || isInvoke(ast))
+      {
+        auto node = ast;
+        if (isInvoke(ast))
+          node = index.find(ast, NodeKind::Member);
+        ops.push_back(index.find(node, NodeKind::Localref));
+      }
+      // All others in 'args'
+      auto args = index.find(ast, NodeKind::Args);
+      ops.insert(ops.end(), args->nodes.begin(), args->nodes.end());
     }
 
     /// Get static call's qualified type
-    static ::ast::Ast getStaticQualType(::ast::Ast ast)
+    static ::ast::Ast getStaticQualType(ASTIndex& index, ::ast::Ast ast)
     {
       assert(isStaticCall(ast) && "Bad node");
-      return findNode(ast, NodeKind::QualType);
+      return index.find(ast, NodeKind::QualType);
     }
 
     // ================================================= Condition Helpers
     /// Return the condition from an if statement
-    static bool hasElse(::ast::Ast ast)
+    static bool hasElse(ASTIndex& index, ::ast::Ast ast)
     {
       // Else nodes always exist inside `if` nodes, but if there was no `else`
       // block, they're empty. We should only return true if they're not.
-      return isA(ast, NodeKind::If) && hasA(ast, NodeKind::Else) &&
-        hasSubs(findNode(ast, NodeKind::Else));
+      if (!isA(ast, NodeKind::If))
+        return false;
+      auto node = index.tryFind(ast, NodeKind::Else);
+      return node && hasSubs(node);
     }
 
     /// Return the block from an if statement
-    static ::ast::Ast getCond(::ast::Ast ast)
+    static ::ast::Ast getCond(ASTIndex& index, ::ast::Ast ast)
     {
       // These are the nodes that could have conditions as subnodes
       assert((isIf(ast) || isLoop(ast)) && "Bad node");
       // Cond nodes are always seq, even with just one cond
-      auto cond = findNode(ast, NodeKind::Condition);
-      return findNode(cond, NodeKind::Seq);
+      auto cond = index.find(ast, NodeKind::Condition);
+      return index.find(cond, NodeKind::Seq);
     }
 
     /// Return true if the 'if' node has an else block
-    static ::ast::Ast getIfBlock(::ast::Ast ast)
+    static ::ast::Ast getIfBlock(ASTIndex& index, ::ast::Ast ast)
     {
       assert(isIf(ast) && "Bad node");
-      return findNode(ast, NodeKind::Block);
+      return index.find(ast, NodeKind::Block);
     }
 
     /// Return the else block from an if statement
-    static ::ast::Ast getElseBlock(::ast::Ast ast)
+    static ::ast::Ast getElseBlock(ASTIndex& index, ::ast::Ast ast)
     {
-      assert(hasElse(ast) && "Bad node");
+      assert(hasElse(index, ast) && "Bad node");
       // Else has either a single node or a seq
-      auto node = findNode(ast, NodeKind::Else);
+      auto node = index.find(ast, NodeKind::Else);
       return node->nodes[0];
     }
 
     // ================================================= Loop Helpers
     /// Return the block from a loop
-    static ::ast::Ast getLoopBlock(::ast::Ast ast)
+    static ::ast::Ast getLoopBlock(ASTIndex& index, ::ast::Ast ast)
     {
       assert(isLoop(ast) && "Bad node");
-      return findNode(ast, NodeKind::Block);
+      return index.find(ast, NodeKind::Block);
     }
 
     /// Return the sequence generator from a `for` loop
-    static ::ast::Ast getLoopSeq(::ast::Ast ast)
+    static ::ast::Ast getLoopSeq(ASTIndex& index, ::ast::Ast ast)
     {
       assert(isFor(ast) && "Bad node");
-      return findNode(findNode(ast, NodeKind::Seq), NodeKind::Localref);
+      return index.find(index.find(ast, NodeKind::Seq), NodeKind::Localref);
     }
 
     /// Return the induction variable from a `for` loop
-    static ::ast::Ast getLoopInd(::ast::Ast ast)
+    static ::ast::Ast getLoopInd(ASTIndex& index, ::ast::Ast ast)
     {
       assert(isFor(ast) && "Bad node");
-      return findNode(ast, NodeKind::Localref);
+      return index.find(ast, NodeKind::Localref);
     }
   };
 }
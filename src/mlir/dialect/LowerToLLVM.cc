@@ -0,0 +1,509 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+
+#include "LowerToLLVM.h"
+
+#include "VeronaOps.h"
+#include "VeronaTypes.h"
+#include "mlir/Conversion/StandardToLLVM/ConvertStandardToLLVM.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
+#include "mlir/Transforms/DialectConversion.h"
+
+using namespace mlir;
+using namespace mlir::verona;
+
+namespace
+{
+  /// Find the class an object reference of type `type` points at. Class
+  /// types appear either directly or as one element of an intersection,
+  /// eg. `class<"C", ...> & mut`. Returns null when the type does not
+  /// determine a unique class, in particular for still-unknown types.
+  ClassType extractClassType(Type type)
+  {
+    if (auto cls = type.dyn_cast<ClassType>())
+      return cls;
+
+    if (auto meet = type.dyn_cast<MeetType>())
+    {
+      ClassType result;
+      for (Type element : meet.getElements())
+      {
+        if (auto cls = element.dyn_cast<ClassType>())
+        {
+          if (result && result != cls)
+            return ClassType();
+          result = cls;
+        }
+      }
+      return result;
+    }
+
+    return ClassType();
+  }
+
+  /// True when a reference of this type always carries region ownership.
+  /// A join is only always-iso if every alternative is.
+  bool isAlwaysIso(Type type)
+  {
+    if (auto cap = type.dyn_cast<CapabilityType>())
+      return cap.getCapability() == Capability::Isolated;
+    if (auto meet = type.dyn_cast<MeetType>())
+      return llvm::any_of(meet.getElements(), isAlwaysIso);
+    if (auto join = type.dyn_cast<JoinType>())
+      return llvm::all_of(join.getElements(), isAlwaysIso);
+    return false;
+  }
+
+  /// True when a reference of this type may carry region ownership.
+  /// Paired with isAlwaysIso to classify drops: types in between, such
+  /// as `iso | mut`, need a runtime distinction the opaque handles do
+  /// not carry, so their drops are rejected.
+  bool mayBeIso(Type type)
+  {
+    if (type.isa<UnknownType>())
+      return true;
+    if (auto cap = type.dyn_cast<CapabilityType>())
+      return cap.getCapability() == Capability::Isolated;
+    if (auto meet = type.dyn_cast<MeetType>())
+      return llvm::any_of(meet.getElements(), mayBeIso);
+    if (auto join = type.dyn_cast<JoinType>())
+      return llvm::any_of(join.getElements(), mayBeIso);
+    return false;
+  }
+
+  /// Position of field `name` in the dense field array of `cls`. Indices
+  /// follow ClassType::getFields(), matching the layout rt-abi.cc uses.
+  llvm::Optional<size_t> fieldIndex(ClassType cls, StringRef name)
+  {
+    auto fields = cls.getFields();
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+      if (fields[i].first == name)
+        return i;
+    }
+    return llvm::None;
+  }
+
+  /// Creates the LLVM-level view of the runtime ABI on demand: function
+  /// declarations for the rt-abi.h entry points, and one verona_class_t
+  /// global per class, initialized with the class name, field count and
+  /// iso-field mask.
+  struct RuntimeABI
+  {
+    explicit RuntimeABI(ModuleOp module) : module(module)
+    {
+      MLIRContext* ctx = module.getContext();
+      opaquePtr = LLVM::LLVMPointerType::get(IntegerType::get(ctx, 8));
+      sizeTy = IntegerType::get(ctx, 64);
+      voidTy = LLVM::LLVMVoidType::get(ctx);
+      classTy = LLVM::LLVMStructType::getIdentified(ctx, "verona_class");
+      if (!classTy.isInitialized())
+      {
+        (void)classTy.setBody(
+          {opaquePtr, sizeTy, opaquePtr, opaquePtr}, /*isPacked=*/false);
+      }
+      classPtr = LLVM::LLVMPointerType::get(classTy);
+    }
+
+    /// Get the declaration of a runtime entry point, declaring it at the
+    /// start of the module on first use.
+    LLVM::LLVMFuncOp
+    getRuntimeFunction(StringRef name, ArrayRef<Type> params, Type result)
+    {
+      if (auto func = module.lookupSymbol<LLVM::LLVMFuncOp>(name))
+        return func;
+
+      OpBuilder builder = OpBuilder::atBlockBegin(module.getBody());
+      auto type = LLVM::LLVMFunctionType::get(result, params);
+      return builder.create<LLVM::LLVMFuncOp>(module.getLoc(), name, type);
+    }
+
+    /// Get the address of the verona_class_t global for `type`, creating
+    /// the global on first use.
+    Value classAddress(Location loc, OpBuilder& builder, ClassType type)
+    {
+      std::string symbol = ("verona_class." + type.getName()).str();
+      auto global = module.lookupSymbol<LLVM::GlobalOp>(symbol);
+      if (!global)
+        global = createClassGlobal(loc, symbol, type);
+      return builder.create<LLVM::AddressOfOp>(loc, global);
+    }
+
+    ModuleOp module;
+    Type opaquePtr;
+    Type sizeTy;
+    Type voidTy;
+    LLVM::LLVMStructType classTy;
+    Type classPtr;
+
+  private:
+    LLVM::GlobalOp
+    createClassGlobal(Location loc, StringRef symbol, ClassType type)
+    {
+      OpBuilder builder = OpBuilder::atBlockBegin(module.getBody());
+
+      // Not a constant: the runtime caches the descriptor it builds for
+      // the class in the global's impl slot (see rt-abi.h).
+      auto global = builder.create<LLVM::GlobalOp>(
+        loc,
+        classTy,
+        /*isConstant=*/false,
+        LLVM::Linkage::Internal,
+        symbol,
+        Attribute());
+
+      // The struct references the name and iso-mask globals, so it is
+      // built in an initializer region; the ops below all translate to
+      // LLVM constant expressions.
+      Block* block = builder.createBlock(&global.getInitializerRegion());
+      builder.setInsertionPointToStart(block);
+
+      std::string name = type.getName().str();
+      name.push_back('\0');
+
+      // One byte per field, non-zero when the field always holds an
+      // owned reference. Fields that only may be owned cannot be
+      // expressed in a static mask; under-approximating means their
+      // sub-regions leak on release rather than being freed twice.
+      std::string isoMask;
+      for (auto& field : type.getFields())
+        isoMask.push_back(isAlwaysIso(field.second) ? 1 : 0);
+
+      Value init = builder.create<LLVM::UndefOp>(loc, classTy);
+      Value className = LLVM::createGlobalString(
+        loc,
+        builder,
+        (symbol + ".name").str(),
+        name,
+        LLVM::Linkage::Internal);
+      Value fieldCount = builder.create<LLVM::ConstantOp>(
+        loc, sizeTy, builder.getI64IntegerAttr(type.getFields().size()));
+      Value isoFields = LLVM::createGlobalString(
+        loc,
+        builder,
+        (symbol + ".iso").str(),
+        isoMask,
+        LLVM::Linkage::Internal);
+      Value impl = builder.create<LLVM::NullOp>(loc, opaquePtr);
+
+      init = builder.create<LLVM::InsertValueOp>(
+        loc, classTy, init, className, builder.getI64ArrayAttr(0));
+      init = builder.create<LLVM::InsertValueOp>(
+        loc, classTy, init, fieldCount, builder.getI64ArrayAttr(1));
+      init = builder.create<LLVM::InsertValueOp>(
+        loc, classTy, init, isoFields, builder.getI64ArrayAttr(2));
+      init = builder.create<LLVM::InsertValueOp>(
+        loc, classTy, init, impl, builder.getI64ArrayAttr(3));
+      builder.create<LLVM::ReturnOp>(loc, init);
+
+      return global;
+    }
+  };
+
+  /// Base for the patterns below, carrying the shared ABI builder.
+  template<typename Op>
+  struct VeronaOpLowering : public OpConversionPattern<Op>
+  {
+    VeronaOpLowering(LLVMTypeConverter& converter, RuntimeABI& abi)
+    : OpConversionPattern<Op>(converter, &converter.getContext()), abi(abi)
+    {}
+
+    RuntimeABI& abi;
+  };
+
+  /// copy and view are identities on opaque handles: ownership and
+  /// aliasing are enforced statically, the runtime representation of an
+  /// owned and an unowned reference is the same pointer.
+  template<typename Op>
+  struct PassthroughLowering : public VeronaOpLowering<Op>
+  {
+    using VeronaOpLowering<Op>::VeronaOpLowering;
+
+    LogicalResult matchAndRewrite(
+      Op op,
+      ArrayRef<Value> operands,
+      ConversionPatternRewriter& rewriter) const final
+    {
+      rewriter.replaceOp(op, operands.front());
+      return success();
+    }
+  };
+
+  struct StaticLowering : public VeronaOpLowering<StaticOp>
+  {
+    using VeronaOpLowering::VeronaOpLowering;
+
+    LogicalResult matchAndRewrite(
+      StaticOp op,
+      ArrayRef<Value> operands,
+      ConversionPatternRewriter& rewriter) const final
+    {
+      ClassType cls = extractClassType(op.type());
+      if (!cls)
+        return rewriter.notifyMatchFailure(
+          op, "static descriptor of a non-class type");
+
+      Value address = abi.classAddress(op.getLoc(), rewriter, cls);
+      rewriter.replaceOpWithNewOp<LLVM::BitcastOp>(
+        op, abi.opaquePtr, address);
+      return success();
+    }
+  };
+
+  struct FieldReadLowering : public VeronaOpLowering<FieldReadOp>
+  {
+    using VeronaOpLowering::VeronaOpLowering;
+
+    LogicalResult matchAndRewrite(
+      FieldReadOp op,
+      ArrayRef<Value> operands,
+      ConversionPatternRewriter& rewriter) const final
+    {
+      ClassType cls = extractClassType(op.origin().getType());
+      if (!cls)
+        return rewriter.notifyMatchFailure(
+          op, "field origin has no known class type");
+      auto index = fieldIndex(cls, op.field());
+      if (!index)
+        return rewriter.notifyMatchFailure(
+          op, "field is not part of the origin's class type");
+
+      auto func = abi.getRuntimeFunction(
+        "verona_field_load", {abi.opaquePtr, abi.sizeTy}, abi.opaquePtr);
+      Value indexValue = rewriter.create<LLVM::ConstantOp>(
+        op.getLoc(), abi.sizeTy, rewriter.getI64IntegerAttr(*index));
+      rewriter.replaceOpWithNewOp<LLVM::CallOp>(
+        op, func, ValueRange{operands[0], indexValue});
+      return success();
+    }
+  };
+
+  struct FieldWriteLowering : public VeronaOpLowering<FieldWriteOp>
+  {
+    using VeronaOpLowering::VeronaOpLowering;
+
+    LogicalResult matchAndRewrite(
+      FieldWriteOp op,
+      ArrayRef<Value> operands,
+      ConversionPatternRewriter& rewriter) const final
+    {
+      ClassType cls = extractClassType(op.origin().getType());
+      if (!cls)
+        return rewriter.notifyMatchFailure(
+          op, "field origin has no known class type");
+      auto index = fieldIndex(cls, op.field());
+      if (!index)
+        return rewriter.notifyMatchFailure(
+          op, "field is not part of the origin's class type");
+
+      auto func = abi.getRuntimeFunction(
+        "verona_field_store",
+        {abi.opaquePtr, abi.sizeTy, abi.opaquePtr},
+        abi.opaquePtr);
+      Value indexValue = rewriter.create<LLVM::ConstantOp>(
+        op.getLoc(), abi.sizeTy, rewriter.getI64IntegerAttr(*index));
+      rewriter.replaceOpWithNewOp<LLVM::CallOp>(
+        op, func, ValueRange{operands[0], indexValue, operands[1]});
+      return success();
+    }
+  };
+
+  struct TidyLowering : public VeronaOpLowering<TidyOp>
+  {
+    using VeronaOpLowering::VeronaOpLowering;
+
+    LogicalResult matchAndRewrite(
+      TidyOp op,
+      ArrayRef<Value> operands,
+      ConversionPatternRewriter& rewriter) const final
+    {
+      auto func = abi.getRuntimeFunction(
+        "verona_region_gc", {abi.opaquePtr}, abi.voidTy);
+      rewriter.replaceOpWithNewOp<LLVM::CallOp>(
+        op, func, ValueRange{operands[0]});
+      return success();
+    }
+  };
+
+  struct DropLowering : public VeronaOpLowering<DropOp>
+  {
+    using VeronaOpLowering::VeronaOpLowering;
+
+    LogicalResult matchAndRewrite(
+      DropOp op,
+      ArrayRef<Value> operands,
+      ConversionPatternRewriter& rewriter) const final
+    {
+      Type type = op.region().getType();
+      if (isAlwaysIso(type))
+      {
+        auto func = abi.getRuntimeFunction(
+          "verona_region_release", {abi.opaquePtr}, abi.voidTy);
+        rewriter.replaceOpWithNewOp<LLVM::CallOp>(
+          op, func, ValueRange{operands[0]});
+        return success();
+      }
+
+      if (!mayBeIso(type))
+      {
+        rewriter.eraseOp(op);
+        return success();
+      }
+
+      return rewriter.notifyMatchFailure(
+        op, "cannot lower drop of a value with mixed ownership");
+    }
+  };
+
+  /// Emit a verona_field_store per (name, value) initializer pair. The
+  /// allocation ops carry initializers as parallel name and operand
+  /// lists; fields left out stay null.
+  LogicalResult initializeFields(
+    Operation* op,
+    ClassType cls,
+    Value object,
+    ArrayAttr names,
+    ArrayRef<Value> values,
+    RuntimeABI& abi,
+    ConversionPatternRewriter& rewriter)
+  {
+    auto func = abi.getRuntimeFunction(
+      "verona_field_store",
+      {abi.opaquePtr, abi.sizeTy, abi.opaquePtr},
+      abi.opaquePtr);
+
+    for (auto pair : llvm::zip(names, values))
+    {
+      StringRef name = std::get<0>(pair).cast<StringAttr>().getValue();
+      auto index = fieldIndex(cls, name);
+      if (!index)
+        return rewriter.notifyMatchFailure(
+          op, "initializer for a field not in the class type");
+
+      Value indexValue = rewriter.create<LLVM::ConstantOp>(
+        op->getLoc(), abi.sizeTy, rewriter.getI64IntegerAttr(*index));
+      rewriter.create<LLVM::CallOp>(
+        op->getLoc(),
+        func,
+        ValueRange{object, indexValue, std::get<1>(pair)});
+    }
+
+    return success();
+  }
+
+  struct AllocateRegionLowering : public VeronaOpLowering<AllocateRegionOp>
+  {
+    using VeronaOpLowering::VeronaOpLowering;
+
+    LogicalResult matchAndRewrite(
+      AllocateRegionOp op,
+      ArrayRef<Value> operands,
+      ConversionPatternRewriter& rewriter) const final
+    {
+      ClassType cls = extractClassType(op.output().getType());
+      if (!cls)
+        return rewriter.notifyMatchFailure(
+          op, "allocation result has no known class type");
+
+      Location loc = op.getLoc();
+      Value clsAddr = abi.classAddress(loc, rewriter, cls);
+      auto func = abi.getRuntimeFunction(
+        "verona_region_new", {abi.classPtr}, abi.opaquePtr);
+      Value object =
+        rewriter.create<LLVM::CallOp>(loc, func, ValueRange{clsAddr})
+          .getOperation()
+          ->getResult(0);
+
+      if (failed(initializeFields(
+            op, cls, object, op.field_names(), operands, abi, rewriter)))
+        return failure();
+
+      rewriter.replaceOp(op, object);
+      return success();
+    }
+  };
+
+  struct AllocateObjectLowering : public VeronaOpLowering<AllocateObjectOp>
+  {
+    using VeronaOpLowering::VeronaOpLowering;
+
+    LogicalResult matchAndRewrite(
+      AllocateObjectOp op,
+      ArrayRef<Value> operands,
+      ConversionPatternRewriter& rewriter) const final
+    {
+      ClassType cls = extractClassType(op.output().getType());
+      if (!cls)
+        return rewriter.notifyMatchFailure(
+          op, "allocation result has no known class type");
+
+      Location loc = op.getLoc();
+      Value clsAddr = abi.classAddress(loc, rewriter, cls);
+      auto func = abi.getRuntimeFunction(
+        "verona_object_new", {abi.opaquePtr, abi.classPtr}, abi.opaquePtr);
+
+      // The region operand follows the variadic field initializers.
+      Value region = operands.back();
+      Value object =
+        rewriter.create<LLVM::CallOp>(loc, func, ValueRange{region, clsAddr})
+          .getOperation()
+          ->getResult(0);
+
+      if (failed(initializeFields(
+            op,
+            cls,
+            object,
+            op.field_names(),
+            operands.drop_back(),
+            abi,
+            rewriter)))
+        return failure();
+
+      rewriter.replaceOp(op, object);
+      return success();
+    }
+  };
+}
+
+namespace mlir::verona
+{
+  void LowerToLLVMPass::runOnOperation()
+  {
+    ModuleOp module = getOperation();
+    MLIRContext* ctx = &getContext();
+
+    RuntimeABI abi(module);
+
+    LLVMTypeConverter converter(ctx);
+    // Every Verona reference, descriptors included, is an opaque pointer
+    // at runtime.
+    converter.addConversion([&](Type type) -> llvm::Optional<Type> {
+      if (isaVeronaType(type))
+        return abi.opaquePtr;
+      return llvm::None;
+    });
+
+    OwningRewritePatternList patterns;
+    populateStdToLLVMConversionPatterns(converter, patterns);
+    patterns.insert<
+      PassthroughLowering<CopyOp>,
+      PassthroughLowering<ViewOp>,
+      StaticLowering,
+      FieldReadLowering,
+      FieldWriteLowering,
+      TidyLowering,
+      DropLowering,
+      AllocateRegionLowering,
+      AllocateObjectLowering>(converter, abi);
+
+    // No pattern handles verona.call on purpose: dynamic dispatch needs
+    // the selector tables and vtables the generator does not emit yet,
+    // so such modules fail the conversion with a diagnostic.
+    LLVMConversionTarget target(*ctx);
+    target.addLegalOp<ModuleOp, ModuleTerminatorOp>();
+
+    if (failed(applyFullConversion(module, target, std::move(patterns))))
+      signalPassFailure();
+  }
+}
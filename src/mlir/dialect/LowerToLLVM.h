@@ -0,0 +1,27 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir::verona
+{
+  /// Lower a module to the LLVM dialect, for AOT compilation against the
+  /// Verona runtime.
+  ///
+  /// Verona references become opaque `!llvm.ptr<i8>` handles and the
+  /// dialect's region and field operations become calls into the C ABI
+  /// implemented by rt-abi.cc (allocation, field access, GC, release),
+  /// with one `verona_class_t` global emitted per class. Standard dialect
+  /// operations are lowered with the stock Standard-to-LLVM patterns.
+  ///
+  /// The lowering needs the class types the typechecker established:
+  /// operations whose types are still unknown, as well as dynamic calls
+  /// (verona.call, which needs selectors and vtables), are diagnosed as
+  /// unsupported rather than miscompiled.
+  class LowerToLLVMPass
+  : public PassWrapper<LowerToLLVMPass, OperationPass<ModuleOp>>
+  {
+    void runOnOperation() override;
+  };
+}
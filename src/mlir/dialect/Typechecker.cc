@@ -6,10 +6,49 @@
 #include "TypecheckInterface.h"
 #include "VeronaTypes.h"
 
+#include "llvm/ADT/DenseMap.h"
+
+namespace
+{
+  /// Memoized subtype queries, keyed on the uniqued Type pointers.
+  /// Identity hashing is sound because types are uniqued by the context.
+  /// Generated modules check the same (lhs, rhs) pairs thousands of
+  /// times, so a repeat query should be a hash hit instead of a
+  /// re-derivation of the whole rule set.
+  ///
+  /// The cache is installed for the duration of one typecheck walk and
+  /// consulted by `isSubtype`; thread_local so concurrent pass instances
+  /// don't share state.
+  using SubtypeQuery = std::pair<const void*, const void*>;
+  thread_local llvm::DenseMap<SubtypeQuery, bool>* subtypeCache = nullptr;
+
+  /// Installs a fresh subtype cache for the lifetime of the scope,
+  /// restoring whatever was installed before on exit.
+  struct SubtypeCacheScope
+  {
+    llvm::DenseMap<SubtypeQuery, bool> map;
+    llvm::DenseMap<SubtypeQuery, bool>* previous;
+
+    SubtypeCacheScope() : previous(subtypeCache)
+    {
+      subtypeCache = &map;
+    }
+
+    ~SubtypeCacheScope()
+    {
+      subtypeCache = previous;
+    }
+  };
+}
+
 namespace mlir::verona
 {
   LogicalResult typecheck(Operation* op)
   {
+    // One subtype cache for the whole walk. Types outlive the walk, so
+    // entries can't go stale.
+    SubtypeCacheScope cache;
+
     auto callback = [](TypecheckInterface innerOp) -> WalkResult {
       // If typecheck fails, WalkResult::interrupt is returned.
       return innerOp.typecheck();
@@ -170,7 +209,19 @@ namespace mlir::verona
     assert(isaVeronaType(lhs));
     assert(isaVeronaType(rhs));
 
-    return RULES(lhs, rhs);
+    if (!subtypeCache)
+      return RULES(lhs, rhs);
+
+    SubtypeQuery key{lhs.getAsOpaquePointer(), rhs.getAsOpaquePointer()};
+    auto it = subtypeCache->find(key);
+    if (it != subtypeCache->end())
+      return it->second;
+
+    // The rules recurse through isSubtype, so the memo also serves the
+    // inner queries of meets, joins and viewpoints.
+    bool result = RULES(lhs, rhs);
+    subtypeCache->try_emplace(key, result);
+    return result;
   }
 
   LogicalResult checkSubtype(Operation* op, Type lhs, Type rhs)
@@ -8,6 +8,7 @@
 #include "VeronaTypes.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/OpImplementation.h"
+#include "mlir/IR/PatternMatch.h"
 
 #include "llvm/ADT/StringSet.h"
 
@@ -44,6 +45,128 @@ static LogicalResult verify(verona::AllocateObjectOp op)
   return verifyAllocationOp(op);
 }
 
+namespace
+{
+  /// Fold a view of a view into a single view of the original reference.
+  /// Views never consume their operand, so going through the intermediate
+  /// unowned reference is observably the same as viewing the source.
+  struct ViewOfView : public OpRewritePattern<verona::ViewOp>
+  {
+    using OpRewritePattern<verona::ViewOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(
+      verona::ViewOp op, PatternRewriter& rewriter) const override
+    {
+      auto inner = op.input().getDefiningOp<verona::ViewOp>();
+      if (!inner)
+        return failure();
+      rewriter.replaceOpWithNewOp<verona::ViewOp>(
+        op, op.output().getType(), inner.input());
+      return success();
+    }
+  };
+
+  /// Fold a copy whose only purpose is to feed another copy. The inner
+  /// copy consumes its operand and the outer copy consumes the
+  /// intermediate reference, so one copy of the source has the same
+  /// effect, as long as nothing else uses the intermediate reference.
+  struct CopyOfCopy : public OpRewritePattern<verona::CopyOp>
+  {
+    using OpRewritePattern<verona::CopyOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(
+      verona::CopyOp op, PatternRewriter& rewriter) const override
+    {
+      auto inner = op.input().getDefiningOp<verona::CopyOp>();
+      if (!inner || !inner.output().hasOneUse())
+        return failure();
+      rewriter.replaceOpWithNewOp<verona::CopyOp>(
+        op, op.output().getType(), inner.input());
+      rewriter.eraseOp(inner);
+      return success();
+    }
+  };
+
+  /// Rebuild an allocation with a new initialiser list. The two allocation
+  /// ops only differ in the trailing region operand.
+  verona::AllocateRegionOp cloneAllocation(
+    PatternRewriter& rewriter,
+    verona::AllocateRegionOp alloc,
+    ArrayAttr names,
+    ValueRange fields)
+  {
+    return rewriter.create<verona::AllocateRegionOp>(
+      alloc.getLoc(),
+      alloc.output().getType(),
+      alloc.class_nameAttr(),
+      names,
+      fields);
+  }
+
+  verona::AllocateObjectOp cloneAllocation(
+    PatternRewriter& rewriter,
+    verona::AllocateObjectOp alloc,
+    ArrayAttr names,
+    ValueRange fields)
+  {
+    return rewriter.create<verona::AllocateObjectOp>(
+      alloc.getLoc(),
+      alloc.output().getType(),
+      alloc.class_nameAttr(),
+      names,
+      fields,
+      alloc.region());
+  }
+
+  /// Fuse a field write into the allocation of its target object. The
+  /// write must immediately follow the allocation, so that no other
+  /// operation can observe the object in between, and its old-value
+  /// result must be unused. If the field is already in the initialiser
+  /// list its operand is replaced, otherwise the field is appended.
+  template<typename AllocOp>
+  struct FuseInitialization : public OpRewritePattern<verona::FieldWriteOp>
+  {
+    using OpRewritePattern<verona::FieldWriteOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(
+      verona::FieldWriteOp op, PatternRewriter& rewriter) const override
+    {
+      auto alloc = op.origin().getDefiningOp<AllocOp>();
+      if (!alloc || op.getOperation()->getPrevNode() != alloc)
+        return failure();
+      // The old value must be unused and the new value must not be the
+      // object being initialised.
+      if (!op.output().use_empty() || op.value() == alloc.output())
+        return failure();
+
+      llvm::SmallVector<Value, 4> fields(
+        alloc.fields().begin(), alloc.fields().end());
+      llvm::SmallVector<Attribute, 4> names(
+        alloc.field_names().begin(), alloc.field_names().end());
+      size_t index = 0;
+      while (index < names.size() &&
+             names[index].cast<StringAttr>().getValue() != op.field())
+        index++;
+      if (index < names.size())
+      {
+        fields[index] = op.value();
+      }
+      else
+      {
+        names.push_back(op.fieldAttr());
+        fields.push_back(op.value());
+      }
+
+      rewriter.setInsertionPoint(alloc);
+      auto fused = cloneAllocation(
+        rewriter, alloc, rewriter.getArrayAttr(names), fields);
+      rewriter.replaceOp(alloc, fused.output());
+      rewriter.eraseOp(op);
+      return success();
+    }
+  };
+}
+
 namespace mlir::verona
 {
   Type FieldReadOp::getFieldType()
@@ -55,6 +178,26 @@ namespace mlir::verona
   {
     return lookupFieldType(origin().getType(), field());
   }
+
+  void ViewOp::getCanonicalizationPatterns(
+    OwningRewritePatternList& results, MLIRContext* context)
+  {
+    results.insert<ViewOfView>(context);
+  }
+
+  void CopyOp::getCanonicalizationPatterns(
+    OwningRewritePatternList& results, MLIRContext* context)
+  {
+    results.insert<CopyOfCopy>(context);
+  }
+
+  void FieldWriteOp::getCanonicalizationPatterns(
+    OwningRewritePatternList& results, MLIRContext* context)
+  {
+    results.insert<
+      FuseInitialization<AllocateRegionOp>,
+      FuseInitialization<AllocateObjectOp>>(context);
+  }
 } // namespace mlir::verona
 
 #define GET_OP_CLASSES
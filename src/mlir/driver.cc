@@ -3,16 +3,20 @@
 
 #include "driver.h"
 
+#include "dialect/LowerToLLVM.h"
 #include "dialect/Typechecker.h"
 #include "generator.h"
 #include "mlir/Conversion/StandardToLLVM/ConvertStandardToLLVMPass.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/StandardOps/IR/Ops.h"
 #include "mlir/IR/Dialect.h"
 #include "mlir/IR/Verifier.h"
 #include "mlir/Parser.h"
 #include "mlir/Pass/Pass.h"
+#include "mlir/Target/LLVMIR.h"
 #include "mlir/Transforms/Passes.h"
 
+#include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/ToolOutputFile.h"
@@ -24,6 +28,7 @@ namespace mlir::verona
   {
     context.getOrLoadDialect<mlir::StandardOpsDialect>();
     context.getOrLoadDialect<mlir::verona::VeronaDialect>();
+    context.getOrLoadDialect<mlir::LLVM::LLVMDialect>();
 
     // Opaque operations and types can only exist if we allow
     // unregistered dialects to co-exist. Full conversions later will
@@ -84,19 +89,27 @@ namespace mlir::verona
     return llvm::Error::success();
   }
 
-  llvm::Error Driver::emitMLIR(llvm::StringRef filename)
+  llvm::Error Driver::runPasses()
   {
     assert(module);
 
-    if (filename.empty())
-      return runtimeError("No output filename provided");
-
     if (failed(passManager.run(module.get())))
     {
       module->dump();
       return runtimeError("Failed to run some passes");
     }
 
+    return llvm::Error::success();
+  }
+
+  llvm::Error Driver::emitMLIR(llvm::StringRef filename)
+  {
+    if (filename.empty())
+      return runtimeError("No output filename provided");
+
+    if (auto err = runPasses())
+      return err;
+
     // Write to the file requested
     std::error_code error;
     auto out = llvm::raw_fd_ostream(filename, error);
@@ -106,4 +119,38 @@ namespace mlir::verona
     module->print(out);
     return llvm::Error::success();
   }
+
+  llvm::Error Driver::emitLLVM(llvm::StringRef filename)
+  {
+    if (filename.empty())
+      return runtimeError("No output filename provided");
+
+    if (auto err = runPasses())
+      return err;
+
+    // Lower what the main pipeline left to the LLVM dialect. This runs
+    // separately from passManager so emitMLIR keeps producing the
+    // high-level module.
+    mlir::PassManager lower(&context);
+    lower.addPass(std::make_unique<LowerToLLVMPass>());
+    if (failed(lower.run(module.get())))
+    {
+      module->dump();
+      return runtimeError("Failed to lower the module to the LLVM dialect");
+    }
+
+    llvm::LLVMContext llvmContext;
+    auto llvmModule = mlir::translateModuleToLLVMIR(module.get(), llvmContext);
+    if (!llvmModule)
+      return runtimeError("Failed to translate the module to LLVM IR");
+
+    // Write to the file requested
+    std::error_code error;
+    auto out = llvm::raw_fd_ostream(filename, error);
+    if (error)
+      return runtimeError("Cannot open output filename");
+
+    llvmModule->print(out, nullptr);
+    return llvm::Error::success();
+  }
 }
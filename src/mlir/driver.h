@@ -43,7 +43,15 @@ namespace mlir::verona
     /// Emit the module as textual MLIR.
     llvm::Error emitMLIR(const llvm::StringRef filename);
 
+    /// Lower the module through the LLVM dialect and emit textual LLVM
+    /// IR, with runtime interaction as calls to the rt-abi.h symbols.
+    /// The output can be compiled and linked against verona-mlir-rt-abi.
+    llvm::Error emitLLVM(const llvm::StringRef filename);
+
   private:
+    /// Run the configured pass pipeline over the module.
+    llvm::Error runPasses();
+
     /// MLIR context.
     mlir::MLIRContext context;
 
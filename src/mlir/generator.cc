@@ -10,6 +10,10 @@
 #include "mlir/IR/Dialect.h"
 #include "mlir/IR/Types.h"
 
+#include "llvm/Support/Parallel.h"
+
+#include <mutex>
+
 namespace
 {
   /// Helper to make sure the basic block has a terminator
@@ -44,6 +48,11 @@ namespace mlir::verona
     if (auto err = gen.parseModule(ast))
       return std::move(err);
 
+    // With the module structure in place, lower the function bodies,
+    // in parallel if the context allows it.
+    if (auto err = gen.lowerBodies())
+      return std::move(err);
+
     return std::move(gen.module);
   }
 
@@ -80,7 +89,7 @@ namespace mlir::verona
     // Declare before building fields to allow for recursive declaration
     // If class is used in definitions before, it has been declared empty
     // already, so we use `update` to fetch it.
-    auto name = AST::getID(ast);
+    auto name = AST::getID(astIndex, ast);
     auto type = ClassType::get(context, name);
     typeTable.getOrAdd(name, type);
 
@@ -111,16 +120,20 @@ namespace mlir::verona
       else if (AST::isField(node))
       {
         // Get field name/type for class type declaration
-        auto fieldName = AST::getID(node);
+        auto fieldName = AST::getID(astIndex, node);
         auto fieldType = parseType(AST::getType(node));
         fields.push_back({fieldName, fieldType});
       }
       else if (AST::isFunction(node))
       {
-        // Methods
-        auto func = parseFunction(node);
+        // Methods: declare the signature now, keep the body for later.
+        // Bodies are lowered together once the module is complete, so
+        // that they can be lowered in parallel.
+        auto func = parseSignature(node);
         if (auto err = func.takeError())
           return std::move(err);
+        if (AST::hasFunctionBody(node))
+          bodies.push_back({*func, node});
         // Associate function with module (late mangling)
         func->getOperation()->setAttr("class", TypeAttr::get(type));
         // Add qualifiers as attributes
@@ -149,7 +162,7 @@ namespace mlir::verona
     return scope;
   }
 
-  llvm::Expected<mlir::FuncOp> Generator::parseFunction(const ::ast::Ast& ast)
+  llvm::Expected<mlir::FuncOp> Generator::parseSignature(const ::ast::Ast& ast)
   {
     assert(AST::isFunction(ast) && "Bad node");
 
@@ -162,59 +175,94 @@ namespace mlir::verona
       // This is wrong. Constraints are not aliases, but with
       // the oversimplified representaiton we have and the fluid
       // state of the type system, this will "work" for now.
-      auto alias = AST::getID(c);
+      auto alias = AST::getID(astIndex, c);
       auto ty = AST::getType(c);
       typeTable.insert(alias, parseType(ty));
     }
 
     // Function type from signature
-    llvm::SmallVector<llvm::StringRef, 4> argNames;
     Types types;
     llvm::SmallVector<::ast::Ast, 4> args;
     AST::getFunctionArgs(args, ast);
     for (auto arg : args)
-    {
-      argNames.push_back(AST::getID(arg));
       types.push_back(parseType(AST::getType(arg)));
-    }
 
     // Return type is nothing if no type
     llvm::SmallVector<mlir::Type, 1> retTy;
-    if (AST::hasType(AST::getFunctionType(ast)))
-      retTy.push_back(parseType(AST::getFunctionType(ast)));
+    auto retNode = AST::getFunctionType(ast);
+    if (AST::hasType(retNode))
+      retTy.push_back(parseType(retNode));
 
-    // If just declaration, return the proto value
+    // Declare function signature
     auto name = AST::getFunctionName(ast);
-    if (!AST::hasFunctionBody(ast))
+    auto proto = generateProto(getLocation(ast), name, types, retTy);
+    if (auto err = proto.takeError())
+      return std::move(err);
+    auto& func = *proto;
+
+    // Definitions get their entry block now, to be filled by
+    // parseFunctionBody (possibly on another thread).
+    if (AST::hasFunctionBody(ast))
+      func.addEntryBlock();
+
+    return func;
+  }
+
+  llvm::Error
+  Generator::parseFunctionBody(mlir::FuncOp func, const ::ast::Ast& ast)
+  {
+    assert(AST::isFunction(ast) && "Bad node");
+    auto loc = getLocation(ast);
+
+    // Re-establish the 'where' clause aliases for the body
+    TypeScopeT alias_scope(typeTable);
+    llvm::SmallVector<::ast::Ast, 4> constraints;
+    AST::getFunctionConstraints(constraints, ast);
+    for (auto c : constraints)
     {
-      // Declare function signature
-      auto proto = generateProto(getLocation(ast), name, types, retTy);
-      if (auto err = proto.takeError())
-        return std::move(err);
-      auto& func = *proto;
-      return func;
+      auto alias = AST::getID(astIndex, c);
+      auto ty = AST::getType(c);
+      typeTable.insert(alias, parseType(ty));
     }
 
-    // Declare all arguments on current scope
+    // Argument names, from the signature
+    llvm::SmallVector<llvm::StringRef, 4> argNames;
+    llvm::SmallVector<::ast::Ast, 4> args;
+    AST::getFunctionArgs(args, ast);
+    for (auto arg : args)
+      argNames.push_back(AST::getID(astIndex, arg));
+
+    // Declare all arguments on a new scope
     SymbolScopeT var_scope(symbolTable);
-    auto def =
-      generateEmptyFunction(getLocation(ast), name, argNames, types, retTy);
-    if (auto err = def.takeError())
-      return std::move(err);
-    auto& func = *def;
+    auto& entryBlock = func.getBody().front();
+    auto argVals = entryBlock.getArguments();
+    assert(argNames.size() == argVals.size() && "Argument/value mismatch");
+    builder.setInsertionPointToStart(&entryBlock);
+    for (auto var_val : llvm::zip(argNames, argVals))
+    {
+      // Get the argument name/value
+      auto name = std::get<0>(var_val);
+      auto value = std::get<1>(var_val);
+      // Allocate space in the stack & store the argument value
+      auto alloca = generateAlloca(loc, value.getType());
+      generateStore(loc, value, alloca);
+      // Associate the name with the alloca SSA value
+      symbolTable.insert(name, alloca);
+    }
 
     // Lower body
     auto body = AST::getFunctionBody(ast);
     auto last = parseNode(body);
     if (auto err = last.takeError())
-      return std::move(err);
+      return err;
 
     // Check if needs to return a value at all
     if (hasTerminator(builder.getBlock()))
-      return func;
+      return llvm::Error::success();
 
     // Return last value (or none)
     // TODO: Implement multiple return values for tuples
+    auto retTy = func.getType().getResults();
     bool hasLast = last->hasValue();
     bool hasRetTy = !retTy.empty();
     if (hasLast && hasRetTy)
@@ -222,20 +270,60 @@ namespace mlir::verona
       // Function has return value and there is a last value,
       // check types, cast if not the same, return.
       auto cast = generateAutoCast(last->get().getLoc(), last->get(), retTy[0]);
-      builder.create<mlir::ReturnOp>(getLocation(ast), cast);
+      builder.create<mlir::ReturnOp>(loc, cast);
     }
     else if (!hasRetTy)
     {
       // Function return value is void, ignore last value and return.
-      builder.create<mlir::ReturnOp>(getLocation(ast));
+      builder.create<mlir::ReturnOp>(loc);
     }
     else
     {
       // Has return type but no value, emit an error.
-      return parsingError("Function has no value to return", getLocation(ast));
+      return parsingError("Function has no value to return", loc);
     }
 
-    return func;
+    return llvm::Error::success();
+  }
+
+  llvm::Error Generator::lowerBodies()
+  {
+    if (bodies.empty())
+      return llvm::Error::success();
+
+    // Serial fallback, also used when threading was disabled on the
+    // context (e.g. for debugging).
+    if (bodies.size() == 1 || !context->isMultithreadingEnabled())
+    {
+      for (auto& body : bodies)
+      {
+        if (auto err = parseFunctionBody(body.first, body.second))
+          return err;
+      }
+      return llvm::Error::success();
+    }
+
+    // One worker per function. Workers share the (thread-safe) context
+    // but nothing else: each has its own builder, symbol tables and AST
+    // index, and starts from a copy of the types declared so far.
+    std::mutex errorLock;
+    std::vector<llvm::Error> errors;
+    llvm::parallelForEach(
+      bodies.begin(), bodies.end(), [&](auto& body) {
+        Generator worker(context);
+        worker.typeTable = typeTable;
+        if (auto err = worker.parseFunctionBody(body.first, body.second))
+        {
+          std::lock_guard<std::mutex> lock(errorLock);
+          errors.push_back(std::move(err));
+        }
+      });
+
+    // Report failures in one go, in no particular order.
+    llvm::Error result = llvm::Error::success();
+    for (auto& err : errors)
+      result = llvm::joinErrors(std::move(result), std::move(err));
+    return result;
   }
 
   mlir::Type Generator::generateType(llvm::StringRef name)
@@ -260,7 +348,7 @@ namespace mlir::verona
   {
     // Qualified types are references to classes
     if (AST::isQualType(ast))
-      return generateType(AST::getID(ast));
+      return generateType(AST::getID(astIndex, ast));
 
     assert(AST::isTypeHolder(ast) && "Bad node");
 
@@ -275,7 +363,7 @@ namespace mlir::verona
 
     // Simple types should work directly
     if (nodes.size() == 1)
-      return generateType(AST::getID(nodes[0]));
+      return generateType(AST::getID(astIndex, nodes[0]));
 
     // Composite types (meet, join) may require recursion
     llvm::SmallVector<mlir::Type, 1> types;
@@ -289,7 +377,7 @@ namespace mlir::verona
       // Direct nodes
       else
       {
-        types.push_back(generateType(AST::getID(node)));
+        types.push_back(generateType(AST::getID(astIndex, node)));
       }
     }
 
@@ -410,7 +498,7 @@ namespace mlir::verona
 
     // Else, it can either be a let (new variable)
     // or localref (existing variable).
-    auto name = AST::getLocalName(lhs);
+    auto name = AST::getLocalName(astIndex, lhs);
 
     // If the variable wasn't declared yet in this context, create an alloca
     if (AST::isLet(lhs))
@@ -440,12 +528,12 @@ namespace mlir::verona
     assert(
       (AST::isCall(ast) || AST::isInvoke(ast) || AST::isStaticCall(ast)) &&
       "Bad node");
-    auto name = AST::getID(ast);
+    auto name = AST::getID(astIndex, ast);
     auto loc = getLocation(ast);
 
     // Get arguments
     llvm::SmallVector<::ast::Ast, 1> nodes;
-    AST::getAllOperands(nodes, ast);
+    AST::getAllOperands(astIndex, nodes, ast);
     llvm::SmallVector<mlir::Value, 1> args;
     for (auto node : nodes)
     {
@@ -484,7 +572,7 @@ namespace mlir::verona
     else
     {
       // Static call: `func(a, b...)` | `Class.op(a, b...)`
-      auto qualType = AST::getStaticQualType(ast);
+      auto qualType = AST::getStaticQualType(astIndex, ast);
       auto type = parseType(qualType);
       auto descTy = DescriptorType::get(context, type);
       descriptor = builder.create<StaticOp>(loc, descTy, TypeAttr::get(type));
@@ -561,21 +649,22 @@ namespace mlir::verona
 
     // First node is a sequence of conditions
     // lower in the current basic block.
-    auto condNode = AST::getCond(ast);
+    auto condNode = AST::getCond(astIndex, ast);
     auto condLoc = getLocation(condNode);
     auto cond = parseNode(condNode);
     if (auto err = cond.takeError())
       return std::move(err);
 
     // Create basic-blocks, conditionally branch to if/else
+    auto hasElse = AST::hasElse(astIndex, ast);
     auto region = builder.getInsertionBlock()->getParent();
     mlir::ValueRange empty{};
     auto ifBB = addBlock(region);
     mlir::Block* elseBB = nullptr;
-    if (AST::hasElse(ast))
+    if (hasElse)
       elseBB = addBlock(region);
     auto exitBB = addBlock(region);
-    if (AST::hasElse(ast))
+    if (hasElse)
     {
       if (
         auto err =
@@ -595,7 +684,7 @@ namespace mlir::verona
       SymbolScopeT if_scope{symbolTable};
 
       // If block
-      auto ifNode = AST::getIfBlock(ast);
+      auto ifNode = AST::getIfBlock(astIndex, ast);
       auto ifLoc = getLocation(ifNode);
       builder.setInsertionPointToEnd(ifBB);
       auto ifBlock = parseNode(ifNode);
@@ -607,12 +696,12 @@ namespace mlir::verona
 
     // Else block
     // We don't need to lower the else part if it's empty
-    if (AST::hasElse(ast))
+    if (hasElse)
     {
       // Create local context for the else block variables
       SymbolScopeT else_scope{symbolTable};
 
-      auto elseNode = AST::getElseBlock(ast);
+      auto elseNode = AST::getElseBlock(astIndex, ast);
       auto elseLoc = getLocation(elseNode);
       builder.setInsertionPointToEnd(elseBB);
       auto elseBlock = parseNode(elseNode);
@@ -647,7 +736,7 @@ namespace mlir::verona
 
     // First node is a sequence of conditions
     // lower in the head basic block, with the conditional branch.
-    auto condNode = AST::getCond(ast);
+    auto condNode = AST::getCond(astIndex, ast);
     auto condLoc = getLocation(condNode);
     builder.setInsertionPointToEnd(headBB);
     auto cond = parseNode(condNode);
@@ -664,7 +753,7 @@ namespace mlir::verona
     loopTable.insert("tail", exitBB);
 
     // Loop body, branch back to head node which will decide exit criteria
-    auto bodyNode = AST::getLoopBlock(ast);
+    auto bodyNode = AST::getLoopBlock(astIndex, ast);
     auto bodyLoc = getLocation(bodyNode);
     builder.setInsertionPointToEnd(bodyBB);
     auto bodyBlock = parseNode(bodyNode);
@@ -708,7 +797,7 @@ namespace mlir::verona
     auto loc = getLocation(ast);
 
     // Class name
-    auto name = AST::getID(AST::getClassTypeRef(ast));
+    auto name = AST::getID(astIndex, AST::getClassTypeRef(ast));
     auto nameAttr = SymbolRefAttr::get(name, context);
 
     // Type to allocate
@@ -723,7 +812,7 @@ namespace mlir::verona
     {
       if (!AST::isField(node))
         continue;
-      fieldNames.push_back(StringAttr::get(AST::getID(node), context));
+      fieldNames.push_back(StringAttr::get(AST::getID(astIndex, node), context));
       auto expr = parseNode(AST::getInitExpr(node));
       if (auto err = expr.takeError())
         return std::move(err);
@@ -732,10 +821,10 @@ namespace mlir::verona
     auto fieldNameAttr = ArrayAttr::get(fieldNames, context);
     ValueRange inits{fieldValues};
 
-    if (AST::hasInRegion(ast))
+    if (AST::hasInRegion(astIndex, ast))
     {
       // If there's an `inreg`, allocate object on existing region
-      auto regionName = AST::getID(AST::getInRegion(ast));
+      auto regionName = AST::getID(astIndex, AST::getInRegion(astIndex, ast));
       auto regionObj = symbolTable.lookup(regionName);
       if (isAlloca(regionObj))
         regionObj = generateLoad(loc, regionObj);
@@ -757,11 +846,11 @@ namespace mlir::verona
     assert(AST::isMember(ast) && "Bad node");
 
     // Find the variable to extract from
-    auto ref = AST::getLocalRef(ast);
+    auto ref = AST::getLocalRef(astIndex, ast);
     auto var = symbolTable.lookup(ref);
 
     // Get the field name
-    auto field = AST::getID(ast);
+    auto field = AST::getID(astIndex, ast);
 
     // Find the field type, if any
     auto fieldType = unkTy;
@@ -780,11 +869,11 @@ namespace mlir::verona
     assert(AST::isMember(ast) && "Bad node");
 
     // Find the variable to extract from
-    auto ref = AST::getLocalRef(ast);
+    auto ref = AST::getLocalRef(astIndex, ast);
     auto var = symbolTable.lookup(ref);
 
     // Get the field name
-    auto field = AST::getID(ast);
+    auto field = AST::getID(astIndex, ast);
 
     // Find the field type
     auto fieldType = unkTy;
@@ -815,48 +904,6 @@ namespace mlir::verona
     return functionTable.insert(name, func);
   }
 
-  llvm::Expected<mlir::FuncOp> Generator::generateEmptyFunction(
-    mlir::Location loc,
-    llvm::StringRef name,
-    llvm::ArrayRef<llvm::StringRef> args,
-    llvm::ArrayRef<mlir::Type> types,
-    llvm::ArrayRef<mlir::Type> retTy)
-  {
-    assert(args.size() == types.size() && "Argument/type mismatch");
-
-    // If it's not declared yet, do so. This simplifies direct declaration of
-    // compiler functions. User functions should be checked at the parse level.
-    auto func = functionTable.inScope(name);
-    if (!func)
-    {
-      auto proto = generateProto(loc, name, types, retTy);
-      if (auto err = proto.takeError())
-        return std::move(err);
-      func = *proto;
-    }
-
-    // Create entry block, set builder entry point
-    auto& entryBlock = *func.addEntryBlock();
-    auto argVals = entryBlock.getArguments();
-    assert(args.size() == argVals.size() && "Argument/value mismatch");
-    builder.setInsertionPointToStart(&entryBlock);
-
-    // Declare all arguments
-    for (auto var_val : llvm::zip(args, argVals))
-    {
-      // Get the argument name/value
-      auto name = std::get<0>(var_val);
-      auto value = std::get<1>(var_val);
-      // Allocate space in the stack & store the argument value
-      auto alloca = generateAlloca(loc, value.getType());
-      generateStore(loc, value, alloca);
-      // Associate the name with the alloca SSA value
-      symbolTable.insert(name, alloca);
-    }
-
-    return func;
-  }
-
   llvm::Error Generator::generateCondBranch(
     mlir::Location loc,
     mlir::Value cond,
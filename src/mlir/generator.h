@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "ast-utils.h"
 #include "ast/ast.h"
 #include "dialect/VeronaOps.h"
 #include "dialect/VeronaTypes.h"
@@ -20,6 +21,8 @@
 
 #include <peglib.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace mlir::verona
 {
@@ -136,6 +139,10 @@ namespace mlir::verona
     /// Unknown location, for compiler generated stuff.
     mlir::Location unkLoc;
 
+    /// Child index for AST nodes, so repeated helper queries against the
+    /// same node don't re-scan its child list.
+    ASTIndex astIndex;
+
     /// Symbol tables for variables.
     SymbolTableT symbolTable;
     /// Symbol tables for functions.
@@ -150,6 +157,10 @@ namespace mlir::verona
     /// MLIR boolean type (int1).
     mlir::Type boolTy;
 
+    /// Function bodies found while declaring the module, lowered by
+    /// lowerBodies once the module structure is complete.
+    std::vector<std::pair<mlir::FuncOp, ::ast::Ast>> bodies;
+
     // ===================================================== Helpers
     // Methods for symbols, location and other helpers for building
     // MLIR nodes.
@@ -162,11 +173,22 @@ namespace mlir::verona
     // expected MLIR value or call the generators (see below) to do that for
     // them.
 
-    /// Parses a module, the global context.
+    /// Parses a module, the global context. This only declares classes and
+    /// function signatures; the bodies are lowered by lowerBodies.
     llvm::Error parseModule(const ::ast::Ast& ast);
 
-    /// Parses a function, from a top-level (module) view.
-    llvm::Expected<mlir::FuncOp> parseFunction(const ::ast::Ast& ast);
+    /// Lowers all function bodies collected while declaring the module.
+    /// Bodies are independent of each other (calls are by name, types are
+    /// uniqued in the thread-safe context), so with a multi-threaded
+    /// context each body gets its own worker generator and they all lower
+    /// in parallel, feeding the same module.
+    llvm::Error lowerBodies();
+
+    /// Parses a function signature, from a top-level (module) view.
+    /// Definitions get an empty entry block, filled by parseFunctionBody.
+    llvm::Expected<mlir::FuncOp> parseSignature(const ::ast::Ast& ast);
+    /// Lowers a function body into its already declared FuncOp.
+    llvm::Error parseFunctionBody(mlir::FuncOp func, const ::ast::Ast& ast);
     /// Parse a class declaration
     llvm::Expected<ModuleOp>
     parseClass(const ::ast::Ast& ast, mlir::Type parent = mlir::Type());
@@ -219,13 +241,6 @@ namespace mlir::verona
       llvm::StringRef name,
       llvm::ArrayRef<mlir::Type> types,
       llvm::ArrayRef<mlir::Type> retTy);
-    /// Generates an empty function (with the first basic block)
-    llvm::Expected<mlir::FuncOp> generateEmptyFunction(
-      mlir::Location loc,
-      llvm::StringRef name,
-      llvm::ArrayRef<llvm::StringRef> args,
-      llvm::ArrayRef<mlir::Type> types,
-      llvm::ArrayRef<mlir::Type> retTy);
     /// Generates a conditional branch, casting to i1 if necessary
     llvm::Error generateCondBranch(
       mlir::Location loc,
@@ -0,0 +1,195 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+
+#include "rt-abi.h"
+
+#include <memory>
+#include <verona.h>
+
+namespace rt = verona::rt;
+
+namespace
+{
+  /**
+   * Runtime descriptor for an AOT-compiled class, built lazily from the
+   * verona_class_t the lowering emitted and cached in its `impl` slot.
+   *
+   * This mirrors the interpreter's VMDescriptor, minus everything that
+   * needs bytecode: there are no user finalisers yet, so finalisation
+   * only collects the sub-regions held by iso fields.
+   */
+  struct AOTDescriptor;
+
+  /**
+   * Heap object layout for AOT-compiled classes: a dense array of object
+   * references, indexed by the field order of the class's FieldsRef. The
+   * parent chain resolves any object to its region entrypoint, as
+   * Region::alloc requires the Iso object (see VMObject::region).
+   */
+  struct AOTObject : public rt::Object
+  {
+    explicit AOTObject(AOTObject* region, const AOTDescriptor* desc);
+
+    std::unique_ptr<rt::Object*[]> fields;
+
+    const AOTDescriptor* descriptor() const;
+
+    AOTObject* region()
+    {
+      if (parent_ == nullptr)
+      {
+        return this;
+      }
+      else
+      {
+        parent_ = parent_->region();
+        return parent_;
+      }
+    }
+
+    static void trace_fn(const rt::Object* base_object, rt::ObjectStack& stack);
+    static void collect_iso_fields(
+      rt::Object* base_object,
+      rt::Object* region,
+      rt::ObjectStack& sub_regions);
+    static void destructor_fn(rt::Object* base_object);
+
+  private:
+    AOTObject* parent_;
+  };
+
+  struct AOTDescriptor : public rt::Descriptor
+  {
+    explicit AOTDescriptor(const verona_class_t* cls) : cls(cls)
+    {
+      rt::Descriptor::size = rt::vsizeof<AOTObject>;
+      rt::Descriptor::trace = AOTObject::trace_fn;
+      rt::Descriptor::finaliser = AOTObject::collect_iso_fields;
+
+      // As in VMDescriptor, objects without fields have a trivial
+      // destructor and can stay on the trivial ring.
+      rt::Descriptor::destructor =
+        cls->field_count > 0 ? AOTObject::destructor_fn : nullptr;
+    }
+
+    const verona_class_t* cls;
+  };
+
+  const AOTDescriptor* AOTObject::descriptor() const
+  {
+    return static_cast<const AOTDescriptor*>(rt::Object::get_descriptor());
+  }
+
+  AOTObject::AOTObject(AOTObject* region, const AOTDescriptor* desc)
+  : Object(), parent_(region)
+  {
+    if (desc->cls->field_count > 0)
+      fields = std::make_unique<rt::Object*[]>(desc->cls->field_count);
+    else
+      fields = nullptr;
+  }
+
+  void
+  AOTObject::trace_fn(const rt::Object* base_object, rt::ObjectStack& stack)
+  {
+    const AOTObject* object = static_cast<const AOTObject*>(base_object);
+    const verona_class_t* cls = object->descriptor()->cls;
+
+    for (size_t i = 0; i < cls->field_count; i++)
+    {
+      if (object->fields[i] != nullptr)
+        stack.push(object->fields[i]);
+    }
+  }
+
+  void AOTObject::collect_iso_fields(
+    rt::Object* base_object, rt::Object* region, rt::ObjectStack& sub_regions)
+  {
+    // Unlike the interpreter's fat FieldValues, plain pointers don't
+    // carry ownership, so which fields hold sub-region entrypoints comes
+    // from the class metadata instead.
+    UNUSED(region);
+
+    AOTObject* object = static_cast<AOTObject*>(base_object);
+    const verona_class_t* cls = object->descriptor()->cls;
+
+    for (size_t i = 0; i < cls->field_count; i++)
+    {
+      if (cls->iso_fields[i] && object->fields[i] != nullptr)
+        sub_regions.push(object->fields[i]);
+    }
+  }
+
+  void AOTObject::destructor_fn(rt::Object* base_object)
+  {
+    AOTObject* object = static_cast<AOTObject*>(base_object);
+    object->~AOTObject();
+  }
+
+  const AOTDescriptor* get_descriptor(verona_class_t* cls)
+  {
+    if (cls->impl == nullptr)
+      cls->impl = new AOTDescriptor(cls);
+    return static_cast<const AOTDescriptor*>(cls->impl);
+  }
+}
+
+extern "C"
+{
+  void verona_runtime_init(size_t cores)
+  {
+    rt::Scheduler& sched = rt::Scheduler::get();
+    sched.init(cores);
+  }
+
+  void verona_runtime_run()
+  {
+    rt::Scheduler::get().run();
+  }
+
+  void* verona_region_new(verona_class_t* cls)
+  {
+    const AOTDescriptor* descriptor = get_descriptor(cls);
+    rt::Alloc* alloc = rt::ThreadAlloc::get();
+    rt::Object* object = rt::RegionTrace::create(alloc, descriptor);
+    return new (object) AOTObject(nullptr, descriptor);
+  }
+
+  void* verona_object_new(void* object, verona_class_t* cls)
+  {
+    const AOTDescriptor* descriptor = get_descriptor(cls);
+    rt::Alloc* alloc = rt::ThreadAlloc::get();
+    AOTObject* region = static_cast<AOTObject*>(object)->region();
+    rt::Object* o = rt::Region::alloc(alloc, region, descriptor);
+    return new (o) AOTObject(region, descriptor);
+  }
+
+  void* verona_field_load(void* object, size_t index)
+  {
+    AOTObject* o = static_cast<AOTObject*>(object);
+    assert(index < o->descriptor()->cls->field_count);
+    return o->fields[index];
+  }
+
+  void* verona_field_store(void* object, size_t index, void* value)
+  {
+    AOTObject* o = static_cast<AOTObject*>(object);
+    assert(index < o->descriptor()->cls->field_count);
+    rt::Object* old = o->fields[index];
+    o->fields[index] = static_cast<rt::Object*>(value);
+    return old;
+  }
+
+  void verona_region_gc(void* object)
+  {
+    rt::Alloc* alloc = rt::ThreadAlloc::get();
+    AOTObject* region = static_cast<AOTObject*>(object)->region();
+    rt::RegionTrace::gc(alloc, region);
+  }
+
+  void verona_region_release(void* object)
+  {
+    rt::Alloc* alloc = rt::ThreadAlloc::get();
+    rt::Region::release(alloc, static_cast<AOTObject*>(object));
+  }
+}
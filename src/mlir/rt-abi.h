@@ -0,0 +1,94 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * C ABI between AOT-compiled Verona modules and the runtime.
+ *
+ * The LLVM lowering (dialect/LowerToLLVM.cc) emits calls to these
+ * symbols; rt-abi.cc implements them over the C++ runtime API. Native
+ * modules link against the verona-mlir-rt-abi library, which carries
+ * the runtime with it.
+ *
+ * Objects are opaque `void*` handles: pointers to runtime objects whose
+ * fields are a dense array of object references. The ABI is deliberately
+ * free of C++ types so generated code only ever manipulates pointers.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /**
+   * Per-class metadata, emitted by the lowering as a constant global.
+   *
+   * `iso_fields` points to `field_count` bytes, each non-zero when the
+   * corresponding field holds an owned (iso) reference; the runtime uses
+   * it to find sub-regions when a region is deallocated.
+   *
+   * `impl` caches the runtime descriptor built for the class on first
+   * use and must be initialized to null.
+   */
+  typedef struct verona_class
+  {
+    const char* name;
+    size_t field_count;
+    const unsigned char* iso_fields;
+    void* impl;
+  } verona_class_t;
+
+  /**
+   * Initialise the runtime with the given number of scheduler cores.
+   * Must be called once, before any other entry point.
+   */
+  void verona_runtime_init(size_t cores);
+
+  /**
+   * Run the scheduler until no work is left. Returns once all behaviours
+   * have completed.
+   */
+  void verona_runtime_run(void);
+
+  /**
+   * Allocate an object of class `cls` as the entrypoint of a new region.
+   * Returns an owned reference. All fields start out null.
+   */
+  void* verona_region_new(verona_class_t* cls);
+
+  /**
+   * Allocate an object of class `cls` in the region of `object`, which
+   * may be any object of that region. Returns an unowned reference. All
+   * fields start out null.
+   */
+  void* verona_object_new(void* object, verona_class_t* cls);
+
+  /**
+   * Read field `index` of `object`.
+   */
+  void* verona_field_load(void* object, size_t index);
+
+  /**
+   * Write `value` into field `index` of `object`, returning the field's
+   * previous value.
+   */
+  void* verona_field_store(void* object, size_t index, void* value);
+
+  /**
+   * Garbage-collect the region of `object`, which may be any object of
+   * that region.
+   */
+  void verona_region_gc(void* object);
+
+  /**
+   * Deallocate the region whose entrypoint is `object`, including any
+   * sub-regions reachable through iso fields.
+   */
+  void verona_region_release(void* object);
+
+#ifdef __cplusplus
+}
+#endif
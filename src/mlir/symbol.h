@@ -8,6 +8,8 @@
 #include "mlir/IR/Types.h"
 #include "mlir/IR/Value.h"
 
+#include <string_view>
+
 namespace mlir::verona
 {
   /**
@@ -30,9 +32,20 @@ namespace mlir::verona
   template<class T>
   class ScopedTable
   {
-    using MapTy = std::map<std::string, T>;
+    // Transparent comparator, so lookups can probe with a string view
+    // instead of allocating a std::string per frame.
+    using MapTy = std::map<std::string, T, std::less<>>;
     std::vector<MapTy> stack;
 
+    /// Cache of full-chain lookups, keyed by name, holding the epoch the
+    /// answer was computed in. The generator resolves the same names many
+    /// times between scope changes; each hit avoids walking every frame.
+    std::map<std::string, std::pair<size_t, T>, std::less<>> cache;
+
+    /// Bumped on every change to the stack or its contents, which
+    /// invalidates all cached lookups at once.
+    size_t epoch = 0;
+
   public:
     ScopedTable()
     {
@@ -60,6 +73,7 @@ namespace mlir::verona
     /// If insert=true, asserts if element already exist
     T getOrAdd(llvm::StringRef key, T value, bool insert = false)
     {
+      epoch++;
       auto& frame = stack.back();
       auto res = frame.emplace(key, value);
       if (insert)
@@ -78,27 +92,48 @@ namespace mlir::verona
     /// `lastContextOnly=true` only looks up in the local scope
     T lookup(llvm::StringRef key, bool lastContextOnly = false)
     {
+      std::string_view probe(key.data(), key.size());
+
+      // Scope-local probes don't walk the chain, not worth caching.
+      if (!lastContextOnly)
+      {
+        auto hit = cache.find(probe);
+        if (hit != cache.end() && hit->second.first == epoch)
+          return hit->second.second;
+      }
+
+      T found = nullptr;
       for (auto it = stack.rbegin(), end = stack.rend(); it != end; it++)
       {
         auto& frame = *it;
-        auto val = frame.find(key.str());
+        auto val = frame.find(probe);
         if (val != frame.end())
-          return val->second;
+        {
+          found = val->second;
+          break;
+        }
         if (lastContextOnly)
-          return nullptr;
+          break;
       }
-      return nullptr;
+
+      // Misses are cached too, they walk the whole chain.
+      if (!lastContextOnly)
+        cache.insert_or_assign(
+          std::string(probe), std::make_pair(epoch, found));
+      return found;
     }
 
     /// Creates a new scope
     void pushScope()
     {
+      epoch++;
       stack.emplace_back();
     }
 
     /// Destroys the inner-most scope
     void popScope()
     {
+      epoch++;
       stack.pop_back();
     }
   };
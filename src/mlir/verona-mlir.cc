@@ -51,6 +51,20 @@ namespace
     cl::ZeroOrMore,
     cl::init(0));
 
+  // Output kinds, to choose how far to lower
+  enum class OutputKind
+  {
+    MLIR,
+    LLVM
+  };
+  cl::opt<enum OutputKind> outputKind(
+    "emit",
+    cl::init(OutputKind::MLIR),
+    cl::desc("Output type"),
+    cl::values(clEnumValN(OutputKind::MLIR, "mlir", "MLIR file")),
+    cl::values(clEnumValN(
+      OutputKind::LLVM, "llvm", "LLVM IR file, for AOT compilation")));
+
   // Output file
   cl::opt<std::string> outputFile("o", cl::init(""), cl::desc("Output file"));
 
@@ -76,6 +90,10 @@ namespace
         inputKind = InputKind::Verona;
     }
 
+    // An explicit .ll output implies LLVM IR output
+    if (llvm::StringRef(outputFile).endswith(".ll"))
+      outputKind = OutputKind::LLVM;
+
     // Choose output file extension from output type
     // Careful with mlir->mlir not to overwrite source file
     if (outputFile.empty())
@@ -87,7 +105,9 @@ namespace
       else
       {
         llvm::SmallString<128> newName(inputFile);
-        if (inputKind == InputKind::MLIR)
+        if (outputKind == OutputKind::LLVM)
+          llvm::sys::path::replace_extension(newName, ".ll");
+        else if (inputKind == InputKind::MLIR)
           llvm::sys::path::replace_extension(newName, ".new.mlir");
         else
           llvm::sys::path::replace_extension(newName, ".mlir");
@@ -153,7 +173,16 @@ int main(int argc, char** argv)
       return 1;
   }
 
-  check(driver.emitMLIR(outputFile));
+  // Emit the output file (mlir/llvm)
+  switch (outputKind)
+  {
+    case OutputKind::MLIR:
+      check(driver.emitMLIR(outputFile));
+      break;
+    case OutputKind::LLVM:
+      check(driver.emitLLVM(outputFile));
+      break;
+  }
 
   return 0;
 }
@@ -4,188 +4,343 @@
 
 #include "pass.h"
 
+#include <unordered_set>
+
 namespace verona::parser::dnf
 {
-  Node<Type> single_union(Node<Type>& left, UnionType& right, Location& loc)
+  namespace
   {
-    // A & (B | C) -> (A & B) | (A & C)
-    auto un = std::make_shared<UnionType>();
-    un->location = loc;
-
-    for (auto& type : right.types)
+    // Structural fingerprint of a type: fnv-1a over the node kinds, the
+    // source text of their name and literal fields, and the tree shape.
+    // Normalization only ever combines types from a single type
+    // expression, so two types that print the same text name the same
+    // type and fingerprint equality can stand in for structural
+    // equality.
+    struct Hash
     {
-      auto isect = std::make_shared<IsectType>();
-      isect->location = type->location;
-      isect->types.push_back(left);
-      isect->types.push_back(type);
-      un->types.push_back(isect);
-    }
-
-    return un;
-  }
-
-  Node<Type> isect_union(IsectType& left, UnionType& right, Location& loc)
-  {
-    // (A & B) & (C | D) -> (A & B & C) | (A & B & D)
-    auto un = std::make_shared<UnionType>();
-    un->location = loc;
-
-    for (auto& type : right.types)
-    {
-      auto isect = std::make_shared<IsectType>();
-      isect->location = left.location.range(right.location);
-      isect->location = type->location;
-      isect->types = left.types;
-      isect->types.push_back(type);
-      un->types.push_back(isect);
-    }
+      uint64_t hash = 0xcbf29ce484222325;
 
-    return un;
-  }
+      void feed(const char* data, size_t size)
+      {
+        for (size_t i = 0; i < size; i++)
+        {
+          hash = hash ^ static_cast<uint8_t>(data[i]);
+          hash = hash * 0x100000001b3;
+        }
+      }
 
-  Node<Type> union_union(UnionType& left, UnionType& right, Location& loc)
-  {
-    // (A | B) & (C | D) -> (A & C) | (A & D) | (B & C) | (B & D)
-    auto un = std::make_shared<UnionType>();
-    un->location = loc;
+      void feed(uint64_t value)
+      {
+        feed(reinterpret_cast<const char*>(&value), sizeof(value));
+      }
 
-    for (auto& ltype : left.types)
-    {
-      assert(ltype->kind() != Kind::UnionType);
+      void operator()() {}
 
-      for (auto& rtype : right.types)
+      template<typename T>
+      void operator()(T& node)
       {
-        auto isect = std::make_shared<IsectType>();
-        isect->location = ltype->location.range(rtype->location);
-        auto& types = isect->types;
+        *this << fields(node);
+      }
 
-        if (ltype->kind() == Kind::IsectType)
-          types = ltype->as<IsectType>().types;
+      Hash& operator<<(Location& loc)
+      {
+        if (loc.source)
+        {
+          auto view = loc.view();
+          feed(view.data(), view.size());
+          feed(view.size());
+        }
         else
-          types.push_back(ltype);
+        {
+          feed(uint64_t(0));
+        }
+
+        return *this;
+      }
 
-        if (rtype->kind() == Kind::IsectType)
+      template<typename T>
+      Hash& operator<<(Node<T>& node)
+      {
+        if (node)
         {
-          auto& rtypes = rtype->as<IsectType>().types;
-          types.insert(types.end(), rtypes.begin(), rtypes.end());
+          feed(static_cast<uint64_t>(node->kind()));
+          dispatch(*this, node);
         }
         else
         {
-          types.push_back(rtype);
+          feed(~uint64_t(0));
         }
 
-        un->types.push_back(isect);
+        return *this;
+      }
+
+      template<typename T>
+      Hash& operator<<(List<T>& nodes)
+      {
+        feed(nodes.size());
+
+        for (auto& node : nodes)
+          *this << node;
+
+        return *this;
       }
+    };
+
+    uint64_t fingerprint(Cache& cache, Node<Type>& type)
+    {
+      auto find = cache.fingerprints.find(type.get());
+
+      if (find != cache.fingerprints.end())
+        return find->second.second;
+
+      Hash h;
+      h << type;
+      cache.fingerprints.emplace(type.get(), std::make_pair(type, h.hash));
+      return h.hash;
     }
 
-    return un;
-  }
+    uint64_t bit(uint64_t fp)
+    {
+      return uint64_t(1) << (fp & 63);
+    }
 
-  Node<Type> conjunction(Node<Type>& left, Node<Type>& right, Location& loc)
-  {
-    switch (left->kind())
+    void add_conjunct(Cache& cache, List<Type>& types, Node<Type>& type)
     {
-      case Kind::IsectType:
+      auto fp = fingerprint(cache, type);
+
+      for (auto& t : types)
       {
-        auto lhs = left->as<IsectType>();
+        if (fingerprint(cache, t) == fp)
+          return;
+      }
 
-        switch (right->kind())
-        {
-          case Kind::IsectType:
-          {
-            auto rhs = right->as<IsectType>();
+      types.push_back(type);
+    }
 
-            for (auto& type : rhs.types)
-              lhs.types.push_back(type);
+    bool has_conjunct(Cache& cache, Node<Type>& disjunct, uint64_t fp)
+    {
+      if (disjunct->kind() == Kind::IsectType)
+      {
+        for (auto& t : disjunct->as<IsectType>().types)
+        {
+          if (fingerprint(cache, t) == fp)
+            return true;
+        }
 
-            return left;
-          }
+        return false;
+      }
 
-          case Kind::UnionType:
-            return dnf::isect_union(lhs, right->as<UnionType>(), loc);
+      return fingerprint(cache, disjunct) == fp;
+    }
 
-          default:
-          {
-            lhs.types.push_back(right);
-            return left;
-          }
+    // l subsumes r when every conjunct of l is a conjunct of r, so that
+    // A | (A & B) collapses to A.
+    bool subsumes(Cache& cache, Node<Type>& l, Node<Type>& r)
+    {
+      if (l->kind() == Kind::IsectType)
+      {
+        for (auto& t : l->as<IsectType>().types)
+        {
+          if (!has_conjunct(cache, r, fingerprint(cache, t)))
+            return false;
         }
+
+        return true;
       }
 
-      case Kind::UnionType:
-      {
-        auto lhs = left->as<UnionType>();
+      return has_conjunct(cache, r, fingerprint(cache, l));
+    }
 
-        switch (right->kind())
+    // Accumulates the disjuncts of a union under construction, dropping
+    // duplicates and subsumed disjuncts as they arrive. A signature
+    // word - one bit per conjunct fingerprint - gives an early exit for
+    // the subset test, so a disjunct that can't possibly subsume
+    // another is rejected on a single mask comparison.
+    struct Disjuncts
+    {
+      Cache& cache;
+      List<Type> types;
+      std::vector<uint64_t> sigs;
+      std::unordered_set<uint64_t> seen;
+
+      Disjuncts(Cache& cache) : cache(cache) {}
+
+      uint64_t signature(Node<Type>& type)
+      {
+        if (type->kind() == Kind::IsectType)
         {
-          case Kind::IsectType:
-            return dnf::isect_union(right->as<IsectType>(), lhs, loc);
+          uint64_t sig = 0;
 
-          case Kind::UnionType:
-            return dnf::union_union(lhs, right->as<UnionType>(), loc);
+          for (auto& t : type->as<IsectType>().types)
+            sig |= bit(fingerprint(cache, t));
 
-          default:
-            return dnf::single_union(right, lhs, loc);
+          return sig;
         }
+
+        return bit(fingerprint(cache, type));
       }
 
-      default:
+      void add(Node<Type>& type)
       {
-        switch (right->kind())
+        // A duplicate of a disjunct seen before is either still present
+        // or was subsumed by something that also subsumes this one.
+        if (!seen.insert(fingerprint(cache, type)).second)
+          return;
+
+        auto sig = signature(type);
+
+        for (size_t i = 0; i < types.size(); i++)
         {
-          case Kind::IsectType:
-          {
-            auto rhs = right->as<IsectType>();
-            rhs.types.push_back(left);
-            return right;
-          }
+          if (((sigs[i] & ~sig) == 0) && subsumes(cache, types[i], type))
+            return;
+        }
 
-          case Kind::UnionType:
-            return dnf::single_union(left, right->as<UnionType>(), loc);
+        size_t keep = 0;
 
-          default:
-          {
-            auto isect = std::make_shared<IsectType>();
-            isect->location = loc;
-            isect->types.push_back(left);
-            isect->types.push_back(right);
-            return isect;
-          }
+        for (size_t i = 0; i < types.size(); i++)
+        {
+          if (((sig & ~sigs[i]) == 0) && subsumes(cache, type, types[i]))
+            continue;
+
+          types[keep] = types[i];
+          sigs[keep] = sigs[i];
+          keep++;
         }
+
+        types.resize(keep);
+        sigs.resize(keep);
+        types.push_back(type);
+        sigs.push_back(sig);
+      }
+    };
+
+    // Conjoin two types that are free of union types, flattening
+    // intersections and dropping repeated conjuncts. The conjuncts of
+    // the left operand come first.
+    Node<Type> conjoin(
+      Cache& cache, Node<Type>& left, Node<Type>& right, Location& loc)
+    {
+      auto isect = std::make_shared<IsectType>();
+      isect->location = loc;
+
+      if (left->kind() == Kind::IsectType)
+        isect->types = left->as<IsectType>().types;
+      else
+        isect->types.push_back(left);
+
+      if (right->kind() == Kind::IsectType)
+      {
+        for (auto& type : right->as<IsectType>().types)
+          add_conjunct(cache, isect->types, type);
       }
+      else
+      {
+        add_conjunct(cache, isect->types, right);
+      }
+
+      if (isect->types.size() == 1)
+        return isect->types.front();
+
+      return isect;
     }
   }
 
-  Node<Type> disjunction(Node<Type>& left, Node<Type>& right, Location& loc)
+  Node<Type> conjunction(
+    Cache& cache, Node<Type>& left, Node<Type>& right, Location& loc)
   {
-    if (left->kind() == Kind::UnionType)
+    auto key = std::make_pair(left.get(), right.get());
+    auto find = cache.conjunction.find(key);
+
+    if (find != cache.conjunction.end())
+      return find->second.result;
+
+    Node<Type> result;
+
+    if (
+      (left->kind() == Kind::UnionType) || (right->kind() == Kind::UnionType))
     {
-      auto& lhs = left->as<UnionType>().types;
+      // A & (B | C) -> (A & B) | (A & C)
+      // (A | B) & (C | D) -> (A & C) | (A & D) | (B & C) | (B & D)
+      // Each pair of disjuncts is memoized in its own right, so a pair
+      // that occurs repeatedly is expanded once and the result shared.
+      List<Type> lone;
+      List<Type> rone;
+      List<Type>* ltypes = &lone;
+      List<Type>* rtypes = &rone;
+
+      if (left->kind() == Kind::UnionType)
+        ltypes = &left->as<UnionType>().types;
+      else
+        lone.push_back(left);
 
       if (right->kind() == Kind::UnionType)
+        rtypes = &right->as<UnionType>().types;
+      else
+        rone.push_back(right);
+
+      Disjuncts dis(cache);
+
+      for (auto& ltype : *ltypes)
+      {
+        for (auto& rtype : *rtypes)
+        {
+          auto isect = conjunction(cache, ltype, rtype, loc);
+          dis.add(isect);
+        }
+      }
+
+      if (dis.types.size() == 1)
       {
-        auto& rhs = right->as<UnionType>().types;
-        lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+        result = dis.types.front();
       }
       else
       {
-        lhs.push_back(right);
+        auto un = std::make_shared<UnionType>();
+        un->location = loc;
+        un->types = std::move(dis.types);
+        result = un;
       }
+    }
+    else
+    {
+      result = conjoin(cache, left, right, loc);
+    }
+
+    cache.conjunction.emplace(key, Cache::Entry{left, right, result});
+    return result;
+  }
+
+  Node<Type> disjunction(
+    Cache& cache, Node<Type>& left, Node<Type>& right, Location& loc)
+  {
+    Disjuncts dis(cache);
 
-      return left;
+    if (left->kind() == Kind::UnionType)
+    {
+      for (auto& type : left->as<UnionType>().types)
+        dis.add(type);
+    }
+    else
+    {
+      dis.add(left);
     }
 
     if (right->kind() == Kind::UnionType)
     {
-      auto& rhs = right->as<UnionType>().types;
-      rhs.push_back(left);
-      return right;
+      for (auto& type : right->as<UnionType>().types)
+        dis.add(type);
+    }
+    else
+    {
+      dis.add(right);
     }
 
+    if (dis.types.size() == 1)
+      return dis.types.front();
+
     auto un = std::make_shared<UnionType>();
     un->location = loc;
-    un->types.push_back(left);
-    un->types.push_back(right);
+    un->types = std::move(dis.types);
     return un;
   }
 
@@ -5,18 +5,47 @@
 #include "ast.h"
 
 #include <iostream>
+#include <map>
 
 namespace verona::parser::dnf
 {
+  // Memoizes normalization work. Mechanically generated types fold the
+  // same unions and intersections together many times over; with the
+  // cache, each distinct pair of operands is expanded once and the
+  // resulting nodes are shared. The entries keep their nodes alive so a
+  // recycled address can't alias a stale key. One cache per Parse
+  // instance, so no synchronization is needed.
+  struct Cache
+  {
+    struct Entry
+    {
+      Node<Type> left;
+      Node<Type> right;
+      Node<Type> result;
+    };
+
+    // Conjunction results, keyed on the identity of the operand pair.
+    std::map<std::pair<Type*, Type*>, Entry> conjunction;
+
+    // Structural fingerprints of type nodes, keyed on node identity.
+    // Fingerprints stand in for structural equality when deciding that
+    // one disjunct subsumes another.
+    std::map<Type*, std::pair<Node<Type>, uint64_t>> fingerprints;
+  };
+
   // This distributes & over | in the type system, producing a disjunctive
   // normal form type. The two types are any two types that are in an
-  // intersection type together.
-  Node<Type> conjunction(Node<Type>& left, Node<Type>& right, Location& loc);
+  // intersection type together. The operands are not modified; repeated
+  // conjuncts and subsumed disjuncts are dropped as the result is built,
+  // so A & A collapses to A and A | (A & B) collapses to A.
+  Node<Type> conjunction(
+    Cache& cache, Node<Type>& left, Node<Type>& right, Location& loc);
 
   // This applies | to any two types that are in a union type together. If one
   // or both types are themselves union types, it will collapse them into a
-  // single union type.
-  Node<Type> disjunction(Node<Type>& left, Node<Type>& right, Location& loc);
+  // single union type, dropping subsumed disjuncts in the same way.
+  Node<Type> disjunction(
+    Cache& cache, Node<Type>& left, Node<Type>& right, Location& loc);
 
   // This checks if types are in disjunctive normal form.
   bool wellformed(Ast& ast, std::ostream& out = std::cerr);
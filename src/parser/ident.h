@@ -5,26 +5,51 @@
 #include "lexer.h"
 
 #include <cstring>
+#include <mutex>
 
 namespace verona::parser
 {
   struct Ident
   {
-    Source store;
-    size_t hygienic;
+    // The store and the hygienic counter are shared between copies and
+    // interning takes a lock, so parallel parsers (see parser.cc) can
+    // hand each worker a copy of one Ident and intern into a single
+    // store.
+    struct State
+    {
+      Source store;
+      size_t hygienic = 0;
+      std::mutex mutex;
+    };
+
+    std::shared_ptr<State> state;
+
+    // Hygienic names are usually drawn from the shared counter. A copy
+    // given its own scope (see the parallel file parsing in parser.cc)
+    // draws from a private counter under a distinct prefix instead, so
+    // the generated names are deterministic under scheduling and still
+    // unique across files. '$' cannot appear in source identifiers, so
+    // neither form can collide with user names.
+    std::string scope;
+    size_t scoped_hygienic = 0;
 
-    Ident() : hygienic(0)
+    Ident()
     {
-      store = std::make_shared<SourceDef>();
+      state = std::make_shared<State>();
+      state->store = std::make_shared<SourceDef>();
     }
 
     Location operator()(const char* text = "")
     {
       auto len = std::strlen(text);
+      std::lock_guard<std::mutex> guard(state->mutex);
+      auto& store = state->store;
 
       if (len == 0)
       {
-        auto h = "$" + std::to_string(hygienic++);
+        auto h = scope.empty() ?
+          "$" + std::to_string(state->hygienic++) :
+          scope + std::to_string(scoped_hygienic++);
         auto pos = store->contents.size();
         store->contents.append(h);
         len = h.size();
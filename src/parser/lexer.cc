@@ -4,6 +4,10 @@
 
 #include "escaping.h"
 
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
 namespace verona::parser
 {
   constexpr uint8_t X = 0; // Invalid
@@ -93,6 +97,137 @@ namespace verona::parser
     return ((c >= '0') && (c <= '1')) || (c == '_');
   }
 
+  // Bulk scanning kernels. Long runs - whitespace, identifiers, string and
+  // comment bodies - dominate lexing time, so they are classified 16 bytes
+  // at a time where SSE2 is available, with a scalar loop as both the tail
+  // and the fallback. All source ranges of interest are plain ASCII, so
+  // signed byte compares are safe: bytes >= 0x80 fail every range check
+  // and fall out of the run, exactly like the lookup table classifies
+  // them.
+
+#if defined(__SSE2__)
+  size_t first_match(uint32_t mask)
+  {
+    return static_cast<size_t>(__builtin_ctz(mask));
+  }
+#endif
+
+  /**
+   * Returns the index of the first non-whitespace character at or after i.
+   */
+  size_t skip_whitespace(const std::string& text, size_t i)
+  {
+#if defined(__SSE2__)
+    while ((i + 16) <= text.size())
+    {
+      __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+      __m128i ws = _mm_or_si128(
+        _mm_or_si128(
+          _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')),
+          _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+        _mm_or_si128(
+          _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')),
+          _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))));
+
+      uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_epi8(ws)) & 0xffff;
+      if (mask != 0)
+        return i + first_match(mask);
+
+      i += 16;
+    }
+#endif
+
+    while (i < text.size())
+    {
+      char c = text[i];
+      if ((c != ' ') && (c != '\t') && (c != '\r') && (c != '\n'))
+        break;
+      i++;
+    }
+    return i;
+  }
+
+  /**
+   * Returns the index of the first character at or after i that cannot
+   * continue an identifier, ie. anything but [A-Za-z0-9_'].
+   */
+  size_t scan_ident(const std::string& text, size_t i)
+  {
+#if defined(__SSE2__)
+    auto in_range = [](__m128i chunk, char lo, char hi) {
+      return _mm_and_si128(
+        _mm_cmpgt_epi8(chunk, _mm_set1_epi8(lo - 1)),
+        _mm_cmplt_epi8(chunk, _mm_set1_epi8(hi + 1)));
+    };
+
+    while ((i + 16) <= text.size())
+    {
+      __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+      __m128i cont = _mm_or_si128(
+        _mm_or_si128(
+          in_range(chunk, '0', '9'), in_range(chunk, 'A', 'Z')),
+        _mm_or_si128(
+          in_range(chunk, 'a', 'z'),
+          _mm_or_si128(
+            _mm_cmpeq_epi8(chunk, _mm_set1_epi8('_')),
+            _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\'')))));
+
+      uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_epi8(cont)) & 0xffff;
+      if (mask != 0)
+        return i + first_match(mask);
+
+      i += 16;
+    }
+#endif
+
+    while (i < text.size())
+    {
+      char c = text[i];
+      bool cont = ((c >= '0') && (c <= '9')) || ((c >= 'A') && (c <= 'Z')) ||
+        ((c >= 'a') && (c <= 'z')) || (c == '_') || (c == '\'');
+      if (!cont)
+        break;
+      i++;
+    }
+    return i;
+  }
+
+  /**
+   * Returns the index of the first occurrence of either delimiter at or
+   * after i, or the end of the text.
+   */
+  size_t
+  scan_delimiters(const std::string& text, size_t i, char first, char second)
+  {
+#if defined(__SSE2__)
+    while ((i + 16) <= text.size())
+    {
+      __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+      __m128i hit = _mm_or_si128(
+        _mm_cmpeq_epi8(chunk, _mm_set1_epi8(first)),
+        _mm_cmpeq_epi8(chunk, _mm_set1_epi8(second)));
+
+      uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+      if (mask != 0)
+        return i + first_match(mask);
+
+      i += 16;
+    }
+#endif
+
+    while (i < text.size())
+    {
+      char c = text[i];
+      if ((c == first) || (c == second))
+        break;
+      i++;
+    }
+    return i;
+  }
+
   uint8_t next(Source& source, size_t& i)
   {
     if ((i + 1) < source->contents.size())
@@ -205,6 +340,15 @@ namespace verona::parser
 
     while (++i < source->contents.size())
     {
+      if (!backslash)
+      {
+        // Only the delimiter and a backslash affect the state machine;
+        // skip straight to the next one.
+        i = scan_delimiters(source->contents, i, '\\', '\'');
+        if (i >= source->contents.size())
+          break;
+      }
+
       switch (source->contents[i])
       {
         case '\\':
@@ -247,6 +391,15 @@ namespace verona::parser
 
     while (++i < source->contents.size())
     {
+      if (!backslash)
+      {
+        // Only the delimiter and a backslash affect the state machine;
+        // skip straight to the next one.
+        i = scan_delimiters(source->contents, i, '\\', '\"');
+        if (i >= source->contents.size())
+          break;
+      }
+
       switch (source->contents[i])
       {
         case '\\':
@@ -297,6 +450,15 @@ namespace verona::parser
 
     while (++i < source->contents.size())
     {
+      if ((state == State::Nesting) && (count == 0))
+      {
+        // In this state every character other than the two quotes leaves
+        // the state machine where it is; skip straight to the next quote.
+        i = scan_delimiters(source->contents, i, '\"', '\'');
+        if (i >= source->contents.size())
+          break;
+      }
+
       switch (source->contents[i])
       {
         case '\"':
@@ -384,14 +546,9 @@ namespace verona::parser
 
   void consume_line_comment(Source& source, size_t& i)
   {
-    while (++i < source->contents.size())
-    {
-      if (source->contents[i] == '\n')
-      {
-        i++;
-        break;
-      }
-    }
+    i = scan_delimiters(source->contents, i + 1, '\n', '\n');
+    if (i < source->contents.size())
+      i++;
   }
 
   void consume_nested_comment(Source& source, size_t& i)
@@ -408,6 +565,15 @@ namespace verona::parser
 
     while (++i < source->contents.size())
     {
+      if (state == State::Other)
+      {
+        // Skip straight to the next character that could open or close a
+        // nested comment.
+        i = scan_delimiters(source->contents, i, '/', '*');
+        if (i >= source->contents.size())
+          break;
+      }
+
       auto c = source->contents[i];
 
       switch (c)
@@ -626,18 +792,8 @@ namespace verona::parser
   {
     auto start = i;
 
-    while (++i < source->contents.size())
-    {
-      auto c = lookup[source->contents[i]];
-
-      // Idents and numbers are valid ident continuations.
-      if ((c != I) && (c != N))
-      {
-        // Prime is the only other thing that's a valid ident continuation.
-        if ((c != Q) || (source->contents[i] != '\''))
-          break;
-      }
-    }
+    // Idents, numbers and primes are valid ident continuations.
+    i = scan_ident(source->contents, i + 1);
 
     Token tok{TokenKind::Ident, {source, start, i - 1}};
 
@@ -716,7 +872,7 @@ namespace verona::parser
         case W:
         {
           // Skip whitespace.
-          i++;
+          i = skip_whitespace(source->contents, i + 1);
           break;
         }
 
@@ -7,11 +7,14 @@
 
 namespace verona::parser
 {
-  AstPaths
-  look_down_all(AstPaths& paths, const Location& name, bool from_using);
+  AstPaths look_down_all(
+    LookupCache& cache, AstPaths& paths, const Location& name, bool from_using);
 
-  AstPaths
-  look_in_with_using(AstPath& path, const Location& name, bool from_using);
+  AstPaths look_in_with_using(
+    LookupCache& cache, AstPath& path, const Location& name, bool from_using);
+
+  AstPaths look_up(
+    LookupCache& cache, AstPath& path, const Location& name, bool from_using);
 
   void add(AstPaths& rs, AstPath& r)
   {
@@ -39,7 +42,11 @@ namespace verona::parser
   }
 
   AstPaths look_in_definition(
-    AstPath& path, Node<Type>& type, const Location& name, bool from_using)
+    LookupCache& cache,
+    AstPath& path,
+    Node<Type>& type,
+    const Location& name,
+    bool from_using)
   {
     // We have a type which is the definition of a type alias or the upper
     // bounds of a type parameter. We want to look inside that type for a
@@ -54,14 +61,15 @@ namespace verona::parser
       {
         // Lookup through the right-hand side of the type pair.
         return look_in_definition(
-          path, type->as<TypePair>().right, name, from_using);
+          cache, path, type->as<TypePair>().right, name, from_using);
       }
 
       case Kind::TypeRef:
       {
         // Look up this type and look down from there.
-        auto paths = look_up(path, type->as<TypeRef>().typenames, from_using);
-        return look_down_all(paths, name, from_using);
+        auto paths =
+          look_up(cache, path, type->as<TypeRef>().typenames, from_using);
+        return look_down_all(cache, paths, name, from_using);
       }
 
       case Kind::IsectType:
@@ -72,7 +80,7 @@ namespace verona::parser
 
         for (auto& type : isect.types)
         {
-          auto find = look_in_definition(path, type, name, from_using);
+          auto find = look_in_definition(cache, path, type, name, from_using);
           add(rs, find);
         }
 
@@ -84,7 +92,8 @@ namespace verona::parser
     }
   }
 
-  AstPaths look_down(AstPath& path, const Location& name, bool from_using)
+  AstPaths look_down(
+    LookupCache& cache, AstPath& path, const Location& name, bool from_using)
   {
     // This looks for `name` in the last element of `path`.
     if (path.empty())
@@ -99,19 +108,19 @@ namespace verona::parser
       {
         // If we are looking up in an entity, expect to find the name in the
         // entity's symbol table.
-        return look_in_with_using(path, name, from_using);
+        return look_in_with_using(cache, path, name, from_using);
       }
 
       case Kind::TypeAlias:
       {
         auto& type = def->as<TypeAlias>().type;
-        return look_in_definition(path, type, name, from_using);
+        return look_in_definition(cache, path, type, name, from_using);
       }
 
       case Kind::TypeParam:
       {
         auto& type = def->as<TypeParam>().type;
-        return look_in_definition(path, type, name, from_using);
+        return look_in_definition(cache, path, type, name, from_using);
       }
 
       default:
@@ -119,7 +128,8 @@ namespace verona::parser
     }
   }
 
-  AstPaths look_down_all(AstPaths& paths, const Location& name, bool from_using)
+  AstPaths look_down_all(
+    LookupCache& cache, AstPaths& paths, const Location& name, bool from_using)
   {
     // Find `name` by looking down from every path in `paths`.
     // This will yield some number of new paths.
@@ -127,7 +137,7 @@ namespace verona::parser
 
     for (auto& path : paths)
     {
-      auto rs2 = look_down(path, name, from_using);
+      auto rs2 = look_down(cache, path, name, from_using);
       add(rs, rs2);
     }
 
@@ -149,8 +159,8 @@ namespace verona::parser
     return find->second;
   }
 
-  AstPaths
-  look_in_with_using(AstPath& path, const Location& name, bool from_using)
+  AstPaths look_in_with_using(
+    LookupCache& cache, AstPath& path, const Location& name, bool from_using)
   {
     if (path.empty())
       return {};
@@ -161,6 +171,22 @@ namespace verona::parser
     if (!st)
       return {};
 
+    // What a non-entity scope contributes depends on where `name`
+    // occurs, because its `using` statements only apply to later names
+    // in the same file, so those answers can't be shared between
+    // occurrences.
+    bool cacheable =
+      is_kind(ast, {Kind::Class, Kind::Interface}) || st->use.empty();
+    LookupCache::Key key{ast.get(), name, from_using};
+
+    if (cacheable)
+    {
+      auto prev = cache.map.find(key);
+
+      if (prev != cache.map.end())
+        return prev->second;
+    }
+
     // Look in this node's symbol table.
     AstPaths rs;
     auto find = st->map.find(name);
@@ -173,7 +199,12 @@ namespace verona::parser
     }
 
     if (from_using)
+    {
+      if (cacheable)
+        cache.map.emplace(key, rs);
+
       return rs;
+    }
 
     for (auto it = st->use.rbegin(); it != st->use.rend(); ++it)
     {
@@ -194,11 +225,15 @@ namespace verona::parser
       // Note that we don't follow `using` once we are following a `using`.
       // A `using` statement doesn't export the names being used, it only
       // imports them for use locally.
-      auto rs2 = look_up(path, use->type->as<TypeRef>().typenames, true);
-      rs2 = look_down_all(rs2, name, true);
+      auto rs2 =
+        look_up(cache, path, use->type->as<TypeRef>().typenames, true);
+      rs2 = look_down_all(cache, rs2, name, true);
       add(rs, rs2);
     }
 
+    if (cacheable)
+      cache.map.emplace(key, rs);
+
     return rs;
   }
 
@@ -221,7 +256,8 @@ namespace verona::parser
     return {};
   }
 
-  AstPaths look_up(AstPath& path, const Location& name, bool from_using)
+  AstPaths look_up(
+    LookupCache& cache, AstPath& path, const Location& name, bool from_using)
   {
     if (path.empty())
       return {};
@@ -232,30 +268,34 @@ namespace verona::parser
     for (auto it = path.rbegin(); it != path.rend(); ++it)
     {
       AstPath r{begin, it.base()};
-      auto rs2 = look_in_with_using(r, name, from_using);
+      auto rs2 = look_in_with_using(cache, r, name, from_using);
       add(rs, rs2);
     }
 
     return rs;
   }
 
-  AstPaths look_up(AstPath& path, const Location& name)
+  AstPaths look_up(LookupCache& cache, AstPath& path, const Location& name)
   {
-    return look_up(path, name, false);
+    return look_up(cache, path, name, false);
   }
 
-  AstPaths look_up(AstPath& path, List<TypeName>& names, bool from_using)
+  AstPaths look_up(
+    LookupCache& cache,
+    AstPath& path,
+    List<TypeName>& names,
+    bool from_using)
   {
     if (path.empty() || names.empty())
       return {};
 
     // Find all visible definitions of the first element.
-    auto rs = look_up(path, names.front()->location, from_using);
+    auto rs = look_up(cache, path, names.front()->location, from_using);
 
     // For each following element, find all possible definitions in the paths
     // we have so far.
     for (size_t i = 1; i < names.size(); i++)
-      rs = look_down_all(rs, names[i]->location, from_using);
+      rs = look_down_all(cache, rs, names[i]->location, from_using);
 
     return rs;
   }
@@ -4,8 +4,48 @@
 
 #include "ast.h"
 
+#include <unordered_map>
+
 namespace verona::parser
 {
+  // Memoizes what each scope contributes to a lookup, keyed on the
+  // scope node, the name text and whether the search came through a
+  // `using`. Every reference to a name walks the same outer scopes and
+  // expands the same `using` statements; with the cache, each (scope,
+  // name) pair is resolved once. In a non-entity scope, `using`
+  // statements apply only to names that appear after them in the same
+  // file, so those answers are position-dependent and are not cached.
+  // Scope nodes are part of the tree being resolved and outlive the
+  // cache, so a key can't dangle. One cache per resolve run.
+  struct LookupCache
+  {
+    struct Key
+    {
+      NodeDef* scope;
+      Location name;
+      bool from_using;
+
+      bool operator==(const Key& that) const
+      {
+        return (scope == that.scope) && (from_using == that.from_using) &&
+          (name == that.name);
+      }
+    };
+
+    struct Hash
+    {
+      size_t operator()(const Key& key) const
+      {
+        auto h = std::hash<Location>()(key.name);
+        auto p = std::hash<NodeDef*>()(key.scope);
+        return h ^ (p + 0x9e3779b9 + (h << 6) + (h >> 2)) ^
+          size_t(key.from_using);
+      }
+    };
+
+    std::unordered_map<Key, AstPaths, Hash> map;
+  };
+
   // Find a definition of `name` in `ast` only.
   // This is safe to use during parsing if `ast` has been fully parsed.
   Ast look_in(Ast& ast, const Location& name);
@@ -16,11 +56,14 @@ namespace verona::parser
 
   // Find all visible definitions of `name`, sorted from closest to furthest.
   // This shouldn't be used until after parsing is complete.
-  AstPaths look_up(AstPath& path, const Location& name);
+  AstPaths look_up(LookupCache& cache, AstPath& path, const Location& name);
 
   // Find all visible definitions of `names`, sorted from closest to furthest.
   // Set the `from_using` flag if you are looking up the TypeRef in a `using`
   // node. This shouldn't be used until after parsing is complete.
-  AstPaths
-  look_up(AstPath& path, List<TypeName>& names, bool from_using = false);
+  AstPaths look_up(
+    LookupCache& cache,
+    AstPath& path,
+    List<TypeName>& names,
+    bool from_using = false);
 }
@@ -17,10 +17,13 @@ int main(int argc, char** argv)
   CLI::App app{"Verona Parser"};
   bool emit_ast = false;
   bool validate = false;
+  bool cache = false;
   std::string path;
 
   app.add_flag("-a,--ast", emit_ast, "Emit an abstract syntax tree.");
   app.add_flag("-v,--validate", validate, "Run validation passes.");
+  app.add_flag(
+    "-c,--cache", cache, "Cache parsed modules alongside their sources.");
   app.add_option("path", path, "Path to the module to compile.")->required();
 
   try
@@ -33,7 +36,7 @@ int main(int argc, char** argv)
   }
 
   auto stdlibpath = path::canonical(path::join(path::executable(), stdlib));
-  auto [ok, ast] = parse(path, stdlibpath);
+  auto [ok, ast] = parse(path, stdlibpath, std::cerr, cache);
   ok = ok && (!validate || dnf::wellformed(ast));
 
   ok = ok && resolve::run(ast);
@@ -0,0 +1,672 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include "modulecache.h"
+
+#include "dispatch.h"
+#include "fields.h"
+#include "path.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace verona::parser::modulecache
+{
+  namespace
+  {
+    // "vnamod01", little-endian. Bump the version digits whenever the
+    // format changes; a mismatch makes load() fail and the module is
+    // parsed and re-cached.
+    constexpr uint64_t magic = 0x3130646F6D616E76;
+    constexpr auto cache_name = "module.vast";
+
+    // The header is the magic number, the content hash of the module's
+    // source files and a checksum of the payload. The payload is a
+    // source table followed by a node stream and the pending imports.
+    // All integers are little-endian; strings are a u32 length and the
+    // bytes.
+    constexpr size_t header_size = 3 * sizeof(uint64_t);
+
+    uint64_t fnv1a(uint64_t hash, const void* data, size_t size)
+    {
+      auto bytes = static_cast<const uint8_t*>(data);
+
+      for (size_t i = 0; i < size; i++)
+      {
+        hash = hash ^ bytes[i];
+        hash = hash * 0x100000001b3;
+      }
+
+      return hash;
+    }
+
+    constexpr uint64_t fnv_offset = 0xcbf29ce484222325;
+
+    void put8(std::string& buf, uint8_t value)
+    {
+      buf.push_back(static_cast<char>(value));
+    }
+
+    void put32(std::string& buf, uint32_t value)
+    {
+      for (size_t i = 0; i < sizeof(value); i++)
+        buf.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+    }
+
+    void put64(std::string& buf, uint64_t value)
+    {
+      for (size_t i = 0; i < sizeof(value); i++)
+        buf.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+    }
+
+    void putstr(std::string& buf, const std::string& value)
+    {
+      put32(buf, static_cast<uint32_t>(value.size()));
+      buf.append(value);
+    }
+
+    // Serializes a subtree over the generic field machinery. Each node
+    // is written once, in traversal order; a node reached again - a
+    // shared type from normalization, or a symbol table entry, since
+    // symbols are written after the fields that contain them - becomes
+    // a back-reference to its position in the stream. Sources are
+    // collected as they are first referenced and written ahead of the
+    // node stream, and symbol tables are sorted by name so the bytes
+    // don't depend on hash order.
+    struct Writer
+    {
+      std::string body;
+      std::vector<Source> sources;
+      std::unordered_map<SourceDef*, uint32_t> source_ids;
+      std::unordered_map<NodeDef*, uint32_t> node_ids;
+
+      void operator()() {}
+
+      template<typename T>
+      void operator()(T& node)
+      {
+        *this << fields(node);
+      }
+
+      void operator()(StaticRef& sr)
+      {
+        // maybe_member is not a field of the node, so it is not covered
+        // by fieldsof and is written by hand.
+        *this << fields(sr);
+        put8(body, sr.maybe_member ? 1 : 0);
+      }
+
+      Writer& operator<<(Location& loc)
+      {
+        if (!loc.source)
+        {
+          put32(body, ~uint32_t(0));
+          put32(body, 0);
+          put32(body, 0);
+          return *this;
+        }
+
+        auto find = source_ids.find(loc.source.get());
+        uint32_t id;
+
+        if (find != source_ids.end())
+        {
+          id = find->second;
+        }
+        else
+        {
+          id = static_cast<uint32_t>(sources.size());
+          sources.push_back(loc.source);
+          source_ids.emplace(loc.source.get(), id);
+        }
+
+        put32(body, id);
+        put32(body, loc.start);
+        put32(body, loc.end);
+        return *this;
+      }
+
+      template<typename T>
+      Writer& operator<<(Node<T>& node)
+      {
+        if (!node)
+        {
+          put8(body, 0);
+          return *this;
+        }
+
+        auto find = node_ids.find(node.get());
+
+        if (find != node_ids.end())
+        {
+          put8(body, 2);
+          put32(body, find->second);
+          return *this;
+        }
+
+        node_ids.emplace(
+          node.get(), static_cast<uint32_t>(node_ids.size()));
+        put8(body, 1);
+        put8(body, static_cast<uint8_t>(node->kind()));
+        *this << node->location;
+        dispatch(*this, node);
+
+        if (auto st = node->symbol_table())
+          table(*st);
+
+        return *this;
+      }
+
+      template<typename T>
+      Writer& operator<<(List<T>& list)
+      {
+        put32(body, static_cast<uint32_t>(list.size()));
+
+        for (auto& node : list)
+          *this << node;
+
+        return *this;
+      }
+
+      void table(SymbolTable& st)
+      {
+        std::vector<std::pair<Location, Ast>> entries(
+          st.map.begin(), st.map.end());
+
+        std::sort(entries.begin(), entries.end(), [](auto& a, auto& b) {
+          auto av = a.first.view();
+          auto bv = b.first.view();
+
+          if (av != bv)
+            return av < bv;
+
+          if (a.first.start != b.first.start)
+            return a.first.start < b.first.start;
+
+          return a.first.source->origin < b.first.source->origin;
+        });
+
+        put32(body, static_cast<uint32_t>(entries.size()));
+
+        for (auto& [id, sym] : entries)
+        {
+          *this << id;
+          *this << sym;
+        }
+
+        put32(body, static_cast<uint32_t>(st.use.size()));
+
+        for (auto& use : st.use)
+          *this << use;
+      }
+    };
+
+    Ast make_node(uint8_t kind)
+    {
+      switch (static_cast<Kind>(kind))
+      {
+        case Kind::Using:
+          return std::make_shared<Using>();
+        case Kind::TypeAlias:
+          return std::make_shared<TypeAlias>();
+        case Kind::Interface:
+          return std::make_shared<Interface>();
+        case Kind::Class:
+          return std::make_shared<Class>();
+        case Kind::Module:
+          return std::make_shared<Module>();
+        case Kind::Field:
+          return std::make_shared<Field>();
+        case Kind::Param:
+          return std::make_shared<Param>();
+        case Kind::TypeParam:
+          return std::make_shared<TypeParam>();
+        case Kind::Signature:
+          return std::make_shared<Signature>();
+        case Kind::Function:
+          return std::make_shared<Function>();
+        case Kind::UnionType:
+          return std::make_shared<UnionType>();
+        case Kind::IsectType:
+          return std::make_shared<IsectType>();
+        case Kind::TupleType:
+          return std::make_shared<TupleType>();
+        case Kind::FunctionType:
+          return std::make_shared<FunctionType>();
+        case Kind::ViewType:
+          return std::make_shared<ViewType>();
+        case Kind::ExtractType:
+          return std::make_shared<ExtractType>();
+        case Kind::TypeName:
+          return std::make_shared<TypeName>();
+        case Kind::ModuleName:
+          return std::make_shared<ModuleName>();
+        case Kind::TypeRef:
+          return std::make_shared<TypeRef>();
+        case Kind::Iso:
+          return std::make_shared<Iso>();
+        case Kind::Mut:
+          return std::make_shared<Mut>();
+        case Kind::Imm:
+          return std::make_shared<Imm>();
+        case Kind::Oftype:
+          return std::make_shared<Oftype>();
+        case Kind::Tuple:
+          return std::make_shared<Tuple>();
+        case Kind::Block:
+          return std::make_shared<Block>();
+        case Kind::When:
+          return std::make_shared<When>();
+        case Kind::While:
+          return std::make_shared<While>();
+        case Kind::Case:
+          return std::make_shared<Case>();
+        case Kind::Match:
+          return std::make_shared<Match>();
+        case Kind::If:
+          return std::make_shared<If>();
+        case Kind::Lambda:
+          return std::make_shared<Lambda>();
+        case Kind::Break:
+          return std::make_shared<Break>();
+        case Kind::Continue:
+          return std::make_shared<Continue>();
+        case Kind::Return:
+          return std::make_shared<Return>();
+        case Kind::Yield:
+          return std::make_shared<Yield>();
+        case Kind::Assign:
+          return std::make_shared<Assign>();
+        case Kind::Infix:
+          return std::make_shared<Infix>();
+        case Kind::Apply:
+          return std::make_shared<Apply>();
+        case Kind::Select:
+          return std::make_shared<Select>();
+        case Kind::Specialise:
+          return std::make_shared<Specialise>();
+        case Kind::StaticSelect:
+          return std::make_shared<StaticSelect>();
+        case Kind::Ref:
+          return std::make_shared<Ref>();
+        case Kind::StaticRef:
+          return std::make_shared<StaticRef>();
+        case Kind::Let:
+          return std::make_shared<Let>();
+        case Kind::Var:
+          return std::make_shared<Var>();
+        case Kind::New:
+          return std::make_shared<New>();
+        case Kind::ObjectLiteral:
+          return std::make_shared<ObjectLiteral>();
+        case Kind::EscapedString:
+          return std::make_shared<EscapedString>();
+        case Kind::UnescapedString:
+          return std::make_shared<UnescapedString>();
+        case Kind::Character:
+          return std::make_shared<Character>();
+        case Kind::Int:
+          return std::make_shared<Int>();
+        case Kind::Float:
+          return std::make_shared<Float>();
+        case Kind::Hex:
+          return std::make_shared<Hex>();
+        case Kind::Binary:
+          return std::make_shared<Binary>();
+        case Kind::True:
+          return std::make_shared<True>();
+        case Kind::False:
+          return std::make_shared<False>();
+      }
+
+      return {};
+    }
+
+    // Rebuilds a subtree from the node stream, mirroring the Writer.
+    // Every read is bounds-checked; the first malformed read clears ok
+    // and everything after it is a no-op, so a bad file is rejected
+    // rather than decoded.
+    struct Reader
+    {
+      const char* data;
+      size_t size;
+      size_t pos = 0;
+      bool ok = true;
+
+      std::vector<Source> sources;
+      std::vector<Ast> nodes;
+
+      Reader(const char* data, size_t size) : data(data), size(size) {}
+
+      bool bytes(void* out, size_t count)
+      {
+        if (!ok || ((size - pos) < count))
+        {
+          ok = false;
+          return false;
+        }
+
+        ::memcpy(out, data + pos, count);
+        pos += count;
+        return true;
+      }
+
+      uint8_t u8()
+      {
+        uint8_t value = 0;
+        bytes(&value, sizeof(value));
+        return value;
+      }
+
+      uint32_t u32()
+      {
+        uint8_t buf[sizeof(uint32_t)] = {};
+        bytes(buf, sizeof(buf));
+        uint32_t value = 0;
+
+        for (size_t i = 0; i < sizeof(buf); i++)
+          value |= static_cast<uint32_t>(buf[i]) << (i * 8);
+
+        return value;
+      }
+
+      std::string str()
+      {
+        auto count = u32();
+
+        if (!ok || ((size - pos) < count))
+        {
+          ok = false;
+          return {};
+        }
+
+        std::string value(data + pos, count);
+        pos += count;
+        return value;
+      }
+
+      void operator()() {}
+
+      template<typename T>
+      void operator()(T& node)
+      {
+        *this << fields(node);
+      }
+
+      void operator()(StaticRef& sr)
+      {
+        *this << fields(sr);
+        sr.maybe_member = u8() != 0;
+      }
+
+      Reader& operator<<(Location& loc)
+      {
+        auto id = u32();
+        auto start = u32();
+        auto end = u32();
+
+        if (!ok)
+          return *this;
+
+        if (id == ~uint32_t(0))
+        {
+          loc = {};
+          loc.start = 0;
+          loc.end = 0;
+          return *this;
+        }
+
+        if (id >= sources.size())
+        {
+          ok = false;
+          return *this;
+        }
+
+        loc.source = sources[id];
+        loc.start = start;
+        loc.end = end;
+        return *this;
+      }
+
+      Ast node()
+      {
+        auto tag = u8();
+
+        if (!ok || (tag == 0))
+          return {};
+
+        if (tag == 2)
+        {
+          auto id = u32();
+
+          if (!ok || (id >= nodes.size()))
+          {
+            ok = false;
+            return {};
+          }
+
+          return nodes[id];
+        }
+
+        if (tag != 1)
+        {
+          ok = false;
+          return {};
+        }
+
+        auto ast = make_node(u8());
+
+        if (!ast)
+        {
+          ok = false;
+          return {};
+        }
+
+        nodes.push_back(ast);
+        *this << ast->location;
+        dispatch(*this, ast);
+
+        if (auto st = ast->symbol_table())
+          table(*st);
+
+        return ast;
+      }
+
+      template<typename T>
+      Reader& operator<<(Node<T>& out)
+      {
+        out = std::static_pointer_cast<T>(node());
+        return *this;
+      }
+
+      template<typename T>
+      Reader& operator<<(List<T>& list)
+      {
+        auto count = u32();
+
+        for (uint32_t i = 0; ok && (i < count); i++)
+        {
+          Node<T> n;
+          *this << n;
+          list.push_back(n);
+        }
+
+        return *this;
+      }
+
+      void table(SymbolTable& st)
+      {
+        auto count = u32();
+
+        for (uint32_t i = 0; ok && (i < count); i++)
+        {
+          Location id;
+          Ast sym;
+          *this << id;
+          *this << sym;
+          st.map.emplace(id, sym);
+        }
+
+        count = u32();
+
+        for (uint32_t i = 0; ok && (i < count); i++)
+        {
+          Node<Using> use;
+          *this << use;
+          st.use.push_back(use);
+        }
+      }
+    };
+  }
+
+  uint64_t hash_files(const std::vector<std::string>& filenames)
+  {
+    auto hash = fnv_offset;
+
+    for (auto& filename : filenames)
+    {
+      std::ifstream f(filename, std::ios::binary);
+
+      if (!f)
+        return 0;
+
+      std::string contents(
+        (std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+      if (f.bad())
+        return 0;
+
+      hash = fnv1a(hash, filename.data(), filename.size());
+      auto size = uint64_t(contents.size());
+      hash = fnv1a(hash, &size, sizeof(size));
+      hash = fnv1a(hash, contents.data(), contents.size());
+    }
+
+    // 0 means the files couldn't be read.
+    if (hash == 0)
+      hash = 1;
+
+    return hash;
+  }
+
+  bool save(
+    const std::string& path,
+    uint64_t hash,
+    Node<Class>& module,
+    std::vector<std::pair<Node<TypeName>, std::string>>& refs)
+  {
+    Writer w;
+    w << module;
+    put32(w.body, static_cast<uint32_t>(refs.size()));
+
+    for (auto& [name, find] : refs)
+    {
+      w << name;
+      putstr(w.body, find);
+    }
+
+    std::string payload;
+    put32(payload, static_cast<uint32_t>(w.sources.size()));
+
+    for (auto& source : w.sources)
+    {
+      putstr(payload, source->origin);
+      putstr(payload, source->contents);
+    }
+
+    payload.append(w.body);
+
+    std::string file;
+    put64(file, magic);
+    put64(file, hash);
+    put64(file, fnv1a(fnv_offset, payload.data(), payload.size()));
+    file.append(payload);
+
+    std::ofstream f(
+      path::join(path, cache_name), std::ios::binary | std::ios::trunc);
+
+    if (!f)
+      return false;
+
+    f.write(file.data(), file.size());
+    return f.good();
+  }
+
+  bool load(
+    const std::string& path,
+    uint64_t hash,
+    Node<Class>& module,
+    std::vector<std::pair<Node<TypeName>, std::string>>& refs)
+  {
+    std::ifstream f(path::join(path, cache_name), std::ios::binary);
+
+    if (!f)
+      return false;
+
+    std::string file(
+      (std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+    if (f.bad() || (file.size() < header_size))
+      return false;
+
+    auto get64 = [&](size_t at) {
+      uint64_t value = 0;
+
+      for (size_t i = 0; i < sizeof(value); i++)
+        value |= static_cast<uint64_t>(
+                   static_cast<uint8_t>(file[at + i]))
+          << (i * 8);
+
+      return value;
+    };
+
+    if ((get64(0) != magic) || (get64(8) != hash))
+      return false;
+
+    auto payload = file.data() + header_size;
+    auto payload_size = file.size() - header_size;
+
+    if (get64(16) != fnv1a(fnv_offset, payload, payload_size))
+      return false;
+
+    Reader r(payload, payload_size);
+    auto count = r.u32();
+
+    for (uint32_t i = 0; r.ok && (i < count); i++)
+    {
+      auto source = std::make_shared<SourceDef>();
+      source->origin = r.str();
+      source->contents = r.str();
+      r.sources.push_back(source);
+    }
+
+    Node<Class> m;
+    r << m;
+
+    if (!r.ok || !m || (m->kind() != Kind::Class))
+      return false;
+
+    std::vector<std::pair<Node<TypeName>, std::string>> rs;
+    count = r.u32();
+
+    for (uint32_t i = 0; r.ok && (i < count); i++)
+    {
+      Node<TypeName> name;
+      r << name;
+      auto find = r.str();
+
+      if (!r.ok || !name)
+        return false;
+
+      rs.push_back({name, find});
+    }
+
+    if (!r.ok || (r.pos != r.size))
+      return false;
+
+    module = m;
+    refs = std::move(rs);
+    return true;
+  }
+}
@@ -0,0 +1,41 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ast.h"
+
+#include <string>
+#include <vector>
+
+namespace verona::parser::modulecache
+{
+  // A binary cache of a parsed module, stored alongside its source
+  // files. The cache holds the module's class node, its symbol tables
+  // and its pending imports in a versioned flat format, keyed on a
+  // content hash of the module's source files, so an unchanged module
+  // is loaded without lexing or parsing it.
+
+  // Returns a content hash of the named files, or 0 if any of them
+  // can't be read. A hash of 0 disables the cache for the module.
+  uint64_t hash_files(const std::vector<std::string>& filenames);
+
+  // Writes the module subtree and its pending imports to the cache file
+  // in the module directory. The imports are saved as pairs of the
+  // reference node and the canonical path it refers to, before module
+  // indexes are assigned, so the compilation that loads the cache can
+  // number them to match its own import table.
+  bool save(
+    const std::string& path,
+    uint64_t hash,
+    Node<Class>& module,
+    std::vector<std::pair<Node<TypeName>, std::string>>& refs);
+
+  // Loads the cache file in the module directory. Fails if the file is
+  // missing, was written by a different format version, doesn't match
+  // the hash of the current sources, or doesn't decode cleanly.
+  bool load(
+    const std::string& path,
+    uint64_t hash,
+    Node<Class>& module,
+    std::vector<std::pair<Node<TypeName>, std::string>>& refs);
+}
@@ -6,10 +6,16 @@
 #include "escaping.h"
 #include "ident.h"
 #include "lookup.h"
+#include "modulecache.h"
 #include "path.h"
 
+#include <atomic>
 #include <cassert>
+#include <limits>
+#include <memory>
 #include <set>
+#include <sstream>
+#include <thread>
 
 namespace verona::parser
 {
@@ -25,11 +31,20 @@ namespace verona::parser
   struct Parse
   {
     Source source;
-    size_t pos;
+
+    // The whole file is lexed once, up front, into this buffer; the
+    // grammar then runs over token indexes. Backtracking used to reset
+    // the character position and re-lex, which re-scanned the same
+    // characters many times in the expression grammar; now it is an
+    // index assignment. cursor is the next unconsumed token, la is the
+    // lookahead offset past it, and avail is how many tokens past the
+    // cursor the current rule has looked at.
+    std::vector<Token> tokens;
+    size_t cursor;
     size_t la;
+    size_t avail;
     Token previous;
-    std::vector<Token> lookahead;
-    std::vector<size_t> pos_stack;
+    std::vector<size_t> cursor_stack;
 
     AstPath symbol_stack;
 
@@ -38,11 +53,50 @@ namespace verona::parser
     Location name_has_value;
     Location name_next;
 
+    dnf::Cache dnf_cache;
+
     Result final_result;
     std::vector<std::string> imports;
     std::string stdlib;
     std::ostream& out;
 
+    // When set, a module directory whose sources match a cache file is
+    // loaded from the cache instead of being parsed, and a module that
+    // had to be parsed is cached on the way out. See modulecache.h.
+    bool use_modulecache = false;
+
+    // Module references found while parsing. The "$module-N" name that
+    // stands for an import is assigned in assign_module_indexes once the
+    // per-file parsers of a module have been merged in file order, so
+    // the numbering does not depend on worker scheduling.
+    std::vector<std::pair<Node<TypeName>, std::string>> module_refs;
+
+    // When this parser handles one file of a module on a worker thread
+    // (see module()), successful inserts into the module-level symbol
+    // table are logged so they can be replayed into the real module.
+    // The incremental update (see IncrementalParse) uses the same log
+    // to replay the symbols of top-level items it did not re-parse.
+    SymbolTable* log_table = nullptr;
+    std::vector<std::pair<Location, Ast>> sym_log;
+
+    // One entry per top-level item of the file most recently parsed:
+    // where the item ends in the token buffer, and how many members,
+    // logged symbols and using declarations exist once it has been
+    // parsed. The incremental update uses these to locate the items an
+    // edit touches and to splice the rest of the previous tree back in.
+    struct ItemMark
+    {
+      size_t tokens;
+      size_t members;
+      size_t syms;
+      size_t uses;
+    };
+
+    static constexpr size_t no_item = std::numeric_limits<size_t>::max();
+
+    std::vector<ItemMark> items;
+    size_t moduledef_item = no_item;
+
     struct NullBuffer : public std::streambuf
     {
       int overflow(int c)
@@ -85,8 +139,9 @@ namespace verona::parser
     };
 
     Parse(const std::string& stdlib, std::ostream& out)
-    : pos(0),
+    : cursor(0),
       la(0),
+      avail(0),
       final_result(Success),
       stdlib(stdlib),
       out(out),
@@ -105,15 +160,35 @@ namespace verona::parser
     void start(Source& src)
     {
       source = src;
-      pos = 0;
+      cursor = 0;
       la = 0;
+      avail = 0;
       previous = {};
-      lookahead.clear();
+      tokens.clear();
+
+      size_t pos = 0;
+      Token t;
+
+      do
+      {
+        t = lex(source, pos);
+        tokens.push_back(t);
+      } while (t.kind != TokenKind::End);
+    }
+
+    const Token& token(size_t i)
+    {
+      // The buffer ends with a single End token; looking past it keeps
+      // yielding End, just as lexing past the end of the source does.
+      if (i >= tokens.size())
+        i = tokens.size() - 1;
+
+      return tokens[i];
     }
 
     std::ostream& error()
     {
-      if (pos_stack.size() > 0)
+      if (cursor_stack.size() > 0)
         return null_stream;
 
       final_result = Error;
@@ -135,27 +210,22 @@ namespace verona::parser
     Try try_rule()
     {
       assert(la == 0);
-
-      if (lookahead.size() > 0)
-        pos_stack.push_back(lookahead.front().location.start);
-      else
-        pos_stack.push_back(pos);
-
+      cursor_stack.push_back(cursor);
       return Try(*this);
     }
 
     void try_pop(bool success)
     {
-      assert(pos_stack.size() > 0);
+      assert(cursor_stack.size() > 0);
 
       if (!success)
       {
         la = 0;
-        lookahead.clear();
-        pos = pos_stack.back();
+        avail = 0;
+        cursor = cursor_stack.back();
       }
 
-      pos_stack.pop_back();
+      cursor_stack.pop_back();
     }
 
     void set_sym(const Location& id, Ast node, SymbolTable& st)
@@ -174,6 +244,9 @@ namespace verona::parser
       }
 
       st.map.emplace(id, node);
+
+      if (&st == log_table)
+        sym_log.push_back({id, node});
     }
 
     void set_sym(const Location& id, Ast node)
@@ -199,8 +272,8 @@ namespace verona::parser
 
     Location loc()
     {
-      if (lookahead.size() > 0)
-        return lookahead[0].location;
+      if (avail > 0)
+        return token(cursor).location;
       else
         return previous.location;
     }
@@ -212,14 +285,14 @@ namespace verona::parser
 
     bool peek(const TokenKind& kind, const char* text = nullptr)
     {
-      if (la >= lookahead.size())
-        lookahead.push_back(lex(source, pos));
+      if (la >= avail)
+        avail = la + 1;
 
-      assert(la < lookahead.size());
+      auto& t = token(cursor + la);
 
-      if (lookahead[la].kind == kind)
+      if (t.kind == kind)
       {
-        if (!text || (lookahead[la].location == text))
+        if (!text || (t.location == text))
         {
           next();
           return true;
@@ -243,11 +316,11 @@ namespace verona::parser
     {
       assert(la == 0);
 
-      if (lookahead.size() == 0)
-        return lex(source, pos);
+      if (avail == 0)
+        return token(cursor++);
 
-      previous = lookahead.front();
-      lookahead.erase(lookahead.begin());
+      previous = token(cursor++);
+      avail--;
       return previous;
     }
 
@@ -929,7 +1002,7 @@ namespace verona::parser
       if (!peek(TokenKind::Ident))
         return Skip;
 
-      bool local = is_localref(lookahead[la - 1].location);
+      bool local = is_localref(token(cursor + la - 1).location);
       rewind();
 
       if (!local)
@@ -1117,7 +1190,7 @@ namespace verona::parser
       if (!peek(TokenKind::Ident) && !peek(TokenKind::Symbol))
         return Skip;
 
-      bool local = is_localref(lookahead[la - 1].location);
+      bool local = is_localref(token(cursor + la - 1).location);
       rewind();
 
       if (local)
@@ -1581,16 +1654,11 @@ namespace verona::parser
 
       if (!find.empty())
       {
-        auto it = std::find(imports.begin(), imports.end(), find);
-        size_t i = it - imports.begin();
-
-        if (it == imports.end())
-        {
-          i = imports.size();
-          imports.push_back(find);
-        }
-
-        name->location = ident("$module-" + std::to_string(i));
+        // Defer naming the import: the index is assigned once every file
+        // of the enclosing module has been parsed. Until then the
+        // location is the module string itself, which is what the error
+        // paths want anyway.
+        module_refs.push_back({name, find});
       }
       else
       {
@@ -1780,7 +1848,7 @@ namespace verona::parser
         }
 
         if (r2 != Skip)
-          type = dnf::conjunction(type, next, amploc);
+          type = dnf::conjunction(dnf_cache, type, next, amploc);
       } while (has(TokenKind::Symbol, "&"));
 
       return r;
@@ -1810,7 +1878,7 @@ namespace verona::parser
         }
 
         if (r2 != Skip)
-          type = dnf::disjunction(type, next, pipeloc);
+          type = dnf::disjunction(dnf_cache, type, next, pipeloc);
       } while (has(TokenKind::Symbol, "|"));
 
       return r;
@@ -2362,23 +2430,14 @@ namespace verona::parser
       return r;
     }
 
-    Result sourcefile(
-      const std::string& file, Node<Class>& module, Node<Module>& moduledef)
+    Result
+    items_until(size_t limit, Node<Class>& module, Node<Module>& moduledef)
     {
-      auto source = load_source(file);
-
-      if (!source)
-      {
-        error() << "Couldn't read file " << file << std::endl;
-        return Error;
-      }
-
-      start(source);
-
       // module <- (moduledef / member)*
-      while (!has(TokenKind::End))
+      while ((cursor < limit) && !has(TokenKind::End))
       {
         Result r;
+        bool had_moduledef = moduledef != nullptr;
 
         if ((r = optmoduledef(moduledef)) == Skip)
           r = optmember(module->members);
@@ -2399,11 +2458,61 @@ namespace verona::parser
                           TokenKind::LSquare,
                           TokenKind::LParen});
         }
+
+        if (!had_moduledef && moduledef)
+          moduledef_item = items.size();
+
+        items.push_back({cursor,
+                         module->members.size(),
+                         sym_log.size(),
+                         module->symbol_table()->use.size()});
       }
 
       return final_result;
     }
 
+    Result
+    sourcefile(Source& source, Node<Class>& module, Node<Module>& moduledef)
+    {
+      start(source);
+      items.clear();
+      moduledef_item = no_item;
+      return items_until(tokens.size(), module, moduledef);
+    }
+
+    Result sourcefile(
+      const std::string& file, Node<Class>& module, Node<Module>& moduledef)
+    {
+      auto source = load_source(file);
+
+      if (!source)
+      {
+        error() << "Couldn't read file " << file << std::endl;
+        return Error;
+      }
+
+      return sourcefile(source, module, moduledef);
+    }
+
+    void assign_module_indexes()
+    {
+      for (auto& [name, find] : module_refs)
+      {
+        auto it = std::find(imports.begin(), imports.end(), find);
+        size_t i = it - imports.begin();
+
+        if (it == imports.end())
+        {
+          i = imports.size();
+          imports.push_back(find);
+        }
+
+        name->location = ident("$module-" + std::to_string(i));
+      }
+
+      module_refs.clear();
+    }
+
     Result
     module(const std::string& path, size_t module_index, Node<Class>& program)
     {
@@ -2414,6 +2523,8 @@ namespace verona::parser
 
       Node<Module> moduledef;
       auto r = Success;
+      uint64_t cache_hash = 0;
+      bool cached = false;
 
       auto module = std::make_shared<Class>();
       auto st = push(module);
@@ -2437,15 +2548,147 @@ namespace verona::parser
         }
         else
         {
+          std::vector<std::string> filenames;
+
           for (auto& file : files)
           {
             if (ext != path::extension(file))
               continue;
 
-            auto filename = path::join(path, file);
+            filenames.push_back(path::join(path, file));
+          }
+
+          if (use_modulecache)
+          {
+            cache_hash = modulecache::hash_files(filenames);
+            std::vector<std::pair<Node<TypeName>, std::string>> refs;
+            Node<Class> saved;
+
+            if (
+              (cache_hash != 0) &&
+              modulecache::load(path, cache_hash, saved, refs))
+            {
+              // Splice the cached subtree in under the current module
+              // name. The pending imports are replayed so that the
+              // "$module-N" numbering reflects this compilation, not
+              // the one that wrote the cache.
+              module->members = std::move(saved->members);
+              module->typeparams = std::move(saved->typeparams);
+              module->inherits = saved->inherits;
+              *module->symbol_table() = std::move(*saved->symbol_table());
+
+              for (auto& ref : refs)
+                module_refs.push_back(ref);
+
+              cached = true;
+            }
+          }
 
-            if (sourcefile(filename, module, moduledef) == Error)
-              r = Error;
+          if (!cached)
+          {
+            // The files of a module are parse-independent. Each one is
+            // parsed by its own Parse instance on a pool of worker
+            // threads, sharing only the identifier store, which is
+            // internally synchronized. Everything else - members, symbols,
+            // module references, errors - is collected per file and merged
+            // in file order below, so the resulting tree and diagnostics
+            // do not depend on scheduling.
+            struct FileParse
+            {
+              std::stringstream errors;
+              std::unique_ptr<Parse> parser;
+              Node<Class> shell;
+              Node<Module> moduledef;
+              Result result = Success;
+            };
+
+            std::vector<FileParse> results(filenames.size());
+
+            std::atomic<size_t> next{0};
+            auto work = [&]() {
+              while (true)
+              {
+                size_t index = next.fetch_add(1);
+                if (index >= filenames.size())
+                  break;
+
+                auto& fp = results[index];
+                fp.parser = std::make_unique<Parse>(stdlib, fp.errors);
+                fp.parser->ident = ident;
+                fp.parser->ident.scope =
+                  "$" + std::to_string(module_index) + "." +
+                  std::to_string(index) + ".";
+
+                fp.shell = std::make_shared<Class>();
+                fp.shell->id = modulename;
+
+                auto program_shell = std::make_shared<Class>();
+                auto st1 = fp.parser->push(program_shell);
+                auto st2 = fp.parser->push(fp.shell);
+                fp.parser->log_table = fp.shell->symbol_table();
+
+                fp.result =
+                  fp.parser->sourcefile(filenames[index], fp.shell, fp.moduledef);
+              }
+            };
+
+            size_t threads = std::min<size_t>(
+              std::thread::hardware_concurrency(), filenames.size());
+            std::vector<std::thread> workers;
+            for (size_t i = 1; i < threads; i++)
+            {
+              workers.emplace_back(work);
+            }
+
+            // The calling thread participates as well.
+            work();
+
+            for (auto& worker : workers)
+            {
+              worker.join();
+            }
+
+            for (auto& fp : results)
+            {
+              out << fp.errors.str();
+              if (fp.result == Error)
+              {
+                final_result = Error;
+                r = Error;
+              }
+
+              for (auto& member : fp.shell->members)
+                module->members.push_back(member);
+
+              // Replaying the per-file symbols into the real module picks
+              // up duplicate definitions that span files.
+              for (auto& [id, node] : fp.parser->sym_log)
+                set_sym(id, node, *module->symbol_table());
+
+              auto& use = module->symbol_table()->use;
+              auto& shell_use = fp.shell->symbol_table()->use;
+              use.insert(use.end(), shell_use.begin(), shell_use.end());
+
+              for (auto& ref : fp.parser->module_refs)
+                module_refs.push_back(ref);
+
+              if (fp.moduledef)
+              {
+                if (!moduledef)
+                {
+                  moduledef = fp.moduledef;
+                }
+                else
+                {
+                  error() << fp.moduledef->location
+                          << "The module has already been defined"
+                          << text(fp.moduledef->location) << moduledef->location
+                          << "The previous definition is here"
+                          << text(moduledef->location);
+                  r = Error;
+                }
+              }
+            }
           }
         }
       }
@@ -2456,14 +2699,25 @@ namespace verona::parser
         module->inherits = moduledef->inherits;
       }
 
+      // Cache before the module indexes are assigned, so the pending
+      // imports are saved with their paths rather than with the import
+      // numbering of this particular compilation.
+      if (use_modulecache && !cached && (cache_hash != 0) && (r == Success))
+        modulecache::save(path, cache_hash, module, module_refs);
+
+      assign_module_indexes();
       return r;
     }
   };
 
-  std::pair<bool, Ast>
-  parse(const std::string& path, const std::string& stdlib, std::ostream& out)
+  std::pair<bool, Ast> parse(
+    const std::string& path,
+    const std::string& stdlib,
+    std::ostream& out,
+    bool modulecache)
   {
     Parse parse(stdlib, out);
+    parse.use_modulecache = modulecache;
     auto program = std::make_shared<Class>();
     auto st = parse.push(program);
     parse.imports.push_back(path::canonical(path));
@@ -2473,4 +2727,228 @@ namespace verona::parser
 
     return {parse.final_result == Success, program};
   }
+
+  IncrementalParse::IncrementalParse(
+    const std::string& stdlib, std::ostream& out)
+  : parser(std::make_unique<Parse>(stdlib, out))
+  {}
+
+  IncrementalParse::~IncrementalParse() = default;
+
+  std::pair<bool, Ast> IncrementalParse::parse(Source& source)
+  {
+    auto& p = *parser;
+    p.final_result = Success;
+    p.sym_log.clear();
+
+    program = std::make_shared<Class>();
+    module = std::make_shared<Class>();
+    module->id = p.ident("$module-0");
+    moduledef = nullptr;
+
+    auto st1 = p.push(program);
+    auto st2 = p.push(module);
+    program->members.push_back(module);
+    p.set_sym_parent(module->id, module);
+    p.log_table = module->symbol_table();
+
+    auto r = p.sourcefile(source, module, moduledef);
+    p.assign_module_indexes();
+
+    if (moduledef)
+    {
+      // Copied rather than moved: the module definition node may be
+      // spliced back in by a later update.
+      module->typeparams = moduledef->typeparams;
+      module->inherits = moduledef->inherits;
+    }
+
+    return {r == Success, program};
+  }
+
+  std::pair<bool, Ast> IncrementalParse::update(Source& source)
+  {
+    auto& p = *parser;
+
+    if (!module)
+      return parse(source);
+
+    // Lex the new revision.
+    std::vector<Token> ntokens;
+    {
+      size_t pos = 0;
+      Token t;
+
+      do
+      {
+        t = lex(source, pos);
+        ntokens.push_back(t);
+      } while (t.kind != TokenKind::End);
+    }
+
+    auto& otokens = p.tokens;
+    size_t on = otokens.size();
+    size_t nn = ntokens.size();
+
+    // Longest common token prefix and suffix, comparing kind and text.
+    // This locates the edit without needing the byte range from the
+    // caller, and an edit that only touches whitespace or comments
+    // leaves no changed tokens at all.
+    size_t prefix = 0;
+
+    while ((prefix < on) && (prefix < nn) &&
+           (otokens[prefix].kind == ntokens[prefix].kind) &&
+           (otokens[prefix].location == ntokens[prefix].location))
+      prefix++;
+
+    size_t suffix = 0;
+
+    while ((suffix < (on - prefix)) && (suffix < (nn - prefix)) &&
+           (otokens[on - 1 - suffix].kind == ntokens[nn - 1 - suffix].kind) &&
+           (otokens[on - 1 - suffix].location ==
+            ntokens[nn - 1 - suffix].location))
+      suffix++;
+
+    // Take the previous parse apart. Items [0, lo) end before the first
+    // changed token and items [hi, count) start after the last one;
+    // everything in between is re-parsed from the new token buffer.
+    auto old_module = module;
+    auto old_moduledef = moduledef;
+    auto old_items = std::move(p.items);
+    auto old_syms = std::move(p.sym_log);
+    auto& old_use = old_module->symbol_table()->use;
+    size_t old_moduledef_item = p.moduledef_item;
+    size_t count = old_items.size();
+
+    auto item_start = [&](size_t i) {
+      return (i == 0) ? 0 : old_items[i - 1].tokens;
+    };
+
+    size_t lo = 0;
+
+    while ((lo < count) && (old_items[lo].tokens <= prefix))
+      lo++;
+
+    size_t hi = count;
+
+    while ((hi > lo) && (item_start(hi - 1) >= (on - suffix)))
+      hi--;
+
+    // The window of new tokens covering the changed items. Reusable
+    // items after the window sit at the same distance from the end of
+    // both revisions, so old indexes past it map across by adding the
+    // difference in length.
+    size_t w0 = item_start(lo);
+    size_t w1 = item_start(hi) + nn - on;
+
+    // Fresh shells; the previous tree is left intact in case the
+    // caller still holds it.
+    program = std::make_shared<Class>();
+    module = std::make_shared<Class>();
+    module->id = old_module->id;
+    moduledef = nullptr;
+
+    p.final_result = Success;
+    p.sym_log.clear();
+    p.moduledef_item = Parse::no_item;
+    p.source = source;
+    p.tokens = std::move(ntokens);
+    p.cursor = w0;
+    p.la = 0;
+    p.avail = 0;
+    p.previous = {};
+
+    {
+      auto st1 = p.push(program);
+      auto st2 = p.push(module);
+      program->members.push_back(module);
+      p.set_sym_parent(module->id, module);
+      p.log_table = module->symbol_table();
+
+      auto st = module->symbol_table();
+
+      // Splice the items before the window back in. Replaying their
+      // logged symbols rebuilds the module-level table in item order,
+      // just as a full parse would.
+      size_t m0 = (lo == 0) ? 0 : old_items[lo - 1].members;
+      size_t s0 = (lo == 0) ? 0 : old_items[lo - 1].syms;
+      size_t u0 = (lo == 0) ? 0 : old_items[lo - 1].uses;
+
+      module->members.assign(
+        old_module->members.begin(), old_module->members.begin() + m0);
+
+      for (size_t i = 0; i < s0; i++)
+        p.set_sym(old_syms[i].first, old_syms[i].second, *st);
+
+      st->use.assign(old_use.begin(), old_use.begin() + u0);
+      p.items.assign(old_items.begin(), old_items.begin() + lo);
+
+      if (old_moduledef_item < lo)
+      {
+        moduledef = old_moduledef;
+        p.moduledef_item = old_moduledef_item;
+      }
+
+      // Re-parse the changed items.
+      p.items_until(w1, module, moduledef);
+
+      if (p.cursor != w1)
+      {
+        // Error recovery consumed tokens past the window, so the
+        // splice points are gone. Fall back to a full parse.
+        return parse(source);
+      }
+
+      // Splice the items after the window back in, remapping their
+      // marks into the new token buffer.
+      for (size_t i = hi; i < count; i++)
+      {
+        auto& item = old_items[i];
+        size_t m = (i == 0) ? 0 : old_items[i - 1].members;
+        size_t s = (i == 0) ? 0 : old_items[i - 1].syms;
+        size_t u = (i == 0) ? 0 : old_items[i - 1].uses;
+
+        for (size_t j = m; j < item.members; j++)
+          module->members.push_back(old_module->members[j]);
+
+        if (old_moduledef_item == i)
+        {
+          if (!moduledef)
+          {
+            moduledef = old_moduledef;
+            p.moduledef_item = p.items.size();
+          }
+          else
+          {
+            p.error() << old_moduledef->location
+                      << "The module has already been defined"
+                      << text(old_moduledef->location) << moduledef->location
+                      << "The previous definition is here"
+                      << text(moduledef->location);
+          }
+        }
+
+        for (size_t j = s; j < item.syms; j++)
+          p.set_sym(old_syms[j].first, old_syms[j].second, *st);
+
+        for (size_t j = u; j < item.uses; j++)
+          st->use.push_back(old_use[j]);
+
+        p.items.push_back({item.tokens + nn - on,
+                           module->members.size(),
+                           p.sym_log.size(),
+                           st->use.size()});
+      }
+    }
+
+    p.assign_module_indexes();
+
+    if (moduledef)
+    {
+      module->typeparams = moduledef->typeparams;
+      module->inherits = moduledef->inherits;
+    }
+
+    return {p.final_result == Success, program};
+  }
 }
@@ -5,11 +5,43 @@
 #include "ast.h"
 
 #include <iostream>
+#include <memory>
 
 namespace verona::parser
 {
+  struct Parse;
+
+  // When modulecache is set, each module directory whose sources match
+  // its cache file is loaded from the cache instead of being parsed,
+  // and a module that had to be parsed is cached. See modulecache.h.
   std::pair<bool, Ast> parse(
     const std::string& path,
     const std::string& stdlib,
-    std::ostream& out = std::cerr);
+    std::ostream& out = std::cerr,
+    bool modulecache = false);
+
+  // Incremental parsing of a single source file, for tooling that
+  // re-parses on every edit. parse() parses the file in full and caches
+  // its token buffer and top-level item boundaries. update() takes the
+  // next revision of the file, diffs its token stream against the
+  // cached one, re-parses only the top-level definitions the edit
+  // touches, and splices the untouched parts of the previous tree back
+  // in. Locations in reused subtrees still point at the revision they
+  // were parsed from: their text is unchanged, but their offsets are
+  // relative to that revision. Errors are reported only for the
+  // re-parsed definitions; diagnostics for untouched ones are unchanged
+  // from the revision that produced them.
+  struct IncrementalParse
+  {
+    std::unique_ptr<Parse> parser;
+    Node<Class> program;
+    Node<Class> module;
+    Node<Module> moduledef;
+
+    IncrementalParse(const std::string& stdlib, std::ostream& out = std::cerr);
+    ~IncrementalParse();
+
+    std::pair<bool, Ast> parse(Source& source);
+    std::pair<bool, Ast> update(Source& source);
+  };
 }
@@ -3,6 +3,7 @@
 
 #include "pretty.h"
 
+#include <algorithm>
 #include <cassert>
 #include <deque>
 #include <variant>
@@ -34,7 +35,7 @@ namespace verona::parser
     std::ostream& underlying_output;
 
     /// Current indent level
-    uint16_t indent = 0;
+    size_t indent = 0;
 
     /// Width of lines for output
     uint16_t width;
@@ -45,15 +46,25 @@ namespace verona::parser
     /// If false, then new lines will be ignored.
     bool ignore_new_lines = false;
 
+    /// The indent actually printed, clamped so that arbitrarily deep
+    /// nesting still leaves some columns of line budget.
+    size_t padding()
+    {
+      return std::min(indent, size_t(width) - 1);
+    }
+
   public:
     IndentStream(std::ostream& underlying_output, uint16_t width)
-    : underlying_output(underlying_output), width(width)
+    : underlying_output(underlying_output),
+      width(std::max<uint16_t>(width, 2))
     {}
 
-    /// How long is a line given current indent levels.
+    /// How long is a line given current indent levels. This is always
+    /// positive: if it could go negative, the token queue would never
+    /// be flushed and the printer would buffer the rest of the tree.
     int line_width()
     {
-      return width - indent;
+      return width - static_cast<int>(padding());
     }
 
     /// Set if new lines should be ignored.
@@ -74,7 +85,8 @@ namespace verona::parser
       return *this;
     }
 
-    // For new line.
+    // For new line. Written as '\n' rather than std::endl: flushing the
+    // underlying stream once per line stalls printing into a pipe.
     IndentStream& operator<<(std::ostream& (*f)(std::ostream&))
     {
       if (!ignore_new_lines)
@@ -82,7 +94,7 @@ namespace verona::parser
         if (!empty_line) // Remove repeated newlines.
         {
           empty_line = true;
-          underlying_output << std::endl;
+          underlying_output << '\n';
         }
       }
       return *this;
@@ -93,8 +105,14 @@ namespace verona::parser
     {
       if (empty_line)
       {
-        if (indent != 0)
-          underlying_output << std::string(indent, ' ');
+        // Indent from a fixed buffer instead of allocating a string of
+        // spaces per line.
+        static constexpr char spaces[] = "                ";
+        constexpr size_t chunk = sizeof(spaces) - 1;
+
+        for (auto pad = padding(); pad > 0; pad -= std::min(pad, chunk))
+          underlying_output.write(spaces, std::min(pad, chunk));
+
         empty_line = false;
       }
       underlying_output << t;
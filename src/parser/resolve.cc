@@ -14,6 +14,7 @@ namespace verona::parser::resolve
 
     Ident ident;
     Location name_create;
+    LookupCache lookup_cache;
 
     Resolve()
     {
@@ -94,7 +95,7 @@ namespace verona::parser::resolve
     {
       // This checks that the type exists but doesn't rewrite the AST.
       bool from_using = (parent()->kind() == Kind::Using);
-      auto paths = look_up(stack, tr.typenames, from_using);
+      auto paths = look_up(lookup_cache, stack, tr.typenames, from_using);
 
       if (paths.empty())
       {
@@ -131,7 +132,7 @@ namespace verona::parser::resolve
 
     void post(StaticRef& sr)
     {
-      auto paths = look_up(stack, sr.typenames);
+      auto paths = look_up(lookup_cache, stack, sr.typenames);
 
       if (paths.empty())
       {
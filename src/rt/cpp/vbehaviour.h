@@ -37,10 +37,13 @@ namespace verona::rt
       auto t = static_cast<T*>(msg);
       t->f();
 
-      // If behaviour has a destructor tidy up the behaviour.
+      // If behaviour has a destructor tidy up the behaviour. A yielded
+      // behaviour keeps its state: the runtime re-delivers it and `f`
+      // runs again (see Behaviour::yield).
       if constexpr (!std::is_trivially_destructible_v<T>)
       {
-        t->~T();
+        if (!yield_requested(msg))
+          t->~T();
       }
     }
 
@@ -79,4 +82,120 @@ namespace verona::rt
     void operator delete[](void* p) = delete;
     void operator delete[](void* p, size_t sz) = delete;
   };
+
+  /**
+   * Behaviour wrapping a C++ callable.
+   *
+   * The callable is move-constructed directly inside the behaviour
+   * allocation — for small callables the combined message block (see
+   * MultiMessage::make_body_combined), which is pre-sized from sizeof(F)
+   * at compile time through this template. Captures are never copied:
+   * construction from an lvalue is deleted, so a multi-KB capture costs
+   * one move on `schedule_lambda` rather than a copy per `when`.
+   */
+  template<class F>
+  class VLambdaBehaviour : public VBehaviour<VLambdaBehaviour<F>>
+  {
+    static_assert(
+      std::is_move_constructible_v<F>,
+      "The callable must be movable into the behaviour allocation.");
+
+    F fn;
+
+  public:
+    VLambdaBehaviour(F&& fn) : fn(std::move(fn)) {}
+
+    /// Copying a callable with a large capture into the message is
+    /// exactly the cost this class exists to avoid.
+    VLambdaBehaviour(const F&) = delete;
+
+    void f()
+    {
+      fn();
+    }
+  };
+
+  /**
+   * Schedule a callable on the given cowns. The callable must be passed
+   * as an rvalue (`std::move` a named lambda): its captures are moved
+   * into the behaviour in place, never copied.
+   */
+  template<TransferOwnership transfer = NoTransfer, class F>
+  void schedule_lambda(size_t count, Cown** cowns, F&& fn)
+  {
+    static_assert(
+      !std::is_lvalue_reference_v<F>,
+      "Pass the callable as an rvalue (std::move) so its captures are "
+      "moved into the behaviour, not copied.");
+    Cown::schedule<VLambdaBehaviour<F>, transfer>(count, cowns, std::move(fn));
+  }
+
+  template<TransferOwnership transfer = NoTransfer, class F>
+  void schedule_lambda(Cown* cown, F&& fn)
+  {
+    static_assert(
+      !std::is_lvalue_reference_v<F>,
+      "Pass the callable as an rvalue (std::move) so its captures are "
+      "moved into the behaviour, not copied.");
+    schedule_lambda<transfer>(1, &cown, std::move(fn));
+  }
+
+  /**
+   * Schedule a callable as a read-only behaviour on one cown: it may run
+   * concurrently with other read-only behaviours on the same cown, and
+   * must not mutate state the cown owns (see Cown::schedule_read).
+   */
+  template<TransferOwnership transfer = NoTransfer, class F>
+  void schedule_lambda_read(Cown* cown, F&& fn)
+  {
+    static_assert(
+      !std::is_lvalue_reference_v<F>,
+      "Pass the callable as an rvalue (std::move) so its captures are "
+      "moved into the behaviour, not copied.");
+    Cown::schedule_read<VLambdaBehaviour<F>, transfer>(cown, std::move(fn));
+  }
+
+  namespace internal
+  {
+    inline void pipeline_build(Alloc*, Pipeline*, size_t) {}
+
+    template<class F, class... Rest>
+    void pipeline_build(
+      Alloc* alloc,
+      Pipeline* p,
+      size_t index,
+      Cown* cown,
+      F&& fn,
+      Rest&&... rest)
+    {
+      static_assert(
+        !std::is_lvalue_reference_v<F>,
+        "Pass the callable as an rvalue (std::move) so its captures are "
+        "moved into the behaviour, not copied.");
+      auto* be = ::new (alloc->alloc<sizeof(VLambdaBehaviour<F>)>())
+        VLambdaBehaviour<F>(std::move(fn));
+      p->set_stage(index, cown, be);
+      pipeline_build(alloc, p, index + 1, std::forward<Rest>(rest)...);
+    }
+  }
+
+  /**
+   * Schedule alternating (cown, callable) arguments as a pipeline: stage
+   * i runs its callable with cown i acquired, and on completion the next
+   * stage starts immediately on the same thread when its cown is idle,
+   * rather than paying a queue round trip per hop (see Pipeline).
+   * Callables must be rvalues, as with schedule_lambda, and must not
+   * yield.
+   */
+  template<class... Args>
+  void schedule_lambda_pipeline(Args&&... args)
+  {
+    static_assert(
+      sizeof...(Args) >= 2 && sizeof...(Args) % 2 == 0,
+      "Arguments must alternate cown and callable.");
+    auto* alloc = ThreadAlloc::get();
+    auto* p = Pipeline::make(alloc, sizeof...(Args) / 2);
+    internal::pipeline_build(alloc, p, 0, std::forward<Args>(args)...);
+    Cown::schedule_pipeline(p);
+  }
 } // namespace verona::rt
@@ -34,6 +34,14 @@ namespace verona::rt
   struct has_finaliser<T, std::void_t<decltype(&T::finaliser)>> : std::true_type
   {};
 
+  template<class T, class = void>
+  struct has_trace_slots : std::false_type
+  {};
+  template<class T>
+  struct has_trace_slots<T, std::void_t<decltype(&T::trace_slots)>>
+  : std::true_type
+  {};
+
   template<class T>
   struct has_destructor
   {
@@ -80,19 +88,51 @@ namespace verona::rt
       ((T*)o)->~T();
     }
 
+    static void gc_trace_slots(Object* o, SlotStack& st)
+    {
+      if constexpr (has_trace_slots<T>::value)
+        ((T*)o)->trace_slots(st);
+      else
+      {
+        UNUSED(o);
+        UNUSED(st);
+      }
+    }
+
     void trace(ObjectStack&) {}
 
   public:
     VBase() : Base() {}
 
-    static Descriptor* desc()
+    /**
+     * Fixed offset of the embedded C++ object from the start of the
+     * allocation. The payload always sits directly after the Verona
+     * header, so embedding code reaches it from the allocation base (see
+     * `object_at`) and accesses its fields as plain member offsets, with
+     * no descriptor indirection; the descriptor exists for tracing and
+     * finalisation only.
+     */
+    static constexpr size_t payload_offset = sizeof(Object::Header);
+
+    /// The embedded C++ object of an allocation made for `T`.
+    static T* object_at(void* base)
+    {
+      return (T*)Object::object_start(base);
+    }
+
+    static const Descriptor* desc()
     {
-      static Descriptor desc = {vsizeof<T>,
-                                gc_trace,
-                                has_finaliser<T>::value ? gc_final : nullptr,
-                                has_notified<T>::value ? gc_notified : nullptr,
-                                has_destructor<T>::value ? gc_destructor :
-                                                           nullptr};
+      // The payload layout is fixed at compile time, so the descriptor is
+      // a constant: callers pay no initialisation guard on the
+      // allocation fast path.
+      static_assert(alignof(T) <= Object::ALIGNMENT);
+      static constexpr Descriptor desc = {
+        vsizeof<T>,
+        gc_trace,
+        has_finaliser<T>::value ? gc_final : nullptr,
+        has_notified<T>::value ? gc_notified : nullptr,
+        has_destructor<T>::value ? gc_destructor : nullptr,
+        has_trace_slots<T>::value ? gc_trace_slots : nullptr};
 
       return &desc;
     }
@@ -189,13 +229,16 @@ namespace verona::rt
     void* operator new(size_t)
     {
       return Object::register_object(
-        ThreadAlloc::get()->alloc<vsizeof<T>>(), VBase<T, Cown>::desc());
+        Cown::alloc_cown<vsizeof<T>>(
+          ThreadAlloc::get(), VBase<T, Cown>::desc()),
+        VBase<T, Cown>::desc());
     }
 
     void* operator new(size_t, Alloc* alloc)
     {
       return Object::register_object(
-        alloc->alloc<vsizeof<T>>(), VBase<T, Cown>::desc());
+        Cown::alloc_cown<vsizeof<T>>(alloc, VBase<T, Cown>::desc()),
+        VBase<T, Cown>::desc());
     }
   };
 } // namespace verona::rt
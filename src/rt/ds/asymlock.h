@@ -8,6 +8,20 @@ namespace verona::rt
   /**
    * AsymmetricLock allows a single owning thread to use the internal
    * acquire/release API. Other threads must use the external API.
+   *
+   * The lock additionally offers a read mode for threads that only poll the
+   * protected state, such as stats or debugging threads. The owning thread
+   * brackets updates with `publish_begin`/`publish_end`, which bump a
+   * version word; readers bracket their loads with `external_read_begin`/
+   * `external_read_validate` and retry if a version change shows the
+   * snapshot was torn. Readers never write shared state, so polling does
+   * not contend with the owner's fast path.
+   *
+   * Read mode gives a consistent snapshot of the words themselves; it does
+   * not keep memory reachable from them alive. If the protected state
+   * contains pointers, the reader must hold an `Epoch` (see sched/epoch.h)
+   * while dereferencing them, and the owner must retire replaced memory via
+   * `Epoch::delete_in_epoch` rather than freeing it directly.
    */
   class AsymmetricLock
   {
@@ -15,6 +29,10 @@ namespace verona::rt
     std::atomic<uint64_t> internal_lock = 0;
     std::atomic<bool> external_lock = false;
 
+    /// Incremented by the owner on entering and leaving a publish section,
+    /// so the value is odd while an update is in progress.
+    std::atomic<uint64_t> write_version = 0;
+
     NOINLINE void internal_acquire_rare()
     {
       internal_release();
@@ -84,6 +102,51 @@ namespace verona::rt
       }
     }
 
+    /**
+     * Mark the start of an update to state that is polled through read
+     * mode. Must be called with the lock held (internally or externally).
+     */
+    void publish_begin()
+    {
+      auto v = write_version.load(std::memory_order_relaxed);
+      assert((v & 1) == 0);
+      write_version.store(v + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    /**
+     * Mark the end of an update started with `publish_begin`.
+     */
+    void publish_end()
+    {
+      auto v = write_version.load(std::memory_order_relaxed);
+      assert((v & 1) == 1);
+      std::atomic_thread_fence(std::memory_order_release);
+      write_version.store(v + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Begin a read-mode snapshot. Returns a version to pass to
+     * `external_read_validate` once the reader has copied the state it
+     * needs. Safe to call from any thread.
+     */
+    uint64_t external_read_begin()
+    {
+      return write_version.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns true if the loads performed since `external_read_begin`
+     * returned `version` form a consistent snapshot. On false, the reader
+     * discards its copy and retries from `external_read_begin`.
+     */
+    bool external_read_validate(uint64_t version)
+    {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return ((version & 1) == 0) &&
+        (write_version.load(std::memory_order_relaxed) == version);
+    }
+
     uint64_t internal_count()
     {
       assert(debug_internal_held());
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <cassert>
 #include <utility>
 
 namespace verona::rt
@@ -94,6 +95,22 @@ namespace verona::rt
      */
     Node* head = nullptr;
 
+#ifndef NDEBUG
+    /**
+     * Debug check that `n` is reachable from `from`.  Used to validate the
+     * iterators handed to the splice operations; linear, so debug only.
+     */
+    static bool reachable(Node* from, Node* n)
+    {
+      for (Node* c = from; c != nullptr; c = c->next)
+      {
+        if (c == n)
+          return true;
+      }
+      return false;
+    }
+#endif
+
   public:
     /**
      * Returns true if this list is empty, false otherwise.
@@ -133,6 +150,48 @@ namespace verona::rt
       Node* n = new Node(head, std::move(val));
       head = n;
     }
+    /**
+     * Splice the whole of `other` onto the front of this list, leaving
+     * `other` empty.  `other_last` must be an iterator to the final element
+     * of `other`; callers transferring batches typically tracked the tail
+     * while building the list, which keeps the relink O(1) instead of
+     * walking for it here.
+     */
+    void splice_front(forward_list& other, iterator other_last)
+    {
+      if (other.empty())
+      {
+        assert(other_last == end());
+        return;
+      }
+
+      assert(other_last != end());
+      assert(other_last.val->next == nullptr);
+      assert(reachable(other.head, other_last.val));
+
+      other_last.val->next = head;
+      head = other.head;
+      other.head = nullptr;
+    }
+    /**
+     * Splice the run of elements after `before_first`, up to and including
+     * `last`, out of `other` and onto the front of this list.  O(1): three
+     * pointer updates, no per-node work.  The run must be non-empty, so
+     * `before_first` must not equal `last`.
+     */
+    void splice_front(forward_list& other, iterator before_first, iterator last)
+    {
+      assert(before_first != end());
+      assert(last != end());
+      assert(before_first != last);
+      assert(reachable(other.head, before_first.val));
+      assert(reachable(before_first.val->next, last.val));
+
+      Node* first = before_first.val->next;
+      before_first.val->next = last.val->next;
+      last.val->next = head;
+      head = first;
+    }
     /**
      * Destructor.  Deletes the list.
      */
@@ -4,6 +4,10 @@
 
 #include "../object/object.h"
 
+#if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#endif
+
 namespace verona::rt
 {
   /**
@@ -18,6 +22,21 @@ namespace verona::rt
     uint8_t capacity_shift;
     uint8_t longest_probe = 0;
 
+    /**
+     * Previous slot allocation of an in-progress incremental rehash, or
+     * null. Growth does not rehash the whole table in one shot: the old
+     * allocation is kept and drained a few slots per mutation into the new
+     * one, so the worst-case insert latency is bounded regardless of table
+     * size. Lookups consult both allocations until the old one is drained.
+     */
+    Entry* prev_slots = nullptr;
+    size_t migrate_index = 0;
+    uint8_t prev_capacity_shift = 0;
+    uint8_t prev_longest_probe = 0;
+
+    /// Slots of the previous allocation migrated per mutation.
+    static constexpr size_t MIGRATE_STEP = 4;
+
     /**
      * The key type must be derrived from `Object` because the low bits are used
      * to encode a mark bit and the probe length of the entry from its ideal
@@ -99,29 +118,150 @@ namespace verona::rt
     }
 
     /**
-     * Double the allocation size. The entries in the previous allocation will
-     * be reinserted.
+     * Capacity of the previous allocation, or 0 when no rehash is in
+     * progress.
+     */
+    size_t prev_capacity() const
+    {
+      return (prev_slots == nullptr) ? 0 : ((size_t)1 << prev_capacity_shift);
+    }
+
+    /**
+     * Combined number of slots across the active allocation and, during an
+     * incremental rehash, the previous allocation.
+     */
+    size_t total_capacity() const
+    {
+      return capacity() + prev_capacity();
+    }
+
+    /**
+     * Slot at an index into the combined iteration space: indices below
+     * `capacity()` address the active allocation, the rest address the
+     * previous allocation of an in-progress rehash.
      */
-    void resize(Alloc* alloc)
+    Entry& entry_at(size_t index) const
     {
-      auto prev = *this;
+      if (index < capacity())
+        return slots[index];
+
+      assert(prev_slots != nullptr);
+      return prev_slots[index - capacity()];
+    }
+
+    /**
+     * Begin an incremental rehash into an allocation of twice the size. Any
+     * rehash already in progress is completed first, so at most two
+     * allocations exist at a time.
+     */
+    void start_resize(Alloc* alloc)
+    {
+      migrate(alloc, ~(size_t)0);
+      assert(prev_slots == nullptr);
+
+      prev_slots = slots;
+      prev_capacity_shift = capacity_shift;
+      prev_longest_probe = longest_probe;
+      migrate_index = 0;
 
       capacity_shift++;
       slots = (Entry*)alloc->alloc<YesZero>(capacity() * sizeof(Entry));
-      filled_slots = 0;
       longest_probe = 0;
+    }
+
+    /**
+     * Advance an in-progress rehash by up to `max_slots` slots of the
+     * previous allocation, freeing it once drained. Each insert calls this
+     * with a small bound, so the cost of a rehash is spread across the
+     * mutations that follow it rather than paid by any single insert.
+     */
+    void migrate(Alloc* alloc, size_t max_slots)
+    {
+      if (prev_slots == nullptr)
+        return;
 
-      for (auto it = prev.begin(); it != prev.end(); ++it)
+      while (max_slots-- > 0)
       {
-        if constexpr (is_set)
-          insert(alloc, it.key());
-        else
-          insert(alloc, std::make_pair(it.key(), std::move(it.value())));
+        if (migrate_index == prev_capacity())
+        {
+          alloc->dealloc(prev_slots, prev_capacity() * sizeof(Entry));
+          prev_slots = nullptr;
+          return;
+        }
+
+        auto& e = prev_slots[migrate_index++];
+        if (key_of(e) != 0)
+        {
+          insert_rehash(alloc, std::move(e));
+          key_of(e) = 0;
+        }
+      }
+    }
+
+    /**
+     * Insert an entry while rehashing into the active allocation. Keys are
+     * known to be unique and mark bits are preserved. `filled_slots` is not
+     * modified, as the entry is already counted.
+     */
+    void insert_rehash(Alloc* alloc, Entry entry)
+    {
+      while (true)
+      {
+        const auto hash =
+          bits::hash(((const Object*)unmark_key(key_of(entry)))->id());
+        auto index = hash & (capacity() - 1);
+
+        for (uint8_t probe_len = 0; probe_len <= PROBE_MASK; probe_len++)
+        {
+          const auto k = key_of(slots[index]);
+
+          if (k == 0)
+          {
+            place_entry(std::move(entry), index, probe_len);
+            return;
+          }
+
+          if (probe_index(k) < probe_len)
+          {
+            Entry swap = std::move(slots[index]);
+            place_entry(std::move(entry), index, probe_len);
+            entry = std::move(swap);
+            probe_len = probe_index(key_of(entry));
+          }
+
+          if (++index == capacity())
+            index = 0;
+        }
 
-        key_of(it.entry()) = 0;
+        // Maximum probe length reached: double the active allocation and
+        // retry with whichever entry was displaced last.
+        grow_active(alloc);
       }
     }
 
+    /**
+     * Double the active allocation in one step, reinserting its entries.
+     * Only used when a rehash exhausts the maximum probe length, as entries
+     * awaiting migration cannot be rehashed a second time incrementally.
+     */
+    void grow_active(Alloc* alloc)
+    {
+      auto* old = slots;
+      const auto old_capacity = capacity();
+
+      capacity_shift++;
+      slots = (Entry*)alloc->alloc<YesZero>(capacity() * sizeof(Entry));
+      longest_probe = 0;
+
+      for (size_t i = 0; i < old_capacity; i++)
+      {
+        if (key_of(old[i]) != 0)
+          insert_rehash(alloc, std::move(old[i]));
+      }
+
+      alloc->dealloc(old, old_capacity * sizeof(Entry));
+    }
+
     /**
      * Place an entry into the map at the given index, overwriting any existing
      * entry. The probe bits of the key are set to `probe_len` and the
@@ -138,6 +278,31 @@ namespace verona::rt
         longest_probe = probe_len;
     }
 
+    /**
+     * Find a key among the entries still awaiting migration. Returns `end()`
+     * when no rehash is in progress or the key is not present.
+     */
+    auto find_prev(uintptr_t key) const
+    {
+      if (prev_slots != nullptr)
+      {
+        const auto hash = bits::hash(((const Object*)key)->id());
+        auto index = hash & (prev_capacity() - 1);
+        for (size_t probe_len = 0; probe_len <= prev_longest_probe;
+             probe_len++)
+        {
+          const auto k = unmark_key(key_of(prev_slots[index]));
+          if (k == key)
+            return Iterator(this, capacity() + index);
+
+          if (++index == prev_capacity())
+            index = 0;
+        }
+      }
+
+      return end();
+    }
+
   public:
     /**
      * Iterator over the entries in an `ObjectMap`, starting from a slot index.
@@ -152,7 +317,7 @@ namespace verona::rt
 
       Entry& entry()
       {
-        return map->slots[index];
+        return map->entry_at(index);
       }
 
       Iterator(const ObjectMap* m, size_t i) : map(m), index(i) {}
@@ -194,9 +359,9 @@ namespace verona::rt
 
       Iterator& operator++()
       {
-        while (++index < map->capacity())
+        while (++index < map->total_capacity())
         {
-          const auto key = key_of(map->slots[index]);
+          const auto key = key_of(map->entry_at(index));
           if (key != 0)
             break;
         }
@@ -235,6 +400,11 @@ namespace verona::rt
     void dealloc(Alloc* alloc)
     {
       clear(nullptr);
+      if (prev_slots != nullptr)
+      {
+        alloc->dealloc(prev_slots, prev_capacity() * sizeof(Entry));
+        prev_slots = nullptr;
+      }
       alloc->dealloc(slots, capacity() * sizeof(Entry));
     }
 
@@ -266,7 +436,23 @@ namespace verona::rt
 
     Iterator end() const
     {
-      return Iterator(this, capacity());
+      return Iterator(this, total_capacity());
+    }
+
+    /**
+     * Hash `key` and prefetch its home slot. Issuing this a fixed window
+     * ahead of the corresponding `find`/`insert` overlaps the per-entry
+     * cache miss that otherwise serialises bulk operations on large maps.
+     */
+    void prefetch(const KeyType* key) const
+    {
+      const auto hash = bits::hash(key->id());
+      const auto* slot = &slots[hash & (capacity() - 1)];
+#if defined(_MSC_VER) && !defined(__clang__)
+      _mm_prefetch((const char*)slot, _MM_HINT_T0);
+#else
+      __builtin_prefetch(slot, 0, 3);
+#endif
     }
 
     /**
@@ -291,7 +477,7 @@ namespace verona::rt
           index = 0;
       }
 
-      return end();
+      return find_prev((uintptr_t)key);
     }
 
     /**
@@ -304,13 +490,22 @@ namespace verona::rt
     std::pair<bool, Iterator> insert(Alloc* alloc, E entry)
     {
       if (unlikely(size() == capacity()))
-        resize(alloc);
+        start_resize(alloc);
+
+      migrate(alloc, MIGRATE_STEP);
 
       assert(key_of(entry) != 0);
       const auto key = unmark_key(key_of(entry));
+
+      // An existing entry may still be awaiting migration.
+      auto prev_it = find_prev(key);
+      if (prev_it != end())
+        return std::make_pair(false, std::move(prev_it));
+
       const auto hash = bits::hash(((const Object*)key)->id());
       auto index = hash & (capacity() - 1);
       size_t iter_index = ~(size_t)0;
+      bool swapped = false;
 
       for (uint8_t probe_len = 0; probe_len <= PROBE_MASK; probe_len++)
       {
@@ -347,15 +542,20 @@ namespace verona::rt
           place_entry(std::forward<E>(entry), index, probe_len);
           entry = swap;
           probe_len = probe_index(key_of(entry));
+          swapped = true;
         }
 
         if (++index == capacity())
           index = 0;
       }
 
-      // Maximum probe length reached, resize and retry.
-      resize(alloc);
-      // Entry may have been swapped prior to resize.
+      // Maximum probe length reached: begin rehashing into a larger
+      // allocation and retry.
+      start_resize(alloc);
+      // Entry may have been swapped prior to the resize; a swapped entry was
+      // already counted, and is now in neither allocation.
+      if (swapped)
+        filled_slots--;
       auto it = insert(alloc, std::forward<E>(entry)).second;
       if ((uintptr_t)it.key() != key)
         it = find((const KeyType*)key);
@@ -406,10 +606,19 @@ namespace verona::rt
 
       longest_probe = 0;
 
-      if ((alloc != nullptr) && (capacity() > 8))
+      if (alloc != nullptr)
       {
-        alloc->dealloc(slots, capacity() * sizeof(Entry));
-        init_alloc(alloc);
+        if (prev_slots != nullptr)
+        {
+          alloc->dealloc(prev_slots, prev_capacity() * sizeof(Entry));
+          prev_slots = nullptr;
+        }
+
+        if (capacity() > 8)
+        {
+          alloc->dealloc(slots, capacity() * sizeof(Entry));
+          init_alloc(alloc);
+        }
       }
     }
 
@@ -433,6 +642,9 @@ namespace verona::rt
             << ", probe " << (size_t)probe_index(key) << ")";
       }
       out << " } cap: " << capacity();
+      if (prev_slots != nullptr)
+        out << " (+ " << prev_capacity() << " rehashing)";
+
       return out;
     }
   };
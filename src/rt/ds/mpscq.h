@@ -52,16 +52,19 @@ namespace verona::rt
    *      queue receives multiple calls to "notify" it may consolidate them into
    *      a single call. This supports zero allocation notifications in the
    *      runtime.
+   *
+   * The queue is intrusive: elements are linked through a member of T
+   * named by the `link` parameter, an `std::atomic<T*>` field defaulting
+   * to `T::next`. Specifying the link lets one element type sit in
+   * several queues (each with its own link field) without a wrapper
+   * allocation; the member pointer is a compile-time constant, so access
+   * through it is a fixed offset, the same code as naming the field.
    **/
 
-  template<class T>
+  template<class T, std::atomic<T*> T::*link = &T::next>
   class MPSCQ
   {
   private:
-    static_assert(
-      std::is_same<decltype(((T*)nullptr)->next), std::atomic<T*>>::value,
-      "T->next must be a std::atomic<T*>");
-
     // Embedding state into last two bits.
     enum STATE
     {
@@ -114,7 +117,7 @@ namespace verona::rt
 
     void init(T* stub)
     {
-      stub->next.store(nullptr, std::memory_order_relaxed);
+      (stub->*link).store(nullptr, std::memory_order_relaxed);
       front = stub;
 
       stub = set_state(stub, SLEEPING);
@@ -153,7 +156,7 @@ namespace verona::rt
       assert(is_clear(t));
 
       invariant();
-      t->next.store(nullptr, std::memory_order_relaxed);
+      (t->*link).store(nullptr, std::memory_order_relaxed);
       std::atomic_thread_fence(std::memory_order_release);
       T* prev = back.exchange(t, std::memory_order_relaxed);
       bool was_sleeping;
@@ -169,7 +172,7 @@ namespace verona::rt
       was_sleeping = has_state(prev, SLEEPING);
       prev = clear_state(prev);
 
-      prev->next.store(t, std::memory_order_relaxed);
+      (prev->*link).store(t, std::memory_order_relaxed);
       return was_sleeping;
     }
 
@@ -190,7 +193,7 @@ namespace verona::rt
       invariant();
       T* fnt = front;
       assert(is_clear(fnt));
-      T* next = fnt->next.load(std::memory_order_relaxed);
+      T* next = (fnt->*link).load(std::memory_order_relaxed);
 
       if (next == nullptr)
       {
@@ -202,7 +205,7 @@ namespace verona::rt
       assert(front);
       std::atomic_thread_fence(std::memory_order_acquire);
 
-      alloc->dealloc(fnt, fnt->size());
+      T::recycle(alloc, fnt);
       invariant();
 
       if (has_state(next, NOTIFY))
@@ -230,13 +233,139 @@ namespace verona::rt
       return dequeue(alloc, notify);
     }
 
+    /**
+     * A run of elements detached from the queue by `dequeue_n`.
+     *
+     * The consumer drains the run with `pop`, which hands out the elements
+     * in queue order. As with `dequeue`, an element is recycled once the
+     * next one is requested, so the element being processed stays live. The
+     * final element of the run is the queue's new stub and is never
+     * recycled by the batch.
+     **/
+    class Batch
+    {
+      friend class MPSCQ;
+
+      /// Next element to hand out, or nullptr when the run is drained.
+      T* next_msg = nullptr;
+
+      /// Final element of the run; the queue's front.
+      T* last = nullptr;
+
+      /// Most recently popped element awaiting recycling.
+      T* processed = nullptr;
+
+    public:
+      bool empty() const
+      {
+        return next_msg == nullptr;
+      }
+
+      T* pop(snmalloc::Alloc* alloc)
+      {
+        assert(!empty());
+        T* msg = next_msg;
+        assert(is_clear(msg));
+
+        if (msg == last)
+          next_msg = nullptr;
+        else
+          next_msg = clear_state((msg->*link).load(std::memory_order_relaxed));
+
+        if (processed != nullptr)
+          T::recycle(alloc, processed);
+
+        // The final element remains in the queue as the stub, so it is
+        // recycled by a later dequeue rather than by this batch.
+        processed = (msg == last) ? nullptr : msg;
+        return msg;
+      }
+    };
+
+    /**
+     * Dequeues (removes) up to `count` elements from the queue as a single
+     * run, paying one acquire fence rather than one per element.
+     *
+     * Returns an empty batch if the queue is empty. Otherwise the front of
+     * the queue advances to the last element of the run and the old front
+     * is recycled; the elements of the run are then owned by the batch.
+     *
+     * The notify parameter is set if any element of the run carries a
+     * notification.
+     *
+     * If the consumer stops draining the batch early, it must call
+     * `requeue_front` with the most recently popped element, to make the
+     * remaining elements reachable from the queue again.
+     **/
+    Batch dequeue_n(snmalloc::Alloc* alloc, size_t count, bool& notify)
+    {
+      invariant();
+      assert(count > 0);
+      T* fnt = front;
+      assert(is_clear(fnt));
+      Batch batch;
+
+      T* next = (fnt->*link).load(std::memory_order_relaxed);
+      if (next == nullptr)
+        return batch;
+
+      if (has_state(next, NOTIFY))
+      {
+        // Consume the notification: if the rest of the run is reattached
+        // with `requeue_front`, it must not be observed a second time.
+        notify = true;
+        (fnt->*link).store(clear_state(next), std::memory_order_relaxed);
+      }
+
+      T* first = clear_state(next);
+      T* last = first;
+
+      for (size_t n = 1; n < count; n++)
+      {
+        next = (last->*link).load(std::memory_order_relaxed);
+        if (next == nullptr)
+          break;
+
+        if (has_state(next, NOTIFY))
+        {
+          notify = true;
+          (last->*link).store(clear_state(next), std::memory_order_relaxed);
+        }
+
+        last = clear_state(next);
+      }
+
+      front = last;
+      std::atomic_thread_fence(std::memory_order_acquire);
+
+      T::recycle(alloc, fnt);
+      invariant();
+
+      batch.next_msg = first;
+      batch.last = last;
+      return batch;
+    }
+
+    /**
+     * Reattach the undrained remainder of a batch to the queue. `stub` must
+     * be the element most recently popped from the batch: it becomes the
+     * queue's front, making the elements after it reachable again. Only
+     * safe to call from the consumer.
+     **/
+    void requeue_front(T* stub)
+    {
+      assert(is_clear(stub));
+      front = stub;
+      invariant();
+    }
+
     /**
      * Used to find the first element in the queue. Only safe to use in the
      * consumer.
      **/
     T* peek()
     {
-      return clear_state(front->next.load(std::memory_order_relaxed));
+      return clear_state((front->*link).load(std::memory_order_relaxed));
     }
 
     /**
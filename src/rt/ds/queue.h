@@ -2,7 +2,12 @@
 // SPDX-License-Identifier: MIT
 namespace verona
 {
-  template<class T>
+  /**
+   * Intrusive FIFO linked through a member of T named by the `link`
+   * parameter, defaulting to `T::next`. Specifying the link lets one
+   * element type sit in several structures, each through its own field.
+   */
+  template<class T, T* T::*link = &T::next>
   class Queue
   {
   private:
@@ -27,7 +32,7 @@ namespace verona
       }
       else
       {
-        last->next = next;
+        last->*link = next;
         last = next;
       }
 
@@ -47,13 +52,41 @@ namespace verona
       }
       else
       {
-        first = first->next;
+        first = first->*link;
       }
 
       assert((first != nullptr && last != nullptr) || last == first);
       return result;
     }
 
+    /**
+     * Append the whole of `other` to this queue in O(1), leaving `other`
+     * empty. The tail pointer makes this three pointer updates with no
+     * per-node work.
+     */
+    void splice(Queue& other)
+    {
+      assert((first != nullptr && last != nullptr) || last == first);
+
+      if (other.is_empty())
+        return;
+
+      if (is_empty())
+      {
+        first = other.first;
+      }
+      else
+      {
+        last->*link = other.first;
+      }
+
+      last = other.last;
+      other.first = nullptr;
+      other.last = nullptr;
+
+      assert((first != nullptr && last != nullptr) || last == first);
+    }
+
     size_t length()
     {
       T* p = first;
@@ -66,7 +99,7 @@ namespace verona
       while (p != last)
       {
         len++;
-        p = p->next;
+        p = p->*link;
       }
 
       return len;
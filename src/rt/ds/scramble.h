@@ -20,8 +20,17 @@ namespace verona
    * The implementation is guaranteed to be a permutation as a Feisel network is
    * invertible.  This is not a crytpographic primitive, it is just a compact
    * way to provide random orders on pointers.
+   *
+   * Perturbed orders are only useful when exploring interleavings, so the
+   * `Scramble` alias below selects this implementation under systematic
+   * testing and an identity permutation otherwise, removing the per
+   * comparison hashing cost from release builds.
    */
-  class Scramble
+  template<bool enabled>
+  class ScrambleImpl;
+
+  template<>
+  class ScrambleImpl<true>
   {
     // Number of rounds to get value.
     static constexpr size_t ROUNDS = 8;
@@ -33,7 +42,7 @@ namespace verona
     uintptr_t keys[ROUNDS];
 
   public:
-    Scramble() {}
+    ScrambleImpl() {}
 
     void setup(xoroshiro::p128r32& r)
     {
@@ -58,4 +67,29 @@ namespace verona
       return l + ((uintptr_t)r << PTR_HALF_SHIFT);
     }
   };
+
+  /**
+   * Zero-cost stand-in for builds that do not explore acquisition orders:
+   * the permutation is the identity, so comparisons on permuted values
+   * compile down to plain pointer comparisons.
+   */
+  template<>
+  class ScrambleImpl<false>
+  {
+  public:
+    ScrambleImpl() {}
+
+    void setup(xoroshiro::p128r32&) {}
+
+    uintptr_t perm(uintptr_t p)
+    {
+      return p;
+    }
+  };
+
+#ifdef USE_SYSTEMATIC_TESTING
+  using Scramble = ScrambleImpl<true>;
+#else
+  using Scramble = ScrambleImpl<false>;
+#endif
 }
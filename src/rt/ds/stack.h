@@ -3,6 +3,7 @@
 #pragma once
 
 #include <cassert>
+#include <cstring>
 #include <snmalloc.h>
 
 namespace verona::rt
@@ -10,26 +11,36 @@ namespace verona::rt
   /**
    * This class contains the core functionality for a stack using aligned blocks
    * of memory. The stack is the size of a single pointer when empty.
+   *
+   * The chunk geometry is configurable: `pointer_count` is the number of
+   * pointer slots per block, including the previous pointer. Larger blocks
+   * amortise the boundary checks and allocator calls over more elements at
+   * the cost of worse worst-case residency; the default matches the
+   * per-thread block pool (see StackBlockPool).
    */
-  template<class T, class Alloc>
+  template<class T, class Alloc, size_t pointer_count = 64>
   class StackThin
   {
   private:
-    static constexpr size_t POINTER_COUNT = 64;
+    static constexpr size_t POINTER_COUNT = pointer_count;
     static_assert(
       snmalloc::bits::next_pow2_const(POINTER_COUNT) == POINTER_COUNT,
       "Should be power of 2 for alignment.");
+    static_assert(
+      POINTER_COUNT * sizeof(T*) >= 64,
+      "Blocks must be at least cache-line aligned.");
 
     static constexpr size_t STACK_COUNT = POINTER_COUNT - 1;
 
     /**
      * The assumes that the allocations are aligned to the same threshold as
-     * their size. The blocks contain one previous pointer, and 63 pointers to
-     * Ts.  This is a power of two, so we can use the bottom part of the
-     * pointer to track the index.
+     * their size. The blocks contain one previous pointer, and
+     * `pointer_count - 1` pointers to Ts.  This is a power of two, so we can
+     * use the bottom part of the pointer to track the index.
      *
-     * As the block contains a previous pointer, there are only 64 possible
-     * states for a block, that is 0 - 63 live entries.
+     * As the block contains a previous pointer, there are only
+     * `pointer_count` possible states for a block, that is
+     * 0 - `pointer_count - 1` live entries.
      *
      * The stack is represented by a single interior pointer, index, of type
      * T**.
@@ -145,6 +156,62 @@ namespace verona::rt
       push_slow(item, alloc);
     }
 
+    /**
+     * Push `n` elements; equivalent to `n` calls to `push` on
+     * `items[0]..items[n - 1]`, leaving `items[n - 1]` on top, but pays
+     * one boundary check and one bulk copy per block rather than one per
+     * element.
+     */
+    void push_n(T* const* items, size_t n, Alloc* alloc)
+    {
+      while (n > 0)
+      {
+        if (is_full(index))
+        {
+          Block* next = (Block*)alloc->template alloc<sizeof(Block)>();
+          assert(((uintptr_t)next) % alignof(Block) == 0);
+          next->prev = index;
+          // Point at the `prev` slot: the empty-block index.
+          index = (T**)next;
+        }
+
+        size_t space =
+          (INDEX_MASK - ((uintptr_t)index & INDEX_MASK)) / sizeof(T*);
+        size_t batch = n < space ? n : space;
+        memcpy(index + 1, items, batch * sizeof(T*));
+        index += batch;
+        items += batch;
+        n -= batch;
+      }
+    }
+
+    /**
+     * Pop up to `n` elements into `out`, top of stack first; returns the
+     * number popped. Equivalent to repeated `pop`, but pays one boundary
+     * check per block.
+     */
+    size_t pop_n(T** out, size_t n, Alloc* alloc)
+    {
+      size_t popped = 0;
+      while (popped < n && !empty())
+      {
+        size_t avail = ((uintptr_t)index & INDEX_MASK) / sizeof(T*);
+        size_t batch = (n - popped) < avail ? (n - popped) : avail;
+        for (size_t i = 0; i < batch; i++)
+          out[popped + i] = *(index - i);
+        index -= batch;
+        popped += batch;
+
+        if (is_empty(index))
+        {
+          Block* block = get_block(index);
+          index = block->prev;
+          alloc->template dealloc<sizeof(Block)>(block);
+        }
+      }
+      return popped;
+    }
+
     /// For all elements of the stack
     void forall(snmalloc::function_ref<void(T*)> apply)
     {
@@ -190,6 +257,102 @@ namespace verona::rt
     }
   };
 
+  /**
+   * Per-thread pool of stack blocks, shared by every `Stack` on the thread.
+   *
+   * GC, freeze and region teardown construct fresh stacks for each pass, so
+   * their blocks go back to the allocator as each pass ends, only to be
+   * reallocated by the next one. With the pool enabled, `Stack`'s backup
+   * allocator overflows into the pool instead, and the next collection's
+   * stacks reuse the warm blocks.
+   *
+   * Disabled by default (limit 0) so leak accounting such as
+   * `debug_check_empty` stays exact; embedders opt in with `set_limit`.
+   */
+  class StackBlockPool
+  {
+  public:
+    /**
+     * Every default-geometry `StackThin` block is one previous pointer
+     * plus 63 element pointers, so the pool can store them untyped.
+     * Stacks with other chunk geometries bypass the pool (see the size
+     * guards in `Stack::BackupAlloc`).
+     */
+    static constexpr size_t BLOCK_SIZE = 64 * sizeof(void*);
+
+  private:
+    struct FreeBlock
+    {
+      FreeBlock* next;
+    };
+
+    FreeBlock* head = nullptr;
+    size_t count = 0;
+
+    static size_t& limit()
+    {
+      static size_t limit = 0;
+      return limit;
+    }
+
+  public:
+    static StackBlockPool& get()
+    {
+      static thread_local StackBlockPool pool;
+      return pool;
+    }
+
+    /// Set the per-thread limit on pooled blocks. Zero (the default)
+    /// disables pooling.
+    static void set_limit(size_t blocks)
+    {
+      limit() = blocks;
+    }
+
+    /// Pop a pooled block, or nullptr.
+    void* acquire()
+    {
+      if (head == nullptr)
+        return nullptr;
+
+      auto* b = head;
+      head = b->next;
+      count--;
+      return b;
+    }
+
+    /// Pool a free block; returns false if the pool is full.
+    bool release(void* p)
+    {
+      if (count >= limit())
+        return false;
+
+      auto* b = (FreeBlock*)p;
+      b->next = head;
+      head = b;
+      count++;
+      return true;
+    }
+
+    /// Return every pooled block to the allocator.
+    template<class Alloc>
+    void flush(Alloc* alloc)
+    {
+      while (head != nullptr)
+      {
+        auto* next = head->next;
+        alloc->template dealloc<BLOCK_SIZE>(head);
+        head = next;
+      }
+      count = 0;
+    }
+
+    ~StackBlockPool()
+    {
+      flush(snmalloc::ThreadAlloc::get_noncachable());
+    }
+  };
+
   /**
    * This class uses the block structured stack with extra fields
    * for the allocator, and a backup block, so that the common case
@@ -204,7 +367,7 @@ namespace verona::rt
    * elements and pops them on each iteration may trigger allocation the first
    * time but will then not trigger allocation on any subsequent iteration.
    */
-  template<class T, class Alloc>
+  template<class T, class Alloc, size_t pointer_count = 64>
   class Stack
   {
     /**
@@ -213,7 +376,8 @@ namespace verona::rt
      */
     class BackupAlloc
     {
-      using Block = typename StackThin<T, BackupAlloc>::Block;
+      using Block =
+        typename StackThin<T, BackupAlloc, pointer_count>::Block;
 
       /// A one place pool of Block.
       Block* backup = nullptr;
@@ -234,8 +398,15 @@ namespace verona::rt
 
         if (backup)
           return std::exchange(backup, nullptr);
-        else
-          return underlying_alloc->template alloc<Size>();
+
+        if constexpr (sizeof(Block) == StackBlockPool::BLOCK_SIZE)
+        {
+          void* b = StackBlockPool::get().acquire();
+          if (b != nullptr)
+            return b;
+        }
+
+        return underlying_alloc->template alloc<Size>();
       }
 
       /// Deallocate a stack Block.
@@ -249,18 +420,32 @@ namespace verona::rt
         if (backup == nullptr)
           backup = b;
         else
-          underlying_alloc->template dealloc<Size>(b);
+          release_block(b);
       }
 
       ~BackupAlloc()
       {
         if (backup != nullptr)
-          underlying_alloc->template dealloc<sizeof(Block)>(backup);
+          release_block(backup);
+      }
+
+    private:
+      /// Give a block back to the per-thread pool, or the allocator if the
+      /// pool declines it.
+      void release_block(Block* b)
+      {
+        if constexpr (sizeof(Block) == StackBlockPool::BLOCK_SIZE)
+        {
+          if (StackBlockPool::get().release(b))
+            return;
+        }
+
+        underlying_alloc->template dealloc<sizeof(Block)>(b);
       }
     };
 
     /// Underlying stack
-    StackThin<T, BackupAlloc> stack;
+    StackThin<T, BackupAlloc, pointer_count> stack;
 
     /// Allocator for new blocks of stack
     BackupAlloc backup_alloc;
@@ -286,6 +471,19 @@ namespace verona::rt
       return stack.pop(&backup_alloc);
     }
 
+    /// Put `n` elements on the stack, `items[n - 1]` ending up on top.
+    ALWAYSINLINE void push_n(T* const* items, size_t n)
+    {
+      stack.push_n(items, n, &backup_alloc);
+    }
+
+    /// Remove up to `n` elements, top of stack first; returns the number
+    /// removed.
+    ALWAYSINLINE size_t pop_n(T** out, size_t n)
+    {
+      return stack.pop_n(out, n, &backup_alloc);
+    }
+
     /// Check if stack is empty
     ALWAYSINLINE bool empty()
     {
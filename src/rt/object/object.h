@@ -78,9 +78,20 @@ namespace verona::rt
   class RegionBase;
 
   using ObjectStack = Stack<Object, Alloc>;
+  /// Stack of in-object pointer slots, i.e. addresses of Object* fields.
+  /// Used by `Descriptor::trace_slots` implementations.
+  using SlotStack = Stack<Object*, Alloc>;
   static constexpr size_t descriptor_alignment =
     snmalloc::bits::min<size_t>(8, alignof(void*));
 
+  /**
+   * The descriptor is a literal aggregate, and every descriptor in the
+   * runtime and the C++ embedding (see cpp/vobject.h) is built as a
+   * `constexpr` constant: embedding any number of types adds no startup
+   * work, and the descriptors are emitted into read-only pages that are
+   * shared across forked processes. New descriptors should follow suit
+   * rather than filling one in at runtime.
+   **/
   struct alignas(descriptor_alignment) Descriptor
   {
     // for field in o do
@@ -108,11 +119,22 @@ namespace verona::rt
 
     using DestructorFunction = void (*)(Object* o);
 
+    /**
+     * Enumerate the *addresses* of the object's Object* fields, pushing
+     * each non-null slot. Where `trace` enumerates field values, this
+     * enumerates the slots holding them, so a pass that relocates
+     * objects can rewrite the pointers afterwards (see region/flatten.h).
+     * Optional: compaction-style passes fall back to doing nothing for
+     * graphs containing a descriptor without it.
+     **/
+    using TraceSlotsFunction = void (*)(Object* o, SlotStack& st);
+
     size_t size;
     TraceFunction trace;
     FinalFunction finaliser;
     NotifiedFunction notified = nullptr;
     DestructorFunction destructor = nullptr;
+    TraceSlotsFunction trace_slots = nullptr;
     // TODO: virtual dispatch, pattern matching on type, reflection
   };
 
@@ -214,6 +236,24 @@ namespace verona::rt
 
     /// This class represents the Verona object header.
     /// It is stored directly before a Verona object.
+    ///
+    /// TODO(object): A compact-header mode (32-bit descriptor index plus
+    /// region-relative compressed pointers) would roughly halve header
+    /// overhead for small-object-heavy arena regions, but cannot be selected
+    /// per region type with the current design:
+    ///  * Generic code manipulates raw `Object*` with no region context
+    ///    (immutable reference counting, freezing, remembered sets, message
+    ///    bodies), so every header accessor would need a mode discriminator,
+    ///    which itself costs header bits on every object.
+    ///  * The descriptor word doubles as tag storage: `EpochMark` and the
+    ///    RememberedSet mark live in its low bits, and the status union
+    ///    reuses `next`/`rc`/`bits` for the region ring, SCC pointers and
+    ///    reference counts. A 32-bit index leaves no room for these without
+    ///    a second discriminated encoding of every `RegionMD` state.
+    ///  * Compressed in-object pointers require rewriting fields, and trace
+    ///    functions enumerate field values, not field slots (see the
+    ///    compaction note in region_trace.h).
+    /// Revisit if trace is extended to expose field slots.
     struct Header
     {
       union
@@ -290,10 +330,26 @@ namespace verona::rt
     /// Should be called by the region allocator prior to initialising an
     /// object as part of the runtime.  This is used to ensure that all
     /// subclasses of rt::Object are actually part of the runtime.
+    /**
+     * Cumulative bytes of runtime objects allocated by this thread.
+     * Monotonic---frees are not subtracted---so the difference across a
+     * behaviour's execution gives the allocation volume of that
+     * behaviour (see Cown::set_alloc_alert). snmalloc's own counters are
+     * private to the allocator (see SchedulerStats::print), so the
+     * runtime counts at the one point every object allocation passes
+     * through.
+     **/
+    static size_t& thread_alloc_bytes()
+    {
+      static thread_local size_t bytes = 0;
+      return bytes;
+    }
+
     static Object* register_object(void* base, const Descriptor* desc)
     {
       Object* obj = object_start(base);
       obj->get_header().descriptor = desc;
+      thread_alloc_bytes() += desc->size;
       runtime_alloc(true);
       return obj;
     }
@@ -411,12 +467,16 @@ namespace verona::rt
     friend class Cown;
     friend class Immutable;
     friend class Freeze;
+    friend class FreezeIncremental;
+    friend class Flatten;
     friend class Region;
     friend class RegionBase;
     friend class RegionTrace;
     friend class RegionArena;
     friend class RememberedSet;
     friend class ExternalReferenceTable;
+    friend class HeapSnapshot;
+    friend class RegionImage;
     template<typename Entry>
     friend class ObjectMap;
     friend class Message;
@@ -591,6 +651,23 @@ namespace verona::rt
       get_header().bits |= (uint8_t)RegionMD::MARKED;
     }
 
+    /**
+     * Atomically transition this object from UNMARKED to MARKED. Returns
+     * true if this call performed the transition, so racing markers claim
+     * each object exactly once. Must only be called on objects whose class
+     * is UNMARKED or MARKED; or-ing the mark bit into any other class would
+     * corrupt it.
+     **/
+    inline bool mark_racy()
+    {
+      assert(
+        (get_class() == RegionMD::UNMARKED) ||
+        (get_class() == RegionMD::MARKED));
+      auto prev = get_header().rc.fetch_or(
+        (size_t)RegionMD::MARKED, std::memory_order_acq_rel);
+      return (prev & MASK) == (size_t)RegionMD::UNMARKED;
+    }
+
     inline void unmark()
     {
       assert(get_class() == RegionMD::MARKED);
@@ -730,6 +807,34 @@ namespace verona::rt
       return true;
     }
 
+    /**
+     * Decrement the reference count by `count`, returning true if it
+     * reached zero. Equivalent to `count` calls to `decref`, with a single
+     * atomic subtraction; used when releasing batches of references to the
+     * same object.
+     **/
+    inline bool decref(size_t count)
+    {
+      assert(count > 0);
+      assert(get_class() == RegionMD::RC || get_class() == RegionMD::COWN);
+
+      size_t done_rc = (size_t)get_class() + (count * ONE_RC);
+
+      size_t approx_rc = get_header().bits;
+      assert(approx_rc >= count * ONE_RC);
+
+      if (approx_rc != done_rc)
+      {
+        approx_rc = get_header().rc.fetch_sub(count * ONE_RC);
+
+        if (approx_rc != done_rc)
+          return false;
+      }
+
+      assert(approx_rc == done_rc);
+      return true;
+    }
+
     /**
      * Larger reference count than is possible to indicate that the cown's
      * reference count can no longer have new strong references taken out.
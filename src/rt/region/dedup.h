@@ -0,0 +1,327 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "ds/hashmap.h"
+#include "freeze.h"
+#include "immutable.h"
+
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace verona::rt
+{
+  /**
+   * Deduplication cache for frozen object graphs.
+   *
+   * Workloads that freeze many near-identical graphs (configuration state,
+   * prepared datasets) end up with distinct immutable copies of the same
+   * structure. After freezing, a graph can be interned: its structural hash
+   * is looked up in a global cache and, when a structurally equal graph is
+   * already cached, the fresh copy is released and a reference to the
+   * canonical one returned, so repeated freezes of equal graphs share one
+   * copy.
+   *
+   * Interning is whole-graph rather than per-SCC: replacing an individual
+   * SCC mid-freeze would require rewriting the fields of the objects that
+   * already point at the fresh copy, and trace functions enumerate field
+   * values, not field slots (see the compaction note in region_trace.h).
+   * Shared substructure still deduplicates across graphs, because identical
+   * subgraph pointers compare equal during the structural walk.
+   *
+   * Structural equality follows descriptors, edge structure and payload
+   * bytes; cowns are compared by identity, as their state is mutable.
+   * Value trace is lossy (null fields are skipped and unboxed payloads
+   * push nothing), so comparison reads each object's payload directly,
+   * with the pointer slots enumerated by `Descriptor::trace_slots`. As
+   * with Flatten, graphs containing a descriptor without `trace_slots`
+   * are left alone: `intern` returns them unchanged and uncached rather
+   * than risk conflating graphs with different program-visible data.
+   *
+   * The cache holds a reference to each canonical root; embedders that
+   * check for leaks at shutdown should `clear` the cache first.
+   **/
+  class ImmutableDedup
+  {
+    struct Entry
+    {
+      size_t hash;
+      Object* root;
+      Entry* next;
+    };
+
+    static constexpr size_t BUCKETS = 1 << 10;
+
+    std::mutex lock;
+    Entry* buckets[BUCKETS] = {};
+
+    static ImmutableDedup& get()
+    {
+      static ImmutableDedup instance;
+      return instance;
+    }
+
+    /// Program-visible bytes of an object: everything after the header.
+    static size_t payload_size(const Descriptor* desc)
+    {
+      return desc->size - sizeof(Object::Header);
+    }
+
+    /**
+     * Hash the structure reachable from `root`: descriptors, payload
+     * bytes and traversal shape, with back and cross edges folded in by
+     * visit index. Graphs that are structurally equal hash equally;
+     * collisions are resolved by `structural_eq`.
+     *
+     * Returns false, leaving `out` unset, when the graph contains a
+     * descriptor without `trace_slots`; such graphs cannot be compared
+     * losslessly and must not be interned.
+     **/
+    static bool structural_hash(Alloc* alloc, Object* root, size_t& out)
+    {
+      ObjectMap<std::pair<Object*, size_t>> visited(alloc);
+      ObjectStack dfs(alloc);
+      SlotStack slots(alloc);
+      std::vector<char> scratch;
+
+      size_t h = 0;
+      size_t visit = 0;
+
+      dfs.push(root);
+      while (!dfs.empty())
+      {
+        Object* p = dfs.pop();
+
+        auto it = visited.find(p);
+        if (it != visited.end())
+        {
+          h = bits::hash(h ^ (it.value() + 1));
+          continue;
+        }
+
+        visited.insert(alloc, std::make_pair(p, visit++));
+
+        if (p->get_class() == Object::COWN)
+        {
+          // Cowns are mutable leaves; identity is their only structure.
+          h = bits::hash(h ^ (uintptr_t)p);
+          continue;
+        }
+
+        auto* desc = p->get_descriptor();
+        if (desc->trace_slots == nullptr)
+          return false;
+
+        h = bits::hash(h ^ (uintptr_t)desc);
+
+        // Hash the payload with the pointer slots masked out, so
+        // primitive fields and nulls contribute; each slot contributes
+        // its offset here and its target's visit index above.
+        const size_t len = payload_size(desc);
+        scratch.assign((char*)p, (char*)p + len);
+
+        assert(slots.empty());
+        desc->trace_slots(p, slots);
+        while (!slots.empty())
+        {
+          Object** slot = slots.pop();
+          const size_t off = (size_t)((char*)slot - (char*)p);
+          memset(scratch.data() + off, 0, sizeof(Object*));
+          h = bits::hash(h ^ off);
+          dfs.push(*slot);
+        }
+
+        for (char c : scratch)
+          h = bits::hash(h ^ (uint8_t)c);
+      }
+
+      out = h;
+      return true;
+    }
+
+    /**
+     * Check `a` and `b` for structural equality: a bijection between their
+     * reachable objects that preserves descriptors, edge structure and
+     * payload bytes. Both graphs must already have passed
+     * `structural_hash`, so every descriptor has `trace_slots`.
+     **/
+    static bool structural_eq(Alloc* alloc, Object* a, Object* b)
+    {
+      if (a == b)
+        return true;
+
+      // Correspondence in both directions, so the mapping is a bijection.
+      ObjectMap<std::pair<Object*, Object*>> corr(alloc);
+      ObjectMap<std::pair<Object*, Object*>> rcorr(alloc);
+      ObjectStack dfs_a(alloc);
+      ObjectStack dfs_b(alloc);
+      SlotStack slots_a(alloc);
+      SlotStack slots_b(alloc);
+      std::vector<char> scratch_a;
+      std::vector<char> scratch_b;
+
+      dfs_a.push(a);
+      dfs_b.push(b);
+
+      while (!dfs_a.empty())
+      {
+        Object* x = dfs_a.pop();
+        Object* y = dfs_b.pop();
+
+        auto it = corr.find(x);
+        if (it != corr.end())
+        {
+          if (it.value() != y)
+            return false;
+          continue;
+        }
+
+        if (rcorr.find(y) != rcorr.end())
+          return false;
+
+        const bool is_cown = x->get_class() == Object::COWN;
+        if (is_cown || (y->get_class() == Object::COWN))
+        {
+          if (x != y)
+            return false;
+        }
+        else if (x == y)
+        {
+          // Shared subgraph: equal by identity, no need to traverse.
+        }
+        else if (x->get_descriptor() != y->get_descriptor())
+        {
+          return false;
+        }
+
+        corr.insert(alloc, std::make_pair(x, y));
+        rcorr.insert(alloc, std::make_pair(y, x));
+
+        if (is_cown || (x == y))
+          continue;
+
+        // Pair the children up positionally through the pointer slots,
+        // which must sit at the same offsets (a null field in one graph
+        // shifts its slot sequence), then byte-compare the rest of the
+        // payload so primitive fields and nulls are part of equality.
+        const auto* desc = x->get_descriptor();
+        const size_t len = payload_size(desc);
+        scratch_a.assign((char*)x, (char*)x + len);
+        scratch_b.assign((char*)y, (char*)y + len);
+
+        assert(slots_a.empty() && slots_b.empty());
+        desc->trace_slots(x, slots_a);
+        desc->trace_slots(y, slots_b);
+        while (!slots_a.empty() && !slots_b.empty())
+        {
+          Object** slot_x = slots_a.pop();
+          Object** slot_y = slots_b.pop();
+          const size_t off = (size_t)((char*)slot_x - (char*)x);
+          if (off != (size_t)((char*)slot_y - (char*)y))
+            return false;
+
+          memset(scratch_a.data() + off, 0, sizeof(Object*));
+          memset(scratch_b.data() + off, 0, sizeof(Object*));
+          dfs_a.push(*slot_x);
+          dfs_b.push(*slot_y);
+        }
+        if (!slots_a.empty() || !slots_b.empty())
+          return false;
+
+        if (memcmp(scratch_a.data(), scratch_b.data(), len) != 0)
+          return false;
+      }
+
+      return true;
+    }
+
+    Object* intern_internal(Alloc* alloc, Object* root)
+    {
+      size_t h;
+      if (!structural_hash(alloc, root, h))
+      {
+        Systematic::cout()
+          << "Dedup: descriptor without trace_slots, graph not interned: "
+          << root << std::endl;
+        return root;
+      }
+
+      std::lock_guard<std::mutex> g(lock);
+      Entry*& bucket = buckets[h & (BUCKETS - 1)];
+
+      for (Entry* e = bucket; e != nullptr; e = e->next)
+      {
+        if (e->hash != h)
+          continue;
+        if (!structural_eq(alloc, e->root, root))
+          continue;
+
+        if (e->root == root)
+          return root;
+
+        Systematic::cout() << "Dedup hit: " << root << " -> " << e->root
+                           << std::endl;
+        Immutable::acquire(e->root);
+        Immutable::release(alloc, root);
+        return e->root;
+      }
+
+      auto* e = (Entry*)alloc->alloc<sizeof(Entry)>();
+      e->hash = h;
+      e->root = root;
+      e->next = bucket;
+      bucket = e;
+      Immutable::acquire(root);
+      return root;
+    }
+
+    void clear_internal(Alloc* alloc)
+    {
+      std::lock_guard<std::mutex> g(lock);
+      for (size_t i = 0; i < BUCKETS; i++)
+      {
+        Entry* e = buckets[i];
+        buckets[i] = nullptr;
+        while (e != nullptr)
+        {
+          Entry* next = e->next;
+          Immutable::release(alloc, e->root);
+          alloc->dealloc<sizeof(Entry)>(e);
+          e = next;
+        }
+      }
+    }
+
+  public:
+    /**
+     * Intern a frozen graph. Returns the canonical root for the graph's
+     * structure: either `root` itself (now cached) or a previously cached
+     * equal graph, in which case `root` has been released and the returned
+     * root acquired on the caller's behalf.
+     *
+     * Graphs containing a descriptor without `trace_slots` are returned
+     * unchanged and not cached: their value trace cannot distinguish
+     * differing primitive fields or null placement, so caching them
+     * could substitute a graph with different data.
+     **/
+    static Object* intern(Alloc* alloc, Object* root)
+    {
+      assert(root->debug_is_immutable());
+      return get().intern_internal(alloc, root);
+    }
+
+    /// Freeze `o`'s region and intern the result.
+    static Object* freeze(Alloc* alloc, Object* o)
+    {
+      Freeze::apply(alloc, o);
+      return intern(alloc, o);
+    }
+
+    /// Drop every cached reference. Call before shutdown leak checks.
+    static void clear(Alloc* alloc)
+    {
+      get().clear_internal(alloc);
+    }
+  };
+} // namespace verona::rt
@@ -6,6 +6,7 @@
 #include "ds/hashmap.h"
 #include "immutable.h"
 
+#include <algorithm>
 #include <snmalloc.h>
 
 namespace verona::rt
@@ -87,6 +88,29 @@ namespace verona::rt
         return new (obj) ExternalRef(ert, o);
       }
 
+      /**
+       * Release a batch of external references in one pass, as when an FFI
+       * batch completes. Repeated references to the same object alias the
+       * same ExternalRef, so the batch is sorted and each distinct ref is
+       * released with a single atomic decrement, instead of one per
+       * reference. The array is consumed: its order is not preserved.
+       */
+      static void
+      release_batch(Alloc* alloc, ExternalRef** refs, size_t count)
+      {
+        std::sort(refs, refs + count);
+
+        for (size_t i = 0; i < count;)
+        {
+          size_t j = i + 1;
+          while ((j < count) && (refs[j] == refs[i]))
+            j++;
+
+          Immutable::release_many(alloc, refs[i], j - i);
+          i = j;
+        }
+      }
+
       /**
        * May only be called when `is_in` returns `true`.
        */
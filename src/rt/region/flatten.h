@@ -0,0 +1,159 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "freeze.h"
+#include "immutable.h"
+#include "region.h"
+
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace verona::rt
+{
+  /**
+   * Read-optimising freeze: freeze a region and relay its object graph
+   * in breadth-first order.
+   *
+   * Freeze::apply leaves the immutable graph in its mutation-era layout,
+   * so read-side traversals of a long-lived region chase pointers in
+   * whatever order mutation happened to allocate. This pass copies every
+   * frozen object into a fresh allocation in BFS order from the entry
+   * point — consecutive same-sized allocations come out of consecutive
+   * slab memory, so breadth-first readers of the relaid graph walk
+   * close to sequentially. The objects stay individual allocations,
+   * which keeps the ordinary Immutable::release path valid; a single
+   * contiguous block would need its own release protocol.
+   *
+   * Rewriting pointers after the move requires knowing where the
+   * pointers live, which `Descriptor::trace` does not provide: it
+   * enumerates field values, not slots. The pass therefore requires
+   * `Descriptor::trace_slots` on every descriptor in the graph, and
+   * falls back to a plain freeze when any descriptor lacks it.
+   *
+   * The relayout must happen while membership of the region is still
+   * known and nothing outside the caller refers to the objects, so it
+   * is fused with the freeze rather than run on an already-shared
+   * graph. Preconditions beyond Freeze::apply's: the region (and its
+   * subregions) must have no external references or noticeboard
+   * registrations, and the returned root must be used in place of `o`
+   * everywhere — in particular it is what the caller inserts into any
+   * RememberedSet. References the graph holds to cowns and to
+   * already-immutable objects move with the copies, so no external
+   * reference counts change.
+   */
+  class Flatten
+  {
+  public:
+    /**
+     * Freeze the region whose Iso object is `o`, relaying the live graph
+     * in BFS order when every descriptor allows it. Returns the entry
+     * point of the frozen graph, which replaces `o`.
+     **/
+    static Object* apply(Alloc* alloc, Object* o)
+    {
+      assert(o->debug_is_iso());
+
+      // Collect the live objects of the region (and of any subregions,
+      // which freeze will also freeze) in BFS order from the entry
+      // point. This must happen before the freeze: afterwards the
+      // region's census is gone and garbage has been deallocated, so
+      // membership can no longer be decided.
+      std::vector<Object*> members;
+      std::unordered_set<Object*> seen;
+      ObjectStack fields(alloc);
+
+      bool sloted = true;
+      members.push_back(o);
+      seen.insert(o);
+
+      for (size_t i = 0; i < members.size(); i++)
+      {
+        Object* p = members[i];
+        sloted &= p->get_descriptor()->trace_slots != nullptr;
+
+        assert(fields.empty());
+        p->trace(fields);
+        while (!fields.empty())
+        {
+          Object* q = fields.pop();
+          switch (q->get_class())
+          {
+            case Object::UNMARKED:
+            case Object::ISO:
+              // Same region, or the entry point of a subregion: both
+              // end up in the frozen graph.
+              if (seen.insert(q).second)
+                members.push_back(q);
+              break;
+
+            case Object::RC:
+            case Object::SCC_PTR:
+            case Object::NONATOMIC_RC:
+            case Object::COWN:
+              // Already immutable, or a cown: stays where it is, the
+              // reference moves with the copy.
+              break;
+
+            default:
+              assert(0);
+          }
+        }
+      }
+
+      Freeze::apply(alloc, o);
+
+      if (!sloted)
+      {
+        Systematic::cout()
+          << "Flatten: descriptor without trace_slots, graph kept in place: "
+          << o << std::endl;
+        return o;
+      }
+
+      // Copy each live object, headers included, in BFS order. The
+      // header copy carries the descriptor and, for an SCC root, its
+      // reference count.
+      std::unordered_map<Object*, Object*> copies;
+      copies.reserve(members.size());
+      for (Object* p : members)
+      {
+        size_t sz = p->size();
+        void* base = alloc->alloc(sz);
+        memcpy(base, p->real_start(), sz);
+        copies.emplace(p, Object::object_start(base));
+      }
+
+      SlotStack slots(alloc);
+      for (auto& [p, c] : copies)
+      {
+        // Union-find pointers are object pointers too: retarget them at
+        // the copied representative, fully path-compressed.
+        if (c->get_class() == Object::SCC_PTR)
+          c->set_scc(copies.at(p->immutable()));
+
+        // Rewrite the fields that point into the graph; pointers to
+        // cowns and to pre-existing immutables are left as they are.
+        assert(slots.empty());
+        c->get_descriptor()->trace_slots(c, slots);
+        while (!slots.empty())
+        {
+          Object** slot = slots.pop();
+          auto it = copies.find(*slot);
+          if (it != copies.end())
+            *slot = it->second;
+        }
+      }
+
+      // The originals are dead shells: their resources (external
+      // reference counts, finaliser-owned state) moved to the copies,
+      // so they are returned to the allocator without finalisation.
+      for (Object* p : members)
+        p->dealloc(alloc);
+
+      return copies.at(o);
+    }
+  };
+} // namespace verona::rt
@@ -4,6 +4,12 @@
 
 #include "region.h"
 
+#include <limits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#endif
+
 namespace verona::rt
 {
   /**!freeze.md
@@ -11,7 +17,8 @@ namespace verona::rt
    * ========================
    *
    * The Freeze class provides the methods for freezing an isolated object
-   * graph.
+   * graph. The traversal state lives in FreezeIncremental, so a graph can
+   * also be frozen in bounded slices.
    *
    * In does two key things
    *  - calculates the union/find data structure for strongly connected
@@ -117,9 +124,74 @@ namespace verona::rt
    * ring in the isolated regions. Every time we break the ring, we keep track
    * of that point in the objects stack.
    */
-  class Freeze
+  /**
+   * TODO(region): Freezing is single-threaded. Partitioning the DFS across
+   * threads would need every union-find transition (`set_pending`,
+   * `set_scc`, `make_nonatomic_scc`, `incref_nonatomic`) to become an
+   * atomic operation on the object header, and a concurrent union-find for
+   * the cross edges between partitions; the non-atomic transitions are a
+   * deliberate optimisation that keeps the common freeze cheap, so a
+   * parallel mode is a substantial redesign rather than a fan-out of the
+   * existing loop. For large graphs the walk below is memory-bound, so the
+   * next vertex's header is prefetched while the current one is processed.
+   */
+  /**
+   * An in-progress freeze of an isolated object graph.
+   *
+   * Holds the traversal state of the algorithm described above, so that a
+   * graph can be frozen in bounded slices: construct with the Iso entry
+   * point, then call `step` with a budget until it returns true. The
+   * owning cown can interleave the slices with its message processing, so
+   * a large freeze need not blow the latency budget of its scheduler
+   * thread; `Freeze::estimate` indicates whether slicing is worthwhile.
+   *
+   * Between steps the graph is mid-transition---object headers hold
+   * union-find state, and completed SCCs still use non-atomic reference
+   * counts---so the region must not be read, mutated or collected until
+   * `step` has returned true. The caller is responsible for keeping the
+   * graph unreachable from everything except this object in the meantime.
+   */
+  class FreezeIncremental
   {
   private:
+    enum Phase
+    {
+      Trace,
+      Sweep,
+      Dealloc,
+    };
+
+    Alloc* alloc;
+
+    // Set of objects in the region being frozen, lazily constructed from
+    // the sublists of its rings.
+    ObjectStack objects;
+    ObjectStack dfs;
+    // Iso objects of nested regions discovered during the walk.
+    ObjectStack iso;
+    // The current path of incomplete SCCs.
+    ObjectStack pending;
+    ObjectStack dealloc_regions;
+    // Finalised objects awaiting deallocation.
+    LinkedObjectStack to_dealloc;
+
+    // Region currently being frozen; nullptr between regions.
+    RegionTrace* reg = nullptr;
+    // Sweep cursor into the current object sublist.
+    Object* sweep = nullptr;
+    Phase phase = Trace;
+    bool complete = false;
+
+    static void prefetch_header(Object* o)
+    {
+      const void* p = o->real_start();
+#if defined(_MSC_VER) && !defined(__clang__)
+      _mm_prefetch((const char*)p, _MM_HINT_T0);
+#else
+      __builtin_prefetch(p, 0, 3);
+#endif
+    }
+
     static Object* post_order_mark(Object* o)
     {
       return (Object*)(((size_t)o) | 1);
@@ -130,217 +202,356 @@ namespace verona::rt
       return (Object*)(((uintptr_t)o) & ~(uintptr_t)1);
     }
 
-  public:
-    static void apply(Alloc* alloc, Object* o)
+    /**
+     * Begin freezing the next region from the iso stack: drop its ISO
+     * entry point into the ring, and seed the DFS and the object
+     * sublists.
+     **/
+    void start_region()
     {
-      assert(o->debug_is_iso());
+      assert(objects.empty());
+      assert(dfs.empty());
 
-      ObjectStack objects(alloc);
-      ObjectStack dfs(alloc);
-      ObjectStack iso(alloc);
-      ObjectStack pending(alloc);
-      ObjectStack dealloc_regions(alloc);
+      Object* p = iso.pop();
+      assert(p->debug_is_iso());
 
-      iso.push(o);
+      // TODO(region): Right now we can only freeze trace regions. We'll
+      // probably need different strategies if we want to freeze other kinds
+      // of regions, e.g. copying objects out of an arena region.
+      assert(RegionTrace::is_trace_region(p->get_region()));
+      reg = RegionTrace::get(p);
 
-      while (!iso.empty())
-      {
-        assert(objects.empty());
-        assert(dfs.empty());
+      // Drop the ISO mark on the entry point.
+      p->init_next(reg);
 
-        Object* p = iso.pop();
-        assert(p->debug_is_iso());
+      // Start with the graph entry point.
+      dfs.push(p);
 
-        // TODO(region): Right now we can only freeze trace regions. We'll
-        // probably need different strategies if we want to freeze other kinds
-        // of regions, e.g. copying objects out of an arena region.
-        assert(RegionTrace::is_trace_region(p->get_region()));
-        RegionTrace* reg = RegionTrace::get(p);
+      // Add the finaliser, and non-finaliser rings to objects.
+      objects.push(reg->next_not_root);
+      objects.push(reg->get_next());
 
-        // Drop the ISO mark on the entry point.
-        p->init_next(reg);
+      // Mark region metadata object, so sweeping does not travel through it.
+      reg->Object::mark();
 
-        // Start with the graph entry point.
-        dfs.push(p);
+      phase = Trace;
+    }
 
-        // Add the finaliser, and non-finaliser rings to objects.
-        objects.push(reg->next_not_root);
-        objects.push(reg->get_next());
+    /**
+     * Run the DFS of the current region, visiting at most `budget`
+     * vertices. Moves on to the sweep phase once the stack is empty.
+     **/
+    void trace_step(size_t& budget)
+    {
+      while ((budget > 0) && !dfs.empty())
+      {
+        budget--;
 
-        // Mark region metadata object, so sweeping does not travel through it.
-        reg->Object::mark();
+        Object::RegionMD c;
 
-        while (!dfs.empty())
-        {
-          Object::RegionMD c;
+        // Depth-first search has reached vertex q.
+        // This may be either a pre-order and post-order visit
+        Object* q_mark = dfs.pop();
+        Object* q = remove_post_order_mark(q_mark);
 
-          // Depth-first search has reached vertex q.
-          // This may be either a pre-order and post-order visit
-          Object* q_mark = dfs.pop();
-          Object* q = remove_post_order_mark(q_mark);
+        // Warm the header of the next vertex on the stack; large graph
+        // freezes are dominated by these misses.
+        if (!dfs.empty())
+          prefetch_header(remove_post_order_mark(dfs.peek()));
 
-          if (q != q_mark)
+        if (q != q_mark)
+        {
+          // Finished this part of the spanning tree
+          // If this is the head of the pending list, this means we have
+          // processed all children in the spanning tree and this should now
+          // be turned into a complete SCC with ref count 1.
+          if (q == pending.peek())
           {
-            // Finished this part of the spanning tree
-            // If this is the head of the pending list, this means we have
-            // processed all children in the spanning tree and this should now
-            // be turned into a complete SCC with ref count 1.
-            if (q == pending.peek())
-            {
-              pending.pop();
-              q->root_and_class(c)->make_nonatomic_scc();
-              assert(c == Object::PENDING);
-            }
-            continue;
+            pending.pop();
+            q->root_and_class(c)->make_nonatomic_scc();
+            assert(c == Object::PENDING);
           }
+          continue;
+        }
 
-          auto r = q->root_and_class(c);
+        auto r = q->root_and_class(c);
 
-          switch (c)
+        switch (c)
+        {
+          case Object::PENDING:
           {
-            case Object::PENDING:
+            // We have found a reference back into one of the SCCs
+            // on the current path.  Collapse the path by unioning
+            // all the nodes up to that SCC.
+            auto rank = r->pending_rank();
+            Object* p;
+            while (r != (p = pending.peek()->root_and_class(c)))
             {
-              // We have found a reference back into one of the SCCs
-              // on the current path.  Collapse the path by unioning
-              // all the nodes up to that SCC.
-              auto rank = r->pending_rank();
-              while (r != (p = pending.peek()->root_and_class(c)))
+              assert(c == Object::PENDING);
+              // Rank used to keep the union/find data structure balanced
+              auto p_rank = p->pending_rank();
+              if (p_rank <= rank)
               {
-                assert(c == Object::PENDING);
-                // Rank used to keep the union/find data structure balanced
-                auto p_rank = p->pending_rank();
-                if (p_rank <= rank)
-                {
-                  p->set_scc(r);
-                  if (p_rank == rank)
-                    r->set_pending_rank(++rank);
-                }
-                else
-                {
-                  r->set_scc(p);
-                  rank = p_rank;
-                  r = p;
-                }
-                pending.pop();
+                p->set_scc(r);
+                if (p_rank == rank)
+                  r->set_pending_rank(++rank);
               }
-              break;
-            }
-
-            case Object::ISO:
-            {
-              // External Iso, process that later.
-              iso.push(q);
-              break;
+              else
+              {
+                r->set_scc(p);
+                rank = p_rank;
+                r = p;
+              }
+              pending.pop();
             }
+            break;
+          }
 
-            case Object::RC:
-            case Object::COWN:
-            {
-              Systematic::cout()
-                << "External reference during freeze: " << r << std::endl;
-              // External reference
-              r->incref();
-              break;
-            }
+          case Object::ISO:
+          {
+            // External Iso, process that later.
+            iso.push(q);
+            break;
+          }
 
-            case Object::NONATOMIC_RC:
-            {
-              // Reference to an already complete SCC, so incref it.
-              r->incref_nonatomic();
-              break;
-            }
+          case Object::RC:
+          case Object::COWN:
+          {
+            Systematic::cout()
+              << "External reference during freeze: " << r << std::endl;
+            // External reference
+            r->incref();
+            break;
+          }
 
-            case Object::UNMARKED:
-            {
-              // Lazily construct stack of sublists for gcing
-              objects.push(q->get_next());
-              // Clear the `has_ext_ref` bit.
-              q->clear_has_ext_ref();
-              // Add this to the current path we are exploring
-              q->set_pending();
-              pending.push(q);
-              // Push post-order mark, so we can revisit once subtree complete
-              dfs.push(post_order_mark(q));
-              // Add all the fields to the dfs
-              q->trace(dfs);
-              break;
-            }
+          case Object::NONATOMIC_RC:
+          {
+            // Reference to an already complete SCC, so incref it.
+            r->incref_nonatomic();
+            break;
+          }
 
-            default:
-              assert(0);
+          case Object::UNMARKED:
+          {
+            // Lazily construct stack of sublists for gcing
+            objects.push(q->get_next());
+            // Clear the `has_ext_ref` bit.
+            q->clear_has_ext_ref();
+            // Add this to the current path we are exploring
+            q->set_pending();
+            pending.push(q);
+            // Push post-order mark, so we can revisit once subtree complete
+            dfs.push(post_order_mark(q));
+            // Add all the fields to the dfs
+            q->trace(dfs);
+            break;
           }
+
+          default:
+            assert(0);
         }
+      }
 
-        // Finalise all the objects
-        // Move non-atomics to atomics
-        // Calculate list of things to be deallocated
-        LinkedObjectStack to_dealloc;
-        p = objects.pop();
-        while (true)
-        {
-          switch (p->get_class())
-          {
-            case Object::UNMARKED:
-            {
-              // Node was unreachable deallocate it
-              auto next = p->get_next();
+      if (dfs.empty())
+      {
+        sweep = objects.pop();
+        phase = Sweep;
+      }
+    }
 
-              assert(p != reg);
+    /**
+     * Finalise unreachable objects, convert completed SCCs to atomic
+     * reference counts, and build the list of objects to deallocate,
+     * visiting at most `budget` objects. Unreachable sub-regions are
+     * released whole, not sliced. Moves on to the dealloc phase once the
+     * object sublists are exhausted.
+     **/
+    void sweep_step(size_t& budget)
+    {
+      while (budget > 0)
+      {
+        budget--;
 
-              // ISO marker has been dropped on entry point, so
-              // can pass nullptr here.
-              p->finalise(nullptr, dealloc_regions);
-              to_dealloc.push(p);
-              // Deallocate unreachable sub-regions
-              while (!dealloc_regions.empty())
-              {
-                Object* q = dealloc_regions.pop();
-                Region::release(alloc, q);
-              }
+        switch (sweep->get_class())
+        {
+          case Object::UNMARKED:
+          {
+            // Node was unreachable deallocate it
+            auto next = sweep->get_next();
 
-              p = next;
-              continue;
-            }
+            assert(sweep != reg);
 
-            case Object::NONATOMIC_RC:
+            // ISO marker has been dropped on entry point, so
+            // can pass nullptr here.
+            sweep->finalise(nullptr, dealloc_regions);
+            to_dealloc.push(sweep);
+            // Deallocate unreachable sub-regions
+            while (!dealloc_regions.empty())
             {
-              // Convert to atomic rc to allow sharing.
-              p->make_atomic();
-              break;
+              Object* q = dealloc_regions.pop();
+              Region::release(alloc, q);
             }
 
-            case Object::MARKED:
-              assert(p == reg);
-
-            case Object::RC:
-            case Object::SCC_PTR:
-              break;
+            sweep = next;
+            continue;
+          }
 
-            default:
-              assert(0);
+          case Object::NONATOMIC_RC:
+          {
+            // Convert to atomic rc to allow sharing.
+            sweep->make_atomic();
+            break;
           }
 
-          if (objects.empty())
+          case Object::MARKED:
+            assert(sweep == reg);
+
+          case Object::RC:
+          case Object::SCC_PTR:
             break;
 
-          p = objects.pop();
+          default:
+            assert(0);
         }
 
-        // Finally deallocate objects.
-        while (!to_dealloc.empty())
+        if (objects.empty())
         {
-          Object* q = to_dealloc.pop();
-          q->destructor();
-          q->dealloc(alloc);
+          sweep = nullptr;
+          phase = Dealloc;
+          return;
         }
 
+        sweep = objects.pop();
+      }
+    }
+
+    /**
+     * Deallocate up to `budget` of the finalised objects, then tear down
+     * the region metadata and move on to the next nested region.
+     **/
+    void dealloc_step(size_t& budget)
+    {
+      while ((budget > 0) && !to_dealloc.empty())
+      {
+        budget--;
+
+        Object* q = to_dealloc.pop();
+        q->destructor();
+        q->dealloc(alloc);
+      }
+
+      if (to_dealloc.empty())
+      {
         reg->discard(alloc);
         reg->dealloc(alloc);
+        reg = nullptr;
       }
+    }
 
-      assert(objects.empty());
-      assert(dfs.empty());
-      assert(iso.empty());
+  public:
+    FreezeIncremental(Alloc* alloc, Object* o)
+    : alloc(alloc),
+      objects(alloc),
+      dfs(alloc),
+      iso(alloc),
+      pending(alloc),
+      dealloc_regions(alloc)
+    {
+      assert(o->debug_is_iso());
+      iso.push(o);
+    }
+
+    /// True once every region of the graph has been frozen.
+    bool done()
+    {
+      return complete;
+    }
+
+    /**
+     * Process up to `budget` objects of the freeze; the budget counts
+     * DFS vertex visits, sweep visits and deallocations. Returns true
+     * when the whole graph, including nested regions, has been frozen.
+     *
+     * Releasing an unreachable sub-region discovered during the sweep is
+     * not itself sliced, so a slice can overrun its budget by the size
+     * of such a region.
+     **/
+    bool step(size_t budget)
+    {
+      assert(!complete);
+
+      while (budget > 0)
+      {
+        if (reg == nullptr)
+        {
+          if (iso.empty())
+            break;
+          start_region();
+        }
+
+        switch (phase)
+        {
+          case Trace:
+            trace_step(budget);
+            break;
+          case Sweep:
+            sweep_step(budget);
+            break;
+          case Dealloc:
+            dealloc_step(budget);
+            break;
+        }
+      }
+
+      if ((reg == nullptr) && iso.empty())
+      {
+        assert(objects.empty());
+        assert(dfs.empty());
+        complete = true;
+      }
+
+      return complete;
+    }
+  };
+
+  class Freeze
+  {
+  public:
+    /**
+     * Estimated cost of a freeze, taken from the counters maintained in
+     * the region header.
+     **/
+    struct Estimate
+    {
+      /// Objects the freeze will visit. Includes any garbage allocated
+      /// since the region's last collection, which the sweep also walks.
+      size_t objects;
+      /// Bytes occupied by those objects.
+      size_t bytes;
+    };
+
+    /**
+     * Estimate the cost of freezing the region entered through the Iso
+     * object `o`. Nested regions are only discovered during the walk
+     * itself, so the estimate covers the root region alone. Callers can
+     * use this to decide between `apply` and slicing a large freeze with
+     * `FreezeIncremental`.
+     **/
+    static Estimate estimate(Object* o)
+    {
+      assert(o->debug_is_iso());
+      assert(RegionTrace::is_trace_region(o->get_region()));
+
+      RegionTrace* reg = RegionTrace::get(o);
+      return {reg->object_count(), reg->memory_used()};
+    }
+
+    static void apply(Alloc* alloc, Object* o)
+    {
+      FreezeIncremental freeze(alloc, o);
+      bool complete = freeze.step((std::numeric_limits<size_t>::max)());
+      assert(complete);
+      UNUSED(complete);
     }
   };
 } // namespace verona::rt
@@ -0,0 +1,296 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "freeze.h"
+#include "immutable.h"
+#include "region.h"
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace verona::rt
+{
+  /**
+   * Save and restore a frozen object graph, so reference data built once
+   * can be loaded by later processes instead of being rebuilt.
+   *
+   * `save` walks the immutable graph below a frozen root and writes a
+   * relocatable image: each object's fields with every pointer slot
+   * replaced by the target's position in the walk. `load` reallocates the
+   * objects into a fresh region, patches the slots back into pointers,
+   * and freezes the result, rebuilding the union-find structure rather
+   * than trusting the image's.
+   *
+   * The image stores no descriptor pointers. The caller passes the same
+   * descriptor table, in the same order, to `save` and `load`; objects
+   * are recorded by their index into it. Every descriptor in the graph
+   * must provide `trace_slots` (pointer rewriting needs slot addresses,
+   * see `Flatten`), and object payloads must be trivially copyable:
+   * loading restores raw bytes without running constructors. Graphs that
+   * reference cowns cannot be saved, as a cown is meaningless in another
+   * process.
+   **/
+  class RegionImage
+  {
+    /// Image format: magic, descriptor table size, object count, then one
+    /// record per object in walk order. All integers are LEB128 varints.
+    static constexpr uint8_t MAGIC[4] = {'V', 'R', 'I', '1'};
+
+    struct Writer
+    {
+      std::ostream& out;
+
+      void u8(uint8_t v)
+      {
+        out.put((char)v);
+      }
+
+      void varint(uint64_t v)
+      {
+        while (v >= 0x80)
+        {
+          u8((uint8_t)(v | 0x80));
+          v >>= 7;
+        }
+        u8((uint8_t)v);
+      }
+
+      void bytes(const void* p, size_t len)
+      {
+        out.write((const char*)p, (std::streamsize)len);
+      }
+    };
+
+    struct Reader
+    {
+      std::istream& in;
+      bool ok = true;
+
+      uint8_t u8()
+      {
+        int c = in.get();
+        if (c < 0)
+        {
+          ok = false;
+          return 0;
+        }
+        return (uint8_t)c;
+      }
+
+      uint64_t varint()
+      {
+        uint64_t v = 0;
+        for (size_t shift = 0; shift < 64; shift += 7)
+        {
+          uint8_t b = u8();
+          v |= (uint64_t)(b & 0x7f) << shift;
+          if ((b & 0x80) == 0)
+            return v;
+        }
+        ok = false;
+        return 0;
+      }
+
+      void bytes(void* p, size_t len)
+      {
+        if (!in.read((char*)p, (std::streamsize)len))
+          ok = false;
+      }
+    };
+
+    /// Bytes of object payload following the header. Restoring an object
+    /// rewrites exactly this range, leaving the header the new region
+    /// built for it untouched.
+    static size_t payload_size(const Descriptor* desc)
+    {
+      return desc->size - sizeof(Object::Header);
+    }
+
+  public:
+    /**
+     * Write the frozen graph rooted at `o` to `out`. Returns false,
+     * leaving a partial stream, if the graph contains a descriptor
+     * missing from the table or without `trace_slots`, or a reference to
+     * a cown.
+     **/
+    static bool save(
+      Alloc* alloc,
+      Object* o,
+      const Descriptor* const* descs,
+      size_t desc_count,
+      std::ostream& out)
+    {
+      assert(o->debug_is_immutable());
+
+      std::unordered_map<const Descriptor*, size_t> desc_index;
+      for (size_t i = 0; i < desc_count; i++)
+        desc_index.emplace(descs[i], i);
+
+      // Collect the graph in BFS order; an object's position is its
+      // identity in the image.
+      std::vector<Object*> members;
+      std::unordered_map<Object*, size_t> index;
+      ObjectStack fields(alloc);
+
+      members.push_back(o);
+      index.emplace(o, 0);
+
+      for (size_t i = 0; i < members.size(); i++)
+      {
+        Object* p = members[i];
+
+        if (p->get_class() == Object::COWN)
+        {
+          Systematic::cout()
+            << "RegionImage: graph references a cown, cannot save: " << p
+            << std::endl;
+          return false;
+        }
+
+        auto* desc = p->get_descriptor();
+        if ((desc_index.count(desc) == 0) || (desc->trace_slots == nullptr))
+        {
+          Systematic::cout()
+            << "RegionImage: descriptor not saveable for object: " << p
+            << std::endl;
+          return false;
+        }
+
+        assert(fields.empty());
+        p->trace(fields);
+        while (!fields.empty())
+        {
+          Object* q = fields.pop();
+          if (index.emplace(q, members.size()).second)
+            members.push_back(q);
+        }
+      }
+
+      Writer w{out};
+      w.bytes(MAGIC, sizeof(MAGIC));
+      w.varint(desc_count);
+      w.varint(members.size());
+
+      // Write each payload with its pointer slots swizzled to the
+      // target's index, biased by one so a swizzled slot can never look
+      // like the null pointer `trace_slots` skips.
+      std::vector<char> scratch;
+      SlotStack slots(alloc);
+      for (Object* p : members)
+      {
+        auto* desc = p->get_descriptor();
+        w.varint(desc_index.at(desc));
+
+        const size_t len = payload_size(desc);
+        scratch.assign((char*)p, (char*)p + len);
+
+        assert(slots.empty());
+        desc->trace_slots(p, slots);
+        while (!slots.empty())
+        {
+          Object** slot = slots.pop();
+          const size_t off = (size_t)((char*)slot - (char*)p);
+          assert(off + sizeof(Object*) <= len);
+
+          auto tagged = (uintptr_t)(index.at(*slot) + 1);
+          memcpy(scratch.data() + off, &tagged, sizeof(uintptr_t));
+        }
+
+        w.bytes(scratch.data(), len);
+      }
+
+      return out.good();
+    }
+
+    /**
+     * Rebuild a graph saved with the same descriptor table from `in`.
+     * Returns the root of the frozen graph with one reference for the
+     * caller, or nullptr if the stream is malformed or was written
+     * against a different table.
+     **/
+    static Object* load(
+      Alloc* alloc,
+      const Descriptor* const* descs,
+      size_t desc_count,
+      std::istream& in)
+    {
+      Reader r{in};
+
+      uint8_t magic[sizeof(MAGIC)];
+      r.bytes(magic, sizeof(magic));
+      if (!r.ok || (memcmp(magic, MAGIC, sizeof(MAGIC)) != 0))
+        return nullptr;
+
+      if (r.varint() != desc_count)
+        return nullptr;
+
+      const uint64_t count = r.varint();
+      if (!r.ok || (count == 0))
+        return nullptr;
+
+      // Reallocate the objects into a fresh region and restore their
+      // payloads; the slots still hold indices at this point. The count
+      // is untrusted, so the vector grows as records actually parse
+      // rather than reserving up front: a malformed stream claiming a
+      // huge count would throw from reserve instead of taking the
+      // nullptr path below.
+      std::vector<Object*> objects;
+      Object* root = nullptr;
+
+      for (uint64_t i = 0; i < count; i++)
+      {
+        const uint64_t d = r.varint();
+        if (!r.ok || (d >= desc_count))
+        {
+          if (root != nullptr)
+            Region::release(alloc, root);
+          return nullptr;
+        }
+
+        auto* desc = descs[d];
+        Object* p = (i == 0) ? RegionTrace::create(alloc, desc) :
+                               RegionTrace::alloc(alloc, root, desc);
+        if (i == 0)
+          root = p;
+
+        r.bytes((char*)p, payload_size(desc));
+        objects.push_back(p);
+      }
+
+      if (!r.ok)
+      {
+        Region::release(alloc, root);
+        return nullptr;
+      }
+
+      // Patch the slots back into pointers.
+      SlotStack slots(alloc);
+      for (Object* p : objects)
+      {
+        assert(slots.empty());
+        p->get_descriptor()->trace_slots(p, slots);
+        while (!slots.empty())
+        {
+          Object** slot = slots.pop();
+          const auto tagged = (uintptr_t)*slot;
+          if ((tagged == 0) || (tagged > count))
+          {
+            Region::release(alloc, root);
+            return nullptr;
+          }
+          *slot = objects[tagged - 1];
+        }
+      }
+
+      // Rebuild the union-find structure rather than persisting it: the
+      // graph is identical, so the freeze finds the same SCCs.
+      Freeze::apply(alloc, root);
+      return root;
+    }
+  };
+} // namespace verona::rt
@@ -34,6 +34,21 @@ namespace verona::rt
       return 0;
     }
 
+    /**
+     * Release `count` references to `o` with a single atomic decrement.
+     * Equivalent to `count` calls to `release`.
+     **/
+    static size_t release_many(Alloc* alloc, Object* o, size_t count)
+    {
+      assert(o->debug_is_immutable());
+      auto root = o->immutable();
+
+      if (root->decref(count))
+        return free(alloc, root);
+
+      return 0;
+    }
+
     static void mark_and_scan(Alloc* alloc, Object* o, EpochMark epoch)
     {
       assert(o->debug_is_immutable());
@@ -85,7 +100,11 @@ namespace verona::rt
 
       // Free immutable graph.
       ObjectStack f(alloc);
-      LinkedObjectStack fl;
+      // Dense array of the members of the SCC being torn down. The
+      // finaliser and teardown passes each touch every member, so they
+      // sweep this array linearly rather than chasing an intrusive list
+      // through the headers of already dead objects.
+      ObjectStack members(alloc);
       LinkedObjectStack scc;
       LinkedObjectStack dfs;
 
@@ -94,7 +113,7 @@ namespace verona::rt
       while (!dfs.empty())
       {
         assert(f.empty());
-        assert(fl.empty());
+        assert(members.empty());
         assert(scc.empty());
 
         Object* v = dfs.pop();
@@ -109,7 +128,7 @@ namespace verona::rt
         while (!scc.empty())
         {
           Object* w = scc.pop();
-          fl.push(w);
+          members.push(w);
           w->trace(f);
 
           while (!f.empty())
@@ -120,15 +139,15 @@ namespace verona::rt
         }
 
         // Run all finalisers for this SCC before deallocating.
-        fl.forall<run_finaliser>();
+        members.forall([](Object* w) { run_finaliser(w); });
 
         // We don't need the actual subregions here, as they have been frozen.
         ObjectStack dummy(alloc);
         v->finalise(nullptr, dummy);
 
-        while (!fl.empty())
+        while (!members.empty())
         {
-          Object* w = fl.pop();
+          Object* w = members.pop();
           total += w->size();
           w->destructor();
           w->dealloc(alloc);
@@ -140,7 +159,7 @@ namespace verona::rt
       }
 
       assert(f.empty());
-      assert(fl.empty());
+      assert(members.empty());
       assert(scc.empty());
       assert(dfs.empty());
 
@@ -178,6 +178,47 @@ namespace verona::rt
       }
     }
 
+    /**
+     * Open a scratch region for a short-lived, behaviour-local object
+     * graph, returning its Iso object `o` of type `desc`. Scratch regions
+     * are arena regions that each scheduler thread reuses between opens:
+     * when `close_scratch` finds the region needs no per-object teardown,
+     * release is a pointer reset and the arenas are parked for this
+     * thread's next `open_scratch`, so a behaviour that builds and drops a
+     * temporary graph allocates nothing in the steady state.
+     *
+     * The caller must not let the region escape the scope that opened it
+     * (no merging into another region, no external references handed out),
+     * and must close it with `close_scratch` on the same thread.
+     *
+     * The default template parameter `size = 0` is to avoid writing two
+     * definitions which differ only in one line. This overload works because
+     * every object must contain a descriptor, so 0 is not a valid size.
+     **/
+    template<size_t size = 0>
+    static Object* open_scratch(Alloc* alloc, const Descriptor* desc)
+    {
+      return RegionArena::open_scratch<size>(alloc, desc);
+    }
+
+    /**
+     * Close a scratch region opened with `open_scratch`. If the region can
+     * be rewound in constant time it is parked for reuse; otherwise (some
+     * object has a finaliser or destructor, or an external reference was
+     * created) this falls back to an ordinary region release, so closing
+     * is always safe.
+     **/
+    static void close_scratch(Alloc* alloc, Object* o)
+    {
+      assert(o->debug_is_iso());
+      if (
+        RegionArena::is_arena_region(o->get_region()) &&
+        RegionArena::close_scratch(alloc, o))
+        return;
+
+      Region::release(alloc, o);
+    }
+
     /**
      * Returns the region metadata object for the given Iso object `o`.
      *
@@ -223,6 +264,47 @@ namespace verona::rt
       }
     }
 
+    /**
+     * Returns the bytes of objects allocated in the region represented by
+     * the Iso object `o`, from counters maintained at allocation time, so
+     * the cost is O(1) regardless of region size. For trace regions the
+     * value is exact after a collection and includes any garbage allocated
+     * since. Ignores subregions.
+     **/
+    static size_t memory_used(Object* o)
+    {
+      assert(o->debug_is_iso());
+      RegionBase* r = o->get_region();
+      switch (Region::get_type(r))
+      {
+        case RegionType::Trace:
+          return ((RegionTrace*)r)->memory_used();
+        case RegionType::Arena:
+          return ((RegionArena*)r)->memory_used();
+        default:
+          abort();
+      }
+    }
+
+    /**
+     * Returns the number of objects allocated in the region represented by
+     * the Iso object `o`, maintained like `memory_used`.
+     **/
+    static size_t object_count(Object* o)
+    {
+      assert(o->debug_is_iso());
+      RegionBase* r = o->get_region();
+      switch (Region::get_type(r))
+      {
+        case RegionType::Trace:
+          return ((RegionTrace*)r)->object_count();
+        case RegionType::Arena:
+          return ((RegionArena*)r)->object_count();
+        default:
+          abort();
+      }
+    }
+
   private:
     /**
      * Trace the region's object graph, following external pointers to cowns,
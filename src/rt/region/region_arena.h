@@ -7,6 +7,10 @@
 
 #include <cstddef>
 
+#ifndef _MSC_VER
+#  include <sys/mman.h>
+#endif
+
 namespace verona::rt
 {
   using namespace snmalloc;
@@ -46,6 +50,25 @@ namespace verona::rt
     template<IteratorType type>
     class iterator;
 
+    /**
+     * Hint for the arena geometry of a region: small for per-request
+     * regions of a few objects, large for batch regions that allocate
+     * megabytes. The hint only affects allocation granularity, never what
+     * can be allocated; oversized objects fall back to a bigger arena tier
+     * or the large object ring as before.
+     *
+     * Huge picks multi-megabyte blocks which, when `set_huge_pages` is
+     * enabled, are backed by 2MB-aligned mappings advised as transparent
+     * huge pages, cutting TLB pressure on very large flat heaps.
+     **/
+    enum class SizeHint : uint8_t
+    {
+      Small = 0,
+      Medium = 1,
+      Large = 2,
+      Huge = 3,
+    };
+
   private:
     friend class Region;
     friend class RegionTrace;
@@ -116,7 +139,27 @@ namespace verona::rt
       friend class RegionArena::iterator;
 
     public:
-      static constexpr size_t SIZE = 1024 * 1024 - 4 * sizeof(uintptr_t);
+      /**
+       * Total block sizes of the four arena geometries, including the
+       * header. Tiny per-request regions pick the small geometry, batch
+       * regions the large one; the tiers are a factor of four apart so an
+       * object that overflows one tier's payload is retried in the next.
+       * The huge geometry exists for huge-page backing (see
+       * `set_huge_pages`) and is only used as a region's preferred block
+       * size, never reached by the overflow walk.
+       **/
+      static constexpr size_t BLOCK_SIZES[4] = {
+        64 * 1024, 256 * 1024, 1024 * 1024, 4 * 1024 * 1024};
+
+      static constexpr size_t HEADER_SIZE =
+        snmalloc::bits::align_up(4 * sizeof(uintptr_t), Object::ALIGNMENT);
+
+      /**
+       * Maximum payload of any arena. Objects larger than this can never be
+       * arena-allocated, regardless of the region's geometry, so this is
+       * the threshold separating arena objects from the large object ring.
+       **/
+      static constexpr size_t SIZE = BLOCK_SIZES[2] - HEADER_SIZE;
 
       /**
        * Pointer to next arena in the linked list.
@@ -136,25 +179,37 @@ namespace verona::rt
       std::byte* non_trivial_begin;
 
       /**
-       * Pointer to the byte after the Arena. We technically don't need to
-       * store this pointer, but we have some space because `objects_begin`
-       * needs to be aligned.
+       * Pointer to the byte after the Arena. Together with `objects_begin`
+       * this recovers the block size of the arena, so no explicit capacity
+       * field is needed.
        **/
       std::byte* non_trivial_end;
 
       /**
-       * Where objects will actually be allocated.
+       * Where objects will actually be allocated: the first aligned byte
+       * after the header. The payload is laid out directly after this
+       * object rather than as an array member, so arenas of different
+       * geometries share one type.
        **/
-      alignas(Object::ALIGNMENT) std::byte objects_begin[SIZE];
+      std::byte* objects_begin() const
+      {
+        return (std::byte*)this + HEADER_SIZE;
+      }
 
     public:
-      Arena()
+      Arena(size_t block)
       : next(nullptr),
-        objects_end(objects_begin),
-        non_trivial_begin(objects_begin + SIZE),
+        objects_end(objects_begin()),
+        non_trivial_begin(objects_begin() + (block - HEADER_SIZE)),
         non_trivial_end(non_trivial_begin)
       {
-        assert(free_space() == SIZE);
+        assert(free_space() == block - HEADER_SIZE);
+      }
+
+      /// Total size of the block this arena was allocated in.
+      inline size_t block_size() const
+      {
+        return (size_t)(non_trivial_end - (std::byte*)this);
       }
 
       inline size_t free_space() const
@@ -203,10 +258,10 @@ namespace verona::rt
     private:
       bool debug_invariant() const
       {
-        bool objects_ptrs = objects_begin <= objects_end;
+        bool objects_ptrs = objects_begin() <= objects_end;
         bool non_trivial_ptrs = non_trivial_begin <= non_trivial_end;
         bool no_overlap = (non_trivial_begin - objects_end) >= 0;
-        auto alignment1 = Object::debug_is_aligned(objects_begin);
+        auto alignment1 = Object::debug_is_aligned(objects_begin());
         auto alignment2 = Object::debug_is_aligned(objects_end);
         auto alignment3 = Object::debug_is_aligned(non_trivial_begin);
         auto alignment4 = Object::debug_is_aligned(non_trivial_end);
@@ -214,7 +269,361 @@ namespace verona::rt
           alignment2 && alignment3 && alignment4;
       }
     };
-    static_assert(sizeof(Arena) == 1024 * 1024 * sizeof(std::byte));
+    static_assert(sizeof(Arena) <= Arena::HEADER_SIZE);
+
+    /**
+     * Per-thread cache of free arena blocks, one small stack per geometry.
+     * Regions churn arenas at high rates; reusing a recently released block
+     * is a pointer pop instead of a round-trip through snmalloc's large
+     * object path. Cached blocks keep their `non_trivial_end` intact so the
+     * block size can still be recovered, and are re-initialised with
+     * placement new on reuse.
+     *
+     * Caching is off by default so `debug_check_empty` leak accounting
+     * stays exact; embedders opt in with `set_arena_cache_limit`.
+     **/
+    class ArenaCache
+    {
+      Arena* tiers[4] = {nullptr, nullptr, nullptr, nullptr};
+      size_t counts[4] = {0, 0, 0, 0};
+
+      static size_t tier_of(size_t block)
+      {
+        for (size_t t = 0; t < 4; t++)
+        {
+          if (Arena::BLOCK_SIZES[t] == block)
+            return t;
+        }
+        assert(0);
+        return 3;
+      }
+
+    public:
+      /// Pop a cached block of the given size, or nullptr.
+      Arena* get(size_t block)
+      {
+        auto t = tier_of(block);
+        auto* a = tiers[t];
+        if (a == nullptr)
+          return nullptr;
+
+        tiers[t] = a->next;
+        counts[t]--;
+        return a;
+      }
+
+      /// Cache a free block; returns false if the tier is full.
+      bool put(Arena* a)
+      {
+        auto t = tier_of(a->block_size());
+        if (counts[t] >= arena_cache_limit())
+          return false;
+
+        a->next = tiers[t];
+        tiers[t] = a;
+        counts[t]++;
+        return true;
+      }
+
+      /// Return every cached block to the system.
+      void flush(Alloc* alloc)
+      {
+        for (size_t t = 0; t < 4; t++)
+        {
+          auto* a = tiers[t];
+          while (a != nullptr)
+          {
+            auto* next = a->next;
+            free_block(alloc, a, Arena::BLOCK_SIZES[t]);
+            a = next;
+          }
+          tiers[t] = nullptr;
+          counts[t] = 0;
+        }
+      }
+
+      ~ArenaCache()
+      {
+        flush(ThreadAlloc::get_noncachable());
+      }
+    };
+
+    static ArenaCache& arena_cache()
+    {
+      static thread_local ArenaCache cache;
+      return cache;
+    }
+
+    static size_t& arena_cache_limit()
+    {
+      static size_t limit = 0;
+      return limit;
+    }
+
+    /**
+     * Global queue of memory from dead regions awaiting reclamation.
+     * Releasing a large region hands its arena list and large object ring
+     * to this queue in a few atomic operations, so the releasing behaviour
+     * returns in microseconds regardless of region size; idle scheduler
+     * threads drain the queue one region at a time.
+     *
+     * Push is a Treiber stack push, safe from any thread. Popping is
+     * serialised with a try-lock, so only pushers race the head CAS and no
+     * ABA protection is needed.
+     **/
+    class ReclaimQueue
+    {
+      struct DeadRegion
+      {
+        DeadRegion* next;
+        Arena* arenas;
+        /// Null-terminated list of large ring objects, linked through the
+        /// object header next pointer.
+        Object* large;
+      };
+
+      std::atomic<DeadRegion*> head{nullptr};
+      std::atomic<bool> draining{false};
+
+    public:
+      void push(Alloc* alloc, Arena* arenas, Object* large)
+      {
+        auto* d = (DeadRegion*)alloc->alloc<sizeof(DeadRegion)>();
+        d->arenas = arenas;
+        d->large = large;
+
+        auto* h = head.load(std::memory_order_relaxed);
+        do
+        {
+          d->next = h;
+        } while (!head.compare_exchange_weak(
+          h, d, std::memory_order_release, std::memory_order_relaxed));
+      }
+
+      /// Reclaim one dead region's memory. Returns false if the queue was
+      /// empty or another thread is already draining.
+      bool reclaim_one(Alloc* alloc)
+      {
+        if (draining.exchange(true, std::memory_order_acquire))
+          return false;
+
+        auto* d = head.load(std::memory_order_acquire);
+        do
+        {
+          if (d == nullptr)
+          {
+            draining.store(false, std::memory_order_release);
+            return false;
+          }
+        } while (!head.compare_exchange_weak(
+          d, d->next, std::memory_order_acq_rel, std::memory_order_acquire));
+
+        draining.store(false, std::memory_order_release);
+
+        Object* p = d->large;
+        while (p != nullptr)
+        {
+          Object* q = p->get_next_any_mark();
+          p->dealloc(alloc);
+          p = q;
+        }
+
+        Arena* a = d->arenas;
+        while (a != nullptr)
+        {
+          Arena* q = a->next;
+          dealloc_arena(alloc, a);
+          a = q;
+        }
+
+        alloc->dealloc<sizeof(DeadRegion)>(d);
+        return true;
+      }
+    };
+
+    static ReclaimQueue& reclaim_queue()
+    {
+      static ReclaimQueue queue;
+      return queue;
+    }
+
+    static bool& deferred_reclaim()
+    {
+      static bool enabled = false;
+      return enabled;
+    }
+
+    /**
+     * Holder for this thread's parked scratch region, so its memory is
+     * returned to snmalloc at thread exit rather than leaked.
+     **/
+    struct ScratchSlot
+    {
+      RegionArena* reg = nullptr;
+
+      ~ScratchSlot()
+      {
+        if (reg != nullptr)
+          free_scratch(ThreadAlloc::get_noncachable(), reg);
+      }
+    };
+
+    static RegionArena*& scratch_region()
+    {
+      static thread_local ScratchSlot slot;
+      return slot.reg;
+    }
+
+    /// Free an empty, parked scratch region's arenas and metadata.
+    static void free_scratch(Alloc* alloc, RegionArena* reg)
+    {
+      assert(reg->current_objects == 0);
+
+      Arena* a = reg->first_arena;
+      while (a != nullptr)
+      {
+        Arena* q = a->next;
+        dealloc_arena(alloc, a);
+        a = q;
+      }
+
+      reg->dealloc(alloc);
+    }
+
+    /**
+     * Open a scratch region: take this thread's parked scratch region if
+     * one is available, allocating the new Iso object `desc` into its
+     * already-held arenas, otherwise create a fresh region of the small
+     * geometry. See Region::open_scratch for the API contract.
+     **/
+    template<size_t size = 0>
+    static Object* open_scratch(Alloc* alloc, const Descriptor* desc)
+    {
+      RegionArena*& slot = scratch_region();
+      if (slot == nullptr)
+        return create<size>(alloc, desc, SizeHint::Small);
+
+      RegionArena* reg = slot;
+      slot = nullptr;
+
+      Object* o = reg->alloc_internal<size>(alloc, desc);
+      assert(Object::debug_is_aligned(o));
+      o->init_iso();
+      o->set_region(reg);
+      return o;
+    }
+
+    /**
+     * Close a scratch region by rewinding it to empty and parking it for
+     * the next open_scratch on this thread. Returns false if the region
+     * needs per-object teardown (see reset_internal), in which case the
+     * caller must release it the normal way.
+     **/
+    static bool close_scratch(Alloc* alloc, Object* o)
+    {
+      RegionArena* reg = get(o);
+      if (!reg->reset_internal(alloc))
+        return false;
+
+      RegionArena*& slot = scratch_region();
+      if (slot == nullptr)
+        slot = reg;
+      else
+        free_scratch(alloc, reg);
+
+      return true;
+    }
+
+    /// Size and alignment of a transparent huge page on the platforms
+    /// that support them.
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    static bool& huge_pages()
+    {
+      static bool enabled = false;
+      return enabled;
+    }
+
+    /// True if blocks of this size are backed by huge-page mappings
+    /// rather than snmalloc.
+    static bool use_huge_pages(size_t block)
+    {
+#ifndef _MSC_VER
+      return huge_pages() && (block == Arena::BLOCK_SIZES[3]);
+#else
+      UNUSED(block);
+      return false;
+#endif
+    }
+
+    /// Allocate a raw arena block from the system: a 2MB-aligned
+    /// huge-page-advised mapping for the huge geometry when enabled,
+    /// snmalloc otherwise.
+    static void* alloc_block(Alloc* alloc, size_t block)
+    {
+#ifndef _MSC_VER
+      if (use_huge_pages(block))
+      {
+        // Over-reserve so the block can be trimmed to huge-page
+        // alignment; the kernel only backs aligned 2MB extents with
+        // transparent huge pages.
+        size_t reserve = block + HUGE_PAGE_SIZE;
+        void* p = mmap(
+          nullptr,
+          reserve,
+          PROT_READ | PROT_WRITE,
+          MAP_PRIVATE | MAP_ANONYMOUS,
+          -1,
+          0);
+        if (p == MAP_FAILED)
+          abort();
+
+        uintptr_t base = (uintptr_t)p;
+        uintptr_t aligned = bits::align_up(base, HUGE_PAGE_SIZE);
+        if (aligned != base)
+          munmap(p, aligned - base);
+        size_t tail = (base + reserve) - (aligned + block);
+        if (tail != 0)
+          munmap((void*)(aligned + block), tail);
+
+#  ifdef MADV_HUGEPAGE
+        madvise((void*)aligned, block, MADV_HUGEPAGE);
+#  endif
+        return (void*)aligned;
+      }
+#endif
+      return alloc->alloc(block);
+    }
+
+    /// Return a raw arena block to the system; the counterpart of
+    /// `alloc_block`.
+    static void free_block(Alloc* alloc, Arena* a, size_t block)
+    {
+#ifndef _MSC_VER
+      if (use_huge_pages(block))
+      {
+        munmap(a, block);
+        return;
+      }
+#endif
+      alloc->dealloc(a, block);
+    }
+
+    /// Allocate an arena block of `block` bytes, preferring the cache.
+    static Arena* alloc_arena(Alloc* alloc, size_t block)
+    {
+      auto* a = arena_cache().get(block);
+      if (a == nullptr)
+        a = (Arena*)alloc_block(alloc, block);
+      return new (a) Arena(block);
+    }
+
+    /// Release an arena block into the cache, or to the system if full.
+    static void dealloc_arena(Alloc* alloc, Arena* a)
+    {
+      if (!arena_cache().put(a))
+        free_block(alloc, a, a->block_size());
+    }
 
     /**
      * Pointer to the linked list of arenas where objects are allocated in.
@@ -236,11 +645,38 @@ namespace verona::rt
      **/
     Object* last_large;
 
-    RegionArena()
+    /**
+     * Preferred arena block size for this region, chosen from the size hint
+     * at creation. Objects too large for this geometry but small enough to
+     * be arena-allocated get a one-off arena of a bigger tier.
+     **/
+    size_t arena_block;
+
+    /**
+     * Bytes and count of objects allocated in this region. Arena regions
+     * never collect, so these only grow, and merging adds the other
+     * region's counters.
+     **/
+    size_t current_memory_used = 0;
+    size_t current_objects = 0;
+
+    /**
+     * Number of objects in this region whose descriptor has a finaliser
+     * (resp. destructor). Maintained like `current_objects`: read off the
+     * descriptor at allocation, summed on merge, never decremented since
+     * arena regions do not collect. Most descriptors have neither, so
+     * teardown consults these to skip a whole non-trivial pass — a
+     * finaliser-free region releases its arenas with no per-object work.
+     **/
+    size_t finaliser_count = 0;
+    size_t destructor_count = 0;
+
+    RegionArena(size_t arena_block_)
     : RegionBase(),
       first_arena(nullptr),
       last_arena(nullptr),
-      last_large(nullptr)
+      last_large(nullptr),
+      arena_block(arena_block_)
     {
       init_next(this);
     }
@@ -266,6 +702,86 @@ namespace verona::rt
       return o->is_type(desc());
     }
 
+    /**
+     * Set the per-tier limit on the per-thread free arena cache. Zero (the
+     * default) disables caching, so every released arena goes straight
+     * back to snmalloc and leak accounting stays exact. Must be set before
+     * any region churn whose arenas should be reused.
+     **/
+    static void set_arena_cache_limit(size_t limit)
+    {
+      arena_cache_limit() = limit;
+    }
+
+    /// Return this thread's cached arena blocks to snmalloc.
+    static void flush_arena_cache(Alloc* alloc)
+    {
+      arena_cache().flush(alloc);
+    }
+
+    /**
+     * Back arena blocks of the huge geometry (`SizeHint::Huge`) with
+     * 2MB-aligned anonymous mappings advised as transparent huge pages,
+     * instead of snmalloc. Multi-gigabyte flat heaps spend measurably
+     * less time in TLB misses. The flag also selects how such blocks are
+     * freed, so it must be configured before the first huge-geometry
+     * region is created and not changed while any exists (including
+     * cached blocks). No effect on platforms without mmap.
+     **/
+    static void set_huge_pages(bool enable)
+    {
+      huge_pages() = enable;
+    }
+
+    /**
+     * Free this thread's parked scratch region, if any, so leak accounting
+     * stays exact. Embedders that use scratch regions should call this
+     * before `debug_check_empty`.
+     **/
+    static void flush_scratch(Alloc* alloc)
+    {
+      RegionArena*& slot = scratch_region();
+      if (slot != nullptr)
+      {
+        free_scratch(alloc, slot);
+        slot = nullptr;
+      }
+    }
+
+    /**
+     * Enable deferred region teardown: dead regions' arenas and large
+     * object rings are queued and reclaimed by idle scheduler threads
+     * instead of being freed inline by the releasing behaviour.
+     * Finalisers and destructors still run inline at release, as they are
+     * observable; only the memory frees are deferred. Off by default so
+     * leak accounting stays exact for embedders without a running
+     * scheduler.
+     **/
+    static void set_deferred_reclaim(bool enable)
+    {
+      deferred_reclaim() = enable;
+    }
+
+    /// Reclaim one dead region from the deferred reclamation queue.
+    /// Returns true if any memory was reclaimed.
+    static bool reclaim_one(Alloc* alloc)
+    {
+      return reclaim_queue().reclaim_one(alloc);
+    }
+
+    /// Bytes of objects allocated in this region. The region metadata
+    /// object and unused arena space are not counted.
+    size_t memory_used()
+    {
+      return current_memory_used;
+    }
+
+    /// Number of objects allocated in this region.
+    size_t object_count()
+    {
+      return current_objects;
+    }
+
     /**
      * Creates a new arena region by allocationg Object `o` of type `desc`. The
      * object is initialised as the Iso object for that region, and points to a
@@ -276,11 +792,13 @@ namespace verona::rt
      * every object must contain a descriptor, so 0 is not a valid size.
      **/
     template<size_t size = 0>
-    static Object* create(Alloc* alloc, const Descriptor* desc)
+    static Object*
+    create(Alloc* alloc, const Descriptor* desc, SizeHint hint = SizeHint::Large)
     {
       void* p = Object::register_object(
         alloc->alloc<vsizeof<RegionArena>>(), RegionArena::desc());
-      RegionArena* reg = new (p) RegionArena();
+      RegionArena* reg =
+        new (p) RegionArena(Arena::BLOCK_SIZES[(size_t)hint]);
 
       // o might be allocated in the arena or the large object ring.
       Object* o = reg->alloc_internal<size>(alloc, desc);
@@ -314,6 +832,123 @@ namespace verona::rt
       return o;
     }
 
+    /**
+     * Cursor for allocating a batch of same-type objects in an arena region.
+     *
+     * Deserialising a large batch through `alloc` pays a region lookup and
+     * an arena capacity check per object. A cursor hoists both out of the
+     * loop: it reserves an arena sized for the remaining batch once, then
+     * each `alloc` is a pointer bump until that arena is exhausted — the
+     * same trick `Arena::alloc_obj` does internally, exposed so callers
+     * amortize it.
+     *
+     * The cursor caches the current arena's free space, so it must be the
+     * region's only allocator until the batch completes: interleaving
+     * `RegionArena::alloc` calls into the same region invalidates it.
+     * Objects too large for any arena fall back to the large object ring
+     * per allocation, as before.
+     **/
+    class BatchCursor
+    {
+      friend class RegionArena;
+
+      RegionArena* reg;
+      const Descriptor* desc;
+
+      /// Allocation size of each object, padded for alignment.
+      size_t sz;
+
+      /// Arena the cursor is currently bumping into. Null until the first
+      /// refill, and always null for ring-allocated objects.
+      Arena* arena;
+
+      /// Objects the current arena can hold without another capacity check.
+      size_t remaining;
+
+      /// Objects the caller still expects to allocate; sizes the next arena.
+      size_t expected;
+
+      BatchCursor(RegionArena* reg_, const Descriptor* desc_, size_t count)
+      : reg(reg_),
+        desc(desc_),
+        sz(snmalloc::bits::align_up(desc_->size, Object::ALIGNMENT)),
+        arena(nullptr),
+        remaining(0),
+        expected(count)
+      {}
+
+      /**
+       * Ensure the region's last arena has space for at least one object,
+       * preferring a geometry that fits the remaining batch, then cache it
+       * along with how many objects it can take.
+       **/
+      void refill(Alloc* alloc)
+      {
+        assert(sz <= Arena::SIZE);
+
+        if ((reg->last_arena == nullptr) || (reg->last_arena->free_space() < sz))
+        {
+          size_t want = sz * (expected > 0 ? expected : 1);
+          size_t block = reg->arena_block;
+          while (
+            ((block - Arena::HEADER_SIZE) < want) &&
+            (block < Arena::BLOCK_SIZES[2]))
+            block *= 4;
+          assert((block - Arena::HEADER_SIZE) >= sz);
+
+          Arena* a = alloc_arena(alloc, block);
+
+          if (reg->last_arena == nullptr)
+          {
+            reg->first_arena = a;
+            reg->last_arena = a;
+          }
+          else
+          {
+            reg->last_arena->next = a;
+            reg->last_arena = a;
+          }
+        }
+
+        arena = reg->last_arena;
+        remaining = arena->free_space() / sz;
+        assert(remaining > 0);
+      }
+
+    public:
+      /**
+       * Allocate the next object of the batch. Returns a pointer to where
+       * the object should be constructed, like `RegionArena::alloc`.
+       **/
+      Object* alloc(Alloc* alloc)
+      {
+        if (sz > Arena::SIZE)
+          return reg->alloc_internal(alloc, desc);
+
+        if (remaining == 0)
+          refill(alloc);
+
+        remaining--;
+        if (expected > 0)
+          expected--;
+
+        reg->use_memory(desc);
+        return arena->alloc_obj(desc, sz);
+      }
+    };
+
+    /**
+     * Open a batch allocation cursor for `count` objects of type `desc` in
+     * the region represented by the Iso object `in`. `count` is a sizing
+     * hint, not a limit: allocating more objects than expected is
+     * permitted, at a granularity of one capacity check per arena.
+     **/
+    static BatchCursor
+    alloc_batch(Object* in, const Descriptor* desc, size_t count)
+    {
+      return BatchCursor(get(in), desc, count);
+    }
+
     /**
      * Insert the Object `o` into the RememberedSet of `into`'s region.
      *
@@ -423,6 +1058,8 @@ namespace verona::rt
       assert((size == 0) || (desc->size == size));
 
       auto sz = size == 0 ? desc->size : size;
+      use_memory(desc);
+
       if (sz > Arena::SIZE)
       {
         // Allocate object.
@@ -441,11 +1078,16 @@ namespace verona::rt
       }
 
       // If we don't have an arena, or the arena does not have enough space,
-      // allocate a new arena.
+      // allocate a new arena of the region's preferred geometry, bumping up
+      // a tier if the object doesn't fit the preferred payload.
       if (last_arena == nullptr || last_arena->free_space() < sz)
       {
-        void* p = alloc->alloc<sizeof(Arena)>();
-        Arena* a = new (p) Arena();
+        size_t block = arena_block;
+        while ((block - Arena::HEADER_SIZE) < sz)
+          block *= 4;
+        assert(block <= Arena::BLOCK_SIZES[3]);
+
+        Arena* a = alloc_arena(alloc, block);
 
         if (last_arena == nullptr)
         {
@@ -491,6 +1133,12 @@ namespace verona::rt
       assert(last_arena != nullptr ? last_arena->next == nullptr : true);
       assert(
         last_large != nullptr ? last_large->get_next_any_mark() == this : true);
+
+      // Update memory usage.
+      current_memory_used += other->current_memory_used;
+      current_objects += other->current_objects;
+      finaliser_count += other->finaliser_count;
+      destructor_count += other->destructor_count;
     }
 
     void swap_root_internal(Object* oroot, Object* nroot)
@@ -537,6 +1185,60 @@ namespace verona::rt
         last_large != nullptr ? last_large->get_next_any_mark() == this : true);
     }
 
+    /**
+     * Rewind the region to empty, keeping its arena blocks for reuse: each
+     * arena's bump pointers are reset, the large object ring is freed, and
+     * references held by the remembered set are dropped. The cost is
+     * per-arena and per-large-object, not per-object.
+     *
+     * Only a region needing no per-object teardown can be rewound: no
+     * finalisers or destructors (so, by the language's guarantee that
+     * finalisers surface all isos, no subregions either), and no external
+     * references, which pin object identities beyond the region's scope.
+     * Returns false, having done nothing, if any of these hold.
+     **/
+    bool reset_internal(Alloc* alloc)
+    {
+      if ((finaliser_count > 0) || (destructor_count > 0))
+        return false;
+
+      if (external_map->size() != 0)
+        return false;
+
+      Systematic::cout() << "Region reset: arena region: " << this
+                         << std::endl;
+
+      // Free the large object ring; its objects are individual allocations
+      // and cannot be rewound.
+      Object* p = get_next();
+      while (p != this)
+      {
+        Object* q = p->get_next_any_mark();
+        p->dealloc(alloc);
+        p = q;
+      }
+      init_next(this);
+      last_large = nullptr;
+
+      // Rewind each arena's bump pointers, keeping the block.
+      for (Arena* a = first_arena; a != nullptr;)
+      {
+        Arena* q = a->next;
+        size_t block = a->block_size();
+        new (a) Arena(block);
+        a->next = q;
+        a = q;
+      }
+
+      // Nothing is marked, so this drops every reference the region held
+      // to immutables.
+      RememberedSet::sweep(alloc);
+
+      current_memory_used = 0;
+      current_objects = 0;
+      return true;
+    }
+
     /**
      * Release and deallocate all objects within the region represented by the
      * Iso Object `o`.
@@ -558,34 +1260,63 @@ namespace verona::rt
       // left in this object that haven't been added to collect.  Read-only
       // views of objects during finalization are the easiest way to guarantee
       // this.
-      for (auto it = begin<NonTrivial>(); it != end<NonTrivial>(); ++it)
+      //
+      // Each pass is driven by the descriptor counts maintained at
+      // allocation: if no descriptor in the region has a finaliser (resp.
+      // destructor) the pass is dropped wholesale, so a finaliser-free
+      // region never touches its objects on teardown. A pass that does
+      // run still visits only the non-trivial span of each arena.
+      if (finaliser_count > 0)
       {
-        (*it)->finalise(o, collect);
+        for (auto it = begin<NonTrivial>(); it != end<NonTrivial>(); ++it)
+        {
+          (*it)->finalise(o, collect);
+        }
       }
 
       // Destructors can invalidate the object's state, so all finalisers must
       // run before any destructor runs, i.e. two separate passes are required.
-      for (auto it = begin<NonTrivial>(); it != end<NonTrivial>(); ++it)
+      if (destructor_count > 0)
       {
-        (*it)->destructor();
+        for (auto it = begin<NonTrivial>(); it != end<NonTrivial>(); ++it)
+        {
+          (*it)->destructor();
+        }
       }
 
-      // Now we can deallocate large object ring.
-      Object* p = get_next();
-      while (p != this)
+      if (deferred_reclaim())
       {
-        Object* q = p->get_next_any_mark();
-        p->dealloc(alloc);
-        p = q;
+        // Hand the arena list and the large object ring to the deferred
+        // reclamation queue; everything observable (finalisers and
+        // destructors) has already run. The ring is cut into a
+        // null-terminated list, as the region metadata object it circles
+        // through is about to be deallocated.
+        Object* large = get_next() == this ? nullptr : get_next();
+        if (last_large != nullptr)
+          last_large->init_next(nullptr);
+
+        if ((large != nullptr) || (first_arena != nullptr))
+          reclaim_queue().push(alloc, first_arena, large);
       }
-
-      // Deallocate arenas.
-      Arena* arena = first_arena;
-      while (arena != nullptr)
+      else
       {
-        Arena* q = arena->next;
-        alloc->dealloc<sizeof(Arena)>(arena);
-        arena = q;
+        // Now we can deallocate large object ring.
+        Object* p = get_next();
+        while (p != this)
+        {
+          Object* q = p->get_next_any_mark();
+          p->dealloc(alloc);
+          p = q;
+        }
+
+        // Deallocate arenas, preferring the per-thread arena cache.
+        Arena* arena = first_arena;
+        while (arena != nullptr)
+        {
+          Arena* q = arena->next;
+          dealloc_arena(alloc, arena);
+          arena = q;
+        }
       }
 
       // Sweep the RememberedSet, to ensure destructors are called.
@@ -596,6 +1327,16 @@ namespace verona::rt
       dealloc(alloc);
     }
 
+    void use_memory(const Descriptor* desc)
+    {
+      current_memory_used += desc->size;
+      current_objects++;
+      if (desc->finaliser != nullptr)
+        finaliser_count++;
+      if (desc->destructor != nullptr)
+        destructor_count++;
+    }
+
   public:
     template<IteratorType type = AllObjects>
     class iterator
@@ -666,7 +1407,7 @@ namespace verona::rt
         std::byte* q = ptr->real_start() + sz;
         if constexpr (type == Trivial)
         {
-          assert(q > arena->objects_begin && q <= arena->objects_end);
+          assert(q > arena->objects_begin() && q <= arena->objects_end);
 
           // We have not yet reached the end, so q is valid.
           if (q != arena->objects_end)
@@ -683,7 +1424,7 @@ namespace verona::rt
         else if constexpr (type == AllObjects)
         {
           assert(
-            (q > arena->objects_begin && q <= arena->objects_end) ||
+            (q > arena->objects_begin() && q <= arena->objects_end) ||
             (q > arena->non_trivial_begin && q <= arena->non_trivial_end));
 
           // We have not yet reached either end, so q is valid.
@@ -734,15 +1475,15 @@ namespace verona::rt
         while (arena != nullptr)
         {
           assert(
-            arena->objects_begin < arena->objects_end ||
+            arena->objects_begin() < arena->objects_end ||
             arena->non_trivial_begin < arena->non_trivial_end);
           assert(arena->debug_invariant());
           if constexpr (type == Trivial || type == AllObjects)
           {
-            if (arena->objects_begin != arena->objects_end)
+            if (arena->objects_begin() != arena->objects_end)
               // objects_begin points to header of first object.
               // we return the actually Object*.
-              return Object::object_start(arena->objects_begin);
+              return Object::object_start(arena->objects_begin());
           }
           if constexpr (type == NonTrivial || type == AllObjects)
           {
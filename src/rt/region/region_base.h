@@ -30,6 +30,7 @@ namespace verona::rt
                      public RememberedSet
   {
     friend class Freeze;
+    friend class FreezeIncremental;
     friend class RegionTrace;
     friend class RegionArena;
 
@@ -88,6 +88,25 @@ namespace verona::rt
       r.second.mark();
     }
 
+    /**
+     * Mark a batch of objects, as `mark` would one at a time. Home slots
+     * are hashed and prefetched a fixed window ahead of the insertions, so
+     * the per-entry cache miss on sets with millions of entries is
+     * overlapped instead of serialised.
+     */
+    void mark_batch(Alloc* alloc, Object** objs, size_t count)
+    {
+      static constexpr size_t WINDOW = 8;
+
+      for (size_t i = 0; i < count; i++)
+      {
+        if ((i + WINDOW) < count)
+          hash_set->prefetch(objs[i + WINDOW]);
+
+        mark(alloc, objs[i]);
+      }
+    }
+
     /**
      * Erase all unmarked entries from the set and unmark the remaining entries.
      */
@@ -27,10 +27,19 @@ namespace verona::rt
     // The content of a noticeboard; only accessible via `put` and `get`.
     unsigned char content[sizeof(CT)];
 
+    // Bumped on every visible update, so readers holding a previous
+    // version can skip re-copying unchanged values.
+    std::atomic<uint64_t> version{0};
+
   protected:
     // Indicate if the content of the noticeboard is std::is_fundamental
     bool is_fundamental;
 
+    void bump_version()
+    {
+      version.fetch_add(1, std::memory_order_release);
+    }
+
     template<typename T>
     void put(T v)
     {
@@ -69,6 +78,7 @@ namespace verona::rt
           update_buffer.pop_front();
         }
         put(prev);
+        bump_version();
       }
       else
       {
@@ -83,10 +93,18 @@ namespace verona::rt
         }
         assert(prev);
         put(prev);
+        bump_version();
       }
     }
 
   public:
+    /// Current version of the noticeboard content, for use with
+    /// `Noticeboard::peek_batch`.
+    uint64_t get_version() const
+    {
+      return version.load(std::memory_order_acquire);
+    }
+
     void flush_all(Alloc* alloc)
     {
       if (update_buffer.empty())
@@ -51,7 +51,7 @@ namespace verona::rt
       static void empty_behaviour_trace(const Behaviour*, ObjectStack&) {}
       static const Descriptor* empty()
       {
-        static const Descriptor desc = {
+        static constexpr Descriptor desc = {
           sizeof(Behaviour), empty_behaviour_f, empty_behaviour_trace};
         return &desc;
       }
@@ -60,9 +60,59 @@ namespace verona::rt
   protected:
     const Descriptor* descriptor;
 
+  private:
+    /**
+     * The behaviour, if any, that yielded during the dispatch currently
+     * unwinding on this thread. Set by `yield` from inside `f`, observed
+     * by the wrapper that would otherwise destroy the behaviour (see
+     * VBehaviour::f), and consumed by the scheduler once per dispatch
+     * (see Cown::run).
+     **/
+    static inline thread_local Behaviour* yielded_ = nullptr;
+
   public:
     Behaviour(const Descriptor* desc) : descriptor(desc) {}
 
+    /**
+     * Checkpoint this behaviour and hand the cowns back to the scheduler.
+     *
+     * May only be called from within `f`, and must be the last thing `f`
+     * does: the runtime skips destroying the behaviour and re-sends it,
+     * state intact, to the same set of cowns, so messages queued behind a
+     * long-running behaviour get to interleave. Once the cowns have been
+     * re-acquired, `f` is invoked again from the top and must pick up from
+     * the checkpointed state.
+     **/
+    void yield()
+    {
+      assert(yielded_ == nullptr);
+      yielded_ = this;
+    }
+
+    /**
+     * True if `be` yielded during the dispatch that is unwinding. Does not
+     * consume the request; wrappers use this to keep a yielded behaviour's
+     * state alive (see VBehaviour::f).
+     **/
+    static bool yield_requested(const Behaviour* be)
+    {
+      return yielded_ == be;
+    }
+
+    /**
+     * Consume a pending yield request for `be`, returning whether one was
+     * made. Called exactly once per dispatch by the scheduler; comparing
+     * against `be` keeps requests from nested inline dispatches apart.
+     **/
+    static bool take_yield(const Behaviour* be)
+    {
+      if (yielded_ != be)
+        return false;
+
+      yielded_ = nullptr;
+      return true;
+    }
+
   protected:
     inline size_t size() const
     {
@@ -84,4 +134,65 @@ namespace verona::rt
       return descriptor;
     }
   };
+
+  /**
+   * A statically declared chain of single-cown stages.
+   *
+   * Dataflow written as nested whens pays a schedule/dequeue round trip
+   * per hop. A pipeline declares the chain up front: when stage N
+   * completes, the chain is forwarded to stage N+1's cown with a
+   * single-cown send, which the scheduler runs inline on the same thread
+   * when that cown is idle (see Cown::schedule_pipeline) — collapsing
+   * the per-hop queue round-trips in the uncontended case and degrading
+   * to a normal schedule otherwise.
+   *
+   * Stage behaviours are constructed when the pipeline is built and are
+   * run and deallocated one at a time as the chain advances. They must
+   * not yield: the chain has no way to re-deliver a checkpointed stage.
+   */
+  class Pipeline
+  {
+    friend class Cown;
+
+  public:
+    struct Stage
+    {
+      Cown* cown;
+      Behaviour* behaviour;
+    };
+
+  private:
+    size_t count;
+
+    /// Next stage to run; stages before this have completed and their
+    /// behaviours are gone.
+    size_t index = 0;
+
+    Pipeline(size_t count_) : count(count_) {}
+
+    /// The stage array is co-allocated behind the header.
+    Stage& stage(size_t i)
+    {
+      assert(i < count);
+      return ((Stage*)(this + 1))[i];
+    }
+
+  public:
+    /// Bytes for a pipeline of `count` stages.
+    static size_t size(size_t count)
+    {
+      return sizeof(Pipeline) + (count * sizeof(Stage));
+    }
+
+    static Pipeline* make(Alloc* alloc, size_t count)
+    {
+      assert(count > 0);
+      return new (alloc->alloc(size(count))) Pipeline(count);
+    }
+
+    void set_stage(size_t i, Cown* cown, Behaviour* behaviour)
+    {
+      stage(i) = {cown, behaviour};
+    }
+  };
 } // namespace verona::rt
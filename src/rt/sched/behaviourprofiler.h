@@ -0,0 +1,139 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <iostream>
+#include <snmalloc.h>
+
+namespace verona::rt
+{
+  /**
+   * Sampling profiler for behaviour execution cost.
+   *
+   * Each scheduler thread owns one profiler and samples every Nth behaviour
+   * dispatch: the cown's descriptor, the behaviour's run function and the
+   * elapsed TSC are accumulated into a small open-addressed hash table. The
+   * table is keyed by (cown descriptor, behaviour function), so the hot
+   * behaviour *types* can be identified without external perf tooling and
+   * without per-dispatch overhead off the sampled path.
+   *
+   * All recording is single-threaded from the owning scheduler thread;
+   * aggregation across threads happens in `merge` when a dump is requested.
+   */
+  class BehaviourProfiler
+  {
+  public:
+    struct Entry
+    {
+      const void* cown_desc = nullptr;
+      const void* fn = nullptr;
+      uint64_t tsc = 0;
+      uint64_t hits = 0;
+    };
+
+  private:
+    static constexpr size_t SLOT_BITS = 8;
+    static constexpr size_t SLOTS = 1 << SLOT_BITS;
+    static constexpr size_t MASK = SLOTS - 1;
+    /// One in every SAMPLE_INTERVAL dispatches is timed.
+    static constexpr size_t SAMPLE_INTERVAL = 1 << 7;
+
+    Entry table[SLOTS] = {};
+    size_t countdown = SAMPLE_INTERVAL;
+    /// Samples dropped because the table was full.
+    uint64_t dropped = 0;
+
+    static size_t hash(const void* cown_desc, const void* fn)
+    {
+      auto h = (uintptr_t)cown_desc ^ ((uintptr_t)fn >> 3);
+      h *= 0x9E3779B97F4A7C15;
+      return (h >> (64 - SLOT_BITS)) & MASK;
+    }
+
+    void add(const void* cown_desc, const void* fn, uint64_t tsc, uint64_t hits)
+    {
+      auto slot = hash(cown_desc, fn);
+
+      for (size_t probe = 0; probe < SLOTS; probe++)
+      {
+        auto& e = table[(slot + probe) & MASK];
+
+        if (e.hits == 0)
+        {
+          e.cown_desc = cown_desc;
+          e.fn = fn;
+        }
+        else if ((e.cown_desc != cown_desc) || (e.fn != fn))
+        {
+          continue;
+        }
+
+        e.tsc += tsc;
+        e.hits += hits;
+        return;
+      }
+
+      dropped += hits;
+    }
+
+  public:
+    /// Returns true if this dispatch should be timed.
+    bool sample()
+    {
+      if (--countdown != 0)
+        return false;
+
+      countdown = SAMPLE_INTERVAL;
+      return true;
+    }
+
+    void record(const void* cown_desc, const void* fn, uint64_t elapsed)
+    {
+      add(cown_desc, fn, elapsed, 1);
+    }
+
+    /// Fold another thread's samples into this profiler.
+    void merge(const BehaviourProfiler& that)
+    {
+      for (size_t i = 0; i < SLOTS; i++)
+      {
+        const auto& e = that.table[i];
+        if (e.hits != 0)
+          add(e.cown_desc, e.fn, e.tsc, e.hits);
+      }
+
+      dropped += that.dropped;
+    }
+
+    /**
+     * Print the top `k` behaviour types by accumulated TSC, one line each:
+     * cown descriptor, behaviour function, sampled hits, total and mean TSC.
+     */
+    void dump_top(std::ostream& o, size_t k)
+    {
+      for (; k > 0; k--)
+      {
+        Entry* best = nullptr;
+
+        for (size_t i = 0; i < SLOTS; i++)
+        {
+          auto& e = table[i];
+          if ((e.hits != 0) && ((best == nullptr) || (e.tsc > best->tsc)))
+            best = &e;
+        }
+
+        if (best == nullptr)
+          break;
+
+        o << "desc " << best->cown_desc << " fn " << best->fn << " hits "
+          << best->hits << " tsc " << best->tsc << " mean "
+          << (best->tsc / best->hits) << std::endl;
+
+        best->hits = 0;
+      }
+
+      if (dropped != 0)
+        o << "dropped " << dropped << std::endl;
+    }
+  };
+} // namespace verona::rt
@@ -11,6 +11,9 @@
 #include "priority.h"
 #include "schedulerthread.h"
 
+#include <type_traits>
+#include <utility>
+
 namespace verona::rt
 {
   using namespace snmalloc;
@@ -66,8 +69,24 @@ namespace verona::rt
       YesTryFast
     };
 
+    /**
+     * Per-cown backpressure policy. The defaults match the previous
+     * hardwired heuristic; stages of a pipeline with different overload
+     * points can install their own thresholds at cown creation.
+     */
+    struct BackpressurePolicy
+    {
+      /// Approximate message queue length (tracked through the reference
+      /// count) above which this cown is considered overloaded.
+      size_t overload_rc = 800;
+      /// Bytes of in-flight message payload above which this cown is
+      /// considered overloaded. Zero disables byte accounting.
+      size_t overload_bytes = 0;
+    };
+
     Cown(bool initialise = true)
     {
+      layout_guards();
       make_cown();
 
       if (initialise)
@@ -75,7 +94,11 @@ namespace verona::rt
         auto alloc = ThreadAlloc::get();
         auto epoch = Scheduler::alloc_epoch();
         set_epoch(epoch);
-        queue.init(stub_msg(alloc));
+        // A shell from the pool still holds the sleeping queue the pool
+        // built for it: MPSCQ is trivially default-constructible, so
+        // re-running this constructor left it untouched (see alloc_cown).
+        if (!std::exchange(reused_shell, false))
+          queue.init(stub_msg(alloc));
         CownThread* local = Scheduler::local();
 
         if (local != nullptr)
@@ -101,19 +124,16 @@ namespace verona::rt
     template<typename T>
     friend class Noticeboard;
 
-    template<typename T>
+    template<typename T, std::atomic<T*> T::*>
     friend class SPMCQ;
 
     static constexpr auto NO_EPOCH_SET = (std::numeric_limits<uint64_t>::max)();
 
-    union
-    {
-      std::atomic<Cown*> next_in_queue;
-      uint64_t epoch_when_popped = NO_EPOCH_SET;
-    };
-
-    // Seven pointer overhead compared to an object.
-    verona::rt::MPSCQ<MultiMessage> queue;
+    // The object header, including the reference count that every sender
+    // increfs, occupies the 16 bytes before `this`. Only rarely written
+    // fields share its cache line; the send-hot fields start on their own
+    // line below, so an incref storm and queue traffic never collide with
+    // the LD bookkeeping here.
 
     // Used for garbage collection of cyclic cowns only.
     // Uses the bottom bit to indicate the cown has been collected
@@ -122,6 +142,56 @@ namespace verona::rt
     std::atomic<uintptr_t> thread_status;
     Cown* next;
 
+    /**
+     * If true, this cown is expensive to migrate (e.g. it owns a large
+     * region working set) and work stealing will only take it when the
+     * victim has nothing else to offer.
+     */
+    std::atomic<bool> pinned{false};
+
+    BackpressurePolicy bp_policy{};
+
+  public:
+    /**
+     * Notification delivery policy (see mark_notify). Immediate wakes the
+     * cown on the first notify of each delivery; Adaptive additionally
+     * defers wakeups that arrive shortly after the previous delivery, so
+     * a high-rate notifier costs one scheduled run per window rather than
+     * one per notify round trip.
+     */
+    enum class NotifyPolicy : uint8_t
+    {
+      Immediate,
+      Adaptive,
+    };
+
+  private:
+    /// Length of the adaptive coalescing window, in TSC ticks.
+    static constexpr uint64_t NOTIFY_WINDOW_TSC = 1 << 21;
+
+    NotifyPolicy notify_policy{NotifyPolicy::Immediate};
+
+    /// TSC of the most recent notified() delivery, read by the adaptive
+    /// window check.
+    std::atomic<uint64_t> notify_last_tsc{0};
+
+    // Fields written on the message send path. The alignment keeps the
+    // queue's back pointer, which every sender exchanges, off the line
+    // holding the header's reference count; sharing the two was measured
+    // to slow cross-thread send storms.
+
+    // As with the scheduler queue, the link is named explicitly because
+    // `MultiMessage::next` is private and Cown is the friend that may
+    // form the member pointer.
+    alignas(CACHE_LINE_SIZE)
+      verona::rt::MPSCQ<MultiMessage, &MultiMessage::next> queue;
+
+    union
+    {
+      std::atomic<Cown*> next_in_queue;
+      uint64_t epoch_when_popped = NO_EPOCH_SET;
+    };
+
     /**
      * Cown's weak reference count.  This keeps the cown itself alive, but not
      * the data it can reach.  Weak reference can be promoted to strong, if a
@@ -131,6 +201,91 @@ namespace verona::rt
 
     std::atomic<BPState> bp_state{};
 
+    /// If true, this cown is scheduled on the high-priority lane of its
+    /// scheduler thread and is dequeued ahead of normal-priority cowns.
+    /// Unrelated to the backpressure-internal Priority in priority.h.
+    std::atomic<bool> sched_high{false};
+
+    /// Bytes of message payload currently in flight to this cown, when the
+    /// sender accounts them through `add_in_flight_bytes`.
+    std::atomic<size_t> bytes_in_flight{0};
+
+    /// Set while a notification delivery is pending: further notifies
+    /// collapse into it with a single flag test (see mark_notify).
+    std::atomic<bool> notify_pending{false};
+
+    /// High bit of `readers`: an exclusive message is parked waiting for
+    /// the readers to drain (see the read path in `run`).
+    static constexpr size_t WRITER_WAITING = (size_t)1
+      << ((8 * sizeof(size_t)) - 1);
+
+    /// Number of read-only behaviours currently running on this cown
+    /// (see schedule_read), plus the WRITER_WAITING flag. New readers are
+    /// only admitted by the unique thread running the cown, so the count
+    /// can only grow while that thread is in `run`.
+    std::atomic<size_t> readers{0};
+
+    /// Body of the exclusive message parked behind the readers, with the
+    /// epoch it was dequeued in. Written by the unique thread running the
+    /// cown; consumed by the next `run` after the last reader's wake.
+    std::atomic<MultiMessage::MultiMessageBody*> pending_writer{nullptr};
+    EpochMark pending_writer_epoch{EpochMark::EPOCH_NONE};
+
+#if defined(__GNUC__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+    /// Compile-time guards for the cache-line partitioning above. The
+    /// call from the constructor forces instantiation; the body never runs.
+    static void layout_guards()
+    {
+      // `this` is at least ALIGNMENT-aligned, so the line holding the last
+      // header byte ends no later than `this + 48`; a line-aligned offset
+      // is therefore always off the header's line.
+      static_assert(offsetof(Cown, queue) % CACHE_LINE_SIZE == 0);
+      // Cold LD fields stay between the header and the send-hot line.
+      static_assert(offsetof(Cown, thread_status) < offsetof(Cown, queue));
+      // All send-hot fields fit on a single line.
+      static_assert(
+        offsetof(Cown, notify_pending) + sizeof(std::atomic<bool>) -
+          offsetof(Cown, queue) <=
+        CACHE_LINE_SIZE);
+    }
+
+#ifdef USE_LAYOUT_AUDIT
+  public:
+    /// Print the offset, size and cache line of each member, to audit the
+    /// partitioning when fields are added or reordered.
+    static void dump_layout(std::ostream& o)
+    {
+#  define LAYOUT_ROW(member) \
+    o << "  " << #member << " @" << offsetof(Cown, member) << " +" \
+      << sizeof(((Cown*)nullptr)->member) << " line " \
+      << (offsetof(Cown, member) / CACHE_LINE_SIZE) << std::endl
+      o << "Cown (size " << sizeof(Cown) << ", align " << alignof(Cown)
+        << ", header at -" << sizeof(Object::Header) << ")" << std::endl;
+      LAYOUT_ROW(thread_status);
+      LAYOUT_ROW(next);
+      LAYOUT_ROW(pinned);
+      LAYOUT_ROW(bp_policy);
+      LAYOUT_ROW(notify_policy);
+      LAYOUT_ROW(notify_last_tsc);
+      LAYOUT_ROW(queue);
+      LAYOUT_ROW(next_in_queue);
+      LAYOUT_ROW(weak_count);
+      LAYOUT_ROW(bp_state);
+      LAYOUT_ROW(sched_high);
+      LAYOUT_ROW(bytes_in_flight);
+      LAYOUT_ROW(notify_pending);
+#  undef LAYOUT_ROW
+    }
+
+  private:
+#endif
+#if defined(__GNUC__)
+#  pragma GCC diagnostic pop
+#endif
+
     static Cown* create_token_cown()
     {
       static constexpr Descriptor desc = {
@@ -197,6 +352,60 @@ namespace verona::rt
 
 #endif
 
+    /**
+     * Hint that this cown should stay on its home scheduler thread.
+     * Stealing will skip it unless the victim queue holds nothing else.
+     */
+    void pin_to_thread()
+    {
+      pinned.store(true, std::memory_order_relaxed);
+    }
+
+    /// Remove the affinity hint set by `pin_to_thread`.
+    void unpin()
+    {
+      pinned.store(false, std::memory_order_relaxed);
+    }
+
+    bool is_pinned()
+    {
+      return pinned.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Place this cown on the high-priority scheduler lane, so
+     * latency-critical behaviours (e.g. health checks) are not queued
+     * behind deep analytics queues. Draining is burst-limited, so normal
+     * cowns cannot be starved.
+     */
+    void set_sched_priority(bool high)
+    {
+      sched_high.store(high, std::memory_order_relaxed);
+    }
+
+    bool high_sched_priority()
+    {
+      return sched_high.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Install a backpressure policy for this cown. Expected to be called
+     * at cown creation, before messages are sent to it.
+     */
+    void set_backpressure_policy(BackpressurePolicy policy)
+    {
+      bp_policy = policy;
+    }
+
+    /**
+     * Account payload bytes sent to (positive) or processed by (negative)
+     * this cown, for policies with a byte threshold.
+     */
+    void add_in_flight_bytes(ssize_t bytes)
+    {
+      bytes_in_flight.fetch_add((size_t)bytes, std::memory_order_relaxed);
+    }
+
     void reschedule()
     {
       if (queue.wake())
@@ -206,6 +415,33 @@ namespace verona::rt
       }
     }
 
+    /**
+     * Schedule a batch of cowns that are all known to be unscheduled,
+     * such as promise cowns fulfilled together when an upstream batch
+     * completes. Equivalent to calling `schedule` on each cown, but the
+     * scheduler interaction — the token check and the unpause of
+     * sleeping threads on a scheduler thread, the injection-stack push
+     * from an external thread — is paid once for the whole batch.
+     * Ownership of one reference per cown transfers to the scheduler
+     * queue, as with `schedule`.
+     */
+    static void schedule_many(size_t count, Cown** cowns)
+    {
+      if (count == 0)
+        return;
+
+      CownThread* t = Scheduler::local();
+
+      if (t != nullptr)
+      {
+        t->schedule_fifo_many(count, cowns);
+        return;
+      }
+
+      t = Scheduler::round_robin();
+      t->schedule_external_many(count, cowns);
+    }
+
     bool can_lifo_schedule()
     {
       // TODO: correctly indicate if this cown can be lifo scheduled.
@@ -225,6 +461,31 @@ namespace verona::rt
       o->incref();
     }
 
+    /**
+     * Returns the bytes used by this cown: its own allocation plus the
+     * memory of the regions its fields directly reference, from the
+     * counters the regions maintain at allocation time. Cheap enough for
+     * an ops dashboard to poll: proportional to the cown's field count,
+     * not the region sizes. Subregions, immutables and other cowns are not
+     * included. May only be called while the cown's behaviour is running,
+     * as it reads the fields.
+     **/
+    size_t memory_used(Alloc* alloc)
+    {
+      size_t total = size();
+
+      ObjectStack f(alloc);
+      trace(f);
+      while (!f.empty())
+      {
+        Object* p = f.pop();
+        if (p->get_class() == Object::ISO)
+          total += Region::memory_used(p);
+      }
+
+      return total;
+    }
+
     static void release(Alloc* alloc, Cown* o)
     {
       Systematic::cout() << "Cown " << o << " release" << std::endl;
@@ -282,8 +543,19 @@ namespace verona::rt
      **/
     void weak_release(Alloc* alloc)
     {
-      Systematic::cout() << "Cown " << this << " weak release" << std::endl;
-      if (weak_count.fetch_sub(1) == 1)
+      weak_release_many(alloc, 1);
+    }
+
+    /**
+     * Release `count` weak references to this cown with a single atomic
+     * subtract. Equivalent to `count` calls to `weak_release`.
+     **/
+    void weak_release_many(Alloc* alloc, size_t count)
+    {
+      Systematic::cout() << "Cown " << this << " weak release (" << count
+                         << ")" << std::endl;
+      assert(count != 0);
+      if (weak_count.fetch_sub(count) == count)
       {
         auto* t = owning_thread();
         yield();
@@ -315,6 +587,96 @@ namespace verona::rt
       weak_count++;
     }
 
+    /**
+     * Thread-local accumulator of weak reference releases.
+     *
+     * Tearing down a registry can drop a very large number of weak
+     * references in one burst, and a fetch_sub per reference makes the
+     * released cowns' reference count cache lines ping between threads.
+     * The batch collapses repeated releases of one cown into a single
+     * deferred atomic subtract (weak_release_many), applied when the
+     * entry is evicted by a colliding cown, on an explicit flush, or when
+     * the thread exits.
+     *
+     * Deferring a decrement is safe: it only keeps the cown's allocation
+     * alive longer, exactly as an undropped weak reference would. Flush
+     * before the runtime tears down, or the retained stubs are reported
+     * as leaks.
+     **/
+    class WeakReleaseBatch
+    {
+      friend class Cown;
+
+      /// Direct-mapped table size; a power of two.
+      static constexpr size_t ENTRIES = 64;
+
+      Cown* cowns[ENTRIES] = {};
+      size_t counts[ENTRIES] = {};
+
+      /// Cowns are allocation-aligned, so the low address bits carry no
+      /// entropy.
+      static size_t slot(Cown* cown)
+      {
+        return (address_cast(cown) >> 6) & (ENTRIES - 1);
+      }
+
+      void add(Alloc* alloc, Cown* cown)
+      {
+        size_t i = slot(cown);
+        if (cowns[i] != cown)
+        {
+          if (cowns[i] != nullptr)
+            cowns[i]->weak_release_many(alloc, counts[i]);
+          cowns[i] = cown;
+          counts[i] = 0;
+        }
+        counts[i]++;
+      }
+
+      void flush(Alloc* alloc)
+      {
+        for (size_t i = 0; i < ENTRIES; i++)
+        {
+          if (cowns[i] == nullptr)
+            continue;
+
+          cowns[i]->weak_release_many(alloc, counts[i]);
+          cowns[i] = nullptr;
+          counts[i] = 0;
+        }
+      }
+
+    public:
+      ~WeakReleaseBatch()
+      {
+        flush(ThreadAlloc::get_noncachable());
+      }
+    };
+
+    /// The calling thread's weak release batch.
+    static WeakReleaseBatch& weak_batch()
+    {
+      static thread_local WeakReleaseBatch batch;
+      return batch;
+    }
+
+    /**
+     * Release a weak reference to `cown` through the calling thread's
+     * batch: the decrement is deferred and merged with other pending
+     * releases of the same cown. Use for burst releases, and pair with
+     * `flush_weak_releases` once the burst is done.
+     **/
+    static void weak_release_batched(Alloc* alloc, Cown* cown)
+    {
+      weak_batch().add(alloc, cown);
+    }
+
+    /// Apply every weak release deferred by this thread's batch.
+    static void flush_weak_releases(Alloc* alloc)
+    {
+      weak_batch().flush(alloc);
+    }
+
     /**
      * Gets a strong reference from a weak reference.
      *
@@ -349,7 +711,61 @@ namespace verona::rt
       cown->reschedule();
     }
 
+    /// Select how notifications are delivered to this cown. Not
+    /// synchronised with concurrent notifiers: set it before the cown is
+    /// shared.
+    void set_notify_policy(NotifyPolicy policy)
+    {
+      notify_policy = policy;
+    }
+
+    /**
+     * Request that notified() runs on this cown. Notifications coalesce:
+     * while a delivery is pending, further calls are a single relaxed
+     * flag test. Under NotifyPolicy::Adaptive, a notify arriving within
+     * NOTIFY_WINDOW_TSC of the previous delivery does not wake the cown
+     * immediately; the wakeup is deferred to the end of the window, so a
+     * high-rate notifier costs one delivery per window.
+     */
     void mark_notify()
+    {
+      // Hot path: a delivery is already pending, this notify rides along.
+      if (notify_pending.load(std::memory_order_relaxed))
+      {
+        yield();
+        return;
+      }
+
+      if (notify_pending.exchange(true, std::memory_order_acq_rel))
+      {
+        yield();
+        return;
+      }
+
+      yield();
+
+      if (notify_policy == NotifyPolicy::Adaptive)
+      {
+        // Defer the wakeup when we are inside the coalescing window.
+        // External threads have no timer wheel and always deliver
+        // immediately.
+        auto last = notify_last_tsc.load(std::memory_order_relaxed);
+        auto now = Systematic::tick();
+        if ((Scheduler::local() != nullptr) && (now - last < NOTIFY_WINDOW_TSC))
+        {
+          schedule_after<NotifyFlush>(
+            (last + NOTIFY_WINDOW_TSC) - now, this, this);
+          return;
+        }
+      }
+
+      deliver_notify();
+    }
+
+  private:
+    /// Wake the cown so the scheduler delivers notified(): sets the
+    /// queue's notify bit and schedules the cown if it was asleep.
+    void deliver_notify()
     {
       if (queue.mark_notify())
       {
@@ -359,6 +775,34 @@ namespace verona::rt
       yield();
     }
 
+    /// Timer payload for an adaptively deferred notification: running on
+    /// the target cown at the end of the window, it sets the queue's
+    /// notify bit so the scheduler delivers notified() when this batch
+    /// completes.
+    class NotifyFlush : public Behaviour
+    {
+      friend class Cown;
+
+      Cown* target;
+
+      static void f(Behaviour* msg)
+      {
+        static_cast<NotifyFlush*>(msg)->target->queue.mark_notify();
+      }
+
+      static void trace(const Behaviour*, ObjectStack&) {}
+
+      static const Behaviour::Descriptor* desc()
+      {
+        static constexpr Behaviour::Descriptor desc = {
+          sizeof(NotifyFlush), f, trace};
+
+        return &desc;
+      }
+
+      NotifyFlush(Cown* target) : Behaviour(desc()), target(target) {}
+    };
+
   protected:
     void schedule()
     {
@@ -377,8 +821,12 @@ namespace verona::rt
       // TODO Make this assertion pass.
       // assert(can_lifo_schedule() || Scheduler::debug_not_running());
 
+      // Shard external schedules across scheduler threads: each external
+      // thread keeps its own round robin position, and the target thread
+      // has a dedicated injection queue, so concurrent injectors do not
+      // serialize on a single queue front.
       t = Scheduler::round_robin();
-      t->schedule_lifo(this);
+      t->schedule_external(this);
     }
 
   private:
@@ -391,10 +839,165 @@ namespace verona::rt
 
     void dealloc(Alloc* alloc)
     {
+      if (try_pool_shell(alloc))
+      {
+        yield();
+        return;
+      }
+
       Object::dealloc(alloc);
       yield();
     }
 
+    /**
+     * Per-thread pool of cown shells, keyed by descriptor.
+     *
+     * A connection-per-cown server creates and collects cowns at a very
+     * high rate, and every creation pays for the allocation and for
+     * setting up the message queue around a fresh stub node. When a cown
+     * is freed on a scheduler thread, its shell is offered back here with
+     * the queue re-initialised around a recycled stub, sleeping and ready
+     * to receive; creating the next cown of the same descriptor reuses
+     * the shell and skips both, writing only the header and the payload.
+     *
+     * Shells are only reusable for the exact descriptor they were created
+     * with, as the descriptor determines the allocation size. The table
+     * is a small descriptor-indexed set of freelists; workloads churn few
+     * distinct cown types, so a handful of slots suffices.
+     */
+    class ShellPool
+    {
+      friend class Cown;
+
+      // Reuse relies on re-running the Cown constructor over a shell
+      // leaving the pooled queue intact.
+      static_assert(
+        std::is_trivially_default_constructible_v<
+          verona::rt::MPSCQ<MultiMessage, &MultiMessage::next>>);
+
+      /// Distinct descriptors the pool discriminates between.
+      static constexpr size_t SLOTS = 8;
+
+      /// Bound on pooled shells per thread, across all slots; overflow
+      /// goes back to the allocator.
+      static constexpr size_t MAX_SIZE = 64;
+
+      const Descriptor* descs[SLOTS] = {};
+
+      /// Freelists, linked through the cown `next` field. Every pooled
+      /// shell holds an initialised sleeping queue.
+      Cown* shells[SLOTS] = {};
+
+      size_t size = 0;
+
+      ~ShellPool()
+      {
+        auto* alloc = ThreadAlloc::get_noncachable();
+        for (size_t i = 0; i < SLOTS; i++)
+        {
+          while (shells[i] != nullptr)
+          {
+            auto* shell = shells[i];
+            shells[i] = shell->next;
+            auto* stub = shell->queue.destroy();
+            alloc->dealloc<sizeof(MultiMessage)>(stub);
+            shell->Object::dealloc(alloc);
+          }
+        }
+      }
+    };
+
+    /**
+     * Allocate the backing memory for a cown with the given descriptor,
+     * preferring a recycled shell from the calling thread's pool. Returns
+     * the base of the allocation, as `alloc->alloc` would; used by the
+     * cown operator new (see VCown).
+     */
+    template<size_t size>
+    static void* alloc_cown(Alloc* alloc, const Descriptor* desc)
+    {
+      auto& p = shell_pool();
+      auto* local = Scheduler::local();
+
+      for (size_t i = 0; i < ShellPool::SLOTS; i++)
+      {
+        if ((p.descs[i] != desc) || (p.shells[i] == nullptr))
+          continue;
+
+        auto* shell = p.shells[i];
+        p.shells[i] = shell->next;
+        p.size--;
+        reused_shell = true;
+
+        if (local != nullptr)
+          local->stats.cown_pool_hit();
+
+        Systematic::cout() << "Cown shell " << shell << " reused" << std::endl;
+        return &shell->get_header();
+      }
+
+      if (local != nullptr)
+        local->stats.cown_pool_miss();
+
+      return alloc->alloc<size>();
+    }
+
+  private:
+    /// The calling thread's shell pool.
+    static ShellPool& shell_pool()
+    {
+      static thread_local ShellPool pool;
+      return pool;
+    }
+
+    /// Set when alloc_cown handed out a pooled shell; tells the
+    /// constructor the queue is already initialised.
+    static inline thread_local bool reused_shell = false;
+
+    /**
+     * Offer this cown's shell to the thread-local pool instead of freeing
+     * it. Only pools on scheduler threads outside teardown, for a
+     * descriptor that can hold a slot, while capacity remains.
+     */
+    bool try_pool_shell(Alloc* alloc)
+    {
+      if (
+        (Scheduler::local() == nullptr) ||
+        Scheduler::is_teardown_in_progress())
+        return false;
+
+      auto& p = shell_pool();
+      if (p.size >= ShellPool::MAX_SIZE)
+        return false;
+
+      auto* desc = get_descriptor();
+      size_t slot = ShellPool::SLOTS;
+      for (size_t i = 0; i < ShellPool::SLOTS; i++)
+      {
+        if (p.descs[i] == desc)
+        {
+          slot = i;
+          break;
+        }
+
+        if ((p.descs[i] == nullptr) && (slot == ShellPool::SLOTS))
+          slot = i;
+      }
+
+      if (slot == ShellPool::SLOTS)
+        return false;
+
+      Systematic::cout() << "Cown shell " << this << " pooled" << std::endl;
+
+      p.descs[slot] = desc;
+      queue.init(stub_msg(alloc));
+      next = p.shells[slot];
+      p.shells[slot] = this;
+      p.size++;
+      return true;
+    }
+
+  public:
     bool scanned(EpochMark epoch)
     {
       return in_epoch(epoch);
@@ -453,6 +1056,11 @@ namespace verona::rt
       // message structure, or alter how the backpressure system determines
       // which is/are the currently active cowns.
       Scheduler::local()->message_body = nullptr;
+      // The queue's notify bit is already consumed; clear the coalescing
+      // flag before running notified() so a notify arriving during the
+      // callback wins the flag and triggers the next delivery.
+      notify_pending.store(false, std::memory_order_relaxed);
+      notify_last_tsc.store(Systematic::tick(), std::memory_order_relaxed);
       notified();
     }
 
@@ -479,10 +1087,11 @@ namespace verona::rt
      *     rescheduling. However, for fairness, it is better to reschedule in
      *     case the behaviour executes for a very long time.
      **/
-    static void fast_send(MultiMessage::MultiMessageBody* body, EpochMark epoch)
+    static void
+    fast_send(Alloc* alloc, MultiMessage::MultiMessageBody* body, EpochMark epoch)
     {
-      auto* alloc = ThreadAlloc::get();
       const auto last = body->count - 1;
+      const auto start = body->index;
       assert(body->index <= last);
 
       auto high_priority = false;
@@ -497,6 +1106,13 @@ namespace verona::rt
           });
       }
 
+      // Hold the epoch across the whole acquisition batch, rather than
+      // entering and exiting it for every cown. The epoch is needed in case
+      // priority must be raised after a message is placed in a queue, and
+      // batching the enter/exit removes one fence per cown on the multi-cown
+      // path.
+      Epoch e(alloc);
+
       for (; body->index < body->count; body->index++)
       {
         auto m = MultiMessage::make_message(alloc, body, epoch);
@@ -520,21 +1136,12 @@ namespace verona::rt
         if (next->overloaded() || coin(3))
           high_priority = true;
 
-        if (!high_priority)
+        if (!next->try_fast_send(m))
         {
-          if (!next->try_fast_send(m))
-            return;
-        }
-        else
-        {
-          // Hold epoch in case priority needs to be raised after message is
-          // placed in queue.
-          Epoch e(alloc);
-          if (!next->try_fast_send(m))
-          {
+          if (high_priority)
             backpressure_unblock(next, e);
-            return;
-          }
+          record_batch(body->index - start);
+          return;
         }
 
         Systematic::cout() << "MultiMessage " << m << ": fast acquire cown "
@@ -546,6 +1153,7 @@ namespace verona::rt
             << "MultiMessage " << m
             << ": fast send complete, reschedule last cown" << std::endl;
           next->schedule();
+          record_batch(body->count - start);
           return;
         }
 
@@ -561,6 +1169,18 @@ namespace verona::rt
       }
     }
 
+    /**
+     * Record how many cowns one call to `fast_send` managed to acquire,
+     * so batched multi-cown acquisition can be compared against the
+     * one-at-a-time protocol in the scheduler stats.
+     */
+    static void record_batch(size_t acquired)
+    {
+      auto* sched = Scheduler::local();
+      if (sched != nullptr)
+        sched->stats.mm_batch(acquired);
+    }
+
     /**
      * This method implements an optimized multi-message send to a cown. A
      * sleeping cown will not be reschdeuled because we want to immediately
@@ -583,6 +1203,29 @@ namespace verona::rt
       return needs_scheduling;
     }
 
+    /**
+     * Log a flight-recorder event for any behaviour that allocates more
+     * than `bytes` bytes of runtime objects in a single execution,
+     * identified by its body function pointer. The cost is two reads of
+     * a thread-local counter per behaviour, so the alert can stay on in
+     * production to catch the one message that allocates gigabytes.
+     * Zero, the default, disables the check.
+     **/
+    static void set_alloc_alert(size_t bytes)
+    {
+      alloc_alert_bytes() = bytes;
+    }
+
+  private:
+    /// Behaviour allocation volume above which an AllocAlert event is
+    /// recorded; see `set_alloc_alert`.
+    static size_t& alloc_alert_bytes()
+    {
+      static size_t bytes = 0;
+      return bytes;
+    }
+
+  public:
     /**
      * Execute the behaviour of the given multi-message.
      *
@@ -592,10 +1235,9 @@ namespace verona::rt
      * Otherwise, all cowns have been acquired and we can execute the message
      * behaviour.
      **/
-    static bool run_step(MultiMessage* m)
+    static bool run_step(Alloc* alloc, MultiMessage* m)
     {
       MultiMessage::MultiMessageBody& body = *(m->get_body());
-      Alloc* alloc = ThreadAlloc::get();
       size_t last = body.count - 1;
       auto cown = body.cowns[m->get_body()->index];
 
@@ -660,7 +1302,7 @@ namespace verona::rt
         // starting from the next cown.
         body.index++;
 
-        fast_send(&body, e);
+        fast_send(alloc, &body, e);
         return false;
       }
 
@@ -703,23 +1345,469 @@ namespace verona::rt
       for (size_t i = 0; i < body.count; i++)
         body.cowns[i]->set_blocker(nullptr);
 
+      size_t alloc_before = Object::thread_alloc_bytes();
+
       // Run the behaviour.
       body.behaviour->f();
 
+      if (alloc_alert_bytes() != 0)
+      {
+        size_t delta = Object::thread_alloc_bytes() - alloc_before;
+        if (delta >= alloc_alert_bytes())
+        {
+          auto body_f = (const void*)body.behaviour->get_descriptor()->f;
+          Systematic::cout() << "Behaviour " << body_f << " allocated "
+                             << delta << " bytes" << std::endl;
+          size_t kib = delta >> 10;
+          if (kib > (std::numeric_limits<uint32_t>::max)())
+            kib = (std::numeric_limits<uint32_t>::max)();
+          if (Scheduler::local() != nullptr)
+            Scheduler::local()->events.record(
+              SchedulerEventRing::Kind::AllocAlert, body_f, (uint32_t)kib);
+        }
+      }
+
+      if (Behaviour::yield_requested(body.behaviour))
+      {
+        // The behaviour yielded: the references this message holds on its
+        // cowns and all its allocations transfer to the continuation,
+        // which Cown::run re-sends with this same body.
+        Systematic::cout() << "MultiMessage " << m << " yielded on " << cown
+                           << std::endl;
+        return true;
+      }
+
       for (size_t i = 0; i < body.count; i++)
         Cown::release(alloc, body.cowns[i]);
 
       Systematic::cout() << "MultiMessage " << m << " completed and running on "
                          << cown << std::endl;
 
-      // Free the body and the behaviour.
-      alloc->dealloc(body.behaviour, body.behaviour->size());
-      alloc->dealloc<sizeof(MultiMessage::MultiMessageBody)>(m->get_body());
+      // Free the body and the behaviour. A combined block stays alive
+      // until the senders have been rescheduled, and is then freed in one
+      // piece with the cown array (see Cown::run).
+      if (body.combined_size == 0)
+      {
+        alloc->dealloc(body.behaviour, body.behaviour->size());
+        alloc->dealloc<sizeof(MultiMessage::MultiMessageBody)>(m->get_body());
+      }
+      else if (!MultiMessage::behaviour_combined(m->get_body()))
+      {
+        // The block holds only the body and the cown array (see
+        // MultiMessage::make_body_inline); the large-capture behaviour is
+        // its own allocation and is freed here.
+        alloc->dealloc(body.behaviour, body.behaviour->size());
+      }
 
       return true;
     }
 
+    /**
+     * Run a read-only message's behaviour without exclusive ownership of
+     * the cown: the cown has already been handed back to the scheduler,
+     * and any number of readers may be inside it at once (see the read
+     * path in `run`). Mirrors the execution half of `run_step` and the
+     * completion handling of `run`, for a single-cown message whose
+     * stub has been surrendered to the queue.
+     *
+     * The caller has taken a reader slot and holds a reference to the
+     * cown for this method; the last reader out delivers the wake for a
+     * parked exclusive message.
+     **/
+    void
+    run_read(Alloc* alloc, MultiMessage::MultiMessageBody* body, EpochMark e)
+    {
+      assert(body->count == 1);
+      assert(body->index == 0);
+      assert(body->read);
+
+      if (e == EpochMark::EPOCH_NONE)
+        Scheduler::recv_inflight_message();
+
+      if (Scheduler::should_scan())
+      {
+        if (e != Scheduler::local()->send_epoch)
+        {
+          Systematic::cout() << "Trace read message on cown " << this
+                             << std::endl;
+          scan(alloc, Scheduler::local()->send_epoch);
+
+          ObjectStack f(alloc);
+          body->behaviour->trace(f);
+          scan_stack(alloc, Scheduler::local()->send_epoch, f);
+        }
+      }
+
+      auto* sched = Scheduler::local();
+      sched->message_body = body;
+      set_blocker(nullptr);
+
+      // Run the behaviour.
+      body->behaviour->f();
+
+      if (sched->mutor != nullptr)
+      {
+        // The unmute protocol would consume the message's sender array,
+        // and a reader-shared cown must not be muted mid-read; drop the
+        // request, as `try_run_direct` does.
+        Cown::release(alloc, sched->mutor);
+        sched->mutor = nullptr;
+      }
+
+      if (Behaviour::take_yield(body->behaviour))
+      {
+        // Re-send the message, keeping its reference and state, as `run`
+        // does for exclusive behaviours; it runs again as a fresh read.
+        auto resend_epoch = Scheduler::epoch();
+        if (resend_epoch == EpochMark::EPOCH_NONE)
+          Scheduler::record_inflight_message();
+        fast_send(alloc, body, resend_epoch);
+      }
+      else
+      {
+        // Free the message state, as `run_step` and `run` do between
+        // them, and release the reference the message held.
+        Cown::release(alloc, this);
+
+        auto* behaviour = body->behaviour;
+        const size_t combined_size = body->combined_size;
+        auto** senders = body->cowns;
+
+        if (combined_size == 0)
+        {
+          alloc->dealloc(behaviour, behaviour->size());
+          alloc->dealloc<sizeof(MultiMessage::MultiMessageBody)>(body);
+        }
+        else if (!MultiMessage::behaviour_combined(body))
+        {
+          alloc->dealloc(behaviour, behaviour->size());
+        }
+
+        dealloc_senders(alloc, senders, 1, combined_size);
+      }
+
+      // Leave the reader slot. Exactly one reader can observe itself as
+      // the last one out with an exclusive message parked; it hands the
+      // cown back to the scheduler.
+      auto prev = readers.fetch_sub(1, std::memory_order_acq_rel);
+      assert((prev & ~WRITER_WAITING) != 0);
+      if (prev == (WRITER_WAITING | 1))
+      {
+        readers.fetch_and(~WRITER_WAITING, std::memory_order_acq_rel);
+        yield();
+        Systematic::cout() << "Last reader waking cown " << this << std::endl;
+        schedule();
+      }
+
+      Cown::release(alloc, this);
+    }
+
+    /**
+     * Reclaim memory from one dead region on the deferred reclamation
+     * queue (see RegionArena::set_deferred_reclaim). Called from
+     * otherwise-idle scheduler threads; returns true if any work was done.
+     */
+    static bool reclaim_dead_regions(Alloc* alloc)
+    {
+      return RegionArena::reclaim_one(alloc);
+    }
+
+    /// Bound on nested inline behaviour execution from `schedule`.
+    static constexpr size_t MAX_INLINE_DEPTH = 4;
+
+    /// Largest behaviour (descriptor pointer plus captured state) that is
+    /// co-allocated with its message body and cown array in one block.
+    static constexpr size_t MAX_COMBINED_CAPTURE = 128;
+
+    /**
+     * Fast path for single-cown behaviours. Sends the message with one
+     * allocation batch and, when the target cown turns out to be idle,
+     * runs it right here through `Cown::run` instead of taking a queue
+     * round-trip through the scheduler. Running inline is semantically
+     * valid (see the note on `fast_send`); fairness is preserved by
+     * refusing to inline when the fairness protocol wants a steal and by
+     * bounding the inline depth.
+     *
+     * The caller must have ruled out overloaded or high-priority targets,
+     * which need the full backpressure handling in `fast_send`.
+     */
+    template<TransferOwnership transfer>
+    static void schedule_inline(
+      Alloc* alloc, CownThread* sched, MultiMessage::MultiMessageBody* body)
+    {
+      auto* cown = body->cowns[0];
+
+      if constexpr (transfer == NoTransfer)
+        Cown::acquire(cown);
+
+      auto epoch = Scheduler::epoch();
+      if (epoch == EpochMark::EPOCH_NONE)
+        Scheduler::record_inflight_message();
+
+      if (sched->message_body != nullptr)
+        backpressure_scan(*sched->message_body, *body);
+
+      auto m = MultiMessage::make_message(alloc, body, epoch);
+
+      if (!cown->try_fast_send(m))
+      {
+        // The cown is scheduled or held by another behaviour; it will run
+        // our message in due course.
+        return;
+      }
+
+      Systematic::cout() << "Inline run of cown " << cown << std::endl;
+
+      // We own the previously idle cown. Bind it to this thread if it is
+      // unbound (as the scheduler's prerun would), then run it here.
+      if (cown->owning_thread() == nullptr)
+      {
+        cown->set_owning_thread(sched);
+        cown->next = sched->list;
+        sched->list = cown;
+        sched->total_cowns++;
+      }
+
+      // Save the running-behaviour context of this thread; the inline run
+      // must not leak its message body or mutor into the enclosing
+      // behaviour's backpressure handling.
+      auto* saved_body = sched->message_body;
+      auto* saved_mutor = sched->mutor;
+      sched->mutor = nullptr;
+      sched->inline_depth++;
+
+      bool reschedule = cown->run(alloc, sched->state, sched->send_epoch);
+
+      sched->inline_depth--;
+      sched->message_body = saved_body;
+      sched->mutor = saved_mutor;
+      sched->stats.inline_run();
+
+      if (reschedule)
+        sched->schedule_fifo(cown);
+    }
+
+    /**
+     * Schedule a previously constructed behaviour on a single cown. Used
+     * by the timer wheel, which constructs the behaviour when a timer is
+     * armed and sends it when the deadline expires.
+     */
+    static void schedule_prepared(Alloc* alloc, Cown* cown, Behaviour* be)
+    {
+      auto body = MultiMessage::make_body_inline(alloc, 1, be);
+      body->cowns[0] = cown;
+      Cown::acquire(cown);
+      auto sched = Scheduler::local();
+      auto epoch = sched == nullptr ? EpochMark::EPOCH_A : Scheduler::epoch();
+
+      if (epoch == EpochMark::EPOCH_NONE)
+        Scheduler::record_inflight_message();
+
+      if ((sched != nullptr) && (sched->message_body != nullptr))
+        backpressure_scan(*sched->message_body, *body);
+
+      fast_send(alloc, body, epoch);
+    }
+
+    /**
+     * Behaviour dispatching one stage of a Pipeline. Runs the stage's
+     * user behaviour, then forwards the chain to the next stage's cown
+     * with a single-cown send; `schedule` attempts the inline fast path,
+     * so an idle downstream cown runs right here without a queue round
+     * trip.
+     */
+    class PipelineStep : public Behaviour
+    {
+      friend class Cown;
+      friend class MultiMessage;
+
+      Pipeline* chain;
+
+      PipelineStep(Pipeline* chain_) : Behaviour(desc()), chain(chain_) {}
+
+      static void step_f(Behaviour* be)
+      {
+        auto* chain = ((PipelineStep*)be)->chain;
+        auto* alloc = ThreadAlloc::get();
+        auto& stage = chain->stage(chain->index);
+
+        stage.behaviour->f();
+
+        // Stages must not yield: the chain cannot re-deliver them.
+        assert(!Behaviour::yield_requested(stage.behaviour));
+        alloc->dealloc(stage.behaviour, stage.behaviour->size());
+
+        auto next = ++chain->index;
+        if (next == chain->count)
+        {
+          alloc->dealloc(chain, Pipeline::size(chain->count));
+          return;
+        }
+
+        Systematic::cout()
+          << "Pipeline advance to cown " << chain->stage(next).cown
+          << std::endl;
+
+        // The chain holds a reference on each stage cown, acquired in
+        // schedule_pipeline; each send consumes one.
+        Cown::schedule<PipelineStep, YesTransfer>(
+          1, &chain->stage(next).cown, chain);
+      }
+
+      static void step_trace(const Behaviour* be, ObjectStack& st)
+      {
+        // The stages still to run are only reachable through the chain:
+        // surface their cowns and captured state to the scanner.
+        auto* chain = ((const PipelineStep*)be)->chain;
+        for (size_t i = chain->index; i < chain->count; i++)
+        {
+          auto& stage = chain->stage(i);
+          st.push(stage.cown);
+          stage.behaviour->trace(st);
+        }
+      }
+
+      static const Descriptor* desc()
+      {
+        static constexpr Descriptor desc = {
+          sizeof(PipelineStep), step_f, step_trace};
+        return &desc;
+      }
+    };
+
   public:
+    /**
+     * Schedule a statically declared chain of single-cown stages (see
+     * Pipeline). Acquires a reference on every stage cown up front, then
+     * sends stage 0; each completed stage forwards the chain, running
+     * the next stage inline when its cown is idle. Consumes the chain.
+     */
+    static void schedule_pipeline(Pipeline* chain)
+    {
+      assert(chain->count > 0);
+
+      for (size_t i = 0; i < chain->count; i++)
+      {
+        check_same_runtime(chain->stage(i).cown);
+        Cown::acquire(chain->stage(i).cown);
+      }
+
+      Cown::schedule<PipelineStep, YesTransfer>(
+        1, &chain->stage(0).cown, chain);
+    }
+
+    /// Fire an expired timer: send its behaviour to its cown and drop the
+    /// reference held while the timer was armed.
+    static void fire_timer(Alloc* alloc, Cown* cown, Behaviour* be)
+    {
+      Systematic::cout() << "Timer fired on cown " << cown << std::endl;
+      schedule_prepared(alloc, cown, be);
+      Cown::release(alloc, cown);
+    }
+
+    /// Discard an unfired timer at thread teardown.
+    static void drop_timer(Alloc* alloc, Cown* cown, Behaviour* be)
+    {
+      alloc->dealloc(be, be->size());
+      Cown::release(alloc, cown);
+    }
+
+    /// Deliver an IO completion: send its behaviour to its cown and drop
+    /// the reference and event source held while the registration was
+    /// outstanding.
+    static void fire_io(Alloc* alloc, void* cown, Behaviour* be)
+    {
+      auto* c = (Cown*)cown;
+      Systematic::cout() << "IO ready on cown " << c << std::endl;
+      schedule_prepared(alloc, c, be);
+      Cown::release(alloc, c);
+      Scheduler::remove_external_event_source();
+    }
+
+    /// Discard an undelivered IO registration at pool teardown.
+    static void drop_io(Alloc* alloc, void* cown, Behaviour* be)
+    {
+      alloc->dealloc(be, be->size());
+      Cown::release(alloc, (Cown*)cown);
+      Scheduler::remove_external_event_source();
+    }
+
+    /**
+     * Schedule a behaviour on a cown once `delay_tsc` TSC cycles have
+     * passed. Must be called from a scheduler thread; the timer is armed
+     * on the calling thread's wheel. From outside the runtime the
+     * behaviour is scheduled immediately.
+     */
+    template<class Be, typename... Args>
+    static void schedule_after(uint64_t delay_tsc, Cown* cown, Args&&... args)
+    {
+      static_assert(std::is_base_of_v<Behaviour, Be>);
+      auto* sched = Scheduler::local();
+      auto* alloc = (sched == nullptr) ? ThreadAlloc::get() : sched->alloc;
+      auto* be =
+        new ((Be*)alloc->alloc<sizeof(Be)>()) Be(std::forward<Args>(args)...);
+
+      if (sched == nullptr)
+      {
+        schedule_prepared(alloc, cown, be);
+        return;
+      }
+
+      // Hold a reference to the cown while the timer is outstanding.
+      Cown::acquire(cown);
+      sched->timers.insert(alloc, Systematic::tick() + delay_tsc, cown, be);
+    }
+
+    /**
+     * Schedule a behaviour on a cown once `fd` is ready for `event`. The
+     * registration is one-shot: re-arm from the scheduled behaviour to
+     * keep listening. While it is outstanding it holds a reference to the
+     * cown and counts as an external event source, so the runtime stays
+     * alive until readiness is delivered. Returns false (retaining
+     * nothing) if the descriptor could not be registered, e.g. when a
+     * registration for it is already outstanding.
+     */
+    template<class Be, typename... Args>
+    static bool
+    schedule_on_ready(int fd, IOPoller::Event event, Cown* cown, Args&&... args)
+    {
+      static_assert(std::is_base_of_v<Behaviour, Be>);
+      auto* alloc = ThreadAlloc::get();
+      auto* be =
+        new ((Be*)alloc->alloc<sizeof(Be)>()) Be(std::forward<Args>(args)...);
+
+      Cown::acquire(cown);
+      Scheduler::add_external_event_source();
+
+      if (!Scheduler::io_poller().register_fd(
+            alloc, fd, event, cown, be, &fire_io, &drop_io))
+      {
+        Scheduler::remove_external_event_source();
+        Cown::release(alloc, cown);
+        alloc->dealloc(be, be->size());
+        return false;
+      }
+
+      return true;
+    }
+
+    /**
+     * Abort if the cown is owned by a scheduler thread of another runtime
+     * instance (see ThreadPool::set_current). Cowns not yet bound to a
+     * thread adopt the instance that first runs them, so this is a single
+     * load and compare per cown on the send path.
+     */
+    static void check_same_runtime(Cown* cown)
+    {
+      auto* owner = cown->owning_thread();
+      if ((owner == nullptr) || (owner->pool == &Scheduler::get()))
+        return;
+
+      Systematic::cout() << "Rejected cross-runtime send to cown " << cown
+                         << std::endl;
+      abort();
+    }
+
     template<
       class Behaviour,
       TransferOwnership transfer = NoTransfer,
@@ -730,6 +1818,22 @@ namespace verona::rt
         1, &cown, std::forward<Args>(args)...);
     }
 
+    /**
+     * Schedule a behaviour that only reads its cown. Read-only behaviours
+     * on the same cown run concurrently with each other, on as many
+     * scheduler threads as pick them up; an exclusive behaviour behind
+     * them waits until every reader has finished (see the read path in
+     * `run`). The behaviour must not mutate state owned by the cown.
+     **/
+    template<
+      class Be,
+      TransferOwnership transfer = NoTransfer,
+      typename... Args>
+    static void schedule_read(Cown* cown, Args&&... args)
+    {
+      schedule<Be, transfer, true>(1, &cown, std::forward<Args>(args)...);
+    }
+
     /**
      * Sends a multi-message to the first cown we want to acquire.
      *
@@ -740,6 +1844,7 @@ namespace verona::rt
     template<
       class Be,
       TransferOwnership transfer = NoTransfer,
+      bool read = false,
       typename... Args>
     static void schedule(size_t count, Cown** cowns, Args&&... args)
     {
@@ -747,11 +1852,60 @@ namespace verona::rt
       Systematic::cout() << "Schedule behaviour of type: " << typeid(Be).name()
                          << std::endl;
 
-      auto* alloc = ThreadAlloc::get();
-      auto* be =
-        new ((Be*)alloc->alloc<sizeof(Be)>()) Be(std::forward<Args>(args)...);
-      auto** sort = (Cown**)alloc->alloc(count * sizeof(Cown*));
-      memcpy(sort, cowns, count * sizeof(Cown*));
+      // One TLS read covers both the scheduler context and, on a
+      // scheduler thread, its cached allocator.
+      auto* sched = Scheduler::local();
+      auto* alloc = (sched == nullptr) ? ThreadAlloc::get() : sched->alloc;
+
+      // Small behaviours are co-allocated with the body and the cown array
+      // in one block, so dispatch reads a single cache line; closures with
+      // a large capture keep their own allocation, but still share the
+      // block between the body and the cown array.
+      MultiMessage::MultiMessageBody* body;
+      if constexpr (
+        (sizeof(Be) <= MAX_COMBINED_CAPTURE) &&
+        (alignof(Be) <= Object::ALIGNMENT))
+      {
+        body = MultiMessage::make_body_combined<Be>(
+          alloc, count, std::forward<Args>(args)...);
+      }
+      else
+      {
+        // The capture is too large to join the block, but the cown array
+        // still shares the body allocation.
+        auto* be = new ((Be*)alloc->alloc<sizeof(Be)>())
+          Be(std::forward<Args>(args)...);
+        body = MultiMessage::make_body_inline(alloc, count, be);
+      }
+
+      if constexpr (read)
+      {
+        assert(count == 1);
+        body->read = true;
+      }
+
+      memcpy(body->cowns, cowns, count * sizeof(Cown*));
+
+      // A cown owned by another runtime instance must not be acquired
+      // here: the behaviour would migrate work onto that instance's
+      // cores. Reject the send instead.
+      for (size_t i = 0; i < count; i++)
+        check_same_runtime(cowns[i]);
+
+      // Single-cown behaviours skip the multi-acquire protocol and may run
+      // inline when the target is idle.
+      if (
+        (count == 1) && (sched != nullptr) &&
+        (sched->inline_depth < MAX_INLINE_DEPTH) &&
+        !sched->should_steal_for_fairness &&
+        !cowns[0]->bp_state.load(std::memory_order_acquire).high_priority() &&
+        !cowns[0]->overloaded())
+      {
+        schedule_inline<transfer>(alloc, sched, body);
+        return;
+      }
+
+      auto** sort = body->cowns;
 
 #ifdef USE_SYSTEMATIC_TESTING
       std::sort(&sort[0], &sort[count], [](Cown*& a, Cown*& b) {
@@ -767,13 +1921,10 @@ namespace verona::rt
           Cown::acquire(sort[i]);
       }
 
-      auto body = MultiMessage::make_body(alloc, count, sort, be);
-
       // TODO what if this thread is external.
       //  EPOCH_A okay as currently only sending externally, before we start
       //  and thus its okay.
       //  Need to use another value when we add pinned cowns.
-      auto sched = Scheduler::local();
       auto epoch = sched == nullptr ? EpochMark::EPOCH_A : Scheduler::epoch();
 
       if (epoch == EpochMark::EPOCH_NONE)
@@ -786,7 +1937,119 @@ namespace verona::rt
 
       // Try to acquire as many cowns as possible without rescheduling,
       // starting from the beginning.
-      fast_send(body, epoch);
+      fast_send(alloc, body, epoch);
+    }
+
+    /**
+     * Run `f` on `cown` synchronously, as if it were the body of a
+     * single-cown behaviour, without allocating a message or a closure.
+     *
+     * Ownership of an idle cown is taken by waking its sleeping queue,
+     * which stands in for winning a fast send: only one thread can
+     * observe the SLEEPING to NONE transition. On success `f` runs with
+     * the cown acquired and the thread's running-behaviour context set
+     * up as `run_step` would; afterwards the cown is put back to sleep,
+     * or rescheduled if messages arrived while `f` ran.
+     *
+     * Returns false, leaving the cown untouched, when the calling thread
+     * is not a scheduler thread, the fast-path conditions of
+     * `schedule_inline` do not hold, or the cown is not idle. The caller
+     * must then fall back to a normal schedule. The caller's references
+     * to the cown are neither consumed nor required: the acquisition
+     * below keeps the cown alive for the duration of the run.
+     *
+     * A `mutor` set while `f` runs is discarded rather than applied: the
+     * unmute protocol reuses the message's sender array as its payload,
+     * and this path has none.
+     */
+    template<typename F>
+    static bool try_run_direct(Cown* cown, F&& f)
+    {
+      auto* sched = Scheduler::local();
+      if (
+        (sched == nullptr) || (sched->inline_depth >= MAX_INLINE_DEPTH) ||
+        sched->should_steal_for_fairness || Scheduler::should_scan() ||
+        Scheduler::in_prescan())
+        return false;
+
+      // Overloaded and high-priority targets need the full backpressure
+      // handling of a message send; a pinned cown must run on its home
+      // thread.
+      if (
+        cown->bp_state.load(std::memory_order_acquire).high_priority() ||
+        cown->overloaded() ||
+        (cown->is_pinned() && (cown->owning_thread() != sched)))
+        return false;
+
+      // Readers may still be inside the cown while its queue sleeps (see
+      // schedule_read); `f` would run against them without the parking
+      // protocol in `run`. New readers are only admitted by a thread
+      // running the cown, so the check cannot race with an increment.
+      if (cown->readers.load(std::memory_order_acquire) != 0)
+        return false;
+
+      // Check the state first: `wake` on a non-sleeping queue leaves a
+      // DELAY mark that would cost the running cown a spurious
+      // reschedule before it can sleep again.
+      if (!cown->queue.is_sleeping() || !cown->queue.wake())
+        return false;
+
+      yield(); // Winning the SLEEPING -> NONE transition is a global event.
+
+      Systematic::cout() << "Direct run on cown " << cown << std::endl;
+
+      auto* alloc = sched->alloc;
+      Cown::acquire(cown);
+
+      // We own the previously idle cown. Bind it to this thread if it is
+      // unbound, as the scheduler's prerun would.
+      if (cown->owning_thread() == nullptr)
+      {
+        cown->set_owning_thread(sched);
+        cown->next = sched->list;
+        sched->list = cown;
+        sched->total_cowns++;
+      }
+
+      // Stand-in body, so backpressure scans triggered by sends from
+      // within `f` see this cown as the sender set. It never enters a
+      // queue and holds no behaviour.
+      MultiMessage::MultiMessageBody body{0, 1, &cown, nullptr, 0};
+
+      auto* saved_body = sched->message_body;
+      auto* saved_mutor = sched->mutor;
+      sched->message_body = &body;
+      sched->mutor = nullptr;
+      sched->inline_depth++;
+
+      cown->set_blocker(nullptr);
+
+      f();
+
+      sched->stats.direct_run();
+
+      // Hand ownership of the queue back: sleep again if nothing arrived
+      // while `f` ran, otherwise reschedule to run the new messages.
+      cown->backpressure_transition(Priority::Normal, true);
+      bool notify = false;
+      if (cown->queue.mark_sleeping(notify))
+      {
+        Systematic::cout() << "Direct run: unschedule cown " << cown
+                           << std::endl;
+        Cown::release(alloc, cown);
+      }
+      else
+      {
+        if (notify)
+          cown->cown_notified();
+        sched->schedule_fifo(cown);
+      }
+
+      sched->inline_depth--;
+      sched->message_body = saved_body;
+      sched->mutor = saved_mutor;
+
+      return true;
     }
 
     /// Transition a cown between backpressure states. Return the previous
@@ -823,6 +2086,17 @@ namespace verona::rt
                          << " -> " << state << std::endl;
       yield();
 
+      {
+        auto* sched = Scheduler::local();
+        if (sched != nullptr)
+        {
+          if (state == Priority::Low)
+            sched->stats.mute();
+          else if (prev == Priority::Low)
+            sched->stats.unmute_bp();
+        }
+      }
+
       if (prev == Priority::Low)
       {
         auto sleeping = queue.wake();
@@ -911,11 +2185,16 @@ namespace verona::rt
     /// length of this cown's message queue.
     inline bool overloaded() const
     {
-      static constexpr size_t overload_rc = 800;
       const auto rc = get_header().rc.load(std::memory_order_relaxed);
       assert(rc != 0);
       yield();
-      return rc >= overload_rc;
+
+      if (rc >= bp_policy.overload_rc)
+        return true;
+
+      return (bp_policy.overload_bytes != 0) &&
+        (bytes_in_flight.load(std::memory_order_relaxed) >=
+         bp_policy.overload_bytes);
     }
 
     /// Update priority based on the occurrence of a token message, or replace
@@ -987,11 +2266,28 @@ namespace verona::rt
       return true;
     }
 
+    /// Free a senders array, or the combined block containing it. The
+    /// array of a combined allocation sits directly after the message body
+    /// at the start of the block (see MultiMessage::make_body_combined).
+    static inline void dealloc_senders(
+      Alloc* alloc, Cown** senders, size_t count, size_t combined_size)
+    {
+      if (combined_size != 0)
+        alloc->dealloc((char*)senders - sizeof(MessageBody), combined_size);
+      else
+        alloc->dealloc(senders, count * sizeof(Cown*));
+    }
+
     /// Mute the senders participating in this message if a backpressure scan
     /// set the mutor during the behaviour. If false is returned, the caller
-    /// must reschedule the senders and deallocate the senders array.
+    /// must reschedule the senders and deallocate the senders array (or the
+    /// combined block of `combined_size` bytes containing it).
     inline bool apply_backpressure(
-      Alloc* alloc, EpochMark epoch, Cown** senders, size_t count)
+      Alloc* alloc,
+      EpochMark epoch,
+      Cown** senders,
+      size_t count,
+      size_t combined_size)
     {
       auto* mutor = Scheduler::local()->mutor;
       if (mutor == nullptr)
@@ -1052,7 +2348,7 @@ namespace verona::rt
 
       if (muting_count == 0)
       {
-        alloc->dealloc(senders, count * sizeof(Cown*));
+        dealloc_senders(alloc, senders, count, combined_size);
         Cown::release(alloc, mutor);
         return true;
       }
@@ -1060,6 +2356,17 @@ namespace verona::rt
       if (muting_count < count)
         senders[muting_count] = nullptr;
 
+      if (combined_size != 0)
+      {
+        // The unmute message frees its cown array on its own, so it cannot
+        // point into the combined block; move the muted set to a fresh
+        // array and free the block.
+        auto** arr = (Cown**)alloc->alloc(count * sizeof(Cown*));
+        memcpy(arr, senders, count * sizeof(Cown*));
+        dealloc_senders(alloc, senders, count, combined_size);
+        senders = arr;
+      }
+
       auto* msg = unmute_msg(alloc, count, senders, epoch);
       bool needs_scheduling = mutor->try_fast_send(msg);
       if (needs_scheduling)
@@ -1098,11 +2405,44 @@ namespace verona::rt
 
       MultiMessage* curr = nullptr;
       size_t batch_size = 0;
+
+      // An exclusive message parked while readers were running takes
+      // priority over the queue (see the read path below). Only a wake
+      // from the last reader can have scheduled a cown with a parked
+      // message, so its readers have drained.
+      MultiMessage::MultiMessageBody* parked_body = nullptr;
+      if (pending_writer.load(std::memory_order_relaxed) != nullptr)
+        parked_body =
+          pending_writer.exchange(nullptr, std::memory_order_acquire);
+
+      // Messages are dequeued as runs rather than one at a time, so the
+      // loop below iterates a detached batch with one acquire fence per
+      // run. If processing stops while the batch still holds messages, the
+      // remainder must be reattached to the queue.
+      decltype(queue)::Batch msgs;
+      auto requeue_remaining = [&]() {
+        if (!msgs.empty())
+          queue.requeue_front(curr);
+      };
+
       do
       {
         assert(!queue.is_sleeping());
 
-        curr = queue.dequeue(alloc, notify);
+        bool from_park = false;
+        if (parked_body != nullptr)
+        {
+          // The message's original stub was surrendered to the queue when
+          // it parked, so it gets a fresh one.
+          curr = MultiMessage::make_message(
+            alloc, parked_body, pending_writer_epoch);
+          parked_body = nullptr;
+          Scheduler::recv_inflight_message();
+          from_park = true;
+        }
+
+        if (!from_park && msgs.empty())
+          msgs = queue.dequeue_n(alloc, batch_limit - batch_size, notify);
 
         if (!notified_called && notify)
         {
@@ -1110,7 +2450,7 @@ namespace verona::rt
           cown_notified();
         }
 
-        if (curr == nullptr)
+        if (!from_park && msgs.empty())
         {
           if (Scheduler::should_scan())
           {
@@ -1163,14 +2503,85 @@ namespace verona::rt
           return false;
         }
 
-        assert(!queue.is_sleeping());
+        if (!from_park)
+        {
+          curr = msgs.pop(alloc);
+
+          assert(!queue.is_sleeping());
+          auto* body = curr->get_body();
+
+          if (check_token_message(alloc, body))
+          {
+            requeue_remaining();
+            return true;
+          }
+
+          if (check_unmute_message(alloc, body))
+          {
+            requeue_remaining();
+            return true;
+          }
+        }
+
         auto* body = curr->get_body();
 
-        if (check_token_message(alloc, body))
-          return true;
+        // Reader-shared execution (see schedule_read): a read-only
+        // message takes a reader slot and runs without exclusive
+        // ownership of the cown.
+        if (body->read)
+        {
+          assert(body->count == 1);
+          const EpochMark msg_epoch = curr->get_epoch();
+          readers.fetch_add(1, std::memory_order_acq_rel);
+          yield();
+          Systematic::cout() << "Read message " << curr << " on cown " << this
+                             << std::endl;
+
+          // Keep the cown alive across the read with a reference of our
+          // own, then hand it back to the scheduler before running the
+          // behaviour, so further messages — more readers included — can
+          // be picked up concurrently by other threads.
+          Cown::acquire(this);
+          requeue_remaining();
+          schedule();
+
+          run_read(alloc, body, msg_epoch);
+          return false;
+        }
 
-        if (check_unmute_message(alloc, body))
-          return true;
+        if (readers.load(std::memory_order_acquire) != 0)
+        {
+          // An exclusive message cannot start while readers are inside
+          // the cown. Park its body — the stub is surrendered to the
+          // queue below — and let the last reader out hand the cown back
+          // to the scheduler (see run_read). The in-flight count keeps
+          // the leak detector from completing a scan while the parked
+          // closure is outside every queue.
+          assert(pending_writer.load(std::memory_order_relaxed) == nullptr);
+          pending_writer_epoch = curr->get_epoch();
+          Scheduler::record_inflight_message();
+          pending_writer.store(body, std::memory_order_release);
+          yield();
+
+          auto prev =
+            readers.fetch_or(WRITER_WAITING, std::memory_order_acq_rel);
+          if ((prev & ~WRITER_WAITING) != 0)
+          {
+            Systematic::cout() << "Parked message " << curr << " on cown "
+                               << this << " behind readers" << std::endl;
+            requeue_remaining();
+            return false;
+          }
+
+          // The readers drained before the flag was raised, so no reader
+          // will deliver the wake; reclaim the message and run it here.
+          readers.fetch_and(~WRITER_WAITING, std::memory_order_acq_rel);
+          auto* reclaimed =
+            pending_writer.exchange(nullptr, std::memory_order_acquire);
+          assert(reclaimed == body);
+          UNUSED(reclaimed);
+          Scheduler::recv_inflight_message();
+        }
 
         batch_size++;
 
@@ -1179,24 +2590,90 @@ namespace verona::rt
 
         auto* senders = body->cowns;
         const size_t senders_count = body->count;
+        // Captured before run_step: a separately allocated body is freed
+        // there, while a combined block outlives it and is freed with the
+        // senders array below. The behaviour pointer is only compared
+        // against the yield slot, never dereferenced, after run_step.
+        const size_t combined_size = body->combined_size;
+        auto* behaviour = body->behaviour;
+
+        // Sample the execution cost of every Nth behaviour dispatch. The
+        // key is captured before run_step, which frees the behaviour; only
+        // steps that actually run the behaviour are timed, not multi-acquire
+        // forwarding steps.
+        auto* sched = Scheduler::local();
+        const bool sampled = (body->index == senders_count - 1) &&
+          (sched != nullptr) && sched->profiler.sample();
+        const void* sampled_fn = nullptr;
+        uint64_t sample_start = 0;
+        if (sampled)
+        {
+          sampled_fn = (const void*)body->behaviour->get_descriptor()->f;
+          sample_start = Systematic::tick();
+        }
 
         // A function that returns false indicates that the cown should not
         // be rescheduled, even if it has pending work. This also means the
         // cown's queue should not be marked as empty, even if it is.
-        if (!run_step(curr))
+        if (!run_step(alloc, curr))
+        {
+          if (from_park)
+            MultiMessage::recycle(alloc, curr);
+          requeue_remaining();
           return false;
+        }
+
+        // The stub minted for a parked message never entered a queue, so
+        // nothing else recycles it.
+        if (from_park)
+          MultiMessage::recycle(alloc, curr);
 
-        if (apply_backpressure(alloc, epoch, senders, senders_count))
+        if (sampled)
+          sched->profiler.record(
+            get_descriptor(), sampled_fn, Systematic::tick() - sample_start);
+
+        const bool yielded = Behaviour::take_yield(behaviour);
+        if (yielded && (sched != nullptr) && (sched->mutor != nullptr))
+        {
+          // A mute request cannot be applied to a yielded behaviour: the
+          // unmute protocol would consume the senders array, which the
+          // continuation still owns. Drop it.
+          Cown::release(alloc, sched->mutor);
+          sched->mutor = nullptr;
+        }
+
+        if (apply_backpressure(
+              alloc, epoch, senders, senders_count, combined_size))
+        {
+          requeue_remaining();
           return false;
+        }
 
         // Reschedule the other cowns.
         for (size_t s = 0; s < (senders_count - 1); s++)
           senders[s]->schedule();
 
-        alloc->dealloc(senders, senders_count * sizeof(Cown*));
+        if (yielded)
+        {
+          // The behaviour yielded (see Behaviour::yield): restart the
+          // acquisition walk and re-send it with this same body, so its
+          // captured state survives in place. The continuation keeps the
+          // references the message held on its cowns, so none were
+          // released in run_step and none are acquired here.
+          body->index = 0;
+          auto resend_epoch = Scheduler::epoch();
+          if (resend_epoch == EpochMark::EPOCH_NONE)
+            Scheduler::record_inflight_message();
+          fast_send(alloc, body, resend_epoch);
+        }
+        else
+        {
+          dealloc_senders(alloc, senders, senders_count, combined_size);
+        }
 
       } while ((curr != until) && (batch_size < batch_limit));
 
+      requeue_remaining();
       return true;
     }
 
@@ -1334,7 +2811,7 @@ namespace verona::rt
       // All messages must have been run by the time the cown is collected.
       assert(stub->next.load(std::memory_order_relaxed) == nullptr);
 
-      alloc->dealloc<sizeof(MultiMessage)>(stub);
+      MultiMessage::recycle(alloc, stub);
     }
 
     /**
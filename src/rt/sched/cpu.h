@@ -229,6 +229,26 @@ namespace verona::rt
       return cpus->size();
     }
 
+    /// NUMA node of the CPU a given scheduler thread index is pinned to.
+    size_t numa_node(size_t index)
+    {
+      if ((cpus == nullptr) || (cpus->size() == 0))
+        abort();
+
+      index = index % cpus->size();
+      return cpus->at(index).numa_node;
+    }
+
+    /// Package of the CPU a given scheduler thread index is pinned to.
+    size_t package(size_t index)
+    {
+      if ((cpus == nullptr) || (cpus->size() == 0))
+        abort();
+
+      index = index % cpus->size();
+      return cpus->at(index).package;
+    }
+
   private:
 #ifdef _WIN32
     PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX
@@ -0,0 +1,140 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <iostream>
+#include <snmalloc.h>
+
+namespace verona::rt
+{
+  /**
+   * Always-on flight recorder for scheduler events.
+   *
+   * Each scheduler thread owns one ring of fixed-size packed events,
+   * written with plain stores from the owning thread only, so recording
+   * costs a couple of stores and no synchronisation. This complements the
+   * string-based Systematic logging, which is far too expensive to leave
+   * enabled in production.
+   *
+   * The ring can be dumped in raw binary form (`dump`) for offline
+   * processing, or pretty-printed (`print`) for quick inspection; both are
+   * intended to be called when the thread is stopped or from a crash
+   * handler, where a torn in-flight event is acceptable.
+   */
+  class SchedulerEventRing
+  {
+  public:
+    enum class Kind : uint32_t
+    {
+      None = 0,
+      Schedule,
+      ScheduleLifo,
+      Steal,
+      Mute,
+      Unmute,
+      Park,
+      Unpark,
+      BehaviourStart,
+      BehaviourEnd,
+      // Adaptive fairness decisions; the argument is the period chosen,
+      // in TSC ticks (see SchedulerThread::fairness_cycle).
+      FairSteal,
+      FairDefer,
+      FairForce,
+      // A behaviour allocated more than the configured alert threshold
+      // (see Cown::set_alloc_alert); the argument is the behaviour's
+      // body function pointer and `extra` holds the bytes allocated, in
+      // KiB, saturated.
+      AllocAlert,
+    };
+
+    struct Event
+    {
+      uint64_t tsc;
+      Kind kind;
+      uint32_t extra;
+      uintptr_t arg;
+    };
+
+  private:
+    static constexpr size_t SIZE = 1 << 12;
+    static constexpr size_t MASK = SIZE - 1;
+
+    Event events[SIZE] = {};
+    size_t index = 0;
+
+    static const char* name(Kind k)
+    {
+      switch (k)
+      {
+        case Kind::Schedule:
+          return "schedule";
+        case Kind::ScheduleLifo:
+          return "schedule-lifo";
+        case Kind::Steal:
+          return "steal";
+        case Kind::Mute:
+          return "mute";
+        case Kind::Unmute:
+          return "unmute";
+        case Kind::Park:
+          return "park";
+        case Kind::Unpark:
+          return "unpark";
+        case Kind::BehaviourStart:
+          return "behaviour-start";
+        case Kind::BehaviourEnd:
+          return "behaviour-end";
+        case Kind::FairSteal:
+          return "fair-steal";
+        case Kind::FairDefer:
+          return "fair-defer";
+        case Kind::FairForce:
+          return "fair-force";
+        case Kind::AllocAlert:
+          return "alloc-alert";
+        default:
+          return "none";
+      }
+    }
+
+  public:
+    void record(Kind kind, const void* arg = nullptr, uint32_t extra = 0)
+    {
+      auto& e = events[index & MASK];
+      e.tsc = snmalloc::Aal::tick();
+      e.kind = kind;
+      e.extra = extra;
+      e.arg = (uintptr_t)arg;
+      index++;
+    }
+
+    /// Write the ring to a stream as raw binary, oldest event first.
+    void dump(std::ostream& o)
+    {
+      auto start = (index >= SIZE) ? index - SIZE : 0;
+
+      for (auto i = start; i < index; i++)
+      {
+        auto& e = events[i & MASK];
+        o.write((const char*)&e, sizeof(Event));
+      }
+    }
+
+    /// Pretty-print the ring, oldest event first.
+    void print(std::ostream& o, size_t thread_id)
+    {
+      auto start = (index >= SIZE) ? index - SIZE : 0;
+
+      for (auto i = start; i < index; i++)
+      {
+        auto& e = events[i & MASK];
+        o << thread_id << " " << e.tsc << " " << name(e.kind) << " "
+          << (void*)e.arg;
+        if (e.extra != 0)
+          o << " " << e.extra;
+        o << std::endl;
+      }
+    }
+  };
+} // namespace verona::rt
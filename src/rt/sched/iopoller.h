@@ -0,0 +1,404 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <snmalloc.h>
+
+#if defined(__linux__)
+#  include <sys/epoll.h>
+#  include <sys/eventfd.h>
+#  include <unistd.h>
+#  define VERONA_IO_EPOLL
+#elif !defined(_WIN32)
+#  include <poll.h>
+#  include <unistd.h>
+#  define VERONA_IO_POLL
+#endif
+
+namespace verona::rt
+{
+  using namespace snmalloc;
+
+  class Behaviour;
+
+  /**
+   * Readiness reactor connecting file descriptors to cowns.
+   *
+   * The scheduler thread pool owns one reactor. A registration pairs a file
+   * descriptor with a pre-constructed behaviour; when the descriptor becomes
+   * ready the behaviour is sent to its cown through the normal message path,
+   * so completions are serialised with everything else the cown does, and
+   * submission from a behaviour is an ordinary call that never leaves the
+   * scheduler thread. Registrations are one-shot and at most one may be
+   * outstanding per descriptor: re-arm from the fired behaviour to keep
+   * listening.
+   *
+   * Scheduler threads drain the reactor non-blockingly from their work
+   * loops, alongside the timer wheel. When the whole runtime pauses with
+   * registrations outstanding, the last thread blocks on the reactor
+   * instead of the condition variable, so a quiescent runtime wakes
+   * directly on readiness; `wake` unblocks it for cv-style wakeups.
+   *
+   * The reactor knows nothing of cowns: registrations carry fire/drop
+   * callbacks, bound by `Cown::schedule_on_ready` to the message-send path.
+   * The backend is epoll on Linux and poll(2) on other POSIX systems; the
+   * registration/completion interface is backend-neutral, so an io_uring
+   * submission backend can slot in without changing callers. On Windows
+   * registration aborts: there is no reactor backend yet.
+   */
+  class IOPoller
+  {
+  public:
+    enum class Event
+    {
+      Read,
+      Write
+    };
+
+    /// Completion callbacks. `fire` delivers the behaviour to the cown;
+    /// `drop` discards an undelivered registration at teardown.
+    using Callback = void (*)(Alloc* alloc, void* cown, Behaviour* be);
+
+  private:
+    struct Entry
+    {
+      Entry* next;
+      int fd;
+      Event event;
+      void* cown;
+      Behaviour* be;
+      Callback fire;
+      Callback drop;
+    };
+
+    static constexpr size_t MAX_READY = 16;
+
+    /// All outstanding registrations, guarded by `list_lock`.
+    Entry* list = nullptr;
+    std::atomic_flag list_lock = ATOMIC_FLAG_INIT;
+    /// Serialises harvesting, so concurrent pollers do not contend on the
+    /// backend; registration does not take it.
+    std::atomic_flag poll_lock = ATOMIC_FLAG_INIT;
+    std::atomic<size_t> outstanding{0};
+    /// Set while a thread is blocked in `wait`; makes `wake` cheap when
+    /// nobody is.
+    std::atomic<bool> sleeping{false};
+
+#if defined(VERONA_IO_EPOLL)
+    int epfd = -1;
+    int wakefd = -1;
+#elif defined(VERONA_IO_POLL)
+    int wake_pipe[2] = {-1, -1};
+#endif
+
+    void unlink(Entry* e)
+    {
+      FlagLock f(list_lock);
+      Entry** prev = &list;
+      while (*prev != e)
+        prev = &(*prev)->next;
+      *prev = e->next;
+    }
+
+#if defined(VERONA_IO_EPOLL)
+    void init()
+    {
+      if (epfd != -1)
+        return;
+
+      epfd = ::epoll_create1(0);
+      wakefd = ::eventfd(0, EFD_NONBLOCK);
+
+      // The wake event carries a null entry to tell it apart from
+      // registrations.
+      epoll_event ev{};
+      ev.events = EPOLLIN;
+      ev.data.ptr = nullptr;
+      ::epoll_ctl(epfd, EPOLL_CTL_ADD, wakefd, &ev);
+    }
+
+    bool arm(Entry* e)
+    {
+      epoll_event ev{};
+      ev.events =
+        ((e->event == Event::Read) ? EPOLLIN : EPOLLOUT) | EPOLLONESHOT;
+      ev.data.ptr = e;
+      return ::epoll_ctl(epfd, EPOLL_CTL_ADD, e->fd, &ev) == 0;
+    }
+
+    /// Collect ready registrations into `ready` and return how many; a
+    /// negative timeout blocks until readiness or `wake`.
+    size_t harvest(Entry** ready, int timeout_ms)
+    {
+      epoll_event evs[MAX_READY];
+      int n = ::epoll_wait(epfd, evs, MAX_READY, timeout_ms);
+
+      size_t found = 0;
+      for (int i = 0; i < n; i++)
+      {
+        auto* e = (Entry*)evs[i].data.ptr;
+        if (e == nullptr)
+        {
+          uint64_t buf;
+          UNUSED(::read(wakefd, &buf, sizeof(buf)));
+          continue;
+        }
+
+        ::epoll_ctl(epfd, EPOLL_CTL_DEL, e->fd, nullptr);
+        ready[found++] = e;
+      }
+
+      return found;
+    }
+
+    void wake_backend()
+    {
+      uint64_t one = 1;
+      UNUSED(::write(wakefd, &one, sizeof(one)));
+    }
+
+    void close_backend()
+    {
+      if (epfd == -1)
+        return;
+
+      ::close(epfd);
+      ::close(wakefd);
+      epfd = -1;
+      wakefd = -1;
+    }
+#elif defined(VERONA_IO_POLL)
+    void init()
+    {
+      if (wake_pipe[0] != -1)
+        return;
+
+      UNUSED(::pipe(wake_pipe));
+    }
+
+    bool arm(Entry* e)
+    {
+      UNUSED(e);
+      // The fd set is rebuilt from the list on every harvest; make sure a
+      // blocked waiter picks the new registration up.
+      wake_backend();
+      return true;
+    }
+
+    size_t harvest(Entry** ready, int timeout_ms)
+    {
+      pollfd fds[MAX_READY];
+      Entry* entries[MAX_READY];
+      nfds_t n = 0;
+
+      fds[n].fd = wake_pipe[0];
+      fds[n].events = POLLIN;
+      entries[n++] = nullptr;
+
+      {
+        FlagLock f(list_lock);
+        for (Entry* e = list; (e != nullptr) && (n < MAX_READY); e = e->next)
+        {
+          fds[n].fd = e->fd;
+          fds[n].events = (e->event == Event::Read) ? POLLIN : POLLOUT;
+          entries[n++] = e;
+        }
+      }
+
+      if (::poll(fds, n, timeout_ms) <= 0)
+        return 0;
+
+      size_t found = 0;
+      for (nfds_t i = 0; i < n; i++)
+      {
+        if (fds[i].revents == 0)
+          continue;
+
+        if (entries[i] == nullptr)
+        {
+          char buf[8];
+          UNUSED(::read(wake_pipe[0], buf, sizeof(buf)));
+          continue;
+        }
+
+        ready[found++] = entries[i];
+      }
+
+      return found;
+    }
+
+    void wake_backend()
+    {
+      char one = 1;
+      UNUSED(::write(wake_pipe[1], &one, sizeof(one)));
+    }
+
+    void close_backend()
+    {
+      if (wake_pipe[0] == -1)
+        return;
+
+      ::close(wake_pipe[0]);
+      ::close(wake_pipe[1]);
+      wake_pipe[0] = -1;
+      wake_pipe[1] = -1;
+    }
+#else
+    void init() {}
+
+    bool arm(Entry* e)
+    {
+      UNUSED(e);
+      abort();
+    }
+
+    size_t harvest(Entry** ready, int timeout_ms)
+    {
+      UNUSED(ready);
+      UNUSED(timeout_ms);
+      return 0;
+    }
+
+    void wake_backend() {}
+
+    void close_backend() {}
+#endif
+
+    /// Unlink, fire and free the harvested registrations.
+    void deliver(Alloc* alloc, Entry** ready, size_t count)
+    {
+      for (size_t i = 0; i < count; i++)
+      {
+        auto* e = ready[i];
+        unlink(e);
+        outstanding.fetch_sub(1, std::memory_order_relaxed);
+        e->fire(alloc, e->cown, e->be);
+        alloc->dealloc<sizeof(Entry)>(e);
+      }
+    }
+
+  public:
+    /// Number of outstanding registrations.
+    size_t pending()
+    {
+      return outstanding.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Register interest in `fd`. When it is ready for `event`,
+     * `fire(alloc, cown, be)` runs on whichever scheduler thread harvests
+     * the completion. The
+     * caller is responsible for keeping the cown alive until then; on
+     * failure (e.g. a registration already outstanding for `fd`) nothing
+     * is retained and the caller unwinds.
+     */
+    bool register_fd(
+      Alloc* alloc,
+      int fd,
+      Event event,
+      void* cown,
+      Behaviour* be,
+      Callback fire,
+      Callback drop)
+    {
+      auto* e = (Entry*)alloc->alloc<sizeof(Entry)>();
+      e->fd = fd;
+      e->event = event;
+      e->cown = cown;
+      e->be = be;
+      e->fire = fire;
+      e->drop = drop;
+
+      {
+        FlagLock f(list_lock);
+        init();
+        e->next = list;
+        list = e;
+      }
+
+      outstanding.fetch_add(1, std::memory_order_relaxed);
+
+      if (!arm(e))
+      {
+        unlink(e);
+        outstanding.fetch_sub(1, std::memory_order_relaxed);
+        alloc->dealloc<sizeof(Entry)>(e);
+        return false;
+      }
+
+      return true;
+    }
+
+    /// Deliver any completions that are already ready, without blocking.
+    /// Returns true if a behaviour was scheduled.
+    bool poll(Alloc* alloc)
+    {
+      if (pending() == 0)
+        return false;
+
+      if (poll_lock.test_and_set(std::memory_order_acquire))
+        return false;
+
+      Entry* ready[MAX_READY];
+      size_t count = harvest(ready, 0);
+      poll_lock.clear(std::memory_order_release);
+
+      deliver(alloc, ready, count);
+      return count != 0;
+    }
+
+    /**
+     * Block until a registration completes or `wake` is called, and deliver
+     * what is ready. Only called by the last thread to pause, so it never
+     * contends with `poll`.
+     */
+    void wait(Alloc* alloc)
+    {
+      if (pending() == 0)
+        return;
+
+      FlagLock f(poll_lock);
+      sleeping.store(true, std::memory_order_seq_cst);
+
+      Entry* ready[MAX_READY];
+      size_t count = harvest(ready, -1);
+
+      sleeping.store(false, std::memory_order_relaxed);
+      deliver(alloc, ready, count);
+    }
+
+    /// Unblock a thread sitting in `wait`. Safe from any thread.
+    void wake()
+    {
+      if (sleeping.load(std::memory_order_seq_cst))
+        wake_backend();
+    }
+
+    /**
+     * Drop all outstanding registrations without firing them and release
+     * the backend, so the next `init`/`run` cycle starts clean. Called at
+     * pool teardown, after the scheduler threads have stopped.
+     */
+    void close(Alloc* alloc)
+    {
+      Entry* e;
+      {
+        FlagLock f(list_lock);
+        e = list;
+        list = nullptr;
+      }
+
+      while (e != nullptr)
+      {
+        auto* next = e->next;
+        e->drop(alloc, e->cown, e->be);
+        outstanding.fetch_sub(1, std::memory_order_relaxed);
+        alloc->dealloc<sizeof(Entry)>(e);
+        e = next;
+      }
+
+      assert(pending() == 0);
+      close_backend();
+    }
+  };
+} // namespace verona::rt
@@ -20,15 +20,55 @@ namespace verona::rt
       size_t count;
       Cown** cowns;
       Behaviour* behaviour;
+      /// Total size of the block when the body and the cown array (and,
+      /// for `make_body_combined`, the behaviour too) were co-allocated;
+      /// zero when they are separate allocations. A combined block is
+      /// freed in one piece, after the senders have been rescheduled (see
+      /// Cown::run).
+      size_t combined_size;
+      /// The behaviour only reads its cown: it may run concurrently with
+      /// other read-only behaviours on the same cown, and only single-cown
+      /// messages may carry it (see Cown::schedule_read).
+      bool read = false;
     };
 
+    /**
+     * Per-thread recycling pool for message stubs. Messaging allocates a
+     * MultiMessage per send, making it the top allocator consumer on
+     * message-heavy workloads; recycled messages keep steady-state sends
+     * free of allocator calls. Reuse requires no epoch protection: a
+     * message is only recycled by the single consumer of an MPSCQ, after
+     * its successor has been linked, at which point no other thread holds
+     * a reference to it.
+     */
+    struct Pool
+    {
+      /// Freelist, linked through the message `next` field.
+      MultiMessage* head = nullptr;
+      size_t size = 0;
+      size_t hits = 0;
+      size_t misses = 0;
+
+      /// Bound on pooled messages per thread; overflow goes back to the
+      /// allocator.
+      static constexpr size_t MAX_SIZE = 256;
+    };
+
+    static Pool& pool()
+    {
+      static thread_local Pool p;
+      return p;
+    }
+
   private:
     MultiMessageBody* body;
-    friend verona::rt::MPSCQ<MultiMessage>;
-    friend class Cown;
-
     std::atomic<MultiMessage*> next{nullptr};
 
+    // `next` must be declared before the friend, which names it to form
+    // the queue's link member pointer.
+    friend verona::rt::MPSCQ<MultiMessage, &MultiMessage::next>;
+    friend class Cown;
+
     inline MultiMessageBody* get_body()
     {
       return (MultiMessageBody*)((uintptr_t)body & ~Object::MARK_MASK);
@@ -37,12 +77,60 @@ namespace verona::rt
     static MultiMessage*
     make(Alloc* alloc, EpochMark epoch, MultiMessageBody* body)
     {
-      auto msg = (MultiMessage*)alloc->alloc<sizeof(MultiMessage)>();
+      MultiMessage* msg;
+      auto& p = pool();
+
+      if (p.head != nullptr)
+      {
+        msg = p.head;
+        p.head = msg->next.load(std::memory_order_relaxed);
+        p.size--;
+        p.hits++;
+        msg->next.store(nullptr, std::memory_order_relaxed);
+      }
+      else
+      {
+        msg = (MultiMessage*)alloc->alloc<sizeof(MultiMessage)>();
+        p.misses++;
+      }
+
       msg->body = body;
       msg->set_epoch(epoch);
       return msg;
     }
 
+    /**
+     * Return a message to the recycling pool, or to the allocator when the
+     * pool is full.
+     */
+    static void recycle(Alloc* alloc, MultiMessage* msg)
+    {
+      auto& p = pool();
+
+      if (p.size >= Pool::MAX_SIZE)
+      {
+        alloc->dealloc<sizeof(MultiMessage)>(msg);
+        return;
+      }
+
+      msg->next.store(p.head, std::memory_order_relaxed);
+      p.head = msg;
+      p.size++;
+    }
+
+  public:
+    /// Occupancy statistics for this thread's message pool.
+    static void
+    pool_stats(size_t& size, size_t& hits, size_t& misses)
+    {
+      auto& p = pool();
+      size = p.size;
+      hits = p.hits;
+      misses = p.misses;
+    }
+
+  private:
+
     inline bool in_epoch(EpochMark e)
     {
       return get_epoch() == e;
@@ -71,7 +159,54 @@ namespace verona::rt
     make_body(Alloc* alloc, size_t count, Cown** cowns, Behaviour* behaviour)
     {
       return new (alloc->alloc<sizeof(MultiMessageBody)>())
-        MultiMessageBody{0, count, cowns, behaviour};
+        MultiMessageBody{0, count, cowns, behaviour, 0};
+    }
+
+    /**
+     * Co-allocate the body and the cown array in one block, for
+     * behaviours too large to join the block themselves (see
+     * make_body_combined). The cown array is left uninitialised for the
+     * caller to fill; the behaviour is freed on its own when the message
+     * completes.
+     */
+    static MultiMessageBody*
+    make_body_inline(Alloc* alloc, size_t count, Behaviour* behaviour)
+    {
+      const size_t total = sizeof(MultiMessageBody) + (count * sizeof(Cown*));
+      auto* block = (char*)alloc->alloc(total);
+      auto** cowns = (Cown**)(block + sizeof(MultiMessageBody));
+      return new (block) MultiMessageBody{0, count, cowns, behaviour, total};
+    }
+
+    /// True when `body->behaviour` lives inside the combined block that
+    /// starts at `body` (see make_body_combined); false for separate
+    /// allocations and for bodies made by make_body_inline, whose block
+    /// holds only the body and the cown array.
+    static bool behaviour_combined(MultiMessageBody* body)
+    {
+      auto* p = (char*)body->behaviour;
+      return (p >= (char*)body) && (p < ((char*)body + body->combined_size));
+    }
+
+    /**
+     * Co-allocate the body, the cown array and the behaviour in a single
+     * block, so a small behaviour dispatches from one cache line rather
+     * than three. The behaviour is constructed in place from `args`; the
+     * cown array is left uninitialised for the caller to fill.
+     */
+    template<class Be, typename... Args>
+    static MultiMessageBody*
+    make_body_combined(Alloc* alloc, size_t count, Args&&... args)
+    {
+      static_assert(alignof(Be) <= Object::ALIGNMENT);
+      const size_t be_offset = snmalloc::bits::align_up(
+        sizeof(MultiMessageBody) + (count * sizeof(Cown*)), alignof(Be));
+      const size_t total = be_offset + sizeof(Be);
+
+      auto* block = (char*)alloc->alloc(total);
+      auto** cowns = (Cown**)(block + sizeof(MultiMessageBody));
+      auto* be = new (block + be_offset) Be(std::forward<Args>(args)...);
+      return new (block) MultiMessageBody{0, count, cowns, be, total};
     }
 
     static MultiMessage*
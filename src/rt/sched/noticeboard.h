@@ -63,15 +63,71 @@ namespace verona::rt
                            << std::endl;
         e.dec_in_epoch(local_content);
         put(new_o);
+        bump_version();
       }
       else
       {
         UNUSED(alloc);
         put(new_o);
+        bump_version();
       }
 #endif
     }
 
+    /**
+     * Snapshot a batch of noticeboards with a single epoch enter/exit,
+     * rather than paying the epoch machinery per `peek`.
+     *
+     * For board i, if its version still matches `versions[i]` the copy is
+     * skipped and `out[i]` is left untouched; otherwise the current value
+     * is copied into `out[i]` (increfed for non-fundamental content, as
+     * with `peek`) and `versions[i]` is refreshed. Initialise versions to
+     * a value never returned by `get_version` (e.g. ~0) to force the
+     * first copy. Returns the number of boards refreshed.
+     */
+    static size_t peek_batch(
+      Alloc* alloc,
+      Noticeboard<T>** boards,
+      size_t count,
+      T* out,
+      uint64_t* versions)
+    {
+      size_t refreshed = 0;
+      ObjectStack f(alloc);
+
+      {
+        Epoch e(alloc);
+
+        for (size_t i = 0; i < count; i++)
+        {
+          auto v = boards[i]->get_version();
+          if (v == versions[i])
+            continue;
+
+          out[i] = boards[i]->template get<T>();
+          if constexpr (!std::is_fundamental_v<T>)
+          {
+            out[i]->incref();
+            // As in `peek`, a refreshed value amounts to receiving a
+            // message, so it must be scanned during the LD protocol.
+            if (Scheduler::should_scan())
+              out[i]->trace(f);
+          }
+
+          versions[i] = v;
+          refreshed++;
+        }
+      }
+
+      if constexpr (!std::is_fundamental_v<T>)
+      {
+        if (!f.empty())
+          Cown::scan_stack(alloc, Scheduler::epoch(), f);
+      }
+
+      return refreshed;
+    }
+
     T peek(Alloc* alloc)
     {
       if constexpr (std::is_fundamental_v<T>)
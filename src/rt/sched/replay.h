@@ -0,0 +1,257 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "test/systematic.h"
+
+#include <iostream>
+#include <vector>
+
+namespace verona::rt
+{
+  /**
+   * Record/replay of scheduler decisions.
+   *
+   * Systematic testing can explore interleavings from a seed, but
+   * reproducing a schedule observed in production means guessing seeds.
+   * In record mode each scheduler thread appends its nondeterministic
+   * decisions to an unbounded per-thread trace: the victim of every
+   * successful steal, each pop from the local queue, and each epoch
+   * advance. Traces are dumped after `run` (see
+   * `ThreadPool::dump_replay`) and loaded before a later run, where the
+   * steal choice points consult the trace instead of walking the victim
+   * ring: a thread about to steal jumps straight to the recorded victim
+   * and retries it until work appears, reproducing the recorded work
+   * placement at near-native speed.
+   *
+   * Only steals are driven; local pops and epoch advances are markers
+   * that keep the cursor aligned and are consumed tolerantly. If a
+   * thread's behaviour stops matching its trace — the workload is not
+   * fully deterministic under a fixed work placement — the thread logs
+   * the divergence once and falls back to live scheduling.
+   */
+  class SchedulerReplay
+  {
+  public:
+    enum class Mode
+    {
+      Off,
+      Record,
+      Replay,
+    };
+
+    enum class Kind : uint8_t
+    {
+      Steal,
+      LocalPop,
+      EpochAdvance,
+    };
+
+    struct Decision
+    {
+      Kind kind;
+      uint32_t value;
+    };
+
+  private:
+    std::vector<Decision> trace;
+    size_t cursor = 0;
+    bool diverged = false;
+
+    static Mode& mode()
+    {
+      static Mode m = Mode::Off;
+      return m;
+    }
+
+    /// Traces loaded by `load`, indexed by systematic thread id.
+    static std::vector<std::vector<Decision>>& loaded()
+    {
+      static std::vector<std::vector<Decision>> traces;
+      return traces;
+    }
+
+    void diverge(size_t value)
+    {
+      diverged = true;
+      Systematic::cout() << "Replay diverged at decision " << cursor
+                         << " (steal from " << value << ")" << std::endl;
+    }
+
+  public:
+    /// Start recording decisions; takes effect when threads next attach.
+    static void record()
+    {
+      mode() = Mode::Record;
+    }
+
+    static void off()
+    {
+      mode() = Mode::Off;
+    }
+
+    static bool recording()
+    {
+      return mode() == Mode::Record;
+    }
+
+    bool replaying() const
+    {
+      return (mode() == Mode::Replay) && !diverged;
+    }
+
+    /**
+     * Called by a scheduler thread when it starts running: clears any
+     * previous recording and, in replay mode, picks up the loaded trace
+     * for this thread id.
+     */
+    void attach(size_t thread_id)
+    {
+      trace.clear();
+      cursor = 0;
+      diverged = false;
+
+      if ((mode() == Mode::Replay) && (thread_id < loaded().size()))
+        trace = loaded()[thread_id];
+    }
+
+    /**
+     * In replay mode, the victim id of the next recorded steal, if the
+     * trace has one left. The entry is only consumed by `on_steal`, so
+     * the caller retries the same victim until the steal succeeds.
+     */
+    bool next_steal_victim(uint32_t& id)
+    {
+      if (!replaying())
+        return false;
+
+      for (size_t i = cursor; i < trace.size(); i++)
+      {
+        if (trace[i].kind == Kind::Steal)
+        {
+          id = trace[i].value;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /// A steal succeeded against the given victim.
+    void on_steal(size_t victim_id)
+    {
+      if (recording())
+      {
+        trace.push_back({Kind::Steal, (uint32_t)victim_id});
+        return;
+      }
+
+      if (!replaying())
+        return;
+
+      while ((cursor < trace.size()) && (trace[cursor].kind != Kind::Steal))
+        cursor++;
+
+      if (cursor == trace.size())
+      {
+        // The recorded schedule has been reproduced; any further
+        // decisions are live.
+        diverged = true;
+        Systematic::cout() << "Replay trace complete" << std::endl;
+        return;
+      }
+
+      if (trace[cursor].value != victim_id)
+      {
+        diverge(victim_id);
+        return;
+      }
+
+      cursor++;
+    }
+
+    /// A cown was popped from the local queue.
+    void on_local_pop()
+    {
+      if (recording())
+      {
+        trace.push_back({Kind::LocalPop, 0});
+        return;
+      }
+
+      if (!replaying())
+        return;
+
+      if ((cursor < trace.size()) && (trace[cursor].kind == Kind::LocalPop))
+        cursor++;
+    }
+
+    /// The thread advanced its send epoch to the given mark.
+    void on_epoch_advance(uint32_t mark)
+    {
+      if (recording())
+      {
+        trace.push_back({Kind::EpochAdvance, mark});
+        return;
+      }
+
+      if (!replaying())
+        return;
+
+      if (
+        (cursor < trace.size()) &&
+        (trace[cursor].kind == Kind::EpochAdvance))
+        cursor++;
+    }
+
+    /// Write this thread's trace as text, one decision per line.
+    void dump(std::ostream& o, size_t thread_id) const
+    {
+      for (auto& d : trace)
+      {
+        o << thread_id << " ";
+        switch (d.kind)
+        {
+          case Kind::Steal:
+            o << "S " << d.value;
+            break;
+          case Kind::LocalPop:
+            o << "L";
+            break;
+          case Kind::EpochAdvance:
+            o << "E " << d.value;
+            break;
+        }
+        o << std::endl;
+      }
+    }
+
+    /**
+     * Load traces in the `dump` format and enter replay mode; must be
+     * called before the threads start. Replaces any previously loaded
+     * traces.
+     */
+    static void load(std::istream& in)
+    {
+      loaded().clear();
+
+      size_t id;
+      char k;
+      while (in >> id >> k)
+      {
+        if (loaded().size() <= id)
+          loaded().resize(id + 1);
+
+        uint32_t value = 0;
+        if ((k == 'S') || (k == 'E'))
+          in >> value;
+
+        Kind kind = (k == 'S') ? Kind::Steal :
+          (k == 'E')           ? Kind::EpochAdvance :
+                                 Kind::LocalPop;
+        loaded()[id].push_back({kind, value});
+      }
+
+      mode() = Mode::Replay;
+    }
+  };
+} // namespace verona::rt
@@ -2,33 +2,90 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include "threadstate.h"
+
 #include <iostream>
 #include <snmalloc.h>
+#include <string>
 
 namespace verona::rt
 {
   using namespace snmalloc;
   class SchedulerStats
   {
+  public:
+    /// Shape of the wake-chain latency histogram; see `wake_latency`.
+    static constexpr size_t WAKE_HIST_BUCKETS = 16;
+    static constexpr size_t WAKE_HIST_SHIFT = 10;
+
+    /// Number of counters captured by `snapshot`: the scalar counters,
+    /// the per-LD-state TSC totals, and the wake-latency histogram.
+    static constexpr size_t SNAPSHOT_COUNTERS =
+      22 + (ThreadState::Finished + 1) + 2 + WAKE_HIST_BUCKETS;
+
   private:
 #ifdef USE_SCHED_STATS
     size_t steal_count = 0;
+    // Steals broken down by topological distance to the victim:
+    // 0 same package, 1 same NUMA node, 2 remote NUMA node.
+    size_t steal_tier_count[3] = {0, 0, 0};
+    // Steals that respected or broke a cown's thread affinity hint.
+    size_t steal_affinity_keep_count = 0;
+    size_t steal_affinity_break_count = 0;
     size_t pause_count = 0;
+    size_t mm_batch_count = 0;
+    size_t mm_batch_cowns = 0;
+    // TSC ticks spent in each stage of the adaptive idle policy.
+    uint64_t idle_spin_tsc = 0;
+    uint64_t idle_shallow_tsc = 0;
+    uint64_t idle_park_tsc = 0;
     std::atomic<size_t> unpause_count = 0;
     std::atomic<size_t> lifo_count = 0;
+    // Single-cown behaviours run inline without a queue round-trip.
+    size_t inline_run_count = 0;
+    // Behaviours run synchronously on an idle cown, without a message or
+    // closure allocation.
+    size_t direct_run_count = 0;
+    // Cowns proactively pushed to an idle sibling during a fan-out.
+    size_t share_count = 0;
+    // Backpressure mute/unmute transitions observed on this thread.
+    size_t mute_count = 0;
+    size_t unmute_count_bp = 0;
+    // Cown allocations served from / missed by the thread's shell pool.
+    size_t cown_pool_hit_count = 0;
+    size_t cown_pool_miss_count = 0;
+    // TSC ticks this thread spent in each LD protocol state, indexed by
+    // the state being left, and the number of transitions taken.
+    uint64_t ld_state_tsc[ThreadState::Finished + 1] = {};
+    size_t ld_transition_count = 0;
+    // Wake-chain latency: from the external schedule that woke an idle
+    // runtime to the first behaviour executed afterwards. Bucket b counts
+    // latencies below 2^(b + WAKE_HIST_SHIFT) ticks that did not fit an
+    // earlier bucket; the last bucket is open above.
+    size_t wake_latency_hist[WAKE_HIST_BUCKETS] = {};
+    size_t wake_count = 0;
+    uint64_t wake_latency_tsc = 0;
 #endif
 
   public:
+    /// Process-wide accumulator. Per-thread stats are folded into this
+    /// instance when their scheduler thread is destroyed, so benchmarks can
+    /// sample it between runs to compute deltas. Printed at process exit.
+    static SchedulerStats& global()
+    {
+      static SchedulerStats global_stats;
+      return global_stats;
+    }
+
     ~SchedulerStats()
 #ifdef USE_SCHED_STATS
     {
       static std::atomic_flag lock = ATOMIC_FLAG_INIT;
-      static SchedulerStats global;
 
-      if (this != &global)
+      if (this != &global())
       {
         FlagLock f(lock);
-        global.add(*this);
+        global().add(*this);
       }
       else
       {
@@ -39,6 +96,17 @@ namespace verona::rt
       = default;
 #endif
 
+    /// Total steals folded into this instance. Zero when stats are compiled
+    /// out.
+    size_t steals()
+    {
+#ifdef USE_SCHED_STATS
+      return steal_count;
+#else
+      return 0;
+#endif
+    }
+
     void steal()
     {
 #ifdef USE_SCHED_STATS
@@ -46,6 +114,30 @@ namespace verona::rt
 #endif
     }
 
+    void steal_tier(size_t tier)
+    {
+      UNUSED(tier);
+
+#ifdef USE_SCHED_STATS
+      assert(tier < 3);
+      steal_tier_count[tier]++;
+#endif
+    }
+
+    void steal_affinity_keep()
+    {
+#ifdef USE_SCHED_STATS
+      steal_affinity_keep_count++;
+#endif
+    }
+
+    void steal_affinity_break()
+    {
+#ifdef USE_SCHED_STATS
+      steal_affinity_break_count++;
+#endif
+    }
+
     void pause()
     {
 #ifdef USE_SCHED_STATS
@@ -53,6 +145,44 @@ namespace verona::rt
 #endif
     }
 
+    void idle_spin(uint64_t tsc)
+    {
+      UNUSED(tsc);
+
+#ifdef USE_SCHED_STATS
+      idle_spin_tsc += tsc;
+#endif
+    }
+
+    void idle_shallow(uint64_t tsc)
+    {
+      UNUSED(tsc);
+
+#ifdef USE_SCHED_STATS
+      idle_shallow_tsc += tsc;
+#endif
+    }
+
+    void idle_park(uint64_t tsc)
+    {
+      UNUSED(tsc);
+
+#ifdef USE_SCHED_STATS
+      idle_park_tsc += tsc;
+#endif
+    }
+
+    /// Record one multi-cown acquisition batch of the given size.
+    void mm_batch(size_t acquired)
+    {
+      UNUSED(acquired);
+
+#ifdef USE_SCHED_STATS
+      mm_batch_count++;
+      mm_batch_cowns += acquired;
+#endif
+    }
+
     void unpause()
     {
 #ifdef USE_SCHED_STATS
@@ -67,18 +197,201 @@ namespace verona::rt
 #endif
     }
 
+    void inline_run()
+    {
+#ifdef USE_SCHED_STATS
+      inline_run_count++;
+#endif
+    }
+
+    void direct_run()
+    {
+#ifdef USE_SCHED_STATS
+      direct_run_count++;
+#endif
+    }
+
+    void share()
+    {
+#ifdef USE_SCHED_STATS
+      share_count++;
+#endif
+    }
+
+    void mute()
+    {
+#ifdef USE_SCHED_STATS
+      mute_count++;
+#endif
+    }
+
+    void unmute_bp()
+    {
+#ifdef USE_SCHED_STATS
+      unmute_count_bp++;
+#endif
+    }
+
+    void cown_pool_hit()
+    {
+#ifdef USE_SCHED_STATS
+      cown_pool_hit_count++;
+#endif
+    }
+
+    void cown_pool_miss()
+    {
+#ifdef USE_SCHED_STATS
+      cown_pool_miss_count++;
+#endif
+    }
+
+    /// Account `tsc` ticks to the LD state this thread is leaving.
+    void ld_transition(ThreadState::State prev, uint64_t tsc)
+    {
+      UNUSED(prev);
+      UNUSED(tsc);
+
+#ifdef USE_SCHED_STATS
+      ld_state_tsc[prev] += tsc;
+      ld_transition_count++;
+#endif
+    }
+
+    /// Record one wake-chain latency sample, in TSC ticks.
+    void wake_latency(uint64_t tsc)
+    {
+      UNUSED(tsc);
+
+#ifdef USE_SCHED_STATS
+      wake_count++;
+      wake_latency_tsc += tsc;
+
+      size_t b = 0;
+      while (((tsc >> (b + WAKE_HIST_SHIFT)) != 0) &&
+             (b < (WAKE_HIST_BUCKETS - 1)))
+        b++;
+      wake_latency_hist[b]++;
+#endif
+    }
+
     void add(SchedulerStats& that)
     {
       UNUSED(that);
 
 #ifdef USE_SCHED_STATS
       steal_count += that.steal_count;
+      for (size_t i = 0; i < 3; i++)
+        steal_tier_count[i] += that.steal_tier_count[i];
+      steal_affinity_keep_count += that.steal_affinity_keep_count;
+      steal_affinity_break_count += that.steal_affinity_break_count;
       pause_count += that.pause_count;
+      mm_batch_count += that.mm_batch_count;
+      mm_batch_cowns += that.mm_batch_cowns;
+      idle_spin_tsc += that.idle_spin_tsc;
+      idle_shallow_tsc += that.idle_shallow_tsc;
+      idle_park_tsc += that.idle_park_tsc;
       unpause_count += that.unpause_count;
       lifo_count += that.lifo_count;
+      inline_run_count += that.inline_run_count;
+      direct_run_count += that.direct_run_count;
+      share_count += that.share_count;
+      mute_count += that.mute_count;
+      unmute_count_bp += that.unmute_count_bp;
+      cown_pool_hit_count += that.cown_pool_hit_count;
+      cown_pool_miss_count += that.cown_pool_miss_count;
+      for (size_t i = 0; i <= ThreadState::Finished; i++)
+        ld_state_tsc[i] += that.ld_state_tsc[i];
+      ld_transition_count += that.ld_transition_count;
+      for (size_t i = 0; i < WAKE_HIST_BUCKETS; i++)
+        wake_latency_hist[i] += that.wake_latency_hist[i];
+      wake_count += that.wake_count;
+      wake_latency_tsc += that.wake_latency_tsc;
 #endif
     }
 
+    /**
+     * Copy the counters into `out`, which must hold SNAPSHOT_COUNTERS
+     * entries, in `counter_name` order. May be called from a thread other
+     * than the counters' owner: the reads are unsynchronised, so a value
+     * may be slightly stale or torn, which yields a slightly wrong delta
+     * in one monitoring sample and is acceptable. All zero when stats are
+     * compiled out.
+     */
+    void snapshot(uint64_t* out)
+    {
+      for (size_t i = 0; i < SNAPSHOT_COUNTERS; i++)
+        out[i] = 0;
+
+#ifdef USE_SCHED_STATS
+      size_t i = 0;
+      out[i++] = steal_count;
+      out[i++] = steal_tier_count[0];
+      out[i++] = steal_tier_count[1];
+      out[i++] = steal_tier_count[2];
+      out[i++] = steal_affinity_keep_count;
+      out[i++] = steal_affinity_break_count;
+      out[i++] = lifo_count.load(std::memory_order_relaxed);
+      out[i++] = pause_count;
+      out[i++] = unpause_count.load(std::memory_order_relaxed);
+      out[i++] = inline_run_count;
+      out[i++] = direct_run_count;
+      out[i++] = share_count;
+      out[i++] = mute_count;
+      out[i++] = unmute_count_bp;
+      out[i++] = cown_pool_hit_count;
+      out[i++] = cown_pool_miss_count;
+      out[i++] = mm_batch_count;
+      out[i++] = mm_batch_cowns;
+      out[i++] = idle_spin_tsc;
+      out[i++] = idle_shallow_tsc;
+      out[i++] = idle_park_tsc;
+      out[i++] = ld_transition_count;
+
+      for (size_t s = 0; s <= ThreadState::Finished; s++)
+        out[i++] = ld_state_tsc[s];
+
+      out[i++] = wake_count;
+      out[i++] = wake_latency_tsc;
+
+      for (size_t b = 0; b < WAKE_HIST_BUCKETS; b++)
+        out[i++] = wake_latency_hist[b];
+
+      assert(i == SNAPSHOT_COUNTERS);
+#endif
+    }
+
+    /// Name of the `i`th counter in a `snapshot`, for text dumps. Keep in
+    /// sync with `snapshot`.
+    static std::string counter_name(size_t i)
+    {
+      static constexpr const char* scalar[] = {
+        "Steal",        "StealPackage",      "StealNode",
+        "StealRemote",  "StealAffinityKeep", "StealAffinityBreak",
+        "LIFO",         "Pause",             "Unpause",
+        "InlineRun",    "DirectRun",         "Share",
+        "Mute",         "UnmuteBP",          "CownPoolHit",
+        "CownPoolMiss", "MMBatch",           "MMBatchCowns",
+        "IdleSpinTSC",  "IdleShallowTSC",    "IdleParkTSC",
+        "LDTransitions"};
+      constexpr size_t scalars = sizeof(scalar) / sizeof(scalar[0]);
+
+      if (i < scalars)
+        return scalar[i];
+      i -= scalars;
+
+      if (i <= ThreadState::Finished)
+        return "LDStateTSC" + std::to_string(i);
+      i -= ThreadState::Finished + 1;
+
+      if (i == 0)
+        return "WakeCount";
+      if (i == 1)
+        return "WakeTSC";
+
+      return "WakeHist" + std::to_string(i - 2);
+    }
+
     void print(std::ostream& o, uint64_t dumpid = 0)
     {
       UNUSED(o);
@@ -94,13 +407,87 @@ namespace verona::rt
         csv << "SchedulerStats"
             << "DumpID"
             << "Steal"
+            << "StealPackage"
+            << "StealNode"
+            << "StealRemote"
+            << "StealAffinityKeep"
+            << "StealAffinityBreak"
             << "LIFO"
             << "Pause"
-            << "Unpause" << csv.endl;
+            << "Unpause"
+            << "InlineRun"
+            << "DirectRun"
+            << "Share"
+            << "Mute"
+            << "UnmuteBP"
+            << "CownPoolHit"
+            << "CownPoolMiss"
+            << "MMBatch"
+            << "MMBatchCowns"
+            << "IdleSpinTSC"
+            << "IdleShallowTSC"
+            << "IdleParkTSC"
+            << "LDTransitions"
+            << "LDNotInLDTSC"
+            << "LDWantLDTSC"
+            << "LDPreScanTSC"
+            << "LDScanTSC"
+            << "LDAllInScanTSC"
+            << "LDBDVoteTSC"
+            << "LDBDVotedTSC"
+            << "LDBDTSC"
+            << "LDBDConfirmTSC"
+            << "LDBDRetractTSC"
+            << "LDBDAckTSC"
+            << "LDRDTSC"
+            << "LDRDConfirmTSC"
+            << "LDRDRetractTSC"
+            << "LDSweepTSC"
+            << "LDFinishedTSC"
+            << "WakeCount"
+            << "WakeTSC";
+
+        // One column per log2 wake-latency bucket; bucket b holds samples
+        // below 2^(b + WAKE_HIST_SHIFT) ticks.
+        for (size_t b = 0; b < WAKE_HIST_BUCKETS; b++)
+          csv << ("WakeHist" + std::to_string(b));
+
+        csv << csv.endl;
       }
 
-      csv << "SchedulerStats" << dumpid << steal_count << lifo_count
-          << pause_count << unpause_count << csv.endl;
+      csv << "SchedulerStats" << dumpid << steal_count << steal_tier_count[0]
+          << steal_tier_count[1] << steal_tier_count[2]
+          << steal_affinity_keep_count << steal_affinity_break_count
+          << lifo_count
+          << pause_count << unpause_count << inline_run_count
+          << direct_run_count << share_count
+          << mute_count
+          << unmute_count_bp
+          << cown_pool_hit_count << cown_pool_miss_count
+          << mm_batch_count << mm_batch_cowns
+          << idle_spin_tsc << idle_shallow_tsc << idle_park_tsc
+          << ld_transition_count;
+
+      for (size_t i = 0; i <= ThreadState::Finished; i++)
+        csv << ld_state_tsc[i];
+
+      csv << wake_count << wake_latency_tsc;
+
+      for (size_t b = 0; b < WAKE_HIST_BUCKETS; b++)
+        csv << wake_latency_hist[b];
+
+      csv << csv.endl;
+
+#  ifdef USE_SNMALLOC_STATS
+      // Interleave snmalloc's per-allocator counters (bytes allocated and
+      // freed per sizeclass, remote deallocations, slab churn) with the
+      // scheduler rows, so scheduler behaviour can be correlated with
+      // allocator pressure from a single CSV. Allocators are per thread,
+      // so each allocator's rows correspond to one scheduler thread. The
+      // counters live privately inside snmalloc, hence its own printer
+      // rather than sampled fields here.
+      snmalloc::current_alloc_pool()->print_all_stats(o, dumpid);
+#  endif
 #endif
     }
   };
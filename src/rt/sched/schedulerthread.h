@@ -2,14 +2,19 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include "behaviourprofiler.h"
 #include "cpu.h"
+#include "eventring.h"
 #include "ds/hashmap.h"
 #include "ds/mpscq.h"
 #include "object/object.h"
 #include "priority.h"
+#include "replay.h"
 #include "schedulerstats.h"
 #include "spmcq.h"
 #include "threadpool.h"
+#include "timerwheel.h"
+#include "wsdeque.h"
 
 #include <snmalloc.h>
 #include <thread>
@@ -52,8 +57,6 @@ namespace verona::rt
     template<typename Owner>
     friend class Noticeboard;
 
-    static constexpr uint64_t TSC_QUIESCENCE_TIMEOUT = 1'000'000;
-
     T* token_cown = nullptr;
 
 #ifdef USE_SYSTEMATIC_TESTING
@@ -63,11 +66,70 @@ namespace verona::rt
     bool sleeping = false;
 #endif
 
-    SPMCQ<T> q;
-    Alloc* alloc = nullptr;
+    // --- Steal targets --------------------------------------------------
+    // Thieves CAS on these queues; they start on their own cache line so
+    // cross-thread steal traffic stays off the owner-local fields below.
+
+    // The link is named explicitly: `next_in_queue` is private to T and
+    // this class is its friend, so the member pointer is formed here
+    // rather than by the queue's default argument.
+    alignas(CACHE_LINE_SIZE) SPMCQ<T, &T::next_in_queue> q;
+    /// High-priority lane: cowns marked with `set_sched_priority(true)`
+    /// are scheduled here and drained ahead of `q`, subject to the
+    /// anti-starvation burst limit below.
+    WSDeque<T> high_lane;
+    /// Alternative owner-side queue used when the thread pool has been
+    /// configured with `set_ws_deque(true)`. FIFO scheduled cowns go into
+    /// the deque; the token, LIFO scheduling and deque overflow stay on
+    /// `q`, so all cross-thread pushes keep their existing path.
+    WSDeque<T> deque;
+
+    // --- Written by other threads ---------------------------------------
+    // Flags and stacks that arbitrary threads store to; grouped so their
+    // invalidations hit one line.
+
+    /// External (non-scheduler) threads push unscheduled cowns on to this
+    /// per-thread injection stack instead of contending on the SPMCQ front
+    /// with thieves and the owner. Producers race only with other external
+    /// threads that picked this shard; the owning thread drains the whole
+    /// list with a single exchange in `next_local`.
+    alignas(CACHE_LINE_SIZE) std::atomic<T*> inject{nullptr};
+
+    // The cown queue is initialized with only the token (a cown) in.
+    // Whenever the token is popped out, the popping thread informs the
+    // owner so that it could re-insert the token, which is required
+    // because there's always one cown stuck in the queue; if the token is
+    // not there, this must mean a real cown is stuck there. Accordingly,
+    // the `is_empty` returns true iff token is the only item left in the
+    // queue.
+    //
+    // `token_consumed` is only set when the token is popped by a *thief*;
+    // the owner popping its own token records that in the owner-local
+    // `token_out` instead, so the common drain cycle never writes to this
+    // shared line.
+    std::atomic<bool> token_consumed = false;
+    std::atomic<bool> scheduled_unscanned_cown = false;
+    std::atomic<size_t> free_cowns = 0;
+    std::condition_variable cv;
+
+    // --- Owner-local ----------------------------------------------------
+    // Only ever touched by the owning thread (or before it starts).
+
+    alignas(CACHE_LINE_SIZE) Alloc* alloc = nullptr;
     SchedulerThread<T>* next = nullptr;
     SchedulerThread<T>* victim = nullptr;
-    std::condition_variable cv;
+    /// The runtime instance this thread belongs to, set by its `init`.
+    Scheduler* pool = nullptr;
+
+    /// NUMA node and package of the core this thread is pinned to, filled
+    /// in from the Topology when the thread pool starts.
+    size_t numa_node = 0;
+    size_t package = 0;
+    /// Victims ordered by topological distance (SMT/package first, then
+    /// same NUMA node, then remote nodes). Only populated when
+    /// `set_topology_stealing(true)` has been set on the thread pool.
+    std::vector<SchedulerThread<T>*> victims;
+    size_t victim_index = 0;
 
     bool running = true;
 
@@ -75,17 +137,45 @@ namespace verona::rt
     // process before reaching its LD checkpoint (`n_ld_tokens == 0`).
     uint8_t n_ld_tokens = 0;
 
-    // The cown queue is initialized with only the token (a cown) in.
-    // Whenever the token is popped out, `token_consumed` is set to `true`,
-    // informing its owner so that it could re-insert the token, which is
-    // required because there's always one cown stuck in the queue; if the
-    // token is not there, this must mean a real cown is stuck there.
-    // Accordingly, the `is_empty` returns true iff token is the only item
-    // left in the queue.
-    std::atomic<bool> token_consumed = false;
     bool should_steal_for_fairness = false;
 
-    std::atomic<bool> scheduled_unscanned_cown = false;
+    /// Adaptive fairness state (see `fairness_cycle`): TSC stamp of the
+    /// last token enqueue, behaviours run since, an EWMA of per-behaviour
+    /// cost measured over token cycles, and the current period after
+    /// which a fairness steal is due. Only used in fair mode with
+    /// `set_fair_period` bounds configured.
+    uint64_t token_enqueued_tsc = Systematic::tick();
+    size_t cycle_behaviours = 0;
+    uint64_t behaviour_cost_ewma = 0;
+    uint64_t fair_period_tsc = 0;
+
+    /// Set when this thread pops its own token from its queue. Written
+    /// only by the owning thread; atomic because thieves read it in debug
+    /// assertions.
+    std::atomic<bool> token_out{false};
+
+    /// Adaptive idle state: the current spin budget in TSC ticks, and
+    /// whether the next park should be a shallow (timed) sleep. Reset
+    /// whenever the thread finds work.
+    uint64_t spin_budget = 0;
+    bool shallow_park = true;
+
+    /// After this many consecutive high-priority dequeues, one
+    /// normal-priority cown is let through.
+    static constexpr size_t HIGH_LANE_BURST = 32;
+    size_t high_lane_run = 0;
+
+    /// Number of cowns scheduled FIFO since this thread last dequeued.
+    /// A long run indicates a behaviour rescheduling a large fan-out, and
+    /// triggers proactive work sharing: every other cown beyond the
+    /// threshold is pushed straight to an idle sibling instead of waiting
+    /// to be discovered by stealing one at a time.
+    size_t fifo_burst = 0;
+    static constexpr size_t SHARE_THRESHOLD = 16;
+
+    /// Depth of nested inline behaviour execution (see
+    /// Cown::schedule_inline).
+    size_t inline_depth = 0;
 
     EpochMark send_epoch = EpochMark::EPOCH_A;
     EpochMark prev_epoch = EpochMark::EPOCH_B;
@@ -93,11 +183,20 @@ namespace verona::rt
 
     std::thread t;
     ThreadState::State state = ThreadState::State::NotInLD;
+    /// TSC at this thread's last LD state transition, so each transition
+    /// can account the time spent in the state being left.
+    uint64_t ld_state_since = Systematic::tick();
     SchedulerStats stats;
+    SchedulerEventRing events;
+    /// Recorded (or replayed) scheduler decisions for this thread.
+    SchedulerReplay replay;
+    /// Sampled behaviour execution costs for this thread.
+    BehaviourProfiler profiler;
+    /// Timers armed on this thread, checked once per main loop iteration.
+    TimerWheel<T> timers;
 
     T* list = nullptr;
     size_t total_cowns = 0;
-    std::atomic<size_t> free_cowns = 0;
 
     /// The MessageBody of a running behaviour.
     typename T::MessageBody* message_body = nullptr;
@@ -108,6 +207,63 @@ namespace verona::rt
     /// cleared before scheduler sleep, or in some stages of the LD protocol.
     ObjectMap<T*> mute_set;
 
+#if defined(__GNUC__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+    /// Compile-time guards for the cache-line partitioning above. The
+    /// call from the constructor forces instantiation; the body never runs.
+    static void layout_guards()
+    {
+      static_assert(offsetof(SchedulerThread, q) % CACHE_LINE_SIZE == 0);
+      static_assert(offsetof(SchedulerThread, inject) % CACHE_LINE_SIZE == 0);
+      static_assert(offsetof(SchedulerThread, alloc) % CACHE_LINE_SIZE == 0);
+      // Steal targets, cross-thread flags, then owner-local state.
+      static_assert(
+        offsetof(SchedulerThread, q) < offsetof(SchedulerThread, inject));
+      static_assert(
+        offsetof(SchedulerThread, inject) < offsetof(SchedulerThread, alloc));
+    }
+
+#ifdef USE_LAYOUT_AUDIT
+  public:
+    /// Print the offset, size and cache line of each member, to audit the
+    /// partitioning when fields are added or reordered.
+    static void dump_layout(std::ostream& o)
+    {
+#  define LAYOUT_ROW(member) \
+    o << "  " << #member << " @" << offsetof(SchedulerThread, member) << " +" \
+      << sizeof(((SchedulerThread*)nullptr)->member) << " line " \
+      << (offsetof(SchedulerThread, member) / CACHE_LINE_SIZE) << std::endl
+      o << "SchedulerThread (size " << sizeof(SchedulerThread) << ", align "
+        << alignof(SchedulerThread) << ")" << std::endl;
+      LAYOUT_ROW(token_cown);
+      LAYOUT_ROW(q);
+      LAYOUT_ROW(high_lane);
+      LAYOUT_ROW(deque);
+      LAYOUT_ROW(inject);
+      LAYOUT_ROW(token_consumed);
+      LAYOUT_ROW(scheduled_unscanned_cown);
+      LAYOUT_ROW(free_cowns);
+      LAYOUT_ROW(cv);
+      LAYOUT_ROW(alloc);
+      LAYOUT_ROW(victims);
+      LAYOUT_ROW(spin_budget);
+      LAYOUT_ROW(stats);
+      LAYOUT_ROW(events);
+      LAYOUT_ROW(replay);
+      LAYOUT_ROW(profiler);
+      LAYOUT_ROW(timers);
+      LAYOUT_ROW(mute_set);
+#  undef LAYOUT_ROW
+    }
+
+  private:
+#endif
+#if defined(__GNUC__)
+#  pragma GCC diagnostic pop
+#endif
+
     T* get_token_cown()
     {
       assert(token_cown);
@@ -119,6 +275,7 @@ namespace verona::rt
       q{token_cown},
       mute_set{ThreadAlloc::get()}
     {
+      layout_guards();
       token_cown->set_owning_thread(this);
     }
 
@@ -142,7 +299,12 @@ namespace verona::rt
       running = false;
     }
 
-    inline void schedule_fifo(T* a)
+    /**
+     * Per-cown part of FIFO scheduling: the bookkeeping and the queue
+     * push, without the token check and unpause that complete a
+     * schedule. Callers batch those over one or many pushes.
+     */
+    inline void schedule_fifo_push(T* a)
     {
       Systematic::cout() << "Enqueue cown " << a << " (" << a->get_epoch_mark()
                          << ")" << std::endl;
@@ -154,7 +316,27 @@ namespace verona::rt
         scheduled_unscanned_cown = true;
       }
       assert(!a->queue.is_sleeping());
-      q.enqueue(alloc, a);
+      events.record(SchedulerEventRing::Kind::Schedule, a);
+
+      fifo_burst++;
+      if (
+        (fifo_burst > SHARE_THRESHOLD) && ((fifo_burst & 1) == 0) &&
+        !a->is_pinned() && try_share(a))
+        return;
+
+      if (a->high_sched_priority() && high_lane.push(a))
+      {
+        // Scheduled on the high-priority lane.
+      }
+      else if (!Scheduler::get().use_ws_deque || !deque.push(a))
+      {
+        q.enqueue(alloc, a);
+      }
+    }
+
+    inline void schedule_fifo(T* a)
+    {
+      schedule_fifo_push(a);
 
       // Put the token back if it has been stolen.  This will help
       // free up more work for other threads to steal.
@@ -164,12 +346,29 @@ namespace verona::rt
         stats.unpause();
     }
 
+    /**
+     * Schedule a batch of cowns from this thread at once. Each cown pays
+     * only its queue push; the token check and the unpause of sleeping
+     * threads happen once for the whole batch.
+     */
+    void schedule_fifo_many(size_t count, T** cowns)
+    {
+      for (size_t i = 0; i < count; i++)
+        schedule_fifo_push(cowns[i]);
+
+      check_token_cown();
+
+      if (Scheduler::get().unpause())
+        stats.unpause();
+    }
+
     inline void schedule_lifo(T* a)
     {
       // A lifo scheduled cown is coming from an external source, such as
       // asynchronous I/O.
       Systematic::cout() << "LIFO schedule cown " << a << std::endl;
 
+      events.record(SchedulerEventRing::Kind::ScheduleLifo, a);
       q.enqueue_front(ThreadAlloc::get(), a);
       stats.lifo();
 
@@ -177,33 +376,289 @@ namespace verona::rt
         stats.unpause();
     }
 
+    /**
+     * Schedule a cown from a thread that is not part of the runtime. The
+     * cown is pushed on to this thread's injection stack; the owning
+     * thread moves it on to the scheduler queue the next time it looks
+     * for work.
+     */
+    void schedule_external(T* a)
+    {
+      Systematic::cout() << "External schedule cown " << a << std::endl;
+
+      T* cur = inject.load(std::memory_order_relaxed);
+      do
+      {
+        a->next_in_queue = cur;
+      } while (!inject.compare_exchange_weak(
+        cur, a, std::memory_order_release, std::memory_order_relaxed));
+
+      stats.lifo();
+
+      if (Scheduler::get().unpause())
+        stats.unpause();
+    }
+
+    /**
+     * Schedule a batch of cowns from a thread that is not part of the
+     * runtime. The batch is chained locally and published on to the
+     * injection stack with a single push, so a large fan-in does not
+     * contend on the stack head once per cown.
+     */
+    void schedule_external_many(size_t count, T** cowns)
+    {
+      assert(count > 0);
+      Systematic::cout() << "External schedule of " << count << " cowns"
+                         << std::endl;
+
+      for (size_t i = 0; i + 1 < count; i++)
+        cowns[i]->next_in_queue = cowns[i + 1];
+      T* last = cowns[count - 1];
+
+      T* cur = inject.load(std::memory_order_relaxed);
+      do
+      {
+        last->next_in_queue = cur;
+      } while (!inject.compare_exchange_weak(
+        cur, cowns[0], std::memory_order_release, std::memory_order_relaxed));
+
+      for (size_t i = 0; i < count; i++)
+        stats.lifo();
+
+      if (Scheduler::get().unpause())
+        stats.unpause();
+    }
+
+    /**
+     * Move all externally injected cowns on to the scheduler queue.
+     */
+    void drain_inject()
+    {
+      T* list = inject.exchange(nullptr, std::memory_order_acquire);
+
+      while (list != nullptr)
+      {
+        T* next = list->next_in_queue;
+        q.enqueue_front(alloc, list);
+        list = next;
+      }
+    }
+
+    /**
+     * Push a cown from a large local fan-out directly to an idle sibling
+     * thread's queue. Returns false if no sibling currently looks idle,
+     * in which case the caller schedules locally as usual.
+     */
+    bool try_share(T* a)
+    {
+      for (auto* s = next; s != this; s = s->next)
+      {
+        if (!s->is_queue_empty())
+          continue;
+
+        Systematic::cout() << "Share cown " << a << " with thread "
+                           << s->systematic_id << std::endl;
+        s->q.enqueue_front(alloc, a);
+        stats.share();
+
+        if (Scheduler::get().unpause())
+          stats.unpause();
+
+        return true;
+      }
+
+      return false;
+    }
+
+    /**
+     * Dequeue the next cown scheduled on this thread. The token, LIFO
+     * scheduling and deque overflow are drained from `q` first so that the
+     * fairness protocol observes the same ordering in both queue modes.
+     */
+    T* next_local()
+    {
+      if (inject.load(std::memory_order_relaxed) != nullptr)
+        drain_inject();
+
+      fifo_burst = 0;
+
+      T* cown;
+
+      // Drain the high-priority lane first, but let one normal-priority
+      // cown through after every HIGH_LANE_BURST high-priority dequeues so
+      // the normal lane cannot be starved.
+      if (high_lane_run < HIGH_LANE_BURST)
+      {
+        cown = high_lane.pop();
+
+        if (cown != nullptr)
+        {
+          high_lane_run++;
+          return cown;
+        }
+      }
+
+      high_lane_run = 0;
+
+      cown = q.dequeue(alloc);
+
+      if (cown == nullptr && Scheduler::get().use_ws_deque)
+        cown = deque.pop();
+
+      if (cown == nullptr)
+        cown = high_lane.pop();
+
+      return cown;
+    }
+
+    /**
+     * Steal a cown from this thread. Called by other scheduler threads.
+     */
+    T* steal_from()
+    {
+      T* cown = high_lane.steal();
+
+      if (cown != nullptr)
+        return cown;
+
+      if (Scheduler::get().use_ws_deque)
+      {
+        cown = deque.steal();
+
+        if (cown != nullptr)
+          return cown;
+      }
+
+      return q.dequeue(ThreadAlloc::get());
+    }
+
+    bool is_queue_empty()
+    {
+      if (timers.expired())
+        return false;
+
+      if (inject.load(std::memory_order_relaxed) != nullptr)
+        return false;
+
+      if (!high_lane.is_empty())
+        return false;
+
+      if (Scheduler::get().use_ws_deque && !deque.is_empty())
+        return false;
+
+      return q.is_empty();
+    }
+
     void check_token_cown()
     {
       if (is_token_consumed())
       {
         Systematic::cout() << "Put token " << get_token_cown()
-                           << " in scheduler queue." << std::endl;
+                           << " in scheduler queue (flush epoch "
+                           << q.flush_epochs() << ")." << std::endl;
         if (n_ld_tokens > 0)
         {
           dec_n_ld_tokens();
         }
-        set_token_consumed(false);
+        token_out.store(false, std::memory_order_relaxed);
+        // Avoid dirtying the shared flag when the owner popped its own
+        // token; only a thief will have set it.
+        if (token_consumed.load(std::memory_order_relaxed))
+          set_token_consumed(false);
         enqueue_token();
 
         if (Scheduler::get().fair)
-        {
-          Systematic::cout() << "Should steal for fairness!" << std::endl;
-          should_steal_for_fairness = true;
-        }
+          fairness_cycle();
+      }
+      else if (
+        Scheduler::get().fair && (Scheduler::get().fair_period_max_tsc != 0) &&
+        !should_steal_for_fairness &&
+        ((Systematic::tick() - token_enqueued_tsc) > fair_period_tsc))
+      {
+        // The token has been stuck behind a deep queue for longer than
+        // the period: steal now rather than waiting for it, so fairness
+        // latency stays bounded. Restart the period so a still-deep
+        // queue does not force again immediately.
+        events.record(
+          SchedulerEventRing::Kind::FairForce,
+          (const void*)(uintptr_t)fair_period_tsc);
+        Systematic::cout() << "Should steal for fairness (overdue token)!"
+                           << std::endl;
+        should_steal_for_fairness = true;
+        token_enqueued_tsc = Systematic::tick();
+        cycle_behaviours = 0;
       }
     }
 
+    /**
+     * Close one token round trip and decide whether to steal for
+     * fairness. With no `set_fair_period` bounds configured, the cadence
+     * is fixed: every round trip steals, as before.
+     *
+     * Otherwise the period adapts to the observed load: the cycle's
+     * drain time updates an EWMA of per-behaviour cost, and the next
+     * period is the estimated drain time of the queue depth just
+     * observed, clamped to the configured bounds. A token that returned
+     * well inside the period means this thread is not hoarding work, so
+     * the steal is skipped rather than thrashing caches; a token that
+     * fails to return within the period forces a steal early (see
+     * `check_token_cown`). Each decision is recorded in the flight
+     * recorder with the period as its argument.
+     */
+    void fairness_cycle()
+    {
+      auto& sched = Scheduler::get();
+
+      if (sched.fair_period_max_tsc == 0)
+      {
+        Systematic::cout() << "Should steal for fairness!" << std::endl;
+        should_steal_for_fairness = true;
+        return;
+      }
+
+      auto now = Systematic::tick();
+      uint64_t cycle = now - token_enqueued_tsc;
+      uint64_t depth = cycle_behaviours == 0 ? 1 : cycle_behaviours;
+      token_enqueued_tsc = now;
+      cycle_behaviours = 0;
+
+      // EWMA over token cycles, weighting the newest observation 1/8.
+      uint64_t cost = cycle / depth;
+      if (behaviour_cost_ewma == 0)
+        behaviour_cost_ewma = cost;
+      else
+        behaviour_cost_ewma =
+          behaviour_cost_ewma - (behaviour_cost_ewma / 8) + (cost / 8);
+
+      fair_period_tsc = depth * behaviour_cost_ewma;
+      if (fair_period_tsc < sched.fair_period_min_tsc)
+        fair_period_tsc = sched.fair_period_min_tsc;
+      if (fair_period_tsc > sched.fair_period_max_tsc)
+        fair_period_tsc = sched.fair_period_max_tsc;
+
+      if ((cycle * 2) < fair_period_tsc)
+      {
+        events.record(
+          SchedulerEventRing::Kind::FairDefer,
+          (const void*)(uintptr_t)fair_period_tsc);
+        Systematic::cout() << "Skip fairness steal (fast token)" << std::endl;
+        return;
+      }
+
+      events.record(
+        SchedulerEventRing::Kind::FairSteal,
+        (const void*)(uintptr_t)fair_period_tsc);
+      Systematic::cout() << "Should steal for fairness!" << std::endl;
+      should_steal_for_fairness = true;
+    }
+
     /**
      * Track a cown muted on this thread so that it may be unmuted prior to
      * shutdown.
      */
     void mute_set_add(T* cown)
     {
+      events.record(SchedulerEventRing::Kind::Mute, cown);
       bool inserted = mute_set.insert(alloc, cown).first;
       if (inserted)
         cown->weak_acquire();
@@ -243,8 +698,15 @@ namespace verona::rt
 #endif
 
       Scheduler::local() = this;
+      Scheduler::set_current(*pool);
       alloc = ThreadAlloc::get();
+      replay.attach(systematic_id);
       victim = next;
+      spin_budget = Scheduler::get().idle_spin_min_tsc;
+      fair_period_tsc = Scheduler::get().fair_period_min_tsc;
+      token_enqueued_tsc = Systematic::tick();
+      if (Scheduler::get().topology_stealing)
+        build_victim_order();
       T* cown = nullptr;
 
 #ifdef USE_SYSTEMATIC_TESTING
@@ -272,11 +734,17 @@ namespace verona::rt
 
         check_token_cown();
 
+        timers.advance(alloc);
+        Scheduler::io_poller().poll(alloc);
+
         if (cown == nullptr)
         {
-          cown = q.dequeue(alloc);
+          cown = next_local();
           if (cown != nullptr)
+          {
+            replay.on_local_pop();
             Systematic::cout() << "Pop cown " << cown << std::endl;
+          }
         }
 
         if (cown == nullptr)
@@ -315,7 +783,16 @@ namespace verona::rt
 
         Systematic::cout() << "Running cown " << cown << std::endl;
 
+        // Close any in-flight wake-chain measurement: this is the first
+        // behaviour to run since a schedule woke the paused runtime.
+        uint64_t wake_tsc = Scheduler::get().take_wake_chain();
+        if (wake_tsc != 0)
+          stats.wake_latency(Systematic::tick() - wake_tsc);
+
+        events.record(SchedulerEventRing::Kind::BehaviourStart, cown);
         bool reschedule = cown->run(alloc, state, send_epoch);
+        events.record(SchedulerEventRing::Kind::BehaviourEnd, cown);
+        cycle_behaviours++;
 
         if (reschedule)
         {
@@ -331,7 +808,7 @@ namespace verona::rt
             // otherwise run this cown again. Don't push to the queue
             // immediately to avoid another thread stealing our only cown.
 
-            T* n = q.dequeue(alloc);
+            T* n = next_local();
 
             if (n != nullptr)
             {
@@ -340,7 +817,7 @@ namespace verona::rt
             }
             else
             {
-              if (q.is_empty())
+              if (is_queue_empty())
               {
                 Systematic::cout() << "Queue empty" << std::endl;
                 // We have effectively reached token cown.
@@ -376,6 +853,16 @@ namespace verona::rt
 
       assert(mute_set.size() == 0);
 
+      if (Scheduler::get_fast_exit())
+      {
+        // The process is about to exit: leave cowns, stubs and queue
+        // nodes to the OS instead of sweeping them. Stats fold into the
+        // global accumulator when the pool frees this thread, and the
+        // flight recorder stays dumpable until then.
+        Systematic::cout() << "Fast exit teardown" << std::endl;
+        return;
+      }
+
       Systematic::cout() << "Begin teardown (phase 1)" << std::endl;
 
       cown = list;
@@ -399,7 +886,125 @@ namespace verona::rt
 
       Systematic::cout() << "End teardown (phase 2)" << std::endl;
 
+      // Drain any deferred region reclamation left by the program.
+      while (T::reclaim_dead_regions(alloc))
+        ;
+
+      timers.drop_all(alloc);
       q.destroy(alloc);
+      deque.destroy(alloc);
+      high_lane.destroy(alloc);
+    }
+
+    /**
+     * Topological distance from this thread to a potential victim:
+     * 0 same package, 1 same NUMA node, 2 remote NUMA node.
+     */
+    size_t steal_tier_of(SchedulerThread<T>* v)
+    {
+      if (v->numa_node != numa_node)
+        return 2;
+
+      if (v->package != package)
+        return 1;
+
+      return 0;
+    }
+
+    /**
+     * Order the other scheduler threads by topological distance, so that
+     * steals exhaust nearby caches before pulling cown state across the
+     * interconnect.
+     */
+    void build_victim_order()
+    {
+      for (size_t tier = 0; tier < 3; tier++)
+      {
+        for (auto* v = next; v != this; v = v->next)
+        {
+          if (steal_tier_of(v) == tier)
+            victims.push_back(v);
+        }
+      }
+
+      if (!victims.empty())
+      {
+        victim_index = 0;
+        victim = victims[0];
+      }
+    }
+
+    /**
+     * Advance to the next victim; in topology order when enabled, ring
+     * order otherwise.
+     */
+    void next_victim()
+    {
+      if (!victims.empty())
+      {
+        victim_index++;
+        if (victim_index == victims.size())
+          victim_index = 0;
+        victim = victims[victim_index];
+        return;
+      }
+
+      victim = victim->next;
+    }
+
+    /**
+     * Point `victim` at the thread with the given systematic id; used by
+     * replay to reproduce a recorded steal. Leaves the victim unchanged
+     * if no other thread carries the id.
+     */
+    void set_victim(uint32_t id)
+    {
+      auto* v = next;
+      while ((v != this) && (v->systematic_id != id))
+        v = v->next;
+
+      if (v != this)
+        victim = v;
+    }
+
+    /**
+     * Steal from the current victim, preferring not to migrate cowns that
+     * have been pinned to their home thread. If the first cown stolen is
+     * pinned, one attempt is made to take something else and put the
+     * pinned cown back; the pinned cown is only kept when the victim had
+     * nothing else to offer.
+     */
+    T* steal_filtered()
+    {
+      T* cown = victim->steal_from();
+
+      if (cown == nullptr)
+        return nullptr;
+
+      if (has_thread_bit(cown) || !cown->is_pinned())
+        return cown;
+
+      T* other = victim->steal_from();
+
+      if (other == nullptr)
+      {
+        // The pinned cown is the only work available; migrate it anyway.
+        stats.steal_affinity_break();
+        return cown;
+      }
+
+      if (has_thread_bit(other) || !other->is_pinned())
+      {
+        Systematic::cout() << "Steal skips pinned cown " << cown << std::endl;
+        victim->q.enqueue_front(ThreadAlloc::get(), cown);
+        stats.steal_affinity_keep();
+        return other;
+      }
+
+      // Both are pinned; keep one at home and migrate the other.
+      victim->q.enqueue_front(ThreadAlloc::get(), other);
+      stats.steal_affinity_break();
+      return cown;
     }
 
     bool fast_steal(T*& result)
@@ -407,14 +1012,19 @@ namespace verona::rt
       // auto cur_victim = victim;
       T* cown;
 
+      uint32_t replay_victim;
+      if (replay.next_steal_victim(replay_victim))
+        set_victim(replay_victim);
+
       // Try to steal from the victim thread.
       if (victim != this)
       {
-        cown = victim->q.dequeue(alloc);
+        cown = steal_filtered();
 
         if (cown != nullptr)
         {
           // stats.steal();
+          replay.on_steal(victim->systematic_id);
           Systematic::cout() << "Fast-steal cown " << cown << " from "
                              << victim->systematic_id << std::endl;
           result = cown;
@@ -423,7 +1033,8 @@ namespace verona::rt
       }
 
       // We were unable to steal, move to the next victim thread.
-      victim = victim->next;
+      if (!replay.replaying())
+        next_victim();
 
       return false;
     }
@@ -437,15 +1048,16 @@ namespace verona::rt
 
     bool is_token_consumed()
     {
-      auto res = token_consumed.load(std::memory_order_relaxed);
+      auto res = token_out.load(std::memory_order_relaxed) ||
+        token_consumed.load(std::memory_order_relaxed);
       yield();
       return res;
     }
 
     bool debug_is_token_consumed()
     {
-      auto res = token_consumed.load(std::memory_order_relaxed);
-      return res;
+      return token_out.load(std::memory_order_relaxed) ||
+        token_consumed.load(std::memory_order_relaxed);
     }
 
     void set_token_consumed(bool res)
@@ -454,18 +1066,28 @@ namespace verona::rt
       token_consumed.store(res, std::memory_order_relaxed);
     }
 
+    /// Reset the adaptive idle state after finding work.
+    void reset_idle()
+    {
+      spin_budget = Scheduler::get().idle_spin_min_tsc;
+      shallow_park = true;
+    }
+
     T* steal()
     {
-      uint64_t tsc = Aal::tick();
+      uint64_t tsc = Systematic::tick();
       T* cown;
 
       while (running)
       {
         check_token_cown();
 
+        timers.advance(alloc);
+        Scheduler::io_poller().poll(alloc);
+
         yield();
 
-        if (q.is_empty())
+        if (is_queue_empty())
         {
           n_ld_tokens = 0;
         }
@@ -474,33 +1096,54 @@ namespace verona::rt
         ld_protocol();
 
         // Check if some other thread has pushed work on our queue.
-        cown = q.dequeue(alloc);
+        cown = next_local();
 
         if (cown != nullptr)
+        {
+          replay.on_local_pop();
+          reset_idle();
           return cown;
+        }
+
+        // In replay mode, jump straight to the recorded victim of the
+        // next steal rather than walking the ring.
+        uint32_t replay_victim;
+        if (replay.next_steal_victim(replay_victim))
+          set_victim(replay_victim);
 
         // Try to steal from the victim thread.
         if (victim != this)
         {
-          cown = victim->q.dequeue(alloc);
+          cown = steal_filtered();
 
           if (cown != nullptr)
           {
+            replay.on_steal(victim->systematic_id);
             stats.steal();
+            stats.steal_tier(steal_tier_of(victim));
+            events.record(SchedulerEventRing::Kind::Steal, cown);
             Systematic::cout() << "Stole cown " << cown << " from "
                                << victim->systematic_id << std::endl;
+            reset_idle();
             return cown;
           }
         }
 
-        // We were unable to steal, move to the next victim thread.
-        victim = victim->next;
+        // We were unable to steal, move to the next victim thread; in
+        // replay mode stay on the recorded victim until it yields work.
+        if (!replay.replaying())
+          next_victim();
+
+        // Use otherwise-idle cycles to reclaim memory from dead regions
+        // before considering parking.
+        if (T::reclaim_dead_regions(alloc))
+          continue;
 
-        // Wait until a minimum timeout has passed.
-        uint64_t tsc2 = Aal::tick();
+        // Spin until the current budget has been exhausted.
+        uint64_t tsc2 = Systematic::tick();
 
 #ifndef USE_SYSTEMATIC_TESTING
-        if ((tsc2 - tsc) < TSC_QUIESCENCE_TIMEOUT)
+        if ((tsc2 - tsc) < spin_budget)
         {
           Aal::pause();
         }
@@ -516,12 +1159,37 @@ namespace verona::rt
           continue;
         }
         // Enter sleep only when the queue doesn't contain any real cowns.
-        else if (state == ThreadState::NotInLD && q.is_empty())
+        else if (state == ThreadState::NotInLD && is_queue_empty())
         {
-          // We've been spinning looking for work for some time. While paused,
-          // our running flag may be set to false, in which case we terminate.
-          if (Scheduler::get().pause(tsc2))
+          // We've been spinning looking for work for some time. Take one
+          // shallow (timed) sleep, then park fully on subsequent attempts.
+          // While paused, our running flag may be set to false, in which
+          // case we terminate.
+          stats.idle_spin(tsc2 - tsc);
+          events.record(SchedulerEventRing::Kind::Park);
+          // Never park deeply while timers are outstanding: a timed sleep
+          // guarantees the wheel is advanced close to the next deadline.
+          if (Scheduler::get().pause(
+                tsc2, shallow_park || (timers.pending() != 0)))
+          {
             stats.pause();
+            events.record(SchedulerEventRing::Kind::Unpark);
+            uint64_t tsc3 = Systematic::tick();
+            if (shallow_park)
+            {
+              stats.idle_shallow(tsc3 - tsc2);
+              shallow_park = false;
+            }
+            else
+            {
+              stats.idle_park(tsc3 - tsc2);
+            }
+            // Widen the spin budget and restart the spin window, so bursty
+            // arrivals are picked up without a futex round-trip.
+            spin_budget =
+              std::min(spin_budget * 2, Scheduler::get().idle_spin_max_tsc);
+            tsc = tsc3;
+          }
         }
 #ifdef USE_SYSTEMATIC_TESTING
         else
@@ -561,15 +1229,18 @@ namespace verona::rt
         auto unmasked = clear_thread_bit(cown);
         SchedulerThread* sched = unmasked->owning_thread();
         assert(!sched->debug_is_token_consumed());
-        sched->set_token_consumed(true);
 
         if (sched != this)
         {
+          sched->set_token_consumed(true);
           Systematic::cout() << "Reached token: stolen from "
                              << sched->systematic_id << std::endl;
         }
         else
         {
+          // Own token: stay on owner-local state, off the shared flag.
+          yield();
+          token_out.store(true, std::memory_order_relaxed);
           Systematic::cout() << "Reached token" << std::endl;
         }
 
@@ -731,6 +1402,11 @@ namespace verona::rt
     {
       Systematic::cout() << "Scheduler state change: " << state << " -> "
                          << snext << std::endl;
+
+      uint64_t now = Systematic::tick();
+      stats.ld_transition(state, now - ld_state_since);
+      ld_state_since = now;
+
       state = snext;
     }
 
@@ -744,6 +1420,7 @@ namespace verona::rt
       // scanning.
       send_epoch = EpochMark::EPOCH_NONE;
 
+      replay.on_epoch_advance(static_cast<uint32_t>(send_epoch));
       Systematic::cout() << "send_epoch (1): " << send_epoch << std::endl;
     }
 
@@ -758,6 +1435,7 @@ namespace verona::rt
     {
       send_epoch = (prev_epoch == EpochMark::EPOCH_B) ? EpochMark::EPOCH_A :
                                                         EpochMark::EPOCH_B;
+      replay.on_epoch_advance(static_cast<uint32_t>(send_epoch));
       Systematic::cout() << "send_epoch (2): " << send_epoch << std::endl;
 
       // Send empty messages to all cowns that can be LIFO scheduled.
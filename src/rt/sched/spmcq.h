@@ -44,8 +44,16 @@ namespace verona::rt
    * completed, and then can be used for
    *   - The leak detector algorithm
    *   - The fairness of scheduling
+   *
+   * Each re-arming of the token advances the queue's flush epoch, a
+   * counter maintained by the owning thread that numbers the completed
+   * drain cycles of the queue.
+   *
+   * The intrusive link is a member of T named by the `link` parameter, an
+   * `std::atomic<T*>` field defaulting to `T::next_in_queue`, so one
+   * element type can sit in several queues through distinct link fields.
    */
-  template<class T>
+  template<class T, std::atomic<T*> T::*link = &T::next_in_queue>
   class SPMCQ
   {
   private:
@@ -53,6 +61,10 @@ namespace verona::rt
     static constexpr uintptr_t BIT = 1;
     // Written by a single thread that owns the queue.
     T* back;
+    // Number of times the token has been re-armed, i.e. completed flush
+    // cycles of this queue. Written only by the owning thread (in
+    // `enqueue`), so reading it stays off any contended line.
+    size_t flush_epoch = 0;
     // Multi-threaded end of the "queue" requires ABA protection.
     // Used for work stealing and posting new work from another thread.
     snmalloc::ABA<T> front;
@@ -76,7 +88,7 @@ namespace verona::rt
     explicit SPMCQ(T* token)
     {
       assert(token);
-      token->next_in_queue = nullptr;
+      (token->*link) = nullptr;
       token = set_bit(token);
       back = token;
       front.init(token);
@@ -85,10 +97,12 @@ namespace verona::rt
     void enqueue(Alloc* alloc, T* node)
     {
       UNUSED(alloc);
+      if (is_bit_set(node))
+        flush_epoch++;
       auto unmasked_node = unmask(node);
-      unmasked_node->next_in_queue = nullptr;
+      (unmasked_node->*link) = nullptr;
       auto unmasked_back = unmask(back);
-      unmasked_back->next_in_queue.store(node, std::memory_order_release);
+      (unmasked_back->*link).store(node, std::memory_order_release);
       back = node;
     }
 
@@ -99,7 +113,7 @@ namespace verona::rt
 
       do
       {
-        node->next_in_queue = cmp.ptr();
+        (node->*link) = cmp.ptr();
       } while (!cmp.store_conditional(node));
     }
 
@@ -120,7 +134,7 @@ namespace verona::rt
         fnt = cmp.ptr();
         auto unmasked_fnt = unmask(fnt);
         // This operation is memory safe due to holding the epoch.
-        next = unmasked_fnt->next_in_queue;
+        next = (unmasked_fnt->*link);
 
         if (next == nullptr)
           return nullptr;
@@ -140,7 +154,7 @@ namespace verona::rt
       assert(front.peek() == back);
       assert(is_bit_set(back));
       auto unmasked = unmask(back);
-      assert(unmasked->next_in_queue == nullptr);
+      assert((unmasked->*link) == nullptr);
 
       unmasked->dealloc(alloc);
     }
@@ -149,5 +163,12 @@ namespace verona::rt
     {
       return back == front.peek() && is_bit_set(back);
     }
+
+    /// The number of completed flush cycles of the token through this
+    /// queue. Only meaningful to the owning thread.
+    size_t flush_epochs()
+    {
+      return flush_epoch;
+    }
   };
 } // namespace verona::rt
@@ -0,0 +1,130 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "schedulerstats.h"
+
+#include <iostream>
+#include <snmalloc.h>
+#include <vector>
+
+namespace verona::rt
+{
+  /**
+   * Periodic exporter of scheduler counters.
+   *
+   * While the runtime is running, a sampler thread owned by the thread
+   * pool (see `ThreadPool::set_stats_export`) snapshots every scheduler
+   * thread's `SchedulerStats` once per interval and hands the counters to
+   * `sample`, which turns them into per-interval deltas. Each delta
+   * becomes one fixed-size binary record, appended to a ring of the most
+   * recent records and, when a sink stream was configured, written to it
+   * immediately — e.g. a file or a socket feeding a live dashboard.
+   *
+   * Counter reads are unsynchronised and touch each writer's cache lines
+   * at most once per interval, so the hot path is not perturbed; a stale
+   * or torn value yields a slightly wrong delta in one record, which is
+   * acceptable for monitoring. Records are all zero unless the runtime
+   * was built with USE_SCHED_STATS.
+   */
+  class StatsExporter
+  {
+  public:
+    struct Record
+    {
+      /// TSC at the time the sample was taken.
+      uint64_t tsc;
+      /// `systematic_id` of the sampled scheduler thread.
+      uint32_t thread_id;
+      /// Number of entries in `deltas`, making records self-describing.
+      uint32_t counters;
+      /// Per-counter increments since the previous sample of this
+      /// thread, in `SchedulerStats::snapshot` order.
+      uint64_t deltas[SchedulerStats::SNAPSHOT_COUNTERS];
+    };
+
+  private:
+    /// Records retained in memory. Older records are overwritten, but
+    /// remain available through a configured sink.
+    static constexpr size_t SIZE = 1 << 9;
+    static constexpr size_t MASK = SIZE - 1;
+
+    std::vector<Record> records;
+    size_t index = 0;
+    /// Previous absolute counters of each sampled thread, flattened.
+    std::vector<uint64_t> prev;
+    std::ostream* sink = nullptr;
+
+  public:
+    /// Reset the exporter for a run over `threads` scheduler threads.
+    /// Records are written to `sink_` as they are produced, when not
+    /// null. The ring of a previous run is discarded.
+    void begin(size_t threads, std::ostream* sink_)
+    {
+      records.assign(SIZE, Record());
+      index = 0;
+      prev.assign(threads * SchedulerStats::SNAPSHOT_COUNTERS, 0);
+      sink = sink_;
+    }
+
+    /// Append one delta record for the `slot`th thread, whose current
+    /// absolute counters are in `counters`.
+    void sample(size_t slot, uint32_t thread_id, const uint64_t* counters)
+    {
+      auto& r = records[index & MASK];
+      r.tsc = snmalloc::Aal::tick();
+      r.thread_id = thread_id;
+      r.counters = SchedulerStats::SNAPSHOT_COUNTERS;
+
+      uint64_t* last = &prev[slot * SchedulerStats::SNAPSHOT_COUNTERS];
+      for (size_t i = 0; i < SchedulerStats::SNAPSHOT_COUNTERS; i++)
+      {
+        r.deltas[i] = counters[i] - last[i];
+        last[i] = counters[i];
+      }
+
+      index++;
+
+      if (sink != nullptr)
+      {
+        sink->write((const char*)&r, sizeof(Record));
+        sink->flush();
+      }
+    }
+
+    /// Write the retained ring to a stream as raw binary, oldest record
+    /// first.
+    void dump(std::ostream& o)
+    {
+      auto start = (index >= SIZE) ? index - SIZE : 0;
+
+      for (auto i = start; i < index; i++)
+      {
+        auto& r = records[i & MASK];
+        o.write((const char*)&r, sizeof(Record));
+      }
+    }
+
+    /// Pretty-print the retained ring, oldest record first, showing only
+    /// the counters that moved in each interval.
+    void print(std::ostream& o)
+    {
+      auto start = (index >= SIZE) ? index - SIZE : 0;
+
+      for (auto i = start; i < index; i++)
+      {
+        auto& r = records[i & MASK];
+        o << r.thread_id << " " << r.tsc;
+
+        for (size_t c = 0; c < r.counters; c++)
+        {
+          if (r.deltas[c] != 0)
+            o << " " << SchedulerStats::counter_name(c) << "="
+              << r.deltas[c];
+        }
+
+        o << std::endl;
+      }
+    }
+  };
+} // namespace verona::rt
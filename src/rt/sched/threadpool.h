@@ -2,19 +2,30 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include "behaviourprofiler.h"
 #include "cpu.h"
+#include "iopoller.h"
+#include "statsexporter.h"
 #include "test/systematic.h"
 #include "threadstate.h"
 
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <snmalloc.h>
+#include <thread>
+#include <vector>
 
 namespace verona::rt
 {
   /// Used for default prerun for a thread.
   inline void nop() {}
 
+  /// Assumed cache line size, used to partition the hot fields of the
+  /// scheduler structures. The partitioning is validated by the
+  /// `layout_guards` member of each structure.
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+
   using namespace snmalloc;
   template<class T>
   class ThreadPool
@@ -25,47 +36,227 @@ namespace verona::rt
     static constexpr uint64_t TSC_PAUSE_SLOP = 1'000'000;
     static constexpr uint64_t TSC_UNPAUSE_SLOP = TSC_PAUSE_SLOP / 2;
 
+    // --- Read-mostly configuration --------------------------------------
+    // Set before `run` or only touched on slow paths; kept apart from the
+    // contended counters below so polling them does not bounce lines.
+
     bool detect_leaks = true;
+
+    /// If true, `run` skips the final reference sweeps: cown state,
+    /// message stubs and queue nodes are left to the OS on the assumption
+    /// that the process is about to exit. Ignored in systematic testing
+    /// builds, which always verify a clean shutdown.
+    bool fast_exit = false;
+
     size_t incarnation = 1;
     size_t thread_count = 0;
-    size_t active_thread_count = 0;
+    T* first_thread = nullptr;
+#ifdef USE_SYSTEMATIC_TESTING
+    T* running_thread = nullptr;
+#endif
+
+    bool fair = false;
+
+    /// If true, scheduler threads use a bounded work-stealing deque for
+    /// owner-side scheduling instead of pushing everything through SPMCQ.
+    /// Must be configured before `init`.
+    bool use_ws_deque = false;
+
+    /// If true, steal victims are ordered by CPU topology (same package,
+    /// then same NUMA node, then remote) instead of walking the thread
+    /// ring. Must be configured before `run`.
+    bool topology_stealing = false;
+
+    /// Adaptive idle policy tunables. An idle scheduler thread spins on its
+    /// queue for a budget that doubles from the minimum to the maximum on
+    /// every unproductive wake, takes one shallow (timed) sleep, and only
+    /// then parks fully on the condition variable.
+    uint64_t idle_spin_min_tsc = 1 << 14;
+    uint64_t idle_spin_max_tsc = 1'000'000;
+    uint64_t idle_shallow_sleep_us = 100;
+
+    /// Bounds for the per-thread adaptive fairness period, in TSC ticks
+    /// (see SchedulerThread::fairness_cycle). A zero maximum keeps the
+    /// fixed cadence: a fairness steal on every token round trip.
+    /// Configure before `run`.
+    uint64_t fair_period_min_tsc = 0;
+    uint64_t fair_period_max_tsc = 0;
+
+    /// Cores this instance's threads are pinned to, in thread order,
+    /// reused round-robin when shorter than the thread count. When empty,
+    /// cores are assigned from the topology. Configure before `run` to
+    /// partition cores between colocated instances.
+    std::vector<size_t> cores;
+
+    /// Period of the scheduler-stats exporter, zero when disabled, and
+    /// the stream its binary delta records are written to (may be null:
+    /// records are then only retained in the exporter's ring). Configure
+    /// before `run`; see statsexporter.h.
+    uint64_t stats_export_interval_ms = 0;
+    std::ostream* stats_export_sink = nullptr;
+
+    ThreadState state;
+    Topology topology;
+
+    // --- Cross-thread counters ------------------------------------------
+    // Bumped from arbitrary threads on the message send and LD paths; their
+    // own line keeps that traffic off the configuration above.
 
     /**
      * Number of messages that have been sent that may not be visible to a
      *thread in a Scan state.
      **/
-    std::atomic<size_t> inflight_count = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> inflight_count = 0;
 
-    uint64_t last_unpause_tsc = Aal::tick();
-    std::mutex m;
-    std::condition_variable cv;
     std::atomic_uint64_t barrier_count = 0;
-    T* first_thread = nullptr;
-#ifdef USE_SYSTEMATIC_TESTING
-    T* running_thread = nullptr;
-#endif
 
     /// Count of external event sources, such as I/O, that will prevent
     /// quiescence.
     std::atomic<size_t> external_event_sources = 0;
+
+    // --- Pause/unpause state --------------------------------------------
+    // The mutex, condition variable and the fields they protect.
+
+    alignas(CACHE_LINE_SIZE) std::mutex m;
+    std::condition_variable cv;
+    size_t active_thread_count = 0;
+    uint64_t last_unpause_tsc = Systematic::tick();
     // Pausing if value is odd.
     // Is not atomic, since updates are only made while a lock is held.
     // We are assuming that no partial write will be observed.
     uint32_t runtime_pausing = 0;
     bool teardown_in_progress = false;
 
-    bool fair = false;
+#ifdef USE_SCHED_STATS
+    /// TSC of the schedule that last woke a paused runtime, not yet
+    /// matched with a behaviour execution. Zero when no wake-chain
+    /// measurement is in flight. Written by `unpause` on its success
+    /// paths; consumed by the first scheduler thread to run a behaviour
+    /// afterwards (see `take_wake_chain`).
+    std::atomic<uint64_t> wake_chain_tsc{0};
+#endif
 
-    ThreadState state;
-    Topology topology;
+    /// The IO readiness reactor shared by all scheduler threads; drained
+    /// from their work loops and blocked on by the last thread to pause.
+    IOPoller io;
+
+    /// Periodic exporter of per-thread scheduler counters and its
+    /// sampler thread; see statsexporter.h. The mutex and condition
+    /// variable only pace the sampler, so it can be woken promptly at
+    /// shutdown.
+    StatsExporter stats_exporter;
+    std::thread stats_export_thread;
+    std::mutex stats_export_m;
+    std::condition_variable stats_export_cv;
+    bool stats_export_running = false;
+
+#if defined(__GNUC__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+    /// Compile-time guards for the cache-line partitioning above. The
+    /// call from `init` forces instantiation; the body never runs.
+    static void layout_guards()
+    {
+      static_assert(
+        offsetof(ThreadPool, inflight_count) % CACHE_LINE_SIZE == 0);
+      static_assert(offsetof(ThreadPool, m) % CACHE_LINE_SIZE == 0);
+      // Configuration stays below the contended counters.
+      static_assert(
+        offsetof(ThreadPool, first_thread) <
+        offsetof(ThreadPool, inflight_count));
+      // The cross-thread counters share one line.
+      static_assert(
+        offsetof(ThreadPool, external_event_sources) +
+          sizeof(std::atomic<size_t>) - offsetof(ThreadPool, inflight_count) <=
+        CACHE_LINE_SIZE);
+    }
 
+#ifdef USE_LAYOUT_AUDIT
   public:
-    static ThreadPool<T>& get()
+    /// Print the offset, size and cache line of each member, to audit the
+    /// partitioning when fields are added or reordered.
+    static void dump_layout(std::ostream& o)
+    {
+#  define LAYOUT_ROW(member) \
+    o << "  " << #member << " @" << offsetof(ThreadPool, member) << " +" \
+      << sizeof(((ThreadPool*)nullptr)->member) << " line " \
+      << (offsetof(ThreadPool, member) / CACHE_LINE_SIZE) << std::endl
+      o << "ThreadPool (size " << sizeof(ThreadPool) << ", align "
+        << alignof(ThreadPool) << ")" << std::endl;
+      LAYOUT_ROW(detect_leaks);
+      LAYOUT_ROW(fast_exit);
+      LAYOUT_ROW(incarnation);
+      LAYOUT_ROW(thread_count);
+      LAYOUT_ROW(first_thread);
+      LAYOUT_ROW(fair);
+      LAYOUT_ROW(use_ws_deque);
+      LAYOUT_ROW(topology_stealing);
+      LAYOUT_ROW(state);
+      LAYOUT_ROW(topology);
+      LAYOUT_ROW(inflight_count);
+      LAYOUT_ROW(barrier_count);
+      LAYOUT_ROW(external_event_sources);
+      LAYOUT_ROW(m);
+      LAYOUT_ROW(cv);
+      LAYOUT_ROW(active_thread_count);
+      LAYOUT_ROW(runtime_pausing);
+      LAYOUT_ROW(io);
+      LAYOUT_ROW(stats_exporter);
+#  undef LAYOUT_ROW
+    }
+
+  private:
+#endif
+#if defined(__GNUC__)
+#  pragma GCC diagnostic pop
+#endif
+
+  public:
+    /**
+     * The default runtime instance. Additional instances can be
+     * constructed directly — for example a latency-critical and a batch
+     * runtime with disjoint `set_cores` masks — and bound per thread with
+     * `set_current`. Each instance has its own threads, queues and
+     * configuration; the epoch machinery stays process-wide.
+     */
+    static ThreadPool<T>& default_pool()
     {
       static ThreadPool<T> global_thread_pool;
       return global_thread_pool;
     }
 
+    /**
+     * The calling thread's runtime instance. The static configuration and
+     * scheduling entry points below all act on this, so single-runtime
+     * embedders are unaffected: threads use the default instance until
+     * bound explicitly, and scheduler threads are bound to their owning
+     * pool when they start.
+     */
+    static ThreadPool<T>& get()
+    {
+      auto*& current = current_pool();
+      if (current == nullptr)
+        current = &default_pool();
+      return *current;
+    }
+
+    /// Bind the calling thread to the given runtime instance: subsequent
+    /// scheduling and configuration from this thread target that pool.
+    static void set_current(ThreadPool<T>& pool)
+    {
+      current_pool() = &pool;
+    }
+
+  private:
+    static ThreadPool<T>*& current_pool()
+    {
+      static thread_local ThreadPool<T>* current = nullptr;
+      return current;
+    }
+
+  public:
+
     static void set_detect_leaks(bool b)
     {
       get().detect_leaks = b;
@@ -76,6 +267,29 @@ namespace verona::rt
       return get().detect_leaks;
     }
 
+    /**
+     * Configure fast exit. When set, teardown stops after the stats and
+     * the flight recorder have been flushed, skipping the reference
+     * sweeps and stub collection; remaining memory is left to the OS.
+     * For deployments where `run` is immediately followed by process
+     * exit — leak detection is unavailable in this mode. Systematic
+     * testing builds ignore the setting, so test shutdown stays fully
+     * verified.
+     */
+    static void set_fast_exit(bool b)
+    {
+      get().fast_exit = b;
+    }
+
+    static bool get_fast_exit()
+    {
+#ifdef USE_SYSTEMATIC_TESTING
+      return false;
+#else
+      return get().fast_exit;
+#endif
+    }
+
     static void record_inflight_message()
     {
       Systematic::cout() << "Increase inflight count: "
@@ -98,6 +312,12 @@ namespace verona::rt
       return get().inflight_count == 0;
     }
 
+    /// The pool's IO readiness reactor; see iopoller.h.
+    static IOPoller& io_poller()
+    {
+      return get().io;
+    }
+
     /// Increment the external event source count. A non-zero count will prevent
     /// runtime teardown.
     static void add_external_event_source()
@@ -130,6 +350,70 @@ namespace verona::rt
       s.fair = fair;
     }
 
+    static void set_ws_deque(bool ws_deque)
+    {
+      Systematic::cout() << "Set ws_deque: " << ws_deque << std::endl;
+      auto& s = get();
+      assert(s.thread_count == 0);
+      s.use_ws_deque = ws_deque;
+    }
+
+    static void set_topology_stealing(bool topology)
+    {
+      Systematic::cout() << "Set topology_stealing: " << topology << std::endl;
+      auto& s = get();
+      s.topology_stealing = topology;
+    }
+
+    /// Restrict this runtime's threads to the given cores (see
+    /// `cpu::set_affinity`). Must be configured before `run`.
+    static void set_cores(std::vector<size_t> cores)
+    {
+      auto& s = get();
+      s.cores = std::move(cores);
+    }
+
+    /// Configure the adaptive idle policy. Spin budgets are in TSC ticks,
+    /// the shallow sleep in microseconds.
+    static void
+    set_idle_policy(uint64_t spin_min, uint64_t spin_max, uint64_t shallow_us)
+    {
+      auto& s = get();
+      s.idle_spin_min_tsc = spin_min;
+      s.idle_spin_max_tsc = spin_max;
+      s.idle_shallow_sleep_us = shallow_us;
+    }
+
+    /**
+     * Bound the adaptive fairness period, in TSC ticks, and thereby
+     * enable it: in fair mode each thread then adapts its stealing
+     * cadence to the drain time of its own queue instead of stealing on
+     * every token round trip (see SchedulerThread::fairness_cycle).
+     * A zero maximum restores the fixed cadence.
+     */
+    static void set_fair_period(uint64_t min_tsc, uint64_t max_tsc)
+    {
+      auto& s = get();
+      s.fair_period_min_tsc = min_tsc;
+      s.fair_period_max_tsc = max_tsc;
+    }
+
+    /**
+     * Enable periodic export of scheduler counters: every `interval_ms`
+     * a sampler thread snapshots each scheduler thread's stats and
+     * appends a binary delta record to the exporter's ring and, when
+     * `sink` is not null, to `sink` — e.g. a file or socket stream
+     * feeding a live dashboard. Zero disables the exporter. Configure
+     * before `run`; only meaningful in builds with USE_SCHED_STATS.
+     */
+    static void
+    set_stats_export(uint64_t interval_ms, std::ostream* sink = nullptr)
+    {
+      auto& s = get();
+      s.stats_export_interval_ms = interval_ms;
+      s.stats_export_sink = sink;
+    }
+
     static bool is_teardown_in_progress()
     {
       return get().teardown_in_progress;
@@ -172,6 +456,11 @@ namespace verona::rt
 
       assert(running_thread == me || running_thread == nullptr);
 
+      // Only scheduler threads drive the virtual clock; they are
+      // serialised by the systematic engine, so time advances
+      // deterministically.
+      Systematic::advance_clock();
+
       uint32_t next = Systematic::get_rng().next() & me->systematic_speed_mask;
       if (next == 0 && running_thread != nullptr)
       {
@@ -345,6 +634,8 @@ namespace verona::rt
 
     void init(size_t count)
     {
+      layout_guards();
+
       if ((thread_count != 0) || (count == 0))
         abort();
 
@@ -370,6 +661,13 @@ namespace verona::rt
       t->systematic_speed_mask = (1 << (Systematic::get_rng().next() % 16)) - 1;
 #endif
       t->next = first_thread;
+
+      t = first_thread;
+      do
+      {
+        t->pool = this;
+        t = t->next;
+      } while (t != first_thread);
     }
 
     void run()
@@ -395,10 +693,32 @@ namespace verona::rt
 
       do
       {
-        t->template start<Args...>(topology.get(i++), startup, args...);
+        t->numa_node = topology.numa_node(i);
+        t->package = topology.package(i);
+        size_t core =
+          cores.empty() ? topology.get(i) : cores[i % cores.size()];
+        t->template start<Args...>(core, startup, args...);
+        i++;
         t = t->next;
       } while (t != first_thread);
 
+      if (stats_export_interval_ms != 0)
+      {
+        start_stats_exporter();
+
+        // Join here rather than in the destructors below, so the
+        // sampler never reads the stats of a deleted thread: it keeps
+        // sampling until the last scheduler thread has finished.
+        t = first_thread;
+        do
+        {
+          t->t.join();
+          t = t->next;
+        } while (t != first_thread);
+
+        stop_stats_exporter();
+      }
+
       t = first_thread;
 
       do
@@ -419,9 +739,90 @@ namespace verona::rt
       state.reset<ThreadState::NotInLD>();
       topology.release();
 
+      // Outstanding registrations hold external event sources, so the pool
+      // cannot reach teardown with deliverable completions; this releases
+      // the backend for the next init/run cycle.
+      io.close(ThreadAlloc::get());
+
       Epoch::flush(ThreadAlloc::get());
     }
 
+    /**
+     * Dump the flight-recorder event ring of every scheduler thread.
+     * Intended for use after `run` has returned, or from a crash handler
+     * where torn in-flight events are acceptable.
+     */
+    static void dump_events(std::ostream& o, bool binary = false)
+    {
+      auto* t = get().first_thread;
+
+      if (t == nullptr)
+        return;
+
+      do
+      {
+        if (binary)
+          t->events.dump(o);
+        else
+          t->events.print(o, t->systematic_id);
+        t = t->next;
+      } while (t != get().first_thread);
+    }
+
+    /**
+     * Dump the recorded scheduler-decision trace of every thread, in the
+     * format `SchedulerReplay::load` accepts. Only meaningful after a run
+     * in record mode (see `SchedulerReplay::record`).
+     */
+    static void dump_replay(std::ostream& o)
+    {
+      auto* t = get().first_thread;
+
+      if (t == nullptr)
+        return;
+
+      do
+      {
+        t->replay.dump(o, t->systematic_id);
+        t = t->next;
+      } while (t != get().first_thread);
+    }
+
+    /**
+     * Merge the behaviour-cost samples of every scheduler thread and print
+     * the top `k` behaviour types by accumulated TSC. Intended for use
+     * after `run` has returned.
+     */
+    static void dump_profile(std::ostream& o, size_t k = 10)
+    {
+      auto* t = get().first_thread;
+
+      if (t == nullptr)
+        return;
+
+      BehaviourProfiler merged;
+      do
+      {
+        merged.merge(t->profiler);
+        t = t->next;
+      } while (t != get().first_thread);
+
+      merged.dump_top(o, k);
+    }
+
+    /**
+     * Dump the delta records retained by the stats exporter. Intended
+     * for use after `run` has returned; see statsexporter.h for the
+     * record format.
+     */
+    static void dump_stats_export(std::ostream& o, bool binary = false)
+    {
+      if (binary)
+        get().stats_exporter.dump(o);
+      else
+        get().stats_exporter.print(o);
+    }
+
     static bool debug_not_running()
     {
       return get().active_thread_count == 0;
@@ -433,7 +834,7 @@ namespace verona::rt
       return state.next(s, thread_count);
     }
 
-    bool pause(uint64_t tsc)
+    bool pause(uint64_t tsc, bool shallow = false)
     {
 #ifndef USE_SYSTEMATIC_TESTING
       if ((tsc - last_unpause_tsc) < TSC_PAUSE_SLOP)
@@ -449,22 +850,26 @@ namespace verona::rt
         {
           active_thread_count--;
 #ifdef USE_SYSTEMATIC_TESTING
+          UNUSED(shallow);
           lock.unlock();
           cv_wait();
           lock.lock();
 #else
-          cv.wait(lock);
+          if (shallow)
+            cv.wait_for(
+              lock, std::chrono::microseconds(idle_shallow_sleep_us));
+          else
+            cv.wait(lock);
 #endif
           active_thread_count++;
           Systematic::cout() << "Unpausing" << std::endl;
           return true;
         }
 
-        // TODO: check for pending async IO
         T* t = first_thread;
         do
         {
-          if (!t->q.is_empty())
+          if (!t->is_queue_empty())
           {
 // Something has been scheduled LIFO, and the unpause was missed,
 // restart everybody.
@@ -488,7 +893,7 @@ namespace verona::rt
           t = first_thread;
           do
           {
-            if (!t->q.is_empty())
+            if (!t->is_queue_empty())
             {
               Systematic::cout() << "Still work left" << std::endl;
               runtime_pausing++;
@@ -503,7 +908,20 @@ namespace verona::rt
           } while (t != first_thread);
 
           Systematic::cout() << "Runtime pausing" << std::endl;
-          cv.wait(lock);
+          if (io.pending() != 0)
+          {
+            // Readiness is an event that must wake the runtime and only
+            // the reactor can observe it, so block there rather than on
+            // the cv. `unpause` rings the reactor's wake fd, so cv-style
+            // wakeups are not lost.
+            lock.unlock();
+            io.wait(ThreadAlloc::get());
+            lock.lock();
+          }
+          else
+          {
+            cv.wait(lock);
+          }
 
           Systematic::cout() << "Runtime unpausing" << std::endl;
           runtime_pausing++;
@@ -550,10 +968,14 @@ namespace verona::rt
       uint32_t pausing = runtime_pausing;
       if ((pausing & 1) != 0)
       {
+        mark_wake_chain();
         // Prevent starvation by detecting if the pausing state has changed,
-        // even if it has paused again.
+        // even if it has paused again. The pausing thread may be blocked on
+        // the IO reactor rather than the cv, so ring that too; retrying
+        // covers the window before it publishes that it is sleeping there.
         do
         {
+          io.wake();
 #ifdef USE_SYSTEMATIC_TESTING
           cv_notify_all();
 #else
@@ -566,7 +988,7 @@ namespace verona::rt
       }
 
 #ifndef USE_SYSTEMATIC_TESTING
-      uint64_t now = Aal::tick();
+      uint64_t now = Systematic::tick();
       uint64_t elapsed = now - last_unpause_tsc;
       last_unpause_tsc = now;
 
@@ -581,6 +1003,8 @@ namespace verona::rt
           return false;
       }
 
+      mark_wake_chain();
+
 #ifdef USE_SYSTEMATIC_TESTING
       cv_notify_all();
 #else
@@ -591,6 +1015,82 @@ namespace verona::rt
       return true;
     }
 
+    /// Start a wake-chain latency measurement if none is in flight,
+    /// stamping the time of the schedule that is waking the runtime.
+    void mark_wake_chain()
+    {
+#ifdef USE_SCHED_STATS
+      uint64_t expected = 0;
+      wake_chain_tsc.compare_exchange_strong(
+        expected, Systematic::tick(), std::memory_order_relaxed);
+#endif
+    }
+
+    /// Close the in-flight wake-chain measurement, if any, returning the
+    /// TSC stamped by `mark_wake_chain` or zero. Called by scheduler
+    /// threads before running a behaviour; compiles to a constant when
+    /// stats are off.
+    uint64_t take_wake_chain()
+    {
+#ifdef USE_SCHED_STATS
+      if (wake_chain_tsc.load(std::memory_order_relaxed) == 0)
+        return 0;
+
+      return wake_chain_tsc.exchange(0, std::memory_order_relaxed);
+#else
+      return 0;
+#endif
+    }
+
+    /// Start the stats sampler thread; see `set_stats_export`.
+    void start_stats_exporter()
+    {
+      stats_exporter.begin(thread_count, stats_export_sink);
+      stats_export_running = true;
+
+      stats_export_thread = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(stats_export_m);
+
+        while (stats_export_running)
+        {
+          stats_export_cv.wait_for(
+            lock, std::chrono::milliseconds(stats_export_interval_ms));
+
+          if (stats_export_running)
+            sample_stats();
+        }
+      });
+    }
+
+    /// Append one delta record per scheduler thread to the exporter.
+    void sample_stats()
+    {
+      uint64_t counters[SchedulerStats::SNAPSHOT_COUNTERS];
+      size_t slot = 0;
+      T* t = first_thread;
+
+      do
+      {
+        t->stats.snapshot(counters);
+        stats_exporter.sample(slot++, (uint32_t)t->systematic_id, counters);
+        t = t->next;
+      } while (t != first_thread);
+    }
+
+    /// Stop the sampler thread, then take a final sample so the tail of
+    /// the run is covered. The scheduler threads must have been joined,
+    /// but not yet deleted.
+    void stop_stats_exporter()
+    {
+      {
+        std::unique_lock<std::mutex> lock(stats_export_m);
+        stats_export_running = false;
+      }
+      stats_export_cv.notify_all();
+      stats_export_thread.join();
+      sample_stats();
+    }
+
     void init_barrier()
     {
       barrier_count = thread_count;
@@ -0,0 +1,175 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "../test/systematic.h"
+
+#include <snmalloc.h>
+
+namespace verona::rt
+{
+  using namespace snmalloc;
+
+  class Behaviour;
+
+  /**
+   * Hierarchical timer wheel for per-cown timeouts.
+   *
+   * Each scheduler thread owns one wheel and checks it from its main loop,
+   * so arming a timer is a local list push and a tick is O(1) in the number
+   * of outstanding timers. Timers fire a previously constructed behaviour
+   * on their cown, replacing the sentinel-behaviour pattern which costs a
+   * full message round-trip per timeout.
+   *
+   * The wheel has LEVELS levels of SLOTS slots; a tick is 2^TICK_BITS TSC
+   * cycles (roughly 40us at 3GHz). Level n slots each span SLOTS^n ticks;
+   * entries cascade down a level as time passes, so far-out deadlines cost
+   * one re-link per level rather than a sorted insert.
+   *
+   * All operations are single-threaded: only the owning scheduler thread
+   * arms and advances its wheel.
+   */
+  template<class T>
+  class TimerWheel
+  {
+    struct Entry
+    {
+      Entry* next;
+      uint64_t deadline;
+      T* cown;
+      Behaviour* behaviour;
+    };
+
+    static constexpr size_t TICK_BITS = 17;
+    static constexpr size_t SLOT_BITS = 6;
+    static constexpr size_t SLOTS = 1 << SLOT_BITS;
+    static constexpr size_t LEVELS = 4;
+
+    Entry* slots[LEVELS][SLOTS] = {};
+    /// The tick up to which the wheel has been advanced.
+    uint64_t current_tick = 0;
+    size_t outstanding = 0;
+
+    void link(Entry* e)
+    {
+      auto tick = e->deadline >> TICK_BITS;
+      auto delta = (tick > current_tick) ? tick - current_tick : 0;
+
+      size_t level = 0;
+      while ((level < LEVELS - 1) && (delta >= (SLOTS << (SLOT_BITS * level))))
+        level++;
+
+      auto slot = (tick >> (SLOT_BITS * level)) & (SLOTS - 1);
+      e->next = slots[level][slot];
+      slots[level][slot] = e;
+    }
+
+  public:
+    size_t pending()
+    {
+      return outstanding;
+    }
+
+    /// True if the wheel holds a timer that has already expired.
+    bool expired()
+    {
+      return (outstanding != 0) && ((Systematic::tick() >> TICK_BITS) > current_tick);
+    }
+
+    /**
+     * Arm a timer firing `behaviour` on `cown` once the TSC passes
+     * `deadline`. The caller must hold a reference to the cown for the
+     * lifetime of the timer.
+     */
+    void insert(Alloc* alloc, uint64_t deadline, T* cown, Behaviour* behaviour)
+    {
+      if (current_tick == 0)
+        current_tick = Systematic::tick() >> TICK_BITS;
+
+      auto e = (Entry*)alloc->alloc<sizeof(Entry)>();
+      e->deadline = deadline;
+      e->cown = cown;
+      e->behaviour = behaviour;
+      link(e);
+      outstanding++;
+    }
+
+    /**
+     * Advance the wheel to the current time, firing every expired timer
+     * through `T::fire_timer(alloc, cown, behaviour)` and cascading
+     * longer-range
+     * slots down a level as they are reached.
+     */
+    void advance(Alloc* alloc)
+    {
+      if (outstanding == 0)
+        return;
+
+      auto now_tick = Systematic::tick() >> TICK_BITS;
+
+      while (current_tick < now_tick)
+      {
+        current_tick++;
+
+        for (size_t level = 0; level < LEVELS; level++)
+        {
+          auto slot = (current_tick >> (SLOT_BITS * level)) & (SLOTS - 1);
+          auto e = slots[level][slot];
+          slots[level][slot] = nullptr;
+
+          while (e != nullptr)
+          {
+            auto next = e->next;
+
+            if ((e->deadline >> TICK_BITS) <= current_tick)
+            {
+              T::fire_timer(alloc, e->cown, e->behaviour);
+              alloc->dealloc<sizeof(Entry)>(e);
+              outstanding--;
+            }
+            else
+            {
+              // Not yet due: cascade to the appropriate lower level.
+              link(e);
+            }
+
+            e = next;
+          }
+
+          // Higher levels only need cascading when their slot index
+          // changed with this tick.
+          if ((current_tick & ((1 << (SLOT_BITS * (level + 1))) - 1)) != 0)
+            break;
+        }
+      }
+    }
+
+    /**
+     * Drop all outstanding timers without firing them. Used at thread
+     * teardown; the cown references held by the timers are released
+     * through `T::drop_timer`.
+     */
+    void drop_all(Alloc* alloc)
+    {
+      for (size_t level = 0; level < LEVELS; level++)
+      {
+        for (size_t slot = 0; slot < SLOTS; slot++)
+        {
+          auto e = slots[level][slot];
+          slots[level][slot] = nullptr;
+
+          while (e != nullptr)
+          {
+            auto next = e->next;
+            T::drop_timer(alloc, e->cown, e->behaviour);
+            alloc->dealloc<sizeof(Entry)>(e);
+            outstanding--;
+            e = next;
+          }
+        }
+      }
+
+      assert(outstanding == 0);
+    }
+  };
+} // namespace verona::rt
@@ -0,0 +1,151 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <atomic>
+#include <snmalloc.h>
+
+namespace verona::rt
+{
+  using namespace snmalloc;
+
+  /**
+   * Bounded Chase-Lev work-stealing deque.
+   *
+   * This is an alternative backing store for a scheduler thread's cown
+   * queue. The owning thread pushes and pops at the bottom of the deque
+   * without any read-modify-write operation on the fast path, while
+   * stealing threads compete with a single CAS on the top index. This
+   * removes the shared CAS point that all consumers of SPMCQ contend on
+   * during steal storms.
+   *
+   * Unlike SPMCQ this is not intrusive: elements are stored in a fixed
+   * circular buffer, so no `next_in_queue` field is written and no epoch
+   * needs to be held while stealing. A stolen pointer is only dereferenced
+   * after the CAS on `top` has succeeded, at which point no other thread
+   * can observe it through the deque.
+   *
+   * The deque is bounded; `push` returns false when the buffer is full and
+   * the caller is expected to fall back to an unbounded queue. The
+   * fallback keeps the scheduler correct under pathological fan-out while
+   * the common case stays in the array.
+   *
+   * Memory ordering follows Le, Pop, Cohen and Nardelli, "Correct and
+   * Efficient Work-Stealing for Weak Memory Models" (PPoPP'13). On x86 the
+   * owner-side push/pop compile down to plain loads and stores plus a
+   * single fence in the pop race window.
+   */
+  template<class T>
+  class WSDeque
+  {
+  private:
+    static constexpr size_t CAPACITY = 1 << 16;
+    static constexpr size_t MASK = CAPACITY - 1;
+
+    /// Next slot the owner will push into. Written only by the owner.
+    std::atomic<size_t> bottom = 0;
+    /// Next slot a thief will steal from.
+    std::atomic<size_t> top = 0;
+    /// Circular buffer of scheduled elements.
+    std::atomic<T*>* buffer;
+
+  public:
+    WSDeque()
+    {
+      buffer = (std::atomic<T*>*)ThreadAlloc::get()->alloc(
+        CAPACITY * sizeof(std::atomic<T*>));
+    }
+
+    /**
+     * Owner-side push on to the bottom of the deque. Returns false if the
+     * deque is full; the element has not been enqueued in that case.
+     */
+    bool push(T* node)
+    {
+      size_t b = bottom.load(std::memory_order_relaxed);
+      size_t t = top.load(std::memory_order_acquire);
+
+      if ((b - t) >= CAPACITY)
+        return false;
+
+      buffer[b & MASK].store(node, std::memory_order_relaxed);
+      bottom.store(b + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+     * Owner-side pop from the bottom of the deque. Returns nullptr if the
+     * deque is empty. May race with a thief for the final element.
+     */
+    T* pop()
+    {
+      size_t b = bottom.load(std::memory_order_relaxed);
+      size_t t = top.load(std::memory_order_relaxed);
+
+      if (t >= b)
+        return nullptr;
+
+      b = b - 1;
+      bottom.store(b, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      t = top.load(std::memory_order_relaxed);
+
+      if (t > b)
+      {
+        // Deque was emptied by thieves while we were updating bottom.
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+      }
+
+      T* node = buffer[b & MASK].load(std::memory_order_relaxed);
+
+      if (t == b)
+      {
+        // Single element left: race with any thief for it.
+        if (!top.compare_exchange_strong(
+              t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+          node = nullptr;
+
+        bottom.store(b + 1, std::memory_order_relaxed);
+      }
+
+      return node;
+    }
+
+    /**
+     * Thief-side steal from the top of the deque. Returns nullptr if the
+     * deque appears empty or the steal race was lost.
+     */
+    T* steal()
+    {
+      size_t t = top.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      size_t b = bottom.load(std::memory_order_acquire);
+
+      if (t >= b)
+        return nullptr;
+
+      T* node = buffer[t & MASK].load(std::memory_order_relaxed);
+
+      if (!top.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr;
+
+      return node;
+    }
+
+    bool is_empty()
+    {
+      return top.load(std::memory_order_acquire) >=
+        bottom.load(std::memory_order_acquire);
+    }
+
+    // The caller is expected to guarantee no one is attempting to access
+    // the deque concurrently, and that the deque is empty.
+    void destroy(Alloc* alloc)
+    {
+      assert(is_empty());
+      alloc->dealloc(buffer, CAPACITY * sizeof(std::atomic<T*>));
+    }
+  };
+} // namespace verona::rt
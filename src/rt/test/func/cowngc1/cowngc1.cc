@@ -388,6 +388,10 @@ int main(int argc, char** argv)
   size_t ring = harness.opt.is<size_t>("--ring", 10);
   uint64_t forward = harness.opt.is<uint64_t>("--forward", 10);
 
+  // The behaviours below build regions, so a one-byte threshold makes
+  // every one of them record an allocation alert.
+  Cown::set_alloc_alert(1);
+
   harness.run(test_cown_gc, forward, ring, &harness, &rand);
   harness.run(test_cown_gc_before_sched);
 
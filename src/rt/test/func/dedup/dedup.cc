@@ -0,0 +1,167 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include <test/harness.h>
+#include <verona.h>
+
+using namespace snmalloc;
+using namespace verona::rt;
+
+/**
+ * Checks the interning cache (ImmutableDedup): equal graphs share one
+ * canonical copy, while graphs that differ only in a primitive field
+ * value or in which slot holds a null are kept distinct, and graphs with
+ * a descriptor lacking trace_slots are refused rather than compared
+ * through their lossy value trace.
+ */
+
+struct C1 : public V<C1>
+{
+  C1* f1 = nullptr;
+  C1* f2 = nullptr;
+  size_t value = 0;
+
+  void trace(ObjectStack& st) const
+  {
+    if (f1 != nullptr)
+      st.push(f1);
+
+    if (f2 != nullptr)
+      st.push(f2);
+  }
+
+  void trace_slots(SlotStack& st)
+  {
+    if (f1 != nullptr)
+      st.push((Object**)&f1);
+
+    if (f2 != nullptr)
+      st.push((Object**)&f2);
+  }
+};
+
+// Same shape as C1, but without trace_slots: its value trace cannot be
+// compared losslessly, so the cache must refuse it.
+struct C2 : public V<C2>
+{
+  C2* f1 = nullptr;
+  size_t value = 0;
+
+  void trace(ObjectStack& st) const
+  {
+    if (f1 != nullptr)
+      st.push(f1);
+  }
+};
+
+// A frozen two-object graph: root{value} -> child{value + 1}, with the
+// child hung off f1 or f2.
+C1* make_graph(Alloc* alloc, size_t value, bool use_f2 = false)
+{
+  C1* r = new (alloc) C1;
+  C1* c = new (alloc, r) C1;
+  if (use_f2)
+    r->f2 = c;
+  else
+    r->f1 = c;
+  r->value = value;
+  c->value = value + 1;
+
+  Freeze::apply(alloc, r);
+  return r;
+}
+
+void test_equal_graphs_share()
+{
+  auto* alloc = ThreadAlloc::get();
+
+  C1* g1 = make_graph(alloc, 42);
+  C1* g2 = make_graph(alloc, 42);
+
+  auto* o1 = ImmutableDedup::intern(alloc, g1);
+  check(o1 == g1);
+
+  // g2 is equal: it is released and the canonical root returned.
+  auto* o2 = ImmutableDedup::intern(alloc, g2);
+  check(o2 == g1);
+
+  Immutable::release(alloc, o1);
+  Immutable::release(alloc, o2);
+  ImmutableDedup::clear(alloc);
+  snmalloc::current_alloc_pool()->debug_check_empty();
+}
+
+void test_differing_primitive()
+{
+  auto* alloc = ThreadAlloc::get();
+
+  // Identical shape, but the child's primitive field differs; the value
+  // trace never surfaces it, so only payload comparison tells them
+  // apart.
+  C1* g1 = make_graph(alloc, 1);
+  C1* g2 = make_graph(alloc, 2);
+
+  C1* o1 = (C1*)ImmutableDedup::intern(alloc, g1);
+  C1* o2 = (C1*)ImmutableDedup::intern(alloc, g2);
+  check(o1 == g1);
+  check(o2 == g2);
+  check(o1->value == 1);
+  check(o2->value == 2);
+
+  Immutable::release(alloc, o1);
+  Immutable::release(alloc, o2);
+  ImmutableDedup::clear(alloc);
+  snmalloc::current_alloc_pool()->debug_check_empty();
+}
+
+void test_shifted_null()
+{
+  auto* alloc = ThreadAlloc::get();
+
+  // The same child in a different slot: the value trace pushes the same
+  // sequence for both, but the null sits in a different field.
+  C1* g1 = make_graph(alloc, 7, /*use_f2=*/false);
+  C1* g2 = make_graph(alloc, 7, /*use_f2=*/true);
+
+  C1* o1 = (C1*)ImmutableDedup::intern(alloc, g1);
+  C1* o2 = (C1*)ImmutableDedup::intern(alloc, g2);
+  check(o1 == g1);
+  check(o2 == g2);
+  check(o1->f1 != nullptr && o1->f2 == nullptr);
+  check(o2->f1 == nullptr && o2->f2 != nullptr);
+
+  Immutable::release(alloc, o1);
+  Immutable::release(alloc, o2);
+  ImmutableDedup::clear(alloc);
+  snmalloc::current_alloc_pool()->debug_check_empty();
+}
+
+void test_lossy_descriptor()
+{
+  auto* alloc = ThreadAlloc::get();
+
+  C2* g1 = new (alloc) C2;
+  C2* g2 = new (alloc) C2;
+  Freeze::apply(alloc, g1);
+  Freeze::apply(alloc, g2);
+
+  // C2 has no trace_slots: even byte-identical graphs are returned
+  // unchanged and nothing is cached.
+  auto* o1 = ImmutableDedup::intern(alloc, g1);
+  auto* o2 = ImmutableDedup::intern(alloc, g2);
+  check(o1 == g1);
+  check(o2 == g2);
+
+  Immutable::release(alloc, o1);
+  Immutable::release(alloc, o2);
+  ImmutableDedup::clear(alloc);
+  snmalloc::current_alloc_pool()->debug_check_empty();
+}
+
+int main(int, char**)
+{
+  test_equal_graphs_share();
+  test_differing_primitive();
+  test_shifted_null();
+  test_lossy_descriptor();
+  return 0;
+}
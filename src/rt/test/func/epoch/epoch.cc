@@ -0,0 +1,53 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include <test/harness.h>
+#include <verona.h>
+
+using namespace snmalloc;
+using namespace verona::rt;
+
+/**
+ * Checks the epoch bulk-defer batching hint: a burst of deferred frees
+ * inside an Epoch::BulkDefer scope triggers no global epoch advances,
+ * one advance attempt covers the burst at scope exit, and everything
+ * deferred is reclaimed once the epoch is flushed.
+ */
+
+void test_bulk_defer()
+{
+  auto* alloc = ThreadAlloc::get();
+
+  // Well past the advance heuristic's threshold, so without the scope
+  // this burst would advance repeatedly.
+  static constexpr size_t BURST = 1000;
+
+  size_t local_before, global_before;
+  Epoch::advance_stats(local_before, global_before);
+
+  {
+    Epoch::BulkDefer defer(alloc);
+
+    for (size_t i = 0; i < BURST; i++)
+    {
+      Epoch e(alloc);
+      e.delete_in_epoch(alloc->alloc(16));
+    }
+
+    size_t local_mid, global_mid;
+    Epoch::advance_stats(local_mid, global_mid);
+    check(global_mid == global_before);
+  }
+
+  size_t local_after, global_after;
+  Epoch::advance_stats(local_after, global_after);
+  check(global_after > global_before);
+
+  // Drain the remaining epochs so the deferred frees complete.
+  Epoch::flush(alloc);
+}
+
+int main(int, char**)
+{
+  test_bulk_defer();
+  return 0;
+}
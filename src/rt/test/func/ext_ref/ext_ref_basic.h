@@ -194,11 +194,39 @@ namespace ext_ref_basic
     snmalloc::current_alloc_pool()->debug_check_empty();
   }
 
+  template<RegionType region_type>
+  void batch_release_test()
+  {
+    auto* alloc = ThreadAlloc::get();
+
+    auto r = new (alloc) R<region_type>;
+    auto r2 = new (alloc, r) R<region_type>;
+    auto region = Region::get(r);
+
+    // A batch of refs, with aliases: repeated creates return the same
+    // ExternalRef with its count bumped.
+    ExternalRef* refs[5];
+    refs[0] = ExternalRef::create(region, r);
+    refs[1] = ExternalRef::create(region, r2);
+    refs[2] = ExternalRef::create(region, r);
+    refs[3] = ExternalRef::create(region, r2);
+    refs[4] = ExternalRef::create(region, r2);
+    check(refs[0] == refs[2]);
+    check(refs[1] == refs[3]);
+
+    ExternalRef::release_batch(alloc, refs, 5);
+    Region::release(alloc, r);
+
+    snmalloc::current_alloc_pool()->debug_check_empty();
+  }
+
   void run_test()
   {
     basic_test();
     singleton_region_test<RegionType::Trace>();
     singleton_region_test<RegionType::Arena>();
+    batch_release_test<RegionType::Trace>();
+    batch_release_test<RegionType::Arena>();
   }
 
   void run_all()
@@ -0,0 +1,67 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+
+// Runs the fairness workload with the adaptive fairness period enabled
+// (see SchedulerThread::fairness_cycle). Tight bounds make the defer,
+// steal and overdue-force decisions all reachable; the harness's
+// systematic seeds check that the tick-driven decisions terminate and
+// shut down cleanly. The harness enables fair mode on odd seeds, so the
+// adaptive and the plain path are both covered.
+#include <test/harness.h>
+
+static constexpr int start_count = 100;
+struct A : public VCown<A>
+{
+  int count = start_count;
+};
+
+struct Loop : public VBehaviour<Loop>
+{
+  A* a;
+  Loop(A* a) : a(a) {}
+
+  void f()
+  {
+    if (a->count == 0)
+      return;
+
+    a->count--;
+    Cown::schedule<Loop>(a, a);
+  }
+};
+
+struct B : public VCown<B>
+{};
+
+struct Spawn : public VBehaviour<Spawn>
+{
+  void f()
+  {
+    auto* alloc = ThreadAlloc::get();
+    (void)alloc;
+    for (int i = 0; i < 6; ++i)
+    {
+      auto a = new A;
+      Cown::schedule<Loop>(a, a);
+      Cown::release(alloc, a);
+    }
+  }
+};
+
+void basic_test()
+{
+  auto* alloc = ThreadAlloc::get();
+
+  auto b = new B;
+  Cown::schedule<Spawn>(b);
+
+  Cown::release(alloc, b);
+}
+
+int main(int argc, char** argv)
+{
+  SystematicTestHarness harness(argc, argv);
+  Scheduler::set_fair_period(1 << 10, 1 << 20);
+  harness.run(basic_test);
+  return 0;
+}
@@ -0,0 +1,50 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include <test/harness.h>
+
+/**
+ * Exercises the fast-exit teardown mode (Scheduler::set_fast_exit): all
+ * scheduled work must still run to completion, and `run` must return
+ * cleanly without the final sweeps. Systematic testing builds ignore the
+ * setting, so there this runs the normal, fully verified teardown; in
+ * concurrent builds the skipped sweeps leave memory behind, so leak
+ * checking is disabled.
+ */
+
+static constexpr size_t cown_count = 64;
+static std::atomic<size_t> ran = 0;
+
+struct C : public VCown<C>
+{};
+
+struct Work : public VBehaviour<Work>
+{
+  void f()
+  {
+    ran++;
+  }
+};
+
+void test_fast_exit()
+{
+  ran = 0;
+
+  for (size_t i = 0; i < cown_count; i++)
+  {
+    auto* c = new C;
+    Cown::schedule<Work, YesTransfer>(c, c);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  SystematicTestHarness harness(argc, argv);
+
+  Scheduler::set_fast_exit(true);
+  harness.detect_leaks = false;
+
+  harness.run(test_fast_exit);
+
+  check(ran == cown_count);
+  return 0;
+}
@@ -127,6 +127,65 @@ public:
   }
 };
 
+template<RegionType region_type>
+class D1 : public V<D1<region_type>, region_type>
+{
+public:
+  D1()
+  {
+    live_count++;
+  }
+
+  ~D1()
+  {
+    live_count--;
+  }
+};
+
+/**
+ * Arena teardown is driven by per-region counts of finaliser- and
+ * destructor-bearing descriptors: a pass whose count is zero is skipped
+ * outright. Check the skipped passes drop no work: destructors still run
+ * with no finalisers present, finalisers still run after being merged
+ * into a region that had none, and an all-trivial region releases clean.
+ **/
+void counts_test()
+{
+  constexpr RegionType region_type = RegionType::Arena;
+  using C = C1<region_type>;
+  using D = D1<region_type>;
+  using F = F1<region_type>;
+
+  Alloc* alloc = ThreadAlloc::get();
+
+  // All-trivial region: teardown runs neither pass.
+  auto a = new C;
+  a->f1 = new (a) C;
+  a->f2 = new (a) C;
+  Region::release(alloc, a);
+
+  // Destructor-only region: the finaliser pass is skipped, destructors
+  // must still run.
+  auto b = new D;
+  new (b) D;
+  new (b) D;
+  Region::release(alloc, b);
+  check(live_count == 0);
+
+  // Merging carries the counts with the objects: the finalisers
+  // allocated in `d` must run when the combined region is released
+  // through `c`, which had none of its own.
+  auto c = new C;
+  auto d = new F;
+  new (d) F;
+  RegionArena::merge(alloc, c, d);
+  new (c) F;
+  Region::release(alloc, c);
+  check(live_count == 0);
+
+  snmalloc::current_alloc_pool()->debug_check_empty();
+}
+
 template<RegionType region_type>
 void basic_test()
 {
@@ -186,5 +245,6 @@ int main(int, char**)
 {
   basic_test<RegionType::Trace>();
   basic_test<RegionType::Arena>();
+  counts_test();
   return live_count;
 }
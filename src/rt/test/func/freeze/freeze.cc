@@ -349,6 +349,47 @@ void test_two_rings_2()
   snmalloc::current_alloc_pool()->debug_check_empty();
 }
 
+void test_incremental()
+{
+  // Drive a freeze one object at a time, as an owning cown interleaving
+  // a large freeze with message processing would, and check the result
+  // matches a one-shot freeze.
+  auto* alloc = ThreadAlloc::get();
+
+  C1* r = new (alloc) C1;
+  r->f1 = new (alloc, r) C1;
+  r->f1->f1 = new (alloc, r) C1;
+  r->f1->f1->f1 = r;
+  // Garbage object, collected by the freeze.
+  new (alloc, r) C1;
+  // Nested region, frozen after the root region.
+  r->f1->f2 = new (alloc) C1;
+
+  auto estimate = Freeze::estimate(r);
+  check(estimate.objects == 4);
+  check(estimate.bytes >= 4 * sizeof(C1));
+
+  FreezeIncremental freeze(alloc, r);
+  size_t steps = 0;
+  while (!freeze.step(1))
+    steps++;
+  check(freeze.done());
+  // At least one slice per object the estimate predicted.
+  check(steps >= estimate.objects);
+
+  auto rr = r->debug_immutable_root();
+  UNUSED(rr);
+  check(rr->debug_test_rc(1));
+  check(r->f1->debug_immutable_root() == rr);
+  check(r->f1->f1->debug_immutable_root() == rr);
+  check(r->f1->f2->debug_immutable_root()->debug_test_rc(1));
+
+  // Free immutable graph.
+  Immutable::release(alloc, r);
+
+  snmalloc::current_alloc_pool()->debug_check_empty();
+}
+
 void test_random(size_t seed = 1, size_t max_edges = 128)
 {
   snmalloc::current_alloc_pool()->debug_check_empty();
@@ -501,6 +542,7 @@ int main(int, char**)
   test_two_rings_1();
   test_two_rings_2();
   freeze_weird_ring();
+  test_incremental();
 
   for (size_t i = 1; i < 10000; i++)
   {
@@ -0,0 +1,151 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include <sstream>
+#include <test/harness.h>
+#include <verona.h>
+
+using namespace snmalloc;
+using namespace verona::rt;
+
+/**
+ * Checks the frozen-graph image (RegionImage): a graph survives a
+ * save/load round trip with its values, sharing and cycles intact, a
+ * graph with a descriptor outside the table refuses to save, and a
+ * malformed stream refuses to load.
+ */
+
+struct C1 : public V<C1>
+{
+  C1* f1 = nullptr;
+  C1* f2 = nullptr;
+  size_t value = 0;
+
+  void trace(ObjectStack& st) const
+  {
+    if (f1 != nullptr)
+      st.push(f1);
+
+    if (f2 != nullptr)
+      st.push(f2);
+  }
+
+  void trace_slots(SlotStack& st)
+  {
+    if (f1 != nullptr)
+      st.push((Object**)&f1);
+
+    if (f2 != nullptr)
+      st.push((Object**)&f2);
+  }
+};
+
+// A second descriptor, deliberately left out of the table in the
+// failure test.
+struct C2 : public V<C2>
+{
+  C1* f1 = nullptr;
+
+  void trace(ObjectStack& st) const
+  {
+    if (f1 != nullptr)
+      st.push(f1);
+  }
+
+  void trace_slots(SlotStack& st)
+  {
+    if (f1 != nullptr)
+      st.push((Object**)&f1);
+  }
+};
+
+void test_round_trip()
+{
+  auto* alloc = ThreadAlloc::get();
+
+  // A diamond with a back edge:
+  //   r -> a, b; a -> c; b -> c; c -> r
+  C1* r = new (alloc) C1;
+  C1* a = new (alloc, r) C1;
+  C1* b = new (alloc, r) C1;
+  C1* c = new (alloc, r) C1;
+  r->f1 = a;
+  r->f2 = b;
+  a->f1 = c;
+  b->f1 = c;
+  c->f1 = r;
+  r->value = 1;
+  a->value = 2;
+  b->value = 3;
+  c->value = 4;
+
+  Freeze::apply(alloc, r);
+
+  const Descriptor* descs[] = {C1::desc()};
+  std::stringstream img;
+  check(RegionImage::save(alloc, r, descs, 1, img));
+
+  C1* f = (C1*)RegionImage::load(alloc, descs, 1, img);
+  check(f != nullptr);
+  check(f != r);
+  check(f->debug_is_immutable());
+
+  // Values, sharing, the cycle and the SCC all survive the round trip.
+  check(f->value == 1);
+  check(f->f1->value == 2);
+  check(f->f2->value == 3);
+  check(f->f1->f1 == f->f2->f1);
+  check(f->f1->f1->value == 4);
+  check(f->f1->f1->f1 == f);
+  check(f->f1->f1->debug_immutable_root() == f->debug_immutable_root());
+  check(f->debug_immutable_root()->debug_test_rc(1));
+
+  Immutable::release(alloc, r);
+  Immutable::release(alloc, f);
+  snmalloc::current_alloc_pool()->debug_check_empty();
+}
+
+void test_unsaveable()
+{
+  auto* alloc = ThreadAlloc::get();
+
+  C2* r = new (alloc) C2;
+  r->f1 = new (alloc, r) C1;
+  Freeze::apply(alloc, r);
+
+  // C2 is not in the table: the save must fail.
+  const Descriptor* descs[] = {C1::desc()};
+  std::stringstream img;
+  check(!RegionImage::save(alloc, r, descs, 1, img));
+
+  Immutable::release(alloc, r);
+  snmalloc::current_alloc_pool()->debug_check_empty();
+}
+
+void test_malformed()
+{
+  auto* alloc = ThreadAlloc::get();
+  const Descriptor* descs[] = {C1::desc()};
+
+  std::stringstream empty;
+  check(RegionImage::load(alloc, descs, 1, empty) == nullptr);
+
+  std::stringstream junk("not an image at all");
+  check(RegionImage::load(alloc, descs, 1, junk) == nullptr);
+
+  // A valid header claiming 2^35 objects, then nothing: the count must
+  // not be trusted before the records parse.
+  std::stringstream huge;
+  huge.write("VRI1\x01", 5);
+  huge.write("\x80\x80\x80\x80\x80\x01", 6);
+  check(RegionImage::load(alloc, descs, 1, huge) == nullptr);
+
+  snmalloc::current_alloc_pool()->debug_check_empty();
+}
+
+int main(int, char**)
+{
+  test_round_trip();
+  test_unsaveable();
+  test_malformed();
+  return 0;
+}
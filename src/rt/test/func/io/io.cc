@@ -0,0 +1,79 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include <test/harness.h>
+
+#ifdef _WIN32
+// The IO reactor has no Windows backend yet.
+int main(int, char**)
+{
+  return 0;
+}
+#else
+#  include <cstring>
+#  include <sys/socket.h>
+#  include <unistd.h>
+
+struct Reader : public VCown<Reader>
+{
+  int fds[2];
+};
+
+struct Ready : public VBehaviour<Ready>
+{
+  Reader* reader;
+
+  Ready(Reader* reader) : reader(reader) {}
+
+  void f()
+  {
+    char buf[8] = {};
+    auto n = read(reader->fds[0], buf, sizeof(buf));
+    check(n == 4);
+    check(memcmp(buf, "ping", 4) == 0);
+    logger::cout() << "Read completed on cown " << reader << std::endl;
+    close(reader->fds[0]);
+    close(reader->fds[1]);
+  }
+};
+
+Reader* make_reader()
+{
+  auto* reader = new Reader;
+  check(socketpair(AF_UNIX, SOCK_STREAM, 0, reader->fds) == 0);
+  return reader;
+}
+
+/// Data is already available when the registration is made.
+void test_immediate()
+{
+  auto* reader = make_reader();
+  check(write(reader->fds[1], "ping", 4) == 4);
+  check(Cown::schedule_on_ready<Ready>(
+    reader->fds[0], IOPoller::Event::Read, reader, reader));
+  Cown::release(ThreadAlloc::get(), reader);
+}
+
+/// Readiness arrives from outside while the runtime is quiescent; the
+/// pending registration must keep it alive and wake it.
+void test_delayed()
+{
+  auto* reader = make_reader();
+  int wfd = reader->fds[1];
+  check(Cown::schedule_on_ready<Ready>(
+    reader->fds[0], IOPoller::Event::Read, reader, reader));
+  Cown::release(ThreadAlloc::get(), reader);
+
+  std::thread([wfd]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    check(write(wfd, "ping", 4) == 4);
+  }).detach();
+}
+
+int main(int argc, char** argv)
+{
+  SystematicTestHarness harness(argc, argv);
+  harness.run(test_immediate);
+  harness.run(test_delayed);
+  return 0;
+}
+#endif
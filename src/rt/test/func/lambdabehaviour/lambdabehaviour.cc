@@ -0,0 +1,73 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include <test/harness.h>
+
+#include <memory>
+#include <vector>
+
+/**
+ * Tests for VLambdaBehaviour / schedule_lambda: captures are moved into
+ * the behaviour allocation, never copied.
+ */
+
+static std::atomic<size_t> ran = 0;
+
+struct C : public VCown<C>
+{};
+
+/// A multi-KB capture must be moved: the heap buffer observed inside the
+/// behaviour is the same one the caller filled.
+void test_move_capture()
+{
+  auto* alloc = ThreadAlloc::get();
+  auto* c = new C;
+
+  std::vector<uint8_t> buf(4096, 0x5a);
+  auto* expect = buf.data();
+
+  auto fn = [buf = std::move(buf), expect]() {
+    check(buf.data() == expect);
+    check(buf[0] == 0x5a);
+    ran++;
+  };
+
+  schedule_lambda(c, std::move(fn));
+  Cown::release(alloc, c);
+}
+
+/// A move-only capture compiles only if no copy is ever made.
+void test_move_only_capture()
+{
+  auto* c = new C;
+
+  schedule_lambda<YesTransfer>(c, [p = std::make_unique<size_t>(7)]() {
+    check(*p == 7);
+    ran++;
+  });
+}
+
+/// Multi-cown scheduling takes the same move-only path.
+void test_multi_cown()
+{
+  auto* alloc = ThreadAlloc::get();
+  Cown* cowns[2] = {new C, new C};
+
+  schedule_lambda(2, cowns, [p = std::make_unique<size_t>(9)]() {
+    check(*p == 9);
+    ran++;
+  });
+
+  Cown::release(alloc, cowns[0]);
+  Cown::release(alloc, cowns[1]);
+}
+
+int main(int argc, char** argv)
+{
+  SystematicTestHarness harness(argc, argv);
+  ran = 0;
+  harness.run(test_move_capture);
+  harness.run(test_move_only_capture);
+  harness.run(test_multi_cown);
+  check(ran != 0);
+  return 0;
+}
@@ -148,9 +148,61 @@ namespace memory_alloc
     }
   }
 
+  /**
+   * Tests the batch allocation cursor on an arena region: a small batch in
+   * one arena, a batch spanning multiple arenas that allocates past its
+   * count hint, and the large object ring fallback.
+   **/
+  void test_alloc_batch()
+  {
+    using C = C1<RegionType::Arena>;
+    using MF = MediumF2<RegionType::Arena>;
+    using XF = XLargeF2<RegionType::Arena>;
+
+    auto* alloc = ThreadAlloc::get();
+    C* o = new (alloc) C;
+
+    // Small objects: one capacity check for the whole batch.
+    {
+      auto cur = RegionArena::alloc_batch(o, C::desc(), 64);
+      for (size_t i = 0; i < 64; i++)
+        ::new ((void*)cur.alloc(alloc)) C;
+    }
+
+    // Medium objects spanning several arenas, allocating one more object
+    // than the count hint.
+    {
+      auto cur = RegionArena::alloc_batch(o, MF::desc(), 2);
+      for (size_t i = 0; i < 3; i++)
+        ::new ((void*)cur.alloc(alloc)) MF;
+    }
+
+    // Objects too large for any arena fall back to the large object ring.
+    {
+      auto cur = RegionArena::alloc_batch(o, XF::desc(), 2);
+      for (size_t i = 0; i < 2; i++)
+        ::new ((void*)cur.alloc(alloc)) XF;
+    }
+
+    check(live_count == 5);
+
+    size_t count = 0;
+    RegionArena* reg = RegionArena::get(o);
+    for (auto b = reg->begin(); b != reg->end(); ++b)
+      count++;
+    check(count == 1 + 64 + 3 + 2);
+    check(Region::object_count(o) == count);
+    check(Region::memory_used(o) >= count * sizeof(C));
+
+    Region::release(alloc, o);
+    snmalloc::current_alloc_pool()->debug_check_empty();
+    check(live_count == 0);
+  }
+
   void run_test()
   {
     test_alloc<RegionType::Trace>();
     test_alloc<RegionType::Arena>();
+    test_alloc_batch();
   }
 }
\ No newline at end of file
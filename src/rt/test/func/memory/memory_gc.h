@@ -24,8 +24,11 @@ namespace memory_gc
   {
     alloc_in_region<T...>(alloc, o);
     check(Region::debug_size(o) == 1 + sizeof...(T)); // o + T...
+    check(Region::object_count(o) == 1 + sizeof...(T));
     RegionTrace::gc(alloc, o);
     check(Region::debug_size(o) == 1); // only o is left
+    check(Region::object_count(o) == 1);
+    check(Region::memory_used(o) == o->size());
   }
 
   /**
@@ -355,6 +358,57 @@ namespace memory_gc
     snmalloc::current_alloc_pool()->debug_check_empty();
   }
 
+  /**
+   * Minor collections: nursery garbage is collected, the old generation is
+   * left alone, and the store barrier keeps nursery objects alive that are
+   * only reachable from the old generation.
+   **/
+  void test_minor()
+  {
+    auto* alloc = ThreadAlloc::get();
+    auto* o = new (alloc) C;
+
+    // Build an old generation: a full collection promotes the survivors.
+    auto* old1 = new (alloc, o) C;
+    auto* old2 = new (alloc, o) C;
+    o->f1 = old1;
+    old1->f1 = old2;
+    new (alloc, o) C; // garbage
+    check(Region::debug_size(o) == 4);
+    RegionTrace::gc(alloc, o);
+    check(Region::debug_size(o) == 3);
+
+    // Nursery garbage, in both rings, is collected by a minor collection.
+    new (alloc, o) C;
+    new (alloc, o) F;
+    check(Region::debug_size(o) == 5);
+    RegionTrace::gc_minor(alloc, o);
+    check(Region::debug_size(o) == 3);
+
+    // Nursery survivors are kept: one reachable from the iso directly, one
+    // reachable only from the old generation via the store barrier.
+    auto* y1 = new (alloc, o) C;
+    auto* y2 = new (alloc, o) C;
+    o->f2 = y1;
+    old2->f1 = y2;
+    RegionTrace::store_barrier(alloc, o, y2);
+    new (alloc, o) C; // garbage
+    check(Region::debug_size(o) == 6);
+    RegionTrace::gc_minor(alloc, o);
+    check(Region::debug_size(o) == 5);
+
+    // The survivors were promoted: dropping the old reference to y2 leaves
+    // it for the next full collection, as minor ones no longer examine it.
+    old2->f1 = nullptr;
+    RegionTrace::gc_minor(alloc, o);
+    check(Region::debug_size(o) == 5);
+    RegionTrace::gc(alloc, o);
+    check(Region::debug_size(o) == 4);
+
+    Region::release(alloc, o);
+    snmalloc::current_alloc_pool()->debug_check_empty();
+  }
+
   /**
    * Run a GC after merging two regions. We'll also throw in a swap root.
    **/
@@ -406,6 +460,64 @@ namespace memory_gc
     snmalloc::current_alloc_pool()->debug_check_empty();
   }
 
+  /**
+   * Split a subgraph out of a region, work on both halves independently,
+   * then merge them back together and GC.
+   **/
+  void test_split()
+  {
+    auto* alloc = ThreadAlloc::get();
+
+    // An immutable the subgraph will reference.
+    Cx* imm = new (alloc) Cx;
+    Freeze::apply(alloc, imm);
+    check(imm->debug_test_rc(1));
+
+    // Build a region with a subgraph hanging off r->f1, using both rings
+    // on both sides of the cut.
+    auto* r = new (alloc) Cx;
+    r->c1 = new (alloc, r) Cx;
+    r->f2 = new (alloc, r) Fx;
+    auto* s = new (alloc, r) Fx;
+    r->f1 = s;
+    s->c1 = new (alloc, r) Cx;
+    s->f1 = new (alloc, r) Fx;
+    s->c1->f1 = s; // cycle back to the subgraph root
+    s->c2 = imm;
+    check(Region::debug_size(r) == 6);
+
+    // Split the subgraph out; r->f1 is now a subregion edge, and the new
+    // region's remembered set holds its own count on the immutable.
+    RegionTrace::split(alloc, r, s);
+    check(s->debug_is_iso());
+    check(Region::debug_size(r) == 3);
+    check(Region::debug_size(s) == 3);
+    check(Region::object_count(r) == 3);
+    check(Region::object_count(s) == 3);
+    check(imm->debug_test_rc(2));
+
+    // The two halves can now be worked on independently.
+    alloc_in_region<Cx, Fx>(alloc, r); // unreachable
+    s->f2 = new (alloc, s) Fx;
+    RegionTrace::gc(alloc, r);
+    check(Region::debug_size(r) == 3);
+    RegionTrace::gc(alloc, s);
+    check(Region::debug_size(s) == 4);
+    check(imm->debug_test_rc(2));
+
+    // Merge the subgraph back; r->f1 still points at s.
+    RegionTrace::merge(alloc, r, s);
+    check(!s->debug_is_iso());
+    check(Region::debug_size(r) == 7);
+    RegionTrace::gc(alloc, r);
+    check(Region::debug_size(r) == 7);
+
+    Immutable::release(alloc, imm);
+    check(imm->debug_test_rc(1));
+    Region::release(alloc, r);
+    snmalloc::current_alloc_pool()->debug_check_empty();
+  }
+
   /**
    * Run GC after swap root operations.
    **/
@@ -535,7 +647,9 @@ namespace memory_gc
     test_linked_list();
     test_freeze();
     test_cycles();
+    test_minor();
     test_merge();
+    test_split();
     test_swap_root();
   }
 }
\ No newline at end of file
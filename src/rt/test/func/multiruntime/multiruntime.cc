@@ -0,0 +1,70 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include <test/harness.h>
+
+/**
+ * Tests for multi-instance runtimes (ThreadPool::set_current): a second
+ * scheduler instance with its own threads and core mask runs work to
+ * completion while the default instance is initialised, and cowns bind
+ * to the instance that runs them.
+ */
+
+static std::atomic<size_t> batch_ran = 0;
+static std::atomic<size_t> latency_ran = 0;
+
+struct C : public VCown<C>
+{};
+
+struct Work : public VBehaviour<Work>
+{
+  std::atomic<size_t>* counter;
+
+  Work(std::atomic<size_t>* counter) : counter(counter) {}
+
+  void f()
+  {
+    (*counter)++;
+  }
+};
+
+void test_two_runtimes()
+{
+  batch_ran = 0;
+  latency_ran = 0;
+
+  // Work for the default (latency) instance; it runs when the harness
+  // starts the default scheduler after this function returns.
+  for (size_t i = 0; i < 8; i++)
+  {
+    auto* c = new C;
+    Cown::schedule<Work, YesTransfer>(c, &latency_ran);
+  }
+
+  // A separate batch instance, pinned to its own core, scheduled and run
+  // to completion here.
+  Scheduler batch;
+  Scheduler::set_current(batch);
+  Scheduler::set_cores({0});
+  batch.init(2);
+
+  for (size_t i = 0; i < 8; i++)
+  {
+    auto* c = new C;
+    Cown::schedule<Work, YesTransfer>(c, &batch_ran);
+  }
+
+  batch.run();
+  check(batch_ran == 8);
+  check(latency_ran == 0);
+
+  // Rebind this thread to the default instance.
+  Scheduler::set_current(Scheduler::default_pool());
+}
+
+int main(int argc, char** argv)
+{
+  SystematicTestHarness harness(argc, argv);
+  harness.run(test_two_runtimes);
+  check(latency_ran == 8);
+  return 0;
+}
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 #include <test/harness.h>
 // Harness must come before tests.
+#include "./notify_adaptive.h"
 #include "./notify_basic.h"
 #include "./notify_coalesce.h"
 #include "./notify_empty_queue.h"
@@ -21,5 +22,7 @@ int main(int argc, char** argv)
   if (harness.cores == 1)
     harness.run(notify_coalesce::run_test);
 
+  harness.run(notify_adaptive::run_test);
+
   return 0;
 }
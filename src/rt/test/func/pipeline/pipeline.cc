@@ -0,0 +1,125 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include <test/harness.h>
+
+/**
+ * Tests for schedule_lambda_pipeline: stages run in order, each with its
+ * cown acquired, whether the downstream cowns are idle (inline transfer)
+ * or busy (fallback to a normal schedule).
+ */
+
+static std::atomic<size_t> step = 0;
+static std::atomic<bool> order_ok = true;
+
+struct Stage : public VCown<Stage>
+{
+  size_t value = 0;
+};
+
+void test_pipeline_order()
+{
+  auto* alloc = ThreadAlloc::get();
+  auto* a = new Stage;
+  auto* b = new Stage;
+  auto* c = new Stage;
+
+  step = 0;
+
+  schedule_lambda_pipeline(
+    a,
+    [a]() {
+      if (step++ != 0)
+        order_ok = false;
+      a->value = 1;
+    },
+    b,
+    [b]() {
+      if (step++ != 1)
+        order_ok = false;
+      b->value = 2;
+    },
+    c,
+    [c]() {
+      if (step++ != 2)
+        order_ok = false;
+      c->value = 3;
+    });
+
+  Cown::release(alloc, a);
+  Cown::release(alloc, b);
+  Cown::release(alloc, c);
+}
+
+/// A stage cown may appear more than once in the chain; the stages on it
+/// still run in pipeline order.
+void test_pipeline_repeated_cown()
+{
+  auto* alloc = ThreadAlloc::get();
+  auto* a = new Stage;
+  auto* b = new Stage;
+
+  step = 0;
+
+  schedule_lambda_pipeline(
+    a,
+    []() {
+      if (step++ != 0)
+        order_ok = false;
+    },
+    b,
+    []() {
+      if (step++ != 1)
+        order_ok = false;
+    },
+    a,
+    []() {
+      if (step++ != 2)
+        order_ok = false;
+    });
+
+  Cown::release(alloc, a);
+  Cown::release(alloc, b);
+}
+
+/// A busy downstream cown forces the fallback path: the chain queues
+/// behind the work already scheduled on it.
+void test_pipeline_busy()
+{
+  auto* alloc = ThreadAlloc::get();
+  auto* a = new Stage;
+  auto* b = new Stage;
+
+  step = 0;
+
+  schedule_lambda(b, [b]() { b->value = 42; });
+
+  schedule_lambda_pipeline(
+    a,
+    []() {
+      if (step++ != 0)
+        order_ok = false;
+    },
+    b,
+    [b]() {
+      if (step++ != 1)
+        order_ok = false;
+      if (b->value != 42)
+        order_ok = false;
+    });
+
+  Cown::release(alloc, a);
+  Cown::release(alloc, b);
+}
+
+int main(int argc, char** argv)
+{
+  SystematicTestHarness harness(argc, argv);
+
+  harness.run(test_pipeline_order);
+  harness.run(test_pipeline_repeated_cown);
+  harness.run(test_pipeline_busy);
+
+  check(order_ok);
+
+  return 0;
+}
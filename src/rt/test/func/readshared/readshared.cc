@@ -0,0 +1,104 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include <test/harness.h>
+
+/**
+ * Tests for schedule_lambda_read / Cown::schedule_read: read-only
+ * behaviours on one cown run without exclusive ownership, and an
+ * exclusive behaviour behind them waits until every reader is done.
+ */
+
+static constexpr size_t READS = 16;
+
+static std::atomic<size_t> readers_active = 0;
+static std::atomic<size_t> reads_done = 0;
+static std::atomic<bool> order_ok = true;
+
+struct Config : public VCown<Config>
+{
+  size_t value = 0;
+};
+
+/**
+ * A batch of reads, then an exclusive write, then more reads. The write
+ * must observe all earlier reads complete and none still running; the
+ * later reads must observe the written value.
+ */
+void test_read_then_write()
+{
+  auto* alloc = ThreadAlloc::get();
+  auto* c = new Config;
+  c->value = 1;
+
+  for (size_t i = 0; i < READS; i++)
+  {
+    schedule_lambda_read(c, [c]() {
+      readers_active++;
+      if (c->value != 1)
+        order_ok = false;
+      readers_active--;
+      reads_done++;
+    });
+  }
+
+  schedule_lambda(c, [c]() {
+    // Writers drain the readers first.
+    if (readers_active.load() != 0)
+      order_ok = false;
+    if (reads_done.load() != READS)
+      order_ok = false;
+    c->value = 2;
+  });
+
+  for (size_t i = 0; i < READS; i++)
+  {
+    schedule_lambda_read(c, [c]() {
+      if (c->value != 2)
+        order_ok = false;
+      reads_done++;
+    });
+  }
+
+  Cown::release(alloc, c);
+}
+
+/// Reads issued from a behaviour on another cown take the scheduler-
+/// thread send path rather than the external one.
+void test_read_from_behaviour()
+{
+  auto* alloc = ThreadAlloc::get();
+  auto* trigger = new Config;
+  auto* c = new Config;
+  c->value = 3;
+
+  schedule_lambda(trigger, [c]() {
+    for (size_t i = 0; i < READS; i++)
+    {
+      schedule_lambda_read(c, [c]() {
+        if (c->value != 3)
+          order_ok = false;
+        reads_done++;
+      });
+    }
+    Cown::release(ThreadAlloc::get(), c);
+  });
+
+  Cown::release(alloc, trigger);
+}
+
+int main(int argc, char** argv)
+{
+  SystematicTestHarness harness(argc, argv);
+
+  readers_active = 0;
+  reads_done = 0;
+  order_ok = true;
+
+  harness.run(test_read_then_write);
+  harness.run(test_read_from_behaviour);
+
+  check(order_ok);
+  check(reads_done != 0);
+
+  return 0;
+}
@@ -0,0 +1,78 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include <test/harness.h>
+
+#include <sstream>
+
+/**
+ * Tests for scheduler decision record/replay (SchedulerReplay): a run in
+ * record mode must complete unchanged, and a run driven by a loaded
+ * trace must complete all scheduled work, falling back to live
+ * scheduling once the trace diverges or runs out.
+ */
+
+static constexpr size_t cown_count = 8;
+static constexpr size_t rounds = 32;
+static std::atomic<size_t> ran = 0;
+
+struct C : public VCown<C>
+{};
+
+static C* cowns[cown_count];
+
+struct Ping : public VBehaviour<Ping>
+{
+  size_t round;
+
+  Ping(size_t round) : round(round) {}
+
+  void f()
+  {
+    ran++;
+    if (round == 0)
+      return;
+
+    // Fan the work back out across all cowns, so threads have something
+    // to steal from each other.
+    for (auto* c : cowns)
+      Cown::schedule<Ping>(c, round - 1);
+  }
+};
+
+void test_work()
+{
+  auto* alloc = ThreadAlloc::get();
+  ran = 0;
+
+  for (auto& c : cowns)
+    c = new C;
+
+  Cown::schedule<Ping>(cowns[0], rounds);
+
+  for (auto* c : cowns)
+    Cown::release(alloc, c);
+}
+
+int main(int argc, char** argv)
+{
+  SystematicTestHarness harness(argc, argv);
+
+  // A full run with recording enabled behaves like a normal run.
+  SchedulerReplay::record();
+  harness.run(test_work);
+  check(ran != 0);
+
+  // Replay from a trace in the dump format. The trace does not match
+  // this run's schedule, so the threads must diverge gracefully and
+  // still complete all the work.
+  std::istringstream trace("1 L\n"
+                           "1 S 2\n"
+                           "2 E 1\n"
+                           "2 S 1\n");
+  SchedulerReplay::load(trace);
+  harness.run(test_work);
+  check(ran != 0);
+
+  SchedulerReplay::off();
+  return 0;
+}
@@ -9,10 +9,10 @@ int main()
   bool failed = false;
   for (size_t i = 0; i < 100; i++)
   {
-    verona::Scramble s1;
+    verona::ScrambleImpl<true> s1;
     s1.setup(r);
 
-    verona::Scramble s2;
+    verona::ScrambleImpl<true> s2;
     s2.setup(r);
 
     size_t count = 0;
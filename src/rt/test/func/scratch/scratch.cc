@@ -0,0 +1,96 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include <test/harness.h>
+#include <verona.h>
+
+using namespace snmalloc;
+using namespace verona::rt;
+
+/**
+ * Checks scratch regions: closing one parks it and the next open on the
+ * thread reuses the same region with its counters rewound, a region with
+ * finalisable objects falls back to a full release, and flushing the
+ * parked region restores exact leak accounting.
+ */
+
+struct C : public V<C, RegionType::Arena>
+{
+  C* next = nullptr;
+  size_t value = 0;
+
+  void trace(ObjectStack& st) const
+  {
+    if (next != nullptr)
+      st.push(next);
+  }
+};
+
+static bool finalised = false;
+
+struct F : public V<F, RegionType::Arena>
+{
+  void trace(ObjectStack&) const {}
+
+  void finaliser(Object*, ObjectStack&)
+  {
+    finalised = true;
+  }
+};
+
+void test_reuse()
+{
+  auto* alloc = ThreadAlloc::get();
+
+  C* r = (C*)Region::open_scratch(alloc, C::desc());
+  // open_scratch does not run C++ constructors; initialise explicitly.
+  r->next = nullptr;
+  r->value = 0;
+
+  // Build a chain of behaviour-local temporaries.
+  C* prev = r;
+  for (size_t i = 1; i < 100; i++)
+  {
+    C* c = new (alloc, r) C;
+    c->value = i;
+    prev->next = c;
+    prev = c;
+  }
+  check(Region::object_count(r) == 100);
+
+  RegionBase* reg = Region::get(r);
+  Region::close_scratch(alloc, r);
+
+  // The next open reuses the parked region, rewound to empty.
+  C* r2 = (C*)Region::open_scratch(alloc, C::desc());
+  r2->next = nullptr;
+  r2->value = 0;
+  check(Region::get(r2) == reg);
+  check(Region::object_count(r2) == 1);
+
+  Region::close_scratch(alloc, r2);
+  RegionArena::flush_scratch(alloc);
+  snmalloc::current_alloc_pool()->debug_check_empty();
+}
+
+void test_fallback()
+{
+  auto* alloc = ThreadAlloc::get();
+
+  F* r = (F*)Region::open_scratch(alloc, F::desc());
+  new (alloc, r) F;
+
+  // The region needs finalisers, so closing falls back to a full release.
+  finalised = false;
+  Region::close_scratch(alloc, r);
+  check(finalised);
+
+  RegionArena::flush_scratch(alloc);
+  snmalloc::current_alloc_pool()->debug_check_empty();
+}
+
+int main(int, char**)
+{
+  test_reuse();
+  test_fallback();
+  return 0;
+}
@@ -0,0 +1,119 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include <test/harness.h>
+
+#include <thread>
+
+/**
+ * Tests for batched weak reference release (Cown::weak_release_batched):
+ * a burst of weak releases is accumulated thread-locally and collapsed
+ * into one atomic subtract per cown.
+ */
+
+struct C : public VCown<C>
+{};
+
+/// Many releases of a few cowns: each burst must collapse to one
+/// subtract, and the flush must settle the counts exactly.
+void test_burst()
+{
+  auto* alloc = ThreadAlloc::get();
+  static constexpr size_t refs = 1000;
+
+  auto* a = new C;
+  auto* b = new C;
+
+  for (size_t i = 0; i < refs; i++)
+  {
+    a->weak_acquire();
+    b->weak_acquire();
+  }
+
+  for (size_t i = 0; i < refs; i++)
+  {
+    Cown::weak_release_batched(alloc, a);
+    Cown::weak_release_batched(alloc, b);
+  }
+
+  Cown::flush_weak_releases(alloc);
+
+  Cown::release(alloc, a);
+  Cown::release(alloc, b);
+}
+
+/// More cowns than the batch has slots, released round-robin so
+/// colliding entries are evicted mid-burst.
+void test_evict()
+{
+  auto* alloc = ThreadAlloc::get();
+  static constexpr size_t count = 200;
+  static constexpr size_t refs = 3;
+
+  C* cowns[count];
+  for (auto& c : cowns)
+  {
+    c = new C;
+    for (size_t i = 0; i < refs; i++)
+      c->weak_acquire();
+  }
+
+  for (size_t i = 0; i < refs; i++)
+  {
+    for (auto* c : cowns)
+      Cown::weak_release_batched(alloc, c);
+  }
+
+  Cown::flush_weak_releases(alloc);
+
+  for (auto* c : cowns)
+    Cown::release(alloc, c);
+}
+
+/// The strong reference goes first, so the deferred weak decrements keep
+/// only the stub alive; the flush must free it.
+void test_release_strong_first()
+{
+  auto* alloc = ThreadAlloc::get();
+  static constexpr size_t refs = 100;
+
+  auto* c = new C;
+  for (size_t i = 0; i < refs; i++)
+    c->weak_acquire();
+
+  Cown::release(alloc, c);
+
+  for (size_t i = 0; i < refs; i++)
+    Cown::weak_release_batched(alloc, c);
+
+  Cown::flush_weak_releases(alloc);
+}
+
+/// A thread that exits without flushing: the batch flushes itself on
+/// thread exit, so nothing leaks.
+void test_thread_exit()
+{
+  auto* alloc = ThreadAlloc::get();
+  static constexpr size_t refs = 100;
+
+  auto* c = new C;
+  for (size_t i = 0; i < refs; i++)
+    c->weak_acquire();
+
+  std::thread([c]() {
+    auto* thread_alloc = ThreadAlloc::get();
+    for (size_t i = 0; i < refs; i++)
+      Cown::weak_release_batched(thread_alloc, c);
+  }).join();
+
+  Cown::release(alloc, c);
+}
+
+int main(int argc, char** argv)
+{
+  SystematicTestHarness harness(argc, argv);
+  harness.run(test_burst);
+  harness.run(test_evict);
+  harness.run(test_release_strong_first);
+  harness.run(test_thread_exit);
+  return 0;
+}
@@ -7,6 +7,14 @@
 #include <test/opt.h>
 #include <verona.h>
 
+#if !defined(_WIN32)
+#  include <algorithm>
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#  include <vector>
+#endif
+
 using namespace verona::rt;
 using namespace std::chrono;
 
@@ -27,6 +35,13 @@ class SystematicTestHarness
 {
   size_t seed = 0;
 
+  /**
+   * Write end of the progress pipe when running as a forked shard worker.
+   * The worker writes each seed here before running it, so the parent can
+   * recover the failing seed if the worker dies. -1 when not sharded.
+   */
+  int progress_fd = -1;
+
 public:
   opt::Opt opt;
 
@@ -34,6 +49,7 @@ public:
   size_t cores;
   size_t seed_lower;
   size_t seed_upper;
+  size_t shards;
   high_resolution_clock::time_point start;
 
   SystematicTestHarness(int argc, char** argv) : opt(argc, argv)
@@ -59,11 +75,21 @@ public:
     cores = opt.is<size_t>("--cores", 4);
     std::cout << " --cores " << cores << std::endl;
 
+    shards = opt.is<size_t>("--shards", 1);
+    if (shards > 1)
+      std::cout << " --shards " << shards << std::endl;
+
     detect_leaks = !opt.has("--allow_leaks");
     if (!detect_leaks)
       std::cout << " --allow_leaks " << std::endl;
     Scheduler::set_detect_leaks(detect_leaks);
 
+    if (opt.has("--ws_deque"))
+    {
+      std::cout << " --ws_deque " << std::endl;
+      Scheduler::set_ws_deque(true);
+    }
+
 #if defined(_WIN32) && defined(CI_BUILD)
     _set_error_mode(_OUT_TO_STDERR);
     _set_abort_behavior(0, _WRITE_ABORT_MSG);
@@ -82,10 +108,110 @@ public:
     // When not a CI build use the seed the user specified.
     size_t random = 0;
 #endif
-    for (seed = seed_lower + random; seed < seed_upper + random; seed++)
+    size_t lower = seed_lower + random;
+    size_t upper = seed_upper + random;
+
+#if defined(_WIN32)
+    // Sharding forks one worker per seed stripe, which requires fork(2).
+    run_range(lower, 1, upper, f, std::forward<Args>(args)...);
+#else
+    if (shards <= 1 || upper - lower <= 1)
+    {
+      run_range(lower, 1, upper, f, std::forward<Args>(args)...);
+      return;
+    }
+
+    // Fork one worker per shard. Worker w covers the interleaved stripe
+    // lower + w, lower + w + workers, ... so early seeds, which are the
+    // ones most often inspected, finish first on every worker.
+    size_t workers = std::min(shards, upper - lower);
+    std::vector<pid_t> pids(workers);
+    std::vector<int> pipes(workers);
+
+    for (size_t w = 0; w < workers; w++)
+    {
+      int fds[2];
+      if (pipe(fds) != 0)
+      {
+        perror("pipe");
+        abort();
+      }
+
+      pid_t pid = fork();
+      if (pid < 0)
+      {
+        perror("fork");
+        abort();
+      }
+
+      if (pid == 0)
+      {
+        close(fds[0]);
+        progress_fd = fds[1];
+        run_range(lower + w, workers, upper, f, std::forward<Args>(args)...);
+        _exit(0);
+      }
+
+      close(fds[1]);
+      pids[w] = pid;
+      pipes[w] = fds[0];
+    }
+
+    // Drain each worker's progress pipe until EOF, then reap it. Reading
+    // before waiting keeps long stripes from filling the pipe and
+    // stalling their worker. The last seed written by a worker that died
+    // is the seed it was running.
+    std::vector<size_t> failures;
+    for (size_t w = 0; w < workers; w++)
+    {
+      size_t last = 0;
+      size_t value;
+      while (read(pipes[w], &value, sizeof(value)) == sizeof(value))
+        last = value;
+      close(pipes[w]);
+
+      int status = 0;
+      waitpid(pids[w], &status, 0);
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        failures.push_back(last);
+    }
+
+    if (!failures.empty())
+    {
+      std::sort(failures.begin(), failures.end());
+      std::cout << "Failing seeds:";
+      for (size_t failing : failures)
+        std::cout << " " << failing;
+      std::cout << std::endl
+                << "Minimal failing seed: " << failures.front() << std::endl;
+      abort();
+    }
+#endif
+  }
+
+  size_t current_seed()
+  {
+    check(seed != 0);
+    return seed;
+  }
+
+private:
+  template<typename... Args>
+  void run_range(
+    size_t first, size_t step, size_t upper, void f(Args...), Args... args)
+  {
+    for (seed = first; seed < upper; seed += step)
     {
       std::cout << "Seed: " << seed << std::endl;
 
+#if !defined(_WIN32)
+      if (progress_fd != -1)
+      {
+        if (write(progress_fd, &seed, sizeof(seed)) != sizeof(seed))
+          abort();
+      }
+#endif
+
       Scheduler& sched = Scheduler::get();
 #ifdef USE_SYSTEMATIC_TESTING
       Systematic::set_seed(seed);
@@ -113,10 +239,4 @@ public:
                 << std::endl;
     }
   }
-
-  size_t current_seed()
-  {
-    check(seed != 0);
-    return seed;
-  }
 };
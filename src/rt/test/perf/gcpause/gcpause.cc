@@ -0,0 +1,207 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <test/opt.h>
+#include <verona.h>
+
+using namespace snmalloc;
+using namespace verona::rt;
+
+/**
+ * Measures GC and freeze pause distributions over parameterized region
+ * topologies.
+ *
+ * The functional memory tests build these graph shapes only to check
+ * correctness; this harness builds them at configurable sizes, repeatedly
+ * drives `RegionTrace::gc` and `Freeze::apply` over them, and reports
+ * p50/p99/max pause times together with the allocation rate of the build
+ * phase. The shapes cover the structurally interesting cases:
+ *
+ *   - ring: a doubly linked cycle, one long pointer chase ending in a
+ *     region-sized SCC for the freezer.
+ *   - tree: a binary heap layout, wide fan-out and a deep mark stack.
+ *   - mesh: a 2D grid linked right and down, many short converging paths.
+ *
+ * Before each GC a configurable amount of unreachable garbage is allocated
+ * in the region, so the pause covers both mark and sweep work.
+ **/
+
+struct C1 : public V<C1>
+{
+  C1* f1 = nullptr;
+  C1* f2 = nullptr;
+
+  void trace(ObjectStack& st) const
+  {
+    if (f1 != nullptr)
+      st.push(f1);
+
+    if (f2 != nullptr)
+      st.push(f2);
+  }
+};
+
+using clk = std::chrono::high_resolution_clock;
+
+/// Collects pause samples and prints a percentile summary.
+struct PauseSamples
+{
+  std::vector<uint64_t> ns;
+
+  void add(clk::time_point t0, clk::time_point t1)
+  {
+    ns.push_back(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+  }
+
+  void report(const char* name)
+  {
+    std::sort(ns.begin(), ns.end());
+    std::cout << std::setw(16) << name << ": p50 " << std::setw(9)
+              << ns[ns.size() / 2] << " ns, p99 " << std::setw(9)
+              << ns[(ns.size() * 99) / 100] << " ns, max " << std::setw(9)
+              << ns.back() << " ns" << std::endl;
+  }
+};
+
+/// Build a doubly linked ring of `objects` nodes rooted at the return value.
+C1* build_ring(Alloc* alloc, size_t objects)
+{
+  C1* root = new (alloc) C1;
+  C1* curr = root;
+
+  for (size_t i = 1; i < objects; i++)
+  {
+    C1* next = new (alloc, root) C1;
+    curr->f1 = next;
+    next->f2 = curr;
+    curr = next;
+  }
+
+  curr->f1 = root;
+  root->f2 = curr;
+  return root;
+}
+
+/// Build a binary tree of `objects` nodes in heap layout.
+C1* build_tree(Alloc* alloc, size_t objects)
+{
+  std::vector<C1*> nodes;
+  nodes.push_back(new (alloc) C1);
+
+  for (size_t i = 1; i < objects; i++)
+    nodes.push_back(new (alloc, nodes[0]) C1);
+
+  for (size_t i = 0; i < objects; i++)
+  {
+    if ((2 * i) + 1 < objects)
+      nodes[i]->f1 = nodes[(2 * i) + 1];
+
+    if ((2 * i) + 2 < objects)
+      nodes[i]->f2 = nodes[(2 * i) + 2];
+  }
+
+  return nodes[0];
+}
+
+/// Build a side x side grid where each node links right and down. `objects`
+/// is rounded down to the nearest square.
+C1* build_mesh(Alloc* alloc, size_t objects)
+{
+  size_t side = 1;
+  while ((side + 1) * (side + 1) <= objects)
+    side++;
+
+  std::vector<C1*> nodes;
+  nodes.push_back(new (alloc) C1);
+
+  for (size_t i = 1; i < side * side; i++)
+    nodes.push_back(new (alloc, nodes[0]) C1);
+
+  for (size_t row = 0; row < side; row++)
+  {
+    for (size_t col = 0; col < side; col++)
+    {
+      auto* n = nodes[(row * side) + col];
+      if (col + 1 < side)
+        n->f1 = nodes[(row * side) + col + 1];
+
+      if (row + 1 < side)
+        n->f2 = nodes[((row + 1) * side) + col];
+    }
+  }
+
+  return nodes[0];
+}
+
+void test_topology(
+  const char* name,
+  C1* (*build)(Alloc*, size_t),
+  size_t objects,
+  size_t garbage,
+  size_t iterations)
+{
+  auto* alloc = ThreadAlloc::get();
+
+  PauseSamples gc_pauses;
+  PauseSamples freeze_pauses;
+  uint64_t build_ns = 0;
+  size_t built = 0;
+
+  for (size_t i = 0; i < iterations; i++)
+  {
+    // GC pause: build, add unreachable garbage, collect.
+    auto t0 = clk::now();
+    C1* root = build(alloc, objects);
+    auto t1 = clk::now();
+    build_ns +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    built += Region::debug_size(root);
+
+    for (size_t g = 0; g < garbage; g++)
+      new (alloc, root) C1;
+
+    t0 = clk::now();
+    RegionTrace::gc(alloc, root);
+    t1 = clk::now();
+    gc_pauses.add(t0, t1);
+
+    Region::release(alloc, root);
+
+    // Freeze pause: a freshly built region, as freezing consumes it.
+    root = build(alloc, objects);
+
+    t0 = clk::now();
+    Freeze::apply(alloc, root);
+    t1 = clk::now();
+    freeze_pauses.add(t0, t1);
+
+    Immutable::release(alloc, root);
+  }
+
+  uint64_t alloc_rate = (built * 1'000'000'000) / build_ns;
+  std::cout << name << ": " << built / iterations << " objects, " << garbage
+            << " garbage, " << alloc_rate << " objects/s allocation"
+            << std::endl;
+  gc_pauses.report("gc");
+  freeze_pauses.report("freeze");
+
+  snmalloc::current_alloc_pool()->debug_check_empty();
+}
+
+int main(int argc, char** argv)
+{
+  opt::Opt opt(argc, argv);
+  const auto objects = opt.is<size_t>("--objects", 100'000);
+  const auto garbage = opt.is<size_t>("--garbage", objects / 4);
+  const auto iterations = opt.is<size_t>("--iterations", 20);
+
+  test_topology("ring", build_ring, objects, garbage, iterations);
+  test_topology("tree", build_tree, objects, garbage, iterations);
+  test_topology("mesh", build_mesh, objects, garbage, iterations);
+
+  return 0;
+}
@@ -0,0 +1,147 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+
+/**
+ * Sweeps the chunk geometry of the block-structured stack (see
+ * ds/stack.h) over a mark-style workload: a depth-first traversal of a
+ * pseudo-random object graph, pushing unvisited children and popping
+ * the next node to scan, exactly the access pattern of the GC mark
+ * stacks. Each geometry is also run with the bulk push_n/pop_n
+ * operations, as used by batched mark loops.
+ */
+#include <iomanip>
+#include <iostream>
+#include <test/measuretime.h>
+#include <test/xoroshiro.h>
+#include <verona.h>
+
+using namespace snmalloc;
+using namespace verona::rt;
+
+static constexpr size_t NODES = 1 << 20;
+static constexpr size_t FANOUT = 4;
+static constexpr size_t BULK = 16;
+
+struct Node
+{
+  Node* children[FANOUT];
+  bool marked = false;
+};
+
+static Node* build_graph(Alloc* alloc, size_t seed)
+{
+  xoroshiro::p128r32 rng(seed);
+  auto* nodes = (Node*)alloc->alloc(NODES * sizeof(Node));
+
+  for (size_t i = 0; i < NODES; i++)
+  {
+    for (size_t j = 0; j < FANOUT; j++)
+      nodes[i].children[j] = &nodes[rng.next() % NODES];
+    nodes[i].marked = false;
+  }
+
+  return nodes;
+}
+
+static void clear_marks(Node* nodes)
+{
+  for (size_t i = 0; i < NODES; i++)
+    nodes[i].marked = false;
+}
+
+template<size_t pointer_count>
+static size_t mark(Alloc* alloc, Node* root)
+{
+  Stack<Node, Alloc, pointer_count> stack(alloc);
+  size_t visited = 0;
+
+  root->marked = true;
+  stack.push(root);
+
+  while (!stack.empty())
+  {
+    Node* n = stack.pop();
+    visited++;
+
+    for (auto* c : n->children)
+    {
+      if (!c->marked)
+      {
+        c->marked = true;
+        stack.push(c);
+      }
+    }
+  }
+
+  return visited;
+}
+
+template<size_t pointer_count>
+static size_t mark_bulk(Alloc* alloc, Node* root)
+{
+  Stack<Node, Alloc, pointer_count> stack(alloc);
+  Node* batch[BULK];
+  Node* pending[BULK * FANOUT];
+  size_t visited = 0;
+
+  root->marked = true;
+  stack.push(root);
+
+  while (!stack.empty())
+  {
+    size_t popped = stack.pop_n(batch, BULK);
+    visited += popped;
+    size_t fill = 0;
+
+    for (size_t i = 0; i < popped; i++)
+    {
+      for (auto* c : batch[i]->children)
+      {
+        if (!c->marked)
+        {
+          c->marked = true;
+          pending[fill++] = c;
+        }
+      }
+    }
+
+    stack.push_n(pending, fill);
+  }
+
+  return visited;
+}
+
+template<size_t pointer_count>
+static void sweep_geometry(Alloc* alloc, Node* nodes)
+{
+  size_t visited = 0;
+
+  clear_marks(nodes);
+  DO_TIME("mark      " << std::setw(4) << pointer_count << " slots", {
+    visited = mark<pointer_count>(alloc, nodes);
+  });
+  if (visited == 0)
+    abort();
+
+  clear_marks(nodes);
+  DO_TIME("mark_bulk " << std::setw(4) << pointer_count << " slots", {
+    visited = mark_bulk<pointer_count>(alloc, nodes);
+  });
+  if (visited == 0)
+    abort();
+}
+
+int main(int, char**)
+{
+  auto* alloc = ThreadAlloc::get();
+  auto* nodes = build_graph(alloc, 5489);
+
+  sweep_geometry<16>(alloc, nodes);
+  sweep_geometry<32>(alloc, nodes);
+  sweep_geometry<64>(alloc, nodes);
+  sweep_geometry<128>(alloc, nodes);
+  sweep_geometry<256>(alloc, nodes);
+
+  alloc->dealloc(nodes, NODES * sizeof(Node));
+  return 0;
+}
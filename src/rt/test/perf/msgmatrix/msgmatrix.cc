@@ -0,0 +1,213 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+
+/**
+ * A benchmark matrix for raw `when()` throughput in the Verona runtime.
+ *
+ * Where `ubench` measures one configuration in depth, this benchmark sweeps
+ * cown count x scheduler thread count x behaviour capture size and emits one
+ * CSV row per cell, so scheduler regressions can be tracked per commit. Each
+ * cell arranges the cowns in a ring and runs a fixed number of independent
+ * message chains around it: every behaviour carries a payload of the given
+ * capture size, bumps a counter on its cown and forwards itself to the next
+ * cown in the ring until its hop budget is spent. A controller cown counts
+ * finished chains and records the elapsed time.
+ *
+ * Each cell is a full `init`/`run` cycle of the scheduler, so per-thread
+ * `SchedulerStats` have been folded into `SchedulerStats::global()` by the
+ * time a cell's row is emitted; the steals column is the delta across the
+ * cell (always zero unless built with USE_SCHED_STATS).
+ */
+
+#include "test/log.h"
+#include "test/opt.h"
+#include "verona.h"
+
+#include <test/harness.h>
+
+namespace sn = snmalloc;
+namespace rt = verona::rt;
+
+namespace msgmatrix
+{
+  struct Controller;
+
+  struct Cell : public rt::VCown<Cell>
+  {
+    Cell* next = nullptr;
+    size_t sink = 0;
+  };
+
+  static std::vector<Cell*> cells;
+  static uint64_t elapsed_ns = 0;
+
+  struct Controller : public rt::VCown<Controller>
+  {
+    size_t waiting;
+    uint64_t start;
+
+    Controller(size_t chains) : waiting(chains), start(sn::Aal::tick()) {}
+
+    void trace(rt::ObjectStack& st) const
+    {
+      for (auto* c : cells)
+        st.push(c);
+    }
+  };
+
+  struct Done : public rt::VBehaviour<Done>
+  {
+    Controller* controller;
+
+    Done(Controller* controller_) : controller(controller_) {}
+
+    void f()
+    {
+      if (--controller->waiting != 0)
+        return;
+
+      elapsed_ns = sn::Aal::tick() - controller->start;
+
+      auto* alloc = sn::ThreadAlloc::get();
+      for (auto* c : cells)
+        rt::Cown::release(alloc, c);
+      rt::Cown::release(alloc, controller);
+    }
+  };
+
+  template<size_t Bytes>
+  struct Ping : public rt::VBehaviour<Ping<Bytes>>
+  {
+    Cell* cell;
+    Controller* controller;
+    size_t hops;
+    std::array<uint8_t, Bytes> payload;
+
+    Ping(Cell* cell_, Controller* controller_, size_t hops_)
+    : cell(cell_), controller(controller_), hops(hops_)
+    {
+      payload[0] = (uint8_t)hops_;
+    }
+
+    void f()
+    {
+      // Touch the payload so the capture cannot be optimised away.
+      cell->sink += payload[0];
+
+      if (hops == 1)
+      {
+        rt::Cown::schedule<Done>(controller, controller);
+        return;
+      }
+
+      rt::Cown::schedule<Ping<Bytes>>(
+        cell->next, cell->next, controller, hops - 1);
+    }
+  };
+
+  /// Run one cell of the matrix and emit its CSV row.
+  template<size_t Bytes>
+  void run_cell(size_t cores, size_t cowns, size_t chains, size_t hops)
+  {
+    auto& sched = rt::Scheduler::get();
+    sched.set_fair(true);
+    sched.init(cores);
+
+    auto* alloc = sn::ThreadAlloc::get();
+
+    cells.clear();
+    for (size_t i = 0; i < cowns; i++)
+      cells.push_back(new (alloc) Cell);
+
+    for (size_t i = 0; i < cowns; i++)
+      cells[i]->next = cells[(i + 1) % cowns];
+
+    auto* controller = new (alloc) Controller(chains);
+
+    for (size_t i = 0; i < chains; i++)
+    {
+      auto* first = cells[i % cowns];
+      rt::Cown::schedule<Ping<Bytes>>(first, first, controller, hops);
+    }
+
+    const size_t steals_before = rt::SchedulerStats::global().steals();
+    sched.run();
+    const size_t steal_delta =
+      rt::SchedulerStats::global().steals() - steals_before;
+
+    const size_t behaviours = chains * hops;
+    const uint64_t ns_per_behaviour = elapsed_ns / behaviours;
+    const uint64_t steals_per_sec =
+      (steal_delta * 1'000'000'000) / elapsed_ns;
+
+    sn::CSVStream csv(&std::cout);
+    csv << "MsgMatrix" << cores << cowns << Bytes << behaviours
+        << ns_per_behaviour << steals_per_sec << csv.endl;
+  }
+
+  /// Dispatch a runtime capture size to a Ping instantiation.
+  void run_cell_bytes(
+    size_t bytes, size_t cores, size_t cowns, size_t chains, size_t hops)
+  {
+    switch (bytes)
+    {
+      case 8:
+        return run_cell<8>(cores, cowns, chains, hops);
+      case 64:
+        return run_cell<64>(cores, cowns, chains, hops);
+      case 256:
+        return run_cell<256>(cores, cowns, chains, hops);
+      case 1024:
+        return run_cell<1024>(cores, cowns, chains, hops);
+      default:
+        abort();
+    }
+  }
+}
+
+using namespace msgmatrix;
+
+int main(int argc, char** argv)
+{
+  opt::Opt opt(argc, argv);
+  const auto seed = opt.is<size_t>("--seed", 5489);
+  const auto max_cores = opt.is<size_t>("--cores", 4);
+  const auto max_cowns = opt.is<size_t>("--cowns", 1 << 12);
+  const auto messages = opt.is<size_t>("--messages", 1 << 20);
+  check(max_cores > 0);
+  check(max_cowns > 0);
+
+#ifdef USE_SYSTEMATIC_TESTING
+  Systematic::enable_logging();
+  Systematic::set_seed(seed);
+#else
+  UNUSED(seed);
+#endif
+
+  sn::CSVStream csv(&std::cout);
+  csv << "MsgMatrix"
+      << "Cores"
+      << "Cowns"
+      << "CaptureBytes"
+      << "Behaviours"
+      << "NsPerBehaviour"
+      << "StealsPerSec" << csv.endl;
+
+  static constexpr size_t capture_sizes[] = {8, 64, 256, 1024};
+
+  for (size_t cores = 1; cores <= max_cores; cores *= 2)
+  {
+    for (size_t cowns = 1; cowns <= max_cowns; cowns *= 8)
+    {
+      // Enough independent chains to keep every thread busy, but never more
+      // than one initial message per cown.
+      const size_t chains = std::min(cowns, cores * 4);
+      const size_t hops = std::max<size_t>(messages / chains, 1);
+
+      for (auto bytes : capture_sizes)
+        run_cell_bytes(bytes, cores, cowns, chains, hops);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,187 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+
+/**
+ * A microbenchmark for measuring message passing latency in the Verona
+ * runtime, complementing ubench's throughput loops.
+ *
+ * Each pair consists of a `Pinger` and a `Ponger` cown. The `Pinger`
+ * stamps a `Ping` with the cycle counter and sends it to the `Ponger`,
+ * which immediately sends a `Pong` back; the round-trip time is recorded
+ * when the `Pong` executes. Pairs run concurrently, so with more pairs
+ * than cores the measurement includes queueing behind unrelated work.
+ *
+ * Once every pair has completed its rounds, the per-pair samples are
+ * merged and the p50/p99/p999 round-trip latencies are reported, along
+ * with the worst observed trip. The first `--warmup` rounds of each pair
+ * are discarded, so scheduler start-up does not pollute the tail.
+ */
+
+#include "test/log.h"
+#include "test/opt.h"
+#include "verona.h"
+
+#include <algorithm>
+#include <test/harness.h>
+#include <vector>
+
+namespace sn = snmalloc;
+namespace rt = verona::rt;
+
+namespace pingpong
+{
+  struct Ponger : public rt::VCown<Ponger>
+  {};
+
+  struct Collector;
+
+  struct Pinger : public rt::VCown<Pinger>
+  {
+    Ponger* ponger;
+    Collector* collector;
+    size_t remaining;
+    size_t warmup;
+    std::vector<uint64_t> samples;
+
+    Pinger(
+      Ponger* ponger_, Collector* collector_, size_t rounds, size_t warmup_)
+    : ponger(ponger_), collector(collector_), remaining(rounds + warmup_),
+      warmup(warmup_)
+    {
+      samples.reserve(rounds);
+    }
+  };
+
+  struct Collector : public rt::VCown<Collector>
+  {
+    size_t waiting;
+    std::vector<uint64_t> samples;
+
+    Collector(size_t waiting_) : waiting(waiting_) {}
+  };
+
+  struct Pong;
+  struct Done;
+
+  struct Ping : public rt::VBehaviour<Ping>
+  {
+    Pinger* pinger;
+    Ponger* ponger;
+    uint64_t start;
+
+    Ping(Pinger* pinger_, Ponger* ponger_, uint64_t start_)
+    : pinger(pinger_), ponger(ponger_), start(start_)
+    {}
+
+    void f()
+    {
+      rt::Cown::schedule<Pong>(pinger, pinger, start);
+    }
+  };
+
+  struct Pong : public rt::VBehaviour<Pong>
+  {
+    Pinger* pinger;
+    uint64_t start;
+
+    Pong(Pinger* pinger_, uint64_t start_) : pinger(pinger_), start(start_) {}
+
+    void f()
+    {
+      uint64_t now = sn::Aal::tick();
+      if (pinger->warmup > 0)
+        pinger->warmup--;
+      else
+        pinger->samples.push_back(now - start);
+
+      if (--pinger->remaining > 0)
+      {
+        rt::Cown::schedule<Ping>(
+          pinger->ponger, pinger, pinger->ponger, sn::Aal::tick());
+        return;
+      }
+
+      rt::Cown::schedule<Done>(pinger->collector, pinger->collector, pinger);
+    }
+  };
+
+  static uint64_t percentile(
+    const std::vector<uint64_t>& sorted, size_t numerator, size_t denominator)
+  {
+    size_t index = (sorted.size() * numerator) / denominator;
+    return sorted[std::min(index, sorted.size() - 1)];
+  }
+
+  struct Done : public rt::VBehaviour<Done>
+  {
+    Collector* collector;
+    Pinger* pinger;
+
+    Done(Collector* collector_, Pinger* pinger_)
+    : collector(collector_), pinger(pinger_)
+    {}
+
+    void f()
+    {
+      auto* alloc = sn::ThreadAlloc::get();
+
+      collector->samples.insert(
+        collector->samples.end(),
+        pinger->samples.begin(),
+        pinger->samples.end());
+      rt::Cown::release(alloc, pinger->ponger);
+      rt::Cown::release(alloc, pinger);
+
+      if (--collector->waiting != 0)
+        return;
+
+      auto& samples = collector->samples;
+      std::sort(samples.begin(), samples.end());
+      logger::cout() << samples.size() << " round trips, p50: "
+                     << percentile(samples, 50, 100)
+                     << " ns, p99: " << percentile(samples, 99, 100)
+                     << " ns, p999: " << percentile(samples, 999, 1000)
+                     << " ns, worst: " << samples.back() << " ns" << std::endl;
+
+      rt::Cown::release(alloc, collector);
+    }
+  };
+}
+
+using namespace pingpong;
+
+int main(int argc, char** argv)
+{
+  opt::Opt opt(argc, argv);
+  const auto seed = opt.is<size_t>("--seed", 5489);
+  const auto cores = opt.is<size_t>("--cores", 4);
+  const auto pairs = opt.is<size_t>("--pairs", 1);
+  const auto rounds = opt.is<size_t>("--rounds", 100000);
+  const auto warmup = opt.is<size_t>("--warmup", 1000);
+  check(rounds > 0);
+
+  logger::cout() << "cores: " << cores << ", pairs: " << pairs
+                 << ", rounds: " << rounds << ", warmup: " << warmup
+                 << std::endl;
+
+  auto* alloc = sn::ThreadAlloc::get();
+#ifdef USE_SYSTEMATIC_TESTING
+  Systematic::enable_logging();
+  Systematic::set_seed(seed);
+#else
+  UNUSED(seed);
+#endif
+  auto& sched = rt::Scheduler::get();
+  sched.init(cores);
+
+  auto* collector = new (alloc) Collector(pairs);
+  for (size_t p = 0; p < pairs; p++)
+  {
+    auto* ponger = new (alloc) Ponger();
+    auto* pinger = new (alloc) Pinger(ponger, collector, rounds, warmup);
+    rt::Cown::schedule<Ping>(ponger, pinger, ponger, sn::Aal::tick());
+  }
+
+  sched.run();
+  return 0;
+}
@@ -21,6 +21,7 @@
 #  include "test/xoroshiro.h"
 #endif
 
+#include <atomic>
 #include <iomanip>
 #include <iostream>
 #include <snmalloc.h>
@@ -41,11 +42,28 @@ namespace Systematic
     return scrambler;
   }
 
+  /**
+   * Virtual clock driving scheduler time under systematic testing.
+   *
+   * Systematic execution is orders of magnitude slower than real time, so
+   * logic expressed in TSC ticks (timer deadlines, coalescing windows,
+   * idle accounting) would behave nothing like production if it read the
+   * real TSC. Instead the engine advances this logical clock at every
+   * yield point, so tick-based behaviour is explored at full execution
+   * speed and replays exactly with the seed.
+   */
+  static inline std::atomic<uint64_t>& get_clock()
+  {
+    static std::atomic<uint64_t> clock{0};
+    return clock;
+  }
+
   static inline void set_seed(uint64_t seed)
   {
     auto& rng = get_rng();
     rng.set_state(seed);
     get_scrambler().setup(rng);
+    get_clock().store(0, std::memory_order_relaxed);
   }
 
   /// 1/(2^range_bits) likelyhood of returning true
@@ -54,8 +72,37 @@ namespace Systematic
     assert(range_bits < 20);
     return (get_rng().next() & ((1ULL << range_bits) - 1)) == 0;
   }
+
+  /**
+   * Advance the virtual clock. Called by the systematic engine at every
+   * yield point of a scheduler thread. Steps are mostly small with an
+   * occasional large jump, so each tick-based window is observed from
+   * both sides of its expiry.
+   */
+  static inline void advance_clock()
+  {
+    uint64_t step = (get_rng().next() & 0xff) + 1;
+    if (coin(6))
+      step = step << 16;
+    get_clock().fetch_add(step, std::memory_order_relaxed);
+  }
 #endif
 
+  /**
+   * Scheduler time. The real TSC normally; under systematic testing the
+   * deterministic virtual clock. All tick-based scheduler logic should
+   * read time through this rather than Aal::tick, which remains for
+   * wall-clock diagnostics such as the flight recorder.
+   */
+  static inline uint64_t tick()
+  {
+#ifdef USE_SYSTEMATIC_TESTING
+    return get_clock().load(std::memory_order_relaxed);
+#else
+    return snmalloc::Aal::tick();
+#endif
+  }
+
 #ifdef USE_FLIGHT_RECORDER
   static constexpr bool flight_recorder = true;
 #else
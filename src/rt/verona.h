@@ -10,10 +10,14 @@
 #include "cpp/vbehaviour.h"
 #include "cpp/vobject.h"
 #include "object/object.h"
+#include "region/dedup.h"
 #include "region/externalreference.h"
+#include "region/flatten.h"
 #include "region/freeze.h"
+#include "region/image.h"
 #include "region/immutable.h"
 #include "region/region.h"
+#include "region/snapshot.h"
 #include "sched/cown.h"
 #include "sched/epoch.h"
 #include "sched/multimessage.h"
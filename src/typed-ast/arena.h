@@ -0,0 +1,129 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace verona::ast
+{
+  /// Bump allocator backing typed-AST nodes.
+  ///
+  /// Nodes are built one tree at a time and die together with the tree,
+  /// so the arena only ever grows: allocation is a pointer bump into
+  /// fixed-size blocks, and all node storage is released at once when
+  /// the arena is destroyed. Node destructors still run, through the
+  /// tree's `unique_ptr` edges; only the storage reclamation is deferred
+  /// (see `Node::operator delete`).
+  ///
+  /// The arena in use is selected per thread with `NodeArena::Scope`, so
+  /// parallel conversion can give each worker its own arena with no
+  /// synchronisation on the allocation path. Nodes built while no arena
+  /// is active fall back to the heap; each allocation carries a small
+  /// header recording which case it was, so deallocation can tell.
+  class NodeArena
+  {
+  public:
+    NodeArena() = default;
+    NodeArena(NodeArena&&) = default;
+    NodeArena& operator=(NodeArena&&) = default;
+
+    /// Makes `arena` the allocation target for typed-AST nodes built on
+    /// the current thread, for the duration of the scope.
+    class Scope
+    {
+      NodeArena* previous;
+
+    public:
+      explicit Scope(NodeArena& arena) : previous(current_)
+      {
+        current_ = &arena;
+      }
+
+      ~Scope()
+      {
+        current_ = previous;
+      }
+
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+    };
+
+    /// Allocate storage for a node of `size` bytes, from the current
+    /// thread's arena if one is active, otherwise from the heap.
+    static void* allocateNode(size_t size)
+    {
+      size_t total = HEADER_SIZE + size;
+      Header* header;
+
+      if (current_ != nullptr)
+      {
+        header = static_cast<Header*>(current_->allocate(total));
+        header->from_arena = true;
+      }
+      else
+      {
+        header = static_cast<Header*>(::operator new(total));
+        header->from_arena = false;
+      }
+
+      return reinterpret_cast<char*>(header) + HEADER_SIZE;
+    }
+
+    /// Release a node's storage. A no-op for arena-backed nodes, whose
+    /// storage is reclaimed when the arena is destroyed.
+    static void deallocateNode(void* p)
+    {
+      if (p == nullptr)
+        return;
+
+      auto* header =
+        reinterpret_cast<Header*>(static_cast<char*>(p) - HEADER_SIZE);
+      if (!header->from_arena)
+        ::operator delete(header);
+    }
+
+  private:
+    struct Header
+    {
+      bool from_arena;
+    };
+
+    /// Node alignment never exceeds this, and keeping the header (and
+    /// every bump) a multiple of it keeps the node storage aligned.
+    static constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+    static constexpr size_t HEADER_SIZE =
+      (sizeof(Header) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    void* allocate(size_t size)
+    {
+      size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+      if (static_cast<size_t>(end_ - next_) < size)
+        grow(size);
+
+      char* result = next_;
+      next_ += size;
+      return result;
+    }
+
+    void grow(size_t size)
+    {
+      size_t block = std::max(BLOCK_SIZE, size);
+      blocks_.push_back(std::make_unique<char[]>(block));
+      next_ = blocks_.back().get();
+      end_ = next_ + block;
+    }
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* next_ = nullptr;
+    char* end_ = nullptr;
+
+    static inline thread_local NodeArena* current_ = nullptr;
+  };
+}
@@ -3,6 +3,10 @@
 
 #include "typed-ast/conversion.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 using Ast = ast::Ast;
 using namespace peg::udl;
 using namespace std::literals::string_view_literals;
@@ -529,9 +533,59 @@ namespace verona::ast
     return result;
   }
 
-  std::unique_ptr<EntityDef> convertModule(const ::ast::Ast& node)
+  TypedModule convertModule(const ::ast::Ast& node)
   {
-    // modules are called "classdef" in the untyped AST.
-    return convertClassDef(node);
+    // Modules are called "classdef" in the untyped AST.
+    assert(node->tag == "classdef"_);
+    assert(node->nodes.size() == 5);
+
+    const Ast& body = node->nodes.at(4);
+    assert(body->tag == "typebody"_);
+
+    TypedModule module;
+
+    size_t members = body->nodes.size();
+    size_t workers =
+      std::min<size_t>(std::thread::hardware_concurrency(), members);
+
+    if (workers <= 1)
+    {
+      module.arenas = std::vector<NodeArena>(1);
+      NodeArena::Scope scope(module.arenas.front());
+      module.root = convertClassDef(node);
+      return module;
+    }
+
+    // The module's top-level definitions are independent of one another, so
+    // they are converted on worker threads, each allocating from its own
+    // arena to keep the allocation path synchronisation-free. The untyped
+    // AST is only read. Members are written by index, so the resulting tree
+    // is identical to a serial conversion.
+    module.arenas = std::vector<NodeArena>(workers + 1);
+    std::vector<std::unique_ptr<MemberDef>> elements(members);
+    std::atomic<size_t> next{0};
+
+    std::vector<std::thread> pool;
+    for (size_t w = 0; w < workers; w++)
+    {
+      pool.emplace_back([&, w]() {
+        NodeArena::Scope scope(module.arenas.at(w));
+        size_t index;
+        while ((index = next.fetch_add(1, std::memory_order_relaxed)) <
+               members)
+        {
+          elements.at(index) = convertMemberDef(body->nodes.at(index));
+        }
+      });
+    }
+    for (std::thread& worker : pool)
+      worker.join();
+
+    NodeArena::Scope scope(module.arenas.back());
+    module.root = std::make_unique<EntityDef>(
+      getSourceLocation(node),
+      convertSymbol(node->nodes.at(0)),
+      std::move(elements));
+    return module;
   }
 }
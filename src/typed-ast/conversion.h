@@ -8,7 +8,17 @@
 
 namespace verona::ast
 {
+  /// A converted module: the typed tree together with the arenas its nodes
+  /// were allocated from. The arenas are declared before the root so the
+  /// tree's destructors run before the node storage is released.
+  struct TypedModule
+  {
+    std::vector<NodeArena> arenas;
+    std::unique_ptr<EntityDef> root;
+  };
+
   /// Convert the untyped AST representation of a module into its typed
-  /// equivalent.
-  std::unique_ptr<EntityDef> convertModule(const ::ast::Ast& node);
+  /// equivalent. The module's definitions are independent of one another,
+  /// and large modules are converted in parallel.
+  TypedModule convertModule(const ::ast::Ast& node);
 }
@@ -24,7 +24,7 @@ int main(int argc, char** argv)
   auto typedModule = verona::ast::convertModule(m->ast);
 
   if (opt.ast)
-    verona::ast::print(std::cout, *typedModule);
+    verona::ast::print(std::cout, *typedModule.root);
 
   std::cerr << err;
   return err.empty() ? 0 : -1;
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include "typed-ast/arena.h"
+
 #include <string>
 
 namespace verona::ast
@@ -48,6 +50,20 @@ namespace verona::ast
     virtual void print(NodePrinter& out) const = 0;
     virtual ~Node() = default;
 
+    /// Nodes are allocated from the arena selected by `NodeArena::Scope`,
+    /// falling back to the heap when none is active. Destructors still run
+    /// through the tree's `unique_ptr` edges; arena-backed storage is only
+    /// reclaimed when the arena itself is destroyed.
+    void* operator new(size_t size)
+    {
+      return NodeArena::allocateNode(size);
+    }
+
+    void operator delete(void* p)
+    {
+      NodeArena::deallocateNode(p);
+    }
+
   protected:
     explicit Node(SourceLocation location) : location(location) {}
   };
@@ -90,16 +90,53 @@ namespace verona::ast
       out << '"';
     }
 
+    /// S-expression implementation of the NodePrinter interface.
+    class TextNodePrinter final : public NodePrinter
+    {
+    public:
+      TextNodePrinter(
+        std::ostream& out, bool compact, size_t indent, size_t width)
+      : out(out), compact(compact), indent(indent), width(width)
+      {}
+
+      NodePrinter& begin(std::string_view name) override;
+      void finish() override;
+
+      NodePrinter& field(const Node& node) override;
+      NodePrinter& field(std::string_view value) override;
+      NodePrinter& field(int64_t value) override;
+      NodePrinter& field(double value) override;
+      NodePrinter& field(bool value) override;
+
+      NodePrinter& empty_field() override;
+
+    protected:
+      NodePrinter&
+      field_list(const std::vector<const Node*>& elements) override;
+
+    private:
+      /// Prepare the output to receive the contents of a new field.
+      void next_field();
+
+      std::ostream& out;
+      bool compact;
+      size_t indent;
+      size_t width;
+
+      /// This is the depth of each indentation, in spaces.
+      static constexpr size_t INDENT_STEP = 2;
+    };
+
     void print_compact(std::ostream& out, const Node& node)
     {
-      NodePrinter printer(out, true, 0, 0);
+      TextNodePrinter printer(out, true, 0, 0);
       node.print(printer);
     }
 
     void print_extended(
       std::ostream& out, const Node& node, size_t indent, size_t width)
     {
-      NodePrinter printer(out, false, indent, width);
+      TextNodePrinter printer(out, false, indent, width);
       node.print(printer);
     }
 
@@ -141,129 +178,124 @@ namespace verona::ast
     }
   }
 
-  NodePrinter& NodePrinter::begin(std::string_view name)
+  namespace
   {
-    if (!compact)
+    NodePrinter& TextNodePrinter::begin(std::string_view name)
     {
-      out << std::string(indent, ' ');
-      indent += INDENT_STEP;
+      if (!compact)
+      {
+        out << std::string(indent, ' ');
+        indent += INDENT_STEP;
+      }
+      out << "(" << name;
+      return *this;
     }
-    out << "(" << name;
-    return *this;
-  }
 
-  void NodePrinter::finish()
-  {
-    out << ")";
-    if (!compact)
-      indent -= INDENT_STEP;
-  }
-
-  void NodePrinter::next_field()
-  {
-    if (compact)
-      out << " ";
-    else
-      out << "\n";
-  }
+    void TextNodePrinter::finish()
+    {
+      out << ")";
+      if (!compact)
+        indent -= INDENT_STEP;
+    }
 
-  NodePrinter& NodePrinter::field(const Node& node)
-  {
-    next_field();
-    if (compact)
+    void TextNodePrinter::next_field()
     {
-      print_compact(out, node);
+      if (compact)
+        out << " ";
+      else
+        out << "\n";
     }
-    else
+
+    NodePrinter& TextNodePrinter::field(const Node& node)
     {
-      // Even if the current node is formatted in its extended form, nested
-      // nodes could be formatted in the compact form, if they fit. We use the
-      // top-level `print` method to make that decision again.
-      print(out, node, indent, width);
+      next_field();
+      if (compact)
+      {
+        print_compact(out, node);
+      }
+      else
+      {
+        // Even if the current node is formatted in its extended form, nested
+        // nodes could be formatted in the compact form, if they fit. We use the
+        // top-level `print` method to make that decision again.
+        print(out, node, indent, width);
+      }
+      return *this;
     }
-    return *this;
-  }
 
-  NodePrinter& NodePrinter::field(std::string_view value)
-  {
-    next_field();
-    out << std::string(indent, ' ');
-    print_string(out, value);
-    return *this;
-  }
+    NodePrinter& TextNodePrinter::field(std::string_view value)
+    {
+      next_field();
+      out << std::string(indent, ' ');
+      print_string(out, value);
+      return *this;
+    }
 
-  NodePrinter& NodePrinter::field(int64_t value)
-  {
-    next_field();
-    out << std::string(indent, ' ') << value;
-    return *this;
-  }
+    NodePrinter& TextNodePrinter::field(int64_t value)
+    {
+      next_field();
+      out << std::string(indent, ' ') << value;
+      return *this;
+    }
 
-  NodePrinter& NodePrinter::field(double value)
-  {
-    next_field();
-    out << std::string(indent, ' ') << value;
-    return *this;
-  }
+    NodePrinter& TextNodePrinter::field(double value)
+    {
+      next_field();
+      out << std::string(indent, ' ') << value;
+      return *this;
+    }
 
-  NodePrinter& NodePrinter::field(bool value)
-  {
-    next_field();
-    out << std::string(indent, ' ') << value;
-    return *this;
-  }
+    NodePrinter& TextNodePrinter::field(bool value)
+    {
+      next_field();
+      out << std::string(indent, ' ') << value;
+      return *this;
+    }
 
-  template<typename T, typename>
-  NodePrinter&
-  NodePrinter::field(const std::vector<std::unique_ptr<T>>& elements)
-  {
-    next_field();
-    if (compact)
+    NodePrinter&
+    TextNodePrinter::field_list(const std::vector<const Node*>& elements)
     {
-      out << "[";
-      bool first = true;
-      for (auto& elem : elements)
+      next_field();
+      if (compact)
       {
-        if (!first)
-          out << " ";
-        else
-          first = false;
+        out << "[";
+        bool first = true;
+        for (const Node* elem : elements)
+        {
+          if (!first)
+            out << " ";
+          else
+            first = false;
 
-        print_compact(out, *elem);
+          print_compact(out, *elem);
+        }
+        out << "]";
       }
-      out << "]";
-    }
-    else
-    {
-      out << std::string(indent, ' ') << "[\n";
-      indent += INDENT_STEP;
-
-      for (auto& elem : elements)
+      else
       {
-        print(out, *elem, indent, width);
-        out << "\n";
-      }
+        out << std::string(indent, ' ') << "[\n";
+        indent += INDENT_STEP;
 
-      indent -= INDENT_STEP;
-      out << std::string(indent, ' ') << "])";
+        for (const Node* elem : elements)
+        {
+          print(out, *elem, indent, width);
+          out << "\n";
+        }
+
+        indent -= INDENT_STEP;
+        out << std::string(indent, ' ') << "])";
+      }
+      return *this;
     }
-    return *this;
-  }
 
-  NodePrinter& NodePrinter::empty_field()
-  {
-    next_field();
-    out << std::string(indent, ' ') << "()";
-    return *this;
+    NodePrinter& TextNodePrinter::empty_field()
+    {
+      next_field();
+      out << std::string(indent, ' ') << "()";
+      return *this;
+    }
   }
 
-  template NodePrinter&
-  NodePrinter::field(const std::vector<std::unique_ptr<Node>>& elements);
-  template NodePrinter&
-  NodePrinter::field(const std::vector<std::unique_ptr<Expr>>& elements);
-  template NodePrinter&
-  NodePrinter::field(const std::vector<std::unique_ptr<MemberDef>>& elements);
-
   void NewExpr::print(NodePrinter& out) const
   {
     out.begin("new").field(elements).optional_field(region).finish();
@@ -25,27 +25,37 @@ namespace verona::ast
   /// more times, and finally end with the `finish` method.
   ///
   /// This allows the node implementations to be agnostic to the details of the
-  /// format, and ensures all nodes are printed consistently.
+  /// format, and ensures all nodes are printed consistently. Concrete
+  /// formats implement the virtual methods: the S-expression printer lives
+  /// in `print.cc`, the binary encoder in `serialize.h`.
   class NodePrinter
   {
   public:
-    NodePrinter(std::ostream& out, bool compact, size_t indent, size_t width)
-    : out(out), compact(compact), indent(indent), width(width)
-    {}
+    virtual NodePrinter& begin(std::string_view name) = 0;
+    virtual void finish() = 0;
 
-    NodePrinter& begin(std::string_view name);
-    void finish();
+    virtual NodePrinter& field(const Node& node) = 0;
+    virtual NodePrinter& field(std::string_view value) = 0;
+    virtual NodePrinter& field(int64_t value) = 0;
+    virtual NodePrinter& field(double value) = 0;
+    virtual NodePrinter& field(bool value) = 0;
 
-    NodePrinter& field(const Node& node);
-    NodePrinter& field(std::string_view value);
-    NodePrinter& field(int64_t value);
-    NodePrinter& field(double value);
-    NodePrinter& field(bool value);
+    virtual NodePrinter& empty_field() = 0;
 
     template<
       typename T,
       typename = std::enable_if_t<std::is_base_of_v<Node, T>>>
-    NodePrinter& field(const std::vector<std::unique_ptr<T>>& elements);
+    NodePrinter& field(const std::vector<std::unique_ptr<T>>& elements)
+    {
+      std::vector<const Node*> nodes;
+      nodes.reserve(elements.size());
+      for (const auto& elem : elements)
+      {
+        assert(elem);
+        nodes.push_back(elem.get());
+      }
+      return field_list(nodes);
+    }
 
     template<
       typename T,
@@ -76,18 +86,12 @@ namespace verona::ast
         return empty_field();
     }
 
-    NodePrinter& empty_field();
-
-  private:
-    /// Prepare the output to receive the contents of a new field.
-    void next_field();
-
-    std::ostream& out;
-    bool compact;
-    size_t indent;
-    size_t width;
+    virtual ~NodePrinter() = default;
 
-    /// This is the depth of each indentation, in spaces.
-    static constexpr size_t INDENT_STEP = 2;
+  protected:
+    /// A field holding a list of nodes. The element type is erased by the
+    /// `field` template above, so formats only need this one overload.
+    virtual NodePrinter&
+    field_list(const std::vector<const Node*>& elements) = 0;
   };
 }
@@ -0,0 +1,250 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+
+#include "typed-ast/serialize.h"
+
+#include <cstring>
+
+namespace verona::ast
+{
+  namespace
+  {
+    /// Map a signed value onto an unsigned one so that small magnitudes,
+    /// of either sign, varint-encode into few bytes.
+    uint64_t zigzag_encode(int64_t value)
+    {
+      return (static_cast<uint64_t>(value) << 1) ^
+        static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t zigzag_decode(uint64_t value)
+    {
+      return static_cast<int64_t>(value >> 1) ^
+        -static_cast<int64_t>(value & 1);
+    }
+  }
+
+  void NodeEncoder::put_tag(Tag tag)
+  {
+    buffer_.push_back(static_cast<uint8_t>(tag));
+  }
+
+  void NodeEncoder::put_varint(uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      buffer_.push_back(static_cast<uint8_t>(value) | 0x80);
+      value >>= 7;
+    }
+    buffer_.push_back(static_cast<uint8_t>(value));
+  }
+
+  void NodeEncoder::put_string(std::string_view value)
+  {
+    auto it = strings_.find(value);
+    if (it != strings_.end())
+    {
+      put_varint(it->second);
+      return;
+    }
+
+    strings_.emplace(value, strings_.size() + 1);
+    put_varint(0);
+    put_varint(value.size());
+    buffer_.insert(buffer_.end(), value.begin(), value.end());
+  }
+
+  NodePrinter& NodeEncoder::begin(std::string_view name)
+  {
+    put_tag(Tag::Begin);
+    put_string(name);
+    return *this;
+  }
+
+  void NodeEncoder::finish()
+  {
+    put_tag(Tag::End);
+  }
+
+  NodePrinter& NodeEncoder::field(const Node& node)
+  {
+    node.print(*this);
+    return *this;
+  }
+
+  NodePrinter& NodeEncoder::field(std::string_view value)
+  {
+    put_tag(Tag::String);
+    put_string(value);
+    return *this;
+  }
+
+  NodePrinter& NodeEncoder::field(int64_t value)
+  {
+    put_tag(Tag::Int);
+    put_varint(zigzag_encode(value));
+    return *this;
+  }
+
+  NodePrinter& NodeEncoder::field(double value)
+  {
+    put_tag(Tag::Float);
+
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(value));
+    memcpy(&bits, &value, sizeof(bits));
+    for (size_t i = 0; i < sizeof(bits); i++)
+      buffer_.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+
+    return *this;
+  }
+
+  NodePrinter& NodeEncoder::field(bool value)
+  {
+    put_tag(value ? Tag::True : Tag::False);
+    return *this;
+  }
+
+  NodePrinter& NodeEncoder::empty_field()
+  {
+    put_tag(Tag::Empty);
+    return *this;
+  }
+
+  NodePrinter& NodeEncoder::field_list(const std::vector<const Node*>& elements)
+  {
+    put_tag(Tag::List);
+    put_varint(elements.size());
+    for (const Node* elem : elements)
+      elem->print(*this);
+    return *this;
+  }
+
+  std::vector<uint8_t> serialize(const Node& node)
+  {
+    NodeEncoder encoder;
+    node.print(encoder);
+    return encoder.take_buffer();
+  }
+
+  bool NodeReader::read_varint(uint64_t* value)
+  {
+    uint64_t result = 0;
+    for (size_t shift = 0; shift < 64; shift += 7)
+    {
+      if (position_ == end_)
+        return false;
+
+      uint8_t byte = *position_++;
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+      {
+        *value = result;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool NodeReader::read_string(std::string_view* value)
+  {
+    uint64_t id;
+    if (!read_varint(&id))
+      return false;
+
+    if (id != 0)
+    {
+      // Back-reference to an earlier definition.
+      if (id > strings_.size())
+        return false;
+      *value = strings_[id - 1];
+      return true;
+    }
+
+    uint64_t length;
+    if (!read_varint(&length))
+      return false;
+    if (length > static_cast<size_t>(end_ - position_))
+      return false;
+
+    *value =
+      std::string_view(reinterpret_cast<const char*>(position_), length);
+    position_ += length;
+    strings_.push_back(*value);
+    return true;
+  }
+
+  NodeReader::Event NodeReader::next()
+  {
+    if (failed_)
+      return Event::Error;
+
+    if (position_ == end_)
+      return Event::Done;
+
+    failed_ = true;
+    switch (static_cast<Tag>(*position_++))
+    {
+      case Tag::Begin:
+        if (!read_string(&string_))
+          return Event::Error;
+        failed_ = false;
+        return Event::Begin;
+
+      case Tag::End:
+        failed_ = false;
+        return Event::End;
+
+      case Tag::String:
+        if (!read_string(&string_))
+          return Event::Error;
+        failed_ = false;
+        return Event::String;
+
+      case Tag::Int:
+      {
+        uint64_t raw;
+        if (!read_varint(&raw))
+          return Event::Error;
+        integer_ = zigzag_decode(raw);
+        failed_ = false;
+        return Event::Int;
+      }
+
+      case Tag::Float:
+      {
+        if (end_ - position_ < static_cast<ptrdiff_t>(sizeof(uint64_t)))
+          return Event::Error;
+
+        uint64_t bits = 0;
+        for (size_t i = 0; i < sizeof(bits); i++)
+          bits |= static_cast<uint64_t>(*position_++) << (8 * i);
+        memcpy(&real_, &bits, sizeof(real_));
+        failed_ = false;
+        return Event::Float;
+      }
+
+      case Tag::True:
+      case Tag::False:
+        boolean_ = static_cast<Tag>(position_[-1]) == Tag::True;
+        failed_ = false;
+        return Event::Bool;
+
+      case Tag::Empty:
+        failed_ = false;
+        return Event::Empty;
+
+      case Tag::List:
+      {
+        uint64_t count;
+        if (!read_varint(&count))
+          return Event::Error;
+        list_length_ = count;
+        failed_ = false;
+        return Event::List;
+      }
+    }
+
+    return Event::Error;
+  }
+}
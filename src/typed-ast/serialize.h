@@ -0,0 +1,184 @@
+// Copyright Microsoft and Project Verona Contributors.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "typed-ast/print.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace verona::ast
+{
+  /// Binary serialization of typed-AST nodes.
+  ///
+  /// The format is a flat stream of tagged events mirroring the
+  /// begin/field/finish protocol nodes already use for printing:
+  ///
+  ///   node   ::= BEGIN name field* END
+  ///   field  ::= node | STRING str | INT zigzag-varint | FLOAT 8-bytes
+  ///            | TRUE | FALSE | EMPTY | LIST varint(count) node*
+  ///   name   ::= str
+  ///   str    ::= varint(id) | varint(0) varint(length) bytes
+  ///
+  /// Each tag is a single byte and every integer is LEB128
+  /// varint-encoded. Strings are interned: the first occurrence is
+  /// written inline and assigned the next id (starting from 1), and
+  /// later occurrences are a one-varint back-reference. Node names and
+  /// symbols recur heavily, so most of them cost one or two bytes.
+  /// Floats are 8 bytes, least significant byte first.
+  enum class Tag : uint8_t
+  {
+    Begin = 0x01,
+    End,
+    String,
+    Int,
+    Float,
+    True,
+    False,
+    Empty,
+    List,
+  };
+
+  /// NodePrinter implementation encoding the tree into a byte buffer.
+  ///
+  /// Reuses the nodes' `print` methods, so any node that can be printed
+  /// can be serialized without further per-node code.
+  class NodeEncoder final : public NodePrinter
+  {
+  public:
+    NodePrinter& begin(std::string_view name) override;
+    void finish() override;
+
+    NodePrinter& field(const Node& node) override;
+    NodePrinter& field(std::string_view value) override;
+    NodePrinter& field(int64_t value) override;
+    NodePrinter& field(double value) override;
+    NodePrinter& field(bool value) override;
+
+    NodePrinter& empty_field() override;
+
+    const std::vector<uint8_t>& buffer() const
+    {
+      return buffer_;
+    }
+
+    std::vector<uint8_t> take_buffer()
+    {
+      return std::move(buffer_);
+    }
+
+  protected:
+    NodePrinter& field_list(const std::vector<const Node*>& elements) override;
+
+  private:
+    void put_tag(Tag tag);
+    void put_varint(uint64_t value);
+    void put_string(std::string_view value);
+
+    std::vector<uint8_t> buffer_;
+
+    /// Intern table; ids start at 1, 0 marks an inline definition.
+    std::map<std::string, uint64_t, std::less<>> strings_;
+  };
+
+  /// Serialize a node tree into a fresh buffer.
+  std::vector<uint8_t> serialize(const Node& node);
+
+  /// Cursor over a serialized buffer, yielding one event per call to
+  /// `next`. The reader never copies: string values, including interned
+  /// back-references, are string_views into the caller's buffer, which
+  /// must outlive the reader and anything it returned.
+  ///
+  /// A malformed buffer yields Error; a fully consumed one yields Done.
+  /// The reader checks framing (tags, varints, string ids, truncation)
+  /// but not that the events form a tree the node classes could have
+  /// produced.
+  class NodeReader
+  {
+  public:
+    enum class Event
+    {
+      /// Start of a node; `string` is its name.
+      Begin,
+      /// End of the node most recently begun.
+      End,
+      /// A string field; value in `string`.
+      String,
+      /// An integer field; value in `integer`.
+      Int,
+      /// A float field; value in `real`.
+      Float,
+      /// A boolean field; value in `boolean`.
+      Bool,
+      /// An absent optional field.
+      Empty,
+      /// A list field of `list_length` nodes, which follow.
+      List,
+      /// The whole buffer has been consumed.
+      Done,
+      /// The buffer is malformed; the reader stays in this state.
+      Error,
+    };
+
+    NodeReader(const uint8_t* data, size_t size)
+    : position_(data), end_(data + size)
+    {}
+
+    explicit NodeReader(const std::vector<uint8_t>& buffer)
+    : NodeReader(buffer.data(), buffer.size())
+    {}
+
+    /// Advance to the next event.
+    Event next();
+
+    /// Valid after Begin and String events.
+    std::string_view string() const
+    {
+      return string_;
+    }
+
+    /// Valid after an Int event.
+    int64_t integer() const
+    {
+      return integer_;
+    }
+
+    /// Valid after a Float event.
+    double real() const
+    {
+      return real_;
+    }
+
+    /// Valid after a Bool event.
+    bool boolean() const
+    {
+      return boolean_;
+    }
+
+    /// Valid after a List event.
+    size_t list_length() const
+    {
+      return list_length_;
+    }
+
+  private:
+    bool read_varint(uint64_t* value);
+    bool read_string(std::string_view* value);
+
+    const uint8_t* position_;
+    const uint8_t* end_;
+    bool failed_ = false;
+
+    /// Intern table mirroring the encoder's, as views into the buffer.
+    std::vector<std::string_view> strings_;
+
+    std::string_view string_;
+    int64_t integer_ = 0;
+    double real_ = 0;
+    bool boolean_ = false;
+    size_t list_length_ = 0;
+  };
+}
@@ -0,0 +1,276 @@
+# Copyright Microsoft and Project Verona Contributors.
+# SPDX-License-Identifier: MIT
+"""Run the runtime perf suites and diff the results against a baseline.
+
+Each suite under `src/rt/test/perf` that emits machine-readable numbers is
+run with fixed seeds and, where the OS supports it, pinned to a fixed set
+of CPUs. The extracted metrics are persisted as JSON keyed by the current
+git SHA, and compared against a stored baseline: any metric that regresses
+by more than the threshold fails the run.
+
+Typical use, from a build of src/rt:
+
+    run_benchmarks.py --build-dir . --set-baseline   # before a change
+    run_benchmarks.py --build-dir .                  # after a change
+
+This is what the `rt_benchmarks` / `rt_benchmarks_baseline` CMake targets
+invoke.
+"""
+
+import argparse
+import json
+import re
+import shutil
+import subprocess
+import sys
+from pathlib import Path
+
+
+class Suite:
+    """One perf binary invocation and how to read metrics off its output.
+
+    `parse` takes the process stdout and returns a dict of metric name to
+    value. `higher_better` applies to every metric the suite produces.
+    """
+
+    def __init__(self, name, binary, args, parse, higher_better):
+        self.name = name
+        self.binary = binary
+        self.args = args
+        self.parse = parse
+        self.higher_better = higher_better
+
+
+def parse_ubench(out):
+    """One `<t> ns, <rate> msgs/s` line per report interval; use the mean."""
+    rates = [int(m.group(1)) for m in re.finditer(r"(\d+) msgs/s", out)]
+    if not rates:
+        return {}
+    return {"msgs_per_sec": sum(rates) // len(rates)}
+
+
+def parse_msgmatrix(out):
+    """CSV rows: MsgMatrix, cores, cowns, bytes, behaviours, ns, steals."""
+    metrics = {}
+    for line in out.splitlines():
+        fields = [f.strip() for f in line.split(",")]
+        if fields and fields[-1] == "":
+            fields.pop()  # tolerate a trailing separator
+        if len(fields) != 7 or fields[0] != "MsgMatrix":
+            continue
+        if not fields[1].isdigit():
+            continue  # header row
+        cores, cowns, nbytes, _, ns_per_behaviour, _ = fields[1:]
+        key = "ns_per_behaviour/c%sx%sx%sB" % (cores, cowns, nbytes)
+        metrics[key] = int(ns_per_behaviour)
+    return metrics
+
+
+def parse_gcpause(out):
+    """Topology header lines, each followed by gc/freeze percentile lines."""
+    metrics = {}
+    topology = None
+    for line in out.splitlines():
+        m = re.match(r"^(ring|tree|mesh):", line)
+        if m:
+            topology = m.group(1)
+            continue
+        m = re.match(
+            r"^\s*(gc|freeze): p50\s+(\d+) ns, p99\s+(\d+) ns, max\s+(\d+) ns",
+            line,
+        )
+        if m and topology:
+            metrics["%s_p50/%s" % (m.group(1), topology)] = int(m.group(2))
+            metrics["%s_p99/%s" % (m.group(1), topology)] = int(m.group(3))
+    return metrics
+
+
+def parse_pingpong(out):
+    """One `<n> round trips, p50: ... ns, ..., worst: ... ns` line."""
+    m = re.search(
+        r"p50: (\d+) ns, p99: (\d+) ns, p999: (\d+) ns", out
+    )
+    if not m:
+        return {}
+    return {
+        "rtt_p50_ns": int(m.group(1)),
+        "rtt_p99_ns": int(m.group(2)),
+        "rtt_p999_ns": int(m.group(3)),
+    }
+
+
+SUITES = [
+    Suite(
+        "ubench",
+        "perf-con-ubench",
+        ["--seed", "5489", "--cores", "4", "--report_count", "5"],
+        parse_ubench,
+        higher_better=True,
+    ),
+    Suite(
+        "msgmatrix",
+        "perf-con-msgmatrix",
+        ["--seed", "5489", "--cores", "4"],
+        parse_msgmatrix,
+        higher_better=False,
+    ),
+    Suite(
+        "gcpause",
+        "perf-con-gcpause",
+        ["--objects", "100000", "--iterations", "20"],
+        parse_gcpause,
+        higher_better=False,
+    ),
+    Suite(
+        "pingpong",
+        "perf-con-pingpong",
+        ["--seed", "5489", "--cores", "4", "--pairs", "4"],
+        parse_pingpong,
+        higher_better=False,
+    ),
+]
+
+
+def git_sha():
+    try:
+        return subprocess.run(
+            ["git", "rev-parse", "HEAD"],
+            cwd=Path(__file__).parent,
+            capture_output=True,
+            text=True,
+            check=True,
+        ).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return "unknown"
+
+
+def run_suite(suite, build_dir, cpus):
+    binary = build_dir / suite.binary
+    if not binary.exists():
+        print("skipping %s: %s not built" % (suite.name, binary))
+        return None
+
+    cmd = [str(binary)] + suite.args
+    if cpus and shutil.which("taskset"):
+        cmd = ["taskset", "-c", cpus] + cmd
+
+    print("running %s" % " ".join(cmd))
+    proc = subprocess.run(cmd, capture_output=True, text=True)
+    if proc.returncode != 0:
+        print(proc.stderr, file=sys.stderr)
+        raise RuntimeError("%s exited with %d" % (suite.name, proc.returncode))
+
+    metrics = suite.parse(proc.stdout)
+    if not metrics:
+        raise RuntimeError("no metrics parsed from %s output" % suite.name)
+    return metrics
+
+
+def diff(baseline, results, threshold):
+    """Print the per-metric deltas; return the metrics that regressed."""
+    regressions = []
+    directions = {s.name: s.higher_better for s in SUITES}
+
+    for suite_name, metrics in sorted(results["suites"].items()):
+        base_metrics = baseline["suites"].get(suite_name, {})
+        higher_better = directions.get(suite_name, False)
+        for key, value in sorted(metrics.items()):
+            base = base_metrics.get(key)
+            if base is None or base == 0:
+                print("  %s/%s: %d (no baseline)" % (suite_name, key, value))
+                continue
+            change = (value - base) / base
+            regressed = (-change if higher_better else change) > threshold
+            print(
+                "  %s/%s: %d -> %d (%+.1f%%)%s"
+                % (
+                    suite_name,
+                    key,
+                    base,
+                    value,
+                    change * 100,
+                    " REGRESSION" if regressed else "",
+                )
+            )
+            if regressed:
+                regressions.append("%s/%s" % (suite_name, key))
+
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument(
+        "--build-dir",
+        type=Path,
+        required=True,
+        help="directory containing the perf binaries",
+    )
+    parser.add_argument(
+        "--results-dir",
+        type=Path,
+        help="where to persist results (default <build-dir>/benchmarks)",
+    )
+    parser.add_argument(
+        "--cpus",
+        default="0-3",
+        help="CPU list to pin benchmarks to, '' to disable (default 0-3)",
+    )
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.05,
+        help="relative regression that fails the run (default 0.05)",
+    )
+    parser.add_argument(
+        "--set-baseline",
+        action="store_true",
+        help="store this run as the baseline instead of diffing",
+    )
+    args = parser.parse_args()
+
+    results_dir = args.results_dir or args.build_dir / "benchmarks"
+    results_dir.mkdir(parents=True, exist_ok=True)
+    baseline_file = results_dir / "baseline.json"
+
+    results = {"sha": git_sha(), "suites": {}}
+    for suite in SUITES:
+        metrics = run_suite(suite, args.build_dir, args.cpus)
+        if metrics is not None:
+            results["suites"][suite.name] = metrics
+
+    if not results["suites"]:
+        print("no perf binaries found in %s" % args.build_dir, file=sys.stderr)
+        return 1
+
+    result_file = results_dir / ("%s.json" % results["sha"])
+    result_file.write_text(json.dumps(results, indent=2) + "\n")
+    print("results written to %s" % result_file)
+
+    if args.set_baseline:
+        baseline_file.write_text(json.dumps(results, indent=2) + "\n")
+        print("baseline set to %s" % results["sha"])
+        return 0
+
+    if not baseline_file.exists():
+        print("no baseline stored; run with --set-baseline first")
+        return 0
+
+    baseline = json.loads(baseline_file.read_text())
+    print("diff against baseline %s:" % baseline["sha"])
+    regressions = diff(baseline, results, args.threshold)
+
+    if regressions:
+        print(
+            "%d metric(s) regressed more than %.0f%%: %s"
+            % (len(regressions), args.threshold * 100, ", ".join(regressions)),
+            file=sys.stderr,
+        )
+        return 1
+
+    print("no regressions above %.0f%%" % (args.threshold * 100))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
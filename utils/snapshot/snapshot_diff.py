@@ -0,0 +1,174 @@
+# Copyright Microsoft and Project Verona Contributors.
+# SPDX-License-Identifier: MIT
+"""Inspect and diff heap snapshots produced by rt::HeapSnapshot::dump.
+
+With one snapshot, prints a per-descriptor breakdown (object count and
+bytes) and a per-region summary. With two, prints the same breakdown as
+a delta: what grew between the first snapshot and the second. This is
+the leak workflow the dumper exists for - snapshot, reproduce, snapshot
+again, diff.
+
+The binary format is documented in src/rt/region/snapshot.h. Descriptor
+ids are assigned in discovery order and are not stable across runs, so
+snapshots are matched through their descriptor tables: descriptors pair
+up by (size, rank of first sighting among descriptors of that size).
+
+Typical use:
+
+    snapshot_diff.py before.vhs
+    snapshot_diff.py before.vhs after.vhs
+"""
+
+import argparse
+import sys
+from collections import defaultdict
+
+TAG_END = 0x00
+TAG_DESC = 0x01
+TAG_REGION = 0x02
+TAG_OBJECT = 0x03
+
+EDGE_KINDS = ["internal", "imm", "sub", "cown"]
+REGION_TYPES = {0: "trace", 1: "arena"}
+
+
+class Snapshot:
+    """Parsed form of one snapshot stream."""
+
+    def __init__(self):
+        # descriptor id -> object size
+        self.desc_size = {}
+        # descriptor id -> number of objects
+        self.desc_count = defaultdict(int)
+        # list of (address, type, object count, bytes)
+        self.regions = []
+        # edge kind name -> count, across all objects
+        self.edges = defaultdict(int)
+
+    @property
+    def objects(self):
+        return sum(self.desc_count.values())
+
+    @property
+    def bytes(self):
+        return sum(r[3] for r in self.regions)
+
+    def desc_key(self, desc_id):
+        """Stable pairing key for a descriptor: its size, and its rank
+        among same-sized descriptors in discovery order."""
+        size = self.desc_size[desc_id]
+        rank = sum(
+            1 for d, s in self.desc_size.items() if s == size and d < desc_id
+        )
+        return (size, rank)
+
+
+class Reader:
+    def __init__(self, data):
+        if data[:4] != b"VHS1":
+            raise ValueError("not a heap snapshot (bad magic)")
+        self.data = data
+        self.pos = 4
+
+    def u8(self):
+        b = self.data[self.pos]
+        self.pos += 1
+        return b
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            b = self.u8()
+            value |= (b & 0x7F) << shift
+            if not b & 0x80:
+                return value
+            shift += 7
+
+
+def parse(path):
+    with open(path, "rb") as f:
+        r = Reader(f.read())
+
+    snap = Snapshot()
+    while True:
+        tag = r.u8()
+        if tag == TAG_END:
+            return snap
+
+        if tag == TAG_DESC:
+            desc_id = r.varint()
+            snap.desc_size[desc_id] = r.varint()
+        elif tag == TAG_REGION:
+            addr = r.varint()
+            rtype = REGION_TYPES.get(r.u8(), "?")
+            count = r.varint()
+            nbytes = r.varint()
+            snap.regions.append((addr, rtype, count, nbytes))
+        elif tag == TAG_OBJECT:
+            r.varint()  # address
+            snap.desc_count[r.varint()] += 1
+            for _ in range(r.varint()):
+                snap.edges[EDGE_KINDS[r.u8()]] += 1
+                r.varint()  # target address
+        else:
+            raise ValueError(f"unknown record tag {tag:#x}")
+
+
+def by_key(snap):
+    """Aggregate (count, bytes) per stable descriptor key."""
+    out = {}
+    for desc_id, count in snap.desc_count.items():
+        key = snap.desc_key(desc_id)
+        out[key] = (count, count * snap.desc_size[desc_id])
+    return out
+
+
+def print_summary(snap):
+    print(
+        f"{len(snap.regions)} regions, {snap.objects} objects, "
+        f"{snap.bytes} bytes"
+    )
+    print(f"{'size':>10} {'count':>10} {'bytes':>12}")
+    rows = sorted(by_key(snap).items(), key=lambda kv: -kv[1][1])
+    for (size, _), (count, nbytes) in rows:
+        print(f"{size:>10} {count:>10} {nbytes:>12}")
+    print("edges:", dict(snap.edges))
+
+
+def print_diff(before, after):
+    b, a = by_key(before), by_key(after)
+    print(
+        f"regions {len(before.regions)} -> {len(after.regions)}, "
+        f"objects {before.objects} -> {after.objects}, "
+        f"bytes {before.bytes} -> {after.bytes}"
+    )
+    print(f"{'size':>10} {'count +/-':>12} {'bytes +/-':>12}")
+    rows = []
+    for key in sorted(set(b) | set(a)):
+        bc, bb = b.get(key, (0, 0))
+        ac, ab = a.get(key, (0, 0))
+        if (bc, bb) != (ac, ab):
+            rows.append((key[0], ac - bc, ab - bb))
+    for size, dcount, dbytes in sorted(rows, key=lambda r: -r[2]):
+        print(f"{size:>10} {dcount:>+12} {dbytes:>+12}")
+    if not rows:
+        print("(no change)")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Summarise a heap snapshot, or diff two."
+    )
+    parser.add_argument("before", help="snapshot file")
+    parser.add_argument("after", nargs="?", help="later snapshot to diff")
+    args = parser.parse_args()
+
+    if args.after is None:
+        print_summary(parse(args.before))
+    else:
+        print_diff(parse(args.before), parse(args.after))
+
+
+if __name__ == "__main__":
+    sys.exit(main())